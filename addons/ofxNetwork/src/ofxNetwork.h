@@ -3,4 +3,5 @@
 #include "ofxTCPClient.h"
 #include "ofxTCPManager.h"
 #include "ofxTCPServer.h"
+#include "ofxTCPEventServer.h"
 #include "ofxUDPManager.h"
@@ -2,9 +2,17 @@
 #include "ofAppRunner.h"
 #include "ofxNetworkUtils.h"
 #include "ofLog.h"
+#include <algorithm>
+#include <iterator>
 
 using namespace std;
 
+namespace{
+	// free space made available before every read so big messages
+	// are received in few calls
+	const size_t receiveChunkSize = 64 * 1024;
+}
+
 //--------------------------
 ofxTCPClient::ofxTCPClient(){
 
@@ -13,11 +21,16 @@ ofxTCPClient::ofxTCPClient(){
 	port		= 0;
 	index		= -1;
 	str			= "";
-	tmpStr		= "";
 	ipAddr		="000.000.000.000";
 
-	partialPrevMsg = "";
 	messageDelimiter = "[/TCP]";
+	framing = OFXTCP_FRAMING_DELIMITER;
+	maxMessageSize = 16 * 1024 * 1024;
+	skipSendTerminator = false;
+	receiveBegin = 0;
+	receiveEnd = 0;
+	receiveScanned = 0;
+	skipTerminator = false;
 	memset(tmpBuff,  0, TCP_MAX_MSG_SIZE+1);
 }
 
@@ -56,6 +69,9 @@ bool ofxTCPClient::setup(const ofxTCPSettings & settings){
 	TCPClient.SetNonBlocking(!settings.blocking);
 
 	setMessageDelimiter(settings.messageDelimiter);
+	setFraming(settings.framing);
+	maxMessageSize = settings.maxMessageSize;
+	skipSendTerminator = settings.skipSendTerminator;
 
 	port		= settings.port;
 	ipAddr		= settings.address;
@@ -93,6 +109,7 @@ bool ofxTCPClient::close(){
 		}else{
             ofLogVerbose("ofxTCPClient") << "closing client";
 			connected = false;
+			pendingSend.clear();
 			return true;
 		}
 	}else{
@@ -104,9 +121,22 @@ bool ofxTCPClient::close(){
 void ofxTCPClient::setMessageDelimiter(string delim){
 	if(delim != ""){
 		messageDelimiter = delim; 
+		receiveScanned = receiveBegin;
 	}
 }
 
+//--------------------------
+void ofxTCPClient::setFraming(ofxTCPFraming framing){
+	this->framing = framing;
+	receiveScanned = receiveBegin;
+	skipTerminator = false;
+}
+
+//--------------------------
+ofxTCPFraming ofxTCPClient::getFraming() const{
+	return framing;
+}
+
 //--------------------------
 bool ofxTCPClient::send(string message){
 	// tcp is a stream oriented protocol
@@ -115,70 +145,100 @@ bool ofxTCPClient::send(string message){
 	// note that you will receive a trailing [/TCP]\0
 	// if sending from here and receiving from receiveRaw or
 	// other applications
-	if(!connected){
-		ofLogWarning("ofxTCPClient") << "send(): not connected, call setup() first";
-		return false;
-	}
-	message = partialPrevMsg + message + messageDelimiter;
-	message += (char)0; //for flash
-	int ret = TCPClient.SendAll( message.c_str(), message.length() );
-    int errorCode = 0;
-    if(ret<0) errorCode = ofxNetworkCheckError();
-	if( isClosingCondition(ret, errorCode) ){
-		ofLogWarning("ofxTCPClient") << "send(): client disconnected";
-		close();
-		return false;
-	}else if(ret<0){
-		ofLogError("ofxTCPClient") << "send(): sending failed";
-		return false;
-	}else if(ret<(int)message.length()){
-		// in case of partial send, store the
-		// part that hasn't been sent and send
-		// with the next message to not corrupt
-		// next messages
-		partialPrevMsg=message.substr(ret);
-		return true;
-	}else{
-		partialPrevMsg = "";
-		return true;
-	}
+	ofxTCPDataView part(message);
+	return sendFramed(&part, 1, true, "send()");
 }
 
 //--------------------------
 bool ofxTCPClient::sendRawMsg(const char * msg, int size){
+	ofxTCPDataView part(msg, max(size, 0));
+	return sendFramed(&part, 1, false, "sendRawMsg()");
+}
 
-	// tcp is a stream oriented protocol
-	// so there's no way to be sure were
-	// a message ends without using a terminator
-	// note that you will receive a trailing [/TCP]\0
-	// if sending from here and receiving from receiveRaw or
-	// other applications
+//--------------------------
+bool ofxTCPClient::sendMessage(std::initializer_list<ofxTCPDataView> parts){
+	return sendFramed(parts.begin(), parts.size(), false, "sendMessage()");
+}
+
+//--------------------------
+bool ofxTCPClient::sendMessage(const std::vector<ofxTCPDataView> & parts){
+	return sendFramed(parts.data(), parts.size(), false, "sendMessage()");
+}
+
+//--------------------------
+bool ofxTCPClient::sendFramed(const ofxTCPDataView * parts, size_t numParts, bool nullTerminate, const char * function){
 	if(!connected){
-		ofLogWarning("ofxTCPClient") << "sendRawMsg(): not connected, call setup() first";
+		ofLogWarning("ofxTCPClient") << function << ": not connected, call setup() first";
 		return false;
 	}
-	tmpBuffSend.append(msg,size);
-	tmpBuffSend.append(messageDelimiter.c_str(),messageDelimiter.size());
 
-    int ret = TCPClient.SendAll( tmpBuffSend.getData(), tmpBuffSend.size() );
-    int errorCode = 0;
-    if(ret<0) errorCode = ofxNetworkCheckError();
+	size_t size = 0;
+	for(size_t i = 0; i < numParts; i++){
+		size += parts[i].size;
+	}
+
+	// the unsent part of the previous message, the framing and the
+	// message are passed to the socket as they are instead of
+	// joining them in a new string
+	char header[4];
+	std::vector<const char*> buffers;
+	std::vector<int> sizes;
+	buffers.reserve(numParts + 4);
+	sizes.reserve(numParts + 4);
+	int total = 0;
+	auto add = [&](const char * data, size_t size){
+		buffers.push_back(data);
+		sizes.push_back(int(size));
+		total += int(size);
+	};
+	add(pendingSend.data(), pendingSend.size());
+	if(framing == OFXTCP_FRAMING_LENGTH_PREFIX){
+		header[0] = char(size >> 24);
+		header[1] = char(size >> 16);
+		header[2] = char(size >> 8);
+		header[3] = char(size);
+		add(header, 4);
+	}
+	for(size_t i = 0; i < numParts; i++){
+		add(parts[i].data, parts[i].size);
+	}
+	if(framing == OFXTCP_FRAMING_DELIMITER){
+		add(messageDelimiter.data(), messageDelimiter.size());
+		if(nullTerminate){
+			add("", 1); //for flash
+		}
+	}
+
+	int ret = TCPClient.SendAllVectors(buffers.data(), sizes.data(), int(buffers.size()));
+	int errorCode = 0;
+	if(ret<0) errorCode = ofxNetworkCheckError();
 	if( isClosingCondition(ret, errorCode) ){
-		ofLogWarning("ofxTCPClient") << "sendRawMsg(): client disconnected";
+		ofLogWarning("ofxTCPClient") << function << ": client disconnected";
 		close();
 		return false;
 	}else if(ret<0){
-		ofLogError("ofxTCPClient") << "sendRawMsg(): sending failed";
+		ofLogError("ofxTCPClient") << function << ": sending failed";
 		return false;
-	}else if(ret<size){
+	}else if(ret<total){
 		// in case of partial send, store the
 		// part that hasn't been sent and send
 		// with the next message to not corrupt
 		// next messages
-		tmpBuffSend.set(&tmpBuffSend.getData()[ret],tmpBuffSend.size()-ret);
+		size_t sent = ret;
+		tmpSend.clear();
+		for(size_t i = 0; i < buffers.size(); i++){
+			size_t partSize = sizes[i];
+			if(sent >= partSize){
+				sent -= partSize;
+			}else{
+				tmpSend.append(buffers[i] + sent, partSize - sent);
+				sent = 0;
+			}
+		}
+		std::swap(pendingSend, tmpSend);
 		return true;
 	}else{
-		tmpBuffSend.clear();
+		pendingSend.clear();
 		return true;
 	}
 }
@@ -220,18 +280,6 @@ int ofxTCPClient::getNumReceivedBytes(){
 	return messageSize;
 }
 
-//--------------------------
-static void removeZeros(char * buffer, int size){
-	for(int i=0;i<size-1;i++){
-		if(buffer[i]==(char)0){
-			for(int j=i;j<size-1;j++){
-				buffer[j]=buffer[j+1];
-			}
-			buffer[size-1]=(char)0;
-		}
-	}
-}
-
 //--------------------------
 bool ofxTCPClient::isClosingCondition(int messageSize, int errorCode){
 	return (messageSize == SOCKET_ERROR && (errorCode == OFXNETWORK_ERROR(CONNRESET) || errorCode == OFXNETWORK_ERROR(CONNABORTED) || errorCode == OFXNETWORK_ERROR(CONNREFUSED) || errorCode == EPIPE || errorCode == OFXNETWORK_ERROR(NOTCONN)))
@@ -241,83 +289,145 @@ bool ofxTCPClient::isClosingCondition(int messageSize, int errorCode){
 //--------------------------
 string ofxTCPClient::receive(){
 	str    = "";
-	char byte;
-	while(peekReceiveRawBytes(&byte, 1)>0){
-		int length=0;
-		//only get data from the buffer if we don't have already some complete message
-		if(tmpStr.find(messageDelimiter)==string::npos){
-			memset(tmpBuff,  0, TCP_MAX_MSG_SIZE+1); //one more so there's always a \0 at the end for string concat
-			length = TCPClient.Receive(tmpBuff, TCP_MAX_MSG_SIZE);
-			if(length>0){ // don't copy the data if there was an error or disconnection
-				removeZeros(tmpBuff,length);
-				tmpStr += tmpBuff;
+	ofxTCPDataView message;
+	if(receiveMessage(message)){
+		// strings end on null bytes, like the ones added by send()
+		str.reserve(message.size);
+		std::remove_copy(message.data, message.data + message.size, std::back_inserter(str), (char)0);
+		// text comes from send(), don't leave the 0 it adds after the
+		// delimiter for a following receiveRawMsg() or receiveMessage()
+		if(framing == OFXTCP_FRAMING_DELIMITER){
+			skipTerminator = true;
+		}
+	}
+	return str;
+}
+
+//--------------------------
+bool ofxTCPClient::receiveMessage(ofxTCPDataView & message){
+	while(true){
+		// process any available data before reading more
+		auto result = parseMessage(message);
+		if(result == Complete){
+			messageSize = int(message.size);
+			return true;
+		}else if(result == TooBig){
+			ofLogError("ofxTCPClient") << "receiveMessage(): received a message bigger than " << maxMessageSize << " bytes, disconnecting";
+			close();
+			receiveBegin = receiveEnd = receiveScanned = 0;
+			skipTerminator = false;
+			return false;
+		}
+		if(!connected){
+			return false;
+		}
+
+		// make space for new data, the start of an incomplete message
+		// is moved to the front only when there's not enough left
+		if(receiveBegin == receiveEnd){
+			receiveBegin = receiveEnd = receiveScanned = 0;
+		}
+		if(receiveData.size() - receiveEnd < receiveChunkSize){
+			if(receiveBegin > 0){
+				std::copy(receiveData.begin() + receiveBegin, receiveData.begin() + receiveEnd, receiveData.begin());
+				receiveEnd -= receiveBegin;
+				receiveScanned -= receiveBegin;
+				receiveBegin = 0;
+			}
+			if(receiveData.size() - receiveEnd < receiveChunkSize){
+				receiveData.resize(max(receiveEnd + receiveChunkSize, receiveData.size() * 2));
 			}
 		}
 
+		int length = TCPClient.Receive(receiveData.data() + receiveEnd, int(receiveData.size() - receiveEnd));
+
 		// check for connection reset or disconnection
 		int errorCode = 0;
 		if(length<0) errorCode = ofxNetworkCheckError();
 		if(isClosingCondition(length,errorCode)){
+			// return any complete message left in the buffer
 			close();
-			if(tmpStr.length()==0) {
-				// return if there's no more data left in the buffer
-				return "";
-			}
+			continue;
 		}
-
-		// process any available data
-		if(tmpStr.find(messageDelimiter)!=string::npos){
-			str=tmpStr.substr(0,tmpStr.find(messageDelimiter));
-			tmpStr=tmpStr.substr(tmpStr.find(messageDelimiter)+messageDelimiter.size());
-			return str;
+		if(length<=0){
+			// no more data available for now
+			return false;
 		}
+		receiveEnd += length;
 	}
-	return "";
 }
 
 //--------------------------
-static int findDelimiter(char * data, int size, string delimiter){
-	unsigned int posInDelimiter=0;
-	for(int i=0;i<size;i++){
-		if(data[i]==delimiter[posInDelimiter]){
-			posInDelimiter++;
-			if(posInDelimiter==delimiter.size()) return i-delimiter.size()+1;
-		}else{
-			posInDelimiter=0;
-		}
-	}
-	return -1;
-}
+ofxTCPClient::ParseResult ofxTCPClient::parseMessage(ofxTCPDataView & message){
+	auto data = receiveData.data();
+	switch(framing){
+		case OFXTCP_FRAMING_NONE:
+			if(receiveBegin == receiveEnd){
+				return Incomplete;
+			}
+			message = ofxTCPDataView(data + receiveBegin, receiveEnd - receiveBegin);
+			receiveBegin = receiveScanned = receiveEnd;
+			return Complete;
 
-//--------------------------
-int ofxTCPClient::receiveRawMsg(char * receiveBuffer, int numBytes){
-	int length=-2;
-	//only get data from the buffer if we don't have already some complete message
-	if(findDelimiter(tmpBuffReceive.getData(),tmpBuffReceive.size(),messageDelimiter)==-1){
-		memset(tmpBuff,  0, TCP_MAX_MSG_SIZE);
-		length = receiveRawBytes(tmpBuff, TCP_MAX_MSG_SIZE);
-		if(length>0){ // don't copy the data if there was an error or disconnection
-			tmpBuffReceive.append(tmpBuff,length);
+		case OFXTCP_FRAMING_LENGTH_PREFIX:{
+			if(receiveEnd - receiveBegin < 4){
+				return Incomplete;
+			}
+			auto header = (const unsigned char*)data + receiveBegin;
+			size_t size = (size_t(header[0]) << 24) | (size_t(header[1]) << 16) | (size_t(header[2]) << 8) | size_t(header[3]);
+			if(size > maxMessageSize){
+				return TooBig;
+			}
+			if(receiveEnd - receiveBegin - 4 < size){
+				return Incomplete;
+			}
+			message = ofxTCPDataView(data + receiveBegin + 4, size);
+			receiveBegin = receiveScanned = receiveBegin + 4 + size;
+			return Complete;
 		}
-	}
 
-	// process any available data
-	int posDelimiter = findDelimiter(tmpBuffReceive.getData(),tmpBuffReceive.size(),messageDelimiter);
-	if(posDelimiter>0){
-		memcpy(receiveBuffer,tmpBuffReceive.getData(),posDelimiter);
-		if(tmpBuffReceive.size() > (unsigned int) posDelimiter + messageDelimiter.size()){
-			memcpy(tmpBuff,tmpBuffReceive.getData()+posDelimiter+messageDelimiter.size(),tmpBuffReceive.size()-(posDelimiter+messageDelimiter.size()));
-			tmpBuffReceive.set(tmpBuff,tmpBuffReceive.size()-(posDelimiter+messageDelimiter.size()));
-		}else{
-			tmpBuffReceive.clear();
+		case OFXTCP_FRAMING_DELIMITER:
+		default:{
+			// send() adds a 0 after the delimiter, it's only skipped
+			// after text or if enabled in the settings so binary
+			// messages can start with zeros
+			if(skipTerminator && receiveBegin < receiveEnd){
+				if(data[receiveBegin] == 0){
+					receiveBegin++;
+				}
+				skipTerminator = false;
+			}
+			// don't search again the part that was already searched
+			// when the message was incomplete
+			auto from = max(receiveBegin, receiveScanned);
+			auto end = std::search(data + from, data + receiveEnd, messageDelimiter.begin(), messageDelimiter.end());
+			if(end == data + receiveEnd){
+				if(receiveEnd - receiveBegin > maxMessageSize + messageDelimiter.size()){
+					return TooBig;
+				}
+				receiveScanned = max(receiveBegin, receiveEnd - min(receiveEnd, messageDelimiter.size() - 1));
+				return Incomplete;
+			}
+			message = ofxTCPDataView(data + receiveBegin, end - (data + receiveBegin));
+			receiveBegin = receiveScanned = (end - data) + messageDelimiter.size();
+			skipTerminator = skipSendTerminator;
+			return Complete;
 		}
 	}
+}
 
-	if(posDelimiter>0){
-		return posDelimiter;
-	}else{
+//--------------------------
+int ofxTCPClient::receiveRawMsg(char * receiveBuffer, int numBytes){
+	ofxTCPDataView message;
+	if(!receiveMessage(message)){
 		return 0;
 	}
+	if(message.size > size_t(numBytes)){
+		ofLogWarning("ofxTCPClient") << "receiveRawMsg(): message of " << message.size << " bytes truncated to " << numBytes << " bytes";
+	}
+	int size = min(int(message.size), numBytes);
+	memcpy(receiveBuffer, message.data, size);
+	return size;
 }
 
 //--------------------------
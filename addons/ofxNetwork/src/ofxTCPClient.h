@@ -5,11 +5,34 @@
 #include "ofxTCPSettings.h"
 #include "ofFileUtils.h"
 #include "ofTypes.h"
+#include <initializer_list>
 
 #define TCP_MAX_MSG_SIZE 512
 //#define STR_END_MSG "[/TCP]"
 //#define STR_END_MSG_LEN 6
 
+/// bytes owned by someone else, used to receive messages without copying
+/// them and to send a message made of several parts without joining them
+struct ofxTCPDataView{
+	ofxTCPDataView(){}
+	ofxTCPDataView(const char * data, size_t size)
+	:data(data)
+	,size(size){}
+	ofxTCPDataView(const std::string & str)
+	:data(str.data())
+	,size(str.size()){}
+	ofxTCPDataView(const ofBuffer & buffer)
+	:data(buffer.getData())
+	,size(buffer.size()){}
+
+	std::string getText() const{
+		return std::string(data, size);
+	}
+
+	const char * data = nullptr;
+	size_t size = 0;
+};
+
 
 class ofxTCPClient{
 
@@ -25,6 +48,13 @@ class ofxTCPClient{
 		bool setup(std::string ip, int _port, bool blocking = false);
 		bool setup(const ofxTCPSettings & settings);
 		void setMessageDelimiter(std::string delim);
+
+		/// how messages sent with send(), sendRawMsg() and sendMessage()
+		/// are framed and how received ones are split.
+		/// OFXTCP_FRAMING_DELIMITER by default, the other side needs to use
+		/// the same framing
+		void setFraming(ofxTCPFraming framing);
+		ofxTCPFraming getFraming() const;
 		bool close();
 
 	
@@ -32,6 +62,8 @@ class ofxTCPClient{
 		//is added to the end of the string which is
 		//used to indicate the end of the message to
 		//the receiver see: STR_END_MSG (ofxTCPClient.h)
+		//with OFXTCP_FRAMING_LENGTH_PREFIX the size of the
+		//message is sent before it instead
 		bool send(std::string message);
 
 		//send data as a string without the end message
@@ -40,6 +72,12 @@ class ofxTCPClient{
 		//same as send for binary messages
 		bool sendRawMsg(const char * msg, int size);
 
+		/// send several parts as a single message, they are passed to
+		/// the socket in one call without copying them to a new buffer.
+		/// eg: client.sendMessage({header, payload});
+		bool sendMessage(std::initializer_list<ofxTCPDataView> parts);
+		bool sendMessage(const std::vector<ofxTCPDataView> & parts);
+
 		//the received message length in bytes
 		int getNumReceivedBytes();
 
@@ -60,6 +98,16 @@ class ofxTCPClient{
 		//sender should send "Hello World[/TCP]"
 		std::string receive();
 
+		/// get the next complete message without copying it.
+		/// the data points to an internal buffer that is reused, it's
+		/// only valid until the next call to receive(), receiveRawMsg()
+		/// or receiveMessage().
+		/// received data is kept between calls and only the new bytes are
+		/// searched for the delimiter so big messages arriving in many
+		/// parts don't get slower to receive
+		/// \returns false if there's no complete message yet
+		bool receiveMessage(ofxTCPDataView & message);
+
 		//no terminating string you will need to be sure
 		//you are receiving all the data by using a loop
 		std::string receiveRaw();
@@ -95,16 +143,35 @@ private:
         //--------------------------
 		bool setupConnectionIdx(int _index, bool blocking);
 		bool isClosingCondition(int messageSize, int errorCode);
+		bool sendFramed(const ofxTCPDataView * parts, size_t numParts, bool nullTerminate, const char * function);
+		enum ParseResult{
+			Incomplete,
+			Complete,
+			TooBig,
+		};
+		ParseResult parseMessage(ofxTCPDataView & message);
 		friend class ofxTCPServer;
 
 		ofxTCPManager	TCPClient;
 
 		char			tmpBuff[TCP_MAX_MSG_SIZE+1];
-		ofBuffer 		tmpBuffReceive;
-		ofBuffer 		tmpBuffSend;
-		std::string		str, tmpStr, ipAddr;
+		std::string		str, ipAddr;
 		int				index, messageSize, port;
 		bool			connected;
-		std::string 	partialPrevMsg;
 		std::string		messageDelimiter;
+		ofxTCPFraming	framing;
+		size_t			maxMessageSize;
+		bool			skipSendTerminator;
+
+		// received data that isn't a complete message yet, messages are
+		// consumed from the front and the rest is only moved back when
+		// more space is needed
+		std::vector<char>	receiveData;
+		size_t			receiveBegin, receiveEnd;
+		size_t			receiveScanned; // end of the data already searched for the delimiter
+		bool			skipTerminator; // the next byte can be the 0 send() adds after the delimiter, skipped if it is
+
+		// the part of the last message that the socket didn't accept,
+		// sent before the next one to not corrupt the stream
+		std::string		pendingSend, tmpSend;
 };
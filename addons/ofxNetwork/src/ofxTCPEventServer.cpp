@@ -0,0 +1,894 @@
+#include "ofxTCPEventServer.h"
+#include "ofxNetworkUtils.h"
+#include "ofLog.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef TARGET_WIN32
+	#include <winsock2.h>
+	#include <ws2tcpip.h>
+#else
+	#include <sys/types.h>
+	#include <sys/socket.h>
+	#include <netinet/in.h>
+	#include <netinet/tcp.h>
+	#include <arpa/inet.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <poll.h>
+	#include <errno.h>
+	#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+		#include <sys/epoll.h>
+		#include <sys/eventfd.h>
+		#define OFXTCP_USE_EPOLL
+	#endif
+#endif
+
+using namespace std;
+
+namespace{
+	const size_t readBufferSize = 64 * 1024;
+	const size_t maxReadsPerEvent = 4;
+	const size_t maxVectorsPerSend = 64;
+	const intptr_t invalidSocket = -1;
+
+#ifdef TARGET_WIN32
+	typedef WSABUF IOVector;
+
+	void setIOVector(IOVector & vector, const char * data, size_t size){
+		vector.buf = (CHAR*)data;
+		vector.len = (ULONG)size;
+	}
+
+	// bytes sent, 0 if the socket can't accept more data or -1 on errors
+	int64_t sendVectors(intptr_t socket, IOVector * vectors, size_t count){
+		DWORD sent = 0;
+		if(WSASend((SOCKET)socket, vectors, (DWORD)count, &sent, 0, nullptr, nullptr) == SOCKET_ERROR){
+			return WSAGetLastError() == WSAEWOULDBLOCK ? 0 : -1;
+		}
+		return sent;
+	}
+
+	// bytes received, 0 if the peer closed the connection, -1 if there's
+	// no data available or -2 on errors
+	int64_t receiveBytes(intptr_t socket, char * buffer, size_t size){
+		int received = recv((SOCKET)socket, buffer, (int)size, 0);
+		if(received == SOCKET_ERROR){
+			return WSAGetLastError() == WSAEWOULDBLOCK ? -1 : -2;
+		}
+		return received;
+	}
+
+	bool setNonBlocking(intptr_t socket){
+		u_long nonBlocking = 1;
+		return ioctlsocket((SOCKET)socket, FIONBIO, &nonBlocking) == 0;
+	}
+
+	bool wouldBlock(){
+		return WSAGetLastError() == WSAEWOULDBLOCK;
+	}
+
+	void closeSocket(intptr_t socket){
+		closesocket((SOCKET)socket);
+	}
+
+	void shutdownSocket(intptr_t socket){
+		shutdown((SOCKET)socket, SD_BOTH);
+	}
+#else
+	typedef iovec IOVector;
+
+	#ifdef MSG_NOSIGNAL
+		const int sendFlags = MSG_NOSIGNAL;
+	#else
+		const int sendFlags = 0;
+	#endif
+
+	void setIOVector(IOVector & vector, const char * data, size_t size){
+		vector.iov_base = (void*)data;
+		vector.iov_len = size;
+	}
+
+	int64_t sendVectors(intptr_t socket, IOVector * vectors, size_t count){
+		msghdr message;
+		memset(&message, 0, sizeof(message));
+		message.msg_iov = vectors;
+		message.msg_iovlen = count;
+		ssize_t sent;
+		do{
+			sent = sendmsg(socket, &message, sendFlags);
+		}while(sent < 0 && errno == EINTR);
+		if(sent < 0){
+			return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+		}
+		return sent;
+	}
+
+	int64_t receiveBytes(intptr_t socket, char * buffer, size_t size){
+		ssize_t received;
+		do{
+			received = recv(socket, buffer, size, 0);
+		}while(received < 0 && errno == EINTR);
+		if(received < 0){
+			return errno == EAGAIN || errno == EWOULDBLOCK ? -1 : -2;
+		}
+		return received;
+	}
+
+	bool setNonBlocking(intptr_t socket){
+		int flags = fcntl(socket, F_GETFL, 0);
+		return flags != -1 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) != -1;
+	}
+
+	bool wouldBlock(){
+		return errno == EAGAIN || errno == EWOULDBLOCK;
+	}
+
+	void closeSocket(intptr_t socket){
+		::close(socket);
+	}
+
+	void shutdownSocket(intptr_t socket){
+		shutdown(socket, SHUT_RDWR);
+	}
+#endif
+}
+
+//--------------------------
+// waits for activity on every socket at once
+class ofxTCPEventServer::Poller{
+public:
+	struct Event{
+		uint64_t id;
+		bool readable;
+		bool writable;
+	};
+
+	static constexpr uint64_t ListenID = ~uint64_t(0);
+	static constexpr uint64_t WakeupID = ~uint64_t(0) - 1;
+
+#ifdef OFXTCP_USE_EPOLL
+	~Poller(){
+		if(wakeupFd != -1) ::close(wakeupFd);
+		if(epollFd != -1) ::close(epollFd);
+	}
+
+	bool setup(){
+		epollFd = epoll_create1(EPOLL_CLOEXEC);
+		wakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if(epollFd == -1 || wakeupFd == -1){
+			return false;
+		}
+		return control(EPOLL_CTL_ADD, wakeupFd, WakeupID, false);
+	}
+
+	bool add(intptr_t socket, uint64_t id){
+		return control(EPOLL_CTL_ADD, socket, id, false);
+	}
+
+	// can be called from any thread
+	void setWrite(intptr_t socket, uint64_t id, bool write){
+		control(EPOLL_CTL_MOD, socket, id, write);
+	}
+
+	void remove(intptr_t socket){
+		epoll_ctl(epollFd, EPOLL_CTL_DEL, socket, nullptr);
+	}
+
+	void wait(vector<Event> & events, int timeoutMs){
+		events.clear();
+		epoll_event ready[256];
+		int count = epoll_wait(epollFd, ready, 256, timeoutMs);
+		for(int i = 0; i < count; i++){
+			if(ready[i].data.u64 == WakeupID){
+				uint64_t value;
+				while(::read(wakeupFd, &value, sizeof(value)) > 0);
+				continue;
+			}
+			bool hangup = ready[i].events & (EPOLLERR | EPOLLHUP);
+			events.push_back({ready[i].data.u64, (ready[i].events & EPOLLIN) || hangup, bool(ready[i].events & EPOLLOUT)});
+		}
+	}
+
+	void wakeup(){
+		uint64_t value = 1;
+		if(::write(wakeupFd, &value, sizeof(value)) < 0){
+			ofLogError("ofxTCPEventServer") << "couldn't wake up the server thread";
+		}
+	}
+
+private:
+	bool control(int operation, intptr_t socket, uint64_t id, bool write){
+		epoll_event event;
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN | (write ? uint32_t(EPOLLOUT) : 0u);
+		event.data.u64 = id;
+		return epoll_ctl(epollFd, operation, socket, &event) == 0;
+	}
+
+	int epollFd = -1;
+	int wakeupFd = -1;
+#else
+	~Poller(){
+	#ifndef TARGET_WIN32
+		if(wakeupPipe[0] != -1) ::close(wakeupPipe[0]);
+		if(wakeupPipe[1] != -1) ::close(wakeupPipe[1]);
+	#endif
+	}
+
+	bool setup(){
+	#ifndef TARGET_WIN32
+		if(pipe(wakeupPipe) == -1){
+			return false;
+		}
+		setNonBlocking(wakeupPipe[0]);
+		setNonBlocking(wakeupPipe[1]);
+	#endif
+		return true;
+	}
+
+	bool add(intptr_t socket, uint64_t id){
+		std::unique_lock<std::mutex> lock(mutex);
+		sockets[socket] = {id, false};
+		return true;
+	}
+
+	void setWrite(intptr_t socket, uint64_t id, bool write){
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			sockets[socket] = {id, write};
+		}
+		wakeup();
+	}
+
+	void remove(intptr_t socket){
+		std::unique_lock<std::mutex> lock(mutex);
+		sockets.erase(socket);
+	}
+
+	void wait(vector<Event> & events, int timeoutMs){
+		events.clear();
+		fds.clear();
+		ids.clear();
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			for(auto & socket: sockets){
+				pollfd fd;
+				fd.fd = socket.first;
+				fd.events = POLLIN | (socket.second.write ? POLLOUT : 0);
+				fd.revents = 0;
+				fds.push_back(fd);
+				ids.push_back(socket.second.id);
+			}
+		}
+	#ifdef TARGET_WIN32
+		// there's no portable way to wake up WSAPoll so poll in short intervals
+		int count = WSAPoll(fds.data(), (ULONG)fds.size(), std::min(timeoutMs, 10));
+	#else
+		pollfd wakeupFd;
+		wakeupFd.fd = wakeupPipe[0];
+		wakeupFd.events = POLLIN;
+		wakeupFd.revents = 0;
+		fds.push_back(wakeupFd);
+		ids.push_back(WakeupID);
+		int count = poll(fds.data(), fds.size(), timeoutMs);
+	#endif
+		for(size_t i = 0; i < fds.size() && count > 0; i++){
+			if(fds[i].revents == 0){
+				continue;
+			}
+			if(ids[i] == WakeupID){
+			#ifndef TARGET_WIN32
+				char buffer[64];
+				while(::read(wakeupPipe[0], buffer, sizeof(buffer)) > 0);
+			#endif
+				continue;
+			}
+			bool hangup = fds[i].revents & (POLLERR | POLLHUP | POLLNVAL);
+			events.push_back({ids[i], (fds[i].revents & POLLIN) || hangup, bool(fds[i].revents & POLLOUT)});
+		}
+	}
+
+	void wakeup(){
+	#ifndef TARGET_WIN32
+		char value = 1;
+		if(::write(wakeupPipe[1], &value, 1) < 0 && !wouldBlock()){
+			ofLogError("ofxTCPEventServer") << "couldn't wake up the server thread";
+		}
+	#endif
+	}
+
+private:
+	struct Socket{
+		uint64_t id;
+		bool write;
+	};
+	std::mutex mutex;
+	std::map<intptr_t, Socket> sockets;
+	vector<pollfd> fds;
+	vector<uint64_t> ids;
+#ifndef TARGET_WIN32
+	int wakeupPipe[2] = {-1, -1};
+#endif
+#endif
+};
+
+constexpr uint64_t ofxTCPEventServer::Poller::ListenID;
+constexpr uint64_t ofxTCPEventServer::Poller::WakeupID;
+
+//--------------------------
+struct ofxTCPEventServer::Connection{
+	// part of a message waiting to be sent, small framing headers are
+	// copied, message bodies are shared with the caller
+	struct Chunk{
+		std::shared_ptr<const ofBuffer> buffer;
+		std::string bytes;
+		size_t offset = 0;
+
+		const char * data() const{
+			return (buffer ? buffer->getData() : bytes.data()) + offset;
+		}
+
+		size_t size() const{
+			return (buffer ? buffer->size() : bytes.size()) - offset;
+		}
+	};
+
+	int id;
+	intptr_t socket;
+	std::string ip;
+	int port;
+
+	// only used from the server thread
+	std::vector<char> input; // start of a message that hasn't arrived completely
+	size_t scanned = 0; // bytes of input already searched for the delimiter
+	bool skipTerminator = false; // the next byte can be the 0 ofxTCPClient::send adds after the delimiter, skipped if it is
+
+	std::mutex mutex;
+	std::deque<Chunk> output;
+	size_t pendingBytes = 0;
+	bool writing = false; // waiting for the socket to be writable
+	bool closed = false;
+};
+
+//--------------------------
+ofxTCPEventServer::ofxTCPEventServer()
+:settings(0)
+,listenSocket(invalidSocket)
+,connected(false)
+,nextID(0){
+	setThreadName("ofxTCPEventServer");
+}
+
+//--------------------------
+ofxTCPEventServer::~ofxTCPEventServer(){
+	close();
+}
+
+//--------------------------
+bool ofxTCPEventServer::setup(int port, ofxTCPFraming framing){
+	ofxTCPSettings settings(port);
+	settings.framing = framing;
+	return setup(settings);
+}
+
+//--------------------------
+bool ofxTCPEventServer::setup(const ofxTCPSettings & settings){
+	close();
+	this->settings = settings;
+	if(this->settings.messageDelimiter.empty()){
+		this->settings.messageDelimiter = "[/TCP]";
+	}
+
+#ifdef TARGET_WIN32
+	WSADATA wsaData;
+	WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+
+	listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+	if(listenSocket == invalidSocket){
+		ofLogError("ofxTCPEventServer") << "setup(): couldn't create socket";
+		return false;
+	}
+	int reuse = 1;
+	setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+	sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_port = htons(settings.port);
+	address.sin_addr.s_addr = settings.address.empty() ? htonl(INADDR_ANY) : inet_addr(settings.address.c_str());
+	if(::bind(listenSocket, (sockaddr*)&address, sizeof(address)) != 0){
+		ofLogError("ofxTCPEventServer") << "setup(): couldn't bind to port " << settings.port;
+		closeSocket(listenSocket);
+		listenSocket = invalidSocket;
+		return false;
+	}
+	if(listen(listenSocket, SOMAXCONN) != 0 || !setNonBlocking(listenSocket)){
+		ofLogError("ofxTCPEventServer") << "setup(): couldn't listen on port " << settings.port;
+		closeSocket(listenSocket);
+		listenSocket = invalidSocket;
+		return false;
+	}
+
+	poller.reset(new Poller);
+	if(!poller->setup() || !poller->add(listenSocket, Poller::ListenID)){
+		ofLogError("ofxTCPEventServer") << "setup(): couldn't start waiting for connections";
+		poller.reset();
+		closeSocket(listenSocket);
+		listenSocket = invalidSocket;
+		return false;
+	}
+
+	connected = true;
+	startThread();
+	return true;
+}
+
+//--------------------------
+void ofxTCPEventServer::close(){
+	if(!poller){
+		return;
+	}
+	stopThread();
+	poller->wakeup();
+	waitForThread(false);
+
+	std::vector<int> ids;
+	{
+		std::unique_lock<std::mutex> lock(connectionsMutex);
+		for(auto & connection: connections){
+			ids.push_back(connection.first);
+		}
+	}
+	for(auto id: ids){
+		release(id);
+	}
+	closeSocket(listenSocket);
+	listenSocket = invalidSocket;
+	poller.reset();
+	connected = false;
+
+#ifdef TARGET_WIN32
+	WSACleanup();
+#endif
+}
+
+//--------------------------
+bool ofxTCPEventServer::isConnected() const{
+	return connected;
+}
+
+//--------------------------
+int ofxTCPEventServer::getPort() const{
+	return settings.port;
+}
+
+//--------------------------
+size_t ofxTCPEventServer::getNumClients(){
+	std::unique_lock<std::mutex> lock(connectionsMutex);
+	return connections.size();
+}
+
+//--------------------------
+bool ofxTCPEventServer::isClientConnected(int clientID){
+	return getConnection(clientID) != nullptr;
+}
+
+//--------------------------
+std::string ofxTCPEventServer::getClientIP(int clientID){
+	auto connection = getConnection(clientID);
+	return connection ? connection->ip : "000.000.000.000";
+}
+
+//--------------------------
+int ofxTCPEventServer::getClientPort(int clientID){
+	auto connection = getConnection(clientID);
+	return connection ? connection->port : 0;
+}
+
+//--------------------------
+bool ofxTCPEventServer::receive(ofxTCPMessage & message){
+	return messages.tryReceive(message);
+}
+
+//--------------------------
+size_t ofxTCPEventServer::receiveAll(std::vector<ofxTCPMessage> & messages){
+	return this->messages.receiveAll(messages);
+}
+
+//--------------------------
+bool ofxTCPEventServer::send(int clientID, const std::string & message){
+	return send(clientID, message.data(), message.size());
+}
+
+//--------------------------
+bool ofxTCPEventServer::send(int clientID, const char * data, size_t size){
+	auto connection = getConnection(clientID);
+	if(!connection){
+		ofLogWarning("ofxTCPEventServer") << "send(): client " << clientID << " doesn't exist";
+		return false;
+	}
+	return queue(*connection, nullptr, data, size);
+}
+
+//--------------------------
+bool ofxTCPEventServer::send(int clientID, std::shared_ptr<const ofBuffer> buffer){
+	auto connection = getConnection(clientID);
+	if(!connection || !buffer){
+		ofLogWarning("ofxTCPEventServer") << "send(): client " << clientID << " doesn't exist";
+		return false;
+	}
+	auto data = buffer->getData();
+	auto size = buffer->size();
+	return queue(*connection, std::move(buffer), data, size);
+}
+
+//--------------------------
+size_t ofxTCPEventServer::sendToAll(const std::string & message){
+	return sendToAll(std::make_shared<ofBuffer>(message.data(), message.size()));
+}
+
+//--------------------------
+size_t ofxTCPEventServer::sendToAll(std::shared_ptr<const ofBuffer> buffer){
+	std::vector<std::shared_ptr<Connection>> all;
+	{
+		std::unique_lock<std::mutex> lock(connectionsMutex);
+		all.reserve(connections.size());
+		for(auto & connection: connections){
+			all.push_back(connection.second);
+		}
+	}
+	size_t sent = 0;
+	for(auto & connection: all){
+		auto shared = buffer;
+		if(queue(*connection, std::move(shared), buffer->getData(), buffer->size())){
+			sent++;
+		}
+	}
+	return sent;
+}
+
+//--------------------------
+bool ofxTCPEventServer::disconnectClient(int clientID){
+	auto connection = getConnection(clientID);
+	if(!connection){
+		ofLogWarning("ofxTCPEventServer") << "disconnectClient(): client " << clientID << " doesn't exist";
+		return false;
+	}
+	// the server thread sees the socket closing and releases it
+	std::unique_lock<std::mutex> lock(connection->mutex);
+	if(!connection->closed){
+		shutdownSocket(connection->socket);
+	}
+	return true;
+}
+
+//--------------------------
+size_t ofxTCPEventServer::getNumPendingBytes(int clientID){
+	auto connection = getConnection(clientID);
+	if(!connection){
+		return 0;
+	}
+	std::unique_lock<std::mutex> lock(connection->mutex);
+	return connection->pendingBytes;
+}
+
+//--------------------------
+std::shared_ptr<ofxTCPEventServer::Connection> ofxTCPEventServer::getConnection(int clientID){
+	std::unique_lock<std::mutex> lock(connectionsMutex);
+	auto it = connections.find(clientID);
+	return it == connections.end() ? nullptr : it->second;
+}
+
+//--------------------------
+bool ofxTCPEventServer::queue(Connection & connection, std::shared_ptr<const ofBuffer> && buffer, const char * data, size_t size){
+	char header[4];
+	const char * prefix = nullptr;
+	size_t prefixSize = 0;
+	const char * suffix = nullptr;
+	size_t suffixSize = 0;
+	switch(settings.framing){
+		case OFXTCP_FRAMING_LENGTH_PREFIX:
+			header[0] = char(size >> 24);
+			header[1] = char(size >> 16);
+			header[2] = char(size >> 8);
+			header[3] = char(size);
+			prefix = header;
+			prefixSize = 4;
+			break;
+		case OFXTCP_FRAMING_DELIMITER:
+			suffix = settings.messageDelimiter.data();
+			suffixSize = settings.messageDelimiter.size();
+			break;
+		case OFXTCP_FRAMING_NONE:
+			break;
+	}
+
+	std::unique_lock<std::mutex> lock(connection.mutex);
+	if(connection.closed){
+		return false;
+	}
+
+	// try to send right away and only queue what the socket didn't accept
+	size_t sent = 0;
+	if(connection.output.empty()){
+		IOVector vectors[3];
+		size_t count = 0;
+		if(prefixSize) setIOVector(vectors[count++], prefix, prefixSize);
+		if(size) setIOVector(vectors[count++], data, size);
+		if(suffixSize) setIOVector(vectors[count++], suffix, suffixSize);
+		auto result = sendVectors(connection.socket, vectors, count);
+		if(result < 0){
+			shutdownSocket(connection.socket);
+			return false;
+		}
+		sent = result;
+	}
+
+	auto queuePart = [&](const char * part, size_t partSize, bool body){
+		if(sent >= partSize){
+			sent -= partSize;
+			return;
+		}
+		Connection::Chunk chunk;
+		if(!body){
+			chunk.bytes.assign(part + sent, partSize - sent);
+		}else if(buffer){
+			chunk.buffer = buffer;
+			chunk.offset = (part - buffer->getData()) + sent;
+		}else{
+			chunk.buffer = std::make_shared<ofBuffer>(part + sent, partSize - sent);
+		}
+		connection.pendingBytes += partSize - sent;
+		connection.output.push_back(std::move(chunk));
+		sent = 0;
+	};
+	queuePart(prefix, prefixSize, false);
+	queuePart(data, size, true);
+	queuePart(suffix, suffixSize, false);
+
+	if(!connection.output.empty() && !connection.writing){
+		connection.writing = true;
+		poller->setWrite(connection.socket, connection.id, true);
+	}
+	return true;
+}
+
+//--------------------------
+bool ofxTCPEventServer::flush(Connection & connection){
+	while(!connection.output.empty()){
+		IOVector vectors[maxVectorsPerSend];
+		size_t count = 0;
+		for(auto & chunk: connection.output){
+			if(count == maxVectorsPerSend){
+				break;
+			}
+			setIOVector(vectors[count++], chunk.data(), chunk.size());
+		}
+		auto sent = sendVectors(connection.socket, vectors, count);
+		if(sent < 0){
+			return false;
+		}else if(sent == 0){
+			return true;
+		}
+		connection.pendingBytes -= sent;
+		while(sent > 0){
+			auto & chunk = connection.output.front();
+			if(size_t(sent) >= chunk.size()){
+				sent -= chunk.size();
+				connection.output.pop_front();
+			}else{
+				chunk.offset += sent;
+				sent = 0;
+			}
+		}
+	}
+	return true;
+}
+
+//--------------------------
+void ofxTCPEventServer::threadedFunction(){
+	std::vector<Poller::Event> events;
+	while(isThreadRunning()){
+		poller->wait(events, 100);
+		for(auto & event: events){
+			if(event.id == Poller::ListenID){
+				accept();
+				continue;
+			}
+			auto connection = getConnection(int(event.id));
+			if(!connection){
+				continue;
+			}
+			if(event.writable){
+				std::unique_lock<std::mutex> lock(connection->mutex);
+				if(!flush(*connection)){
+					shutdownSocket(connection->socket);
+				}else if(connection->output.empty() && connection->writing){
+					connection->writing = false;
+					poller->setWrite(connection->socket, connection->id, false);
+				}
+			}
+			if(event.readable){
+				read(*connection);
+			}
+		}
+	}
+}
+
+//--------------------------
+void ofxTCPEventServer::accept(){
+	while(true){
+		sockaddr_in address;
+		socklen_t addressSize = sizeof(address);
+		intptr_t socket = ::accept(listenSocket, (sockaddr*)&address, &addressSize);
+		if(socket == invalidSocket){
+			if(!wouldBlock()){
+				ofxNetworkCheckError();
+			}
+			return;
+		}
+
+		if(settings.maxClients > 0 && getNumClients() >= settings.maxClients){
+			ofLogWarning("ofxTCPEventServer") << "rejecting connection, maximum number of clients reached: " << settings.maxClients;
+			closeSocket(socket);
+			continue;
+		}
+
+		int noDelay = 1;
+		setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+	#ifdef SO_NOSIGPIPE
+		int noSigPipe = 1;
+		setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+	#endif
+		setNonBlocking(socket);
+
+		auto connection = std::make_shared<Connection>();
+		connection->id = nextID++;
+		connection->socket = socket;
+		connection->ip = inet_ntoa(address.sin_addr);
+		connection->port = ntohs(address.sin_port);
+		{
+			std::unique_lock<std::mutex> lock(connectionsMutex);
+			connections[connection->id] = connection;
+		}
+		ofxTCPMessage message;
+		message.type = ofxTCPMessage::Connected;
+		message.clientID = connection->id;
+		messages.send(std::move(message));
+		poller->add(socket, connection->id);
+		ofLogVerbose("ofxTCPEventServer") << "client " << connection->id << " connected from " << connection->ip << ":" << connection->port;
+	}
+}
+
+//--------------------------
+void ofxTCPEventServer::read(Connection & connection){
+	static thread_local std::vector<char> buffer(readBufferSize);
+	bool closed = false;
+	for(size_t i = 0; i < maxReadsPerEvent; i++){
+		auto received = receiveBytes(connection.socket, buffer.data(), buffer.size());
+		if(received == -1){
+			break;
+		}else if(received <= 0){
+			closed = true;
+			break;
+		}
+		connection.input.insert(connection.input.end(), buffer.data(), buffer.data() + received);
+		if(size_t(received) < buffer.size()){
+			break;
+		}
+	}
+	if(!parse(connection)){
+		ofLogError("ofxTCPEventServer") << "client " << connection.id << " sent a message bigger than " << settings.maxMessageSize << " bytes, disconnecting";
+		closed = true;
+	}
+	if(closed){
+		release(connection.id);
+	}
+}
+
+//--------------------------
+bool ofxTCPEventServer::parse(Connection & connection){
+	auto & input = connection.input;
+	auto deliver = [&](size_t begin, size_t end){
+		ofxTCPMessage message;
+		message.type = ofxTCPMessage::Message;
+		message.clientID = connection.id;
+		message.data.set(input.data() + begin, end - begin);
+		messages.send(std::move(message));
+	};
+
+	size_t consumed = 0;
+	switch(settings.framing){
+		case OFXTCP_FRAMING_NONE:
+			if(!input.empty()){
+				deliver(0, input.size());
+				consumed = input.size();
+			}
+			break;
+
+		case OFXTCP_FRAMING_LENGTH_PREFIX:
+			while(input.size() - consumed >= 4){
+				auto header = (const unsigned char*)input.data() + consumed;
+				size_t size = (size_t(header[0]) << 24) | (size_t(header[1]) << 16) | (size_t(header[2]) << 8) | size_t(header[3]);
+				if(size > settings.maxMessageSize){
+					return false;
+				}
+				if(input.size() - consumed - 4 < size){
+					break;
+				}
+				deliver(consumed + 4, consumed + 4 + size);
+				consumed += 4 + size;
+			}
+			break;
+
+		case OFXTCP_FRAMING_DELIMITER:{
+			auto & delimiter = settings.messageDelimiter;
+			while(consumed < input.size()){
+				// ofxTCPClient::send adds a 0 after the delimiter, it's
+				// only skipped if enabled in the settings so binary
+				// messages can start with zeros
+				if(connection.skipTerminator){
+					connection.skipTerminator = false;
+					if(input[consumed] == 0){
+						consumed++;
+						connection.scanned = std::max(connection.scanned, consumed);
+						continue;
+					}
+				}
+				// don't search again the part that was already searched
+				// when the message was incomplete
+				auto from = std::max(consumed, connection.scanned);
+				auto end = std::search(input.begin() + from, input.end(), delimiter.begin(), delimiter.end());
+				if(end == input.end()){
+					if(input.size() - consumed > settings.maxMessageSize + delimiter.size()){
+						return false;
+					}
+					connection.scanned = std::max(consumed, input.size() - std::min(input.size(), delimiter.size() - 1));
+					break;
+				}
+				size_t position = end - input.begin();
+				deliver(consumed, position);
+				consumed = position + delimiter.size();
+				connection.scanned = consumed;
+				connection.skipTerminator = settings.skipSendTerminator;
+			}
+		}break;
+	}
+
+	// remove the delivered messages at once
+	if(consumed > 0){
+		input.erase(input.begin(), input.begin() + consumed);
+		connection.scanned -= std::min(connection.scanned, consumed);
+	}
+	return true;
+}
+
+//--------------------------
+void ofxTCPEventServer::release(int clientID){
+	std::shared_ptr<Connection> connection;
+	{
+		std::unique_lock<std::mutex> lock(connectionsMutex);
+		auto it = connections.find(clientID);
+		if(it == connections.end()){
+			return;
+		}
+		connection = it->second;
+		connections.erase(it);
+	}
+	{
+		std::unique_lock<std::mutex> lock(connection->mutex);
+		connection->closed = true;
+		connection->output.clear();
+		connection->pendingBytes = 0;
+	}
+	poller->remove(connection->socket);
+	closeSocket(connection->socket);
+
+	ofxTCPMessage message;
+	message.type = ofxTCPMessage::Disconnected;
+	message.clientID = clientID;
+	messages.send(std::move(message));
+	ofLogVerbose("ofxTCPEventServer") << "client " << clientID << " disconnected";
+}
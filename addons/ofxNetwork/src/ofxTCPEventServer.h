@@ -0,0 +1,129 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofThread.h"
+#include "ofThreadChannel.h"
+#include "ofFileUtils.h"
+#include "ofxTCPSettings.h"
+#include <map>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <atomic>
+
+/// a connection, disconnection or complete message received by
+/// ofxTCPEventServer
+struct ofxTCPMessage{
+	enum Type{
+		Connected,
+		Message,
+		Disconnected,
+	};
+
+	Type type = Message;
+	int clientID = -1;
+	ofBuffer data; //< the message without its framing, empty for connections and disconnections
+};
+
+/// TCP server that handles every client from a single thread.
+///
+/// ofxTCPServer creates an ofxTCPClient per connection and every client has
+/// to be polled for new data, which gets slow with many clients.
+/// ofxTCPEventServer waits for activity on all the sockets at once using
+/// epoll on linux and poll everywhere else, splits the incoming data in
+/// messages as it arrives and queues them so the application can receive
+/// everything that happened since the last frame in one call.
+///
+/// ~~~~{.cpp}
+///     ofxTCPSettings settings(11999);
+///     settings.framing = OFXTCP_FRAMING_LENGTH_PREFIX;
+///     server.setup(settings);
+///
+///     // in update
+///     ofxTCPMessage message;
+///     while(server.receive(message)){
+///         if(message.type == ofxTCPMessage::Message){
+///             server.send(message.clientID, message.data.getText());
+///         }
+///     }
+/// ~~~~
+///
+/// Sending never blocks: whatever the socket doesn't accept immediately is
+/// queued and sent from the server thread. Buffers passed as shared_ptr are
+/// not copied, so the same buffer can be sent to many clients.
+///
+/// Client ids are never reused while the server is running.
+class ofxTCPEventServer: public ofThread{
+public:
+	ofxTCPEventServer();
+	~ofxTCPEventServer();
+
+	ofxTCPEventServer(const ofxTCPEventServer &) = delete;
+	ofxTCPEventServer & operator=(const ofxTCPEventServer &) = delete;
+
+	bool setup(int port, ofxTCPFraming framing = OFXTCP_FRAMING_DELIMITER);
+	bool setup(const ofxTCPSettings & settings);
+
+	/// closes every connection and stops the server thread
+	void close();
+
+	bool isConnected() const;
+	int getPort() const;
+	size_t getNumClients();
+	bool isClientConnected(int clientID);
+	std::string getClientIP(int clientID);
+	int getClientPort(int clientID);
+
+	/// get the next queued connection, message or disconnection without
+	/// blocking
+	/// \returns false if there was nothing queued
+	bool receive(ofxTCPMessage & message);
+
+	/// append every queued connection, message and disconnection to messages
+	/// \returns the number of received messages
+	size_t receiveAll(std::vector<ofxTCPMessage> & messages);
+
+	/// send a message adding the framing
+	/// \returns false if the client doesn't exist or the connection failed
+	bool send(int clientID, const std::string & message);
+	bool send(int clientID, const char * data, size_t size);
+
+	/// send a buffer without copying it, it's kept alive until it's been
+	/// completely sent
+	bool send(int clientID, std::shared_ptr<const ofBuffer> buffer);
+
+	/// \returns the number of clients the message was sent to
+	size_t sendToAll(const std::string & message);
+	size_t sendToAll(std::shared_ptr<const ofBuffer> buffer);
+
+	/// closes the connection, a Disconnected message is queued once the
+	/// server thread has released it
+	bool disconnectClient(int clientID);
+
+	/// \returns the number of bytes waiting to be sent to a client, useful
+	/// to detect slow clients
+	size_t getNumPendingBytes(int clientID);
+
+private:
+	class Poller;
+	struct Connection;
+
+	void threadedFunction();
+	void accept();
+	void read(Connection & connection);
+	bool parse(Connection & connection);
+	bool flush(Connection & connection);
+	void release(int clientID);
+	std::shared_ptr<Connection> getConnection(int clientID);
+	bool queue(Connection & connection, std::shared_ptr<const ofBuffer> && buffer, const char * data, size_t size);
+
+	ofxTCPSettings settings;
+	std::unique_ptr<Poller> poller;
+	intptr_t listenSocket;
+	std::atomic<bool> connected;
+	int nextID;
+
+	std::mutex connectionsMutex;
+	std::map<int, std::shared_ptr<Connection>> connections;
+	ofThreadChannel<ofxTCPMessage> messages;
+};
@@ -2,6 +2,12 @@
 #include <stdio.h>
 #include "ofxNetworkUtils.h"
 #include "ofUtils.h"
+#include <algorithm>
+#include <limits.h>
+
+#if !defined(TARGET_WIN32) && !defined(IOV_MAX)
+	#define IOV_MAX 1024
+#endif
 
 //--------------------------------------------------------------------------------
 bool ofxTCPManager::m_bWinsockInit= false;
@@ -395,6 +401,109 @@ int ofxTCPManager::SendAll(const char* pBuff, const int iSize)
 	return total;
 }
 
+//--------------------------------------------------------------------------------
+/// Return values:
+/// SOCKET_TIMEOUT indicates timeout
+/// SOCKET_ERROR in case of a problem.
+int ofxTCPManager::SendAllVectors(const char* const* pBuffs, const int* piSizes, const int iCount)
+{
+	if (m_hSocket == INVALID_SOCKET) return(SOCKET_ERROR);
+
+	int iSize = 0;
+	m_sendVectors.clear();
+	for (int i = 0; i < iCount; i++) {
+		if (piSizes[i] <= 0) continue;
+		#ifdef TARGET_WIN32
+			WSABUF vector;
+			vector.buf = (CHAR*)pBuffs[i];
+			vector.len = (ULONG)piSizes[i];
+		#else
+			iovec vector;
+			vector.iov_base = (void*)pBuffs[i];
+			vector.iov_len = piSizes[i];
+		#endif
+		m_sendVectors.push_back(vector);
+		iSize += piSizes[i];
+	}
+
+	auto timestamp = ofGetElapsedTimeMicros();
+	auto timeleftSecs = m_dwTimeoutSend;
+	auto timeleftMicros = 0;
+	int total = 0;
+	size_t first = 0;
+
+	while (total < iSize) {
+		if (m_dwTimeoutSend	!= NO_TIMEOUT){
+			auto ret = WaitSend(timeleftSecs,timeleftMicros);
+			if(ret!=0){
+				return ret;
+			}
+		}
+		#ifdef TARGET_WIN32
+			DWORD sent = 0;
+			int ret = WSASend(m_hSocket, &m_sendVectors[first], DWORD(m_sendVectors.size() - first), &sent, 0, NULL, NULL);
+			bool wouldBlock = ret == SOCKET_ERROR && WSAGetLastError() == WSAEWOULDBLOCK;
+			if (ret != SOCKET_ERROR) ret = sent;
+		#else
+			msghdr message;
+			memset(&message, 0, sizeof(message));
+			message.msg_iov = &m_sendVectors[first];
+			message.msg_iovlen = std::min<size_t>(m_sendVectors.size() - first, IOV_MAX);
+			int ret = sendmsg(m_hSocket, &message, 0);
+			bool wouldBlock = ret == SOCKET_ERROR && (errno == EAGAIN || errno == EWOULDBLOCK);
+		#endif
+		if (ret == SOCKET_ERROR) {
+			// let the caller keep the rest for later instead of losing
+			// track of what was already sent
+			if (nonBlocking && wouldBlock && total > 0) {
+				return total;
+			}
+			return SOCKET_ERROR;
+		}
+		total += ret;
+
+		// skip the buffers that were sent completely and advance
+		// into the one that was sent partially
+		size_t sent = ret;
+		while (sent > 0) {
+			#ifdef TARGET_WIN32
+				auto & vector = m_sendVectors[first];
+				if (sent >= vector.len) {
+					sent -= vector.len;
+					first++;
+				} else {
+					vector.buf += sent;
+					vector.len -= (ULONG)sent;
+					sent = 0;
+				}
+			#else
+				auto & vector = m_sendVectors[first];
+				if (sent >= vector.iov_len) {
+					sent -= vector.iov_len;
+					first++;
+				} else {
+					vector.iov_base = (char*)vector.iov_base + sent;
+					vector.iov_len -= sent;
+					sent = 0;
+				}
+			#endif
+		}
+
+		if (m_dwTimeoutSend	!= NO_TIMEOUT){
+			auto now = ofGetElapsedTimeMicros();
+			auto diff = now - timestamp;
+			if (diff > m_dwTimeoutSend * 1000000){
+				return SOCKET_TIMEOUT;
+			}
+			float timeFloat = m_dwTimeoutSend - diff/1000000.;
+			timeleftSecs = timeFloat;
+			timeleftMicros = (timeFloat - timeleftSecs) * 1000000;
+		}
+	}
+
+	return total;
+}
+
 
 //--------------------------------------------------------------------------------
 /// Return values:
@@ -64,6 +64,7 @@ SetTimeoutReceive()
 	#include <sys/socket.h>
 	#include <sys/time.h>
 	#include <sys/ioctl.h>
+	#include <sys/uio.h>
 
 #ifndef TARGET_ANDROID
 	#include <sys/signal.h>
@@ -182,6 +183,11 @@ public:
 	int  Send(const char* pBuff, const int iSize);
 	//all data will be sent guaranteed.
 	int  SendAll(const char* pBuff, const int iSize);
+	//sends several buffers one after another in as few system calls as
+	//possible, without joining them first. all data will be sent guaranteed
+	//except in non blocking mode where it returns what was sent if the
+	//socket can't accept more data
+	int  SendAllVectors(const char* const* pBuffs, const int* piSizes, const int iCount);
 	int  PeekReceive(char* pBuff, const int iSize);
 	int  Receive(char* pBuff, const int iSize);
 	int  ReceiveAll(char* pBuff, const int iSize);
@@ -231,6 +237,11 @@ private:
   unsigned long m_dwTimeoutReceive;
   unsigned long m_dwTimeoutAccept;
   bool nonBlocking;
+  #ifdef TARGET_WIN32
+	std::vector<WSABUF> m_sendVectors;
+  #else
+	std::vector<iovec> m_sendVectors;
+  #endif
   static bool m_bWinsockInit;
   bool m_closing;
 };
@@ -10,6 +10,9 @@ ofxTCPServer::ofxTCPServer(){
 	port		= 0;
 	str			= "";
 	messageDelimiter = "[/TCP]";
+	framing = OFXTCP_FRAMING_DELIMITER;
+	maxMessageSize = 16 * 1024 * 1024;
+	skipSendTerminator = false;
 	bClientBlocking = false;
 }
 
@@ -47,6 +50,9 @@ bool ofxTCPServer::setup(const ofxTCPSettings &settings){
 	connected		= true;
 	port           	= settings.port;
 	bClientBlocking	= settings.blocking;
+	framing			= settings.framing;
+	maxMessageSize	= settings.maxMessageSize;
+	skipSendTerminator = settings.skipSendTerminator;
 
 	setMessageDelimiter(settings.messageDelimiter);
 
@@ -347,6 +353,9 @@ void ofxTCPServer::threadedFunction(){
 			TCPConnections[acceptId] = client;
             TCPConnections[acceptId]->setupConnectionIdx(acceptId, bClientBlocking);
 			TCPConnections[acceptId]->setMessageDelimiter(messageDelimiter);
+			TCPConnections[acceptId]->setFraming(framing);
+			TCPConnections[acceptId]->maxMessageSize = maxMessageSize;
+			TCPConnections[acceptId]->skipSendTerminator = skipSendTerminator;
 			ofLogVerbose("ofxTCPServer") << "client " << acceptId << " connected on port " << TCPConnections[acceptId]->getPort();
 			if(acceptId == idCount) idCount++;
 			serverReady.notify_all();
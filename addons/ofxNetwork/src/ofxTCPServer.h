@@ -106,5 +106,8 @@ class ofxTCPServer : public ofThread{
 		int				idCount, port;
 		bool			bClientBlocking;
 		std::string			messageDelimiter;
+		ofxTCPFraming		framing;
+		size_t				maxMessageSize;
+		bool				skipSendTerminator;
 
 };
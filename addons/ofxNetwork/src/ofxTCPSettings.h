@@ -1,5 +1,17 @@
 #pragma once
 
+/// how a stream of bytes is split in messages
+enum ofxTCPFraming{
+	/// messages end with the message delimiter, [/TCP] by default.
+	/// ofxTCPClient::send() adds a 0 after the delimiter, see
+	/// ofxTCPSettings::skipSendTerminator
+	OFXTCP_FRAMING_DELIMITER,
+	/// every message starts with its size as a 4 bytes big endian integer
+	OFXTCP_FRAMING_LENGTH_PREFIX,
+	/// no framing, every chunk of data is delivered as it arrives
+	OFXTCP_FRAMING_NONE,
+};
+
 class ofxTCPSettings {
 public:
 	ofxTCPSettings(std::string _address, int _port) {
@@ -16,4 +28,16 @@ public:
 
 	std::string messageDelimiter = "[/TCP]";
 
+	ofxTCPFraming framing = OFXTCP_FRAMING_DELIMITER;
+	/// skip the 0 ofxTCPClient::send() adds after the delimiter when the
+	/// next message starts with it. Only for peers that send text with
+	/// send(), binary messages starting with a 0 would lose it.
+	/// ofxTCPClient::receive() always skips it
+	bool skipSendTerminator = false;
+	/// connections receiving a bigger message are closed
+	size_t maxMessageSize = 16 * 1024 * 1024;
+	/// maximum number of connected clients, 0 means no limit, used by
+	/// ofxTCPEventServer
+	size_t maxClients = 0;
+
 };
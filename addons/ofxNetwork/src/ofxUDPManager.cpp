@@ -8,6 +8,130 @@
 
 using namespace std;
 
+//--------------------------------------------------------------------------------
+ofxUDPPacketBuffer::ofxUDPPacketBuffer(size_t maxPackets, size_t maxPacketSize)
+{
+	Allocate(maxPackets, maxPacketSize);
+}
+
+//--------------------------------------------------------------------------------
+ofxUDPPacketBuffer::ofxUDPPacketBuffer(const ofxUDPPacketBuffer& other)
+{
+	*this = other;
+}
+
+//--------------------------------------------------------------------------------
+ofxUDPPacketBuffer& ofxUDPPacketBuffer::operator=(const ofxUDPPacketBuffer& other)
+{
+	//	the message headers point to our own memory, only the contents are copied
+	if (this != &other){
+		Allocate(other.maxPackets, other.maxPacketSize);
+		data = other.data;
+		sizes = other.sizes;
+		truncated = other.truncated;
+		addresses = other.addresses;
+		numPackets = other.numPackets;
+	}
+	return *this;
+}
+
+//--------------------------------------------------------------------------------
+ofxUDPPacketBuffer::ofxUDPPacketBuffer(ofxUDPPacketBuffer&& other)
+{
+	*this = std::move(other);
+}
+
+//--------------------------------------------------------------------------------
+ofxUDPPacketBuffer& ofxUDPPacketBuffer::operator=(ofxUDPPacketBuffer&& other)
+{
+	//	the vectors keep their memory when moved so the message headers
+	//	still point to it, the other buffer is left empty and can't receive
+	if (this != &other){
+		data = std::move(other.data);
+		sizes = std::move(other.sizes);
+		truncated = std::move(other.truncated);
+		addresses = std::move(other.addresses);
+		maxPackets = other.maxPackets;
+		maxPacketSize = other.maxPacketSize;
+		numPackets = other.numPackets;
+		#ifdef TARGET_LINUX
+			msgs = std::move(other.msgs);
+			iovecs = std::move(other.iovecs);
+		#endif
+		other.Allocate(0, 0);
+	}
+	return *this;
+}
+
+//--------------------------------------------------------------------------------
+void ofxUDPPacketBuffer::Allocate(size_t maxPackets, size_t maxPacketSize)
+{
+	this->maxPackets = maxPackets;
+	this->maxPacketSize = maxPacketSize;
+	numPackets = 0;
+	data.assign(maxPackets * maxPacketSize, 0);
+	sizes.assign(maxPackets, 0);
+	truncated.assign(maxPackets, 0);
+	addresses.assign(maxPackets, sockaddr_in());
+
+	#ifdef TARGET_LINUX
+		msgs.assign(maxPackets, mmsghdr());
+		iovecs.resize(maxPackets);
+		for (size_t i = 0; i < maxPackets; i++){
+			iovecs[i].iov_base = data.data() + i * maxPacketSize;
+			iovecs[i].iov_len = maxPacketSize;
+			msgs[i].msg_hdr.msg_name = &addresses[i];
+			msgs[i].msg_hdr.msg_iov = &iovecs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+	#endif
+}
+
+//--------------------------------------------------------------------------------
+size_t ofxUDPPacketBuffer::GetNumPackets() const
+{
+	return numPackets;
+}
+
+//--------------------------------------------------------------------------------
+const char* ofxUDPPacketBuffer::GetData(size_t packet) const
+{
+	return data.data() + packet * maxPacketSize;
+}
+
+//--------------------------------------------------------------------------------
+int ofxUDPPacketBuffer::GetSize(size_t packet) const
+{
+	return sizes[packet];
+}
+
+//--------------------------------------------------------------------------------
+bool ofxUDPPacketBuffer::IsTruncated(size_t packet) const
+{
+	return truncated[packet] != 0;
+}
+
+//--------------------------------------------------------------------------------
+bool ofxUDPPacketBuffer::GetRemoteAddr(size_t packet, string& address, int& port) const
+{
+	if (packet >= numPackets) return false;
+	address = inet_ntoa((in_addr)addresses[packet].sin_addr);
+	port = ntohs(addresses[packet].sin_port);
+	return true;
+}
+
+//--------------------------------------------------------------------------------
+size_t ofxUDPPacketBuffer::GetMaxPackets() const
+{
+	return maxPackets;
+}
+
+//--------------------------------------------------------------------------------
+size_t ofxUDPPacketBuffer::GetMaxPacketSize() const
+{
+	return maxPacketSize;
+}
+
 //--------------------------------------------------------------------------------
 bool ofxUDPManager::m_bWinsockInit= false;
 
@@ -429,6 +553,142 @@ int	ofxUDPManager::Receive(char* pBuff, const int iSize)
 	//	return(recvfrom(m_hSocket, pBuff, iSize, 0));
 }
 
+//--------------------------------------------------------------------------------
+///	Return values:
+///	SOCKET_TIMEOUT indicates timeout
+///	SOCKET_ERROR in	case of	a problem.
+int	ofxUDPManager::ReceiveMany(ofxUDPPacketBuffer& packets)
+{
+	packets.numPackets = 0;
+	if (m_hSocket == INVALID_SOCKET){
+		ofLogError("ofxUDPManager") << "INVALID_SOCKET";
+		return(SOCKET_ERROR);
+	}
+	if (packets.maxPackets == 0){
+		ofLogError("ofxUDPManager") << "ReceiveMany(): empty packet buffer";
+		return(SOCKET_ERROR);
+	}
+
+	if (m_dwTimeoutReceive	!= NO_TIMEOUT){
+		auto ret = WaitReceive(m_dwTimeoutReceive,0);
+		if(ret!=0){
+			return ret;
+		}
+	}
+
+	int received = 0;
+	#ifdef TARGET_LINUX
+		//	one call for all the waiting datagrams, only blocks for the first one
+		for (size_t i = 0; i < packets.maxPackets; i++){
+			packets.msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+			packets.msgs[i].msg_hdr.msg_flags = 0;
+		}
+		received = recvmmsg(m_hSocket, packets.msgs.data(), packets.maxPackets, MSG_WAITFORONE, nullptr);
+		for (int i = 0; i < received; i++){
+			packets.sizes[i] = packets.msgs[i].msg_len;
+			packets.truncated[i] = (packets.msgs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+		}
+	#else
+		for (size_t i = 0; i < packets.maxPackets; i++){
+			//	only wait for the first one
+			if (i > 0 && WaitReceive(0,0) != 0) break;
+
+			char* pBuff = packets.data.data() + i * packets.maxPacketSize;
+			#ifndef TARGET_WIN32
+				iovec vector;
+				vector.iov_base = pBuff;
+				vector.iov_len = packets.maxPacketSize;
+				msghdr msg;
+				memset(&msg, 0, sizeof(msg));
+				msg.msg_name = &packets.addresses[i];
+				msg.msg_namelen = sizeof(sockaddr_in);
+				msg.msg_iov = &vector;
+				msg.msg_iovlen = 1;
+				int ret = recvmsg(m_hSocket, &msg, 0);
+				packets.truncated[i] = ret >= 0 && (msg.msg_flags & MSG_TRUNC) != 0;
+			#else
+				int nLen = sizeof(sockaddr_in);
+				int ret = recvfrom(m_hSocket, pBuff, packets.maxPacketSize, 0, (sockaddr *)&packets.addresses[i], &nLen);
+				packets.truncated[i] = ret == SOCKET_ERROR && WSAGetLastError() == WSAEMSGSIZE;
+				if (packets.truncated[i]) ret = packets.maxPacketSize;
+			#endif
+			if (ret < 0){
+				if (i == 0) received = ret;
+				break;
+			}
+			packets.sizes[i] = ret;
+			received++;
+		}
+	#endif
+
+	if (received > 0)
+	{
+		packets.numPackets = received;
+		saClient = packets.addresses[received - 1];
+		canGetRemoteAddress= true;
+	}
+	else
+	{
+		canGetRemoteAddress = false;
+
+		//	if the network error is WOULDBLOCK, then return 0 instead of SOCKET_ERROR as it's not really a problem, just no data.
+		int SocketError = ofxNetworkCheckError();
+		if ( SocketError == OFXNETWORK_ERROR(WOULDBLOCK) )
+			return 0;
+	}
+
+	return received;
+}
+
+//--------------------------------------------------------------------------------
+///	Return values:
+///	SOCKET_TIMEOUT indicates timeout
+///	SOCKET_ERROR in	case of	a problem.
+int	ofxUDPManager::SendMany(const char* const* pBuffs, const int* piSizes, const int iCount)
+{
+	if (m_hSocket == INVALID_SOCKET) return(SOCKET_ERROR);
+
+	if (m_dwTimeoutSend	!= NO_TIMEOUT){
+		auto ret = WaitSend(m_dwTimeoutSend,0);
+		if(ret!=0){
+			return ret;
+		}
+	}
+
+	int sent = 0;
+	#ifdef TARGET_LINUX
+		m_sendMsgs.resize(iCount);
+		m_sendVectors.resize(iCount);
+		for (int i = 0; i < iCount; i++){
+			m_sendVectors[i].iov_base = (void*)pBuffs[i];
+			m_sendVectors[i].iov_len = piSizes[i];
+			memset(&m_sendMsgs[i], 0, sizeof(mmsghdr));
+			m_sendMsgs[i].msg_hdr.msg_name = &saClient;
+			m_sendMsgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+			m_sendMsgs[i].msg_hdr.msg_iov = &m_sendVectors[i];
+			m_sendMsgs[i].msg_hdr.msg_iovlen = 1;
+		}
+		while (sent < iCount){
+			int ret = sendmmsg(m_hSocket, m_sendMsgs.data() + sent, iCount - sent, 0);
+			if (ret < 0) break;
+			sent += ret;
+		}
+	#else
+		for (; sent < iCount; sent++){
+			int ret = sendto(m_hSocket, (char*)pBuffs[sent], piSizes[sent], 0, (sockaddr *)&saClient, sizeof(sockaddr));
+			if (ret < 0) break;
+		}
+	#endif
+
+	if (sent < iCount){
+		//	in non blocking mode the socket buffer can get full, return what was sent so far
+		int SocketError = ofxNetworkCheckError();
+		if (sent == 0 && SocketError != OFXNETWORK_ERROR(WOULDBLOCK))
+			return SOCKET_ERROR;
+	}
+	return sent;
+}
+
 void ofxUDPManager::SetTimeoutSend(int	timeoutInSeconds)
 {
 	m_dwTimeoutSend= timeoutInSeconds;
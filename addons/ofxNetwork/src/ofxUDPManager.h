@@ -52,6 +52,10 @@ x) close()
 optional:
 SetTimeoutReceive()
 
+Several datagrams can be received or sent at once with ReceiveMany() and
+SendMany(), using recvmmsg/sendmmsg where available. ReceiveMany() fills an
+ofxUDPPacketBuffer which is allocated once and reused on every call.
+
 UDP Multicast (receiving):
 --------------
 
@@ -67,6 +71,8 @@ x) Close()
 #include <string.h>
 #include <wchar.h>
 #include <stdio.h>
+#include <string>
+#include <vector>
 
 #ifndef TARGET_WIN32
 
@@ -83,6 +89,7 @@ x) Close()
 	#include <sys/socket.h>
 	#include <sys/time.h>
 	#include <sys/ioctl.h>
+	#include <sys/uio.h>
 
     //#ifdef TARGET_LINUX
         // linux needs this:
@@ -107,6 +114,44 @@ x) Close()
 //--------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------
 
+// Preallocated memory to receive several datagrams with a single call to
+// ofxUDPManager::ReceiveMany(), reused on every call.
+class ofxUDPPacketBuffer
+{
+public:
+	// maxPackets: max datagrams received per call
+	// maxPacketSize: bigger datagrams are truncated
+	ofxUDPPacketBuffer(size_t maxPackets = 64, size_t maxPacketSize = 2048);
+	ofxUDPPacketBuffer(const ofxUDPPacketBuffer& other);
+	ofxUDPPacketBuffer& operator=(const ofxUDPPacketBuffer& other);
+	ofxUDPPacketBuffer(ofxUDPPacketBuffer&& other);
+	ofxUDPPacketBuffer& operator=(ofxUDPPacketBuffer&& other);
+	void Allocate(size_t maxPackets, size_t maxPacketSize);
+
+	size_t GetNumPackets() const;	//	received by the last call to ReceiveMany
+	const char* GetData(size_t packet) const;
+	int  GetSize(size_t packet) const;
+	bool IsTruncated(size_t packet) const;
+	bool GetRemoteAddr(size_t packet, std::string& address, int& port) const;
+	size_t GetMaxPackets() const;
+	size_t GetMaxPacketSize() const;
+
+private:
+	friend class ofxUDPManager;
+
+	std::vector<char> data;
+	std::vector<int> sizes;
+	std::vector<char> truncated;
+	std::vector<sockaddr_in> addresses;
+	size_t maxPackets;
+	size_t maxPacketSize;
+	size_t numPackets;
+	#ifdef TARGET_LINUX
+		std::vector<mmsghdr> msgs;
+		std::vector<iovec> iovecs;
+	#endif
+};
+
 // Implementation of a UDP socket.
 class ofxUDPManager
 {
@@ -134,6 +179,12 @@ public:
 	int  SendAll(const char* pBuff, const int iSize);
 	int  PeekReceive();			//	return number of bytes waiting
 	int  Receive(char* pBuff, const int iSize);
+	//	receive as many waiting datagrams as fit in packets, waiting only for the first one.
+	//	returns the number of datagrams, 0 if none was waiting in non blocking mode
+	int  ReceiveMany(ofxUDPPacketBuffer& packets);
+	//	send iCount datagrams, with a single call where sendmmsg is available.
+	//	returns the number of datagrams sent
+	int  SendMany(const char* const* pBuffs, const int* piSizes, const int iCount);
 	void SetTimeoutSend(int timeoutInSeconds);
 	void SetTimeoutReceive(int timeoutInSeconds);
 	int  GetTimeoutSend();
@@ -173,4 +224,9 @@ protected:
 	static bool m_bWinsockInit;
 	bool canGetRemoteAddress;
 
+	#ifdef TARGET_LINUX
+		std::vector<mmsghdr> m_sendMsgs;
+		std::vector<iovec> m_sendVectors;
+	#endif
+
 };
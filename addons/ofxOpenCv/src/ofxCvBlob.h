@@ -11,7 +11,7 @@
 
 #pragma once
 
-#include "ofxCvConstants.h"
+#include "ofMain.h"
 
 
 class ofxCvBlob {
@@ -0,0 +1,426 @@
+
+#include "ofxCvBlobFinder.h"
+#include "ofxCvGrayscaleImage.h"
+
+
+
+//--------------------------------------------------------------------------------
+// neighbours in clockwise order starting to the right, y goes down
+static const int ofxCvNeighbourX[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+static const int ofxCvNeighbourY[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+
+// direction of the neighbour at (x+1, y+1) of a 3x3 square
+static const int ofxCvNeighbourDirection[9] = { 5, 6, 7, 4, -1, 0, 3, 2, 1 };
+
+//--------------------------------------------------------------------------------
+// runs point to a run with a smaller index so the root of a blob is its
+// first run in raster order
+static size_t ofxCvFindRoot( std::vector<size_t>& parents, size_t i ) {
+	while( parents[i] != i ) {
+		parents[i] = parents[parents[i]];
+		i = parents[i];
+	}
+	return i;
+}
+
+static void ofxCvUnite( std::vector<size_t>& parents, size_t a, size_t b ) {
+	a = ofxCvFindRoot( parents, a );
+	b = ofxCvFindRoot( parents, b );
+	if( a < b ) {
+		parents[b] = a;
+	} else if( b < a ) {
+		parents[a] = b;
+	}
+}
+
+// unite the runs of two consecutive rows that touch, including diagonally
+template<typename Run>
+static void ofxCvUniteRows( const std::vector<Run>& runs,
+                            std::vector<size_t>& parents,
+                            size_t prevBegin, size_t prevEnd,
+                            size_t rowBegin, size_t rowEnd ) {
+	size_t p = prevBegin;
+	for( size_t i = rowBegin; i < rowEnd; i++ ) {
+		const Run& run = runs[i];
+		while( p < prevEnd && runs[p].end < run.x ) {
+			p++;
+		}
+		for( size_t q = p; q < prevEnd && runs[q].x <= run.end; q++ ) {
+			ofxCvUnite( parents, q, i );
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------
+// pixels over the threshold in one channel pixels are looked for 8 at a
+// time, the high bit of every byte of over is set for bytes > threshold
+static inline uint64_t ofxCvBytesOver( uint64_t word, int threshold ) {
+	const uint64_t highs = 0x8080808080808080ULL;
+	uint64_t low = (word & ~highs) + 0x0101010101010101ULL * (127 - (threshold & 0x7f));
+	return threshold < 128 ? (low | word) & highs : low & word & highs;
+}
+
+static int ofxCvRunStart( const unsigned char* row, int x, int width, size_t bytesPerPixel, int threshold ) {
+	if( bytesPerPixel == 1 ) {
+		uint64_t word;
+		while( x + 8 <= width ) {
+			memcpy( &word, row + x, 8 );
+			if( ofxCvBytesOver( word, threshold ) ) {
+				break;
+			}
+			x += 8;
+		}
+	}
+	while( x < width && row[x * bytesPerPixel] <= threshold ) {
+		x++;
+	}
+	return x;
+}
+
+static int ofxCvRunEnd( const unsigned char* row, int x, int width, size_t bytesPerPixel, int threshold ) {
+	if( bytesPerPixel == 1 ) {
+		uint64_t word;
+		while( x + 8 <= width ) {
+			memcpy( &word, row + x, 8 );
+			if( ofxCvBytesOver( word, threshold ) != 0x8080808080808080ULL ) {
+				break;
+			}
+			x += 8;
+		}
+	}
+	while( x < width && row[x * bytesPerPixel] > threshold ) {
+		x++;
+	}
+	return x;
+}
+
+
+
+
+//--------------------------------------------------------------------------------
+ofxCvBlobFinder::ofxCvBlobFinder() {
+    _width = 0;
+    _height = 0;
+    threshold = 0;
+    bFindContours = true;
+    numStrips = 0;
+    data = nullptr;
+    stride = 0;
+    bytesPerPixel = 1;
+}
+
+//--------------------------------------------------------------------------------
+ofxCvBlobFinder::~ofxCvBlobFinder() {
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobFinder::setThreshold( int _threshold ) {
+	threshold = ofClamp( _threshold, 0, 255 );
+}
+
+//--------------------------------------------------------------------------------
+int ofxCvBlobFinder::getThreshold() const {
+	return threshold;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobFinder::setFindContours( bool _bFindContours ) {
+	bFindContours = _bFindContours;
+}
+
+//--------------------------------------------------------------------------------
+bool ofxCvBlobFinder::getFindContours() const {
+	return bFindContours;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobFinder::setNumStrips( int _numStrips ) {
+	numStrips = std::max( _numStrips, 0 );
+}
+
+//--------------------------------------------------------------------------------
+size_t ofxCvBlobFinder::getNumComponents() const {
+	return components.size();
+}
+
+//--------------------------------------------------------------------------------
+int ofxCvBlobFinder::findBlobs( ofxCvGrayscaleImage& input,
+								int minArea,
+								int maxArea,
+								int nConsidered,
+								bool bUseApproximation ) {
+	if( !input.bAllocated ) {
+		return findBlobs( nullptr, 0, 0, 1, 0, minArea, maxArea, nConsidered, bUseApproximation );
+	}
+	const IplImage* image = input.getCvImage();
+	return findBlobs( (const unsigned char*)image->imageData, image->width, image->height,
+	                  image->nChannels, image->widthStep, minArea, maxArea, nConsidered, bUseApproximation );
+}
+
+//--------------------------------------------------------------------------------
+int ofxCvBlobFinder::findBlobs( const ofPixels& pixels,
+								int minArea,
+								int maxArea,
+								int nConsidered,
+								bool bUseApproximation ) {
+	if( !pixels.isAllocated() ) {
+		return findBlobs( nullptr, 0, 0, 1, 0, minArea, maxArea, nConsidered, bUseApproximation );
+	}
+	return findBlobs( pixels.getData(), pixels.getWidth(), pixels.getHeight(), pixels.getNumChannels(),
+	                  pixels.getBytesStride(), minArea, maxArea, nConsidered, bUseApproximation );
+}
+
+//--------------------------------------------------------------------------------
+int ofxCvBlobFinder::findBlobs( const unsigned char* pixels,
+								int w,
+								int h,
+								int numChannels,
+								int widthStep,
+								int minArea,
+								int maxArea,
+								int nConsidered,
+								bool bUseApproximation ) {
+
+    _width = w;
+    _height = h;
+    blobs.clear();
+    components.clear();
+    if( pixels == nullptr || _width <= 0 || _height <= 0 || numChannels <= 0 ) {
+		return 0;
+    }
+    if( widthStep > 0 && widthStep < _width * numChannels ) {
+		ofLogError("ofxCvBlobFinder") << "findBlobs(): width step " << widthStep
+			<< " is smaller than a row, " << _width * numChannels << " bytes";
+		return 0;
+    }
+    data = pixels;
+    bytesPerPixel = numChannels;
+    stride = widthStep > 0 ? widthStep : _width * bytesPerPixel;
+
+	// a few strips per thread so threads that finish early can take
+	// another one, but not so thin that joining them costs more than
+	// labeling them
+	size_t nStrips = numStrips > 0 ? numStrips : ofGetTaskPool().getNumThreads() * 4;
+	nStrips = std::max<size_t>( 1, std::min<size_t>( nStrips, _height / 16 ) );
+	strips.resize( nStrips );
+	for( size_t i = 0; i < nStrips; i++ ) {
+		strips[i].y0 = _height * i / nStrips;
+		strips[i].y1 = _height * (i + 1) / nStrips;
+	}
+
+	ofParallelFor( 0, nStrips, [&](size_t i) {
+		labelStrip( strips[i] );
+	});
+
+	// join the strips, the runs of every strip keep their order so the
+	// root of every blob is still its first run in raster order
+	size_t numRuns = 0;
+	for( auto & strip : strips ) {
+		strip.offset = numRuns;
+		numRuns += strip.runs.size();
+	}
+	runs.resize( numRuns );
+	parents.resize( numRuns );
+	for( auto & strip : strips ) {
+		std::copy( strip.runs.begin(), strip.runs.end(), runs.begin() + strip.offset );
+		for( size_t i = 0; i < strip.parents.size(); i++ ) {
+			parents[strip.offset + i] = strip.parents[i] + strip.offset;
+		}
+	}
+	for( size_t i = 1; i < nStrips; i++ ) {
+		const Strip& prev = strips[i - 1];
+		const Strip& strip = strips[i];
+		ofxCvUniteRows( runs, parents,
+		                prev.offset + prev.lastRowBegin, prev.offset + prev.runs.size(),
+		                strip.offset, strip.offset + strip.firstRowEnd );
+	}
+
+	// every run points to a smaller index so walking them in order labels
+	// them with the label of their parent, already known, and the stats of
+	// every blob are accumulated from its runs on the way
+	for( size_t i = 0; i < numRuns; i++ ) {
+		const Run& run = runs[i];
+		size_t parent = parents[i];
+		if( parent == i ) {
+			parents[i] = components.size();
+			Component component;
+			component.area = 0;
+			component.m10 = 0;
+			component.m01 = 0;
+			component.minX = run.x;
+			component.minY = run.y;
+			component.maxX = run.end - 1;
+			component.maxY = run.y;
+			component.firstRun = i;
+			components.push_back( component );
+		} else {
+			parents[i] = parents[parent];
+		}
+		Component& component = components[parents[i]];
+		int length = run.end - run.x;
+		component.area += length;
+		component.m10 += length * (run.x + run.end - 1) * 0.5;
+		component.m01 += double(length) * run.y;
+		component.minX = std::min( component.minX, run.x );
+		component.maxX = std::max( component.maxX, run.end - 1 );
+		component.maxY = run.y;
+	}
+
+	// sort the blobs in range by area, largest first
+	considered.clear();
+	for( size_t i = 0; i < components.size(); i++ ) {
+		int64_t area = components[i].area;
+		if( area > minArea && area < maxArea ) {
+			considered.push_back( i );
+		}
+	}
+	size_t nBlobs = std::min<size_t>( std::max( nConsidered, 0 ), considered.size() );
+	std::partial_sort( considered.begin(), considered.begin() + nBlobs, considered.end(), [this](size_t a, size_t b) {
+		if( components[a].area != components[b].area ) {
+			return components[a].area > components[b].area;
+		}
+		return a < b;
+	});
+
+	blobs.resize( nBlobs );
+	for( size_t i = 0; i < nBlobs; i++ ) {
+		const Component& component = components[considered[i]];
+		ofxCvBlob& blob = blobs[i];
+		blob.area                = component.area;
+		blob.boundingRect.x      = component.minX;
+		blob.boundingRect.y      = component.minY;
+		blob.boundingRect.width  = component.maxX - component.minX + 1;
+		blob.boundingRect.height = component.maxY - component.minY + 1;
+		blob.centroid.x          = component.m10 / component.area;
+		blob.centroid.y          = component.m01 / component.area;
+	}
+
+	if( bFindContours ) {
+		ofParallelFor( 0, nBlobs, [&](size_t i) {
+			traceContour( components[considered[i]], bUseApproximation, blobs[i] );
+		});
+	}
+	data = nullptr;
+
+	return blobs.size();
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobFinder::labelStrip( Strip& strip ) const {
+	strip.runs.clear();
+	strip.parents.clear();
+	strip.firstRowEnd = 0;
+	strip.lastRowBegin = 0;
+
+	size_t prevBegin = 0;
+	size_t prevEnd = 0;
+	for( int y = strip.y0; y < strip.y1; y++ ) {
+		const unsigned char* row = data + y * stride;
+		size_t rowBegin = strip.runs.size();
+		int x = ofxCvRunStart( row, 0, _width, bytesPerPixel, threshold );
+		while( x < _width ) {
+			int end = ofxCvRunEnd( row, x, _width, bytesPerPixel, threshold );
+			strip.parents.push_back( strip.runs.size() );
+			strip.runs.push_back( { x, end, y } );
+			x = ofxCvRunStart( row, end, _width, bytesPerPixel, threshold );
+		}
+		size_t rowEnd = strip.runs.size();
+		ofxCvUniteRows( strip.runs, strip.parents, prevBegin, prevEnd, rowBegin, rowEnd );
+		if( y == strip.y0 ) {
+			strip.firstRowEnd = rowEnd;
+		}
+		prevBegin = rowBegin;
+		prevEnd = rowEnd;
+	}
+	strip.lastRowBegin = prevBegin;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobFinder::traceContour( const Component& component,
+									bool bUseApproximation,
+									ofxCvBlob& blob ) const {
+	auto inside = [&](int x, int y) {
+		return x >= 0 && y >= 0 && x < _width && y < _height
+			&& data[y * stride + x * bytesPerPixel] > threshold;
+	};
+
+	// moore neighbour tracing, clockwise from the first pixel of the blob
+	// in raster order, all the neighbours before it are outside. back is
+	// the direction of the last neighbour found outside, the search for
+	// the next pixel starts after it
+	const Run& first = runs[component.firstRun];
+	int x = first.x;
+	int y = first.y;
+	int back = 4;
+	int firstDirection = -1;
+	int lastDirection = -1;
+	blob.pts.clear();
+	blob.length = 0;
+	while( true ) {
+		int direction = -1;
+		for( int k = 1; k <= 8; k++ ) {
+			int d = (back + k) & 7;
+			if( inside( x + ofxCvNeighbourX[d], y + ofxCvNeighbourY[d] ) ) {
+				direction = d;
+				break;
+			}
+		}
+		if( direction < 0 ) {
+			// single pixel
+			blob.pts.push_back( ofDefaultVec3( x, y, 0 ) );
+			break;
+		}
+		// back at the start going the same way as the first time
+		if( firstDirection < 0 ) {
+			firstDirection = direction;
+		} else if( x == first.x && y == first.y && direction == firstDirection ) {
+			break;
+		}
+		if( !bUseApproximation || direction != lastDirection ) {
+			blob.pts.push_back( ofDefaultVec3( x, y, 0 ) );
+		}
+		int outside = (direction + 7) & 7;
+		int nextX = x + ofxCvNeighbourX[direction];
+		int nextY = y + ofxCvNeighbourY[direction];
+		back = ofxCvNeighbourDirection[(y + ofxCvNeighbourY[outside] - nextY + 1) * 3 + (x + ofxCvNeighbourX[outside] - nextX + 1)];
+		x = nextX;
+		y = nextY;
+		blob.length += (direction & 1) ? float(M_SQRT2) : 1.f;
+		lastDirection = direction;
+	}
+	blob.nPts = blob.pts.size();
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobFinder::draw( float x, float y, float w, float h ) const {
+
+    float scalex = 0.0f;
+    float scaley = 0.0f;
+    if( _width != 0 ) { scalex = w/_width; } else { scalex = 1.0f; }
+    if( _height != 0 ) { scaley = h/_height; } else { scaley = 1.0f; }
+
+    ofPushStyle();
+	// ---------------------------- draw the bounding rectangle
+	ofSetHexColor(0xDD00CC);
+    ofPushMatrix();
+    ofTranslate( x, y, 0.0 );
+    ofScale( scalex, scaley, 0.0 );
+
+	ofNoFill();
+	for( auto & blob : blobs ) {
+		ofDrawRectangle( blob.boundingRect );
+	}
+
+	// ---------------------------- draw the blobs
+	ofSetHexColor(0x00FFFF);
+
+	for( auto & blob : blobs ) {
+		ofBeginShape();
+		for( auto & pt : blob.pts ) {
+			ofVertex( pt.x, pt.y );
+		}
+		ofEndShape( true );
+	}
+	ofPopMatrix();
+	ofPopStyle();
+}
@@ -0,0 +1,130 @@
+/*
+* ofxCvBlobFinder.h
+*
+* Finds white blobs in grayscale pixels without going through OpenCV.
+* The rows are split in strips that are run length encoded and labeled
+* in parallel on the shared ofTaskPool, the strips are then joined and
+* the area, centroid and bounding box of every blob are accumulated
+* from its runs. Contours are only traced for the blobs that are
+* returned.
+*
+* Areas are in pixels, slightly larger than the polygonal area
+* ofxCvContourFinder calculates for the same blob, and holes aren't
+* reported. Use ofxCvBlobTracker to follow the blobs from frame to frame.
+*
+*/
+
+#pragma once
+
+
+#include "ofxCvBlob.h"
+
+class ofxCvGrayscaleImage;
+
+class ofxCvBlobFinder : public ofBaseDraws {
+
+  public:
+
+    std::vector<ofxCvBlob>  blobs;
+
+    ofxCvBlobFinder();
+    virtual  ~ofxCvBlobFinder();
+
+    virtual float getWidth() const { return _width; };    //set after first findBlobs call
+    virtual float getHeight() const { return _height; };  //set after first findBlobs call
+
+    // Pixels brighter than the threshold belong to blobs, 0 by default so
+    // any thresholded image works as is.
+    virtual void  setThreshold( int threshold );
+    virtual int   getThreshold() const;
+
+    // Without contours blobs only get their area, centroid and bounding
+    // box, pts is empty and length 0. Enabled by default.
+    virtual void  setFindContours( bool bFindContours );
+    virtual bool  getFindContours() const;
+
+    // Number of strips the rows are split in, 0 by default to use a few
+    // per thread of the task pool.
+    virtual void  setNumStrips( int numStrips );
+
+    // Only the first channel of pixels with more than one is used.
+    // Blobs with an area between minArea and maxArea are sorted by area
+    // and the largest nConsidered are returned.
+    virtual int  findBlobs( const ofPixels& pixels,
+                            int minArea, int maxArea,
+                            int nConsidered,
+                            bool bUseApproximation = true );
+                            // approximation = only the points where the
+                            // contour changes direction
+
+    // Reads the memory of the image through its width step, without
+    // copying it to ofPixels. The ROI is ignored.
+    virtual int  findBlobs( ofxCvGrayscaleImage& input,
+                            int minArea, int maxArea,
+                            int nConsidered,
+                            bool bUseApproximation = true );
+
+    // Any memory with rows of widthStep bytes, like the pixels of a
+    // camera, 0 for rows without padding.
+    virtual int  findBlobs( const unsigned char* pixels,
+                            int w, int h, int numChannels, int widthStep,
+                            int minArea, int maxArea,
+                            int nConsidered,
+                            bool bUseApproximation = true );
+
+    // Number of 8-connected blobs in the last image, before filtering them
+    // by area.
+    virtual size_t  getNumComponents() const;
+
+    using ofBaseDraws::draw;
+    virtual void  draw( float x, float y, float w, float h ) const;
+
+
+  protected:
+
+    // pixels [x, end) of row y
+    struct Run {
+        int x;
+        int end;
+        int y;
+    };
+
+    struct Strip {
+        int y0, y1;
+        std::vector<Run> runs;
+        std::vector<size_t> parents;   // union find of the runs in the strip
+        size_t firstRowEnd;            // runs of the first row are [0, firstRowEnd)
+        size_t lastRowBegin;           // runs of the last row are [lastRowBegin, runs.size())
+        size_t offset;                 // of the first run in all the runs
+    };
+
+    // area and moments of a blob, accumulated from its runs
+    struct Component {
+        uint64_t area;
+        double m10, m01;
+        int minX, minY, maxX, maxY;
+        size_t firstRun;               // topmost, leftmost run where tracing starts
+    };
+
+    int  _width;
+    int  _height;
+    int  threshold;
+    bool bFindContours;
+    int  numStrips;
+
+    std::vector<Strip>     strips;
+    std::vector<Run>       runs;
+    std::vector<size_t>    parents;
+    std::vector<Component> components;
+    std::vector<size_t>    considered;
+
+    // memory of the image being processed
+    const unsigned char*   data;
+    size_t                 stride;
+    size_t                 bytesPerPixel;
+
+    virtual void  labelStrip( Strip& strip ) const;
+    virtual void  traceContour( const Component& component,
+                                bool bUseApproximation, ofxCvBlob& blob ) const;
+
+};
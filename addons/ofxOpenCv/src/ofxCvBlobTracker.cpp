@@ -0,0 +1,186 @@
+
+#include "ofxCvBlobTracker.h"
+
+
+
+//--------------------------------------------------------------------------------
+static int64_t ofxCvGridCell( int64_t cellX, int64_t cellY ) {
+	return int64_t( (uint64_t(cellY) << 32) ^ (uint64_t(cellX) & 0xffffffff) );
+}
+
+static bool sort_cell_compare( const std::pair<int64_t, size_t>& a, const std::pair<int64_t, size_t>& b ) {
+	return a.first < b.first;
+}
+
+
+
+
+//--------------------------------------------------------------------------------
+ofxCvBlobTracker::ofxCvBlobTracker() {
+	maxDistance = 50;
+	persistence = 3;
+	nextId = 0;
+}
+
+//--------------------------------------------------------------------------------
+ofxCvBlobTracker::~ofxCvBlobTracker() {
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobTracker::setMaxDistance( float _maxDistance ) {
+	maxDistance = std::max( _maxDistance, 1.f );
+}
+
+//--------------------------------------------------------------------------------
+float ofxCvBlobTracker::getMaxDistance() const {
+	return maxDistance;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobTracker::setPersistence( int frames ) {
+	persistence = std::max( frames, 0 );
+}
+
+//--------------------------------------------------------------------------------
+int ofxCvBlobTracker::getPersistence() const {
+	return persistence;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobTracker::reset() {
+	blobs.clear();
+	newIds.clear();
+	removedIds.clear();
+	nextId = 0;
+}
+
+//--------------------------------------------------------------------------------
+const std::vector<ofxCvTrackedBlob>& ofxCvBlobTracker::track( const std::vector<ofxCvBlob>& newBlobs ) {
+	newIds.clear();
+	removedIds.clear();
+
+	cells.clear();
+	for( size_t i = 0; i < newBlobs.size(); i++ ) {
+		int64_t cellX = floor( newBlobs[i].centroid.x / maxDistance );
+		int64_t cellY = floor( newBlobs[i].centroid.y / maxDistance );
+		cells.emplace_back( ofxCvGridCell( cellX, cellY ), i );
+	}
+	std::sort( cells.begin(), cells.end(), sort_cell_compare );
+
+	// every pair closer than maxDistance, the closest ones are matched
+	// first
+	matches.clear();
+	float maxDistance2 = maxDistance * maxDistance;
+	for( size_t i = 0; i < blobs.size(); i++ ) {
+		const ofxCvTrackedBlob& tracked = blobs[i];
+		auto expected = tracked.centroid + tracked.velocity * float(tracked.lostFrames + 1);
+		int64_t cellX = floor( expected.x / maxDistance );
+		int64_t cellY = floor( expected.y / maxDistance );
+		for( int64_t y = cellY - 1; y <= cellY + 1; y++ ) {
+			for( int64_t x = cellX - 1; x <= cellX + 1; x++ ) {
+				auto cell = std::make_pair( ofxCvGridCell( x, y ), size_t(0) );
+				auto range = std::equal_range( cells.begin(), cells.end(), cell, sort_cell_compare );
+				for( auto it = range.first; it != range.second; ++it ) {
+					float dx = newBlobs[it->second].centroid.x - expected.x;
+					float dy = newBlobs[it->second].centroid.y - expected.y;
+					float distance2 = dx * dx + dy * dy;
+					if( distance2 <= maxDistance2 ) {
+						matches.push_back( { distance2, i, it->second } );
+					}
+				}
+			}
+		}
+	}
+	std::sort( matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+		if( a.distance2 != b.distance2 ) {
+			return a.distance2 < b.distance2;
+		}
+		return a.tracked < b.tracked || (a.tracked == b.tracked && a.blob < b.blob);
+	});
+
+	blobMatches.assign( newBlobs.size(), -1 );
+	trackedMatches.assign( blobs.size(), -1 );
+	for( auto & match : matches ) {
+		if( trackedMatches[match.tracked] < 0 && blobMatches[match.blob] < 0 ) {
+			blobMatches[match.blob] = match.tracked;
+			trackedMatches[match.tracked] = match.blob;
+		}
+	}
+
+	// tracked blobs keep their order, new ones get higher ids so the
+	// result stays sorted by id
+	nextBlobs.clear();
+	for( size_t i = 0; i < blobs.size(); i++ ) {
+		const ofxCvTrackedBlob& tracked = blobs[i];
+		if( trackedMatches[i] >= 0 ) {
+			const ofxCvBlob& found = newBlobs[trackedMatches[i]];
+			nextBlobs.push_back( ofxCvTrackedBlob() );
+			ofxCvTrackedBlob& next = nextBlobs.back();
+			static_cast<ofxCvBlob&>( next ) = found;
+			next.id = tracked.id;
+			next.age = tracked.age + 1;
+			next.lostFrames = 0;
+			next.velocity = (found.centroid - tracked.centroid) / float(tracked.lostFrames + 1);
+		} else if( tracked.lostFrames < persistence ) {
+			nextBlobs.push_back( tracked );
+			nextBlobs.back().age++;
+			nextBlobs.back().lostFrames++;
+		} else {
+			removedIds.push_back( tracked.id );
+		}
+	}
+	for( size_t i = 0; i < newBlobs.size(); i++ ) {
+		if( blobMatches[i] < 0 ) {
+			nextBlobs.push_back( ofxCvTrackedBlob() );
+			ofxCvTrackedBlob& next = nextBlobs.back();
+			static_cast<ofxCvBlob&>( next ) = newBlobs[i];
+			next.id = nextId++;
+			newIds.push_back( next.id );
+		}
+	}
+	std::swap( blobs, nextBlobs );
+
+	return blobs;
+}
+
+//--------------------------------------------------------------------------------
+const std::vector<int>& ofxCvBlobTracker::getNewIds() const {
+	return newIds;
+}
+
+//--------------------------------------------------------------------------------
+const std::vector<int>& ofxCvBlobTracker::getRemovedIds() const {
+	return removedIds;
+}
+
+//--------------------------------------------------------------------------------
+const ofxCvTrackedBlob* ofxCvBlobTracker::getBlob( int id ) const {
+	auto it = std::lower_bound( blobs.begin(), blobs.end(), id, [](const ofxCvTrackedBlob& blob, int id) {
+		return blob.id < id;
+	});
+	if( it != blobs.end() && it->id == id ) {
+		return &*it;
+	}
+	return nullptr;
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvBlobTracker::draw( float x, float y ) const {
+	ofPushStyle();
+	ofNoFill();
+	for( auto & blob : blobs ) {
+		if( blob.lostFrames > 0 ) {
+			continue;
+		}
+		ofSetHexColor(0x00FFFF);
+		ofBeginShape();
+		for( auto & pt : blob.pts ) {
+			ofVertex( x + pt.x, y + pt.y );
+		}
+		ofEndShape( true );
+		ofSetHexColor(0xff0099);
+		ofDrawRectangle( x + blob.boundingRect.x, y + blob.boundingRect.y, blob.boundingRect.width, blob.boundingRect.height );
+		ofDrawBitmapString( ofToString( blob.id ), x + blob.centroid.x, y + blob.centroid.y );
+	}
+	ofPopStyle();
+}
@@ -0,0 +1,96 @@
+/*
+* ofxCvBlobTracker.h
+*
+* Gives the blobs found in every frame, by ofxCvBlobFinder or
+* ofxCvContourFinder, an id that stays the same from frame to frame.
+* Each blob is matched to the closest tracked blob, where it was
+* expected to be after moving as much as in the last frame, up to a
+* maximum distance. Blobs that disappear are kept for a few frames in
+* case they come back, like a finger losing contact with a multi-touch
+* table for a frame.
+*
+*/
+
+#pragma once
+
+
+#include "ofxCvBlob.h"
+
+class ofxCvTrackedBlob : public ofxCvBlob {
+
+    public:
+
+        int                 id;
+        int                 age;         // frames since it appeared
+        int                 lostFrames;  // frames since it was last found, 0 if found in this one
+        ofDefaultVec3       velocity;    // centroid movement per frame
+
+        ofxCvTrackedBlob() {
+            id          = -1;
+            age         = 0;
+            lostFrames  = 0;
+            velocity    = ofDefaultVec3( 0, 0, 0 );
+        }
+};
+
+class ofxCvBlobTracker {
+
+  public:
+
+    // found in the last frame or lost for less frames than the
+    // persistence, sorted by id
+    std::vector<ofxCvTrackedBlob>  blobs;
+
+    ofxCvBlobTracker();
+    virtual  ~ofxCvBlobTracker();
+
+    // Blobs further than this from where a tracked blob was expected are
+    // new blobs, 50 pixels by default.
+    virtual void   setMaxDistance( float maxDistance );
+    virtual float  getMaxDistance() const;
+
+    // Frames a blob that wasn't found is kept before removing it, 3 by
+    // default, 0 removes blobs as soon as they aren't found.
+    virtual void  setPersistence( int frames );
+    virtual int   getPersistence() const;
+
+    // Match the blobs of a new frame with the tracked ones.
+    virtual const std::vector<ofxCvTrackedBlob>&  track( const std::vector<ofxCvBlob>& newBlobs );
+
+    // Ids of the blobs that appeared and were removed in the last frame.
+    virtual const std::vector<int>&  getNewIds() const;
+    virtual const std::vector<int>&  getRemovedIds() const;
+
+    // nullptr if there's no blob with that id.
+    virtual const ofxCvTrackedBlob*  getBlob( int id ) const;
+
+    // Forget every blob, ids start from 0 again.
+    virtual void  reset();
+
+    virtual void  draw( float x = 0, float y = 0 ) const;
+
+
+  protected:
+
+    struct Match {
+        float distance2;
+        size_t tracked;
+        size_t blob;
+    };
+
+    float  maxDistance;
+    int    persistence;
+    int    nextId;
+
+    std::vector<int>     newIds;
+    std::vector<int>     removedIds;
+
+    // new blobs sorted by cell of a maxDistance wide grid, only the ones
+    // in the cells around every tracked blob are compared with it
+    std::vector<std::pair<int64_t, size_t>>  cells;
+    std::vector<Match>             matches;
+    std::vector<int>               blobMatches;
+    std::vector<int>               trackedMatches;
+    std::vector<ofxCvTrackedBlob>  nextBlobs;
+
+};
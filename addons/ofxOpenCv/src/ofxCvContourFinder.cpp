@@ -4,13 +4,16 @@
 
 
 //--------------------------------------------------------------------------------
-static bool sort_carea_compare( const CvSeq* a, const CvSeq* b) {
-	
-	// use opencv to calc size, then sort based on size
-	float areaa = cvContourArea(a, CV_WHOLE_SEQ);
-	float areab = cvContourArea(b, CV_WHOLE_SEQ);
-	
-	return (areaa > areab);
+// contours with their area, calculated once for filtering, sorting and
+// the blobs. signedArea keeps the orientation that tells holes apart
+struct ofxCvContourArea {
+	float area;
+	float signedArea;
+	CvSeq* seq;
+};
+
+static bool sort_carea_compare( const ofxCvContourArea& a, const ofxCvContourArea& b) {
+	return (a.area > b.area);
 }
 
 
@@ -21,12 +24,22 @@ ofxCvContourFinder::ofxCvContourFinder() {
     _width = 0;
     _height = 0;
 	myMoments = (CvMoments*)malloc( sizeof(CvMoments) );
+	contour_storage = cvCreateMemStorage( 1000 );
+	storage = nullptr;
+	bAnchorIsPct = false;
 	reset();
 }
 
 //--------------------------------------------------------------------------------
 ofxCvContourFinder::~ofxCvContourFinder() {
 	free( myMoments );
+	cvReleaseMemStorage( &contour_storage );
+	for( auto roiStorage : roiStorages ) {
+		cvReleaseMemStorage( &roiStorage );
+	}
+	for( auto roiCopy : roiCopies ) {
+		cvReleaseMat( &roiCopy );
+	}
 }
 
 //--------------------------------------------------------------------------------
@@ -37,20 +50,7 @@ void ofxCvContourFinder::reset() {
 }
 
 //--------------------------------------------------------------------------------
-int ofxCvContourFinder::findContours( ofxCvGrayscaleImage&  input,
-									  int minArea,
-									  int maxArea,
-									  int nConsidered,
-									  bool bFindHoles,
-                                      bool bUseApproximation) {
-
-    // get width/height disregarding ROI
-    IplImage* ipltemp = input.getCvImage();
-    _width = ipltemp->width;
-    _height = ipltemp->height;
-
-	reset();
-
+void ofxCvContourFinder::prepareInputCopy( ofxCvGrayscaleImage& input ) {
 	// opencv will clober the image it detects contours on, so we want to
     // copy it into a copy before we detect contours.  That copy is allocated
     // if necessary (necessary = (a) not allocated or (b) wrong size)
@@ -69,89 +69,233 @@ int ofxCvContourFinder::findContours( ofxCvGrayscaleImage&  input,
         inputCopy.clear();
         inputCopy.allocate( _width, _height );
 	}
+}
 
+//--------------------------------------------------------------------------------
+int ofxCvContourFinder::findContours( ofxCvGrayscaleImage&  input,
+									  int minArea,
+									  int maxArea,
+									  int nConsidered,
+									  bool bFindHoles,
+                                      bool bUseApproximation) {
+
+    // get width/height disregarding ROI
+    IplImage* ipltemp = input.getCvImage();
+    _width = ipltemp->width;
+    _height = ipltemp->height;
+
+	reset();
+
+	prepareInputCopy( input );
     inputCopy.setROI( input.getROI() );
     inputCopy = input;
 
+	cvClearMemStorage( contour_storage );
+	findBlobs( inputCopy.getCvImage(), contour_storage, minArea, maxArea, nConsidered,
+               bFindHoles, bUseApproximation, cvPoint(0,0), cvSeqBlobs, blobs );
+
+    nBlobs = blobs.size();
+	return nBlobs;
+
+}
+
+//--------------------------------------------------------------------------------
+int ofxCvContourFinder::findContoursInPlace( ofxCvGrayscaleImage&  input,
+											 int minArea,
+											 int maxArea,
+											 int nConsidered,
+											 bool bFindHoles,
+											 bool bUseApproximation) {
+
+    IplImage* ipltemp = input.getCvImage();
+    _width = ipltemp->width;
+    _height = ipltemp->height;
+
+	reset();
+
+	cvClearMemStorage( contour_storage );
+	findBlobs( ipltemp, contour_storage, minArea, maxArea, nConsidered,
+               bFindHoles, bUseApproximation, cvPoint(0,0), cvSeqBlobs, blobs );
+	input.flagImageChanged();
+
+    nBlobs = blobs.size();
+	return nBlobs;
+
+}
+
+//--------------------------------------------------------------------------------
+int ofxCvContourFinder::findContours( ofxCvGrayscaleImage&  input,
+									  const std::vector<ofRectangle>& rois,
+									  int minArea,
+									  int maxArea,
+									  int nConsidered,
+									  bool bFindHoles,
+                                      bool bUseApproximation,
+                                      bool bInPlace) {
+
+    IplImage* ipltemp = input.getCvImage();
+    _width = ipltemp->width;
+    _height = ipltemp->height;
+
+	reset();
+
+	// the regions are in image coordinates, ignore the ROI while
+	// processing them
+	CvRect inputRoi = cvGetImageROI( ipltemp );
+	cvResetImageROI( ipltemp );
+
+	while( roiStorages.size() < rois.size() ) {
+		roiStorages.push_back( cvCreateMemStorage( 1000 ) );
+	}
+	if( !bInPlace && roiCopies.size() < rois.size() ) {
+		roiCopies.resize( rois.size(), nullptr );
+	}
+	roiBlobs.resize( rois.size() );
+
+	ofParallelFor( 0, rois.size(), [&](size_t i) {
+		roiBlobs[i].clear();
+		int x = (int)ofClamp( rois[i].x, 0, _width );
+		int y = (int)ofClamp( rois[i].y, 0, _height );
+		int w = (int)ofClamp( rois[i].x + rois[i].width, 0, _width ) - x;
+		int h = (int)ofClamp( rois[i].y + rois[i].height, 0, _height ) - y;
+		if( w <= 0 || h <= 0 ) {
+			return;
+		}
+
+		// every region gets its own header on the memory of the image so
+		// they don't share the ROI of the IplImage
+		CvMat region;
+		cvGetSubRect( ipltemp, &region, cvRect( x, y, w, h ) );
+		CvArr* scratch = &region;
+		if( !bInPlace ) {
+			// cvFindContours thresholds its input to 0 and 1 and clears a
+			// 1 pixel border, a copy per region keeps overlapping regions
+			// from changing each other
+			CvMat*& roiCopy = roiCopies[i];
+			if( roiCopy == nullptr || roiCopy->cols != w || roiCopy->rows != h ) {
+				cvReleaseMat( &roiCopy );
+				roiCopy = cvCreateMat( h, w, CV_8UC1 );
+			}
+			cvCopy( &region, roiCopy );
+			scratch = roiCopy;
+		}
+
+		std::vector<CvSeq*> seqs;
+		cvClearMemStorage( roiStorages[i] );
+		findBlobs( scratch, roiStorages[i], minArea, maxArea, nConsidered,
+                   bFindHoles, bUseApproximation, cvPoint( x, y ), seqs, roiBlobs[i] );
+	});
+
+	if( inputRoi.width != _width || inputRoi.height != _height ) {
+		cvSetImageROI( ipltemp, inputRoi );
+	}
+	if( bInPlace ) {
+		input.flagImageChanged();
+	}
+
+	for( auto & blobsInRoi : roiBlobs ) {
+		blobs.insert( blobs.end(), blobsInRoi.begin(), blobsInRoi.end() );
+	}
+
+    nBlobs = blobs.size();
+	return nBlobs;
+
+}
+
+//--------------------------------------------------------------------------------
+const std::vector<ofxCvBlob>& ofxCvContourFinder::getRoiBlobs( size_t roi ) const {
+	return roiBlobs[roi];
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvContourFinder::findBlobs( CvArr* image,
+									CvMemStorage* contourStorage,
+									int minArea,
+									int maxArea,
+									int nConsidered,
+									bool bFindHoles,
+									bool bUseApproximation,
+									CvPoint offset,
+									std::vector<CvSeq*>& seqs,
+									std::vector<ofxCvBlob>& result ) const {
+
 	CvSeq* contour_list = NULL;
-	contour_storage = cvCreateMemStorage( 1000 );
-	storage	= cvCreateMemStorage( 1000 );
 
 	int retrieve_mode
         = (bFindHoles) ? CV_RETR_LIST : CV_RETR_EXTERNAL;
-	cvFindContours( inputCopy.getCvImage(), contour_storage, &contour_list,
-                    sizeof(CvContour), retrieve_mode, bUseApproximation ? CV_CHAIN_APPROX_SIMPLE : CV_CHAIN_APPROX_NONE );
+	cvFindContours( image, contourStorage, &contour_list,
+                    sizeof(CvContour), retrieve_mode, bUseApproximation ? CV_CHAIN_APPROX_SIMPLE : CV_CHAIN_APPROX_NONE,
+                    offset );
 	CvSeq* contour_ptr = contour_list;
 
 	// put the contours from the linked list, into an array for sorting
+	std::vector<ofxCvContourArea> contours;
 	while( (contour_ptr != NULL) ) {
-		float area = cvContourArea(contour_ptr, CV_WHOLE_SEQ, bFindHoles); // oriented=true for holes
+		float signedArea = cvContourArea(contour_ptr, CV_WHOLE_SEQ, bFindHoles); // oriented=true for holes
+		float area = signedArea;
 		if(bFindHoles && area < 0) { // areas can be non negative in the case of holes
 			area = fabs(area);
 		}
 		if((area > minArea) && (area < maxArea)) {
-			cvSeqBlobs.push_back(contour_ptr);
+			contours.push_back({area, signedArea, contour_ptr});
 		}
 		contour_ptr = contour_ptr->h_next;
 	}
 
 
 	// sort the pointers based on size
-	if( cvSeqBlobs.size() > 1 ) {
-        sort( cvSeqBlobs.begin(), cvSeqBlobs.end(), sort_carea_compare );
+	if( contours.size() > 1 ) {
+        sort( contours.begin(), contours.end(), sort_carea_compare );
+	}
+	for( auto & contour : contours ) {
+		seqs.push_back( contour.seq );
 	}
 
 
-	// now, we have cvSeqBlobs.size() contours, sorted by size in the array
-    // cvSeqBlobs let's get the data out and into our structures that we like
-	for( int i = 0; i < MIN(nConsidered, (int)cvSeqBlobs.size()); i++ ) {
-		blobs.push_back( ofxCvBlob() );
-		float area = cvContourArea( cvSeqBlobs[i], CV_WHOLE_SEQ, bFindHoles ); // oriented=true for holes
-		CvRect rect	= cvBoundingRect( cvSeqBlobs[i], 0 );
-		cvMoments( cvSeqBlobs[i], myMoments );
-
-		blobs[i].area                     = bFindHoles ? fabs(area) : area; // only return positive areas
-		blobs[i].length 			      = cvArcLength(cvSeqBlobs[i]);
-		blobs[i].boundingRect.x           = rect.x;
-		blobs[i].boundingRect.y           = rect.y;
-		blobs[i].boundingRect.width       = rect.width;
-		blobs[i].boundingRect.height      = rect.height;
-		blobs[i].centroid.x 			  = (myMoments->m10 / myMoments->m00);
-		blobs[i].centroid.y 			  = (myMoments->m01 / myMoments->m00);
+	// now, we have seqs.size() contours, sorted by size in the array
+    // seqs let's get the data out and into our structures that we like
+	CvMoments moments;
+	size_t first = result.size();
+	for( int i = 0; i < MIN(nConsidered, (int)seqs.size()); i++ ) {
+		result.push_back( ofxCvBlob() );
+		ofxCvBlob& blob = result[first + i];
+		float area = contours[i].signedArea;
+		CvRect rect	= cvBoundingRect( seqs[i], 0 );
+		cvMoments( seqs[i], &moments );
+
+		blob.area                     = bFindHoles ? fabs(area) : area; // only return positive areas
+		blob.length 			      = cvArcLength(seqs[i]);
+		blob.boundingRect.x           = rect.x;
+		blob.boundingRect.y           = rect.y;
+		blob.boundingRect.width       = rect.width;
+		blob.boundingRect.height      = rect.height;
+		blob.centroid.x 			  = (moments.m10 / moments.m00);
+		blob.centroid.y 			  = (moments.m01 / moments.m00);
 
 		if(bFindHoles) {
 			// for some reason, changing the orientation when looking for holes
 			// yields negative areas for non holes and positive areas for holes
 			//
 			// negating the value here works, even though it feels like a hack
-			blobs[i].hole                 = -area < 0 ? true : false; // negative area denotes a hole
+			blob.hole                 = -area < 0 ? true : false; // negative area denotes a hole
 		}
 		else {
-			blobs[i].hole                 = false; // no holes
+			blob.hole                 = false; // no holes
 		}
 
 		// get the points for the blob:
 		CvPoint           pt;
 		CvSeqReader       reader;
-		cvStartReadSeq( cvSeqBlobs[i], &reader, 0 );
+		cvStartReadSeq( seqs[i], &reader, 0 );
 
-    	for( int j=0; j < cvSeqBlobs[i]->total; j++ ) {
+		blob.pts.reserve( seqs[i]->total );
+    	for( int j=0; j < seqs[i]->total; j++ ) {
 			CV_READ_SEQ_ELEM( pt, reader );
-            blobs[i].pts.push_back( ofPoint((float)pt.x, (float)pt.y) );
+            blob.pts.push_back( ofPoint((float)pt.x, (float)pt.y) );
 		}
-		blobs[i].nPts = blobs[i].pts.size();
+		blob.nPts = blob.pts.size();
 
 	}
-
-    nBlobs = blobs.size();
-
-	// Free the storage memory.
-	// Warning: do this inside this function otherwise a strange memory leak
-	if( contour_storage != NULL ) { cvReleaseMemStorage(&contour_storage); }
-	if( storage != NULL ) { cvReleaseMemStorage(&storage); }
-
-	return nBlobs;
-
 }
 
 //--------------------------------------------------------------------------------
@@ -37,6 +37,30 @@ class ofxCvContourFinder : public ofBaseDraws {
                                // of the contour, if the contour runs
                                // along a straight line, for example...
 
+    // Same as findContours but uses input as the scratch buffer instead of
+    // copying it, the contents of input are destroyed: OpenCV leaves it
+    // thresholded to 0 and 1 with a black 1 pixel border.
+    virtual int  findContoursInPlace( ofxCvGrayscaleImage& input,
+                                      int minArea, int maxArea,
+                                      int nConsidered, bool bFindHoles,
+                                      bool bUseApproximation = true);
+
+    // Finds the contours in each region of input in parallel on the shared
+    // ofTaskPool, for example one region per camera in an image with the
+    // frames of several cameras. Regions are in image coordinates,
+    // nConsidered is the number of blobs per region. blobs gets the blobs
+    // of every region in order, in image coordinates, getRoiBlobs the
+    // blobs of one of them. With bInPlace the regions of input are
+    // destroyed like in findContoursInPlace instead of copied, and
+    // mustn't overlap.
+    virtual int  findContours( ofxCvGrayscaleImage& input,
+                               const std::vector<ofRectangle>& rois,
+                               int minArea, int maxArea,
+                               int nConsidered, bool bFindHoles,
+                               bool bUseApproximation = true,
+                               bool bInPlace = false);
+    virtual const std::vector<ofxCvBlob>&  getRoiBlobs( size_t roi ) const;
+
     virtual void  draw() const { draw(0,0, _width, _height); };
     virtual void  draw( float x, float y ) const { draw(x,y, _width, _height); };
     virtual void  draw( float x, float y, float w, float h ) const;
@@ -54,14 +78,25 @@ class ofxCvContourFinder : public ofBaseDraws {
     int  _width;
     int  _height;
     ofxCvGrayscaleImage     inputCopy;
-    CvMemStorage*           contour_storage;
+    CvMemStorage*           contour_storage;  // kept between calls and cleared
     CvMemStorage*           storage;
     CvMoments*              myMoments;
     std::vector<CvSeq*>     cvSeqBlobs;  //these will become blobs
+
+    std::vector<std::vector<ofxCvBlob>> roiBlobs;
+    std::vector<CvMemStorage*> roiStorages;   // one per region processed in parallel
+    std::vector<CvMat*>     roiCopies;   // scratch copy of each region when not in place
     
     ofPoint  anchor;
     bool  bAnchorIsPct;      
 
     virtual void reset();
+    virtual void prepareInputCopy( ofxCvGrayscaleImage& input );
+    virtual void findBlobs( CvArr* image, CvMemStorage* contourStorage,
+                            int minArea, int maxArea,
+                            int nConsidered, bool bFindHoles,
+                            bool bUseApproximation, CvPoint offset,
+                            std::vector<CvSeq*>& seqs,
+                            std::vector<ofxCvBlob>& result ) const;
 
 };
@@ -21,6 +21,7 @@ ofxCvImage::ofxCvImage() {
     cvImageTemp = nullptr;
     bAnchorIsPct = false;
     cvImage = nullptr;
+    bExternalPixels = false;
     ipldepth = 0;
     iplchannels = 0;
 }
@@ -61,9 +62,14 @@ void ofxCvImage::clear() {
 
 	if (bAllocated == true){
 		if (width > 0 && height > 0){
-			cvReleaseImage( &cvImage );
+			if( bExternalPixels ){
+				cvReleaseImageHeader( &cvImage );
+			}else{
+				cvReleaseImage( &cvImage );
+			}
 			cvReleaseImage( &cvImageTemp );
 		}
+		bExternalPixels = false;
         pixels.clear();
         bPixelsDirty = true;
         bRoiPixelsDirty = true;
@@ -795,6 +801,9 @@ void ofxCvImage::swapTemp() {
 		getROI().height != height )
     {
 		cvCopy( cvImageTemp, cvImage );
+	} else if( bExternalPixels ) {
+		// the result has to end up in the external memory
+		cvCopy( cvImageTemp, cvImage );
 	} else {
 		IplImage*  temp;
 		temp = cvImage;
@@ -846,6 +855,87 @@ void ofxCvImage::setRoiFromPixels( const ofPixels & pixels ){
 	setRoiFromPixels(pixels.getData(),pixels.getWidth(),pixels.getHeight());
 }
 
+//--------------------------------------------------------------------------------
+void ofxCvImage::setFromExternalPixels( ofPixels & pixels ){
+	if( ipldepth != IPL_DEPTH_8U || (int)pixels.getNumChannels() != iplchannels ){
+		ofLogError("ofxCvImage") << "setFromExternalPixels(): pixels have " << pixels.getNumChannels()
+			<< " channels of 8 bits, this image needs " << iplchannels << " channels of " << (ipldepth & 255) << " bits";
+		return;
+	}
+	setFromExternalPixels(pixels.getData(),pixels.getWidth(),pixels.getHeight(),pixels.getBytesStride());
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvImage::setFromExternalPixels( unsigned char* _pixels, int w, int h, int widthStep ){
+	if( w == 0 || h == 0 ){
+		ofLogError("ofxCvImage") << "setFromExternalPixels(): width and height are zero";
+		return;
+	}
+	int rowBytes = w * iplchannels * ((ipldepth & 255) / 8);
+	if( widthStep == 0 ){
+		widthStep = rowBytes;
+	}else if( widthStep < rowBytes ){
+		ofLogError("ofxCvImage") << "setFromExternalPixels(): width step " << widthStep
+			<< " is smaller than a row, " << rowBytes << " bytes";
+		return;
+	}
+
+	if( bAllocated && w == width && h == height ){
+		// same size, keep the temp image and only point to the new memory
+		if( !bExternalPixels ){
+			cvReleaseImage( &cvImage );
+			cvImage = cvCreateImageHeader( cvSize(w,h), ipldepth, iplchannels );
+			cvResetImageROI( cvImageTemp );
+		}
+		cvSetData( cvImage, _pixels, widthStep );
+	}else{
+		clear();
+		cvImage = cvCreateImageHeader( cvSize(w,h), ipldepth, iplchannels );
+		cvSetData( cvImage, _pixels, widthStep );
+		cvImageTemp	= cvCreateImage( cvSize(w,h), ipldepth, iplchannels );
+
+		width = w;
+		height = h;
+		bAllocated = true;
+
+		if( bUseTexture ) {
+			allocatePixels(w,h);
+			allocateTexture();
+		}
+	}
+	bExternalPixels = true;
+	flagImageChanged();
+}
+
+//--------------------------------------------------------------------------------
+void ofxCvImage::setFromExternalRoi( ofxCvImage& mom, const ofRectangle& roi ){
+	if( !mom.bAllocated ){
+		ofLogError("ofxCvImage") << "setFromExternalRoi(): source image not allocated";
+		return;
+	}
+	if( mom.ipldepth != ipldepth || mom.iplchannels != iplchannels ){
+		ofLogError("ofxCvImage") << "setFromExternalRoi(): source image type doesn't match";
+		return;
+	}
+	int x = (int)ofClamp(roi.x, 0, mom.width);
+	int y = (int)ofClamp(roi.y, 0, mom.height);
+	int w = (int)ofClamp(roi.x + roi.width, 0, mom.width) - x;
+	int h = (int)ofClamp(roi.y + roi.height, 0, mom.height) - y;
+	if( w <= 0 || h <= 0 ){
+		ofLogError("ofxCvImage") << "setFromExternalRoi(): region of interest outside of the image";
+		return;
+	}
+	IplImage* src = mom.cvImage;
+	int bytesPerPixel = src->nChannels * ((src->depth & 255) / 8);
+	unsigned char* roi_ptr = (unsigned char*)src->imageData + y*src->widthStep + x*bytesPerPixel;
+	setFromExternalPixels( roi_ptr, w, h, src->widthStep );
+}
+
+//--------------------------------------------------------------------------------
+bool ofxCvImage::isUsingExternalPixels() const{
+	return bExternalPixels;
+}
+
 //--------------------------------------------------------------------------------
 ofPixels& ofxCvImage::getPixels(){
 	if(!bAllocated) {
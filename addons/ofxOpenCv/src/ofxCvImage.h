@@ -70,6 +70,21 @@ class ofxCvImage : public ofBaseImage {
     virtual void  operator = ( const ofxCvFloatImage& mom ) = 0;
     virtual void  operator = ( const ofxCvShortImage& mom ) = 0;
     virtual void  operator = ( const IplImage* mom );
+
+    // Wrap external memory instead of copying it, the image reads and
+    // writes directly into it so the memory has to stay valid while the
+    // image uses it. widthStep is the number of bytes from one row to the
+    // next, 0 for rows without padding. Allocating, resizing or calling
+    // clear() stops using the external memory.
+    //
+    virtual void  setFromExternalPixels( ofPixels & pixels );
+    virtual void  setFromExternalPixels( unsigned char* _pixels, int w, int h, int widthStep = 0 );
+    // Wrap a region of mom as this whole image. Views of regions that don't
+    // overlap can be processed from different threads at the same time.
+    // Operations on mom that swap its buffers, like blur or erode,
+    // invalidate the view until this is called again.
+    virtual void  setFromExternalRoi( ofxCvImage& mom, const ofRectangle& roi );
+    virtual bool  isUsingExternalPixels() const;
     
     virtual void  operator -= ( ofxCvImage& mom );
     virtual void  operator += ( ofxCvImage& mom );
@@ -171,6 +186,8 @@ class ofxCvImage : public ofBaseImage {
     IplImage*  cvImage;
     IplImage*  cvImageTemp;   // this is typically swapped back into cvImage
                               // after an image operation with swapImage()
+    bool bExternalPixels;     // cvImage is only a header on memory owned
+                              // by someone else, never swapped or released
                               
     int ipldepth;             // IPL_DEPTH_8U, IPL_DEPTH_16U, IPL_DEPTH_32F, ...
     int iplchannels;          // 1, 3, 4, ...
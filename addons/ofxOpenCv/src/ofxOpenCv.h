@@ -15,5 +15,7 @@
 //--------------------------
 // contours and blobs
 #include "ofxCvContourFinder.h"
+#include "ofxCvBlobFinder.h"
+#include "ofxCvBlobTracker.h"
 
 #include "ofxCvHaarFinder.h"
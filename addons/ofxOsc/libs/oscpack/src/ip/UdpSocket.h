@@ -119,6 +119,9 @@ public:
 	// for calls to Send()
 	void Connect( const IpEndpointName& remoteEndpoint, bool enableBroadcast = false );
 	void Send( const char *data, std::size_t size );
+	// Send several packets to the connected endpoint, with a single
+	// system call where sendmmsg is available
+	void SendMany( const char * const *data, const std::size_t *sizes, std::size_t count );
     void SendTo( const IpEndpointName& remoteEndpoint, const char *data, std::size_t size );
 
 
@@ -215,6 +215,38 @@ public:
         send( socket_, data, size, 0 );
 	}
 
+	void SendMany( const char * const *data, const std::size_t *sizes, std::size_t count )
+	{
+		assert( isConnected_ );
+
+#if defined(__linux__)
+		// sendmmsg in chunks that fit in the stack
+		const std::size_t maxChunk = 64;
+		struct mmsghdr msgs[maxChunk];
+		struct iovec iovecs[maxChunk];
+		std::size_t sent = 0;
+		while( sent < count ){
+			std::size_t chunk = std::min( count - sent, maxChunk );
+			std::memset( msgs, 0, sizeof(msgs[0]) * chunk );
+			for( std::size_t i = 0; i < chunk; ++i ){
+				iovecs[i].iov_base = (void*)data[sent + i];
+				iovecs[i].iov_len = sizes[sent + i];
+				msgs[i].msg_hdr.msg_iov = &iovecs[i];
+				msgs[i].msg_hdr.msg_iovlen = 1;
+			}
+			int ret = sendmmsg( socket_, msgs, (unsigned int)chunk, 0 );
+			if( ret <= 0 ){
+				// skip the packet that failed like Send() would
+				ret = 1;
+			}
+			sent += ret;
+		}
+#else
+		for( std::size_t i = 0; i < count; ++i )
+			send( socket_, data[i], sizes[i], 0 );
+#endif
+	}
+
     void SendTo( const IpEndpointName& remoteEndpoint, const char *data, std::size_t size )
 	{
 		sendToAddr_.sin_addr.s_addr = htonl( remoteEndpoint.address );
@@ -303,6 +335,11 @@ void UdpSocket::Send( const char *data, std::size_t size )
 	impl_->Send( data, size );
 }
 
+void UdpSocket::SendMany( const char * const *data, const std::size_t *sizes, std::size_t count )
+{
+	impl_->SendMany( data, sizes, count );
+}
+
 void UdpSocket::SendTo( const IpEndpointName& remoteEndpoint, const char *data, std::size_t size )
 {
 	impl_->SendTo( remoteEndpoint, data, size );
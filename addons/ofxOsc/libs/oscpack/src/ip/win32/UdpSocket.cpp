@@ -208,6 +208,14 @@ public:
         send( socket_, data, (int)size, 0 );
 	}
 
+	void SendMany( const char * const *data, const std::size_t *sizes, std::size_t count )
+	{
+		assert( isConnected_ );
+
+		for( std::size_t i = 0; i < count; ++i )
+			send( socket_, data[i], (int)sizes[i], 0 );
+	}
+
     void SendTo( const IpEndpointName& remoteEndpoint, const char *data, std::size_t size )
 	{
 		sendToAddr_.sin_addr.s_addr = htonl( remoteEndpoint.address );
@@ -296,6 +304,11 @@ void UdpSocket::Send( const char *data, std::size_t size )
 	impl_->Send( data, size );
 }
 
+void UdpSocket::SendMany( const char * const *data, const std::size_t *sizes, std::size_t count )
+{
+	impl_->SendMany( data, sizes, count );
+}
+
 void UdpSocket::SendTo( const IpEndpointName& remoteEndpoint, const char *data, std::size_t size )
 {
 	impl_->SendTo( remoteEndpoint, data, size );
@@ -3,6 +3,7 @@
 #include "ofxOscMessage.h"
 #include "ofLog.h"
 #include "ofUtils.h"
+#include <cstring>
 
 //--------------------------------------------------------------
 ofxOscMessage::ofxOscMessage() : remoteHost(""), remotePort(0) {}
@@ -22,10 +23,27 @@ ofxOscMessage& ofxOscMessage::operator=(const ofxOscMessage &other){
 	return copy(other);
 }
 
+//--------------------------------------------------------------
+ofxOscMessage::ofxOscMessage(ofxOscMessage &&other) noexcept : remotePort(0){
+	*this = std::move(other);
+}
+
+//--------------------------------------------------------------
+ofxOscMessage& ofxOscMessage::operator=(ofxOscMessage &&other) noexcept{
+	// swap so the memory of this message can be reused by the other one,
+	// which is left empty
+	std::swap(address, other.address);
+	std::swap(args, other.args);
+	std::swap(argsData, other.argsData);
+	std::swap(remoteHost, other.remoteHost);
+	std::swap(remotePort, other.remotePort);
+	other.clear();
+	return *this;
+}
+
 //--------------------------------------------------------------
 ofxOscMessage& ofxOscMessage::copy(const ofxOscMessage &other){
 	if(this == &other) return *this;
-	clear();
 
 	// copy address & remote info
 	address = other.address;
@@ -33,66 +51,19 @@ ofxOscMessage& ofxOscMessage::copy(const ofxOscMessage &other){
 	remotePort = other.remotePort;
 
 	// copy arguments
-    for(std::size_t i = 0; i < other.args.size(); ++i){
-		switch(other.getArgType(i)){
-			case OFXOSC_TYPE_TRUE: case OFXOSC_TYPE_FALSE:
-				args.push_back(new ofxOscArgBool(other.getArgAsBool(i)));
-				break;
-			case OFXOSC_TYPE_INT32:
-				args.push_back(new ofxOscArgInt32(other.getArgAsInt32(i)));
-				break;
-			case OFXOSC_TYPE_INT64:
-				args.push_back(new ofxOscArgInt64(other.getArgAsInt64(i)));
-				break;
-			case OFXOSC_TYPE_FLOAT:
-				args.push_back(new ofxOscArgFloat(other.getArgAsFloat(i)));
-				break;
-			case OFXOSC_TYPE_DOUBLE:
-				args.push_back(new ofxOscArgDouble(other.getArgAsDouble(i)));
-				break;
-			case OFXOSC_TYPE_STRING:
-				args.push_back(new ofxOscArgString(other.getArgAsString(i)));
-				break;
-			case OFXOSC_TYPE_SYMBOL:
-				args.push_back(new ofxOscArgSymbol(other.getArgAsSymbol(i)));
-				break;
-			case OFXOSC_TYPE_CHAR:
-				args.push_back(new ofxOscArgChar(other.getArgAsChar(i)));
-				break;
-			case OFXOSC_TYPE_MIDI_MESSAGE:
-				args.push_back(new ofxOscArgMidiMessage(other.getArgAsMidiMessage(i)));
-				break;
-			case OFXOSC_TYPE_TRIGGER:
-				args.push_back(new ofxOscArgTrigger());
-				break;
-			case OFXOSC_TYPE_TIMETAG:
-				args.push_back(new ofxOscArgTimetag(other.getArgAsTimetag(i)));
-				break;
-			case OFXOSC_TYPE_BLOB:
-				args.push_back(new ofxOscArgBlob(other.getArgAsBlob(i)));
-				break;
-			case OFXOSC_TYPE_RGBA_COLOR:
-				args.push_back(new ofxOscArgRgbaColor(other.getArgAsRgbaColor(i)));
-				break;
-			default:
-				ofLogError("ofxOscMessage") << "copy(): bad argument type "
-					<< other.getArgType(i) << " '" << (char) other.getArgType(i) << "'";	
-				break;
-		}
-	}
-	
+	args = other.args;
+	argsData = other.argsData;
+
 	return *this;
 }
 
 //--------------------------------------------------------------
 void ofxOscMessage::clear(){
-	address = "";
-	remoteHost = "";
+	address.clear();
+	remoteHost.clear();
 	remotePort = 0;
-	for(unsigned int i = 0; i < args.size(); ++i){
-		delete args[i];
-	}
 	args.clear();
+	argsData.clear();
 }
 
 //--------------------------------------------------------------
@@ -134,7 +105,7 @@ ofxOscArgType ofxOscMessage::getArgType(std::size_t index) const{
 		return OFXOSC_TYPE_INDEXOUTOFBOUNDS;
 	}
 	else{
-		return args[index]->getType();
+		return args[index].type;
 	}
 }
 
@@ -146,15 +117,16 @@ std::string ofxOscMessage::getArgTypeName(std::size_t index) const{
 		return "INDEX OUT OF BOUNDS";
 	}
 	else{
-		return args[index]->getTypeName();
+		return std::string(1, (char)args[index].type);
 	}
 }
 
 //--------------------------------------------------------------
 std::string ofxOscMessage::getTypeString() const {
-	std::string types = "";
+	std::string types;
+	types.reserve(args.size());
 	for(std::size_t i = 0; i < args.size(); ++i) {
-		types += args[i]->getTypeName();
+		types += (char)args[i].type;
 	}
 	return types;
 }
@@ -172,21 +144,21 @@ std::int32_t ofxOscMessage::getArgAsInt32(std::size_t index) const{
 			ofLogWarning("ofxOscMessage")
 				<< "getArgAsInt32(): converting int64 to int32 for argument "
 				<< index;
-			return (std::int32_t)((ofxOscArgInt64*)args[index])->get();
+			return (std::int32_t)args[index].int64Value;
 		}
 		else if (getArgType(index) == OFXOSC_TYPE_FLOAT){
-			return (std::int32_t)((ofxOscArgFloat*)args[index])->get();
+			return (std::int32_t)args[index].floatValue;
 		}
 		else if (getArgType(index) == OFXOSC_TYPE_DOUBLE){
 			// warn about possible lack of precision
 			ofLogWarning("ofxOscMessage")
 				<< "getArgAsInt32(): converting double to int32 for argument "
 				<< index;
-			return (std::int32_t)((ofxOscArgDouble*)args[index])->get();
+			return (std::int32_t)args[index].doubleValue;
 		}
 		else if(getArgType(index) == OFXOSC_TYPE_TRUE || 
 			    getArgType(index) == OFXOSC_TYPE_FALSE){
-			return (std::int32_t)((ofxOscArgBool*)args[index])->get();
+			return (std::int32_t)(args[index].type == OFXOSC_TYPE_TRUE);
 		}
 		else{
 			ofLogError("ofxOscMessage") << "getArgAsInt32(): argument "
@@ -195,7 +167,7 @@ std::int32_t ofxOscMessage::getArgAsInt32(std::size_t index) const{
 		}
 	}
 	else{
-		return ((ofxOscArgInt32*)args[index])->get();
+		return args[index].int32Value;
 	}
 }
 
@@ -203,17 +175,17 @@ std::int32_t ofxOscMessage::getArgAsInt32(std::size_t index) const{
 std::int64_t ofxOscMessage::getArgAsInt64(std::size_t index) const{
 	if(getArgType(index) != OFXOSC_TYPE_INT64){
 		if(getArgType(index) == OFXOSC_TYPE_INT32){
-			return (std::int64_t)((ofxOscArgInt32*)args[index])->get();
+			return (std::int64_t)args[index].int32Value;
 		}
 		else if(getArgType(index) == OFXOSC_TYPE_FLOAT){
-			return (std::int64_t)((ofxOscArgFloat*)args[index])->get();
+			return (std::int64_t)args[index].floatValue;
 		}
 		else if(getArgType(index) == OFXOSC_TYPE_DOUBLE){
-			return (std::int64_t)((ofxOscArgDouble*)args[index])->get();
+			return (std::int64_t)args[index].doubleValue;
 		}
 		else if(getArgType(index) == OFXOSC_TYPE_TRUE ||
 			    getArgType(index) == OFXOSC_TYPE_FALSE){
-			return (std::int64_t)((ofxOscArgBool*)args[index])->get();
+			return (std::int64_t)(args[index].type == OFXOSC_TYPE_TRUE);
 		}
 		else{
 			ofLogError("ofxOscMessage") << "getArgAsInt64(): argument "
@@ -222,7 +194,7 @@ std::int64_t ofxOscMessage::getArgAsInt64(std::size_t index) const{
 		}
 	}
 	else{
-		return ((ofxOscArgInt64*)args[index])->get();
+		return args[index].int64Value;
 	}
 }
 
@@ -230,25 +202,25 @@ std::int64_t ofxOscMessage::getArgAsInt64(std::size_t index) const{
 float ofxOscMessage::getArgAsFloat(std::size_t index) const{
 	if(getArgType(index) != OFXOSC_TYPE_FLOAT){
 		if(getArgType(index) == OFXOSC_TYPE_INT32){
-			return (float)((ofxOscArgInt32*)args[index])->get();
+			return (float)args[index].int32Value;
 		}
 		else if(getArgType(index) == OFXOSC_TYPE_INT64){
 			// warn about possible lack of precision
 			ofLogWarning("ofxOscMessage")
 				<< "getArgAsFloat(): converting int64 to float for argument "
 				<< index;
-			return (float)((ofxOscArgInt64*)args[index])->get();
+			return (float)args[index].int64Value;
 		}
 		else if(getArgType(index) == OFXOSC_TYPE_DOUBLE){
 			// warn about possible lack of precision
 			ofLogWarning("ofxOscMessage")
 				<< "getArgAsFloat(): converting double to float for argument "
 				<< index;
-			return (float)((ofxOscArgDouble*)args[index])->get();
+			return (float)args[index].doubleValue;
 		}
 		else if(getArgType(index) == OFXOSC_TYPE_TRUE ||
 			    getArgType(index) == OFXOSC_TYPE_FALSE){
-			return (float)((ofxOscArgBool*)args[index])->get();
+			return (float)(args[index].type == OFXOSC_TYPE_TRUE);
 		}
 		else{
 			ofLogError("ofxOscMessage") << "getArgAsFloat(): argument "
@@ -257,7 +229,7 @@ float ofxOscMessage::getArgAsFloat(std::size_t index) const{
 		}
 	}
 	else{
-		return ((ofxOscArgFloat*)args[index])->get();
+		return args[index].floatValue;
 	}
 }
 
@@ -265,17 +237,17 @@ float ofxOscMessage::getArgAsFloat(std::size_t index) const{
 double ofxOscMessage::getArgAsDouble(std::size_t index) const{
 	if(getArgType(index) != OFXOSC_TYPE_DOUBLE){
 		if(getArgType(index) == OFXOSC_TYPE_INT32){
-			return (double)((ofxOscArgInt32*)args[index])->get();
+			return (double)args[index].int32Value;
 		}
 		else if(getArgType(index) == OFXOSC_TYPE_INT64){
-			return (double)((ofxOscArgInt64*)args[index])->get();
+			return (double)args[index].int64Value;
 		}
 		else if(getArgType(index) == OFXOSC_TYPE_FLOAT){
-			return (double)((ofxOscArgFloat*)args[index])->get();
+			return (double)args[index].floatValue;
 		}
 		else if( getArgType(index) == OFXOSC_TYPE_TRUE ||
 			     getArgType(index) == OFXOSC_TYPE_FALSE){
-			return (double)((ofxOscArgBool*)args[index])->get();
+			return (double)(args[index].type == OFXOSC_TYPE_TRUE);
 		}
 		else{
 			ofLogError("ofxOscMessage") << "getArgAsDouble(): argument "
@@ -284,7 +256,7 @@ double ofxOscMessage::getArgAsDouble(std::size_t index) const{
 		}
 	}
 	else{
-		return ((ofxOscArgDouble*)args[index])->get();
+		return args[index].doubleValue;
 	}
 }
 
@@ -296,34 +268,34 @@ std::string ofxOscMessage::getArgAsString(std::size_t index) const{
 			ofLogWarning("ofxOscMessage")
 				<< "getArgAsString(): converting int32 to string for argument "
 				<< index;
-			return ofToString(((ofxOscArgInt32*)args[index])->get());
+			return ofToString(args[index].int32Value);
 		}
 		else if(getArgType(index) == OFXOSC_TYPE_INT64){
 			ofLogWarning("ofxOscMessage")
 				<< "getArgAsString(): converting int64 to string for argument "
 				<< index;
-			return ofToString(((ofxOscArgInt64*)args[index])->get());
+			return ofToString(args[index].int64Value);
 		}
 		else if(getArgType(index) == OFXOSC_TYPE_FLOAT){
 			ofLogWarning("ofxOscMessage")
 				<< "getArgAsString(): converting float to string for argument "
 				<< index;
-			return ofToString(((ofxOscArgFloat*)args[index])->get());
+			return ofToString(args[index].floatValue);
 		}
 		else if(getArgType(index) == OFXOSC_TYPE_DOUBLE){
 			ofLogWarning("ofxOscMessage")
 				<< "getArgAsString(): converting double to string for argument "
 				<< index;
-			return ofToString(((ofxOscArgDouble*)args[index])->get());
+			return ofToString(args[index].doubleValue);
 		}
 		else if(getArgType(index) == OFXOSC_TYPE_SYMBOL){
-			return ((ofxOscArgSymbol*)args[index])->get();
+			return getArgData(index);
 		}
 		else if(getArgType(index) == OFXOSC_TYPE_CHAR){
 			ofLogWarning("ofxOscMessage")
 				<< "getArgAsString(): converting char to string for argument "
 				<< index;
-			return ofToString(((ofxOscArgChar*)args[index])->get());
+			return ofToString(args[index].charValue);
 		}
 		else{
 			ofLogError("ofxOscMessage")
@@ -333,7 +305,7 @@ std::string ofxOscMessage::getArgAsString(std::size_t index) const{
 		}
 	}
 	else{
-		return ((ofxOscArgString*)args[index])->get();
+		return getArgData(index);
 	}
 }
 
@@ -345,34 +317,34 @@ std::string ofxOscMessage::getArgAsSymbol(std::size_t index) const{
 			ofLogWarning("ofxOscMessage")
 				<< "getArgAsSymbol(): converting int32 to symbol (string) "
 				<< "for argument " << index;
-			return ofToString(((ofxOscArgInt32*)args[index])->get());
+			return ofToString(args[index].int32Value);
 		}
 		else if(getArgType(index) == OFXOSC_TYPE_INT64){
 			ofLogWarning("ofxOscMessage")
 				<< "getArgAsSymbol(): converting int64 to symbol (string) "
 				<< "for argument " << index;
-			return ofToString(((ofxOscArgInt64*)args[index])->get());
+			return ofToString(args[index].int64Value);
 		}
 		else if(getArgType(index) == OFXOSC_TYPE_FLOAT){
 			ofLogWarning("ofxOscMessage")
 				<< "getArgAsSymbol(): converting float to symbol (string) "
 				<< "for argument " << index;
-			return ofToString(((ofxOscArgFloat*)args[index])->get());
+			return ofToString(args[index].floatValue);
 		}
 		else if(getArgType(index) == OFXOSC_TYPE_DOUBLE){
 			ofLogWarning("ofxOscMessage")
 				<< "getArgAsSymbol(): converting double to symbol (string) "
 				<< "for argument " << index;
-			return ofToString(((ofxOscArgDouble*)args[index])->get());
+			return ofToString(args[index].doubleValue);
 		}
 		else if(getArgType(index) == OFXOSC_TYPE_STRING){
-			return ((ofxOscArgString*)args[index])->get();
+			return getArgData(index);
 		}
 		else if(getArgType(index) == OFXOSC_TYPE_CHAR){
 			ofLogWarning("ofxOscMessage")
 				<< "getArgAsSymbol(): converting char to symbol (string) "
 				<< "for argument " << index;
-			return ofToString(((ofxOscArgChar*)args[index])->get());
+			return ofToString(args[index].charValue);
 		}
 		else{
 			ofLogError("ofxOscMessage") << "getArgAsSymbol(): argument "
@@ -381,14 +353,14 @@ std::string ofxOscMessage::getArgAsSymbol(std::size_t index) const{
 		}
 	}
 	else{
-		return ((ofxOscArgSymbol*)args[index])->get();
+		return getArgData(index);
 	}
 }
 
 //--------------------------------------------------------------
 char ofxOscMessage::getArgAsChar(std::size_t index) const{
 	if(getArgType(index) == OFXOSC_TYPE_CHAR){
-		return ((ofxOscArgChar*)args[index])->get();
+		return args[index].charValue;
 	}
 	else{
 		ofLogError("ofxOscMessage") << "getArgAsChar(): argument "
@@ -400,7 +372,7 @@ char ofxOscMessage::getArgAsChar(std::size_t index) const{
 //--------------------------------------------------------------
 std::uint32_t ofxOscMessage::getArgAsMidiMessage(std::size_t index) const{
 	if(getArgType(index) == OFXOSC_TYPE_MIDI_MESSAGE){
-		return ((ofxOscArgMidiMessage*)args[index])->get();
+		return args[index].uint32Value;
 	}
 	else{
 		ofLogError("ofxOscMessage") << "getArgAsMidiMessage(): argument "
@@ -413,17 +385,17 @@ std::uint32_t ofxOscMessage::getArgAsMidiMessage(std::size_t index) const{
 bool ofxOscMessage::getArgAsBool(std::size_t index) const{
 	switch(getArgType(index)){
 		case OFXOSC_TYPE_TRUE: case OFXOSC_TYPE_FALSE:
-			return ((ofxOscArgBool*)args[index])->get();
+			return (args[index].type == OFXOSC_TYPE_TRUE);
 		case OFXOSC_TYPE_INT32:
-			return ((ofxOscArgInt32*)args[index])->get() > 0;
+			return args[index].int32Value > 0;
 		case OFXOSC_TYPE_INT64:
-			return ((ofxOscArgInt64*)args[index])->get() > 0;
+			return args[index].int64Value > 0;
 		case OFXOSC_TYPE_FLOAT:
-			return ((ofxOscArgFloat*)args[index])->get() > 0;
+			return args[index].floatValue > 0;
 		case OFXOSC_TYPE_DOUBLE:
-			return ((ofxOscArgDouble*)args[index])->get() > 0;
+			return args[index].doubleValue > 0;
 		case OFXOSC_TYPE_STRING: case OFXOSC_TYPE_SYMBOL:
-			return ((ofxOscArgString*)args[index])->get() == "true";
+			return getArgData(index) == "true";
 		default:
 			ofLogError("ofxOscMessage") << "getArgAsBool(): argument "
 				<< index << " is not a boolean interpretable value";
@@ -439,7 +411,7 @@ bool ofxOscMessage::getArgAsNone(std::size_t index) const{
 		return false;
 	}
 	else{
-		return ((ofxOscArgNone*)args[index])->get();
+		return true;
 	}
 }
 
@@ -451,7 +423,7 @@ bool ofxOscMessage::getArgAsTrigger(std::size_t index) const{
 		return false;
 	}
 	else{
-		return ((ofxOscArgTrigger*)args[index])->get();
+		return true;
 	}
 }
 
@@ -473,7 +445,7 @@ std::uint64_t ofxOscMessage::getArgAsTimetag(std::size_t index) const{
 			ofLogWarning("ofxOscMessage")
 				<< "getArgAsTimetag(): converting double to Timetag "
 				<< "for argument " << index;
-			return (std::uint64_t)((ofxOscArgDouble*)args[index])->get();
+			return (std::uint64_t)args[index].doubleValue;
 		}
 		else{
 			ofLogError("ofxOscMessage") << "getArgAsTimetag(): argument "
@@ -482,7 +454,7 @@ std::uint64_t ofxOscMessage::getArgAsTimetag(std::size_t index) const{
 		}
 	}
 	else{
-		return ((ofxOscArgTimetag*)args[index])->get();
+		return args[index].timetagValue;
 	}
 }
 
@@ -494,7 +466,7 @@ ofBuffer ofxOscMessage::getArgAsBlob(std::size_t index) const{
 		return ofBuffer();
 	}
 	else{
-		return ((ofxOscArgBlob*)args[index])->get();
+		return ofBuffer(argsData.data() + args[index].data.offset, args[index].data.size);
 	}
 }
 
@@ -506,94 +478,157 @@ std::uint32_t ofxOscMessage::getArgAsRgbaColor(std::size_t index) const{
 		return 0;
 	}
 	else{
-		return ((ofxOscArgRgbaColor*)args[index])->get();
+		return args[index].uint32Value;
 	}
 }
 
 // set methods
 //--------------------------------------------------------------
 void ofxOscMessage::addIntArg(std::int32_t argument){
-	args.push_back(new ofxOscArgInt32(argument));
+	addInt32Arg(argument);
 }
 
 //--------------------------------------------------------------
 void ofxOscMessage::addInt32Arg(std::int32_t argument){
-	args.push_back(new ofxOscArgInt32(argument));
+	Arg arg;
+	arg.type = OFXOSC_TYPE_INT32;
+	arg.int32Value = argument;
+	args.push_back(arg);
 }
 
 //--------------------------------------------------------------
 void ofxOscMessage::addInt64Arg(std::int64_t argument){
-	args.push_back(new ofxOscArgInt64(argument));
+	Arg arg;
+	arg.type = OFXOSC_TYPE_INT64;
+	arg.int64Value = argument;
+	args.push_back(arg);
 }
 
 //--------------------------------------------------------------
 void ofxOscMessage::addFloatArg(float argument){
-	args.push_back(new ofxOscArgFloat(argument));
+	Arg arg;
+	arg.type = OFXOSC_TYPE_FLOAT;
+	arg.floatValue = argument;
+	args.push_back(arg);
 }
 
 //--------------------------------------------------------------
 void ofxOscMessage::addDoubleArg(double argument){
-	args.push_back(new ofxOscArgDouble(argument));
+	Arg arg;
+	arg.type = OFXOSC_TYPE_DOUBLE;
+	arg.doubleValue = argument;
+	args.push_back(arg);
 }
 
 //--------------------------------------------------------------
 void ofxOscMessage::addStringArg(const std::string &argument){
-	args.push_back(new ofxOscArgString(argument));
+	addArg(OFXOSC_TYPE_STRING, argument.data(), argument.size());
+}
+
+//--------------------------------------------------------------
+void ofxOscMessage::addStringArg(const char *argument){
+	addArg(OFXOSC_TYPE_STRING, argument, strlen(argument));
 }
 
 //--------------------------------------------------------------
 void ofxOscMessage::addSymbolArg(const std::string &argument){
-	args.push_back(new ofxOscArgSymbol(argument));
+	addArg(OFXOSC_TYPE_SYMBOL, argument.data(), argument.size());
+}
+
+//--------------------------------------------------------------
+void ofxOscMessage::addSymbolArg(const char *argument){
+	addArg(OFXOSC_TYPE_SYMBOL, argument, strlen(argument));
 }
 
 //--------------------------------------------------------------
 void ofxOscMessage::addCharArg( char argument){
-	args.push_back(new ofxOscArgChar(argument));
+	Arg arg;
+	arg.type = OFXOSC_TYPE_CHAR;
+	arg.charValue = argument;
+	args.push_back(arg);
 }
 
 //--------------------------------------------------------------
 void ofxOscMessage::addMidiMessageArg(std::uint32_t argument){
-	args.push_back(new ofxOscArgMidiMessage(argument));
+	Arg arg;
+	arg.type = OFXOSC_TYPE_MIDI_MESSAGE;
+	arg.uint32Value = argument;
+	args.push_back(arg);
 }
 
 //--------------------------------------------------------------
 void ofxOscMessage::addBoolArg(bool argument){
-	args.push_back(new ofxOscArgBool(argument));
+	Arg arg;
+	arg.type = argument ? OFXOSC_TYPE_TRUE : OFXOSC_TYPE_FALSE;
+	arg.int64Value = 0;
+	args.push_back(arg);
 }
 
 //--------------------------------------------------------------
 void ofxOscMessage::addNoneArg(){
-	args.push_back(new ofxOscArgNone());
+	Arg arg;
+	arg.type = OFXOSC_TYPE_NONE;
+	arg.int64Value = 0;
+	args.push_back(arg);
 }
 
 //--------------------------------------------------------------
 void ofxOscMessage::addTriggerArg(){
-	args.push_back(new ofxOscArgTrigger());
+	Arg arg;
+	arg.type = OFXOSC_TYPE_TRIGGER;
+	arg.int64Value = 0;
+	args.push_back(arg);
 }
 
 //--------------------------------------------------------------
 void ofxOscMessage::addImpulseArg(){
-	args.push_back(new ofxOscArgTrigger());
+	addTriggerArg();
 }
 
 //--------------------------------------------------------------
 void ofxOscMessage::addInfinitumArg(){
-	args.push_back(new ofxOscArgTrigger());
+	addTriggerArg();
 }
 
 //--------------------------------------------------------------
 void ofxOscMessage::addTimetagArg(std::uint64_t argument){
-	args.push_back(new ofxOscArgTimetag(argument));
+	Arg arg;
+	arg.type = OFXOSC_TYPE_TIMETAG;
+	arg.timetagValue = argument;
+	args.push_back(arg);
 }
 
 //--------------------------------------------------------------
 void ofxOscMessage::addBlobArg(const ofBuffer &argument){
-	args.push_back(new ofxOscArgBlob(argument));
+	addArg(OFXOSC_TYPE_BLOB, argument.getData(), argument.size());
+}
+
+//--------------------------------------------------------------
+void ofxOscMessage::addBlobArg(const char *data, std::size_t size){
+	addArg(OFXOSC_TYPE_BLOB, data, size);
 }
 
 //--------------------------------------------------------------
 void ofxOscMessage::addRgbaColorArg(std::uint32_t argument){
-	args.push_back(new ofxOscArgRgbaColor(argument));
+	Arg arg;
+	arg.type = OFXOSC_TYPE_RGBA_COLOR;
+	arg.uint32Value = argument;
+	args.push_back(arg);
+}
+
+//--------------------------------------------------------------
+void ofxOscMessage::addArg(ofxOscArgType type, const char *data, std::size_t size){
+	Arg arg;
+	arg.type = type;
+	arg.data.offset = (std::uint32_t)argsData.size();
+	arg.data.size = (std::uint32_t)size;
+	argsData.insert(argsData.end(), data, data + size);
+	args.push_back(arg);
+}
+
+//--------------------------------------------------------------
+std::string ofxOscMessage::getArgData(std::size_t index) const{
+	return std::string(argsData.data() + args[index].data.offset, args[index].data.size);
 }
 
 // util
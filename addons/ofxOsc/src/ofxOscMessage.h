@@ -6,6 +6,10 @@
 
 /// \class ofxOscMessage
 /// \brief an OSC message with address and arguments
+///
+/// arguments are stored in a flat array, strings and blobs one after
+/// another in a single buffer, so a message that is cleared and reused
+/// doesn't allocate memory when new arguments are added
 class ofxOscMessage{
 public:
 
@@ -13,10 +17,12 @@ public:
 	~ofxOscMessage();
 	ofxOscMessage(const ofxOscMessage &other);
 	ofxOscMessage& operator=(const ofxOscMessage &other);
+	ofxOscMessage(ofxOscMessage &&other) noexcept;
+	ofxOscMessage& operator=(ofxOscMessage &&other) noexcept;
 	/// for operator= and copy constructor
 	ofxOscMessage& copy(const ofxOscMessage &other);
 
-	/// clear this message
+	/// clear this message, keeps the allocated memory to be reused
 	void clear();
 
 	/// set the message address, must start with a /
@@ -187,9 +193,11 @@ public:
 	
 	/// add a string
 	void addStringArg(const std::string &argument);
+	void addStringArg(const char *argument);
 	
 	/// add a symbol (string)
 	void addSymbolArg(const std::string &argument);
+	void addSymbolArg(const char *argument);
 	
 	/// add a char
 	void addCharArg(char argument);
@@ -220,6 +228,9 @@ public:
 	
 	/// add a binary blog
 	void addBlobArg(const ofBuffer &argument);
+
+	/// add a binary blob copying it from data
+	void addBlobArg(const char *data, std::size_t size);
 	
 	/// add a 32-bit color
 	void addRgbaColorArg(std::uint32_t argument);
@@ -243,8 +254,31 @@ public:
 
 private:
 
+	/// an argument, values are stored inline and strings and blobs
+	/// as a range of argsData
+	struct Arg{
+		ofxOscArgType type;
+		union{
+			std::int32_t int32Value;
+			std::int64_t int64Value;
+			float floatValue;
+			double doubleValue;
+			char charValue;
+			std::uint32_t uint32Value; ///< midi message & rgba color
+			std::uint64_t timetagValue;
+			struct{
+				std::uint32_t offset;
+				std::uint32_t size;
+			} data; ///< string, symbol & blob
+		};
+	};
+
+	void addArg(ofxOscArgType type, const char *data, std::size_t size);
+	std::string getArgData(std::size_t index) const;
+
 	std::string address; ///< OSC address, must start with a /
-	std::vector<ofxOscArg*> args; ///< current arguments
+	std::vector<Arg> args; ///< current arguments
+	std::vector<char> argsData; ///< string & blob arguments data
 
 	std::string remoteHost; ///< host name/ip the message was sent from
 	int remotePort; ///< port the message was sent from
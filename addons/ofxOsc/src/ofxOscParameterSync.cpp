@@ -1,9 +1,21 @@
 // copyright (c) openFrameworks team 2012-2017
 #include "ofxOscParameterSync.h"
+#include "ofUtils.h"
+
+// sent to ask the remote for all its values, with the group name as argument
+static const std::string snapshotAddress = "/ofxOscParameterSync/snapshot";
 
 //--------------------------------------------------------------
 ofxOscParameterSync::ofxOscParameterSync(){
 	updatingParameter = false;
+	lastSendTime = 0;
+	statsTime = 0;
+	sentMessages = 0;
+	sentBytes = 0;
+	receivedMessages = 0;
+	sentMessagesPerSecond = 0;
+	sentBytesPerSecond = 0;
+	receivedMessagesPerSecond = 0;
 }
 
 //--------------------------------------------------------------
@@ -13,23 +25,169 @@ ofxOscParameterSync::~ofxOscParameterSync(){
 
 //--------------------------------------------------------------
 void ofxOscParameterSync::setup(ofParameterGroup &group, int localPort, const std::string &host, int remotePort){
+	ofxOscParameterSyncSettings settings;
+	settings.localPort = localPort;
+	settings.remoteHost = host;
+	settings.remotePort = remotePort;
+	setup(group, settings);
+}
+
+//--------------------------------------------------------------
+void ofxOscParameterSync::setup(ofParameterGroup &group, const ofxOscParameterSyncSettings &settings){
+	ofRemoveListener(syncGroup.parameterChangedE(), this, &ofxOscParameterSync::parameterChanged);
+	this->settings = settings;
 	syncGroup = group;
 	ofAddListener(syncGroup.parameterChangedE(), this, &ofxOscParameterSync::parameterChanged);
-	sender.setup(host, remotePort);
-	receiver.setup(localPort);
+
+	parameters.clear();
+	dirtyParameters.clear();
+	parameterIndices.clear();
+	addParameters(syncGroup);
+
+	ofxOscSenderSettings senderSettings;
+	senderSettings.host = settings.remoteHost;
+	senderSettings.port = settings.remotePort;
+	senderSettings.mode = OFXOSC_SEND_BUNDLE;
+	senderSettings.flushEveryFrame = false;
+	senderSettings.maxPacketSize = settings.maxPacketSize;
+	sender.setup(senderSettings);
+
+	receiver.setup(settings.localPort);
+	receiver.clearHandlers();
+	receiver.addParameter(syncGroup);
+	receiver.addHandler(snapshotAddress, [this](const ofxOscMessage &msg){
+		if(msg.getNumArgs() > 0 && msg.getArgType(0) == OFXOSC_TYPE_STRING &&
+		   msg.getArgAsString(0) == syncGroup.getEscapedName()){
+			sendSnapshot();
+		}
+	});
+
+	statsTime = lastSendTime = ofGetElapsedTimef();
+	sentBytes = sender.getBytesSent();
+	if(settings.requestSnapshot){
+		requestSnapshot();
+	}
 }
 
 //--------------------------------------------------------------
 void ofxOscParameterSync::update(){
-	if(receiver.hasWaitingMessages()){
-		updatingParameter = true;
-		receiver.getParameter(syncGroup);
-		updatingParameter = false;
+	// parameters are set by the receiver, other messages are discarded
+	updatingParameter = true;
+	receivedMessages += receiver.dispatchMessages();
+	ofxOscMessage msg;
+	while(receiver.getNextMessage(msg)){
+		receivedMessages++;
 	}
+	updatingParameter = false;
+
+	// send the last value of the parameters changed since the last send
+	auto now = ofGetElapsedTimef();
+	if(!dirtyParameters.empty() && (settings.maxRate <= 0 || now - lastSendTime >= 1 / settings.maxRate)){
+		for(auto i: dirtyParameters){
+			sender.sendParameter(*parameters[i].parameter);
+			parameters[i].dirty = false;
+		}
+		sender.flush();
+		sentMessages += dirtyParameters.size();
+		dirtyParameters.clear();
+		lastSendTime = now;
+	}
+
+	if(now - statsTime >= 1){
+		auto elapsed = now - statsTime;
+		auto bytes = sender.getBytesSent();
+		sentMessagesPerSecond = sentMessages / elapsed;
+		sentBytesPerSecond = (bytes - sentBytes) / elapsed;
+		receivedMessagesPerSecond = receivedMessages / elapsed;
+		sentMessages = 0;
+		sentBytes = bytes;
+		receivedMessages = 0;
+		statsTime = now;
+	}
+}
+
+//--------------------------------------------------------------
+void ofxOscParameterSync::requestSnapshot(){
+	ofxOscMessage msg;
+	msg.setAddress(snapshotAddress);
+	msg.addStringArg(syncGroup.getEscapedName());
+	sender.sendMessage(msg);
+	sender.flush();
+}
+
+//--------------------------------------------------------------
+void ofxOscParameterSync::sendSnapshot(){
+	for(std::size_t i = 0; i < parameters.size(); i++){
+		if(!parameters[i].dirty){
+			parameters[i].dirty = true;
+			dirtyParameters.push_back(i);
+		}
+	}
+}
+
+//--------------------------------------------------------------
+float ofxOscParameterSync::getSentMessagesPerSecond() const{
+	return sentMessagesPerSecond;
+}
+
+//--------------------------------------------------------------
+float ofxOscParameterSync::getSentBytesPerSecond() const{
+	return sentBytesPerSecond;
+}
+
+//--------------------------------------------------------------
+float ofxOscParameterSync::getReceivedMessagesPerSecond() const{
+	return receivedMessagesPerSecond;
+}
+
+//--------------------------------------------------------------
+const ofxOscParameterSyncSettings &ofxOscParameterSync::getSettings() const{
+	return settings;
 }
 
 //--------------------------------------------------------------
 void ofxOscParameterSync::parameterChanged(ofAbstractParameter &parameter){
 	if(updatingParameter) return;
-	sender.sendParameter(parameter);
+	int index = findParameter(parameter);
+	if(index < 0){
+		// added to the group after setup
+		sender.sendParameter(parameter);
+		sender.flush();
+		sentMessages++;
+		return;
+	}
+	if(!parameters[index].dirty){
+		parameters[index].dirty = true;
+		dirtyParameters.push_back(index);
+	}
+}
+
+//--------------------------------------------------------------
+void ofxOscParameterSync::addParameters(ofAbstractParameter &parameter){
+	if(!parameter.isSerializable()) return;
+	if(parameter.type() == typeid(ofParameterGroup).name()){
+		ofParameterGroup &group = static_cast<ofParameterGroup &>(parameter);
+		for(std::size_t i = 0; i < group.size(); i++){
+			addParameters(group[i]);
+		}
+	}else{
+		parameters.push_back({parameter.newReference(), false});
+	}
+}
+
+//--------------------------------------------------------------
+int ofxOscParameterSync::findParameter(const ofAbstractParameter &parameter){
+	// parameters are usually changed through the same object so its
+	// address is remembered, checking it still refers to the same value
+	auto it = parameterIndices.find(&parameter);
+	if(it != parameterIndices.end() && parameters[it->second].parameter->isReferenceTo(parameter)){
+		return it->second;
+	}
+	for(std::size_t i = 0; i < parameters.size(); i++){
+		if(parameters[i].parameter->isReferenceTo(parameter)){
+			parameterIndices[&parameter] = i;
+			return i;
+		}
+	}
+	return -1;
 }
@@ -6,8 +6,24 @@
 #include "ofParameter.h"
 #include "ofParameterGroup.h"
 
+#include <unordered_map>
+
+/// \struct ofxOscParameterSyncSettings
+/// \brief ofxOscParameterSync connection and rate settings
+struct ofxOscParameterSyncSettings {
+	int localPort = 0;                    ///< port to listen on
+	std::string remoteHost = "localhost"; ///< destination host name/ip
+	int remotePort = 0;                   ///< destination port
+	float maxRate = 30;                   ///< max bundles of changes sent per second, 0 sends them every update
+	std::size_t maxPacketSize = 1472;     ///< bundles bigger than this are split
+	bool requestSnapshot = true;          ///< ask the remote for all its values on setup
+};
+
 /// \class ofxOscParamaterSync
 /// \brief a high-level sync object for ofParamaters over OSC
+///
+/// changed parameters are collected and only their last value is sent,
+/// in a bundle, at most maxRate times per second
 class ofxOscParameterSync{
 public:
 
@@ -17,17 +33,65 @@ public:
 	/// set the parameter group & connection info
 	/// the remote and local ports must be different to avoid collisions
 	void setup(ofParameterGroup &group, int localPort, const std::string &remoteHost, int remotePort);
-	
-	/// process any incoming messages
+
+	/// set the parameter group & the given settings
+	void setup(ofParameterGroup &group, const ofxOscParameterSyncSettings &settings);
+
+	/// process any incoming messages and send the changed parameters
 	void update();
 
+	/// ask the remote to send the values of all its parameters, useful to
+	/// get the current state when joining after the remote started
+	void requestSnapshot();
+
+	/// send the values of all the parameters on the next update
+	void sendSnapshot();
+
+	/// \return parameter messages sent per second during the last second
+	float getSentMessagesPerSecond() const;
+
+	/// \return bytes sent per second during the last second
+	float getSentBytesPerSecond() const;
+
+	/// \return messages received per second during the last second
+	float getReceivedMessagesPerSecond() const;
+
+	/// \return the current settings
+	const ofxOscParameterSyncSettings &getSettings() const;
+
 private:
 
+	/// a parameter of the group, or of a group inside it, sent on its own
+	struct SyncParameter{
+		std::shared_ptr<ofAbstractParameter> parameter;
+		bool dirty;
+	};
+
 	/// parameter change callaback
 	void parameterChanged(ofAbstractParameter &parameter);
-	
+
+	/// add the parameters of a group recursively
+	void addParameters(ofAbstractParameter &parameter);
+
+	/// \return index of the parameter in parameters or -1 if it's not synced
+	int findParameter(const ofAbstractParameter &parameter);
+
 	ofxOscSender sender; ///< sync sender
 	ofxOscReceiver receiver; ///< sync receiver
 	ofParameterGroup syncGroup; ///< target parameter group
+	ofxOscParameterSyncSettings settings; ///< current settings
 	bool updatingParameter; ///< is a parameter being updated?
+
+	std::vector<SyncParameter> parameters; ///< synced parameters
+	std::vector<std::size_t> dirtyParameters; ///< indices of the parameters changed since the last send
+	std::unordered_map<const ofAbstractParameter*, std::size_t> parameterIndices; ///< last known index of each notified parameter object
+	float lastSendTime; ///< when the last changes were sent
+
+	float statsTime; ///< start of the current stats second
+	std::size_t sentMessages; ///< parameter messages sent this second
+	std::uint64_t sentBytes; ///< sender bytes at the start of this second
+	std::size_t receivedMessages; ///< messages received this second
+	float sentMessagesPerSecond;
+	float sentBytesPerSecond;
+	float receivedMessagesPerSecond;
 };
@@ -1,16 +1,216 @@
 // copyright (c) openFrameworks team 2010-2017
 // copyright (c) Damian Stewart 2007-2009
 #include "ofxOscReceiver.h"
+#include <cstring>
+#include <algorithm>
 
 using namespace std;
 
+// messages kept to be reused, more than this are freed
+static const size_t messagesPoolSize = 256;
+
+// receiver whose handlers the listener thread is calling, removing
+// handlers from one of them can't wait for it to finish
+static thread_local const ofxOscReceiver * dispatchingReceiver = nullptr;
+
+//--------------------------------------------------------------
+// FNV-1a, also returns the length of the address and if it has wildcards
+static uint64_t hashAddress(const char * address, size_t & length, bool & pattern){
+	uint64_t hash = 14695981039346656037ull;
+	pattern = false;
+	const char * c = address;
+	for(; *c; c++){
+		hash = (hash ^ (unsigned char)*c) * 1099511628211ull;
+		pattern |= *c == '?' || *c == '*' || *c == '[' || *c == '{';
+	}
+	length = c - address;
+	return hash;
+}
+
+//--------------------------------------------------------------
+// osc 1.0 address pattern matching, wildcards don't match across '/'
+static bool matchPattern(const char * pattern, const char * address){
+	while(*pattern){
+		switch(*pattern){
+		case '?':
+			if(*address == 0 || *address == '/') return false;
+			pattern++;
+			address++;
+			break;
+		case '*':{
+			while(*pattern == '*') pattern++;
+			const char * end = address;
+			while(*end && *end != '/') end++;
+			for(const char * a = end; a >= address; a--){
+				if(matchPattern(pattern, a)) return true;
+			}
+			return false;
+		}
+		case '[':{
+			if(*address == 0 || *address == '/') return false;
+			pattern++;
+			bool negate = *pattern == '!';
+			if(negate) pattern++;
+			bool matched = false;
+			while(*pattern && *pattern != ']'){
+				if(pattern[1] == '-' && pattern[2] && pattern[2] != ']'){
+					matched |= *address >= pattern[0] && *address <= pattern[2];
+					pattern += 3;
+				}else{
+					matched |= *address == *pattern;
+					pattern++;
+				}
+			}
+			if(*pattern != ']' || matched == negate) return false;
+			pattern++;
+			address++;
+			break;
+		}
+		case '{':{
+			const char * close = strchr(pattern, '}');
+			if(!close) return false;
+			const char * option = pattern + 1;
+			while(option <= close){
+				const char * optionEnd = option;
+				while(optionEnd < close && *optionEnd != ',') optionEnd++;
+				size_t length = optionEnd - option;
+				if(strncmp(option, address, length) == 0 && matchPattern(close + 1, address + length)){
+					return true;
+				}
+				option = optionEnd + 1;
+			}
+			return false;
+		}
+		default:
+			if(*pattern != *address) return false;
+			pattern++;
+			address++;
+		}
+	}
+	return *address == 0;
+}
+
+//--------------------------------------------------------------
+static void setParameter(ofAbstractParameter &p, const ofxOscMessage &msg){
+	if(msg.getNumArgs() == 0){
+		return;
+	}
+	if(p.type() == typeid(ofParameter<int>).name() &&
+		msg.getArgType(0) == OFXOSC_TYPE_INT32){
+		p.cast<int>() = msg.getArgAsInt32(0);
+	}
+	else if(p.type() == typeid(ofParameter<float>).name() &&
+		msg.getArgType(0) == OFXOSC_TYPE_FLOAT){
+		p.cast<float>() = msg.getArgAsFloat(0);
+	}
+	else if(p.type() == typeid(ofParameter<double>).name() &&
+		msg.getArgType(0) == OFXOSC_TYPE_DOUBLE){
+		p.cast<double>() = msg.getArgAsDouble(0);
+	}
+	else if(p.type() == typeid(ofParameter<bool>).name() &&
+		(msg.getArgType(0) == OFXOSC_TYPE_TRUE ||
+		 msg.getArgType(0) == OFXOSC_TYPE_FALSE ||
+		 msg.getArgType(0) == OFXOSC_TYPE_INT32 ||
+		 msg.getArgType(0) == OFXOSC_TYPE_INT64 ||
+		 msg.getArgType(0) == OFXOSC_TYPE_FLOAT ||
+		 msg.getArgType(0) == OFXOSC_TYPE_DOUBLE ||
+		 msg.getArgType(0) == OFXOSC_TYPE_STRING ||
+		 msg.getArgType(0) == OFXOSC_TYPE_SYMBOL)){
+		p.cast<bool>() = msg.getArgAsBool(0);
+	}
+	else if(msg.getArgType(0) == OFXOSC_TYPE_STRING){
+		p.fromString(msg.getArgAsString(0));
+	}
+}
+
+//--------------------------------------------------------------
+ofxOscReceiver::Router::Router(std::vector<Route> &&routes)
+:routes(std::move(routes)){
+	size_t numExact = 0;
+	for(size_t i = 0; i < this->routes.size(); i++){
+		if(this->routes[i].pattern){
+			patterns.push_back(i);
+		}else{
+			numExact++;
+		}
+	}
+	if(numExact == 0){
+		return;
+	}
+	// keep the table at most half full so probing stays short
+	size_t size = 1;
+	while(size < numExact * 2){
+		size *= 2;
+	}
+	table.assign(size, 0);
+	for(size_t i = 0; i < this->routes.size(); i++){
+		if(!this->routes[i].pattern){
+			size_t pos = this->routes[i].hash & (size - 1);
+			while(table[pos]){
+				pos = (pos + 1) & (size - 1);
+			}
+			table[pos] = i + 1;
+		}
+	}
+}
+
+//--------------------------------------------------------------
+template<typename Function>
+void ofxOscReceiver::Router::match(const char * address, Function f) const{
+	size_t length;
+	bool pattern;
+	uint64_t hash = hashAddress(address, length, pattern);
+	if(pattern){
+		// the message address is the pattern, only the
+		// addresses without wildcards can match it
+		for(size_t i = 0; i < routes.size(); i++){
+			if(!routes[i].pattern && matchPattern(address, routes[i].address.c_str())){
+				f(i);
+			}
+		}
+		return;
+	}
+	if(!table.empty()){
+		size_t mask = table.size() - 1;
+		for(size_t pos = hash & mask; table[pos]; pos = (pos + 1) & mask){
+			const Route & route = routes[table[pos] - 1];
+			if(route.hash == hash && route.address.size() == length &&
+			   memcmp(route.address.data(), address, length) == 0){
+				f(table[pos] - 1);
+			}
+		}
+	}
+	for(auto i: patterns){
+		if(matchPattern(routes[i].address.c_str(), address)){
+			f(i);
+		}
+	}
+}
+
+//--------------------------------------------------------------
+bool ofxOscReceiver::Router::contains(std::size_t id) const{
+	for(auto & route: routes){
+		if(route.id == id){
+			return true;
+		}
+	}
+	return false;
+}
+
+//--------------------------------------------------------------
+ofxOscReceiver::ofxOscReceiver()
+:messagesPool(messagesPoolSize, OF_THREAD_CHANNEL_REJECT)
+,routedPool(messagesPoolSize, OF_THREAD_CHANNEL_REJECT){}
+
 //--------------------------------------------------------------
 ofxOscReceiver::~ofxOscReceiver(){
 	stop();
 }
 
 //--------------------------------------------------------------
-ofxOscReceiver::ofxOscReceiver(const ofxOscReceiver &mom){
+ofxOscReceiver::ofxOscReceiver(const ofxOscReceiver &mom)
+:messagesPool(messagesPoolSize, OF_THREAD_CHANNEL_REJECT)
+,routedPool(messagesPoolSize, OF_THREAD_CHANNEL_REJECT){
 	copy(mom);
 }
 
@@ -23,6 +223,14 @@ ofxOscReceiver& ofxOscReceiver::operator=(const ofxOscReceiver &mom){
 ofxOscReceiver& ofxOscReceiver::copy(const ofxOscReceiver &other){
 	if(this == &other) return *this;
 	settings = other.settings;
+	{
+		std::unique_lock<std::mutex> lock(other.routerMutex);
+		auto otherRouter = other.router;
+		lock.unlock();
+		std::unique_lock<std::mutex> thisLock(routerMutex);
+		router = otherRouter;
+		nextRouteId = other.nextRouteId;
+	}
 	if(other.listenSocket){
 		setup(settings);
 	}
@@ -120,7 +328,7 @@ bool ofxOscReceiver::isListening() const{
 
 //--------------------------------------------------------------
 bool ofxOscReceiver::hasWaitingMessages() const{
-	return !messagesChannel.empty();
+	return !messagesChannel.empty() || !routedChannel.empty();
 }
 
 //--------------------------------------------------------------
@@ -129,63 +337,136 @@ bool ofxOscReceiver::getNextMessage(ofxOscMessage *message){
 }
 
 //--------------------------------------------------------------
-bool ofxOscReceiver::getNextMessage(ofxOscMessage &message){
-	return messagesChannel.tryReceive(message);
+std::size_t ofxOscReceiver::addHandler(const std::string &address, std::function<void(const ofxOscMessage&)> handler, ofxOscDispatch dispatch){
+	Route route;
+	size_t length;
+	route.address = address;
+	route.hash = hashAddress(address.c_str(), length, route.pattern);
+	route.dispatch = dispatch;
+	route.id = nextRouteId++;
+	route.handler = handler;
+	auto id = route.id;
+
+	std::vector<Route> routes;
+	{
+		std::unique_lock<std::mutex> lock(routerMutex);
+		if(router){
+			routes = router->routes;
+		}
+	}
+	routes.push_back(std::move(route));
+	setRoutes(std::move(routes));
+	return id;
 }
 
 //--------------------------------------------------------------
-bool ofxOscReceiver::getParameter(ofAbstractParameter &parameter){
-	ofxOscMessage msg;
-	while(messagesChannel.tryReceive(msg)){
-		ofAbstractParameter * p = &parameter;
-		std::vector<std::string> address = ofSplitString(msg.getAddress(),"/", true);
-		for(unsigned int i = 0; i < address.size(); i++){
-			if(p){
-				if(address[i] == p->getEscapedName()){
-					if(p->type() == typeid(ofParameterGroup).name()){
-						if(address.size() >= i+1){
-							ofParameterGroup* g = static_cast<ofParameterGroup*>(p);
-							if(g->contains(address[i+1])){
-								p = &g->get(address[i+1]);
-							}
-							else{
-								p = nullptr;
-							}
-						}
-					}
-					else if(p->type() == typeid(ofParameter<int>).name() &&
-						msg.getArgType(0) == OFXOSC_TYPE_INT32){
-						p->cast<int>() = msg.getArgAsInt32(0);
-					}
-					else if(p->type() == typeid(ofParameter<float>).name() &&
-						msg.getArgType(0) == OFXOSC_TYPE_FLOAT){
-						p->cast<float>() = msg.getArgAsFloat(0);
-					}
-					else if(p->type() == typeid(ofParameter<double>).name() &&
-						msg.getArgType(0) == OFXOSC_TYPE_DOUBLE){
-						p->cast<double>() = msg.getArgAsDouble(0);
-					}
-					else if(p->type() == typeid(ofParameter<bool>).name() &&
-						(msg.getArgType(0) == OFXOSC_TYPE_TRUE ||
-						 msg.getArgType(0) == OFXOSC_TYPE_FALSE ||
-						 msg.getArgType(0) == OFXOSC_TYPE_INT32 ||
-						 msg.getArgType(0) == OFXOSC_TYPE_INT64 ||
-						 msg.getArgType(0) == OFXOSC_TYPE_FLOAT ||
-						 msg.getArgType(0) == OFXOSC_TYPE_DOUBLE ||
-						 msg.getArgType(0) == OFXOSC_TYPE_STRING ||
-						 msg.getArgType(0) == OFXOSC_TYPE_SYMBOL)){
-						p->cast<bool>() = msg.getArgAsBool(0);
-					}
-					else if(msg.getArgType(0) == OFXOSC_TYPE_STRING){
-						p->fromString(msg.getArgAsString(0));
-					}
-				}
+std::size_t ofxOscReceiver::addParameter(ofAbstractParameter &parameter){
+	// same address ofxOscSender::sendParameter sends to
+	std::string address;
+	for(auto & name: parameter.getGroupHierarchyNames()){
+		address += "/" + name;
+	}
+
+	std::vector<Route> routes;
+	{
+		std::unique_lock<std::mutex> lock(routerMutex);
+		if(router){
+			routes = router->routes;
+		}
+	}
+	auto id = nextRouteId++;
+	addParameterRoutes(routes, parameter, address, id, true);
+	setRoutes(std::move(routes));
+	return id;
+}
+
+//--------------------------------------------------------------
+void ofxOscReceiver::removeHandler(std::size_t id){
+	std::vector<Route> routes;
+	{
+		std::unique_lock<std::mutex> lock(routerMutex);
+		if(!router){
+			return;
+		}
+		routes = router->routes;
+	}
+	routes.erase(std::remove_if(routes.begin(), routes.end(), [&](const Route & route){
+		return route.id == id;
+	}), routes.end());
+	setRoutes(std::move(routes));
+	waitForListenerHandlers();
+}
+
+//--------------------------------------------------------------
+void ofxOscReceiver::clearHandlers(){
+	setRoutes({});
+	waitForListenerHandlers();
+}
+
+//--------------------------------------------------------------
+std::size_t ofxOscReceiver::dispatchMessages(){
+	std::shared_ptr<const Router> currentRouter;
+	{
+		std::unique_lock<std::mutex> lock(routerMutex);
+		currentRouter = router;
+	}
+	std::size_t dispatched = 0;
+	RoutedMessage routed;
+	while(routedChannel.tryReceive(routed)){
+		for(auto i: routed.routes){
+			const Route & route = routed.router->routes[i];
+			// the handler could have been removed since the message arrived
+			if(routed.router == currentRouter || (currentRouter && currentRouter->contains(route.id))){
+				route.handler(routed.message);
 			}
 		}
+		dispatched++;
+		routed.message.clear();
+		routed.routes.clear();
+		routed.router.reset();
+		routedPool.send(std::move(routed));
 	}
+	return dispatched;
+}
+
+//--------------------------------------------------------------
+bool ofxOscReceiver::getNextMessage(ofxOscMessage &message){
+	dispatchMessages();
+
+	ofxOscMessage received;
+	if(!messagesChannel.tryReceive(received)){
+		return false;
+	}
+	// give the memory of the previous message back to the listener thread
+	std::swap(message, received);
+	received.clear();
+	messagesPool.send(std::move(received));
 	return true;
 }
 
+//--------------------------------------------------------------
+bool ofxOscReceiver::getParameter(ofAbstractParameter &parameter){
+	// resolve the addresses with a table of the parameter
+	// addresses instead of walking the group for each message
+	std::string address;
+	for(auto & name: parameter.getGroupHierarchyNames()){
+		address += "/" + name;
+	}
+	std::vector<Route> routes;
+	addParameterRoutes(routes, parameter, address, 0, false);
+	Router parameters(std::move(routes));
+
+	bool handled = false;
+	ofxOscMessage msg;
+	while(getNextMessage(msg)){
+		parameters.match(msg.getAddress().c_str(), [&](std::size_t i){
+			parameters.routes[i].handler(msg);
+			handled = true;
+		});
+	}
+	return handled;
+}
+
 //--------------------------------------------------------------
 int ofxOscReceiver::getPort() const{
 	return settings.port;
@@ -196,11 +477,68 @@ const ofxOscReceiverSettings &ofxOscReceiver::getSettings() const {
 	return settings;
 }
 
+// PRIVATE
+//--------------------------------------------------------------
+void ofxOscReceiver::waitForListenerHandlers(){
+	// the listener thread holds dispatchMutex from loading the router
+	// until its handlers return, once it's released any message uses the
+	// new router
+	if(dispatchingReceiver != this){
+		std::unique_lock<std::mutex> lock(dispatchMutex);
+	}
+}
+
+//--------------------------------------------------------------
+void ofxOscReceiver::setRoutes(std::vector<Route> &&routes){
+	std::shared_ptr<const Router> newRouter;
+	if(!routes.empty()){
+		newRouter = std::make_shared<Router>(std::move(routes));
+	}
+	std::unique_lock<std::mutex> lock(routerMutex);
+	router = newRouter;
+}
+
+//--------------------------------------------------------------
+void ofxOscReceiver::addParameterRoutes(std::vector<Route> &routes, ofAbstractParameter &parameter, const std::string &address, std::size_t id, bool reference){
+	if(!parameter.isSerializable()) return;
+	if(parameter.type() == typeid(ofParameterGroup).name()){
+		ofParameterGroup &group = static_cast<ofParameterGroup &>(parameter);
+		for(std::size_t i = 0; i < group.size(); i++){
+			addParameterRoutes(routes, group[i], address + "/" + group[i].getEscapedName(), id, reference);
+		}
+		return;
+	}
+
+	Route route;
+	size_t length;
+	route.address = address;
+	route.hash = hashAddress(address.c_str(), length, route.pattern);
+	// parameter names are never wildcards
+	route.pattern = false;
+	route.dispatch = OFXOSC_DISPATCH_MAIN_THREAD;
+	route.id = id;
+	if(reference){
+		// keep the parameter alive as long as the route
+		auto p = parameter.newReference();
+		route.handler = [p](const ofxOscMessage &msg){
+			setParameter(*p, msg);
+		};
+	}else{
+		auto p = &parameter;
+		route.handler = [p](const ofxOscMessage &msg){
+			setParameter(*p, msg);
+		};
+	}
+	routes.push_back(std::move(route));
+}
+
 // PROTECTED
 //--------------------------------------------------------------
 void ofxOscReceiver::ProcessMessage(const osc::ReceivedMessage &m, const osc::IpEndpointName &remoteEndpoint){
-	// convert the message to an ofxOscMessage
+	// convert the message to an ofxOscMessage, reusing one
+	// already received if possible
 	ofxOscMessage msg;
+	messagesPool.tryReceive(msg);
 
 	// set the address
 	msg.setAddress(m.AddressPattern());
@@ -255,8 +593,7 @@ void ofxOscReceiver::ProcessMessage(const osc::ReceivedMessage &m, const osc::Ip
 			const char * dataPtr;
 			osc::osc_bundle_element_size_t len = 0;
 			arg->AsBlobUnchecked((const void*&)dataPtr, len);
-			ofBuffer buffer(dataPtr, len);
-			msg.addBlobArg(buffer);
+			msg.addBlobArg(dataPtr, len);
 		}
 		else {
 			ofLogError("ofxOscReceiver") << "ProcessMessage(): argument in message "
@@ -266,8 +603,48 @@ void ofxOscReceiver::ProcessMessage(const osc::ReceivedMessage &m, const osc::Ip
 		}
 	}
 
-	// send msg to main thread
-	messagesChannel.send(std::move(msg));
+	// call the handlers for the address, the ones for the main thread
+	// get the message through routedChannel
+	std::unique_lock<std::mutex> dispatchLock(dispatchMutex);
+	std::shared_ptr<const Router> currentRouter;
+	{
+		std::unique_lock<std::mutex> lock(routerMutex);
+		currentRouter = router;
+	}
+	bool handled = false;
+	bool toMainThread = false;
+	RoutedMessage routed;
+	if(currentRouter){
+		dispatchingReceiver = this;
+		currentRouter->match(m.AddressPattern(), [&](std::size_t i){
+			const Route & route = currentRouter->routes[i];
+			handled = true;
+			if(route.dispatch == OFXOSC_DISPATCH_LISTENER_THREAD){
+				route.handler(msg);
+			}else{
+				if(!toMainThread){
+					routedPool.tryReceive(routed);
+					toMainThread = true;
+				}
+				routed.routes.push_back(i);
+			}
+		});
+		dispatchingReceiver = nullptr;
+	}
+	dispatchLock.unlock();
+	if(toMainThread){
+		std::swap(routed.message, msg);
+		routed.router = currentRouter;
+		routedChannel.send(std::move(routed));
+	}
+
+	if(handled){
+		msg.clear();
+		messagesPool.send(std::move(msg));
+	}else{
+		// send msg to main thread
+		messagesChannel.send(std::move(msg));
+	}
 }
 
 // friend functions
@@ -10,6 +10,8 @@
 #include "OscPacketListener.h"
 #include "UdpSocket.h"
 
+#include <mutex>
+
 /// \struct ofxOscSenderSettings
 /// \brief OSC message sender settings
 struct ofxOscReceiverSettings {
@@ -18,12 +20,21 @@ struct ofxOscReceiverSettings {
 	bool start = true;       ///< start listening after setup?
 };
 
+/// \brief thread where ofxOscReceiver calls a handler
+enum ofxOscDispatch{
+	/// from getNextMessage() or dispatchMessages() in the thread calling them,
+	/// usually the main thread
+	OFXOSC_DISPATCH_MAIN_THREAD,
+	/// from the listener thread as soon as the message arrives
+	OFXOSC_DISPATCH_LISTENER_THREAD,
+};
+
 /// \class ofxOscReceiver
 /// \brief OSC message receiver which listens on a network port
 class ofxOscReceiver : public osc::OscPacketListener {
 public:
 
-	ofxOscReceiver() {};
+	ofxOscReceiver();
 	~ofxOscReceiver();
 	ofxOscReceiver(const ofxOscReceiver &mom);
 	ofxOscReceiver& operator=(const ofxOscReceiver &mom);
@@ -66,12 +77,67 @@ public:
 	/// \return true if there are any messages waiting for collection
 	bool hasWaitingMessages() const;
 
-	/// remove a message from the queue and copy it's data into msg
+	/// call handler with every message whose address matches address
+	///
+	/// address can be an osc address pattern using the wildcards ? * [abc]
+	/// [a-z] [!abc] and {foo,bar}, received messages with an address pattern
+	/// are matched against the added addresses without wildcards
+	///
+	/// addresses are resolved by the listener thread with a hash table,
+	/// messages handled by any handler are not returned by getNextMessage
+	///
+	/// \return id to remove the handler with removeHandler
+	std::size_t addHandler(const std::string &address, std::function<void(const ofxOscMessage&)> handler, ofxOscDispatch dispatch = OFXOSC_DISPATCH_MAIN_THREAD);
+
+	/// set a parameter, or all the parameters in a group, from the messages
+	/// sent to its address as sent by ofxOscSender::sendParameter
+	///
+	/// parameters are set from getNextMessage() or dispatchMessages()
+	///
+	/// \return id to remove the parameter with removeHandler
+	std::size_t addParameter(ofAbstractParameter &parameter);
+
+	/// remove a handler or parameter, it won't be called after this returns
+	///
+	/// if the listener thread is calling handlers this waits for them to
+	/// return, unless it's called from one of them
+	void removeHandler(std::size_t id);
+
+	/// remove all the handlers and parameters, waits for the listener
+	/// thread like removeHandler
+	void clearHandlers();
+
+	/// call the main thread handlers of the messages received so far
+	///
+	/// getNextMessage() already does this, call it instead if all the
+	/// received messages are handled
+	///
+	/// \return number of messages handled
+	std::size_t dispatchMessages();
+
+	/// remove a message from the queue and move it's data into msg
+	///
+	/// the memory used by the previous contents of msg is reused for new
+	/// incoming messages, so receiving in a loop with the same message
+	/// doesn't allocate once the receiver is warmed up:
+	///
+	///     ofxOscMessage m;
+	///     while(receiver.getNextMessage(m)){
+	///         ...
+	///     }
+	///
+	/// messages with handlers added with addHandler or addParameter are
+	/// dispatched to them first
+	///
 	/// \return false if there are no waiting messages, otherwise return true
 	bool getNextMessage(ofxOscMessage& msg);
 	OF_DEPRECATED_MSG("Pass a reference instead of a pointer", bool getNextMessage(ofxOscMessage *msg));
 	
 	/// try to get waiting message an ofParameter
+	///
+	/// messages not sent to the parameter are discarded, use addParameter
+	/// to keep the parameter addresses instead of resolving them each call
+	///
 	/// \return true if message was handled by the given parameter
 	bool getParameter(ofAbstractParameter &parameter);
 
@@ -92,12 +158,57 @@ protected:
 
 private:
 
+	/// handler added for an address
+	struct Route{
+		std::string address;
+		std::uint64_t hash; ///< hash of address
+		bool pattern; ///< address contains wildcards
+		ofxOscDispatch dispatch;
+		std::size_t id;
+		std::function<void(const ofxOscMessage&)> handler;
+	};
+
+	/// table of the added handlers, immutable once built so the listener
+	/// thread can use it while the main thread replaces it
+	struct Router{
+		Router(std::vector<Route> &&routes);
+
+		/// call f with the index of every route matching address
+		template<typename Function>
+		void match(const char * address, Function f) const;
+
+		bool contains(std::size_t id) const;
+
+		std::vector<Route> routes;
+		std::vector<std::size_t> table; ///< open addressing hash table of the routes without wildcards, index + 1 or 0 if empty
+		std::vector<std::size_t> patterns; ///< indices of the routes with wildcards
+	};
+
+	/// message to be handled in the main thread by the matched routes
+	struct RoutedMessage{
+		ofxOscMessage message;
+		std::shared_ptr<const Router> router;
+		std::vector<std::size_t> routes;
+	};
+
+	void setRoutes(std::vector<Route> &&routes);
+	void waitForListenerHandlers();
+	static void addParameterRoutes(std::vector<Route> &routes, ofAbstractParameter &parameter, const std::string &address, std::size_t id, bool reference);
+
 	/// socket to listen on, unique for each port
 	/// shared between objects if allowReuse is true
 	std::unique_ptr<osc::UdpListeningReceiveSocket, std::function<void(osc::UdpListeningReceiveSocket*)>> listenSocket;
 
 	std::thread listenThread; ///< listener thread
 	ofThreadChannel<ofxOscMessage> messagesChannel; ///< message passing thread channel
+	ofBoundedThreadChannel<ofxOscMessage> messagesPool; ///< cleared messages given back by getNextMessage to be reused by the listener thread
+	ofThreadChannel<RoutedMessage> routedChannel; ///< messages with main thread handlers
+	ofBoundedThreadChannel<RoutedMessage> routedPool; ///< routed messages given back by dispatchMessages
+
+	std::shared_ptr<const Router> router; ///< current handlers, replaced as a whole when they change
+	mutable std::mutex routerMutex; ///< protects router
+	std::mutex dispatchMutex; ///< held by the listener thread while it calls handlers
+	std::size_t nextRouteId = 1;
 
 	ofxOscReceiverSettings settings; ///< current settings
 };
@@ -3,11 +3,41 @@
 #include "ofxOscSender.h"
 #include "ofUtils.h"
 #include "ofParameterGroup.h"
+#include "ofAppRunner.h"
+#include "ofAppBaseWindow.h"
 
 #include "UdpSocket.h"
 
 using namespace std;
 
+//--------------------------------------------------------------
+// serialise into a buffer per thread that grows as needed
+// instead of a big buffer in the stack for every call
+template<typename Function>
+static void serialize(Function append, const char *&data, std::size_t &size){
+	static thread_local std::vector<char> buffer(65536);
+	while(true){
+		try{
+			osc::OutboundPacketStream p(buffer.data(), buffer.size());
+			append(p);
+			data = p.Data();
+			size = p.Size();
+			return;
+		}
+		catch(osc::OutOfBufferMemoryException &){
+			buffer.resize(buffer.size() * 2);
+		}
+	}
+}
+
+//--------------------------------------------------------------
+static void appendInt32(std::vector<char> &data, std::uint32_t value){
+	data.push_back(char(value >> 24));
+	data.push_back(char(value >> 16));
+	data.push_back(char(value >> 8));
+	data.push_back(char(value));
+}
+
 //--------------------------------------------------------------
 ofxOscSender::~ofxOscSender() {
 	clear();
@@ -46,6 +76,16 @@ bool ofxOscSender::setup(const ofxOscSenderSettings &settings){
 	if(osc::UdpSocket::GetUdpBufferSize() == 0){
 	   osc::UdpSocket::SetUdpBufferSize(65535);
 	}
+
+	// messages queued for the previous host go to it
+	if(sendSocket){
+		flush();
+	}
+	{
+		std::unique_lock<std::mutex> lock(frameMutex);
+		frameListener.unsubscribe();
+		frameWindow.reset();
+	}
 	
 	this->settings = settings;
 	
@@ -83,6 +123,12 @@ bool ofxOscSender::setup(const ofxOscSenderSettings &settings){
 
 //--------------------------------------------------------------
 void ofxOscSender::clear(){
+	flush();
+	{
+		std::unique_lock<std::mutex> lock(frameMutex);
+		frameListener.unsubscribe();
+		frameWindow.reset();
+	}
 	sendSocket.reset();
 }
 
@@ -92,16 +138,14 @@ void ofxOscSender::sendBundle(const ofxOscBundle &bundle){
 		ofLogError("ofxOscSender") << "trying to send with empty socket";
 		return;
 	}
-	
-	// setting this much larger as it gets trimmed down to the size its using before being sent.
-	// TODO: much better if we could make this dynamic? Maybe have ofxOscBundle return its size?
-	static const int OUTPUT_BUFFER_SIZE = 327680;
-	char buffer[OUTPUT_BUFFER_SIZE];
-	osc::OutboundPacketStream p(buffer, OUTPUT_BUFFER_SIZE);
 
 	// serialise the bundle and send
-	appendBundle(bundle, p);
-	sendSocket->Send(p.Data(), p.Size());
+	const char *data;
+	std::size_t size;
+	serialize([&](osc::OutboundPacketStream &p){
+		appendBundle(bundle, p);
+	}, data, size);
+	sendPacket(data, size);
 }
 
 //--------------------------------------------------------------
@@ -110,22 +154,25 @@ void ofxOscSender::sendMessage(const ofxOscMessage &message, bool wrapInBundle){
 		ofLogError("ofxOscSender") << "trying to send with empty socket";
 		return;
 	}
-	
-	// setting this much larger as it gets trimmed down to the size its using before being sent.
-	// TODO: much better if we could make this dynamic? Maybe have ofxOscMessage return its size?
-	static const int OUTPUT_BUFFER_SIZE = 327680;
-	char buffer[OUTPUT_BUFFER_SIZE];
-	osc::OutboundPacketStream p(buffer, OUTPUT_BUFFER_SIZE);
 
-	// serialise the message and send
-	if(wrapInBundle) {
-		p << osc::BeginBundleImmediate;
-	}
-	appendMessage(message, p);
-	if(wrapInBundle) {
-		p << osc::EndBundle;
+	// queued messages are already in a bundle
+	if(settings.mode == OFXOSC_SEND_BUNDLE){
+		wrapInBundle = false;
 	}
-	sendSocket->Send(p.Data(), p.Size());
+
+	// serialise the message and send
+	const char *data;
+	std::size_t size;
+	serialize([&](osc::OutboundPacketStream &p){
+		if(wrapInBundle) {
+			p << osc::BeginBundleImmediate;
+		}
+		appendMessage(message, p);
+		if(wrapInBundle) {
+			p << osc::EndBundle;
+		}
+	}, data, size);
+	sendPacket(data, size);
 }
 
 //--------------------------------------------------------------
@@ -156,6 +203,43 @@ void ofxOscSender::sendParameter(const ofAbstractParameter &parameter){
 	}
 }
 
+//--------------------------------------------------------------
+void ofxOscSender::flush(){
+	std::unique_lock<std::mutex> lock(queueMutex);
+	if(queuedData.empty()){
+		return;
+	}
+	// close the bundle being filled
+	if(queuedPackets.empty() || queuedPackets.back() != queuedData.size()){
+		queuedPackets.push_back(queuedData.size());
+	}
+	if(sendSocket){
+		flushData.clear();
+		flushSizes.clear();
+		std::size_t start = 0;
+		for(auto end: queuedPackets){
+			flushData.push_back(queuedData.data() + start);
+			flushSizes.push_back(end - start);
+			start = end;
+		}
+		sendSocket->SendMany(flushData.data(), flushSizes.data(), flushData.size());
+		packetsSent += flushData.size();
+		bytesSent += queuedData.size();
+	}
+	queuedData.clear();
+	queuedPackets.clear();
+}
+
+//--------------------------------------------------------------
+std::uint64_t ofxOscSender::getPacketsSent() const{
+	return packetsSent;
+}
+
+//--------------------------------------------------------------
+std::uint64_t ofxOscSender::getBytesSent() const{
+	return bytesSent;
+}
+
 //--------------------------------------------------------------
 std::string ofxOscSender::getHost() const{
 	return settings.host;
@@ -285,6 +369,56 @@ void ofxOscSender::appendParameter(ofxOscMessage &msg, const ofAbstractParameter
 	}
 }
 
+//--------------------------------------------------------------
+void ofxOscSender::sendPacket(const char *data, std::size_t size){
+	if(settings.mode == OFXOSC_SEND_IMMEDIATE){
+		sendSocket->Send(data, size);
+		packetsSent++;
+		bytesSent += size;
+		return;
+	}
+
+	// the sender can be setup before there's a window, when ofEvents()
+	// are the events of no window, so it starts listening to draw of the
+	// current window when the messages are queued. Not under queueMutex,
+	// unsubscribing waits for a frameEnded that could be waiting for it
+	if(settings.flushEveryFrame){
+		std::unique_lock<std::mutex> lock(frameMutex);
+		auto window = ofGetCurrentWindow();
+		if(window && window != frameWindow.lock()){
+			frameListener = window->events().draw.newListener(this, &ofxOscSender::frameEnded, OF_EVENT_ORDER_AFTER_APP);
+			frameWindow = window;
+		}
+	}
+
+	std::unique_lock<std::mutex> lock(queueMutex);
+	if(settings.mode == OFXOSC_SEND_BUNDLE){
+		// add the packet as an element of the bundle being filled, or of
+		// a new one if it would get too big
+		std::size_t bundleStart = queuedPackets.empty() ? 0 : queuedPackets.back();
+		std::size_t bundleSize = queuedData.size() - bundleStart;
+		if(bundleSize > 0 && bundleSize + 4 + size > settings.maxPacketSize){
+			queuedPackets.push_back(queuedData.size());
+			bundleSize = 0;
+		}
+		if(bundleSize == 0){
+			static const char header[16] = {'#','b','u','n','d','l','e','\0', 0,0,0,0,0,0,0,1};
+			queuedData.insert(queuedData.end(), header, header + sizeof(header));
+		}
+		appendInt32(queuedData, size);
+		queuedData.insert(queuedData.end(), data, data + size);
+	}
+	else{
+		queuedData.insert(queuedData.end(), data, data + size);
+		queuedPackets.push_back(queuedData.size());
+	}
+}
+
+//--------------------------------------------------------------
+void ofxOscSender::frameEnded(ofEventArgs &){
+	flush();
+}
+
 // friend functions
 //--------------------------------------------------------------
 std::ostream& operator<<(std::ostream &os, const ofxOscSender &sender) {
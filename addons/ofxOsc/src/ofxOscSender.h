@@ -9,6 +9,25 @@
 #include "ofxOscBundle.h"
 #include "ofParameter.h"
 #include "ofParameterGroup.h"
+#include "ofEvents.h"
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+
+class ofAppBaseWindow;
+
+/// \brief when ofxOscSender sends the messages
+enum ofxOscSendMode{
+	/// every sendMessage, sendBundle and sendParameter call sends a packet
+	OFXOSC_SEND_IMMEDIATE,
+	/// messages are queued in a bundle until flush(), bundles
+	/// are split when they grow bigger than maxPacketSize
+	OFXOSC_SEND_BUNDLE,
+	/// messages are queued as separate packets until flush(), which sends
+	/// all of them with a single system call where sendmmsg is available
+	OFXOSC_SEND_PACKETS,
+};
 
 /// \struct ofxOscSenderSettings
 /// \brief OSC message sender settings
@@ -16,6 +35,9 @@ struct ofxOscSenderSettings {
 	std::string host = "localhost"; ///< destination host name/ip
 	int port = 0;                   ///< destination port
 	bool broadcast = true;          ///< broadcast (aka multicast) ip range support?
+	ofxOscSendMode mode = OFXOSC_SEND_IMMEDIATE; ///< send right away or queue messages until flush()
+	bool flushEveryFrame = true;    ///< flush the queued messages after draw every frame
+	std::size_t maxPacketSize = 1472; ///< max size of a queued bundle, 1472 fits in an ethernet frame
 };
 
 /// \class ofxOscSender
@@ -52,6 +74,17 @@ public:
 	/// create & send a message with data from an ofParameter
 	void sendParameter(const ofAbstractParameter &parameter);
 
+	/// send the messages queued with OFXOSC_SEND_BUNDLE or
+	/// OFXOSC_SEND_PACKETS, called after draw every frame if
+	/// flushEveryFrame is true
+	void flush();
+
+	/// \return number of packets given to the socket so far
+	std::uint64_t getPacketsSent() const;
+
+	/// \return number of bytes given to the socket so far
+	std::uint64_t getBytesSent() const;
+
 	/// \return current host name/ip
 	std::string getHost() const;
 
@@ -73,6 +106,22 @@ private:
 	void appendParameter(ofxOscBundle &bundle, const ofAbstractParameter &parameter, const std::string &address);
 	void appendParameter(ofxOscMessage &msg, const ofAbstractParameter &parameter, const std::string &address);
 
+	/// send or queue a serialised packet depending on the mode
+	void sendPacket(const char *data, std::size_t size);
+	void frameEnded(ofEventArgs &);
+
 	ofxOscSenderSettings settings; ///< current settings
 	std::unique_ptr<osc::UdpTransmitSocket> sendSocket; ///< sender socket
+
+	std::mutex queueMutex; ///< protects the queued packets
+	std::vector<char> queuedData; ///< queued packets one after another
+	std::vector<std::size_t> queuedPackets; ///< end of each complete packet in queuedData
+	std::vector<const char*> flushData; ///< packet pointers for SendMany, reused by flush
+	std::vector<std::size_t> flushSizes; ///< packet sizes for SendMany, reused by flush
+	std::mutex frameMutex; ///< protects frameListener and frameWindow
+	ofEventListener frameListener; ///< flushes after draw, bound when messages are queued
+	std::weak_ptr<ofAppBaseWindow> frameWindow; ///< window frameListener listens to
+
+	std::atomic<std::uint64_t> packetsSent{0}; ///< packets given to the socket
+	std::atomic<std::uint64_t> bytesSent{0}; ///< bytes given to the socket
 };
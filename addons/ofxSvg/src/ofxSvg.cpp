@@ -56,6 +56,8 @@ void ofxSVG::load(string path){
 }
 
 void ofxSVG::draw(){
+	// tessellate every path that changed in parallel before drawing
+	ofTessellatePaths(paths);
 	for(int i = 0; i < (int)paths.size(); i++){
 		paths[i].draw();
 	}
@@ -15,9 +15,24 @@
 
 using namespace std;
 
+namespace{
+    bool useSharedMeshesByDefault = false;
+
+    // normals transform with the inverse of the scale
+    glm::vec3 scaleNormal(const glm::vec3 & normal, const glm::vec3 & scale){
+        glm::vec3 scaled = normal;
+        for(int i = 0; i < 3; i++){
+            if(scale[i] != 0) scaled[i] /= scale[i];
+        }
+        float length = glm::length(scaled);
+        return length > 0 ? scaled / length : normal;
+    }
+}
+
 of3dPrimitive::of3dPrimitive()
 :usingVbo(true)
 ,mesh(new ofVboMesh)
+,usingSharedMesh(useSharedMeshesByDefault)
 {
     setScale(1.0, 1.0, 1.0);
 }
@@ -31,6 +46,13 @@ of3dPrimitive::~of3dPrimitive() {
 of3dPrimitive::of3dPrimitive(const of3dPrimitive & mom):ofNode(mom){
     texCoords = mom.texCoords;
     usingVbo = mom.usingVbo;
+    usingSharedMesh = mom.usingSharedMesh;
+    meshIsShared = mom.meshIsShared;
+    meshScale = mom.meshScale;
+	if(meshIsShared){
+		mesh = mom.mesh;
+		return;
+	}
 	if(usingVbo){
 		mesh = std::make_shared<ofVboMesh>();
 	}else{
@@ -42,7 +64,8 @@ of3dPrimitive::of3dPrimitive(const of3dPrimitive & mom):ofNode(mom){
 //----------------------------------------------------------
 of3dPrimitive::of3dPrimitive(const ofMesh & mesh)
 :usingVbo(true)
-,mesh(new ofVboMesh(mesh)){
+,mesh(new ofVboMesh(mesh))
+,usingSharedMesh(false){
 
 }
 
@@ -51,8 +74,21 @@ of3dPrimitive & of3dPrimitive::operator=(const of3dPrimitive & mom){
 	if(&mom!=this){
 		(*(ofNode*)this)=mom;
 		texCoords = mom.texCoords;
-		setUseVbo(mom.usingVbo);
-		*mesh = *mom.mesh;
+		usingSharedMesh = mom.usingSharedMesh;
+		meshScale = mom.meshScale;
+		if(mom.meshIsShared){
+			usingVbo = mom.usingVbo;
+			mesh = mom.mesh;
+			meshIsShared = true;
+		}else{
+			if(meshIsShared){
+				mesh = std::make_shared<ofVboMesh>();
+				usingVbo = true;
+				meshIsShared = false;
+			}
+			setUseVbo(mom.usingVbo);
+			*mesh = *mom.mesh;
+		}
 	}
     return *this;
 }
@@ -60,11 +96,13 @@ of3dPrimitive & of3dPrimitive::operator=(const of3dPrimitive & mom){
 // GETTERS //
 //----------------------------------------------------------
 ofMesh* of3dPrimitive::getMeshPtr() {
+    detachSharedMesh();
     return mesh.get();
 }
 
 //----------------------------------------------------------
 ofMesh& of3dPrimitive::getMesh() {
+    detachSharedMesh();
     return *mesh;
 }
 
@@ -180,6 +218,10 @@ void of3dPrimitive::mapTexCoordsFromTexture( const ofTexture& inTexture ) {
 //----------------------------------------------------------
 void of3dPrimitive::normalizeAndApplySavedTexCoords() {
 	auto tcoords = getTexCoords();
+	// new meshes already have normalized tex coords
+	if(tcoords == glm::vec4(0.f, 0.f, 1.f, 1.f)){
+		return;
+	}
     // when a new mesh is created, it uses normalized tex coords, we need to reset them
     // but save the ones used previously //
 	texCoords = {0.f, 0.f, 1.f, 1.f};
@@ -233,15 +275,16 @@ void of3dPrimitive::drawNormals(float length, bool bFaceNormals) const{
                 } else if ( i % 3 == 2) {
                     vert = (vertices[i-2]+vertices[i-1]+vertices[i]) / 3;
                 }
+                vert *= meshScale;
                 normalsMesh.setVertex(i*2, vert);
-				normal = glm::normalize(toGlm(normals[i]));
+				normal = scaleNormal(glm::normalize(toGlm(normals[i])), meshScale);
                 normal *= length;
 				normalsMesh.setVertex(i*2+1, vert+normal);
             }
         } else {
 			for(size_t i = 0; i < normals.size(); i++) {
-                vert = vertices[i];
-				normal = glm::normalize(toGlm(normals[i]));
+                vert = vertices[i] * meshScale;
+				normal = scaleNormal(glm::normalize(toGlm(normals[i])), meshScale);
                 normalsMesh.setVertex( i*2, vert);
                 normal *= length;
 				normalsMesh.setVertex(i*2+1, vert+normal);
@@ -265,7 +308,8 @@ void of3dPrimitive::drawAxes(float a_size)  const{
 
 //--------------------------------------------------------------
 void of3dPrimitive::setUseVbo(bool useVbo){
-	if(useVbo!=usingVbo){
+	// shared meshes are always vbo meshes, drawn as a mesh if not using vbo
+	if(useVbo!=usingVbo && !meshIsShared){
 		shared_ptr<ofMesh> newMesh;
 		if(useVbo){
 			newMesh = std::make_shared<ofVboMesh>();
@@ -283,6 +327,78 @@ bool of3dPrimitive::isUsingVbo() const{
 	return usingVbo;
 }
 
+//--------------------------------------------------------------
+void of3dPrimitive::setUseSharedMesh(bool useSharedMesh){
+	if(useSharedMesh == usingSharedMesh) return;
+	usingSharedMesh = useSharedMesh;
+	if(!usingSharedMesh && meshIsShared){
+		// a new mesh with the same mode to regenerate
+		auto mode = mesh->getMode();
+		if(usingVbo){
+			mesh = std::make_shared<ofVboMesh>();
+		}else{
+			mesh = std::make_shared<ofMesh>();
+		}
+		mesh->setMode(mode);
+		meshIsShared = false;
+		meshScale = {1.f, 1.f, 1.f};
+	}
+	updateMesh();
+}
+
+//--------------------------------------------------------------
+bool of3dPrimitive::isUsingSharedMesh() const{
+	return usingSharedMesh;
+}
+
+//--------------------------------------------------------------
+void of3dPrimitive::setUseSharedMeshesByDefault(bool useSharedMeshes){
+	useSharedMeshesByDefault = useSharedMeshes;
+}
+
+//--------------------------------------------------------------
+const glm::vec3 & of3dPrimitive::getMeshScale() const{
+	return meshScale;
+}
+
+//--------------------------------------------------------------
+glm::mat4 of3dPrimitive::getMeshTransformMatrix() const{
+	if(meshScale == glm::vec3(1.f, 1.f, 1.f)){
+		return getGlobalTransformMatrix();
+	}
+	return glm::scale(getGlobalTransformMatrix(), meshScale);
+}
+
+//--------------------------------------------------------------
+void of3dPrimitive::setSharedMesh(shared_ptr<ofVboMesh> sharedMesh, const glm::vec3 & scale){
+	mesh = sharedMesh;
+	meshIsShared = true;
+	meshScale = scale;
+}
+
+//--------------------------------------------------------------
+void of3dPrimitive::detachSharedMesh(){
+	if(!meshIsShared) return;
+	shared_ptr<ofMesh> newMesh;
+	if(usingVbo){
+		newMesh = std::make_shared<ofVboMesh>();
+	}else{
+		newMesh = std::make_shared<ofMesh>();
+	}
+	*newMesh = *mesh;
+	if(meshScale != glm::vec3(1.f, 1.f, 1.f)){
+		for(auto & vertex: newMesh->getVertices()){
+			vertex *= meshScale;
+		}
+		for(auto & normal: newMesh->getNormals()){
+			normal = scaleNormal(normal, meshScale);
+		}
+	}
+	mesh = newMesh;
+	meshIsShared = false;
+	meshScale = {1.f, 1.f, 1.f};
+}
+
 // PLANE PRIMITIVE //
 //--------------------------------------------------------------
 ofPlanePrimitive::ofPlanePrimitive() {
@@ -306,7 +422,11 @@ void ofPlanePrimitive::set(float _width, float _height, int columns, int rows, o
     height = _height;
 	resolution = { columns, rows };
     
-    getMesh() = ofMesh::plane( getWidth(), getHeight(), getResolution().x, getResolution().y, mode );
+    if(usingSharedMesh){
+        setSharedMesh(ofPrimitiveMeshCache::get().plane(getResolution().x, getResolution().y, mode), {getWidth(), getHeight(), 1.f});
+    }else{
+        getMesh() = ofMesh::plane( getWidth(), getHeight(), getResolution().x, getResolution().y, mode );
+    }
     
     normalizeAndApplySavedTexCoords();
     
@@ -349,19 +469,24 @@ void ofPlanePrimitive::setRows( int rows ) {
 //--------------------------------------------------------------
 void ofPlanePrimitive::setResolution( int columns, int rows ) {
 	resolution = { columns, rows };
-    ofPrimitiveMode mode = getMesh().getMode();
+    ofPrimitiveMode mode = mesh->getMode();
     
     set( getWidth(), getHeight(), getResolution().x, getResolution().y, mode );
 }
 
 //--------------------------------------------------------------
 void ofPlanePrimitive::setMode(ofPrimitiveMode mode) {
-    ofPrimitiveMode currMode = getMesh().getMode();
+    ofPrimitiveMode currMode = mesh->getMode();
     
     if( mode != currMode )
         set( getWidth(), getHeight(), getResolution().x, getResolution().y, mode );
 }
 
+//--------------------------------------------------------------
+void ofPlanePrimitive::updateMesh() {
+    set( getWidth(), getHeight(), getResolution().x, getResolution().y, mesh->getMode() );
+}
+
 //--------------------------------------------------------------
 int ofPlanePrimitive::getNumColumns() const {
     return (int)resolution.x;
@@ -416,7 +541,11 @@ void ofSpherePrimitive::set( float _radius, int res, ofPrimitiveMode mode ) {
     radius     = _radius;
     resolution = res;
 
-    getMesh() = ofMesh::sphere( getRadius(), getResolution(), mode );
+    if(usingSharedMesh){
+        setSharedMesh(ofPrimitiveMeshCache::get().sphere(getResolution(), mode), {getRadius(), getRadius(), getRadius()});
+    }else{
+        getMesh() = ofMesh::sphere( getRadius(), getResolution(), mode );
+    }
     
     normalizeAndApplySavedTexCoords();
 }
@@ -424,14 +553,14 @@ void ofSpherePrimitive::set( float _radius, int res, ofPrimitiveMode mode ) {
 //----------------------------------------------------------
 void ofSpherePrimitive::setResolution( int res ) {
     resolution             = res;
-    ofPrimitiveMode mode   = getMesh().getMode();
+    ofPrimitiveMode mode   = mesh->getMode();
     
     set(getRadius(), getResolution(), mode );
 }
 
 //----------------------------------------------------------
 void ofSpherePrimitive::setMode( ofPrimitiveMode mode ) {
-    ofPrimitiveMode currMode = getMesh().getMode();
+    ofPrimitiveMode currMode = mesh->getMode();
     if(currMode != mode)
         set(getRadius(), getResolution(), mode );
 }
@@ -442,6 +571,11 @@ void ofSpherePrimitive::setRadius(float _radius) {
     setResolution( getResolution() );
 }
 
+//----------------------------------------------------------
+void ofSpherePrimitive::updateMesh() {
+    set( getRadius(), getResolution(), mesh->getMode() );
+}
+
 //----------------------------------------------------------
 float ofSpherePrimitive::getRadius() const {
     return radius;
@@ -484,7 +618,11 @@ void ofIcoSpherePrimitive::setResolution( int iterations ) {
     // store the number of iterations in the resolution //
     resolution = iterations;
     
-    getMesh() = ofMesh::icosphere( getRadius(), getResolution() );
+    if(usingSharedMesh){
+        setSharedMesh(ofPrimitiveMeshCache::get().icosphere(getResolution()), {getRadius(), getRadius(), getRadius()});
+    }else{
+        getMesh() = ofMesh::icosphere( getRadius(), getResolution() );
+    }
     normalizeAndApplySavedTexCoords();
 }
 
@@ -500,6 +638,11 @@ void ofIcoSpherePrimitive::setRadius(float _radius) {
     setResolution( getResolution() );
 }
 
+//----------------------------------------------------------
+void ofIcoSpherePrimitive::updateMesh() {
+    setResolution( getResolution() );
+}
+
 //----------------------------------------------------------
 float ofIcoSpherePrimitive::getRadius() const {
     return radius;
@@ -568,7 +711,11 @@ void ofCylinderPrimitive::set(float _radius, float _height, int radiusSegments,
     vertices[2][1] = (getResolution().x+1) * (getResolution().z+1);
     
     
-    getMesh() = ofMesh::cylinder( getRadius(), getHeight(), getResolution().x, getResolution().y, getResolution().z, getCapped(), mode );
+    if(usingSharedMesh){
+        setSharedMesh(ofPrimitiveMeshCache::get().cylinder(getResolution().x, getResolution().y, getResolution().z, getCapped(), mode), {getRadius(), getHeight(), getRadius()});
+    }else{
+        getMesh() = ofMesh::cylinder( getRadius(), getHeight(), getResolution().x, getResolution().y, getResolution().z, getCapped(), mode );
+    }
     
     normalizeAndApplySavedTexCoords();
     
@@ -616,13 +763,13 @@ void ofCylinderPrimitive::setResolutionCap( int capRes ) {
 
 //--------------------------------------------------------------
 void ofCylinderPrimitive::setResolution( int radiusSegments, int heightSegments, int capSegments ) {
-    ofPrimitiveMode mode = getMesh().getMode();
+    ofPrimitiveMode mode = mesh->getMode();
     set( getRadius(), getHeight(), radiusSegments, heightSegments, capSegments, getCapped(), mode );
 }
 
 //----------------------------------------------------------
 void ofCylinderPrimitive::setMode( ofPrimitiveMode mode ) {
-    ofPrimitiveMode currMode = getMesh().getMode();
+    ofPrimitiveMode currMode = mesh->getMode();
     if(currMode != mode)
         set( getRadius(), getHeight(), getResolution().x, getResolution().y, getResolution().z, getCapped(), mode );
 }
@@ -702,6 +849,11 @@ ofMesh ofCylinderPrimitive::getBottomCapMesh() const {
                              vertices[2][0], vertices[2][0]+vertices[2][1] );
 }
 
+//--------------------------------------------------------------
+void ofCylinderPrimitive::updateMesh() {
+    set( getRadius(), getHeight(), getResolution().x, getResolution().y, getResolution().z, getCapped(), mesh->getMode() );
+}
+
 //--------------------------------------------------------------
 int ofCylinderPrimitive::getResolutionRadius() const {
     return (int)resolution.x;
@@ -783,7 +935,11 @@ void ofConePrimitive::set( float _radius, float _height, int radiusSegments, int
     vertices[1][0] = vertices[0][0] + vertices[0][1];
     vertices[1][1] = (getResolution().x+1) * (getResolution().z+1);
     
-    getMesh() = ofMesh::cone( getRadius(), getHeight(), getResolution().x, getResolution().y, getResolution().z, mode );
+    if(usingSharedMesh){
+        setSharedMesh(ofPrimitiveMeshCache::get().cone(getRadius(), getHeight(), getResolution().x, getResolution().y, getResolution().z, mode), {1.f, 1.f, 1.f});
+    }else{
+        getMesh() = ofMesh::cone( getRadius(), getHeight(), getResolution().x, getResolution().y, getResolution().z, mode );
+    }
     
     normalizeAndApplySavedTexCoords();
     
@@ -813,13 +969,13 @@ void ofConePrimitive::setResolutionCap( int capRes ) {
 
 //--------------------------------------------------------------
 void ofConePrimitive::setResolution( int radiusRes, int heightRes, int capRes ) {
-    ofPrimitiveMode mode = getMesh().getMode();
+    ofPrimitiveMode mode = mesh->getMode();
     set( getRadius(), getHeight(), radiusRes, heightRes, capRes, mode );
 }
 
 //----------------------------------------------------------
 void ofConePrimitive::setMode( ofPrimitiveMode mode ) {
-    ofPrimitiveMode currMode = getMesh().getMode();
+    ofPrimitiveMode currMode = mesh->getMode();
     if(currMode != mode)
         set( getRadius(), getHeight(), getResolution().x, getResolution().y, getResolution().z, mode );
 }
@@ -896,6 +1052,11 @@ ofMesh ofConePrimitive::getCapMesh() const {
     return getMesh().getMeshForIndices( startIndex, endIndex, startVertIndex, endVertIndex );
 }
 
+//--------------------------------------------------------------
+void ofConePrimitive::updateMesh() {
+    set( getRadius(), getHeight(), getResolution().x, getResolution().y, getResolution().z, mesh->getMode() );
+}
+
 //--------------------------------------------------------------
 int ofConePrimitive::getResolutionRadius() const {
     return (int)resolution.x;
@@ -995,7 +1156,11 @@ void ofBoxPrimitive::set( float width, float height, float depth, int resWidth,
     vertices[SIDE_BOTTOM][0] = vertices[SIDE_TOP][0] + vertices[SIDE_TOP][1];
     vertices[SIDE_BOTTOM][1] = (resY+1) * (resZ+1);
     
-    getMesh() = ofMesh::box( getWidth(), getHeight(), getDepth(), getResolution().x, getResolution().y, getResolution().z );
+    if(usingSharedMesh){
+        setSharedMesh(ofPrimitiveMeshCache::get().box(getResolution().x, getResolution().y, getResolution().z), getSize());
+    }else{
+        getMesh() = ofMesh::box( getWidth(), getHeight(), getDepth(), getResolution().x, getResolution().y, getResolution().z );
+    }
     
     normalizeAndApplySavedTexCoords();
 }
@@ -1102,6 +1267,11 @@ void ofBoxPrimitive::setSideColor( int sideIndex, ofColor color ) {
     getMesh().setColorForIndices( strides[sideIndex][0], strides[sideIndex][0]+strides[sideIndex][1], color );
 }
 
+//--------------------------------------------------------------
+void ofBoxPrimitive::updateMesh() {
+    setResolution( getResolution().x, getResolution().y, getResolution().z );
+}
+
 //--------------------------------------------------------------
 int ofBoxPrimitive::getResolutionWidth() const {
     return (int)resolution.x;
@@ -2,6 +2,7 @@
 
 #include "ofMesh.h"
 #include "ofNode.h"
+#include "ofPrimitiveMeshCache.h"
 #include <map>
 
 class ofTexture;
@@ -60,18 +61,54 @@ public:
 
     void setUseVbo(bool useVbo);
     bool isUsingVbo() const;
+
+    /// \brief Share the mesh with every primitive of the same type and
+    /// resolution through ofPrimitiveMeshCache.
+    ///
+    /// The shared mesh has unit size and is scaled by getMeshScale() when
+    /// drawn, getMesh() const returns it as is. Calling the non const
+    /// getMesh() or any method that modifies the mesh gives the primitive
+    /// its own copy at its real size until its size or resolution change.
+    void setUseSharedMesh(bool useSharedMesh);
+    bool isUsingSharedMesh() const;
+
+    /// \brief Whether primitives created from now on share their meshes.
+    static void setUseSharedMeshesByDefault(bool useSharedMeshes);
+
+    /// \returns The scale applied to the mesh when drawing, other than 1
+    /// only for shared meshes.
+    const glm::vec3 & getMeshScale() const;
+
+    /// \returns The global transform scaled by getMeshScale(), the
+    /// transform the mesh is drawn with.
+    glm::mat4 getMeshTransformMatrix() const;
 protected:
 
     // useful when creating a new model, since it uses normalized tex coords //
     void normalizeAndApplySavedTexCoords();
 
+    // regenerate the mesh with the current parameters after switching
+    // between shared and own meshes
+    virtual void updateMesh(){}
+
+    // use a mesh from the cache drawn with scale
+    void setSharedMesh(std::shared_ptr<ofVboMesh> sharedMesh, const glm::vec3 & scale);
+
 	glm::vec4 texCoords;
     bool usingVbo;
     std::shared_ptr<ofMesh>  mesh;
     mutable ofMesh normalsMesh;
 
+    bool usingSharedMesh;
+    // mesh is the one in the cache, copied before modifying it
+    bool meshIsShared = false;
+    glm::vec3 meshScale{1.f, 1.f, 1.f};
+
     std::vector<ofIndexType> getIndices( int startIndex, int endIndex ) const;
 
+private:
+    friend class ofPrimitiveBatch;
+    void detachSharedMesh();
 };
 
 
@@ -145,6 +182,7 @@ public:
     float getHeight() const;
 
 protected:
+    void updateMesh();
     float width;
     float height;
 	glm::vec2 resolution;
@@ -218,6 +256,7 @@ public:
     int getResolution() const;
 
 protected:
+    void updateMesh();
     float radius;
     int resolution;
 };
@@ -268,6 +307,7 @@ public:
     int getResolution() const;
 
 protected:
+    void updateMesh();
     float radius;
     int resolution;
 };
@@ -355,6 +395,7 @@ public:
     float getRadius() const;
     bool getCapped() const;
 protected:
+    void updateMesh();
     float radius;
     float height;
     bool bCapped;
@@ -457,6 +498,7 @@ public:
     float getHeight() const;
 
 protected:
+    void updateMesh();
     float radius;
     float height;
 
@@ -558,6 +600,7 @@ public:
     float getDepth() const;
 	glm::vec3 getSize() const;
 protected:
+    void updateMesh();
 	glm::vec3 size;
 	glm::vec3 resolution;
     // indices strides for faces //
@@ -229,7 +229,15 @@ public:
 	/// of the current mesh's lists.
 	void append(const ofMesh_ & mesh);
 
-	void mergeDuplicateVertices();
+	/// \brief Merge the vertices at the same position into one.
+	///
+	/// The merged vertex keeps the normal, color and texture coordinate of
+	/// the first of them. Vertices not used by any index are removed, a mesh
+	/// without indices gets indices for every vertex first.
+	///
+	/// \param epsilon Vertices closer than this are merged, by default
+	/// only vertices at exactly the same position.
+	void mergeDuplicateVertices(float epsilon = 0);
 
 	/// \returns a ofVec3f defining the centroid of all the vetices in the mesh.
 	V getCentroid() const;
@@ -307,7 +315,16 @@ public:
 	virtual void disableNormals();
 	virtual bool usingNormals() const;
 
-	void smoothNormals( float angle );
+	/// \brief Set the normal of every triangle corner to the average of the
+	/// normals of the faces that share its position.
+	///
+	/// Every corner becomes its own vertex, faces more than angle degrees
+	/// away from the corner's face don't contribute to its normal so sharp
+	/// edges stay sharp.
+	///
+	/// \param angle Max angle in degrees between faces that are smoothed.
+	/// \param epsilon Corners closer than this share their normal.
+	void smoothNormals( float angle, float epsilon = 0.01f );
         
         /// \brief Duplicates vertices and updates normals to get a low-poly look.
         void flatNormals();
@@ -586,17 +603,26 @@ public:
 	/// \brief Loads a mesh from a file located at the provided path into the mesh.
 	/// This will replace any existing data within the mesh.
 	///
-	/// It expects that the file will be in the [PLY Format](http://en.wikipedia.org/wiki/PLY_(file_format)).
-	/// It will only load meshes saved in the PLY ASCII format; the binary format is not supported.
-    void load(const std::filesystem::path& path);
+	/// It expects that the file will be in the [PLY Format](http://en.wikipedia.org/wiki/PLY_(file_format)),
+	/// ascii or binary little or big endian, or in the OBJ format if the extension is .obj.
+	/// The file is memory mapped and decoded straight into the mesh, big
+	/// ascii files and the vertices of binary ones are decoded in parallel.
+	/// Polygons with more than 3 vertices are split in triangles.
+	///
+	/// Vertex properties of PLY files are recognized by name: x, y, z,
+	/// nx, ny, nz, red, green, blue, alpha, r, g, b, a, u, v, s, t... any
+	/// type is converted, integer colors are normalized and any other
+	/// property is skipped.
+	///
+	/// \param multithreaded Decode big files in several threads.
+	void load(const std::filesystem::path& path, bool multithreaded = true);
 
-	///  \brief Saves the mesh at the passed path in the [PLY Format](http://en.wikipedia.org/wiki/PLY_(file_format)).
+	///  \brief Saves the mesh at the passed path in the [PLY Format](http://en.wikipedia.org/wiki/PLY_(file_format)),
+	///  or in the OBJ format if the extension is .obj.
 	///
 	///  There are two format options for PLY: a binary format and an ASCII format.
 	///  By default, it will save using the ASCII format.
-	///  Passing ``true`` into the ``useBinary`` parameter will save it in the binary format.
-	///
-	///  If you're planning on reloading the mesh into ofMesh, ofMesh currently only supports loading the ASCII format.
+	///  Passing ``true`` into the ``useBinary`` parameter will save it in the binary little endian format.
 	///
 	///  For more information, see the [PLY format specification](http://paulbourke.net/dataformats/ply/).
     void save(const std::filesystem::path& path, bool useBinary = false) const;
@@ -7,7 +7,88 @@
 #include "ofVectorMath.h"
 #include "ofMath.h"
 #include "ofLog.h"
+#include "ofTaskPool.h"
+#include "ofMeshIO.h"
 #include <map>
+#include <algorithm>
+#include <limits>
+
+namespace of{
+namespace priv{
+	// groups points closer than epsilon, or exactly equal if epsilon is 0,
+	// and returns for every point the index of the first point of its group.
+	//
+	// points are sorted by the cell of a grid of epsilon sized cells they
+	// fall in, so each point only has to be compared with the points in its
+	// cell and the neighbouring ones.
+	template<class V>
+	std::vector<std::size_t> weldPoints(const std::vector<V> & points, float epsilon){
+		auto cellKey = [](int64_t x, int64_t y, int64_t z){
+			uint64_t key = uint64_t(x) * 0x9E3779B97F4A7C15ull;
+			key ^= uint64_t(y) * 0xC2B2AE3D27D4EB4Full + (key << 6) + (key >> 2);
+			key ^= uint64_t(z) * 0x165667B19E3779F9ull + (key << 6) + (key >> 2);
+			return key;
+		};
+		auto floatBits = [](float f){
+			// -0 and 0 are the same position
+			uint32_t bits = 0;
+			if(f != 0){
+				memcpy(&bits, &f, sizeof(f));
+			}
+			return int64_t(bits);
+		};
+		auto cell = [&](const glm::vec3 & p, int dx, int dy, int dz){
+			if(epsilon > 0){
+				return cellKey(int64_t(std::floor(p.x / epsilon)) + dx,
+							   int64_t(std::floor(p.y / epsilon)) + dy,
+							   int64_t(std::floor(p.z / epsilon)) + dz);
+			}else{
+				return cellKey(floatBits(p.x), floatBits(p.y), floatBits(p.z));
+			}
+		};
+
+		std::size_t numPoints = points.size();
+		std::vector<std::pair<uint64_t, std::size_t>> cells(numPoints);
+		ofParallelFor(0, numPoints, [&](std::size_t i){
+			cells[i] = {cell(toGlm(points[i]), 0, 0, 0), i};
+		});
+		std::sort(cells.begin(), cells.end());
+
+		// the first point in the neighbouring cells close enough to each point
+		std::vector<std::size_t> groups(numPoints);
+		float epsilon2 = epsilon * epsilon;
+		int range = epsilon > 0 ? 1 : 0;
+		ofParallelFor(0, numPoints, [&](std::size_t i){
+			glm::vec3 p = toGlm(points[i]);
+			std::size_t first = i;
+			for(int dx = -range; dx <= range; dx++){
+				for(int dy = -range; dy <= range; dy++){
+					for(int dz = -range; dz <= range; dz++){
+						auto key = cell(p, dx, dy, dz);
+						auto it = std::lower_bound(cells.begin(), cells.end(), std::make_pair(key, std::size_t(0)));
+						// points in a cell are sorted by index
+						for(; it != cells.end() && it->first == key && it->second < first; ++it){
+							glm::vec3 other = toGlm(points[it->second]);
+							bool close = epsilon > 0 ? glm::distance2(p, other) <= epsilon2 : p == other;
+							if(close){
+								first = it->second;
+								break;
+							}
+						}
+					}
+				}
+			}
+			groups[i] = first;
+		});
+
+		// points close to a point that was already grouped join its group
+		for(std::size_t i = 0; i < numPoints; i++){
+			groups[i] = groups[groups[i]];
+		}
+		return groups;
+	}
+}
+}
 
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
@@ -1029,346 +1110,71 @@ void ofMesh_<V,N,C,T>::append(const ofMesh_<V,N,C,T> & mesh){
 
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
-void ofMesh_<V,N,C,T>::load(const std::filesystem::path& path){
-	ofFile is(path, ofFile::ReadOnly);
-	auto & data = *this;
-
-
-	std::string error;
-	ofBuffer buffer(is);
-	auto backup = data;
-
-	int orderVertices=-1;
-	int orderIndices=-1;
-
-	ofIndexType vertexCoordsFound=0;
-	ofIndexType colorCompsFound=0;
-	ofIndexType texCoordsFound=0;
-	ofIndexType normalsCoordsFound=0;
-
-	ofIndexType currentVertex = 0;
-	ofIndexType currentFace = 0;
-
-	bool colorTypeIsUChar = false; /// flag to distinguish between uchar (more common) and float (less common) color format in ply file
-	
-	enum State{
-		Header,
-		VertexDef,
-		FaceDef,
-		Vertices,
-		Normals,
-		Faces
-	};
-
-	
-	enum Attribute {
-		Position,
-		Color,
-		Normal,
-		TexCoord,
+void ofMesh_<V,N,C,T>::load(const std::filesystem::path& path, bool multithreaded){
+	// decoded into new vectors so the mesh stays the same if loading fails
+	std::vector<V> newVertices;
+	std::vector<N> newNormals;
+	std::vector<C> newColors;
+	std::vector<T> newTexCoords;
+	std::vector<ofIndexType> newIndices;
+
+	auto allocate = [&](std::size_t numVertices, bool hasNormals, bool hasColors, bool hasTexCoords){
+		of::priv::MeshAttributes attributes;
+		newVertices.resize(numVertices);
+		attributes.vertices = of::priv::meshAttribute(newVertices);
+		if(hasNormals){
+			newNormals.resize(numVertices);
+			attributes.normals = of::priv::meshAttribute(newNormals);
+		}
+		if(hasColors){
+			newColors.resize(numVertices);
+			attributes.colors = of::priv::meshAttribute(newColors, C::limit());
+		}
+		if(hasTexCoords){
+			newTexCoords.resize(numVertices);
+			attributes.texCoords = of::priv::meshAttribute(newTexCoords);
+		}
+		return attributes;
 	};
-	
-	std::vector<Attribute> meshDefinition;
-	
-	data.clear();
-	State state = Header;
-
-	int lineNum = 0;
-	ofBuffer::Lines lines = buffer.getLines();
-	ofBuffer::Line line = lines.begin();
-	lineNum++;
-	if(*line!="ply"){
-		error = "wrong format, expecting 'ply'";
-		goto clean;
-	}
-
-	line++;
-	lineNum++;
-	if(*line!="format ascii 1.0"){
-		error = "wrong format, expecting 'format ascii 1.0'";
-		goto clean;
-	}
-
-	for(;line != lines.end(); ++line){
-		lineNum++;
-		std::string lineStr = *line;
-		if(lineStr.find("comment")==0 || lineStr.empty()){
-			continue;
-		}
-
-		if((state==Header || state==FaceDef) && lineStr.find("element vertex")==0){
-			state = VertexDef;
-			orderVertices = MAX(orderIndices, 0)+1;
-			data.getVertices().resize(ofTo<size_t>(lineStr.substr(15)));
-			continue;
-		}
 
-		if((state==Header || state==VertexDef) && lineStr.find("element face")==0){
-			state = FaceDef;
-			orderIndices = MAX(orderVertices, 0)+1;
-			data.getIndices().resize(ofTo<size_t>(lineStr.substr(13))*3);
-			continue;
-		}
-
-		if(state==VertexDef && (lineStr.find("property float x")==0 || lineStr.find("property float y")==0 || lineStr.find("property float z")==0)){
-			meshDefinition.push_back(Position);
-			vertexCoordsFound++;
-			continue;
-		}
-
-		if(state==VertexDef && (lineStr.find("property float r")==0 || lineStr.find("property float g")==0 || lineStr.find("property float b")==0 || lineStr.find("property float a")==0)){
-			colorCompsFound++;
-			meshDefinition.push_back(Color);
-			data.getColors().resize(data.getVertices().size());
-			continue;
-		}
-
-		if(state==VertexDef && (lineStr.find("property uchar red")==0 || lineStr.find("property uchar green")==0 || lineStr.find("property uchar blue")==0 || lineStr.find("property uchar alpha")==0)){
-			colorTypeIsUChar = true;
-			colorCompsFound++;
-			meshDefinition.push_back(Color);
-			data.getColors().resize(data.getVertices().size());
-			continue;
-		}
-
-		if(state==VertexDef && (lineStr.find("property float u")==0 || lineStr.find("property float v")==0|| lineStr.find("property float s")==0 || lineStr.find("property float t")==0)){
-			texCoordsFound++;
-			meshDefinition.push_back(TexCoord);
-			data.getTexCoords().resize(data.getVertices().size());
-			continue;
-		}
-
-		if(state==VertexDef && (lineStr.find("property float nx")==0 || lineStr.find("property float ny")==0 || lineStr.find("property float nz")==0)){
-			normalsCoordsFound++;
-			meshDefinition.push_back(Normal);
-			if (normalsCoordsFound==3) data.getNormals().resize(data.getVertices().size());
-			continue;
-		}
-
-		if(state==FaceDef && lineStr.find("property list")!=0 && lineStr!="end_header"){
-			error = "wrong face definition";
-			goto clean;
-		}
-
-		if(lineStr=="end_header"){
-			if(data.hasColors() && colorCompsFound!=3 && colorCompsFound!=4){
-				error =  "data has color coordiantes but not correct number of components. Found " + ofToString(colorCompsFound) + " expecting 3 or 4";
-				goto clean;
-			}
-			if(data.hasNormals() && normalsCoordsFound!=3){
-				error = "data has normal coordiantes but not correct number of components. Found " + ofToString(normalsCoordsFound) + " expecting 3";
-				goto clean;
-			}
-			if(!data.hasVertices()){
-				ofLogWarning("ofMesh") << "load(): mesh loaded from \"" << path << "\" has no vertices";
-			}
-			if(orderVertices==-1) orderVertices=9999;
-			if(orderIndices==-1) orderIndices=9999;
-
-			if(orderVertices < orderIndices){
-				state = Vertices;
-			}else {
-				state = Faces;
-			}
-			continue;
-		}
-
-		if(state==Vertices){
-			if(data.getNumVertices()<=currentVertex){
-				error = "found more vertices: " + ofToString(currentVertex+1) + " than specified in header: " + ofToString(data.getNumVertices());
-				goto clean;
-			}
-			std::stringstream sline(lineStr);
-			
-			// read in a line of vertex elements
-			// and split it into attributes,
-			// based attribute order specified in file header
-			ofIndexType vAttr = 0;
-			ofIndexType nAttr = 0;
-			ofIndexType tAttr = 0;
-			ofIndexType cAttr = 0;
-			for(auto s:meshDefinition){
-				switch (s) {
-					case Position:
-						sline >> *(&data.getVertices()[currentVertex].x + (vAttr++)%vertexCoordsFound);
-						break;
-					case Color:
-						if (colorTypeIsUChar){
-							int c = 0;
-							sline >> c;
-							*(&data.getColors()[currentVertex].r + (cAttr++)%colorCompsFound) = c/255.f;
-						} else {
-							sline >> *(&data.getColors()[currentVertex].r + (cAttr++)%colorCompsFound);
-						}
-						break;
-					case Normal:
-						sline >> *(&data.getNormals()[currentVertex].x + (nAttr++)%normalsCoordsFound);
-						break;
-					case TexCoord:
-						sline >> *(&data.getTexCoords()[currentVertex].x + (tAttr++)%texCoordsFound);
-						break;
-					default:
-						break;
-				}
-			}
-			if (vAttr != vertexCoordsFound || cAttr!= colorCompsFound || nAttr!=normalsCoordsFound || tAttr!=texCoordsFound){
-				error = "attribute data does not match definition in header";
-				goto clean;
-			}
-			
-			currentVertex++;
-			if(currentVertex==data.getNumVertices()){
-				if(orderVertices<orderIndices){
-					state = Faces;
-				}else{
-					state = Vertices;
-				}
-			}
-			continue;
-		}
-
-		if(state==Faces){
-			if(data.getNumIndices()/3<currentFace){
-				error = "found more faces than specified in header";
-				goto clean;
-			}
-			std::stringstream sline(lineStr);
-			int numV;
-			sline >> numV;
-			if(numV!=3){
-				error = "face not a triangle";
-				goto clean;
-			}
-			ofIndexType i;
-			sline >> i;
-			data.getIndices()[currentFace*3] = i;
-			sline >> i;
-			data.getIndices()[currentFace*3+1] = i;
-			sline >> i;
-			data.getIndices()[currentFace*3+2] = i;
-
-			currentFace++;
-			if(currentFace==data.getNumIndices()/3){
-				if(orderVertices<orderIndices){
-					state = Vertices;
-				}else{
-					state = Faces;
-				}
-			}
-			continue;
-		}
+	std::string error;
+	if(!of::priv::loadMesh(path, allocate, newIndices, multithreaded, error)){
+		ofLogError("ofMesh") << "load(): couldn't load \"" << path << "\": " << error;
+		return;
 	}
 
+	clear();
+	vertices = std::move(newVertices);
+	normals = std::move(newNormals);
+	colors = std::move(newColors);
+	texCoords = std::move(newTexCoords);
+	indices = std::move(newIndices);
+	bVertsChanged = true;
+	bNormalsChanged = true;
+	bColorsChanged = true;
+	bTexCoordsChanged = true;
+	bIndicesChanged = true;
+	bFacesDirty = true;
 
-	return;
-	clean:
-	ofLogError("ofMesh") << "load(): " << lineNum << ":" << error;
-	ofLogError("ofMesh") << "load(): \"" << *line << "\"";
-	data = backup;
+	if(!hasVertices()){
+		ofLogWarning("ofMesh") << "load(): mesh loaded from \"" << path << "\" has no vertices";
+	}
 }
 
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
 void ofMesh_<V,N,C,T>::save(const std::filesystem::path& path, bool useBinary) const{
-	ofFile os(path, ofFile::WriteOnly);
-	const auto & data = *this;
-
-	os << "ply" << std::endl;
-	if(useBinary) {
-		os << "format binary_little_endian 1.0" << std::endl;
-	} else {
-		os << "format ascii 1.0" << std::endl;
-	}
-
-	if(data.getNumVertices()){
-		os << "element vertex " << data.getNumVertices() << std::endl;
-		os << "property float x" << std::endl;
-		os << "property float y" << std::endl;
-		os << "property float z" << std::endl;
-		if(data.getNumColors()){
-			os << "property uchar red" << std::endl;
-			os << "property uchar green" << std::endl;
-			os << "property uchar blue" << std::endl;
-			os << "property uchar alpha" << std::endl;
-		}
-		if(data.getNumTexCoords()){
-			os << "property float u" << std::endl;
-			os << "property float v" << std::endl;
-		}
-		if(data.getNumNormals()){
-			os << "property float nx" << std::endl;
-			os << "property float ny" << std::endl;
-			os << "property float nz" << std::endl;
-		}
-	}
-
-	uint8_t faceSize = 3;
-	if(data.getNumIndices()){
-		os << "element face " << data.getNumIndices() / faceSize << std::endl;
-		os << "property list uchar int vertex_indices" << std::endl;
-	} else if(data.getMode() == OF_PRIMITIVE_TRIANGLES) {
-		os << "element face " << data.getNumVertices() / faceSize << std::endl;
-		os << "property list uchar int vertex_indices" << std::endl;
-	}
-
-	os << "end_header" << std::endl;
-
-	for(std::size_t i = 0; i < data.getNumVertices(); i++){
-		if(useBinary) {
-			os.write((char*) &data.getVertices()[i], sizeof(V));
-		} else {
-			os << data.getVertex(i).x << " " << data.getVertex(i).y << " " << data.getVertex(i).z;
-		}
-		if(data.getNumColors()){
-			// VCG lib / MeshLab don't support float colors, so we have to cast
-			ofColor cur = data.getColors()[i];
-			if(useBinary) {
-				os.write((char*) &cur, sizeof(ofColor));
-			} else {
-				os << " " << (int) cur.r << " " << (int) cur.g << " " << (int) cur.b << " " << (int) cur.a;
-			}
-		}
-		if(data.getNumTexCoords()){
-			if(useBinary) {
-				os.write((char*) &data.getTexCoords()[i], sizeof(T));
-			} else {
-				os << " " << data.getTexCoord(i).x << " " << data.getTexCoord(i).y;
-			}
-		}
-		if(data.getNumNormals()){
-			if(useBinary) {
-				os.write((char*) &data.getNormals()[i], sizeof(V));
-			} else {
-				os << " " << data.getNormal(i).x << " " << data.getNormal(i).y << " " << data.getNormal(i).z;
-			}
-		}
-		if(!useBinary) {
-			os << std::endl;
-		}
-	}
-
-	if(data.getNumIndices()) {
-		for(uint32_t i = 0; i < data.getNumIndices(); i += faceSize) {
-			if(useBinary) {
-				os.write((char*) &faceSize, sizeof(unsigned char));
-				os.write((char*)&data.getIndices()[i], faceSize);
-			} else {
-				os << (std::size_t) faceSize << " " << data.getIndex(i) << " " << data.getIndex(i+1) << " " << data.getIndex(i+2) << std::endl;
-			}
-		}
-	} else if(data.getMode() == OF_PRIMITIVE_TRIANGLES) {
-		for(uint32_t i = 0; i < data.getNumVertices(); i += faceSize) {
-			uint32_t indices[] = {i, i + 1, i + 2};
-			if(useBinary) {
-				os.write((char*) &faceSize, sizeof(unsigned char));
-				os.write((char*) indices, sizeof(indices));
-			} else {
-				os << (std::size_t) faceSize << " " << indices[0] << " " << indices[1] << " " << indices[2] << std::endl;
-			}
-		}
-	}
+	of::priv::MeshAttributes attributes;
+	attributes.vertices = of::priv::meshAttribute(vertices);
+	attributes.normals = of::priv::meshAttribute(normals);
+	attributes.colors = of::priv::meshAttribute(colors, C::limit());
+	attributes.texCoords = of::priv::meshAttribute(texCoords);
 
 	//TODO: add index generation for other OF_PRIMITIVE cases
+	std::string error;
+	if(!of::priv::saveMesh(path, attributes, getNumVertices(), indices, getMode() == OF_PRIMITIVE_TRIANGLES, useBinary, error)){
+		ofLogError("ofMesh") << "save(): couldn't save \"" << path << "\": " << error;
+	}
 }
 
 
@@ -1459,97 +1265,64 @@ ofMesh_<V,N,C,T> ofMesh_<V,N,C,T>::getMeshForIndices( ofIndexType startIndex, of
 
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
-void ofMesh_<V,N,C,T>::mergeDuplicateVertices() {
-
-	std::vector<V> verts = getVertices();
-	std::vector<ofIndexType> indices = getIndices();
-
-	//get indexes to share single point - TODO: try j < i
-	for(ofIndexType i = 0; i < indices.size(); i++) {
-		for(ofIndexType j = 0; j < indices.size(); j++ ) {
-			if(i==j) continue;
-
-			ofIndexType i1 = indices[i];
-			ofIndexType i2 = indices[j];
-			const V & v1 = verts[ i1 ];
-			const V & v2 = verts[ i2 ];
-
-			if( v1 == v2 && i1 != i2) {
-				indices[j] = i1;
-				break;
-			}
-		}
+void ofMesh_<V,N,C,T>::mergeDuplicateVertices(float epsilon) {
+	if(!hasIndices()){
+		setupIndicesAuto();
 	}
 
-	//indices array now has list of unique points we need
-	//but we need to delete the old points we're not using and that means the index values will change
-	//so we are going to create a new list of points and new indexes - we will use a map to map old index values to the new ones
-	std::vector <V> newPoints;
-	std::vector <ofIndexType> newIndexes;
-	std::map <ofIndexType, bool> ptCreated;
-	std::map <ofIndexType, ofIndexType> oldIndexNewIndex;
+	auto groups = of::priv::weldPoints(vertices, epsilon);
 
-	std::vector<ofFloatColor> newColors;
-	std::vector<ofFloatColor>& colors = getColors();
-	std::vector<T> newTCoords;
-	std::vector<T>& tcoords = getTexCoords();
+	// keep the first vertex of every group that is used by the indices,
+	// with its normal, color and texture coordinate, in the order they
+	// are first used
+	const std::size_t unused = std::numeric_limits<std::size_t>::max();
+	std::vector<std::size_t> newIndices(vertices.size(), unused);
+	std::vector<V> newVertices;
 	std::vector<N> newNormals;
-	std::vector<N>& normals = getNormals();
-
-	for(ofIndexType i = 0; i < indices.size(); i++){
-		ptCreated[i] = false;
-	}
-
-	for(ofIndexType i = 0; i < indices.size(); i++){
-		ofIndexType index = indices[i];
-		const auto & p = verts[ index ];
-
-		if( ptCreated[index] == false ){
-			oldIndexNewIndex[index] = newPoints.size();
-			newPoints.push_back( p );
-			if(hasColors()) {
-				newColors.push_back(colors[index]);
+	std::vector<C> newColors;
+	std::vector<T> newTexCoords;
+
+	bool bHasColors = hasColors();
+	bool bHasNormals = hasNormals();
+	bool bHasTexCoords = hasTexCoords();
+
+	for(auto & index: indices){
+		auto first = groups[index];
+		if(newIndices[first] == unused){
+			newIndices[first] = newVertices.size();
+			newVertices.push_back(vertices[first]);
+			if(bHasColors) {
+				newColors.push_back(colors[first]);
 			}
-			if(hasTexCoords()) {
-				newTCoords.push_back(tcoords[index]);
+			if(bHasTexCoords) {
+				newTexCoords.push_back(texCoords[first]);
 			}
-			if(hasNormals()) {
-				newNormals.push_back(normals[index]);
+			if(bHasNormals) {
+				newNormals.push_back(normals[first]);
 			}
-
-			ptCreated[index] = true;
 		}
-
-		//ofLogNotice("ofMesh") << "[" << i << "]: old " << index << " --> " << oldIndexNewIndex[index];
-		newIndexes.push_back( oldIndexNewIndex[index] );
+		index = newIndices[first];
 	}
 
-	verts.clear();
-	verts = newPoints;
-
-	indices.clear();
-	indices = newIndexes;
-
-	clearIndices();
-	addIndices(indices);
-	clearVertices();
-	addVertices( verts );
+	vertices = std::move(newVertices);
+	bVertsChanged = true;
+	bIndicesChanged = true;
+	bFacesDirty = true;
 
-	if(hasColors()) {
-		clearColors();
-		addColors( newColors );
+	if(bHasColors) {
+		colors = std::move(newColors);
+		bColorsChanged = true;
 	}
 
-	if(hasTexCoords()) {
-		clearTexCoords();
-		addTexCoords( newTCoords );
+	if(bHasTexCoords) {
+		texCoords = std::move(newTexCoords);
+		bTexCoordsChanged = true;
 	}
 
-	if(hasNormals()) {
-		clearNormals();
-		addNormals( newNormals );
+	if(bHasNormals) {
+		normals = std::move(newNormals);
+		bNormalsChanged = true;
 	}
-
 }
 
 
@@ -1703,102 +1476,91 @@ void ofMesh_<V,N,C,T>::setFromTriangles( const std::vector<ofMeshFace_<V,N,C,T>>
 
 //--------------------------------------------------------------
 template<class V, class N, class C, class T>
-void ofMesh_<V,N,C,T>::smoothNormals( float angle ) {
+void ofMesh_<V,N,C,T>::smoothNormals( float angle, float epsilon ) {
 
 	if( getMode() == OF_PRIMITIVE_TRIANGLES) {
-		std::vector<ofMeshFace_<V,N,C,T>> triangles = getUniqueFaces();
-		std::vector<V> verts;
-		for(ofIndexType i = 0; i < triangles.size(); i++) {
-			for(ofIndexType j = 0; j < 3; j++) {
-				verts.push_back( triangles[i].getVertex(j) );
+		// every corner of every triangle becomes a vertex, like in getUniqueFaces
+		bool bHasIndices = hasIndices();
+		std::size_t numCorners = (bHasIndices ? indices.size() : vertices.size()) / 3 * 3;
+		if(numCorners == 0) {
+			return;
+		}
+		auto vertexIndex = [&](std::size_t corner) -> std::size_t {
+			return bHasIndices ? indices[corner] : corner;
+		};
+
+		std::vector<V> corners(numCorners);
+		std::vector<glm::vec3> faceNormals(numCorners / 3);
+		ofParallelFor(0, numCorners / 3, [&](std::size_t face){
+			for(std::size_t k = 0; k < 3; k++) {
+				corners[face * 3 + k] = vertices[vertexIndex(face * 3 + k)];
 			}
-		}
+			glm::vec3 u = toGlm(corners[face * 3 + 1] - corners[face * 3]);
+			glm::vec3 v = toGlm(corners[face * 3 + 2] - corners[face * 3]);
+			faceNormals[face] = glm::normalize(glm::cross(u, v));
+		});
 
-		std::map<int, int> removeIds;
-
-		float epsilon = .01f;
-		for(ofIndexType i = 0; i < verts.size()-1; i++) {
-			for(ofIndexType j = i+1; j < verts.size(); j++) {
-				if(i != j) {
-					const auto& v1 = toGlm(verts[i]);
-					const auto& v2 = toGlm(verts[j]);
-					if( glm::distance(v1, v2) <= epsilon ) {
-						// average the location //
-						verts[i] = (v1+v2)/2.f;
-						verts[j] = verts[i];
-						removeIds[j] = 1;
-					}
-				}
-			}
+		// corners at the same position, one group after another
+		auto groups = of::priv::weldPoints(corners, epsilon);
+		std::vector<std::size_t> groupStart(numCorners + 1, 0);
+		for(auto group: groups) {
+			groupStart[group + 1]++;
 		}
-
-		// string of vertex in 3d space to triangle index //
-		std::map<std::string, std::vector<int> > vertHash;
-
-		//ofLogNotice("ofMesh") << "smoothNormals(): num verts = " << verts.size() << " tris size = " << triangles.size();
-
-		std::string xStr, yStr, zStr;
-
-		for(ofIndexType i = 0; i < verts.size(); i++ ) {
-			xStr = "x"+ofToString(verts[i].x==-0?0:verts[i].x);
-			yStr = "y"+ofToString(verts[i].y==-0?0:verts[i].y);
-			zStr = "z"+ofToString(verts[i].z==-0?0:verts[i].z);
-			std::string vstring = xStr+yStr+zStr;
-			if(vertHash.find(vstring) == vertHash.end()) {
-				for(ofIndexType j = 0; j < triangles.size(); j++) {
-					for(ofIndexType k = 0; k < 3; k++) {
-						if(verts[i].x == triangles[j].getVertex(k).x) {
-							if(verts[i].y == triangles[j].getVertex(k).y) {
-								if(verts[i].z == triangles[j].getVertex(k).z) {
-									vertHash[vstring].push_back( j );
-								}
-							}
-						}
-					}
-				}
+		for(std::size_t i = 0; i < numCorners; i++) {
+			groupStart[i + 1] += groupStart[i];
+		}
+		std::vector<std::size_t> groupCorners(numCorners);
+		{
+			auto next = groupStart;
+			for(std::size_t i = 0; i < numCorners; i++) {
+				groupCorners[next[groups[i]]++] = i;
 			}
 		}
 
-//		for( std::map<std::string, std::vector<int> >::iterator it = vertHash.begin(); it != vertHash.end(); ++it) {
-//			//for( std::map<std::string, int >::iterator it = vertHash.begin(); it != vertHash.end(); ++it) {
-//			ofLogNotice("ofMesh") << "smoothNormals(): " << it->first << "  num = " << it->second.size();
-//		}
-
-		V vert;
-		N normal;
+		// average the normals of the faces around each corner that are
+		// within angle of its own face
 		float angleCos = cos(angle * DEG_TO_RAD );
-		float numNormals=0;
-
-		for(ofIndexType j = 0; j < triangles.size(); j++) {
-			for(ofIndexType k = 0; k < 3; k++) {
-				vert = triangles[j].getVertex(k);
-				xStr = "x"+ofToString(vert.x==-0?0:vert.x);
-				yStr = "y"+ofToString(vert.y==-0?0:vert.y);
-				zStr = "z"+ofToString(vert.z==-0?0:vert.z);
-
-				std::string vstring = xStr+yStr+zStr;
-				numNormals=0;
-				normal = {0.f,0.f,0.f};
-				if(vertHash.find(vstring) != vertHash.end()) {
-					for(ofIndexType i = 0; i < vertHash[vstring].size(); i++) {
-						auto f1 = triangles[j].getFaceNormal();
-						auto f2 = triangles[vertHash[vstring][i]].getFaceNormal();
-						if(glm::dot(toGlm(f1), toGlm(f2)) >= angleCos ) {
-							normal += f2;
-							numNormals+=1.f;
-						}
-					}
-					//normal /= (float)vertHash[vstring].size();
-					normal /= numNormals;
-
-					triangles[j].setNormal(k, normal);
+		std::vector<N> newNormals(numCorners);
+		ofParallelFor(0, numCorners, [&](std::size_t corner){
+			const auto & faceNormal = faceNormals[corner / 3];
+			auto group = groups[corner];
+			glm::vec3 normal(0.f);
+			float numNormals = 0;
+			for(std::size_t i = groupStart[group]; i < groupStart[group + 1]; i++) {
+				const auto & other = faceNormals[groupCorners[i] / 3];
+				if(glm::dot(faceNormal, other) >= angleCos ) {
+					normal += other;
+					numNormals += 1.f;
 				}
 			}
-		}
+			if(numNormals > 0) {
+				normal /= numNormals;
+			}
+			newNormals[corner] = normal;
+		});
 
-		//ofLogNotice("ofMesh") << "smoothNormals(): setting from triangles ";
-		setFromTriangles( triangles );
+		if(hasColors()) {
+			std::vector<C> newColors(numCorners);
+			for(std::size_t i = 0; i < numCorners; i++) {
+				newColors[i] = colors[vertexIndex(i)];
+			}
+			colors = std::move(newColors);
+		}
+		if(hasTexCoords()) {
+			std::vector<T> newTexCoords(numCorners);
+			for(std::size_t i = 0; i < numCorners; i++) {
+				newTexCoords[i] = texCoords[vertexIndex(i)];
+			}
+			texCoords = std::move(newTexCoords);
+		}
+		vertices = std::move(corners);
+		normals = std::move(newNormals);
 
+		setupIndicesAuto();
+		bVertsChanged = true;
+		bNormalsChanged = true;
+		bColorsChanged = true;
+		bTexCoordsChanged = true;
 	}
 }
 
@@ -0,0 +1,1182 @@
+#include "ofMeshIO.h"
+#include "ofFileUtils.h"
+#include "ofUtils.h"
+#include "ofTaskPool.h"
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <unordered_map>
+
+#ifdef TARGET_WIN32
+	#include <windows.h>
+#elif !defined(TARGET_EMSCRIPTEN)
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+using namespace std;
+using of::priv::MeshAttribute;
+using of::priv::MeshAttributes;
+using of::priv::MeshAllocator;
+
+namespace{
+	// files smaller than this are decoded in a single thread
+	const size_t chunkSize = 1 << 20;
+
+	//--------------------------------------------------------------
+	// a whole file mapped in memory or, where that's not possible like for
+	// qt resources, read into a buffer
+	class MappedFile{
+	public:
+		MappedFile(const string & path){
+#ifdef TARGET_WIN32
+			file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if(file != INVALID_HANDLE_VALUE){
+				LARGE_INTEGER fileSize;
+				if(GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0){
+					mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+					if(mapping){
+						mapped = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+						mappedSize = mapped ? size_t(fileSize.QuadPart) : 0;
+					}
+				}
+			}
+#elif !defined(TARGET_EMSCRIPTEN)
+			int fd = ::open(path.c_str(), O_RDONLY);
+			if(fd >= 0){
+				struct stat fileStat;
+				if(fstat(fd, &fileStat) == 0 && fileStat.st_size > 0){
+					void * data = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+					if(data != MAP_FAILED){
+						madvise(data, fileStat.st_size, MADV_WILLNEED);
+						mapped = static_cast<const char*>(data);
+						mappedSize = fileStat.st_size;
+					}
+				}
+				::close(fd);
+			}
+#endif
+			if(mapped){
+				opened = true;
+			}else{
+				ofFile is(path, ofFile::ReadOnly);
+				opened = is.is_open();
+				if(opened){
+					buffer = ofBuffer(is);
+				}
+			}
+		}
+
+		~MappedFile(){
+#ifdef TARGET_WIN32
+			if(mapped) UnmapViewOfFile(mapped);
+			if(mapping) CloseHandle(mapping);
+			if(file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#elif !defined(TARGET_EMSCRIPTEN)
+			if(mapped) munmap(const_cast<char*>(mapped), mappedSize);
+#endif
+		}
+
+		MappedFile(const MappedFile &) = delete;
+		MappedFile & operator=(const MappedFile &) = delete;
+
+		bool isOpen() const{
+			return opened;
+		}
+
+		const char * data() const{
+			return mapped ? mapped : buffer.getData();
+		}
+
+		size_t size() const{
+			return mapped ? mappedSize : buffer.size();
+		}
+
+	private:
+		const char * mapped = nullptr;
+		size_t mappedSize = 0;
+		ofBuffer buffer;
+		bool opened = false;
+#ifdef TARGET_WIN32
+		HANDLE file = INVALID_HANDLE_VALUE;
+		HANDLE mapping = nullptr;
+#endif
+	};
+
+	//--------------------------------------------------------------
+	// text parsing without streams or the locale
+
+	inline bool isBlank(char c){
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	inline bool isDigit(char c){
+		return c >= '0' && c <= '9';
+	}
+
+	inline const char * findLineEnd(const char * p, const char * end){
+		auto lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+		return lineEnd ? lineEnd : end;
+	}
+
+	inline bool isBlankLine(const char * p, const char * end){
+		for(; p < end; p++){
+			if(!isBlank(*p)) return false;
+		}
+		return true;
+	}
+
+	// parses the next decimal number in [p, end), skipping blanks before it,
+	// and leaves p after it. Up to 19 significant digits are accumulated in
+	// an integer and scaled by a power of 10, which is exact for the floats
+	// and ints found in mesh files. inf and nan go through strtod.
+	bool parseNumber(const char *& p, const char * end, double & value){
+		static const double powers[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+		};
+
+		while(p < end && isBlank(*p)) p++;
+		const char * start = p;
+		bool negative = false;
+		if(p < end && (*p == '-' || *p == '+')){
+			negative = *p == '-';
+			p++;
+		}
+
+		uint64_t mantissa = 0;
+		int digits = 0;
+		int exponent = 0;
+		bool found = false;
+		for(; p < end && isDigit(*p); p++){
+			found = true;
+			if(digits < 19){
+				mantissa = mantissa * 10 + (*p - '0');
+				digits += mantissa != 0;
+			}else{
+				exponent++;
+			}
+		}
+		if(p < end && *p == '.'){
+			p++;
+			for(; p < end && isDigit(*p); p++){
+				found = true;
+				if(digits < 19){
+					mantissa = mantissa * 10 + (*p - '0');
+					digits += mantissa != 0;
+					exponent--;
+				}
+			}
+		}
+
+		if(!found){
+			char token[64];
+			size_t length = 0;
+			for(p = start; p < end && length < sizeof(token) - 1 && !isBlank(*p) && *p != '\n'; p++){
+				token[length++] = *p;
+			}
+			token[length] = 0;
+			char * tokenEnd;
+			value = strtod(token, &tokenEnd);
+			p = start + (tokenEnd - token);
+			return tokenEnd != token;
+		}
+
+		if(p < end && (*p == 'e' || *p == 'E')){
+			const char * e = p + 1;
+			bool negativeExponent = false;
+			if(e < end && (*e == '-' || *e == '+')){
+				negativeExponent = *e == '-';
+				e++;
+			}
+			if(e < end && isDigit(*e)){
+				int decimalExponent = 0;
+				for(; e < end && isDigit(*e); e++){
+					decimalExponent = std::min(decimalExponent * 10 + (*e - '0'), 10000);
+				}
+				exponent += negativeExponent ? -decimalExponent : decimalExponent;
+				p = e;
+			}
+		}
+
+		double result = double(mantissa);
+		if(exponent < 0){
+			result = exponent >= -22 ? result / powers[-exponent] : result * std::pow(10., exponent);
+		}else if(exponent > 0){
+			result = exponent <= 22 ? result * powers[exponent] : result * std::pow(10., exponent);
+		}
+		value = negative ? -result : result;
+		return true;
+	}
+
+	void appendNumber(string & out, float value){
+		char number[32];
+		int length = snprintf(number, sizeof(number), "%g", value);
+		out.append(number, length);
+	}
+
+	void appendNumber(string & out, uint64_t value){
+		char number[24];
+		char * p = number + sizeof(number);
+		do{
+			*--p = char('0' + value % 10);
+			value /= 10;
+		}while(value);
+		out.append(p, number + sizeof(number) - p);
+	}
+
+	//--------------------------------------------------------------
+	// binary values
+
+	bool isLittleEndianHost(){
+		uint16_t one = 1;
+		uint8_t first;
+		memcpy(&first, &one, 1);
+		return first == 1;
+	}
+
+	template<class Type>
+	inline Type readBinary(const char * p, bool swap){
+		Type value;
+		if(swap){
+			char bytes[sizeof(Type)];
+			for(size_t i = 0; i < sizeof(Type); i++){
+				bytes[i] = p[sizeof(Type) - 1 - i];
+			}
+			memcpy(&value, bytes, sizeof(Type));
+		}else{
+			memcpy(&value, p, sizeof(Type));
+		}
+		return value;
+	}
+
+	template<class Type>
+	inline void appendBinary(string & out, Type value, bool swap){
+		char bytes[sizeof(Type)];
+		memcpy(bytes, &value, sizeof(Type));
+		if(swap){
+			std::reverse(bytes, bytes + sizeof(Type));
+		}
+		out.append(bytes, sizeof(Type));
+	}
+
+	//--------------------------------------------------------------
+	// ply
+
+	enum PlyType{
+		PlyInvalid,
+		PlyInt8,
+		PlyUInt8,
+		PlyInt16,
+		PlyUInt16,
+		PlyInt32,
+		PlyUInt32,
+		PlyFloat32,
+		PlyFloat64,
+	};
+
+	enum PlyFormat{
+		PlyAscii,
+		PlyBinaryLittleEndian,
+		PlyBinaryBigEndian,
+	};
+
+	enum PlyAttribute{
+		PlyIgnored,
+		PlyPosition,
+		PlyNormal,
+		PlyColor,
+		PlyTexCoord,
+		PlyFaceIndices,
+	};
+
+	struct PlyProperty{
+		string name;
+		PlyType type = PlyInvalid;
+		PlyType countType = PlyInvalid;
+		bool isList = false;
+		PlyAttribute attribute = PlyIgnored;
+		size_t component = 0;
+		double scale = 1;
+		size_t offset = 0;
+		const MeshAttribute * target = nullptr;
+	};
+
+	struct PlyElement{
+		string name;
+		size_t count = 0;
+		vector<PlyProperty> properties;
+		bool hasLists = false;
+		size_t stride = 0;
+	};
+
+	PlyType plyType(const string & name){
+		if(name == "char" || name == "int8") return PlyInt8;
+		if(name == "uchar" || name == "uint8") return PlyUInt8;
+		if(name == "short" || name == "int16") return PlyInt16;
+		if(name == "ushort" || name == "uint16") return PlyUInt16;
+		if(name == "int" || name == "int32") return PlyInt32;
+		if(name == "uint" || name == "uint32") return PlyUInt32;
+		if(name == "float" || name == "float32") return PlyFloat32;
+		if(name == "double" || name == "float64") return PlyFloat64;
+		return PlyInvalid;
+	}
+
+	size_t plyTypeSize(PlyType type){
+		switch(type){
+			case PlyInt8:
+			case PlyUInt8:
+				return 1;
+			case PlyInt16:
+			case PlyUInt16:
+				return 2;
+			case PlyInt32:
+			case PlyUInt32:
+			case PlyFloat32:
+				return 4;
+			case PlyFloat64:
+				return 8;
+			default:
+				return 0;
+		}
+	}
+
+	// value of 1 for colors stored as integers
+	double plyTypeMax(PlyType type){
+		switch(type){
+			case PlyInt8: return 127;
+			case PlyUInt8: return 255;
+			case PlyInt16: return 32767;
+			case PlyUInt16: return 65535;
+			case PlyInt32: return 2147483647.;
+			case PlyUInt32: return 4294967295.;
+			default: return 1;
+		}
+	}
+
+	inline double readPly(const char * p, PlyType type, bool swap){
+		switch(type){
+			case PlyInt8: return int8_t(*p);
+			case PlyUInt8: return uint8_t(*p);
+			case PlyInt16: return readBinary<int16_t>(p, swap);
+			case PlyUInt16: return readBinary<uint16_t>(p, swap);
+			case PlyInt32: return readBinary<int32_t>(p, swap);
+			case PlyUInt32: return readBinary<uint32_t>(p, swap);
+			case PlyFloat32: return readBinary<float>(p, swap);
+			case PlyFloat64: return readBinary<double>(p, swap);
+			default: return 0;
+		}
+	}
+
+	void mapVertexProperty(PlyProperty & property){
+		static const struct{
+			const char * name;
+			PlyAttribute attribute;
+			size_t component;
+		} names[] = {
+			{"x", PlyPosition, 0}, {"y", PlyPosition, 1}, {"z", PlyPosition, 2},
+			{"nx", PlyNormal, 0}, {"ny", PlyNormal, 1}, {"nz", PlyNormal, 2},
+			{"red", PlyColor, 0}, {"green", PlyColor, 1}, {"blue", PlyColor, 2}, {"alpha", PlyColor, 3},
+			{"r", PlyColor, 0}, {"g", PlyColor, 1}, {"b", PlyColor, 2}, {"a", PlyColor, 3},
+			{"diffuse_red", PlyColor, 0}, {"diffuse_green", PlyColor, 1}, {"diffuse_blue", PlyColor, 2}, {"diffuse_alpha", PlyColor, 3},
+			{"u", PlyTexCoord, 0}, {"v", PlyTexCoord, 1}, {"s", PlyTexCoord, 0}, {"t", PlyTexCoord, 1},
+			{"texture_u", PlyTexCoord, 0}, {"texture_v", PlyTexCoord, 1}, {"texture_s", PlyTexCoord, 0}, {"texture_t", PlyTexCoord, 1},
+		};
+		if(property.isList) return;
+		for(auto & name: names){
+			if(property.name == name.name){
+				property.attribute = name.attribute;
+				property.component = name.component;
+				if(property.attribute == PlyColor){
+					property.scale = 1. / plyTypeMax(property.type);
+				}
+				return;
+			}
+		}
+	}
+
+	struct PlyHeader{
+		PlyFormat format = PlyAscii;
+		vector<PlyElement> elements;
+		size_t vertexElement = size_t(-1);
+		size_t faceElement = size_t(-1);
+		const char * body = nullptr;
+	};
+
+	bool parsePlyHeader(const char * data, const char * end, PlyHeader & header, string & error){
+		const char * p = data;
+		size_t lineNum = 0;
+		bool formatFound = false;
+		while(p < end){
+			auto lineEnd = findLineEnd(p, end);
+			string line(p, lineEnd);
+			p = lineEnd < end ? lineEnd + 1 : end;
+			lineNum++;
+			if(!line.empty() && line.back() == '\r'){
+				line.pop_back();
+			}
+
+			istringstream tokens(line);
+			string keyword;
+			tokens >> keyword;
+			if(lineNum == 1){
+				if(keyword != "ply"){
+					error = "wrong format, expecting 'ply'";
+					return false;
+				}
+			}else if(keyword == "format"){
+				string format;
+				tokens >> format;
+				if(format == "ascii"){
+					header.format = PlyAscii;
+				}else if(format == "binary_little_endian"){
+					header.format = PlyBinaryLittleEndian;
+				}else if(format == "binary_big_endian"){
+					header.format = PlyBinaryBigEndian;
+				}else{
+					error = "unknown format '" + format + "'";
+					return false;
+				}
+				formatFound = true;
+			}else if(keyword == "element"){
+				PlyElement element;
+				tokens >> element.name >> element.count;
+				if(tokens.fail()){
+					error = "wrong element definition '" + line + "'";
+					return false;
+				}
+				if(element.name == "vertex") header.vertexElement = header.elements.size();
+				if(element.name == "face") header.faceElement = header.elements.size();
+				header.elements.push_back(element);
+			}else if(keyword == "property"){
+				if(header.elements.empty()){
+					error = "property before any element '" + line + "'";
+					return false;
+				}
+				auto & element = header.elements.back();
+				PlyProperty property;
+				string type;
+				tokens >> type;
+				if(type == "list"){
+					string countType;
+					tokens >> countType >> type;
+					property.isList = true;
+					property.countType = plyType(countType);
+					element.hasLists = true;
+				}
+				tokens >> property.name;
+				property.type = plyType(type);
+				if(tokens.fail() || property.type == PlyInvalid || (property.isList && property.countType == PlyInvalid)){
+					error = "wrong property definition '" + line + "'";
+					return false;
+				}
+				property.offset = element.stride;
+				element.stride += plyTypeSize(property.type);
+				if(element.name == "vertex"){
+					mapVertexProperty(property);
+				}else if(element.name == "face" && property.isList && (property.name == "vertex_indices" || property.name == "vertex_index")){
+					property.attribute = PlyFaceIndices;
+				}
+				element.properties.push_back(property);
+			}else if(keyword == "end_header"){
+				if(!formatFound){
+					error = "missing format";
+					return false;
+				}
+				header.body = p;
+				return true;
+			}else if(keyword != "comment" && keyword != "obj_info" && !keyword.empty()){
+				error = "unknown header line '" + line + "'";
+				return false;
+			}
+		}
+		error = "missing end_header";
+		return false;
+	}
+
+	void addFace(vector<ofIndexType> & indices, ofIndexType first, ofIndexType previous, ofIndexType current){
+		indices.push_back(first);
+		indices.push_back(previous);
+		indices.push_back(current);
+	}
+
+	// decodes the lines in [begin, end) of an ascii ply, firstLine being the
+	// number of non blank lines before begin in the body. faces are appended
+	// to indices since each chunk doesn't know how many triangles come before
+	struct PlyAsciiChunk{
+		const char * begin;
+		const char * end;
+		size_t firstLine;
+		size_t numLines;
+		vector<ofIndexType> indices;
+		string error;
+	};
+
+	void parsePlyAsciiChunk(const PlyHeader & header, const vector<size_t> & elementLines, size_t numVertices, PlyAsciiChunk & chunk){
+		size_t line = chunk.firstLine;
+		size_t element = std::upper_bound(elementLines.begin(), elementLines.end(), line) - elementLines.begin() - 1;
+		for(const char * p = chunk.begin; p < chunk.end && element < header.elements.size();){
+			auto lineEnd = findLineEnd(p, chunk.end);
+			auto next = lineEnd < chunk.end ? lineEnd + 1 : chunk.end;
+			if(isBlankLine(p, lineEnd)){
+				p = next;
+				continue;
+			}
+			while(element < header.elements.size() && line >= elementLines[element + 1]){
+				element++;
+			}
+			if(element >= header.elements.size()){
+				break;
+			}
+
+			size_t row = line - elementLines[element];
+			bool isVertex = element == header.vertexElement;
+			bool isFace = element == header.faceElement;
+			if(isVertex || isFace){
+				for(auto & property: header.elements[element].properties){
+					double value;
+					size_t count = 1;
+					if(property.isList){
+						if(!parseNumber(p, lineEnd, value)){
+							chunk.error = header.elements[element].name + " " + ofToString(row) + ": missing list size";
+							return;
+						}
+						count = size_t(value);
+					}
+					ofIndexType first = 0, previous = 0;
+					for(size_t i = 0; i < count; i++){
+						if(!parseNumber(p, lineEnd, value)){
+							chunk.error = header.elements[element].name + " " + ofToString(row) + ": expecting " + property.name;
+							return;
+						}
+						if(property.target){
+							property.target->set(row, property.component, value * property.scale);
+						}else if(property.attribute == PlyFaceIndices){
+							if(value < 0 || value >= numVertices){
+								chunk.error = "face " + ofToString(row) + ": index out of range " + ofToString(value);
+								return;
+							}
+							auto index = ofIndexType(value);
+							if(i == 0){
+								first = index;
+							}else if(i >= 2){
+								addFace(chunk.indices, first, previous, index);
+							}
+							previous = index;
+						}
+					}
+				}
+			}
+			line++;
+			p = next;
+		}
+	}
+
+	bool loadPlyAscii(const PlyHeader & header, const char * end, size_t numVertices, vector<ofIndexType> & indices, bool multithreaded, string & error){
+		// every element row is a line, count the lines in each chunk
+		// first so they can be decoded in parallel knowing which row
+		// every line is
+		vector<PlyAsciiChunk> chunks;
+		const char * begin = header.body;
+		while(begin < end){
+			const char * chunkEnd = multithreaded ? std::min(begin + chunkSize, end) : end;
+			chunkEnd = chunkEnd < end ? findLineEnd(chunkEnd, end) : end;
+			chunkEnd = chunkEnd < end ? chunkEnd + 1 : end;
+			PlyAsciiChunk chunk;
+			chunk.begin = begin;
+			chunk.end = chunkEnd;
+			chunks.push_back(std::move(chunk));
+			begin = chunkEnd;
+		}
+
+		auto countLines = [&](size_t i){
+			auto & chunk = chunks[i];
+			chunk.numLines = 0;
+			for(const char * p = chunk.begin; p < chunk.end;){
+				auto lineEnd = findLineEnd(p, chunk.end);
+				chunk.numLines += !isBlankLine(p, lineEnd);
+				p = lineEnd < chunk.end ? lineEnd + 1 : chunk.end;
+			}
+		};
+		if(multithreaded){
+			ofParallelFor(0, chunks.size(), countLines, 1);
+		}else{
+			for(size_t i = 0; i < chunks.size(); i++) countLines(i);
+		}
+
+		size_t numLines = 0;
+		for(auto & chunk: chunks){
+			chunk.firstLine = numLines;
+			numLines += chunk.numLines;
+		}
+
+		// first line of every element
+		vector<size_t> elementLines(1, 0);
+		for(auto & element: header.elements){
+			elementLines.push_back(elementLines.back() + element.count);
+		}
+		if(numLines < elementLines.back()){
+			error = "found " + ofToString(numLines) + " lines of data, expecting " + ofToString(elementLines.back());
+			return false;
+		}
+
+		auto parseChunk = [&](size_t i){
+			parsePlyAsciiChunk(header, elementLines, numVertices, chunks[i]);
+		};
+		if(multithreaded){
+			ofParallelFor(0, chunks.size(), parseChunk, 1);
+		}else{
+			for(size_t i = 0; i < chunks.size(); i++) parseChunk(i);
+		}
+
+		size_t numIndices = 0;
+		for(auto & chunk: chunks){
+			if(!chunk.error.empty()){
+				error = chunk.error;
+				return false;
+			}
+			numIndices += chunk.indices.size();
+		}
+		indices.reserve(numIndices);
+		for(auto & chunk: chunks){
+			indices.insert(indices.end(), chunk.indices.begin(), chunk.indices.end());
+		}
+		return true;
+	}
+
+	bool loadPlyBinary(const PlyHeader & header, const char * end, size_t numVertices, vector<ofIndexType> & indices, bool multithreaded, string & error){
+		bool swap = (header.format == PlyBinaryLittleEndian) != isLittleEndianHost();
+		const char * p = header.body;
+		for(size_t e = 0; e < header.elements.size(); e++){
+			auto & element = header.elements[e];
+			bool isVertex = e == header.vertexElement;
+			bool isFace = e == header.faceElement;
+
+			if(!element.hasLists){
+				// fixed size rows, decoded in parallel
+				if(element.stride && size_t(end - p) / element.stride < element.count){
+					error = "file too short for " + ofToString(element.count) + " " + element.name + " elements";
+					return false;
+				}
+				if(isVertex){
+					const char * rows = p;
+					auto decode = [&](size_t begin, size_t rowsEnd){
+						for(size_t row = begin; row < rowsEnd; row++){
+							const char * data = rows + row * element.stride;
+							for(auto & property: element.properties){
+								if(property.target){
+									property.target->set(row, property.component, readPly(data + property.offset, property.type, swap) * property.scale);
+								}
+							}
+						}
+					};
+					if(multithreaded && element.count * element.stride > chunkSize){
+						ofParallelForRange(0, element.count, decode, std::max<size_t>(chunkSize / std::max<size_t>(element.stride, 1), 1));
+					}else{
+						decode(0, element.count);
+					}
+				}
+				p += element.count * element.stride;
+				continue;
+			}
+
+			// rows with lists have to be walked one after another
+			for(size_t row = 0; row < element.count; row++){
+				for(auto & property: element.properties){
+					size_t count = 1;
+					if(property.isList){
+						size_t countSize = plyTypeSize(property.countType);
+						if(size_t(end - p) < countSize){
+							error = "file too short for " + ofToString(element.count) + " " + element.name + " elements";
+							return false;
+						}
+						count = size_t(readPly(p, property.countType, swap));
+						p += countSize;
+					}
+					size_t size = plyTypeSize(property.type);
+					if(size_t(end - p) / size < count){
+						error = "file too short for " + ofToString(element.count) + " " + element.name + " elements";
+						return false;
+					}
+					if(isVertex && property.target){
+						property.target->set(row, property.component, readPly(p, property.type, swap) * property.scale);
+					}else if(isFace && property.attribute == PlyFaceIndices){
+						ofIndexType first = 0, previous = 0;
+						for(size_t i = 0; i < count; i++){
+							double value = readPly(p + i * size, property.type, swap);
+							if(value < 0 || value >= numVertices){
+								error = "face " + ofToString(row) + ": index out of range " + ofToString(value);
+								return false;
+							}
+							auto index = ofIndexType(value);
+							if(i == 0){
+								first = index;
+							}else if(i >= 2){
+								addFace(indices, first, previous, index);
+							}
+							previous = index;
+						}
+					}
+					p += count * size;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool loadPly(const char * data, size_t size, const MeshAllocator & allocate, vector<ofIndexType> & indices, bool multithreaded, string & error){
+		const char * end = data + size;
+		PlyHeader header;
+		if(!parsePlyHeader(data, end, header, error)){
+			return false;
+		}
+
+		bool hasNormals = false, hasColors = false, hasTexCoords = false;
+		size_t numVertices = 0;
+		if(header.vertexElement < header.elements.size()){
+			auto & element = header.elements[header.vertexElement];
+			numVertices = element.count;
+			for(auto & property: element.properties){
+				hasNormals |= property.attribute == PlyNormal;
+				hasColors |= property.attribute == PlyColor;
+				hasTexCoords |= property.attribute == PlyTexCoord;
+			}
+		}
+		auto attributes = allocate(numVertices, hasNormals, hasColors, hasTexCoords);
+
+		// point the vertex properties to where they are decoded
+		if(header.vertexElement < header.elements.size()){
+			for(auto & property: header.elements[header.vertexElement].properties){
+				const MeshAttribute * target = nullptr;
+				switch(property.attribute){
+					case PlyPosition: target = &attributes.vertices; break;
+					case PlyNormal: target = &attributes.normals; break;
+					case PlyColor: target = &attributes.colors; break;
+					case PlyTexCoord: target = &attributes.texCoords; break;
+					default: break;
+				}
+				if(target && *target && property.component < target->components){
+					property.target = target;
+				}
+			}
+		}
+
+		indices.clear();
+		if(header.faceElement < header.elements.size()){
+			indices.reserve(header.elements[header.faceElement].count * 3);
+		}
+		multithreaded &= size > chunkSize;
+		if(header.format == PlyAscii){
+			return loadPlyAscii(header, end, numVertices, indices, multithreaded, error);
+		}else{
+			return loadPlyBinary(header, end, numVertices, indices, multithreaded, error);
+		}
+	}
+
+	//--------------------------------------------------------------
+	// obj
+
+	// a corner of a face, indices of its position, texcoord and normal
+	struct ObjCorner{
+		int64_t position;
+		int64_t texCoord;
+		int64_t normal;
+
+		bool operator==(const ObjCorner & other) const{
+			return position == other.position && texCoord == other.texCoord && normal == other.normal;
+		}
+	};
+
+	struct ObjCornerHash{
+		size_t operator()(const ObjCorner & corner) const{
+			uint64_t hash = uint64_t(corner.position) * 0x9E3779B97F4A7C15ull;
+			hash ^= uint64_t(corner.texCoord) * 0xC2B2AE3D27D4EB4Full + (hash << 6) + (hash >> 2);
+			hash ^= uint64_t(corner.normal) * 0x165667B19E3779F9ull + (hash << 6) + (hash >> 2);
+			return size_t(hash);
+		}
+	};
+
+	// relative indices are negative, absent ones -1
+	bool parseObjIndex(const char *& p, const char * end, size_t count, int64_t & index){
+		double value;
+		if(!parseNumber(p, end, value) || value == 0){
+			return false;
+		}
+		index = value < 0 ? int64_t(count) + int64_t(value) : int64_t(value) - 1;
+		return index >= 0 && size_t(index) < count;
+	}
+
+	bool loadObj(const char * data, size_t size, const MeshAllocator & allocate, vector<ofIndexType> & indices, string & error){
+		const char * end = data + size;
+		vector<float> positions, texCoords, normals, colors;
+		vector<float> vertexColor;
+		vector<ObjCorner> corners;
+		bool hasColors = false;
+		size_t lineNum = 0;
+
+		for(const char * p = data; p < end;){
+			auto lineEnd = findLineEnd(p, end);
+			auto next = lineEnd < end ? lineEnd + 1 : end;
+			lineNum++;
+			while(p < lineEnd && isBlank(*p)) p++;
+
+			auto parseFloats = [&](vector<float> & values, size_t min, size_t max){
+				size_t found = 0;
+				double value;
+				for(; found < max && parseNumber(p, lineEnd, value); found++){
+					values.push_back(float(value));
+				}
+				for(size_t i = found; i < min; i++){
+					values.push_back(0);
+				}
+				return found;
+			};
+
+			if(lineEnd - p > 2 && p[0] == 'v' && isBlank(p[1])){
+				p += 2;
+				size_t found = parseFloats(positions, 3, 3);
+				if(found < 3){
+					error = ofToString(lineNum) + ": expecting 3 coordinates";
+					return false;
+				}
+				// optional vertex colors after the position
+				vertexColor.clear();
+				if(parseFloats(vertexColor, 0, 3) == 3){
+					hasColors = true;
+					colors.insert(colors.end(), vertexColor.begin(), vertexColor.end());
+				}else{
+					colors.insert(colors.end(), 3, 1.f);
+				}
+			}else if(lineEnd - p > 3 && p[0] == 'v' && p[1] == 't' && isBlank(p[2])){
+				p += 3;
+				parseFloats(texCoords, 2, 2);
+			}else if(lineEnd - p > 3 && p[0] == 'v' && p[1] == 'n' && isBlank(p[2])){
+				p += 3;
+				if(parseFloats(normals, 3, 3) < 3){
+					error = ofToString(lineNum) + ": expecting 3 normal coordinates";
+					return false;
+				}
+			}else if(lineEnd - p > 2 && p[0] == 'f' && isBlank(p[1])){
+				p += 2;
+				ObjCorner first{-1, -1, -1};
+				ObjCorner previous{-1, -1, -1};
+				size_t numCorners = 0;
+				while(true){
+					while(p < lineEnd && isBlank(*p)) p++;
+					if(p == lineEnd) break;
+					ObjCorner corner{-1, -1, -1};
+					bool valid = parseObjIndex(p, lineEnd, positions.size() / 3, corner.position);
+					if(valid && p < lineEnd && *p == '/'){
+						p++;
+						if(p < lineEnd && *p != '/'){
+							valid = parseObjIndex(p, lineEnd, texCoords.size() / 2, corner.texCoord);
+						}
+						if(valid && p < lineEnd && *p == '/'){
+							p++;
+							valid = parseObjIndex(p, lineEnd, normals.size() / 3, corner.normal);
+						}
+					}
+					if(!valid || (p < lineEnd && !isBlank(*p))){
+						error = ofToString(lineNum) + ": wrong face index";
+						return false;
+					}
+					// triangulate as a fan
+					if(numCorners == 0){
+						first = corner;
+					}else if(numCorners >= 2){
+						corners.push_back(first);
+						corners.push_back(previous);
+						corners.push_back(corner);
+					}
+					previous = corner;
+					numCorners++;
+				}
+				if(numCorners < 3){
+					error = ofToString(lineNum) + ": face with less than 3 vertices";
+					return false;
+				}
+			}
+			p = next;
+		}
+
+		bool hasTexCoords = false, hasNormals = false, sameIndices = true;
+		for(auto & corner: corners){
+			hasTexCoords |= corner.texCoord >= 0;
+			hasNormals |= corner.normal >= 0;
+			sameIndices &= (corner.texCoord < 0 || corner.texCoord == corner.position) && (corner.normal < 0 || corner.normal == corner.position);
+		}
+
+		indices.clear();
+		if(sameIndices){
+			// faces use the same index for the position, texcoord and
+			// normal of every corner, as saved by ofMesh, or only refer to
+			// positions: the mesh vertices are the positions
+			size_t numVertices = positions.size() / 3;
+			auto attributes = allocate(numVertices, hasNormals, hasColors, hasTexCoords);
+			for(size_t i = 0; i < numVertices; i++){
+				for(size_t c = 0; c < 3; c++){
+					attributes.vertices.set(i, c, positions[i * 3 + c]);
+					if(hasColors) attributes.colors.set(i, c, colors[i * 3 + c]);
+					if(hasNormals && i < normals.size() / 3) attributes.normals.set(i, c, normals[i * 3 + c]);
+				}
+				if(hasTexCoords && i < texCoords.size() / 2){
+					for(size_t c = 0; c < std::min<size_t>(2, attributes.texCoords.components); c++){
+						attributes.texCoords.set(i, c, texCoords[i * 2 + c]);
+					}
+				}
+			}
+			indices.reserve(corners.size());
+			for(auto & corner: corners){
+				indices.push_back(ofIndexType(corner.position));
+			}
+			return true;
+		}
+
+		// a vertex for every different combination of position, texcoord and normal
+		unordered_map<ObjCorner, ofIndexType, ObjCornerHash> vertexIndices;
+		vector<ObjCorner> vertices;
+		indices.reserve(corners.size());
+		for(auto & corner: corners){
+			auto inserted = vertexIndices.insert(make_pair(corner, ofIndexType(vertices.size())));
+			if(inserted.second){
+				vertices.push_back(corner);
+			}
+			indices.push_back(inserted.first->second);
+		}
+
+		auto attributes = allocate(vertices.size(), hasNormals, hasColors, hasTexCoords);
+		for(size_t i = 0; i < vertices.size(); i++){
+			auto & vertex = vertices[i];
+			for(size_t c = 0; c < 3; c++){
+				attributes.vertices.set(i, c, positions[vertex.position * 3 + c]);
+				if(hasColors) attributes.colors.set(i, c, colors[vertex.position * 3 + c]);
+				if(hasNormals && vertex.normal >= 0) attributes.normals.set(i, c, normals[vertex.normal * 3 + c]);
+			}
+			if(hasTexCoords && vertex.texCoord >= 0){
+				for(size_t c = 0; c < std::min<size_t>(2, attributes.texCoords.components); c++){
+					attributes.texCoords.set(i, c, texCoords[vertex.texCoord * 2 + c]);
+				}
+			}
+		}
+		return true;
+	}
+
+	//--------------------------------------------------------------
+	// saving
+
+	// encodes [0, count) in chunks, in parallel, and writes them in order
+	// keeping only a few chunks in memory
+	void writeChunks(ostream & out, size_t count, size_t chunkCount, const function<void(size_t, size_t, string &)> & encode){
+		const size_t numBuffers = 16;
+		vector<string> buffers(numBuffers);
+		for(size_t first = 0; first < count; first += chunkCount * numBuffers){
+			size_t numChunks = std::min(numBuffers, (count - first + chunkCount - 1) / chunkCount);
+			ofParallelFor(0, numChunks, [&](size_t i){
+				size_t begin = first + i * chunkCount;
+				buffers[i].clear();
+				encode(begin, std::min(begin + chunkCount, count), buffers[i]);
+			}, 1);
+			for(size_t i = 0; i < numChunks; i++){
+				out.write(buffers[i].data(), buffers[i].size());
+			}
+		}
+	}
+
+	bool savePly(ostream & out, const MeshAttributes & attributes, size_t numVertices, const vector<ofIndexType> & indices, bool triangles, bool binary){
+		bool swap = !isLittleEndianHost();
+		size_t numFaces = !indices.empty() ? indices.size() / 3 : triangles ? numVertices / 3 : 0;
+
+		out << "ply" << endl;
+		out << (binary ? "format binary_little_endian 1.0" : "format ascii 1.0") << endl;
+		if(numVertices){
+			out << "element vertex " << numVertices << endl;
+			out << "property float x" << endl;
+			out << "property float y" << endl;
+			out << "property float z" << endl;
+			if(attributes.colors){
+				// VCG lib / MeshLab don't support float colors
+				out << "property uchar red" << endl;
+				out << "property uchar green" << endl;
+				out << "property uchar blue" << endl;
+				out << "property uchar alpha" << endl;
+			}
+			if(attributes.texCoords){
+				out << "property float u" << endl;
+				out << "property float v" << endl;
+			}
+			if(attributes.normals){
+				out << "property float nx" << endl;
+				out << "property float ny" << endl;
+				out << "property float nz" << endl;
+			}
+		}
+		if(numFaces){
+			out << "element face " << numFaces << endl;
+			out << "property list uchar int vertex_indices" << endl;
+		}
+		out << "end_header" << endl;
+
+		auto writeAttribute = [&](string & buffer, const MeshAttribute & attribute, size_t i, size_t components){
+			for(size_t c = 0; c < components; c++){
+				float value = c < attribute.components ? attribute.get(i, c) : 0;
+				if(binary){
+					appendBinary(buffer, value, swap);
+				}else{
+					if(!buffer.empty() && buffer.back() != '\n') buffer += ' ';
+					appendNumber(buffer, value);
+				}
+			}
+		};
+
+		size_t verticesPerChunk = 1 << 16;
+		writeChunks(out, numVertices, verticesPerChunk, [&](size_t begin, size_t end, string & buffer){
+			for(size_t i = begin; i < end; i++){
+				writeAttribute(buffer, attributes.vertices, i, 3);
+				if(attributes.colors){
+					for(size_t c = 0; c < 4; c++){
+						float value = c < attributes.colors.components ? attributes.colors.get(i, c) : 1;
+						auto channel = uint8_t(std::max(0.f, std::min(1.f, value)) * 255 + 0.5f);
+						if(binary){
+							buffer += char(channel);
+						}else{
+							buffer += ' ';
+							appendNumber(buffer, uint64_t(channel));
+						}
+					}
+				}
+				if(attributes.texCoords){
+					writeAttribute(buffer, attributes.texCoords, i, 2);
+				}
+				if(attributes.normals){
+					writeAttribute(buffer, attributes.normals, i, 3);
+				}
+				if(!binary){
+					buffer += '\n';
+				}
+			}
+		});
+
+		writeChunks(out, numFaces, verticesPerChunk, [&](size_t begin, size_t end, string & buffer){
+			for(size_t face = begin; face < end; face++){
+				if(binary){
+					buffer += char(3);
+				}else{
+					buffer += '3';
+				}
+				for(size_t k = 0; k < 3; k++){
+					uint64_t index = indices.empty() ? face * 3 + k : indices[face * 3 + k];
+					if(binary){
+						appendBinary(buffer, int32_t(index), swap);
+					}else{
+						buffer += ' ';
+						appendNumber(buffer, index);
+					}
+				}
+				if(!binary){
+					buffer += '\n';
+				}
+			}
+		});
+		return bool(out);
+	}
+
+	bool saveObj(ostream & out, const MeshAttributes & attributes, size_t numVertices, const vector<ofIndexType> & indices, bool triangles){
+		size_t numFaces = !indices.empty() ? indices.size() / 3 : triangles ? numVertices / 3 : 0;
+		size_t verticesPerChunk = 1 << 16;
+
+		auto writeLine = [](string & buffer, const char * prefix, const MeshAttribute & attribute, size_t i, size_t components){
+			buffer += prefix;
+			for(size_t c = 0; c < components; c++){
+				buffer += ' ';
+				appendNumber(buffer, c < attribute.components ? attribute.get(i, c) : 0.f);
+			}
+			buffer += '\n';
+		};
+
+		writeChunks(out, numVertices, verticesPerChunk, [&](size_t begin, size_t end, string & buffer){
+			for(size_t i = begin; i < end; i++){
+				buffer += 'v';
+				for(size_t c = 0; c < 3; c++){
+					buffer += ' ';
+					appendNumber(buffer, attributes.vertices.get(i, c));
+				}
+				if(attributes.colors){
+					for(size_t c = 0; c < 3; c++){
+						buffer += ' ';
+						appendNumber(buffer, attributes.colors.get(i, c));
+					}
+				}
+				buffer += '\n';
+				if(attributes.texCoords){
+					writeLine(buffer, "vt", attributes.texCoords, i, 2);
+				}
+				if(attributes.normals){
+					writeLine(buffer, "vn", attributes.normals, i, 3);
+				}
+			}
+		});
+
+		// obj indices start at 1 and have a texcoord and normal index
+		// that here are the same as the position index
+		writeChunks(out, numFaces, verticesPerChunk, [&](size_t begin, size_t end, string & buffer){
+			for(size_t face = begin; face < end; face++){
+				buffer += 'f';
+				for(size_t k = 0; k < 3; k++){
+					uint64_t index = (indices.empty() ? face * 3 + k : indices[face * 3 + k]) + 1;
+					buffer += ' ';
+					appendNumber(buffer, index);
+					if(attributes.texCoords || attributes.normals){
+						buffer += '/';
+						if(attributes.texCoords) appendNumber(buffer, index);
+						if(attributes.normals){
+							buffer += '/';
+							appendNumber(buffer, index);
+						}
+					}
+				}
+				buffer += '\n';
+			}
+		});
+		return bool(out);
+	}
+
+	bool isObj(const std::filesystem::path & path){
+		return ofToLower(ofFilePath::getFileExt(path)) == "obj";
+	}
+}
+
+//--------------------------------------------------------------
+bool of::priv::loadMesh(const std::filesystem::path & path, const MeshAllocator & allocate, vector<ofIndexType> & indices, bool multithreaded, string & error){
+	MappedFile file(ofToDataPath(path));
+	if(!file.isOpen()){
+		error = "couldn't open file";
+		return false;
+	}
+	if(isObj(path)){
+		return loadObj(file.data(), file.size(), allocate, indices, error);
+	}else{
+		return loadPly(file.data(), file.size(), allocate, indices, multithreaded, error);
+	}
+}
+
+//--------------------------------------------------------------
+bool of::priv::saveMesh(const std::filesystem::path & path, const MeshAttributes & attributes, size_t numVertices, const vector<ofIndexType> & indices, bool triangles, bool binary, string & error){
+	ofFile out(path, ofFile::WriteOnly, true);
+	if(!out.is_open()){
+		error = "couldn't open file for writing";
+		return false;
+	}
+	bool saved;
+	if(isObj(path)){
+		saved = saveObj(out, attributes, numVertices, indices, triangles);
+	}else{
+		saved = savePly(out, attributes, numVertices, indices, triangles, binary);
+	}
+	if(!saved){
+		error = "couldn't write file";
+	}
+	return saved;
+}
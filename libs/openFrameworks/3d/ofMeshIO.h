@@ -0,0 +1,107 @@
+#pragma once
+
+#include "ofConstants.h"
+#include <functional>
+#include <algorithm>
+#include <type_traits>
+
+namespace of{
+namespace priv{
+	/// \brief View of one attribute of the vertices of a mesh, like the
+	/// positions or the colors, in the vector that holds it.
+	///
+	/// Used to decode and encode mesh files straight from and to the
+	/// vectors of ofMesh_ whatever vertex, color... types it uses.
+	struct MeshAttribute{
+		enum Type{
+			Float,
+			UInt8,
+			UInt16,
+		};
+
+		char * data = nullptr;      ///< first component of the first vertex
+		std::size_t stride = 0;     ///< bytes between two vertices
+		std::size_t components = 0; ///< 0 if the mesh doesn't have this attribute
+		Type type = Float;          ///< type of each component
+		float limit = 1;            ///< stored value for 1, the max of a color channel
+
+		/// set a component of vertex i, value is multiplied by limit
+		void set(std::size_t i, std::size_t component, double value) const{
+			char * vertex = data + i * stride;
+			switch(type){
+				case Float:
+					reinterpret_cast<float*>(vertex)[component] = float(value * limit);
+					break;
+				case UInt8:
+					reinterpret_cast<uint8_t*>(vertex)[component] = uint8_t(std::max(0., std::min(1., value)) * limit + 0.5);
+					break;
+				case UInt16:
+					reinterpret_cast<uint16_t*>(vertex)[component] = uint16_t(std::max(0., std::min(1., value)) * limit + 0.5);
+					break;
+			}
+		}
+
+		/// \returns a component of vertex i divided by limit
+		float get(std::size_t i, std::size_t component) const{
+			const char * vertex = data + i * stride;
+			switch(type){
+				case Float:
+					return reinterpret_cast<const float*>(vertex)[component] / limit;
+				case UInt8:
+					return reinterpret_cast<const uint8_t*>(vertex)[component] / limit;
+				case UInt16:
+					return reinterpret_cast<const uint16_t*>(vertex)[component] / limit;
+			}
+			return 0;
+		}
+
+		explicit operator bool() const{
+			return components > 0;
+		}
+	};
+
+	/// \returns a view of all the components of the elements of vertices
+	template<class Vertex>
+	MeshAttribute meshAttribute(const std::vector<Vertex> & vertices, float limit = 1){
+		auto & data = const_cast<std::vector<Vertex>&>(vertices);
+		typedef typename std::remove_reference<decltype(data[0][0])>::type Component;
+		MeshAttribute attribute;
+		if(!data.empty()){
+			attribute.data = reinterpret_cast<char*>(&data[0][0]);
+			attribute.stride = sizeof(Vertex);
+			attribute.components = sizeof(Vertex) / sizeof(Component);
+			attribute.type = std::is_floating_point<Component>::value ? MeshAttribute::Float :
+							 sizeof(Component) == 1 ? MeshAttribute::UInt8 : MeshAttribute::UInt16;
+			attribute.limit = limit;
+		}
+		return attribute;
+	}
+
+	struct MeshAttributes{
+		MeshAttribute vertices;
+		MeshAttribute normals;
+		MeshAttribute colors;
+		MeshAttribute texCoords;
+	};
+
+	/// called once the number of vertices in a file and the attributes it
+	/// has are known, allocates them and returns where to decode them
+	typedef std::function<MeshAttributes(std::size_t numVertices, bool normals, bool colors, bool texCoords)> MeshAllocator;
+
+	/// \brief Load a PLY, ascii or binary, or an OBJ file.
+	///
+	/// The file is memory mapped and decoded straight into the attributes
+	/// returned by allocate. Polygons are triangulated as fans.
+	///
+	/// \param multithreaded Decode big files in chunks in parallel.
+	/// \returns false and the reason in error if the file couldn't be loaded.
+	bool loadMesh(const std::filesystem::path & path, const MeshAllocator & allocate, std::vector<ofIndexType> & indices, bool multithreaded, std::string & error);
+
+	/// \brief Save a mesh as PLY or, if the extension is .obj, OBJ.
+	///
+	/// \param triangles Without indices, save every 3 vertices as a face.
+	/// \param binary Save a binary little endian PLY.
+	/// \returns false and the reason in error if the file couldn't be saved.
+	bool saveMesh(const std::filesystem::path & path, const MeshAttributes & attributes, std::size_t numVertices, const std::vector<ofIndexType> & indices, bool triangles, bool binary, std::string & error);
+}
+}
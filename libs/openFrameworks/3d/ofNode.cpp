@@ -1,5 +1,6 @@
 
 #include "ofNode.h"
+#include "ofTransformStore.h"
 #include "ofMath.h"
 #include "ofLog.h"
 #include "of3dGraphics.h"
@@ -19,6 +20,9 @@ ofNode::ofNode()
 
 //----------------------------------------
 ofNode::~ofNode(){
+	if(transformStore){
+		transformStore->remove(*this);
+	}
 	if(parent){
 		parent->removeListener(*this);
 	}
@@ -62,11 +66,27 @@ ofNode::ofNode(ofNode && node)
 	if(parent){
 		parent->addListener(*this);
 	}
+	// same transforms as the moved node so its cache is still valid
+	globalTransformMatrix = node.globalTransformMatrix;
+	bGlobalTransformDirty = node.bGlobalTransformDirty;
+	for(auto child: children){
+		child->parent = this;
+	}
+	if(node.transformStore){
+		auto store = node.transformStore;
+		store->nodes[store->slot(node.transformStoreHandle)] = this;
+		transformStore = store;
+		transformStoreHandle = node.transformStoreHandle;
+		node.transformStore = nullptr;
+	}
 }
 
 //----------------------------------------
 ofNode & ofNode::operator=(const ofNode & node){
 	if(this == &node) return *this;
+	if(parent && parent != node.parent){
+		parent->removeListener(*this);
+	}
 	parent = node.parent;
 	position = node.position;
 	orientation = node.orientation;
@@ -80,12 +100,19 @@ ofNode & ofNode::operator=(const ofNode & node){
 	if(parent){
 		parent->addListener(*this);
 	}
+	if(transformStore){
+		transformStore->setNodeParent(*this);
+	}
+	createMatrix();
 	return *this;
 }
 
 //----------------------------------------
 ofNode & ofNode::operator=(ofNode && node){
 	if(this == &node) return *this;
+	if(parent && parent != node.parent){
+		parent->removeListener(*this);
+	}
 	parent = node.parent;
 	position = std::move(node.position);
 	orientation = std::move(node.orientation);
@@ -93,10 +120,20 @@ ofNode & ofNode::operator=(ofNode && node){
 	axis = std::move(node.axis);
 	localTransformMatrix = std::move(node.localTransformMatrix);
 	legacyCustomDrawOverrided = std::move(node.legacyCustomDrawOverrided);
-	children = std::move(node.children);
+	// children this node already had still point to it as their parent
+	for(auto child: node.children){
+		child->parent = this;
+		child->invalidateGlobalTransform();
+		children.insert(child);
+	}
+	node.children.clear();
 	if(parent){
 		parent->addListener(*this);
 	}
+	if(transformStore){
+		transformStore->setNodeParent(*this);
+	}
+	createMatrix();
 	return *this;
 }
 
@@ -144,6 +181,10 @@ void ofNode::setParent(ofNode& parent, bool bMaintainGlobalTransform) {
 		parent.addListener(*this);
 	}
 	this->parent = &parent;
+	if(transformStore){
+		transformStore->setNodeParent(*this);
+	}
+	invalidateGlobalTransform();
 }
 
 //----------------------------------------
@@ -162,7 +203,10 @@ void ofNode::clearParent(bool bMaintainGlobalTransform) {
 	}else{
 		this->parent = nullptr;
 	}
-
+	if(transformStore){
+		transformStore->setNodeParent(*this);
+	}
+	invalidateGlobalTransform();
 }
 
 //----------------------------------------
@@ -549,9 +593,22 @@ const glm::mat4& ofNode::getLocalTransformMatrix() const {
 }
 
 //----------------------------------------
-glm::mat4 ofNode::getGlobalTransformMatrix() const {
-	if(parent) return parent->getGlobalTransformMatrix() * getLocalTransformMatrix();
-	else return getLocalTransformMatrix();
+const glm::mat4& ofNode::getGlobalTransformMatrix() const {
+	if(bGlobalTransformDirty){
+		if(transformStore){
+			transformStore->update();
+		}
+		// the store doesn't update nodes while it's already updating
+		if(bGlobalTransformDirty){
+			if(parent){
+				globalTransformMatrix = parent->getGlobalTransformMatrix() * getLocalTransformMatrix();
+			}else{
+				globalTransformMatrix = getLocalTransformMatrix();
+			}
+			bGlobalTransformDirty = false;
+		}
+	}
+	return globalTransformMatrix;
 }
 
 //----------------------------------------
@@ -677,6 +734,22 @@ void ofNode::createMatrix() {
 	localTransformMatrix = glm::scale(localTransformMatrix, toGlm(scale));
 
 	updateAxis();
+	if(transformStore){
+		transformStore->setNodeLocalTransform(*this);
+	}
+	invalidateGlobalTransform();
+}
+
+//----------------------------------------
+void ofNode::invalidateGlobalTransform() {
+	if(bGlobalTransformDirty) return;
+	bGlobalTransformDirty = true;
+	if(transformStore){
+		transformStore->setDirty(transformStoreHandle);
+	}
+	for(auto child: children){
+		child->invalidateGlobalTransform();
+	}
 }
 
 
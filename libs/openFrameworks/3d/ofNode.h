@@ -7,6 +7,7 @@
 #include "glm/mat4x4.hpp"
 
 class ofBaseRenderer;
+class ofTransformStore;
 
 
 /// \brief A generic 3d object in space with transformation (position, rotation, scale).
@@ -145,14 +146,13 @@ public:
 	/// \sa https://open.gl/transformations
 	const glm::mat4& getLocalTransformMatrix() const;
 	
-	// TODO: optimize and cache these
-	// (parent would need to know about its children so it can inform them 
-	// to update their global matrices if it itself transforms)
-	
 	/// \brief Get node's global transformations (position, orientation, scale).
+	///
+	/// The result is cached until the node or any of its parents changes,
+	/// or comes from the ofTransformStore the node was added to.
 	/// \returns A refrence to mat4 containing node's global transformations.
 	/// \sa https://open.gl/transformations
-	glm::mat4 getGlobalTransformMatrix() const;
+	const glm::mat4& getGlobalTransformMatrix() const;
 	
 	/// \brief Get node's global position as a 3D vector.
 	/// \returns A 3D vector with the global coordinates.
@@ -467,6 +467,8 @@ protected:
 	ofNode * parent = nullptr;
 
 private:
+	friend class ofTransformStore;
+
 	void onParentPositionChanged(glm::vec3 & position) {onPositionChanged();}
 	void onParentOrientationChanged(glm::quat & orientation) {onOrientationChanged();}
 	void onParentScaleChanged(glm::vec3 & scale) {onScaleChanged();}
@@ -483,5 +485,13 @@ private:
 
 	void addListener(ofNode & node);
 	void removeListener(ofNode & node);
-//	glm::mat4 globalTransformMatrix;
+	void invalidateGlobalTransform();
+
+	// a dirty node always has dirty children so invalidating can stop
+	// at the first node that's already dirty
+	mutable glm::mat4 globalTransformMatrix;
+	mutable bool bGlobalTransformDirty = true;
+
+	ofTransformStore * transformStore = nullptr;
+	uint32_t transformStoreHandle = 0;
 };
@@ -0,0 +1,220 @@
+#include "ofPrimitiveMeshCache.h"
+#include "of3dPrimitives.h"
+#include "ofGraphics.h"
+#include "ofShader.h"
+#include "ofUtils.h"
+
+using namespace std;
+
+namespace{
+	size_t getMeshBytes(const ofMesh & mesh){
+		return mesh.getNumVertices() * sizeof(glm::vec3)
+			+ mesh.getNumNormals() * sizeof(glm::vec3)
+			+ mesh.getNumColors() * sizeof(ofFloatColor)
+			+ mesh.getNumTexCoords() * sizeof(glm::vec2)
+			+ mesh.getNumIndices() * sizeof(ofIndexType);
+	}
+}
+
+//----------------------------------------
+bool ofPrimitiveMeshCache::Key::operator<(const Key & other) const{
+	if(type != other.type) return type < other.type;
+	for(int i = 0; i < 3; i++){
+		if(resolution[i] != other.resolution[i]) return resolution[i] < other.resolution[i];
+	}
+	if(mode != other.mode) return mode < other.mode;
+	if(capped != other.capped) return capped < other.capped;
+	if(size[0] != other.size[0]) return size[0] < other.size[0];
+	return size[1] < other.size[1];
+}
+
+//----------------------------------------
+ofPrimitiveMeshCache & ofPrimitiveMeshCache::get(){
+	static ofPrimitiveMeshCache * cache = new ofPrimitiveMeshCache;
+	return *cache;
+}
+
+//----------------------------------------
+template<typename Generate>
+shared_ptr<ofVboMesh> ofPrimitiveMeshCache::getMesh(const Key & key, Generate generate){
+	std::unique_lock<std::mutex> lock(mutex);
+	auto it = meshes.find(key);
+	if(it != meshes.end()){
+		hits++;
+		return it->second;
+	}
+	misses++;
+	auto then = ofGetElapsedTimeMicros();
+	auto mesh = make_shared<ofVboMesh>(generate());
+	generationTime += ofGetElapsedTimeMicros() - then;
+	meshes[key] = mesh;
+	return mesh;
+}
+
+//----------------------------------------
+shared_ptr<ofVboMesh> ofPrimitiveMeshCache::plane(int columns, int rows, ofPrimitiveMode mode){
+	Key key{Plane, {columns, rows, 0}, mode, false, {1, 1}};
+	return getMesh(key, [&]{ return ofMesh::plane(1, 1, columns, rows, mode); });
+}
+
+//----------------------------------------
+shared_ptr<ofVboMesh> ofPrimitiveMeshCache::sphere(int resolution, ofPrimitiveMode mode){
+	Key key{Sphere, {resolution, 0, 0}, mode, false, {1, 1}};
+	return getMesh(key, [&]{ return ofMesh::sphere(1, resolution, mode); });
+}
+
+//----------------------------------------
+shared_ptr<ofVboMesh> ofPrimitiveMeshCache::icosphere(int iterations){
+	Key key{IcoSphere, {iterations, 0, 0}, OF_PRIMITIVE_TRIANGLES, false, {1, 1}};
+	return getMesh(key, [&]{ return ofMesh::icosphere(1, iterations); });
+}
+
+//----------------------------------------
+shared_ptr<ofVboMesh> ofPrimitiveMeshCache::cylinder(int radiusSegments, int heightSegments, int capSegments, bool capped, ofPrimitiveMode mode){
+	Key key{Cylinder, {radiusSegments, heightSegments, capSegments}, mode, capped, {1, 1}};
+	return getMesh(key, [&]{ return ofMesh::cylinder(1, 1, radiusSegments, heightSegments, capSegments, capped, mode); });
+}
+
+//----------------------------------------
+shared_ptr<ofVboMesh> ofPrimitiveMeshCache::cone(float radius, float height, int radiusSegments, int heightSegments, int capSegments, ofPrimitiveMode mode){
+	Key key{Cone, {radiusSegments, heightSegments, capSegments}, mode, false, {radius, height}};
+	return getMesh(key, [&]{ return ofMesh::cone(radius, height, radiusSegments, heightSegments, capSegments, mode); });
+}
+
+//----------------------------------------
+shared_ptr<ofVboMesh> ofPrimitiveMeshCache::box(int resWidth, int resHeight, int resDepth){
+	Key key{Box, {resWidth, resHeight, resDepth}, OF_PRIMITIVE_TRIANGLES, false, {1, 1}};
+	return getMesh(key, [&]{ return ofMesh::box(1, 1, 1, resWidth, resHeight, resDepth); });
+}
+
+//----------------------------------------
+void ofPrimitiveMeshCache::purge(){
+	std::unique_lock<std::mutex> lock(mutex);
+	for(auto it = meshes.begin(); it != meshes.end();){
+		if(it->second.use_count() == 1){
+			it = meshes.erase(it);
+		}else{
+			++it;
+		}
+	}
+}
+
+//----------------------------------------
+void ofPrimitiveMeshCache::clear(){
+	std::unique_lock<std::mutex> lock(mutex);
+	meshes.clear();
+}
+
+//----------------------------------------
+ofPrimitiveMeshCache::Stats ofPrimitiveMeshCache::getStats() const{
+	std::unique_lock<std::mutex> lock(mutex);
+	Stats stats;
+	stats.numMeshes = meshes.size();
+	stats.hits = hits;
+	stats.misses = misses;
+	stats.generationTime = generationTime;
+	for(auto & mesh: meshes){
+		auto users = size_t(mesh.second.use_count() - 1);
+		auto bytes = getMeshBytes(*mesh.second);
+		stats.numUsers += users;
+		stats.bytes += bytes;
+		if(users > 1){
+			stats.bytesSaved += (users - 1) * bytes;
+		}
+	}
+	return stats;
+}
+
+//----------------------------------------
+void ofPrimitiveMeshCache::resetStats(){
+	std::unique_lock<std::mutex> lock(mutex);
+	hits = 0;
+	misses = 0;
+	generationTime = 0;
+}
+
+//----------------------------------------
+void ofPrimitiveBatch::add(const of3dPrimitive & primitive){
+	auto it = indices.find(primitive.mesh.get());
+	size_t index;
+	if(it == indices.end()){
+		index = numGroups++;
+		if(index == groups.size()){
+			groups.emplace_back();
+		}
+		groups[index].mesh = primitive.mesh;
+		groups[index].usingVbo = primitive.isUsingVbo();
+		indices[primitive.mesh.get()] = index;
+	}else{
+		index = it->second;
+	}
+	groups[index].transforms.push_back(primitive.getMeshTransformMatrix());
+}
+
+//----------------------------------------
+void ofPrimitiveBatch::clear(){
+	for(size_t i = 0; i < numGroups; i++){
+		groups[i].mesh.reset();
+		groups[i].transforms.clear();
+	}
+	numGroups = 0;
+	indices.clear();
+}
+
+//----------------------------------------
+size_t ofPrimitiveBatch::getNumMeshes() const{
+	return numGroups;
+}
+
+//----------------------------------------
+const ofMesh & ofPrimitiveBatch::getMesh(size_t i) const{
+	return *groups[i].mesh;
+}
+
+//----------------------------------------
+const vector<glm::mat4> & ofPrimitiveBatch::getTransforms(size_t i) const{
+	return groups[i].transforms;
+}
+
+//----------------------------------------
+void ofPrimitiveBatch::draw(ofPolyRenderMode renderType) const{
+	auto renderer = ofGetCurrentRenderer();
+	for(size_t i = 0; i < numGroups; i++){
+		auto & group = groups[i];
+		for(auto & transform: group.transforms){
+			renderer->pushMatrix();
+			renderer->multMatrix(transform);
+			if(group.usingVbo){
+				static_cast<const ofVboMesh&>(*group.mesh).draw(renderType);
+			}else{
+				group.mesh->draw(renderType);
+			}
+			renderer->popMatrix();
+		}
+	}
+}
+
+#ifndef TARGET_OPENGLES
+//----------------------------------------
+void ofPrimitiveBatch::drawInstanced(const ofShader & shader, ofPolyRenderMode renderType){
+	for(size_t i = 0; i < numGroups; i++){
+		auto & group = groups[i];
+		if(!group.usingVbo){
+			ofLogWarning("ofPrimitiveBatch") << "drawInstanced(): skipping primitives that don't use a vbo";
+			continue;
+		}
+		GLsizeiptr bytes = group.transforms.size() * sizeof(glm::mat4);
+		if(!group.transformsBuffer.isAllocated()){
+			group.transformsBuffer.allocate();
+		}
+		if(group.transformsBuffer.size() < bytes){
+			group.transformsBuffer.setData(bytes, group.transforms.data(), GL_STREAM_DRAW);
+			group.transformsTexture.allocateAsBufferTexture(group.transformsBuffer, GL_RGBA32F);
+		}else{
+			group.transformsBuffer.updateData(0, bytes, group.transforms.data());
+		}
+		shader.setUniformTexture("transforms", group.transformsTexture, 0);
+		static_cast<const ofVboMesh&>(*group.mesh).drawInstanced(renderType, group.transforms.size());
+	}
+}
+#endif
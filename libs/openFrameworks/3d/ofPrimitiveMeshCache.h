@@ -0,0 +1,180 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "ofVboMesh.h"
+#include "ofTexture.h"
+#include <map>
+#include <mutex>
+
+class of3dPrimitive;
+class ofShader;
+
+/// \brief Meshes of the 3d primitives shared between every primitive with
+/// the same type and resolution.
+///
+/// The meshes are generated once at unit size, primitives using them are
+/// scaled to their size when drawn, so a thousand spheres of different
+/// radius but the same resolution hold a single mesh, uploaded once to the
+/// graphics card. Primitives use it after calling
+/// of3dPrimitive::setUseSharedMesh(true) or when
+/// of3dPrimitive::setUseSharedMeshesByDefault(true) was called before
+/// creating them.
+///
+/// Meshes stay in the cache after the last primitive using them is
+/// destroyed, purge() releases them.
+class ofPrimitiveMeshCache{
+public:
+	struct Stats{
+		/// \brief Meshes in the cache.
+		size_t numMeshes = 0;
+		/// \brief Primitives and other users holding a cached mesh.
+		size_t numUsers = 0;
+		/// \brief Requests served with a mesh already in the cache.
+		size_t hits = 0;
+		/// \brief Requests that generated a new mesh.
+		size_t misses = 0;
+		/// \brief Memory used by the cached meshes in bytes.
+		size_t bytes = 0;
+		/// \brief Memory every user would need to hold its own copy.
+		size_t bytesSaved = 0;
+		/// \brief Time spent generating meshes in microseconds.
+		uint64_t generationTime = 0;
+	};
+
+	/// \brief The cache used by the primitives.
+	static ofPrimitiveMeshCache & get();
+
+	/// \brief Plane of size 1x1.
+	std::shared_ptr<ofVboMesh> plane(int columns, int rows, ofPrimitiveMode mode = OF_PRIMITIVE_TRIANGLE_STRIP);
+
+	/// \brief Sphere of radius 1.
+	std::shared_ptr<ofVboMesh> sphere(int resolution, ofPrimitiveMode mode = OF_PRIMITIVE_TRIANGLE_STRIP);
+
+	/// \brief Icosphere of radius 1.
+	std::shared_ptr<ofVboMesh> icosphere(int iterations);
+
+	/// \brief Cylinder of radius 1 and height 1.
+	std::shared_ptr<ofVboMesh> cylinder(int radiusSegments, int heightSegments, int capSegments, bool capped, ofPrimitiveMode mode = OF_PRIMITIVE_TRIANGLE_STRIP);
+
+	/// \brief Cone with the passed radius and height.
+	///
+	/// The normals of the cone don't scale with it so cones are
+	/// only shared when they have the same size too.
+	std::shared_ptr<ofVboMesh> cone(float radius, float height, int radiusSegments, int heightSegments, int capSegments, ofPrimitiveMode mode = OF_PRIMITIVE_TRIANGLE_STRIP);
+
+	/// \brief Box of size 1x1x1.
+	std::shared_ptr<ofVboMesh> box(int resWidth, int resHeight, int resDepth);
+
+	/// \brief Release the meshes that no primitive is using anymore.
+	void purge();
+
+	/// \brief Release every mesh, primitives using them keep their copy.
+	void clear();
+
+	Stats getStats() const;
+	void resetStats();
+
+private:
+	enum Type{
+		Plane,
+		Sphere,
+		IcoSphere,
+		Cylinder,
+		Cone,
+		Box,
+	};
+
+	struct Key{
+		Type type;
+		int resolution[3];
+		int mode;
+		bool capped;
+		float size[2];
+		bool operator<(const Key & other) const;
+	};
+
+	template<typename Generate>
+	std::shared_ptr<ofVboMesh> getMesh(const Key & key, Generate generate);
+
+	std::map<Key, std::shared_ptr<ofVboMesh>> meshes;
+	mutable std::mutex mutex;
+	size_t hits = 0;
+	size_t misses = 0;
+	uint64_t generationTime = 0;
+};
+
+/// \brief Primitives grouped by the mesh they share, with the transform
+/// of each of them.
+///
+/// draw() isn't instanced, it draws every primitive with its own draw
+/// call and only saves binding a different vbo for each of them.
+/// drawInstanced() draws each mesh once with ofVboMesh::drawInstanced
+/// and a shader that reads the transforms from a buffer texture, as in
+/// examples/gl/textureBufferInstancedExample.
+///
+/// ~~~~{.cpp}
+/// ofPrimitiveBatch batch;
+/// for(auto & sphere: spheres){
+///     batch.add(sphere);
+/// }
+/// batch.draw();
+/// ~~~~
+class ofPrimitiveBatch{
+public:
+	/// \brief Add a primitive with its current global transform and size.
+	void add(const of3dPrimitive & primitive);
+
+	/// \brief Remove every primitive, keeps the memory for the next frame.
+	void clear();
+
+	/// \brief Number of different meshes.
+	size_t getNumMeshes() const;
+
+	const ofMesh & getMesh(size_t i) const;
+
+	/// \brief Transforms of the primitives drawn with mesh i, their
+	/// global transform scaled to their size.
+	const std::vector<glm::mat4> & getTransforms(size_t i) const;
+
+	/// \brief Draw every primitive, one draw call each.
+	void draw(ofPolyRenderMode renderType = OF_MESH_FILL) const;
+
+#ifndef TARGET_OPENGLES
+	/// \brief Draw each mesh once, instanced, with the transforms of its
+	/// primitives in a buffer texture.
+	///
+	/// shader has to be bound. The transforms are passed to it as a
+	/// samplerBuffer uniform named transforms, in texture location 0,
+	/// with 4 texels per instance, one per column of the matrix:
+	///
+	/// ~~~~{.glsl}
+	/// uniform samplerBuffer transforms;
+	/// ...
+	/// int x = gl_InstanceID * 4;
+	/// mat4 transform = mat4(texelFetch(transforms, x),
+	///                       texelFetch(transforms, x + 1),
+	///                       texelFetch(transforms, x + 2),
+	///                       texelFetch(transforms, x + 3));
+	/// gl_Position = modelViewProjectionMatrix * transform * position;
+	/// ~~~~
+	///
+	/// The buffers are kept from one frame to the next and only
+	/// reallocated when a mesh has more primitives than before. Primitives
+	/// that don't use a vbo are skipped.
+	void drawInstanced(const ofShader & shader, ofPolyRenderMode renderType = OF_MESH_FILL);
+#endif
+
+private:
+	struct Group{
+		std::shared_ptr<const ofMesh> mesh;
+		bool usingVbo;
+		std::vector<glm::mat4> transforms;
+#ifndef TARGET_OPENGLES
+		ofBufferObject transformsBuffer;
+		ofTexture transformsTexture;
+#endif
+	};
+	std::vector<Group> groups;
+	size_t numGroups = 0;
+	std::map<const ofMesh*, size_t> indices;
+};
@@ -0,0 +1,337 @@
+#include "ofTransformStore.h"
+#include "ofNode.h"
+#include "glm/gtc/type_ptr.hpp"
+#include <algorithm>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define OF_TRANSFORM_STORE_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define OF_TRANSFORM_STORE_NEON
+#endif
+
+using namespace std;
+
+const ofTransformStore::Handle ofTransformStore::none = numeric_limits<uint32_t>::max();
+
+namespace{
+	// result = a * b, all column major. result can't be a or b
+	inline void multiply(const glm::mat4 & a, const glm::mat4 & b, glm::mat4 & result){
+		const float * A = glm::value_ptr(a);
+		const float * B = glm::value_ptr(b);
+		float * R = glm::value_ptr(result);
+#if defined(OF_TRANSFORM_STORE_SSE)
+		__m128 a0 = _mm_loadu_ps(A);
+		__m128 a1 = _mm_loadu_ps(A + 4);
+		__m128 a2 = _mm_loadu_ps(A + 8);
+		__m128 a3 = _mm_loadu_ps(A + 12);
+		for(int column = 0; column < 4; column++){
+			const float * b = B + column * 4;
+			__m128 r = _mm_mul_ps(a0, _mm_set1_ps(b[0]));
+			r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(b[1])));
+			r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(b[2])));
+			r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(b[3])));
+			_mm_storeu_ps(R + column * 4, r);
+		}
+#elif defined(OF_TRANSFORM_STORE_NEON)
+		float32x4_t a0 = vld1q_f32(A);
+		float32x4_t a1 = vld1q_f32(A + 4);
+		float32x4_t a2 = vld1q_f32(A + 8);
+		float32x4_t a3 = vld1q_f32(A + 12);
+		for(int column = 0; column < 4; column++){
+			const float * b = B + column * 4;
+			float32x4_t r = vmulq_n_f32(a0, b[0]);
+			r = vmlaq_n_f32(r, a1, b[1]);
+			r = vmlaq_n_f32(r, a2, b[2]);
+			r = vmlaq_n_f32(r, a3, b[3]);
+			vst1q_f32(R + column * 4, r);
+		}
+#else
+		result = a * b;
+#endif
+	}
+}
+
+//----------------------------------------
+ofTransformStore::~ofTransformStore(){
+	clear();
+}
+
+//----------------------------------------
+ofTransformStore::Handle ofTransformStore::add(const glm::mat4 & localTransform, Handle parent){
+	Handle handle;
+	if(freeHandles.empty()){
+		handle = Handle(slots.size());
+		slots.push_back(none);
+	}else{
+		handle = freeHandles.back();
+		freeHandles.pop_back();
+	}
+	auto slot = uint32_t(handles.size());
+	slots[handle] = slot;
+	handles.push_back(handle);
+	parents.push_back(none);
+	localTransforms.push_back(localTransform);
+	worldTransforms.push_back(localTransform);
+	dirty.push_back(1);
+	nodes.push_back(nullptr);
+	bDirty = true;
+	setParent(handle, parent);
+	return handle;
+}
+
+//----------------------------------------
+ofTransformStore::Handle ofTransformStore::add(ofNode & node){
+	if(node.transformStore == this){
+		return node.transformStoreHandle;
+	}
+	if(node.transformStore){
+		node.transformStore->remove(node);
+	}
+	auto handle = add(node.getLocalTransformMatrix());
+	nodes[slot(handle)] = &node;
+	node.transformStore = this;
+	node.transformStoreHandle = handle;
+	setNodeParent(node);
+	for(auto child: node.children){
+		if(child->transformStore == this){
+			setNodeParent(*child);
+		}
+	}
+	return handle;
+}
+
+//----------------------------------------
+void ofTransformStore::remove(Handle handle){
+	if(!contains(handle)) return;
+	auto s = slot(handle);
+	if(nodes[s]){
+		// children in the store now have a parent outside of it
+		auto node = nodes[s];
+		node->transformStore = nullptr;
+		for(auto child: node->children){
+			if(child->transformStore == this){
+				parents[slot(child->transformStoreHandle)] = none;
+				setDirty(child->transformStoreHandle);
+			}
+		}
+	}
+	// the slot stays as a hole until the next sort, which also turns
+	// whatever had it as parent into roots
+	handles[s] = none;
+	nodes[s] = nullptr;
+	parents[s] = none;
+	slots[handle] = none;
+	freeHandles.push_back(handle);
+	numRemoved++;
+	bNeedsSort = true;
+}
+
+//----------------------------------------
+void ofTransformStore::remove(ofNode & node){
+	if(node.transformStore == this){
+		remove(node.transformStoreHandle);
+	}
+}
+
+//----------------------------------------
+void ofTransformStore::clear(){
+	for(auto node: nodes){
+		if(node){
+			node->transformStore = nullptr;
+		}
+	}
+	parents.clear();
+	localTransforms.clear();
+	worldTransforms.clear();
+	dirty.clear();
+	nodes.clear();
+	handles.clear();
+	slots.clear();
+	freeHandles.clear();
+	numRemoved = 0;
+	bNeedsSort = false;
+	bDirty = false;
+}
+
+//----------------------------------------
+ofTransformStore::Handle ofTransformStore::getHandle(const ofNode & node) const{
+	return node.transformStore == this ? node.transformStoreHandle : none;
+}
+
+//----------------------------------------
+bool ofTransformStore::contains(Handle handle) const{
+	return handle < slots.size() && slots[handle] != none;
+}
+
+//----------------------------------------
+size_t ofTransformStore::size() const{
+	return handles.size() - numRemoved;
+}
+
+//----------------------------------------
+void ofTransformStore::setParent(Handle handle, Handle parent){
+	if(!contains(handle)) return;
+	auto s = slot(handle);
+	auto parentSlot = contains(parent) && parent != handle ? slot(parent) : none;
+	parents[s] = parentSlot;
+	if(parentSlot != none && parentSlot > s){
+		bNeedsSort = true;
+	}
+	setDirty(handle);
+}
+
+//----------------------------------------
+ofTransformStore::Handle ofTransformStore::getParent(Handle handle) const{
+	if(!contains(handle)) return none;
+	auto parentSlot = parents[slot(handle)];
+	return parentSlot == none ? none : handles[parentSlot];
+}
+
+//----------------------------------------
+void ofTransformStore::setLocalTransform(Handle handle, const glm::mat4 & localTransform){
+	if(!contains(handle)) return;
+	localTransforms[slot(handle)] = localTransform;
+	setDirty(handle);
+}
+
+//----------------------------------------
+const glm::mat4 & ofTransformStore::getLocalTransform(Handle handle) const{
+	return localTransforms[slot(handle)];
+}
+
+//----------------------------------------
+const glm::mat4 & ofTransformStore::getWorldTransform(Handle handle){
+	update();
+	return worldTransforms[slot(handle)];
+}
+
+//----------------------------------------
+void ofTransformStore::update(){
+	if(bNeedsSort){
+		sort();
+	}
+	if(!bDirty || bUpdating) return;
+	// a parent outside of the store could be in another store with
+	// nodes parented to this one, the nodes compute themselves then
+	bUpdating = true;
+	auto numSlots = handles.size();
+	for(size_t i = 0; i < numSlots; i++){
+		auto parent = parents[i];
+		if(parent != none){
+			dirty[i] |= dirty[parent];
+		}
+		if(!dirty[i]) continue;
+		auto node = nodes[i];
+		if(parent != none){
+			multiply(worldTransforms[parent], localTransforms[i], worldTransforms[i]);
+		}else if(node && node->parent){
+			multiply(node->parent->getGlobalTransformMatrix(), localTransforms[i], worldTransforms[i]);
+		}else{
+			worldTransforms[i] = localTransforms[i];
+		}
+		if(node){
+			node->globalTransformMatrix = worldTransforms[i];
+			node->bGlobalTransformDirty = false;
+		}
+	}
+	std::fill(dirty.begin(), dirty.end(), 0);
+	bDirty = false;
+	bUpdating = false;
+}
+
+//----------------------------------------
+void ofTransformStore::sort(){
+	auto numSlots = handles.size();
+
+	// depth of every slot, parents always have a smaller depth than their
+	// children so ordering by depth puts them first
+	vector<uint32_t> depths(numSlots, none);
+	vector<uint32_t> chain;
+	uint32_t maxDepth = 0;
+	for(size_t i = 0; i < numSlots; i++){
+		if(handles[i] == none) continue;
+		auto s = uint32_t(i);
+		chain.clear();
+		while(s != none && depths[s] == none && handles[s] != none){
+			chain.push_back(s);
+			s = parents[s];
+			if(chain.size() > numSlots) break; // a cycle, cut it
+		}
+		uint32_t depth = (s != none && handles[s] != none && depths[s] != none) ? depths[s] + 1 : 0;
+		for(auto it = chain.rbegin(); it != chain.rend(); ++it){
+			depths[*it] = depth++;
+		}
+		maxDepth = std::max(maxDepth, depth);
+	}
+
+	// counting sort, stable so siblings keep their order
+	vector<uint32_t> firstOfDepth(maxDepth + 1, 0);
+	for(size_t i = 0; i < numSlots; i++){
+		if(handles[i] != none) firstOfDepth[depths[i]]++;
+	}
+	uint32_t total = 0;
+	for(auto & first: firstOfDepth){
+		auto count = first;
+		first = total;
+		total += count;
+	}
+	vector<uint32_t> newSlots(numSlots, none);
+	for(size_t i = 0; i < numSlots; i++){
+		if(handles[i] != none) newSlots[i] = firstOfDepth[depths[i]]++;
+	}
+
+	vector<uint32_t> sortedParents(total);
+	vector<glm::mat4> sortedLocalTransforms(total);
+	vector<glm::mat4> sortedWorldTransforms(total);
+	vector<uint8_t> sortedDirty(total);
+	vector<ofNode*> sortedNodes(total);
+	vector<Handle> sortedHandles(total);
+	for(size_t i = 0; i < numSlots; i++){
+		auto s = newSlots[i];
+		if(s == none) continue;
+		auto parent = parents[i];
+		bool validParent = parent != none && handles[parent] != none && depths[parent] < depths[i];
+		sortedParents[s] = validParent ? newSlots[parent] : none;
+		sortedLocalTransforms[s] = localTransforms[i];
+		sortedWorldTransforms[s] = worldTransforms[i];
+		// a transform that lost its parent needs updating
+		sortedDirty[s] = dirty[i] || (parent != none && !validParent);
+		sortedNodes[s] = nodes[i];
+		sortedHandles[s] = handles[i];
+		slots[handles[i]] = s;
+		bDirty |= sortedDirty[s] != 0;
+	}
+	parents = std::move(sortedParents);
+	localTransforms = std::move(sortedLocalTransforms);
+	worldTransforms = std::move(sortedWorldTransforms);
+	dirty = std::move(sortedDirty);
+	nodes = std::move(sortedNodes);
+	handles = std::move(sortedHandles);
+	numRemoved = 0;
+	bNeedsSort = false;
+}
+
+//----------------------------------------
+void ofTransformStore::setDirty(Handle handle){
+	dirty[slot(handle)] = 1;
+	bDirty = true;
+}
+
+//----------------------------------------
+void ofTransformStore::setNodeParent(ofNode & node){
+	auto parent = node.parent ? getHandle(*node.parent) : none;
+	setParent(node.transformStoreHandle, parent);
+}
+
+//----------------------------------------
+void ofTransformStore::setNodeLocalTransform(const ofNode & node){
+	setLocalTransform(node.transformStoreHandle, node.getLocalTransformMatrix());
+}
+
+//----------------------------------------
+uint32_t ofTransformStore::slot(Handle handle) const{
+	return slots[handle];
+}
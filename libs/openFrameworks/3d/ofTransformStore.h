@@ -0,0 +1,127 @@
+#pragma once
+
+#include "ofConstants.h"
+#include "glm/mat4x4.hpp"
+
+class ofNode;
+
+/// \brief Flat storage for the transforms of a hierarchy.
+///
+/// Parents, local and world matrices are kept in contiguous arrays sorted
+/// so every parent comes before its children. update() computes all the
+/// world matrices that changed in one pass over those arrays instead of
+/// walking up the parent chain of every node.
+///
+/// ofNodes can be added to a store, they keep working as usual but their
+/// global transform comes from the store: the first getGlobalTransformMatrix()
+/// after a change updates the whole store. Transforms that don't need a full
+/// ofNode, like particles attached to a rig, can be added directly and are
+/// accessed through the handle returned by add().
+///
+/// ~~~~{.cpp}
+/// ofTransformStore store;
+/// for(auto & bone: bones){
+///     store.add(bone);   // parents before or after their children
+/// }
+/// auto particle = store.add(glm::translate(glm::mat4(1), {0, 10, 0}), store.getHandle(bones[3]));
+/// ...
+/// store.update();
+/// auto world = store.getWorldTransform(particle);
+/// ~~~~
+class ofTransformStore{
+public:
+	typedef uint32_t Handle;
+
+	/// \brief Handle of no transform, used as the parent of roots.
+	static const Handle none;
+
+	ofTransformStore() = default;
+	ofTransformStore(const ofTransformStore &) = delete;
+	ofTransformStore & operator=(const ofTransformStore &) = delete;
+
+	/// \brief Removes every node from the store, they compute their
+	/// global transforms on their own again.
+	~ofTransformStore();
+
+	/// \brief Add a transform.
+	/// \param localTransform Transform relative to its parent.
+	/// \param parent Handle of the parent or ofTransformStore::none.
+	/// \returns A handle that stays valid until the transform is removed.
+	Handle add(const glm::mat4 & localTransform, Handle parent = none);
+
+	/// \brief Add a node, removing it from any other store it was in.
+	///
+	/// Its parent and children are linked to it if they are in this store
+	/// too. A parent outside of the store is read with its own
+	/// getGlobalTransformMatrix() when the node needs updating.
+	/// \returns The handle of the node in this store.
+	Handle add(ofNode & node);
+
+	/// \brief Remove a transform, transforms that had it as parent become roots.
+	void remove(Handle handle);
+
+	/// \brief Remove a node, it computes its global transform on its own again.
+	void remove(ofNode & node);
+
+	/// \brief Remove every transform and node.
+	void clear();
+
+	/// \returns The handle of node in this store or ofTransformStore::none.
+	Handle getHandle(const ofNode & node) const;
+
+	/// \returns true if handle is a transform in this store.
+	bool contains(Handle handle) const;
+
+	/// \brief Number of transforms in the store.
+	size_t size() const;
+
+	/// \brief Change the parent of a transform added with a matrix.
+	///
+	/// Nodes take their parent from ofNode::setParent.
+	void setParent(Handle handle, Handle parent);
+
+	/// \returns The parent of handle in this store or ofTransformStore::none.
+	Handle getParent(Handle handle) const;
+
+	/// \brief Change the local transform of a transform added with a matrix.
+	///
+	/// Nodes take their local transform from their position,
+	/// orientation and scale.
+	void setLocalTransform(Handle handle, const glm::mat4 & localTransform);
+
+	const glm::mat4 & getLocalTransform(Handle handle) const;
+
+	/// \returns The world transform of handle, updating the store first if
+	/// anything changed.
+	const glm::mat4 & getWorldTransform(Handle handle);
+
+	/// \brief Compute the world transforms of everything that changed
+	/// since the last update and of their descendants.
+	void update();
+
+private:
+	friend class ofNode;
+
+	void sort();
+	void setDirty(Handle handle);
+	void setNodeParent(ofNode & node);
+	void setNodeLocalTransform(const ofNode & node);
+	uint32_t slot(Handle handle) const;
+
+	// per slot, in an order where parents come before their children
+	std::vector<uint32_t> parents;
+	std::vector<glm::mat4> localTransforms;
+	std::vector<glm::mat4> worldTransforms;
+	std::vector<uint8_t> dirty;
+	std::vector<ofNode*> nodes;
+	std::vector<Handle> handles;
+
+	// per handle, the slot it's stored in, slots move when sorting
+	std::vector<uint32_t> slots;
+	std::vector<Handle> freeHandles;
+
+	size_t numRemoved = 0;
+	bool bNeedsSort = false;
+	bool bDirty = false;
+	bool bUpdating = false;
+};
@@ -4,6 +4,7 @@
 #include "ofAppRunner.h"
 #include "ofUtils.h"
 #include "ofFileUtils.h"
+#include "ofFrameProfiler.h"
 #include "ofGLProgrammableRenderer.h"
 #include "ofGLRenderer.h"
 #include "ofVectorMath.h"
@@ -910,7 +911,9 @@ void ofAppEGLWindow::draw() {
 	}
 	currentRenderer->finishRender();
 
+	ofGetFrameProfiler().beginPhase(OF_FRAME_PHASE_SWAP);
 	EGLBoolean success = eglSwapBuffers(eglDisplay, eglSurface);
+	ofGetFrameProfiler().endPhase(OF_FRAME_PHASE_SWAP);
 	if(!success) {
 		GLint error = eglGetError();
 		ofLogNotice("ofAppEGLWindow") << "display(): eglSwapBuffers failed: " << eglErrorString(error);
@@ -5,6 +5,7 @@
 #include "ofGLRenderer.h"
 #include "ofGLProgrammableRenderer.h"
 #include "ofAppRunner.h"
+#include "ofFrameProfiler.h"
 #include "ofFileUtils.h"
 #include "ofEvents.h"
 #include "ofPixels.h"
@@ -455,6 +456,7 @@ void ofAppGLFWWindow::draw(){
 
 	events().notifyDraw();
 
+	ofGetFrameProfiler().beginPhase(OF_FRAME_PHASE_SWAP);
     #ifdef TARGET_WIN32
 	if (currentRenderer->getBackgroundAuto() == false){
 		// on a PC resizing a window with this method of accumulation (essentially single buffering)
@@ -490,6 +492,7 @@ void ofAppGLFWWindow::draw(){
     #endif
 
 	currentRenderer->finishRender();
+	ofGetFrameProfiler().endPhase(OF_FRAME_PHASE_SWAP);
 
 	nFramesSinceWindowResized++;
 }
@@ -10,6 +10,7 @@
 #include "ofConstants.h"
 #include "ofAppBaseWindow.h"
 #include "ofBaseApp.h"
+#include "ofFrameProfiler.h"
 
 //========================================================================
 // default windowing
@@ -162,7 +163,10 @@ void ofMainLoop::loopOnce(){
 
 void ofMainLoop::pollEvents(){
 	if(windowPollEvents){
+		auto & profiler = ofGetFrameProfiler();
+		profiler.beginPhase(OF_FRAME_PHASE_EVENTS);
 		windowPollEvents();
+		profiler.endPhase(OF_FRAME_PHASE_EVENTS);
 	}
 }
 
@@ -10,6 +10,7 @@
 #include <stddef.h>
 #include <functional>
 #include <deque>
+#include <algorithm>
 
 
 /*! \cond PRIVATE */
@@ -72,9 +73,228 @@ namespace priv{
 		return std::make_unique<StdFunctionId>();
 	}
 
+	// -------------------------------------
+	// Hazard pointer reclamation of the listener snapshots of every event.
+	// A notification publishes the snapshot it traverses, and each
+	// listener it calls, in slots that belong to its thread, so notifying
+	// doesn't write to memory shared with other threads. Replaced
+	// snapshots are deleted, by any later retire, once no slot points to
+	// them, so there's never more retired snapshots than notifications in
+	// progress.
+	class SnapshotHazards{
+		struct Slot{
+			std::atomic<const void*> pointer{nullptr};
+			std::atomic<Slot*> next{nullptr};
+		};
+
+		// a slot per nesting level
+		struct Slots{
+			std::atomic<Slot*> first{nullptr};
+			std::size_t depth = 0;
+		};
+
+		// one per thread
+		struct Record{
+			Slots snapshots;
+			Slots calls;
+			std::atomic<bool> used{true};
+		};
+
+	public:
+		static SnapshotHazards & get(){
+			// never destroyed so events destroyed during static
+			// destruction can still retire their snapshots
+			static SnapshotHazards * hazards = new SnapshotHazards;
+			return *hazards;
+		}
+
+		// Keeps the snapshot returned by protect() from being deleted
+		// until it's destroyed.
+		class Hazard{
+		public:
+			Hazard()
+			:slots(threadRecord().snapshots)
+			,slot(slotAt(slots, slots.depth++)){}
+
+			~Hazard(){
+				slot.pointer.store(nullptr);
+				slots.depth--;
+			}
+
+			template<typename Snapshot>
+			Snapshot * protect(const std::atomic<Snapshot*> & snapshot){
+				auto pointer = snapshot.load();
+				while(true){
+					slot.pointer.store(pointer);
+					auto current = snapshot.load();
+					if(current == pointer){
+						return pointer;
+					}
+					pointer = current;
+				}
+			}
+
+		private:
+			Slots & slots;
+			Slot & slot;
+		};
+
+		// Marks a listener as being called by the current thread until
+		// it's destroyed.
+		class Call{
+		public:
+			Call(const void * listener)
+			:slots(threadRecord().calls)
+			,slot(slotAt(slots, slots.depth++)){
+				slot.pointer.store(listener);
+			}
+
+			~Call(){
+				slot.pointer.store(nullptr);
+				slots.depth--;
+			}
+
+		private:
+			Slots & slots;
+			Slot & slot;
+		};
+
+		// Waits until no other thread is calling the listener. Calls from
+		// the current thread are ignored so a listener can disable itself.
+		void waitForCalls(const void * listener){
+			auto & own = threadRecord();
+			while(true){
+				bool called = false;
+				{
+					std::unique_lock<std::mutex> lck(mtx);
+					for(auto & record: records){
+						if(record.get() == &own){
+							continue;
+						}
+						for(auto slot = record->calls.first.load(); slot && !called; slot = slot->next.load()){
+							called = slot->pointer.load() == listener;
+						}
+					}
+				}
+				if(!called){
+					return;
+				}
+				std::this_thread::yield();
+			}
+		}
+
+		template<typename Snapshot>
+		void retire(std::unique_ptr<Snapshot> && snapshot){
+			std::vector<std::shared_ptr<void>> reclaimed;
+			{
+				std::unique_lock<std::mutex> lck(mtx);
+				retired.emplace_back(std::move(snapshot));
+				std::vector<const void*> hazards;
+				for(auto & record: records){
+					for(auto slot = record->snapshots.first.load(); slot; slot = slot->next.load()){
+						if(auto pointer = slot->pointer.load()){
+							hazards.push_back(pointer);
+						}
+					}
+				}
+				auto it = std::partition(retired.begin(), retired.end(), [&](const std::shared_ptr<void> & snapshot){
+					return std::find(hazards.begin(), hazards.end(), snapshot.get()) != hazards.end();
+				});
+				std::move(it, retired.end(), std::back_inserter(reclaimed));
+				retired.erase(it, retired.end());
+			}
+			// deleted outside of the lock, releasing the last reference to
+			// a listener can destroy other events
+		}
+
+		std::size_t getNumRetired(){
+			std::unique_lock<std::mutex> lck(mtx);
+			return retired.size();
+		}
+
+	private:
+		static Record & threadRecord(){
+			struct Owner{
+				Record * record = get().acquire();
+				~Owner(){
+					record->used = false;
+				}
+			};
+			static thread_local Owner owner;
+			return *owner.record;
+		}
+
+		// records of finished threads are reused, so there's never more
+		// than the maximum number of threads that notified at once
+		Record * acquire(){
+			std::unique_lock<std::mutex> lck(mtx);
+			for(auto & record: records){
+				if(!record->used.exchange(true)){
+					return record.get();
+				}
+			}
+			records.emplace_back(new Record);
+			return records.back().get();
+		}
+
+		// only called from the thread that owns the record, slots are
+		// added but never removed so other threads can read them
+		static Slot & slotAt(Slots & slots, std::size_t depth){
+			auto next = &slots.first;
+			while(true){
+				auto slot = next->load();
+				if(!slot){
+					slot = new Slot;
+					next->store(slot);
+				}
+				if(depth-- == 0){
+					return *slot;
+				}
+				next = &slot->next;
+			}
+		}
+
+		std::mutex mtx;
+		std::vector<std::unique_ptr<Record>> records;
+		std::vector<std::shared_ptr<void>> retired;
+	};
+
+
+	// -------------------------------------
+	// Lets a listener be disabled without locking on every notification.
+	// disable() waits for the calls running in other threads to finish,
+	// calls from the current thread, like a listener removing itself,
+	// don't block.
+	class ListenerCalls{
+	public:
+		class Call{
+		public:
+			Call(ListenerCalls & calls)
+			:calls(calls)
+			,call(&calls){}
+
+			bool isEnabled() const{
+				return calls.enabled.load();
+			}
+
+		private:
+			ListenerCalls & calls;
+			SnapshotHazards::Call call;
+		};
+
+		void disable(){
+			enabled = false;
+			SnapshotHazards::get().waitForCalls(this);
+		}
+
+	private:
+		std::atomic<bool> enabled{true};
+	};
+
+
 	// -------------------------------------
 	template<typename T, class Mutex>
-	class Function{
+	class Function: public ListenerCalls{
 	public:
 		Function(int priority, std::function<bool(const void*,T&)> function,  std::unique_ptr<BaseFunctionId>&& id )
 		:priority(priority)
@@ -86,7 +306,10 @@ namespace priv{
 		}
 
 		inline bool notify(const void*s,T&t){
-			std::unique_lock<Mutex> lck(mtx);
+			Call call(*this);
+			if(!call.isEnabled()){
+				return false;
+			}
 			try{
 				return function(s,t);
 			}catch(std::bad_function_call &){
@@ -94,22 +317,16 @@ namespace priv{
 			}
 		}
 
-		inline void disable(){
-			std::unique_lock<Mutex> lck(mtx);
-			function = nullptr;
-		}
-
 		int priority;
 		std::unique_ptr<BaseFunctionId> id;
 
 	private:
 		std::function<bool(const void*,T&)> function;
-		Mutex mtx;
 	};
 
 	// -------------------------------------
 	template<class Mutex>
-	class Function<void,Mutex>{
+	class Function<void,Mutex>: public ListenerCalls{
 	public:
 		Function(int priority, std::function<bool(const void*)> function,  std::unique_ptr<BaseFunctionId> && id )
 		:priority(priority)
@@ -121,7 +338,10 @@ namespace priv{
 		}
 
 		inline bool notify(const void*s){
-			std::unique_lock<Mutex> lck(mtx);
+			Call call(*this);
+			if(!call.isEnabled()){
+				return false;
+			}
 			try{
 				return function(s);
 			}catch(std::bad_function_call &){
@@ -129,20 +349,19 @@ namespace priv{
 			}
 		}
 
-		inline void disable(){
-			std::unique_lock<Mutex> lck(mtx);
-			function = nullptr;
-		}
-
 		int priority;
 		std::unique_ptr<BaseFunctionId> id;
 	private:
 		std::function<bool(const void*)> function;
-		Mutex mtx;
 	};
 
 
 	// -------------------------------------
+	// The listeners of an event are kept in an immutable snapshot, sorted
+	// by priority, that is replaced as a whole every time a listener is
+	// added or removed. Notifying only needs to protect the current
+	// snapshot and traverse it, without locking the event or copying the
+	// list. Replaced snapshots are retired to SnapshotHazards.
 	template<typename Function, typename Mutex=std::recursive_mutex>
 	class BaseEvent{
 	public:
@@ -150,7 +369,7 @@ namespace priv{
 
 		BaseEvent(const BaseEvent & mom){
 			std::unique_lock<Mutex> lck(const_cast<BaseEvent&>(mom).self->mtx);
-			self->functions = mom.self->functions;
+			self->publish(mom.self->copyFunctions());
 		}
 
 		BaseEvent & operator=(const BaseEvent & mom){
@@ -159,14 +378,15 @@ namespace priv{
 			}
 			std::unique_lock<Mutex> lck(const_cast<BaseEvent&>(mom).self->mtx);
 			std::unique_lock<Mutex> lck2(self->mtx);
-			self->functions = mom.self->functions;
+			self->publish(mom.self->copyFunctions());
 			self->enabled = mom.self->enabled;
 			return *this;
 		}
 
 		BaseEvent(BaseEvent && mom){
 			std::unique_lock<Mutex> lck(const_cast<BaseEvent&>(mom).self->mtx);
-			self->functions = std::move(mom.self->functions);
+			self->publish(mom.self->copyFunctions());
+			mom.self->publish(std::make_unique<Functions>());
 			self->enabled = std::move(mom.self->enabled);
 		}
 
@@ -176,7 +396,7 @@ namespace priv{
 			}
 			std::unique_lock<Mutex> lck(const_cast<BaseEvent&>(mom).self->mtx);
 			std::unique_lock<Mutex> lck2(self->mtx);
-			self->functions = mom.self->functions;
+			self->publish(mom.self->copyFunctions());
 			self->enabled = mom.self->enabled;
 			return *this;
 		}
@@ -194,31 +414,85 @@ namespace priv{
 		}
 
 		std::size_t size() const {
-			return self->functions.size();
+			Listeners listeners(self);
+			return listeners.end() - listeners.begin();
 		}
 
 	protected:
+		typedef std::vector<std::shared_ptr<Function>> Functions;
 
 		struct Data{
 			Mutex mtx;
-			std::vector<std::shared_ptr<Function>> functions;
+			std::atomic<Functions*> functions{nullptr};
 			bool enabled = true;
 
+			~Data(){
+				// retired instead of deleted, a listener can destroy the
+				// event while it's being notified
+				std::unique_ptr<Functions> current(functions.load());
+				if(current){
+					SnapshotHazards::get().retire(std::move(current));
+				}
+			}
+
+			// needs mtx to be locked
+			std::unique_ptr<Functions> copyFunctions() const{
+				auto current = functions.load();
+				return current ? std::make_unique<Functions>(*current) : std::make_unique<Functions>();
+			}
+
+			// needs mtx to be locked
+			void publish(std::unique_ptr<Functions> && newFunctions){
+				std::unique_ptr<Functions> old(functions.exchange(newFunctions.release()));
+				if(old){
+					SnapshotHazards::get().retire(std::move(old));
+				}
+			}
+
 			void remove(const BaseFunctionId & id){
-				std::unique_lock<Mutex> lck(mtx);
-				auto it = functions.begin();
-				for(; it!=functions.end(); ++it){
-					auto f = *it;
-					if(*f->id == id){
-						f->disable();
-						functions.erase(it);
-						break;
+				std::shared_ptr<Function> removed;
+				{
+					std::unique_lock<Mutex> lck(mtx);
+					auto newFunctions = copyFunctions();
+					auto it = std::find_if(newFunctions->begin(), newFunctions->end(), [&](const std::shared_ptr<Function> & f){
+						return *f->id == id;
+					});
+					if(it == newFunctions->end()){
+						return;
 					}
+					removed = *it;
+					newFunctions->erase(it);
+					publish(std::move(newFunctions));
 				}
+				// outside of the lock so listeners running in other threads
+				// can still add or remove listeners while we wait for them
+				removed->disable();
 			}
 		};
 		std::shared_ptr<Data> self{new Data};
 
+		// Read access to the current listeners for the duration of a
+		// notification. The snapshot stays valid until it's destroyed,
+		// even if a listener destroys the event.
+		class Listeners{
+		public:
+			Listeners(const std::shared_ptr<Data> & data)
+			:functions(hazard.protect(data->functions)){}
+
+			const std::shared_ptr<Function> * begin() const{
+				return functions ? functions->data() : nullptr;
+			}
+
+			const std::shared_ptr<Function> * end() const{
+				return functions ? functions->data() + functions->size() : nullptr;
+			}
+
+		private:
+			// declared first, it's used to initialize functions
+			SnapshotHazards::Hazard hazard;
+			const Functions * functions;
+		};
+
 		class EventToken: public AbstractEventToken{
 			public:
 				EventToken() {};
@@ -248,21 +522,18 @@ namespace priv{
 		template<typename TFunction>
 		void addNoToken(TFunction && f){
 			std::unique_lock<Mutex> lck(self->mtx);
-			auto it = self->functions.begin();
-			for(; it!=self->functions.end(); ++it){
+			auto newFunctions = self->copyFunctions();
+			auto it = newFunctions->begin();
+			for(; it!=newFunctions->end(); ++it){
 				if((*it)->priority>f->priority) break;
 			}
-			self->functions.emplace(it, f);
+			newFunctions->emplace(it, f);
+			self->publish(std::move(newFunctions));
 		}
 
 		template<typename TFunction>
 		std::unique_ptr<EventToken> addFunction(TFunction && f){
-			std::unique_lock<Mutex> lck(self->mtx);
-			auto it = self->functions.begin();
-			for(; it!=self->functions.end(); ++it){
-				if((*it)->priority>f->priority) break;
-			}
-			self->functions.emplace(it, f);
+			addNoToken(f);
 			return make_token(*f);
 		}
 	};
@@ -523,6 +794,7 @@ protected:
 
 	using of::priv::BaseEvent<of::priv::Function<T,Mutex>,Mutex>::addFunction;
 	using of::priv::BaseEvent<of::priv::Function<T,Mutex>,Mutex>::addNoToken;
+	typedef typename of::priv::BaseEvent<of::priv::Function<T,Mutex>,Mutex>::Listeners Listeners;
 
 public:
 	template<class TObj, typename TMethod>
@@ -556,31 +828,19 @@ public:
 	}
 
 	inline bool notify(const void* sender, T & param){
-		if(ofEvent<T,Mutex>::self->enabled && !ofEvent<T,Mutex>::self->functions.empty()){
-			std::unique_lock<Mutex> lck(ofEvent<T,Mutex>::self->mtx);
-			auto functions_copy = ofEvent<T,Mutex>::self->functions;
-			lck.unlock();
-			for(auto & f: functions_copy){
-                if(f->notify(sender,param)){
+		if(ofEvent<T,Mutex>::self->enabled){
+			Listeners listeners(ofEvent<T,Mutex>::self);
+			for(auto & f: listeners){
+				if(f->notify(sender,param)){
 					return true;
-                }
+				}
 			}
 		}
 		return false;
 	}
 
 	inline bool notify(T & param){
-		if(ofEvent<T,Mutex>::self->enabled && !ofEvent<T,Mutex>::self->functions.empty()){
-			std::unique_lock<Mutex> lck(ofEvent<T,Mutex>::self->mtx);
-			auto functions_copy = ofEvent<T,Mutex>::self->functions;
-			lck.unlock();
-			for(auto & f: functions_copy){
-				if(f->notify(nullptr,param)){
-					return true;
-				}
-			}
-		}
-		return false;
+		return notify(nullptr,param);
 	}
 };
 
@@ -681,6 +941,7 @@ protected:
 
 	using of::priv::BaseEvent<of::priv::Function<void,Mutex>,Mutex>::addFunction;
 	using of::priv::BaseEvent<of::priv::Function<void,Mutex>,Mutex>::addNoToken;
+	typedef typename of::priv::BaseEvent<of::priv::Function<void,Mutex>,Mutex>::Listeners Listeners;
 
 public:
 	template<class TObj, typename TMethod>
@@ -714,11 +975,9 @@ public:
 	}
 
 	bool notify(const void* sender){
-		if(ofEvent<void,Mutex>::self->enabled && !ofEvent<void,Mutex>::self->functions.empty()){
-			std::unique_lock<Mutex> lck(ofEvent<void,Mutex>::self->mtx);
-			auto functions_copy = ofEvent<void,Mutex>::self->functions;
-			lck.unlock();
-			for(auto & f: functions_copy){
+		if(ofEvent<void,Mutex>::self->enabled){
+			Listeners listeners(ofEvent<void,Mutex>::self);
+			for(auto & f: listeners){
 				if(f->notify(sender)){
 					return true;
 				}
@@ -728,35 +987,16 @@ public:
 	}
 
 	bool notify(){
-		if(ofEvent<void,Mutex>::self->enabled && !ofEvent<void,Mutex>::self->functions.empty()){
-			std::unique_lock<Mutex> lck(ofEvent<void,Mutex>::self->mtx);
-			auto functions_copy = ofEvent<void,Mutex>::self->functions;
-			lck.unlock();
-			for(auto & f: functions_copy){
-				if(f->notify(nullptr)){
-					return true;
-				}
-			}
-		}
-		return false;
+		return notify(nullptr);
 	}
 };
 
 // -------------------------------------
-/// Non thread safe event that avoids locks and copies of the listeners
-/// making it faster than a plain ofEvent
+/// Non thread safe event that doesn't lock the event when adding and
+/// removing listeners. Adding or removing still retires the replaced
+/// list of listeners, which takes a lock shared by every event, and
+/// notifying is as fast as for a plain ofEvent
 template<typename T>
 class ofFastEvent: public ofEvent<T,of::priv::NoopMutex>{
-public:
-	inline bool notify(const void* sender, T & param){
-		if(this->isEnabled()){
-			for(auto & f: ofFastEvent<T>::self->functions){
-				if(f->notify(sender, param)){
-					return true;
-				}
-			}
-		}
-		return false;
-	}
 };
 
@@ -2,6 +2,8 @@
 #include "ofAppRunner.h"
 #include "ofAppBaseWindow.h"
 #include "ofLog.h"
+#include "ofFrameProfiler.h"
+#include "ofTaskPool.h"
 
 using namespace std;
 
@@ -283,15 +285,26 @@ bool ofCoreEvents::notifySetup(){
 #include "ofGraphics.h"
 //------------------------------------------
 bool ofCoreEvents::notifyUpdate(){
-	return ofNotifyEvent( update, voidEventArgs );
+	auto & profiler = ofGetFrameProfiler();
+	profiler.newFrame();
+	profiler.beginPhase(OF_FRAME_PHASE_UPDATE);
+	of::priv::runMainThreadQueue();
+	auto attended = ofNotifyEvent( update, voidEventArgs );
+	profiler.endPhase(OF_FRAME_PHASE_UPDATE);
+	return attended;
 }
 
 //------------------------------------------
 bool ofCoreEvents::notifyDraw(){
+	auto & profiler = ofGetFrameProfiler();
+	profiler.beginPhase(OF_FRAME_PHASE_DRAW);
 	auto attended = ofNotifyEvent( draw, voidEventArgs );
+	profiler.endPhase(OF_FRAME_PHASE_DRAW);
 
 	if (bFrameRateSet){
+		profiler.beginPhase(OF_FRAME_PHASE_WAIT);
 		timer.waitNext();
+		profiler.endPhase(OF_FRAME_PHASE_WAIT);
 	}
 	
 	if(fps.getNumFrames()==0){
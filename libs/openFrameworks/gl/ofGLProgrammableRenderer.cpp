@@ -277,7 +277,7 @@ void ofGLProgrammableRenderer::drawInstanced(const ofVboMesh & mesh, ofPolyRende
 //----------------------------------------------------------
 void ofGLProgrammableRenderer::draw( const of3dPrimitive& model, ofPolyRenderMode renderType) const {
 	const_cast<ofGLProgrammableRenderer*>(this)->pushMatrix();
-	const_cast<ofGLProgrammableRenderer*>(this)->multMatrix(model.getGlobalTransformMatrix());
+	const_cast<ofGLProgrammableRenderer*>(this)->multMatrix(model.getMeshTransformMatrix());
 	if(model.isUsingVbo()){
 		draw(static_cast<const ofVboMesh&>(model.getMesh()),renderType);
 	}else{
@@ -247,7 +247,7 @@ void ofGLRenderer::drawInstanced(const ofVboMesh & mesh, ofPolyRenderMode render
 //----------------------------------------------------------
 void ofGLRenderer::draw( const of3dPrimitive& model, ofPolyRenderMode renderType)  const{
 	const_cast<ofGLRenderer*>(this)->pushMatrix();
-	const_cast<ofGLRenderer*>(this)->multMatrix(model.getGlobalTransformMatrix());
+	const_cast<ofGLRenderer*>(this)->multMatrix(model.getMeshTransformMatrix());
 	if(model.isUsingVbo()){
 		draw(static_cast<const ofVboMesh&>(model.getMesh()),renderType);
 	}else{
@@ -401,7 +401,7 @@ void ofCairoRenderer::draw(const ofMesh & primitive, ofPolyRenderMode mode, bool
 void ofCairoRenderer::draw( const of3dPrimitive& model, ofPolyRenderMode renderType  )  const{
 
 	const_cast<ofCairoRenderer*>(this)->pushMatrix();
-	const_cast<ofCairoRenderer*>(this)->multMatrix(model.getGlobalTransformMatrix());
+	const_cast<ofCairoRenderer*>(this)->multMatrix(model.getMeshTransformMatrix());
 
     const ofMesh& mesh = model.getMesh();
     draw( mesh, renderType );
@@ -5,11 +5,14 @@
 #include "ofGraphics.h"
 #ifdef TARGET_QT
 # include <qimage.h>
+# include <qimagereader.h>
 #else
 # include "FreeImage.h"
 #endif
 #include "ofGLUtils.h"
 #include "ofURLFileLoader.h"
+#include "ofTaskPool.h"
+#include <atomic>
 
 #if defined(TARGET_ANDROID)
 #include "ofxAndroidUtils.h"
@@ -86,7 +89,16 @@ static bool loadImage(ofPixels_<PixelType> & pix, const std::filesystem::path& _
 	if(scheme == "http" || scheme == "https"){
 		return ofLoadImage(pix, ofLoadURL(_fileName.string()).data);
 	}
-    QImage result(_fileName.string().c_str());
+    QImageReader reader(_fileName.string().c_str());
+	if(settings.jpegTargetSize > 0 && reader.format() == "jpeg"){
+		// the jpeg plugin uses libjpeg's DCT scaling for scaled reads
+		QSize size = reader.size();
+		float scale = float(settings.jpegTargetSize) / std::max(size.width(), size.height());
+		if(scale < 1){
+			reader.setScaledSize(size * scale);
+		}
+	}
+    QImage result = reader.read();
     if (result.isNull()) {
 		ofLogError("ofImage") << "QImage: failed to load image";
         return false;
@@ -151,9 +163,30 @@ FREE_IMAGE_TYPE getFreeImageType(const ofFloatPixels& pix) {
 	}
 }
 
+//----------------------------------------------------
+// copies the rows of src into dst in reverse order, since ofPixels are top left
+// and FIBITMAP is bottom left, swapping R and B if needed in the same pass
+static void copyFlippedRows(const unsigned char * src, size_t srcStride, unsigned char * dst, size_t dstStride, size_t rowBytes, size_t height, size_t channels, bool swapRB){
+	src += srcStride * (height - 1);
+	for(size_t y = 0; y < height; y++, src -= srcStride, dst += dstStride){
+		if(swapRB){
+			for(size_t x = 0; x < rowBytes; x += channels){
+				dst[x] = src[x + 2];
+				dst[x + 1] = src[x + 1];
+				dst[x + 2] = src[x];
+				if(channels == 4){
+					dst[x + 3] = src[x + 3];
+				}
+			}
+		}else{
+			memcpy(dst, src, rowBytes);
+		}
+	}
+}
+
 //----------------------------------------------------
 template<typename PixelType>
-FIBITMAP* getBmpFromPixels(const ofPixels_<PixelType> &pix){
+FIBITMAP* getBmpFromPixels(const ofPixels_<PixelType> &pix, bool swapRB = false){
 	const PixelType* pixels = pix.getData();
 	unsigned int width = pix.getWidth();
 	unsigned int height = pix.getHeight();
@@ -163,26 +196,13 @@ FIBITMAP* getBmpFromPixels(const ofPixels_<PixelType> &pix){
 	FIBITMAP* bmp = FreeImage_AllocateT(freeImageType, width, height, bpp);
 	unsigned char* bmpBits = FreeImage_GetBits(bmp);
 	if(bmpBits != nullptr) {
-		int srcStride = width * pix.getBytesPerPixel();
-		int dstStride = FreeImage_GetPitch(bmp);
-		unsigned char* src = (unsigned char*) pixels;
-		unsigned char* dst = bmpBits;
-		if(srcStride != dstStride){
-			for(int i = 0; i < (int)height; i++) {
-				memcpy(dst, src, srcStride);
-				src += srcStride;
-				dst += dstStride;
-			}
-		}else{
-			memcpy(dst,src,dstStride*height);
-		}
+		size_t srcStride = width * pix.getBytesPerPixel();
+		size_t dstStride = FreeImage_GetPitch(bmp);
+		copyFlippedRows((const unsigned char*) pixels, srcStride, bmpBits, dstStride, srcStride, height, pix.getNumChannels(), swapRB && pix.getNumChannels() >= 3);
 	} else {
 		ofLogError("ofImage") << "getBmpFromPixels(): unable to get FIBITMAP from ofPixels";
 	}
 
-	// ofPixels are top left, FIBITMAP is bottom left
-	FreeImage_FlipVertical(bmp);
-
 	return bmp;
 }
 
@@ -230,22 +250,19 @@ void putBmpIntoPixels(FIBITMAP * bmp, ofPixels_<PixelType>& pix, bool swapOnLitt
 #endif
 
 
+	// R and B are swapped while copying so the result is always RGB
 	ofPixelFormat pixFormat;
     if(channels==1) pixFormat=OF_PIXELS_GRAY;
-    if(swapRG){
-		if(channels==3) pixFormat=OF_PIXELS_BGR;
-		if(channels==4) pixFormat=OF_PIXELS_BGRA;
-	}else{
-		if(channels==3) pixFormat=OF_PIXELS_RGB;
-		if(channels==4) pixFormat=OF_PIXELS_RGBA;
-    }
-
-	// ofPixels are top left, FIBITMAP is bottom left
-	FreeImage_FlipVertical(bmp);
+	if(channels==3) pixFormat=OF_PIXELS_RGB;
+	if(channels==4) pixFormat=OF_PIXELS_RGBA;
 
+	// decode straight into the destination, if it's already allocated with
+	// the same size and format its memory is reused
 	unsigned char* bmpBits = FreeImage_GetBits(bmp);
 	if(bmpBits != nullptr) {
-		pix.setFromAlignedPixels((PixelType*) bmpBits, width, height, pixFormat, pitch);
+		pix.allocate(width, height, pixFormat);
+		size_t rowBytes = pix.getBytesStride();
+		copyFlippedRows(bmpBits, pitch, (unsigned char*) pix.getData(), rowBytes, rowBytes, height, channels, swapRG && channels >= 3);
 	} else {
 		ofLogError("ofImage") << "putBmpIntoPixels(): unable to set ofPixels from FIBITMAP";
 	}
@@ -253,10 +270,6 @@ void putBmpIntoPixels(FIBITMAP * bmp, ofPixels_<PixelType>& pix, bool swapOnLitt
 	if(bmpConverted != nullptr) {
 		FreeImage_Unload(bmpConverted);
 	}
-
-    if(swapRG && channels >=3 ) {
-		pix.swapRgb();
-    }
 }
 
 /// internal
@@ -266,6 +279,9 @@ static int getJpegOptionFromImageLoadSetting(const ofImageLoadSettings &settings
 	if(settings.exifRotate)   option |= JPEG_EXIFROTATE;
 	if(settings.grayscale)    option |= JPEG_GREYSCALE;
 	if(settings.separateCMYK) option |= JPEG_CMYK;
+	// FreeImage uses the upper 16 bits as the requested size for libjpeg's
+	// DCT scaling
+	if(settings.jpegTargetSize > 0) option |= int(std::min(settings.jpegTargetSize, 0xFFFFu) << 16);
 	return option;
 }
 
@@ -418,6 +434,53 @@ bool ofLoadImage(ofFloatPixels & pix, const ofBuffer & buffer, const ofImageLoad
 	return loadImage(pix, buffer, settings);
 }
 
+//----------------------------------------------------------------
+template<typename PixelType>
+static std::vector<ofImageLoadStats> loadImages(const std::vector<std::filesystem::path> & paths, std::vector<ofPixels_<PixelType>> & pixels, size_t numThreads, const ofImageLoadSettings & settings){
+#ifndef TARGET_QT
+	// initialize FreeImage before any thread can try to do it
+	ofInitFreeImage();
+#endif
+	pixels.resize(paths.size());
+	std::vector<ofImageLoadStats> stats(paths.size());
+	std::atomic<size_t> next{0};
+	auto worker = [&]{
+		for(size_t i = next++; i < paths.size(); i = next++){
+			auto then = ofGetElapsedTimeMicros();
+			stats[i].path = paths[i];
+			stats[i].loaded = loadImage(pixels[i], paths[i], settings);
+			stats[i].micros = ofGetElapsedTimeMicros() - then;
+		}
+	};
+
+	// the files are shared between at most numThreads workers of the
+	// task pool, the calling thread included
+	auto & pool = ofGetTaskPool();
+	if(numThreads == 0){
+		numThreads = pool.getNumThreads() + 1;
+	}
+	numThreads = std::max<size_t>(1, std::min(numThreads, paths.size()));
+	pool.parallelFor(0, numThreads, [&](size_t){
+		worker();
+	}, 1);
+	return stats;
+}
+
+//----------------------------------------------------------------
+std::vector<ofImageLoadStats> ofLoadImages(const std::vector<std::filesystem::path> & paths, std::vector<ofPixels> & pixels, size_t numThreads, const ofImageLoadSettings & settings){
+	return loadImages(paths, pixels, numThreads, settings);
+}
+
+//----------------------------------------------------------------
+std::vector<ofImageLoadStats> ofLoadImages(const std::vector<std::filesystem::path> & paths, std::vector<ofShortPixels> & pixels, size_t numThreads, const ofImageLoadSettings & settings){
+	return loadImages(paths, pixels, numThreads, settings);
+}
+
+//----------------------------------------------------------------
+std::vector<ofImageLoadStats> ofLoadImages(const std::vector<std::filesystem::path> & paths, std::vector<ofFloatPixels> & pixels, size_t numThreads, const ofImageLoadSettings & settings){
+	return loadImages(paths, pixels, numThreads, settings);
+}
+
 //----------------------------------------------------------------
 bool ofLoadImage(ofTexture & tex, const std::filesystem::path& path, const ofImageLoadSettings &settings){
 	ofPixels pixels;
@@ -491,21 +554,12 @@ static bool saveImage(const ofPixels_<PixelType> & _pix, const std::filesystem::
 		return saveImage(pix3,_fileName,qualityLevel);
 	}
 
-	FIBITMAP * bmp = nullptr;
 	#ifdef TARGET_LITTLE_ENDIAN
-	if(sizeof(PixelType) == 1 && (_pix.getPixelFormat()==OF_PIXELS_RGB || _pix.getPixelFormat()==OF_PIXELS_RGBA)) {	// Make a local copy.
-		ofPixels_<PixelType> pix = _pix;
-		pix.swapRgb();
-		bmp	= getBmpFromPixels(pix);
-	}else{
-	#endif
-
-		bmp	= getBmpFromPixels(_pix);
-
-
-	#ifdef TARGET_LITTLE_ENDIAN
-	}
+	bool swapRB = sizeof(PixelType) == 1 && (_pix.getPixelFormat()==OF_PIXELS_RGB || _pix.getPixelFormat()==OF_PIXELS_RGBA);
+	#else
+	bool swapRB = false;
 	#endif
+	FIBITMAP * bmp = getBmpFromPixels(_pix, swapRB);
 
 	bool retValue = false;
 	if((fif != FIF_UNKNOWN) && FreeImage_FIFSupportsReading(fif)) {
@@ -601,21 +655,12 @@ static bool saveImage(const ofPixels_<PixelType> & _pix, ofBuffer & buffer, ofIm
 	}
 
 
-	FIBITMAP * bmp = nullptr;
 	#ifdef TARGET_LITTLE_ENDIAN
-	if(sizeof(PixelType) == 1 && (_pix.getPixelFormat()==OF_PIXELS_RGB || _pix.getPixelFormat()==OF_PIXELS_RGBA)) {	// Make a local copy.
-		ofPixels_<PixelType> pix = _pix;
-		pix.swapRgb();
-		bmp	= getBmpFromPixels(pix);
-	}else{
-	#endif
-
-		bmp	= getBmpFromPixels(_pix);
-
-
-	#ifdef TARGET_LITTLE_ENDIAN
-	}
+	bool swapRB = sizeof(PixelType) == 1 && (_pix.getPixelFormat()==OF_PIXELS_RGB || _pix.getPixelFormat()==OF_PIXELS_RGBA);
+	#else
+	bool swapRB = false;
 	#endif
+	FIBITMAP * bmp = getBmpFromPixels(_pix, swapRB);
 
 	if (bmp)  // bitmap successfully created
 	{
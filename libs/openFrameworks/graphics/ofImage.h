@@ -125,6 +125,19 @@ struct ofImageLoadSettings {
 	bool exifRotate = false;
 	bool grayscale = false;
 	bool separateCMYK = false;
+	/// \brief Decode JPEGs at a reduced resolution, using libjpeg's DCT
+	/// scaling, with their biggest side as close as possible to this size
+	/// without being smaller. 0 decodes at the original resolution.
+	unsigned int jpegTargetSize = 0;
+};
+
+/// \brief Result of loading one of the files passed to ofLoadImages.
+struct ofImageLoadStats {
+	std::filesystem::path path;
+	/// \brief True if the file was loaded correctly.
+	bool loaded = false;
+	/// \brief Time spent reading and decoding the file.
+	uint64_t micros = 0;
 };
 
 //----------------------------------------------------
@@ -139,6 +152,26 @@ bool ofLoadImage(ofFloatPixels & pix, const ofBuffer & buffer, const ofImageLoad
 bool ofLoadImage(ofShortPixels & pix, const std::filesystem::path& path, const ofImageLoadSettings &settings = ofImageLoadSettings());
 bool ofLoadImage(ofShortPixels & pix, const ofBuffer & buffer, const ofImageLoadSettings &settings = ofImageLoadSettings());
 
+/// \brief Load several images in parallel.
+///
+/// Decodes every file in `paths` into the corresponding position of `pixels`
+/// on the shared ofTaskPool. `pixels` is resized to the number of paths and
+/// pixels already allocated with the right size and format are reused.
+///
+/// ~~~~{.cpp}
+/// std::vector<ofPixels> thumbnails;
+/// ofImageLoadSettings settings;
+/// settings.jpegTargetSize = 256;
+/// auto stats = ofLoadImages(paths, thumbnails, 0, settings);
+/// ~~~~
+///
+/// \param numThreads Maximum number of threads decoding at the same time,
+/// the calling thread included, 0 uses every worker of the pool.
+/// \returns Whether each file was loaded and the time it took.
+std::vector<ofImageLoadStats> ofLoadImages(const std::vector<std::filesystem::path> & paths, std::vector<ofPixels> & pixels, size_t numThreads = 0, const ofImageLoadSettings &settings = ofImageLoadSettings());
+std::vector<ofImageLoadStats> ofLoadImages(const std::vector<std::filesystem::path> & paths, std::vector<ofShortPixels> & pixels, size_t numThreads = 0, const ofImageLoadSettings &settings = ofImageLoadSettings());
+std::vector<ofImageLoadStats> ofLoadImages(const std::vector<std::filesystem::path> & paths, std::vector<ofFloatPixels> & pixels, size_t numThreads = 0, const ofImageLoadSettings &settings = ofImageLoadSettings());
+
 /// \todo Needs documentation.
 bool ofLoadImage(ofTexture & tex, const std::filesystem::path& path, const ofImageLoadSettings &settings = ofImageLoadSettings());
 bool ofLoadImage(ofTexture & tex, const ofBuffer & buffer, const ofImageLoadSettings &settings = ofImageLoadSettings());
@@ -1,4 +1,5 @@
 #include "ofPath.h"
+#include "ofTaskPool.h"
 
 using namespace std;
 
@@ -51,6 +52,7 @@ ofPath::ofPath(){
 	bNeedsTessellation = false;
 	bHasChanged = false;
 	bUseShapeColor = true;
+	bUseTessellationCache = false;
 	bNeedsPolylinesGeneration = false;
 	clear();
 }
@@ -614,15 +616,34 @@ void ofPath::generatePolylinesFromCommands(){
 void ofPath::tessellate(){
 	generatePolylinesFromCommands();
 	if(!bNeedsTessellation || polylines.empty() || std::all_of(polylines.begin(), polylines.end(), [](const ofPolyline & p) {return p.getVertices().empty();})) return;
-	if(bFill){
-		tessellator.tessellateToMesh( polylines, windingMode, cachedTessellation);
-	}
-	if(hasOutline() && windingMode!=OF_POLY_WINDING_ODD){
-		tessellator.tessellateToPolylines( polylines, windingMode, tessellatedContour);
+	bool bNeedsContour = hasOutline() && windingMode!=OF_POLY_WINDING_ODD;
+	if(bUseTessellationCache){
+		if(bFill || bNeedsContour){
+			ofGetTessellationCache().tessellate( tessellator, polylines, windingMode,
+				bFill ? &cachedTessellation : nullptr,
+				bNeedsContour ? &tessellatedContour : nullptr );
+		}
+	}else{
+		if(bFill){
+			tessellator.tessellateToMesh( polylines, windingMode, cachedTessellation);
+		}
+		if(bNeedsContour){
+			tessellator.tessellateToPolylines( polylines, windingMode, tessellatedContour);
+		}
 	}
 	bNeedsTessellation = false;
 }
 
+//----------------------------------------------------------
+void ofPath::setUseTessellationCache(bool useCache){
+	bUseTessellationCache = useCache;
+}
+
+//----------------------------------------------------------
+bool ofPath::getUseTessellationCache() const{
+	return bUseTessellationCache;
+}
+
 //----------------------------------------------------------
 const vector<ofPolyline> & ofPath::getOutline() const{
 	if(windingMode!=OF_POLY_WINDING_ODD){
@@ -884,3 +905,26 @@ void ofPath::addCommand(const ofPath::Command & command){
 	}
 	commands.push_back(command);
 }
+
+//----------------------------------------------------------
+void ofTessellatePaths(const vector<ofPath*> & paths){
+#if defined(TARGET_EMSCRIPTEN)
+	// all the paths share the same tessellator
+	for(auto path: paths){
+		path->tessellate();
+	}
+#else
+	ofParallelFor(0, paths.size(), [&](size_t i){
+		paths[i]->tessellate();
+	});
+#endif
+}
+
+//----------------------------------------------------------
+void ofTessellatePaths(vector<ofPath> & paths){
+	vector<ofPath*> pointers(paths.size());
+	for(size_t i = 0; i < paths.size(); i++){
+		pointers[i] = &paths[i];
+	}
+	ofTessellatePaths(pointers);
+}
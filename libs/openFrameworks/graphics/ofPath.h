@@ -321,6 +321,15 @@ public:
 
 	const ofMesh & getTessellation() const;
 
+	/// \brief Reuse the tessellation of any path with the same outline and
+	/// winding mode from ofGetTessellationCache() instead of tessellating
+	/// again.
+	///
+	/// Useful for shapes that are rebuilt every frame but don't change
+	/// often, or for many copies of the same shape. Disabled by default.
+	void setUseTessellationCache(bool useCache);
+	bool getUseTessellationCache() const;
+
 	void simplify(float tolerance=0.3f);
 
 	void translate(const glm::vec3 & p);
@@ -413,6 +422,7 @@ private:
 	float				strokeWidth;
 	bool				bFill;
 	bool				bUseShapeColor;
+	bool				bUseTessellationCache;
 
 	// polyline / tessellation
 	std::vector<ofPolyline>  polylines;
@@ -439,3 +449,12 @@ private:
 
 	Mode				mode;
 };
+
+/// \brief Tessellate every path that changed since it was last tessellated
+/// in parallel using the shared task pool, each worker with its own
+/// tessellator.
+///
+/// Drawing the paths afterwards only needs to upload the meshes. Every path
+/// in the vector has to be a different one.
+void ofTessellatePaths(const std::vector<ofPath*> & paths);
+void ofTessellatePaths(std::vector<ofPath> & paths);
@@ -1,8 +1,21 @@
 #include "ofPixels.h"
 #include "ofGraphicsConstants.h"
 #include "glm/common.hpp"
+#include "ofTaskPool.h"
 #include <cstring>
 
+#if defined(__AVX__)
+	#include <immintrin.h>
+	#define OF_PIXELS_RESAMPLE_AVX
+	#define OF_PIXELS_RESAMPLE_SSE
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define OF_PIXELS_RESAMPLE_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define OF_PIXELS_RESAMPLE_NEON
+#endif
+
 using namespace std;
 
 static ofImageType getImageTypeFromChannels(size_t channels){
@@ -1256,16 +1269,262 @@ void ofPixels_<PixelType>::mirrorTo(ofPixels_<PixelType> & dst, bool vertically,
 
 }
 
+//----------------------------------------------------------------------
+// Separable resampling used by the bilinear, area and lanczos resizes.
+//
+// Each axis is described by a table with a fixed number of taps per
+// destination coordinate: the first source index and the normalized weight
+// of every tap. Borders are handled by clamping the source index and folding
+// its weight into the window so the inner loops never need to branch.
+namespace{
+	struct ofResampleAxis{
+		size_t taps = 0;
+		vector<size_t> first;
+		vector<float> weights;
+	};
+
+	float resampleSinc(float x){
+		if(x == 0.f) return 1.f;
+		x *= float(PI);
+		return std::sin(x) / x;
+	}
+
+	float resampleLanczos3(float x){
+		x = std::abs(x);
+		return x < 3.f ? resampleSinc(x) * resampleSinc(x / 3.f) : 0.f;
+	}
+
+	ofResampleAxis resampleAxis(size_t srcSize, size_t dstSize, ofInterpolationMethod interpMethod){
+		float scale = float(srcSize) / float(dstSize);
+		float filterScale = std::max(1.f, scale);
+		size_t maxTaps;
+		switch(interpMethod){
+			case OF_INTERPOLATE_AREA:
+				maxTaps = size_t(std::ceil(scale)) + 1;
+				break;
+			case OF_INTERPOLATE_LANCZOS:
+				maxTaps = size_t(std::ceil(6.f * filterScale)) + 1;
+				break;
+			case OF_INTERPOLATE_BILINEAR:
+			default:
+				maxTaps = 2;
+				break;
+		}
+
+		ofResampleAxis axis;
+		axis.taps = std::min(maxTaps, srcSize);
+		axis.first.resize(dstSize);
+		axis.weights.assign(dstSize * axis.taps, 0.f);
+
+		vector<float> contrib(maxTaps);
+		for(size_t x=0; x<dstSize; x++){
+			long lo;
+			std::fill(contrib.begin(), contrib.end(), 0.f);
+			switch(interpMethod){
+				case OF_INTERPOLATE_AREA:{
+					// fraction of each source pixel covered by this destination pixel
+					float x0 = x * scale;
+					float x1 = x0 + scale;
+					lo = long(x0);
+					for(size_t k=0; k<maxTaps; k++){
+						float overlap = std::min(float(lo + k + 1), x1) - std::max(float(lo + k), x0);
+						contrib[k] = std::max(overlap, 0.f);
+					}
+				}break;
+				case OF_INTERPOLATE_LANCZOS:{
+					float center = (x + 0.5f) * scale - 0.5f;
+					lo = long(std::floor(center - 3.f * filterScale)) + 1;
+					for(size_t k=0; k<maxTaps; k++){
+						contrib[k] = resampleLanczos3((lo + long(k) - center) / filterScale);
+					}
+				}break;
+				case OF_INTERPOLATE_BILINEAR:
+				default:{
+					float center = (x + 0.5f) * scale - 0.5f;
+					lo = long(std::floor(center));
+					float frac = center - lo;
+					contrib[0] = 1.f - frac;
+					contrib[1] = frac;
+				}break;
+			}
+
+			float sum = 0;
+			for(auto w: contrib) sum += w;
+			if(sum == 0.f) sum = 1.f;
+
+			long start = std::max(0L, std::min(lo, long(srcSize - axis.taps)));
+			float * weights = &axis.weights[x * axis.taps];
+			for(size_t k=0; k<maxTaps; k++){
+				long src = std::max(0L, std::min(lo + long(k), long(srcSize) - 1));
+				weights[src - start] += contrib[k] / sum;
+			}
+			axis.first[x] = start;
+		}
+		return axis;
+	}
+
+	// dst[i] += src[i] * weight, the vertical pass of the resampler
+	void resampleAccumulate(float * dst, const float * src, float weight, size_t n){
+		size_t i = 0;
+#if defined(OF_PIXELS_RESAMPLE_AVX)
+		__m256 w8 = _mm256_set1_ps(weight);
+		for(; i+8<=n; i+=8){
+			_mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), w8)));
+		}
+#endif
+#if defined(OF_PIXELS_RESAMPLE_SSE)
+		__m128 w4 = _mm_set1_ps(weight);
+		for(; i+4<=n; i+=4){
+			_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), w4)));
+		}
+#elif defined(OF_PIXELS_RESAMPLE_NEON)
+		for(; i+4<=n; i+=4){
+			vst1q_f32(dst + i, vmlaq_n_f32(vld1q_f32(dst + i), vld1q_f32(src + i), weight));
+		}
+#endif
+		for(; i<n; i++){
+			dst[i] += src[i] * weight;
+		}
+	}
+
+	// horizontal pass for one source row already converted to float
+	void resampleRow(const float * src, float * dst, size_t channels, const ofResampleAxis & axis){
+		size_t dstWidth = axis.first.size();
+		const float * w = axis.weights.data();
+#if defined(OF_PIXELS_RESAMPLE_SSE) || defined(OF_PIXELS_RESAMPLE_NEON)
+		if(channels == 4){
+			for(size_t x=0; x<dstWidth; x++, w+=axis.taps){
+				const float * s = src + axis.first[x] * 4;
+	#if defined(OF_PIXELS_RESAMPLE_SSE)
+				__m128 acc = _mm_setzero_ps();
+				for(size_t k=0; k<axis.taps; k++){
+					acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(s + k * 4), _mm_set1_ps(w[k])));
+				}
+				_mm_storeu_ps(dst + x * 4, acc);
+	#else
+				float32x4_t acc = vdupq_n_f32(0.f);
+				for(size_t k=0; k<axis.taps; k++){
+					acc = vmlaq_n_f32(acc, vld1q_f32(s + k * 4), w[k]);
+				}
+				vst1q_f32(dst + x * 4, acc);
+	#endif
+			}
+			return;
+		}
+#endif
+		for(size_t x=0; x<dstWidth; x++, w+=axis.taps){
+			const float * s = src + axis.first[x] * channels;
+			for(size_t c=0; c<channels; c++){
+				float acc = 0;
+				for(size_t k=0; k<axis.taps; k++){
+					acc += s[k * channels + c] * w[k];
+				}
+				dst[x * channels + c] = acc;
+			}
+		}
+	}
+
+	template<typename PixelType>
+	inline PixelType resampleStore(float v){
+		if(std::numeric_limits<PixelType>::is_integer){
+			double d = std::max(double(std::numeric_limits<PixelType>::lowest()), std::min(double(v), double(std::numeric_limits<PixelType>::max())));
+			return PixelType(d < 0 ? d - 0.5 : d + 0.5);
+		}else{
+			return PixelType(v);
+		}
+	}
+
+	// resamples destination rows [y0, y1). Every source row is filtered
+	// horizontally once into a ring of yAxis.taps rows and reused by all the
+	// destination rows that need it.
+	template<typename PixelType>
+	void resampleBand(const PixelType * src, size_t srcWidth, PixelType * dst, size_t dstWidth, size_t channels,
+					  const ofResampleAxis & xAxis, const ofResampleAxis & yAxis, size_t y0, size_t y1){
+		size_t srcRowSize = srcWidth * channels;
+		size_t dstRowSize = dstWidth * channels;
+		vector<float> srcRow(srcRowSize);
+		vector<float> cache(yAxis.taps * dstRowSize);
+		vector<size_t> cachedRow(yAxis.taps, std::numeric_limits<size_t>::max());
+		vector<float> accum(dstRowSize);
+
+		for(size_t y=y0; y<y1; y++){
+			std::fill(accum.begin(), accum.end(), 0.f);
+			const float * w = &yAxis.weights[y * yAxis.taps];
+			for(size_t k=0; k<yAxis.taps; k++){
+				if(w[k] == 0.f) continue;
+				size_t row = yAxis.first[y] + k;
+				size_t slot = row % yAxis.taps;
+				float * filtered = &cache[slot * dstRowSize];
+				if(cachedRow[slot] != row){
+					const PixelType * srcLine = src + row * srcRowSize;
+					for(size_t i=0; i<srcRowSize; i++){
+						srcRow[i] = srcLine[i];
+					}
+					resampleRow(srcRow.data(), filtered, channels, xAxis);
+					cachedRow[slot] = row;
+				}
+				resampleAccumulate(accum.data(), filtered, w[k], dstRowSize);
+			}
+			PixelType * dstLine = dst + y * dstRowSize;
+			for(size_t i=0; i<dstRowSize; i++){
+				dstLine[i] = resampleStore<PixelType>(accum[i]);
+			}
+		}
+	}
+
+	template<typename PixelType>
+	void resampleSeparable(const PixelType * src, size_t srcWidth, size_t srcHeight, PixelType * dst, size_t dstWidth, size_t dstHeight,
+						   size_t channels, ofInterpolationMethod interpMethod, size_t numThreads){
+		ofResampleAxis xAxis = resampleAxis(srcWidth, dstWidth, interpMethod);
+		ofResampleAxis yAxis = resampleAxis(srcHeight, dstHeight, interpMethod);
+
+		if(numThreads == 0){
+			numThreads = ofGetTaskPool().getNumThreads() + 1;
+		}
+		numThreads = std::min(numThreads, dstHeight);
+		if(numThreads <= 1){
+			resampleBand(src, srcWidth, dst, dstWidth, channels, xAxis, yAxis, 0, dstHeight);
+			return;
+		}
+
+		// each band keeps its own row cache so the source rows at the band
+		// boundaries are filtered twice but no synchronization is needed
+		size_t bandHeight = (dstHeight + numThreads - 1) / numThreads;
+		ofGetTaskPool().parallelForRange(0, dstHeight, [&](size_t y0, size_t y1){
+			resampleBand(src, srcWidth, dst, dstWidth, channels, xAxis, yAxis, y0, y1);
+		}, bandHeight);
+	}
+
+	bool resampleSupportsFormat(ofPixelFormat pixelFormat){
+		switch(pixelFormat){
+			case OF_PIXELS_RGB:
+			case OF_PIXELS_BGR:
+			case OF_PIXELS_RGBA:
+			case OF_PIXELS_BGRA:
+			case OF_PIXELS_GRAY:
+			case OF_PIXELS_GRAY_ALPHA:
+			case OF_PIXELS_Y:
+			case OF_PIXELS_U:
+			case OF_PIXELS_V:
+			case OF_PIXELS_UV:
+			case OF_PIXELS_VU:
+				return true;
+			default:
+				return false;
+		}
+	}
+}
+
 //----------------------------------------------------------------------
 template<typename PixelType>
-bool ofPixels_<PixelType>::resize(size_t dstWidth, size_t dstHeight, ofInterpolationMethod interpMethod){
+bool ofPixels_<PixelType>::resize(size_t dstWidth, size_t dstHeight, ofInterpolationMethod interpMethod, size_t numThreads){
 
 	if ((dstWidth == 0) || (dstHeight == 0) || !(isAllocated())) return false;
 
 	ofPixels_<PixelType> dstPixels;
 	dstPixels.allocate(dstWidth, dstHeight, getPixelFormat());
 
-	if(!resizeTo(dstPixels,interpMethod)) return false;
+	if(!resizeTo(dstPixels,interpMethod,numThreads)) return false;
 
 	delete [] pixels;
 	pixels = dstPixels.getData();
@@ -1331,7 +1590,7 @@ float ofPixels_<PixelType>::bicubicInterpolate (const float *patch, float x,floa
 
 //----------------------------------------------------------------------
 template<typename PixelType>
-bool ofPixels_<PixelType>::resizeTo(ofPixels_<PixelType>& dst, ofInterpolationMethod interpMethod) const{
+bool ofPixels_<PixelType>::resizeTo(ofPixels_<PixelType>& dst, ofInterpolationMethod interpMethod, size_t numThreads) const{
 	if(&dst == this){
 		return true;
 	}
@@ -1373,8 +1632,13 @@ bool ofPixels_<PixelType>::resizeTo(ofPixels_<PixelType>& dst, ofInterpolationMe
 
 			//----------------------------------------
 		case OF_INTERPOLATE_BILINEAR:
-			// not implemented yet
-			ofLogError("ofPixels") << "resizeTo(): bilinear resize not implemented, not resizing";
+		case OF_INTERPOLATE_AREA:
+		case OF_INTERPOLATE_LANCZOS:
+			if(!resampleSupportsFormat(pixelFormat)){
+				ofLogError("ofPixels") << "resizeTo(): pixel format " << ofToString(pixelFormat) << " can only be resized with nearest neighbor, not resizing";
+				return false;
+			}
+			resampleSeparable(pixels, srcWidth, srcHeight, dstPixels, dstWidth, dstHeight, getNumChannels(), interpMethod, numThreads);
 			break;
 
 			//----------------------------------------
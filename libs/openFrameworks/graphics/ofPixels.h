@@ -52,7 +52,12 @@
 enum ofInterpolationMethod {
 	OF_INTERPOLATE_NEAREST_NEIGHBOR =1,
 	OF_INTERPOLATE_BILINEAR			=2,
-	OF_INTERPOLATE_BICUBIC			=3
+	OF_INTERPOLATE_BICUBIC			=3,
+	/// \brief Box filter averaging every source pixel covered by the
+	/// destination pixel, the best choice for large downscales.
+	OF_INTERPOLATE_AREA				=4,
+	/// \brief Windowed sinc with a 3 lobe support, sharpest but slowest.
+	OF_INTERPOLATE_LANCZOS			=5
 };
 
 
@@ -277,7 +282,13 @@ public:
 	///     OF_INTERPOLATE_NEAREST_NEIGHBOR
 	///     OF_INTERPOLATE_BILINEAR
 	///     OF_INTERPOLATE_BICUBIC
-	bool resize(size_t dstWidth, size_t dstHeight, ofInterpolationMethod interpMethod=OF_INTERPOLATE_NEAREST_NEIGHBOR);
+	///     OF_INTERPOLATE_AREA
+	///     OF_INTERPOLATE_LANCZOS
+	///
+	/// \param numThreads Bilinear, area and lanczos resizes can be split
+	/// in horizontal bands processed in parallel by the shared ofTaskPool,
+	/// 0 uses one band per core.
+	bool resize(size_t dstWidth, size_t dstHeight, ofInterpolationMethod interpMethod=OF_INTERPOLATE_NEAREST_NEIGHBOR, size_t numThreads=1);
 
 	/// \brief Resize the ofPixels instance to the size of the ofPixels object passed in dst.
 	///
@@ -286,7 +297,17 @@ public:
 	///     OF_INTERPOLATE_NEAREST_NEIGHBOR
 	///     OF_INTERPOLATE_BILINEAR
 	///     OF_INTERPOLATE_BICUBIC
-	bool resizeTo(ofPixels_<PixelType> & dst, ofInterpolationMethod interpMethod=OF_INTERPOLATE_NEAREST_NEIGHBOR) const;
+	///     OF_INTERPOLATE_AREA
+	///     OF_INTERPOLATE_LANCZOS
+	///
+	/// Bilinear, area and lanczos are computed as two separable passes,
+	/// every source row is filtered horizontally only once and cached
+	/// while the destination rows that need it are produced.
+	///
+	/// \param numThreads Number of horizontal bands to process in
+	/// parallel on the shared ofTaskPool for the separable methods, 0 uses
+	/// one band per core.
+	bool resizeTo(ofPixels_<PixelType> & dst, ofInterpolationMethod interpMethod=OF_INTERPOLATE_NEAREST_NEIGHBOR, size_t numThreads=1) const;
 
 	/// \brief Paste the ofPixels object into another ofPixels object at the
 	/// specified index, copying data from the ofPixels that the method is
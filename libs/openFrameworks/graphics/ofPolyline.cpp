@@ -0,0 +1,280 @@
+#include "ofPolyline.h"
+#include "ofVectorMath.h"
+#include <algorithm>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define OF_POLYLINE_SSE
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__aarch64__)
+	#include <arm_neon.h>
+	#define OF_POLYLINE_NEON
+#endif
+
+using namespace std;
+
+namespace{
+	// segments per leaf, a multiple of the 4 segments tested at once
+	const size_t leafSize = 8;
+	const uint32_t noSegment = numeric_limits<uint32_t>::max();
+
+	// even-odd crossings of a ray going right from x,y with count
+	// segments, count is a multiple of 4. same test as ofPolyline::inside,
+	// done in float as it is there so the results are exactly the same
+	int countCrossings(float x, float y, const float * x0, const float * y0, const float * x1, const float * y1, size_t count){
+		int crossings = 0;
+#if defined(OF_POLYLINE_SSE)
+		__m128 X = _mm_set1_ps(x);
+		__m128 Y = _mm_set1_ps(y);
+		for(size_t i = 0; i < count; i += 4){
+			__m128 ax = _mm_loadu_ps(x0 + i);
+			__m128 ay = _mm_loadu_ps(y0 + i);
+			__m128 bx = _mm_loadu_ps(x1 + i);
+			__m128 by = _mm_loadu_ps(y1 + i);
+			__m128 mask = _mm_and_ps(_mm_cmpgt_ps(Y, _mm_min_ps(ay, by)), _mm_cmple_ps(Y, _mm_max_ps(ay, by)));
+			mask = _mm_and_ps(mask, _mm_cmple_ps(X, _mm_max_ps(ax, bx)));
+			mask = _mm_and_ps(mask, _mm_cmpneq_ps(ay, by));
+			if(_mm_movemask_ps(mask) == 0) continue;
+			__m128 xinters = _mm_add_ps(_mm_div_ps(_mm_mul_ps(_mm_sub_ps(Y, ay), _mm_sub_ps(bx, ax)), _mm_sub_ps(by, ay)), ax);
+			mask = _mm_and_ps(mask, _mm_or_ps(_mm_cmpeq_ps(ax, bx), _mm_cmple_ps(X, xinters)));
+			int bits = _mm_movemask_ps(mask);
+			crossings += (bits & 1) + ((bits >> 1) & 1) + ((bits >> 2) & 1) + ((bits >> 3) & 1);
+		}
+#elif defined(OF_POLYLINE_NEON)
+		float32x4_t X = vdupq_n_f32(x);
+		float32x4_t Y = vdupq_n_f32(y);
+		uint32x4_t total = vdupq_n_u32(0);
+		for(size_t i = 0; i < count; i += 4){
+			float32x4_t ax = vld1q_f32(x0 + i);
+			float32x4_t ay = vld1q_f32(y0 + i);
+			float32x4_t bx = vld1q_f32(x1 + i);
+			float32x4_t by = vld1q_f32(y1 + i);
+			uint32x4_t mask = vandq_u32(vcgtq_f32(Y, vminq_f32(ay, by)), vcleq_f32(Y, vmaxq_f32(ay, by)));
+			mask = vandq_u32(mask, vcleq_f32(X, vmaxq_f32(ax, bx)));
+			mask = vandq_u32(mask, vmvnq_u32(vceqq_f32(ay, by)));
+			float32x4_t xinters = vaddq_f32(vdivq_f32(vmulq_f32(vsubq_f32(Y, ay), vsubq_f32(bx, ax)), vsubq_f32(by, ay)), ax);
+			mask = vandq_u32(mask, vorrq_u32(vceqq_f32(ax, bx), vcleq_f32(X, xinters)));
+			total = vsubq_u32(total, mask); // true lanes are all ones, -1
+		}
+		crossings = int(vaddvq_u32(total));
+#else
+		for(size_t i = 0; i < count; i++){
+			if(y > std::min(y0[i], y1[i]) && y <= std::max(y0[i], y1[i]) && x <= std::max(x0[i], x1[i]) && y0[i] != y1[i]){
+				float xinters = (y - y0[i]) * (x1[i] - x0[i]) / (y1[i] - y0[i]) + x0[i];
+				if(x0[i] == x1[i] || x <= xinters){
+					crossings++;
+				}
+			}
+		}
+#endif
+		return crossings;
+	}
+}
+
+//--------------------------------------------------
+void of::priv::PolylineBVH::build(const float * points, size_t stride, size_t numPoints, bool closed){
+	clear();
+	if(numPoints < 2) return;
+	this->closed = closed;
+	this->numPoints = numPoints;
+
+	auto point = [&](size_t i){
+		return reinterpret_cast<const float*>(reinterpret_cast<const char*>(points) + (i % numPoints) * stride);
+	};
+
+	// the last segment closes the polyline, inside always uses it
+	size_t numSegments = numPoints;
+	vector<uint32_t> order(numSegments);
+	vector<float> centers(numSegments * 3);
+	for(size_t i = 0; i < numSegments; i++){
+		order[i] = uint32_t(i);
+		for(int axis = 0; axis < 3; axis++){
+			centers[i * 3 + axis] = (point(i)[axis] + point(i + 1)[axis]) * 0.5f;
+		}
+	}
+
+	auto reserved = numSegments + numSegments / 2 + 4;
+	for(auto coordinates: {&x0, &y0, &z0, &x1, &y1, &z1}){
+		coordinates->reserve(reserved);
+	}
+	indices.reserve(reserved);
+	nodes.reserve(2 * (numSegments / leafSize + 1));
+
+	struct Range{
+		size_t node;
+		size_t begin;
+		size_t end;
+	};
+	vector<Range> stack{{0, 0, numSegments}};
+	nodes.emplace_back();
+	while(!stack.empty()){
+		auto range = stack.back();
+		stack.pop_back();
+
+		auto & node = nodes[range.node];
+		float centerMin[3], centerMax[3];
+		for(int axis = 0; axis < 3; axis++){
+			node.min[axis] = centerMin[axis] = numeric_limits<float>::max();
+			node.max[axis] = centerMax[axis] = -numeric_limits<float>::max();
+		}
+		for(size_t i = range.begin; i < range.end; i++){
+			auto a = point(order[i]);
+			auto b = point(order[i] + 1);
+			for(int axis = 0; axis < 3; axis++){
+				node.min[axis] = std::min(node.min[axis], std::min(a[axis], b[axis]));
+				node.max[axis] = std::max(node.max[axis], std::max(a[axis], b[axis]));
+				centerMin[axis] = std::min(centerMin[axis], centers[order[i] * 3 + axis]);
+				centerMax[axis] = std::max(centerMax[axis], centers[order[i] * 3 + axis]);
+			}
+		}
+
+		if(range.end - range.begin <= leafSize){
+			node.first = uint32_t(indices.size());
+			for(size_t i = range.begin; i < range.end; i++){
+				auto a = point(order[i]);
+				auto b = point(order[i] + 1);
+				x0.push_back(a[0]); y0.push_back(a[1]); z0.push_back(a[2]);
+				x1.push_back(b[0]); y1.push_back(b[1]); z1.push_back(b[2]);
+				indices.push_back(order[i]);
+			}
+			// pad with segments that never cross anything
+			auto nan = numeric_limits<float>::quiet_NaN();
+			while(indices.size() % 4 != 0){
+				for(auto coordinates: {&x0, &y0, &z0, &x1, &y1, &z1}){
+					coordinates->push_back(nan);
+				}
+				indices.push_back(noSegment);
+			}
+			node.count = uint32_t(indices.size() - node.first);
+			continue;
+		}
+
+		// split at the median of the longest axis of the centers
+		int axis = 0;
+		for(int i = 1; i < 3; i++){
+			if(centerMax[i] - centerMin[i] > centerMax[axis] - centerMin[axis]) axis = i;
+		}
+		size_t middle = (range.begin + range.end) / 2;
+		nth_element(order.begin() + range.begin, order.begin() + middle, order.begin() + range.end, [&](uint32_t a, uint32_t b){
+			return centers[a * 3 + axis] < centers[b * 3 + axis];
+		});
+
+		// both children are stored together, first is the index of the first one
+		node.count = 0;
+		node.first = uint32_t(nodes.size());
+		size_t left = nodes.size();
+		size_t right = left + 1;
+		nodes.emplace_back();
+		nodes.emplace_back();
+		stack.push_back({right, middle, range.end});
+		stack.push_back({left, range.begin, middle});
+	}
+}
+
+//--------------------------------------------------
+void of::priv::PolylineBVH::clear(){
+	nodes.clear();
+	for(auto coordinates: {&x0, &y0, &z0, &x1, &y1, &z1}){
+		coordinates->clear();
+	}
+	indices.clear();
+	numPoints = 0;
+	closed = false;
+}
+
+//--------------------------------------------------
+bool of::priv::PolylineBVH::empty() const{
+	return nodes.empty();
+}
+
+//--------------------------------------------------
+int of::priv::PolylineBVH::closestSegment(const glm::vec3 & target, glm::vec3 & nearest, float & position) const{
+	if(nodes.empty()) return -1;
+
+	auto boxDistance2 = [&](const Node & node){
+		float distance2 = 0;
+		for(int axis = 0; axis < 3; axis++){
+			float d = std::max(std::max(node.min[axis] - target[axis], target[axis] - node.max[axis]), 0.f);
+			distance2 += d * d;
+		}
+		return distance2;
+	};
+
+	// the closing segment only counts if the polyline is closed
+	uint32_t skip = closed ? noSegment : uint32_t(numPoints - 1);
+	float best = numeric_limits<float>::infinity();
+	uint32_t bestSegment = noSegment;
+
+	// the child that's further away is pushed first and visited last so
+	// most of the time it can be discarded once the closer one is done
+	uint32_t stack[64];
+	int top = 0;
+	stack[top++] = 0;
+	while(top > 0){
+		auto & node = nodes[stack[--top]];
+		// a little margin so rounding can't discard a segment at the same distance
+		if(boxDistance2(node) > best * best * 1.0001f) continue;
+		if(node.count == 0){
+			uint32_t left = node.first;
+			uint32_t right = node.first + 1;
+			if(boxDistance2(nodes[left]) <= boxDistance2(nodes[right])){
+				stack[top++] = right;
+				stack[top++] = left;
+			}else{
+				stack[top++] = left;
+				stack[top++] = right;
+			}
+			continue;
+		}
+		for(size_t i = node.first; i < node.first + node.count; i++){
+			auto segment = indices[i];
+			if(segment == noSegment || segment == skip) continue;
+			glm::vec3 p1(x0[i], y0[i], z0[i]);
+			glm::vec3 p2(x1[i], y1[i], z1[i]);
+			float u = 0;
+			glm::vec3 closest = p1;
+			// same as getClosestPointUtil in ofPolyline.inl
+			if(p1 != p2){
+				u = (target.x - p1.x) * (p2.x - p1.x);
+				u += (target.y - p1.y) * (p2.y - p1.y);
+				float len = glm::length(p2 - p1);
+				u /= (len * len);
+				if(u > 1){
+					u = 1;
+				}else if(u < 0){
+					u = 0;
+				}
+				closest = glm::lerp(p1, p2, u);
+			}
+			float distance = glm::distance(closest, target);
+			if(distance < best || (distance == best && segment < bestSegment)){
+				best = distance;
+				bestSegment = segment;
+				nearest = closest;
+				position = u;
+			}
+		}
+	}
+	return bestSegment == noSegment ? -1 : int(bestSegment);
+}
+
+//--------------------------------------------------
+bool of::priv::PolylineBVH::inside(float x, float y) const{
+	if(nodes.empty()) return false;
+	int crossings = 0;
+	uint32_t stack[64];
+	int top = 0;
+	stack[top++] = 0;
+	while(top > 0){
+		auto & node = nodes[stack[--top]];
+		// only segments to the right of x whose y range contains y can be crossed
+		if(!(y > node.min[1] && y <= node.max[1] && x <= node.max[0])) continue;
+		if(node.count == 0){
+			stack[top++] = node.first + 1;
+			stack[top++] = node.first;
+		}else{
+			crossings += countCrossings(x, y, &x0[node.first], &y0[node.first], &x1[node.first], &y1[node.first], node.count);
+		}
+	}
+	return crossings % 2 == 1;
+}
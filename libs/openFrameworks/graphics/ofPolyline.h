@@ -52,6 +52,52 @@
 
 class ofRectangle;
 
+namespace of{
+namespace priv{
+	/// \brief Bounding volume hierarchy over the segments of a polyline used
+	/// by ofPolyline to answer closest point and inside queries without
+	/// testing every segment.
+	///
+	/// Segment i goes from point i to point i+1, the last one closes the
+	/// polyline back to the first point and is only used by closest point
+	/// queries if the polyline is closed.
+	class PolylineBVH{
+	public:
+		/// \param points First coordinate of the first point, each point
+		/// has x, y and z floats.
+		/// \param stride Bytes between two points.
+		void build(const float * points, std::size_t stride, std::size_t numPoints, bool closed);
+		void clear();
+		bool empty() const;
+
+		/// \returns The index of the segment closest to target, the lowest
+		/// one if several are at the same distance, or -1 if there's none.
+		/// \param nearest Set to the closest point on that segment.
+		/// \param position Set to the normalized position of nearest along
+		/// the segment.
+		int closestSegment(const glm::vec3 & target, glm::vec3 & nearest, float & position) const;
+
+		/// \brief Even-odd test of x,y against the polyline in the xy plane.
+		bool inside(float x, float y) const;
+
+	private:
+		struct Node{
+			float min[3];
+			float max[3];
+			uint32_t first; ///< first segment in leaves, first of the two children in inner nodes
+			uint32_t count; ///< segments in leaves, 0 in inner nodes
+		};
+		std::vector<Node> nodes;
+		// segments in leaf order, each leaf padded to a multiple of 4 so
+		// they can be tested 4 at a time
+		std::vector<float> x0, y0, z0, x1, y1, z1;
+		std::vector<uint32_t> indices;
+		std::size_t numPoints = 0;
+		bool closed = false;
+	};
+}
+}
+
 template<class T>
 class ofPolyline_ {
 public:
@@ -423,6 +469,44 @@ public:
 	/// index of the closest vertex
 	T getClosestPoint(const T& target, unsigned int* nearestIndex = nullptr) const;
 
+	/// \}
+	/// \name Batched Queries
+	/// \{
+
+	/// \brief Use a bounding volume hierarchy of the segments for
+	/// getClosestPoint() and inside().
+	///
+	/// It's built the first time it's needed after the polyline changes, so
+	/// it pays off for long polylines queried many times without changes.
+	/// The batched queries below always use it. Disabled by default.
+	void setUseAcceleration(bool useAcceleration);
+	bool getUseAcceleration() const;
+
+	/// \brief Tests for each of numPoints points whether it's within the
+	/// closed ofPolyline, same as inside().
+	void inside(const T * points, std::size_t numPoints, bool * result) const;
+	std::vector<bool> inside(const std::vector<T> & points) const;
+
+	/// \brief Gets the point on the line closest to each of numPoints
+	/// targets, same as getClosestPoint().
+	///
+	/// \param nearestIndices Optionally receives the index of the closest
+	/// vertex to each target, can be nullptr.
+	void getClosestPoints(const T * targets, std::size_t numPoints, T * closest, unsigned int * nearestIndices = nullptr) const;
+	std::vector<T> getClosestPoints(const std::vector<T> & targets, std::vector<unsigned int> * nearestIndices = nullptr) const;
+
+	/// \brief Gets the interpolated index at each of count lengths along
+	/// the path, same as getIndexAtLength().
+	void getIndicesAtLengths(const float * lengths, std::size_t count, float * indices) const;
+
+	/// \brief Gets the point at each of count lengths along the path, same
+	/// as getPointAtLength().
+	void getPointsAtLengths(const float * lengths, std::size_t count, T * points) const;
+
+	/// \brief Gets the point at each of count percentages along the path,
+	/// same as getPointAtPercent().
+	void getPointsAtPercents(const float * percents, std::size_t count, T * points) const;
+
 
 	/// \}
 	/// \name Other Functions
@@ -533,6 +617,7 @@ private:
 	mutable std::vector<float> angles;     // angle (rad) between adjacent segments, stored per point (asin(cross product))
 	mutable T centroid2D;
 	mutable float area;
+	mutable of::priv::PolylineBVH bvh;
 
 
 	std::deque<T> curveVertices;
@@ -540,9 +625,15 @@ private:
 
 	bool bClosed;
 	bool bHasChanged;   // public API has access to this
+	bool bUseAcceleration;
 	mutable bool bCacheIsDirty;   // used only internally, no public API to read
+	mutable bool bLengthsAreDirty;
+	mutable bool bBVHIsDirty;
 
 	void updateCache(bool bForceUpdate = false) const;
+	void updateLengths() const;
+	const of::priv::PolylineBVH & getBVH() const;
+	bool getClosestPointAccelerated(const T& target, T & closest, unsigned int* nearestIndex) const;
 
 	// given an interpolated index (e.g. 5.75) return neighboring indices and interolation factor (e.g. 5, 6, 0.75)
 	void getInterpolationParams(float findex, int &i1, int &i2, float &t) const;
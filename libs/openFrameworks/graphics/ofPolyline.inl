@@ -9,10 +9,12 @@
 #include "ofAppRunner.h"
 #include "ofMath.h"
 #include "ofLog.h"
+#include <algorithm>
 
 //----------------------------------------------------------
 template<class T>
 ofPolyline_<T>::ofPolyline_(){
+    bUseAcceleration = false;
     setRightVector();
 	clear();
 }
@@ -20,6 +22,7 @@ ofPolyline_<T>::ofPolyline_(){
 //----------------------------------------------------------
 template<class T>
 ofPolyline_<T>::ofPolyline_(const std::vector<T>& verts){
+    bUseAcceleration = false;
     setRightVector();
 	clear();
 	addVertices(verts);
@@ -154,6 +157,8 @@ template<class T>
 void ofPolyline_<T>::flagHasChanged() {
     bHasChanged = true;
     bCacheIsDirty = true;
+    bLengthsAreDirty = true;
+    bBVHIsDirty = true;
 }
 
 //----------------------------------------------------------
@@ -418,7 +423,7 @@ float ofPolyline_<T>::getPerimeter() const {
     if(points.size() < 2) {
         return 0;
     } else {
-        updateCache();
+        updateLengths();
         return lengths.back();
     }
 }
@@ -573,6 +578,11 @@ T ofPolyline_<T>::getClosestPoint(const T& target, unsigned int* nearestIndex) c
 		}
 		return target;
 	}
+
+	T closest;
+	if(bUseAcceleration && getClosestPointAccelerated(target, closest, nearestIndex)){
+		return closest;
+	}
 	
 	float distance = 0;
 	T nearestPoint;
@@ -652,6 +662,9 @@ bool ofPolyline_<T>::inside(float x, float y, const ofPolyline_ & polyline){
 //--------------------------------------------------
 template<class T>
 bool ofPolyline_<T>::inside(float x, float y) const {
+	if(bUseAcceleration && points.size() >= 2){
+		return getBVH().inside(x, y);
+	}
 	return ofPolyline_<T>::inside(x, y, *this);
     
 }
@@ -659,7 +672,100 @@ bool ofPolyline_<T>::inside(float x, float y) const {
 //--------------------------------------------------
 template<class T>
 bool ofPolyline_<T>::inside(const T & p) const {
-	return ofPolyline_<T>::inside(p, *this);
+	return inside(p.x, p.y);
+}
+
+//--------------------------------------------------
+template<class T>
+void ofPolyline_<T>::setUseAcceleration(bool useAcceleration){
+	bUseAcceleration = useAcceleration;
+}
+
+//--------------------------------------------------
+template<class T>
+bool ofPolyline_<T>::getUseAcceleration() const{
+	return bUseAcceleration;
+}
+
+//--------------------------------------------------
+template<class T>
+const of::priv::PolylineBVH & ofPolyline_<T>::getBVH() const{
+	if(bBVHIsDirty){
+		if(points.size() >= 2){
+			bvh.build(&points[0].x, sizeof(T), points.size(), bClosed);
+		}else{
+			bvh.clear();
+		}
+		bBVHIsDirty = false;
+	}
+	return bvh;
+}
+
+//--------------------------------------------------
+template<class T>
+bool ofPolyline_<T>::getClosestPointAccelerated(const T& target, T & closest, unsigned int* nearestIndex) const{
+	glm::vec3 nearestPoint;
+	float normalizedPosition = 0;
+	int segment = getBVH().closestSegment(toGlm(target), nearestPoint, normalizedPosition);
+	if(segment < 0){
+		return false;
+	}
+	if(nearestIndex != nullptr) {
+		unsigned int nearest = segment;
+		if(normalizedPosition > .5) {
+			nearest++;
+			if(nearest == points.size()) {
+				nearest = 0;
+			}
+		}
+		*nearestIndex = nearest;
+	}
+	closest = T(nearestPoint.x, nearestPoint.y, nearestPoint.z);
+	return true;
+}
+
+//--------------------------------------------------
+template<class T>
+void ofPolyline_<T>::inside(const T * points, std::size_t numPoints, bool * result) const{
+	auto & bvh = getBVH();
+	for(std::size_t i = 0; i < numPoints; i++){
+		result[i] = !bvh.empty() && bvh.inside(points[i].x, points[i].y);
+	}
+}
+
+//--------------------------------------------------
+template<class T>
+std::vector<bool> ofPolyline_<T>::inside(const std::vector<T> & points) const{
+	std::vector<bool> result(points.size());
+	auto & bvh = getBVH();
+	for(std::size_t i = 0; i < points.size(); i++){
+		result[i] = !bvh.empty() && bvh.inside(points[i].x, points[i].y);
+	}
+	return result;
+}
+
+//--------------------------------------------------
+template<class T>
+void ofPolyline_<T>::getClosestPoints(const T * targets, std::size_t numPoints, T * closest, unsigned int * nearestIndices) const{
+	for(std::size_t i = 0; i < numPoints; i++){
+		auto nearestIndex = nearestIndices ? nearestIndices + i : nullptr;
+		if(!getClosestPointAccelerated(targets[i], closest[i], nearestIndex)){
+			closest[i] = getClosestPoint(targets[i], nearestIndex);
+		}
+	}
+}
+
+//--------------------------------------------------
+template<class T>
+std::vector<T> ofPolyline_<T>::getClosestPoints(const std::vector<T> & targets, std::vector<unsigned int> * nearestIndices) const{
+	std::vector<T> closest(targets.size());
+	if(nearestIndices){
+		nearestIndices->resize(targets.size());
+	}
+	if(!targets.empty()){
+		getClosestPoints(targets.data(), targets.size(), closest.data(), nearestIndices ? nearestIndices->data() : nullptr);
+	}
+	return closest;
 }
 
 
@@ -872,35 +978,17 @@ T ofPolyline_<T>::getRightVector() const {
 template<class T>
 float ofPolyline_<T>::getIndexAtLength(float length) const {
     if(points.size() < 2) return 0;
-    updateCache();
+    updateLengths();
     
-    float totalLength = getPerimeter();
+    float totalLength = lengths.back();
     length = ofClamp(length, 0, totalLength);
     
-    int lastPointIndex = isClosed() ? points.size() : points.size()-1;
-    
-    int i1 = ofClamp(floor(length / totalLength * lastPointIndex), 0, lengths.size()-2);   // start approximation here
-    int leftLimit = 0;
-    int rightLimit = lastPointIndex;
-    
-    float distAt1, distAt2;
-    for(int iterations = 0; iterations < 32; iterations ++) {	// limit iterations
-        i1 = ofClamp(i1, 0, lengths.size()-1);
-        distAt1 = lengths[i1];
-        if(distAt1 <= length) {         // if Length at i1 is less than desired Length (this is good)
-            distAt2 = lengths[i1+1];
-            if(distAt2 >= length) {
-                float t = ofMap(length, distAt1, distAt2, 0, 1);
-                return i1 + t;
-            } else {
-                leftLimit = i1;
-            }
-        } else {
-            rightLimit = i1;
-        }
-        i1 = (leftLimit + rightLimit)/2;
-    }
-    return 0;
+    // first point at or after length, lengths are cumulative so sorted
+    auto next = std::lower_bound(lengths.begin() + 1, lengths.end(), length);
+    if(next == lengths.end()) --next;
+    int i1 = next - lengths.begin() - 1;
+    float t = ofMap(length, lengths[i1], lengths[i1+1], 0, 1);
+    return i1 + t;
 }
 
 
@@ -914,7 +1002,7 @@ float ofPolyline_<T>::getIndexAtPercent(float f) const {
 template<class T>
 float ofPolyline_<T>::getLengthAtIndex(int index) const {
     if(points.size() < 2) return 0;
-    updateCache();
+    updateLengths();
     return lengths[getWrappedIndex(index)];
 }
 
@@ -922,7 +1010,7 @@ float ofPolyline_<T>::getLengthAtIndex(int index) const {
 template<class T>
 float ofPolyline_<T>::getLengthAtIndexInterpolated(float findex) const {
     if(points.size() < 2) return 0;
-    updateCache();
+    updateLengths();
     int i1, i2;
     float t;
     getInterpolationParams(findex, i1, i2, t);
@@ -934,7 +1022,6 @@ float ofPolyline_<T>::getLengthAtIndexInterpolated(float findex) const {
 template<class T>
 T ofPolyline_<T>::getPointAtLength(float f) const {
 	if(points.size() < 2) return T();
-    updateCache();
     return getPointAtIndexInterpolated(getIndexAtLength(f));
 }
 
@@ -945,6 +1032,31 @@ T ofPolyline_<T>::getPointAtPercent(float f) const {
     return getPointAtLength(f * length);
 }
 
+//--------------------------------------------------
+template<class T>
+void ofPolyline_<T>::getIndicesAtLengths(const float * lengths, std::size_t count, float * indices) const {
+    for(std::size_t i = 0; i < count; i++){
+        indices[i] = getIndexAtLength(lengths[i]);
+    }
+}
+
+//--------------------------------------------------
+template<class T>
+void ofPolyline_<T>::getPointsAtLengths(const float * lengths, std::size_t count, T * points) const {
+    for(std::size_t i = 0; i < count; i++){
+        points[i] = getPointAtLength(lengths[i]);
+    }
+}
+
+//--------------------------------------------------
+template<class T>
+void ofPolyline_<T>::getPointsAtPercents(const float * percents, std::size_t count, T * points) const {
+    float length = getPerimeter();
+    for(std::size_t i = 0; i < count; i++){
+        points[i] = getPointAtLength(percents[i] * length);
+    }
+}
+
 
 //--------------------------------------------------
 template<class T>
@@ -1122,7 +1234,6 @@ void ofPolyline_<T>::getInterpolationParams(float findex, int &i1, int &i2, floa
 template<class T>
 void ofPolyline_<T>::updateCache(bool bForceUpdate) const {
     if(bCacheIsDirty || bForceUpdate) {
-        lengths.clear();
         angles.clear();
         rotations.clear();
         normals.clear();
@@ -1158,7 +1269,6 @@ void ofPolyline_<T>::updateCache(bool bForceUpdate) const {
 
         
         // per vertex cache
-        lengths.resize(points.size());
         tangents.resize(points.size());
         angles.resize(points.size());
         normals.resize(points.size());
@@ -1169,19 +1279,34 @@ void ofPolyline_<T>::updateCache(bool bForceUpdate) const {
 		T normal;
 		T tangent;
 
-        float length = 0;
         for(int i=0; i<(int)points.size(); i++) {
-            lengths[i] = length;
-
             calcData(i, tangent, angle, rotation, normal);
             tangents[i] = tangent;
             angles[i] = angle;
             rotations[i] = rotation;
             normals[i] = normal;
-            
+        }
+    }
+}
+
+//--------------------------------------------------
+// the lengths are kept apart from the rest of the cache so
+// queries by length don't need to calculate the per vertex data
+template<class T>
+void ofPolyline_<T>::updateLengths() const {
+    if(bLengthsAreDirty) {
+        lengths.clear();
+        bLengthsAreDirty = false;
+
+        if(points.size() < 2) return;
+
+        lengths.resize(points.size());
+        float length = 0;
+        for(int i=0; i<(int)points.size(); i++) {
+            lengths[i] = length;
 			length += glm::distance(toGlm(points[i]), toGlm(points[getWrappedIndex(i + 1)]));
         }
-        
+
         if(isClosed()) lengths.push_back(length);
     }
 }
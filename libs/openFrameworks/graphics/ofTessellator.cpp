@@ -2,57 +2,142 @@
 #include "tesselator.h"
 #include "ofPolyline.h"
 #include "ofMesh.h"
+#include <chrono>
+#include <cstring>
 
 using namespace std;
 
-
-
-
-
 //-------------- polygons ----------------------------------
 //
 // to do polygons, we need tesselation
-// to do tesselation, we need glu and callbacks....
+// libtess2 allocates lots of small pieces of memory for its
+// mesh, dictionary and priority queue while tessellating and
+// frees all of them at the end.
 // ------------------------------------
-// one of the callbacks creates new vertices (on intersections, etc),
-// and there is a potential for memory leaks
-// if we don't clean up properly
+// instead of going through malloc for each of them, every
+// ofTessellator has an arena: allocations just move a pointer
+// forward in a block and the whole arena is rewound after each
+// tessellation, together with the tessellator living in it.
 // ------------------------------------
-// also the easiest system, using beginShape
-// vertex(), endShape, will also use dynamically
-// allocated memory
-// ------------------------------------
-// so, therefore, we will be using a static vector here
-// for two things:
-//
-// a) collecting vertices
-// b) new vertices on combine callback
-//
-// important note!
-//
-// this assumes single threaded polygon creation
-// you can have big problems if creating polygons in
-// multiple threads... please be careful
-//
-// (but also be aware that alot of opengl code
-// is single threaded anyway, so you will have problems
-// with many things opengl related across threads)
-//
+// an ofTessellator still can't be used from several threads at
+// the same time but different instances can, ofPath keeps one
+// per thread.
 // ------------------------------------
 // (note: this implementation is based on code from ftgl)
 // ------------------------------------
 
+struct of::priv::TessellatorArena{
+	// allocations are aligned to this and prefixed by their capacity
+	static const size_t alignment = 16;
+	static const size_t minBlockSize = 256 * 1024;
+
+	struct Block{
+		char * data;
+		size_t size;
+	};
+
+	vector<Block> blocks;
+	size_t current = 0;
+	size_t used = 0;
+	char * last = nullptr;
+
+	~TessellatorArena(){
+		for(auto & block: blocks){
+			::free(block.data);
+		}
+	}
+
+	static size_t padded(size_t size){
+		return (size + alignment - 1) / alignment * alignment;
+	}
+
+	static size_t & capacity(void * ptr){
+		return *reinterpret_cast<size_t*>(static_cast<char*>(ptr) - alignment);
+	}
+
+	void * alloc(size_t size){
+		size_t needed = alignment + padded(size);
+		while(current < blocks.size() && used + needed > blocks[current].size){
+			current++;
+			used = 0;
+		}
+		if(current == blocks.size()){
+			size_t blockSize = std::max(needed, blocks.empty() ? minBlockSize : blocks.back().size * 2);
+			Block block{static_cast<char*>(malloc(blockSize)), blockSize};
+			if(!block.data) return nullptr;
+			blocks.push_back(block);
+			used = 0;
+		}
+		last = blocks[current].data + used + alignment;
+		capacity(last) = padded(size);
+		used += needed;
+		return last;
+	}
+
+	void * realloc(void * ptr, size_t size){
+		if(!ptr) return alloc(size);
+		size_t oldCapacity = capacity(ptr);
+		if(size <= oldCapacity) return ptr;
+		// the last allocation can grow in place if its block has room
+		if(ptr == last){
+			size_t start = last - blocks[current].data;
+			if(start + padded(size) <= blocks[current].size){
+				capacity(ptr) = padded(size);
+				used = start + padded(size);
+				return ptr;
+			}
+		}
+		auto newPtr = alloc(size);
+		if(newPtr) memcpy(newPtr, ptr, oldCapacity);
+		return newPtr;
+	}
+
+	void free(void * ptr){
+		// only the last allocation can be given back, the rest is
+		// released all at once by reset()
+		if(ptr && ptr == last){
+			used = last - alignment - blocks[current].data;
+			last = nullptr;
+		}
+	}
+
+	void reset(){
+		// if one tessellation needed more than one block merge them so
+		// the next ones fit in a single one, shrink if it's way bigger
+		// than what the last tessellation needed
+		size_t total = 0;
+		for(size_t i = 0; i < current; i++){
+			total += blocks[i].size;
+		}
+		total += used;
+		size_t wanted = std::max(minBlockSize, padded(total));
+		if(blocks.size() > 1 || (!blocks.empty() && blocks[0].size > wanted * 4)){
+			for(auto & block: blocks){
+				::free(block.data);
+			}
+			blocks.clear();
+			Block block{static_cast<char*>(malloc(wanted)), wanted};
+			if(block.data) blocks.push_back(block);
+		}
+		current = 0;
+		used = 0;
+		last = nullptr;
+	}
+};
 
-void * memAllocator( void *userData, unsigned int size ){
-	return malloc(size);
+const size_t of::priv::TessellatorArena::alignment;
+const size_t of::priv::TessellatorArena::minBlockSize;
+
+static void * memAllocator( void *userData, unsigned int size ){
+	return static_cast<of::priv::TessellatorArena*>(userData)->alloc(size);
 }
 
-void * memReallocator( void *userData, void* ptr, unsigned int size ){
-	return realloc(ptr,size);
+static void * memReallocator( void *userData, void* ptr, unsigned int size ){
+	return static_cast<of::priv::TessellatorArena*>(userData)->realloc(ptr, size);
 }
 
-void memFree( void *userData, void *ptr ){
-	free (ptr);
+static void memFree( void *userData, void *ptr ){
+	static_cast<of::priv::TessellatorArena*>(userData)->free(ptr);
 }
 
 //----------------------------------------------------------
@@ -64,57 +149,64 @@ ofTessellator::ofTessellator()
 
 //----------------------------------------------------------
 ofTessellator::~ofTessellator(){
-	tessDeleteTess(cacheTess);
+	// everything libtess2 allocated lives in the arena
 }
 
 //----------------------------------------------------------
 ofTessellator::ofTessellator(const ofTessellator & mom)
   : cacheTess(nullptr)
 {
-	if(&mom != this){
-		if(cacheTess) tessDeleteTess(cacheTess);
-		init();
-	}
+	init();
 }
 
 //----------------------------------------------------------
 ofTessellator & ofTessellator::operator=(const ofTessellator & mom){
-	if(&mom != this){
-		if(cacheTess) tessDeleteTess(cacheTess);
-		init();
-	}
+	// nothing to copy, each tessellator keeps its own arena
 	return *this;
 }
 
 //----------------------------------------------------------
 void ofTessellator::init(){
+	arena.reset(new of::priv::TessellatorArena);
 	tessAllocator.memalloc = memAllocator;
 	tessAllocator.memrealloc = memReallocator;
 	tessAllocator.memfree = memFree;
-	tessAllocator.meshEdgeBucketSize=0;
-	tessAllocator.meshVertexBucketSize=0;
-	tessAllocator.meshFaceBucketSize=0;
-	tessAllocator.dictNodeBucketSize=0;
-	tessAllocator.regionBucketSize=0;
+	tessAllocator.userData = arena.get();
 	tessAllocator.extraVertices=0;
-	cacheTess = tessNewTess( &tessAllocator );
 }
 
 //----------------------------------------------------------
-void ofTessellator::tessellateToMesh( const ofPolyline& src,  ofPolyWindingMode polyWindingMode, ofMesh& dstmesh, bool bIs2D){
-
-	ofPolyline& polyline = const_cast<ofPolyline&>(src);
-	tessAddContour( cacheTess, bIs2D?2:3, &polyline.getVertices()[0], sizeof(glm::vec3), polyline.size());
-
-	performTessellation( polyWindingMode, dstmesh, bIs2D );
+void ofTessellator::begin(size_t numVertices){
+	// libtess2 links every item of its buckets in a free list when it
+	// creates them which is most of the time spent for small shapes with
+	// the default sizes, size them for the shape instead
+	auto bucketSize = [numVertices](size_t divisor, size_t max){
+		return int(std::max<size_t>(16, std::min(numVertices / divisor, max)));
+	};
+	tessAllocator.meshEdgeBucketSize = bucketSize(1, 512);
+	tessAllocator.meshVertexBucketSize = bucketSize(1, 512);
+	tessAllocator.meshFaceBucketSize = bucketSize(2, 256);
+	tessAllocator.dictNodeBucketSize = bucketSize(4, 512);
+	tessAllocator.regionBucketSize = bucketSize(4, 256);
+	cacheTess = tessNewTess( &tessAllocator );
 }
 
-	
 //----------------------------------------------------------
-void ofTessellator::tessellateToMesh( const vector<ofPolyline>& src, ofPolyWindingMode polyWindingMode, ofMesh & dstmesh, bool bIs2D ) {
+void ofTessellator::reset(){
+	// drops the tessellator together with everything in the arena
+	arena->reset();
+	cacheTess = nullptr;
+}
 
+//----------------------------------------------------------
+void ofTessellator::addContours( const vector<ofPolyline>& src, bool bIs2D ){
+	size_t numVertices = 0;
+	for ( auto & polyline: src ) {
+		numVertices += polyline.size();
+	}
+	begin( numVertices );
 
-	// pass vertex pointers to GLU tessellator
+	// pass vertex pointers to the tessellator
 	for ( int i=0; i<(int)src.size(); ++i ) {
 		if (src[i].size() > 0) {
 			ofPolyline& polyline = const_cast<ofPolyline&>(src[i]);
@@ -122,13 +214,30 @@ void ofTessellator::tessellateToMesh( const vector<ofPolyline>& src, ofPolyWindi
 			tessAddContour(cacheTess, bIs2D ? 2 : 3, &polyline.getVertices()[0].x, sizeof(glm::vec3), polyline.size());
 		}
 	}
+}
+
+//----------------------------------------------------------
+void ofTessellator::tessellateToMesh( const ofPolyline& src,  ofPolyWindingMode polyWindingMode, ofMesh& dstmesh, bool bIs2D){
+
+	begin( src.size() );
+	ofPolyline& polyline = const_cast<ofPolyline&>(src);
+	tessAddContour( cacheTess, bIs2D?2:3, &polyline.getVertices()[0], sizeof(glm::vec3), polyline.size());
 
 	performTessellation( polyWindingMode, dstmesh, bIs2D );
 }
 
+	
+//----------------------------------------------------------
+void ofTessellator::tessellateToMesh( const vector<ofPolyline>& src, ofPolyWindingMode polyWindingMode, ofMesh & dstmesh, bool bIs2D ) {
+
+	addContours( src, bIs2D );
+	performTessellation( polyWindingMode, dstmesh, bIs2D );
+}
+
 //----------------------------------------------------------
 void ofTessellator::tessellateToPolylines( const ofPolyline& src,  ofPolyWindingMode polyWindingMode, vector<ofPolyline>& dstpoly, bool bIs2D){
 
+	begin( src.size() );
 	if (src.size() > 0) {
 		ofPolyline& polyline = const_cast<ofPolyline&>(src);
 		tessAddContour(cacheTess, bIs2D ? 2 : 3, &polyline.getVertices()[0], sizeof(glm::vec3), polyline.size());
@@ -139,16 +248,7 @@ void ofTessellator::tessellateToPolylines( const ofPolyline& src,  ofPolyWinding
 
 //----------------------------------------------------------
 void ofTessellator::tessellateToPolylines( const vector<ofPolyline>& src, ofPolyWindingMode polyWindingMode, vector<ofPolyline>& dstpoly, bool bIs2D ) {
-
-	// pass vertex pointers to GLU tessellator
-	for ( int i=0; i<(int)src.size(); ++i ) {
-		if (src[i].size() > 0) {
-			ofPolyline& polyline = const_cast<ofPolyline&>(src[i]);
-
-			tessAddContour(cacheTess, bIs2D ? 2 : 3, &polyline.getVertices()[0].x, sizeof(glm::vec3), polyline.size());
-		}
-	}
-
+	addContours( src, bIs2D );
 	performTessellation( polyWindingMode, dstpoly, bIs2D );
 }
 
@@ -158,6 +258,7 @@ void ofTessellator::performTessellation(ofPolyWindingMode polyWindingMode, ofMes
 
 	if (!tessTesselate(cacheTess, polyWindingMode, TESS_POLYGONS, 3, 3, 0)){
 		ofLogError("ofTessellator") << "performTessellation(): mesh polygon tessellation failed, winding mode " << polyWindingMode;
+		reset();
 		return;
 	}
 
@@ -174,6 +275,7 @@ void ofTessellator::performTessellation(ofPolyWindingMode polyWindingMode, ofMes
 	}*/
 	dstmesh.setMode(OF_PRIMITIVE_TRIANGLES);
 
+	reset();
 }
 
 
@@ -181,6 +283,7 @@ void ofTessellator::performTessellation(ofPolyWindingMode polyWindingMode, ofMes
 void ofTessellator::performTessellation(ofPolyWindingMode polyWindingMode, vector<ofPolyline>& dstpoly, bool bIs2D ) {
 	if (!tessTesselate(cacheTess, polyWindingMode, TESS_BOUNDARY_CONTOURS, 0, 3, 0)){
 		ofLogError("ofTessellator") << "performTesselation(): polyline boundary contours tessellation failed, winding mode " << polyWindingMode;
+		reset();
 		return;
 	}
 
@@ -196,4 +299,208 @@ void ofTessellator::performTessellation(ofPolyWindingMode polyWindingMode, vecto
 			dstpoly[i].addVertices(&verts[b],n);
 			dstpoly[i].setClosed(true);
 	}
+
+	reset();
+}
+
+//----------------------------------------------------------
+struct ofTessellationCache::Entry{
+	uint64_t hash;
+	ofPolyWindingMode polyWindingMode;
+	bool bIs2D;
+	bool hasMesh;
+	bool hasPolylines;
+	// the contours this entry was tessellated from
+	vector<glm::vec3> points;
+	vector<size_t> sizes;
+
+	ofMesh mesh;
+	vector<ofPolyline> polylines;
+
+	bool matches(const vector<ofPolyline>& src, ofPolyWindingMode polyWindingMode, bool bIs2D, bool hasMesh, bool hasPolylines) const{
+		if(this->polyWindingMode != polyWindingMode || this->bIs2D != bIs2D || this->hasMesh != hasMesh || this->hasPolylines != hasPolylines){
+			return false;
+		}
+		size_t contour = 0;
+		size_t offset = 0;
+		for(auto & polyline: src){
+			auto & vertices = polyline.getVertices();
+			if(vertices.empty()) continue;
+			if(contour == sizes.size() || sizes[contour] != vertices.size() ||
+			   memcmp(&points[offset], &vertices[0], vertices.size() * sizeof(glm::vec3)) != 0){
+				return false;
+			}
+			offset += vertices.size();
+			contour++;
+		}
+		return contour == sizes.size();
+	}
+};
+
+//----------------------------------------------------------
+// fnv-1a over 32 bit words, empty contours are skipped like
+// ofTessellator does
+static uint64_t hashContours(const vector<ofPolyline>& src, ofPolyWindingMode polyWindingMode, bool bIs2D, bool hasMesh, bool hasPolylines){
+	const uint64_t prime = 1099511628211ull;
+	uint64_t hash = 14695981039346656037ull;
+	auto add = [&](uint32_t word){
+		hash = (hash ^ word) * prime;
+	};
+	add(uint32_t(polyWindingMode) | (bIs2D << 8) | (hasMesh << 9) | (hasPolylines << 10));
+	for(auto & polyline: src){
+		auto & vertices = polyline.getVertices();
+		if(vertices.empty()) continue;
+		add(uint32_t(vertices.size()));
+		auto words = reinterpret_cast<const uint32_t*>(&vertices[0]);
+		auto numWords = vertices.size() * sizeof(glm::vec3) / sizeof(uint32_t);
+		for(size_t i = 0; i < numWords; i++){
+			add(words[i]);
+		}
+	}
+	// fnv mixes the low bits poorly, finish with a murmur like avalanche
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdull;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+//----------------------------------------------------------
+static void copyTessellation(const ofMesh & src, ofMesh & dst){
+	dst.clear();
+	dst.addVertices(src.getVertices());
+	dst.addIndices(src.getIndices());
+	dst.setMode(OF_PRIMITIVE_TRIANGLES);
+}
+
+//----------------------------------------------------------
+static uint64_t microsSince(chrono::steady_clock::time_point start){
+	return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+}
+
+//----------------------------------------------------------
+ofTessellationCache::ofTessellationCache(size_t maxEntries)
+:maxEntries(maxEntries)
+,hits(0)
+,misses(0)
+,tessellationTime(0)
+,lookupTime(0){
+}
+
+//----------------------------------------------------------
+bool ofTessellationCache::tessellate( ofTessellator & tessellator, const vector<ofPolyline>& src, ofPolyWindingMode polyWindingMode, ofMesh * dstmesh, vector<ofPolyline> * dstpoly, bool bIs2D ){
+	auto start = chrono::steady_clock::now();
+	auto hash = hashContours(src, polyWindingMode, bIs2D, dstmesh != nullptr, dstpoly != nullptr);
+
+	shared_ptr<const Entry> entry;
+	{
+		lock_guard<std::mutex> lock(mutex);
+		auto found = entriesByHash.find(hash);
+		if(found != entriesByHash.end()){
+			entries.splice(entries.begin(), entries, found->second);
+			entry = *found->second;
+		}
+	}
+
+	// entries are never modified once they are in the cache so they can
+	// be compared and copied without holding the lock
+	if(entry && entry->matches(src, polyWindingMode, bIs2D, dstmesh != nullptr, dstpoly != nullptr)){
+		if(dstmesh) copyTessellation(entry->mesh, *dstmesh);
+		if(dstpoly) *dstpoly = entry->polylines;
+		hits++;
+		lookupTime += microsSince(start);
+		return true;
+	}
+
+	auto newEntry = make_shared<Entry>();
+	newEntry->hash = hash;
+	newEntry->polyWindingMode = polyWindingMode;
+	newEntry->bIs2D = bIs2D;
+	newEntry->hasMesh = dstmesh != nullptr;
+	newEntry->hasPolylines = dstpoly != nullptr;
+	for(auto & polyline: src){
+		auto & vertices = polyline.getVertices();
+		if(vertices.empty()) continue;
+		newEntry->points.insert(newEntry->points.end(), vertices.begin(), vertices.end());
+		newEntry->sizes.push_back(vertices.size());
+	}
+
+	start = chrono::steady_clock::now();
+	if(dstmesh){
+		tessellator.tessellateToMesh(src, polyWindingMode, newEntry->mesh, bIs2D);
+		copyTessellation(newEntry->mesh, *dstmesh);
+	}
+	if(dstpoly){
+		tessellator.tessellateToPolylines(src, polyWindingMode, newEntry->polylines, bIs2D);
+		*dstpoly = newEntry->polylines;
+	}
+	misses++;
+	tessellationTime += microsSince(start);
+
+	lock_guard<std::mutex> lock(mutex);
+	if(maxEntries == 0){
+		return false;
+	}
+	auto found = entriesByHash.find(hash);
+	if(found != entriesByHash.end()){
+		// same hash but different contours or already added by another thread
+		*found->second = newEntry;
+		entries.splice(entries.begin(), entries, found->second);
+	}else{
+		entries.push_front(newEntry);
+		entriesByHash[hash] = entries.begin();
+		while(entries.size() > maxEntries){
+			entriesByHash.erase(entries.back()->hash);
+			entries.pop_back();
+		}
+	}
+	return false;
+}
+
+//----------------------------------------------------------
+void ofTessellationCache::clear(){
+	lock_guard<std::mutex> lock(mutex);
+	entries.clear();
+	entriesByHash.clear();
+}
+
+//----------------------------------------------------------
+void ofTessellationCache::setMaxEntries(size_t maxEntries){
+	lock_guard<std::mutex> lock(mutex);
+	this->maxEntries = maxEntries;
+	while(entries.size() > maxEntries){
+		entriesByHash.erase(entries.back()->hash);
+		entries.pop_back();
+	}
+}
+
+//----------------------------------------------------------
+size_t ofTessellationCache::getMaxEntries() const{
+	lock_guard<std::mutex> lock(mutex);
+	return maxEntries;
+}
+
+//----------------------------------------------------------
+ofTessellationCacheStats ofTessellationCache::getStats() const{
+	ofTessellationCacheStats stats;
+	stats.hits = hits;
+	stats.misses = misses;
+	stats.tessellationTime = tessellationTime;
+	stats.lookupTime = lookupTime;
+	lock_guard<std::mutex> lock(mutex);
+	stats.numEntries = entries.size();
+	return stats;
+}
+
+//----------------------------------------------------------
+void ofTessellationCache::resetStats(){
+	hits = 0;
+	misses = 0;
+	tessellationTime = 0;
+	lookupTime = 0;
+}
+
+//----------------------------------------------------------
+ofTessellationCache & ofGetTessellationCache(){
+	static ofTessellationCache cache;
+	return cache;
 }
@@ -2,11 +2,22 @@
 
 #include "ofConstants.h"
 #include "ofGraphicsBaseTypes.h"
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 
 typedef struct TESStesselator TESStesselator;
 typedef struct TESSalloc TESSalloc;
 
+namespace of{
+namespace priv{
+	struct TessellatorArena;
+}
+}
+
 /// \brief
 /// ofTessellator exists for one purpose: to turn ofPolylines into ofMeshes so
 /// that they can be more efficiently displayed using OpenGL. The ofPath class
@@ -22,6 +33,10 @@ typedef struct TESSalloc TESSalloc;
 /// shown on the right.
 /// 
 /// ![tessellation](graphics/tessellation.jpg)
+///
+/// Every ofTessellator allocates the memory libtess2 needs from its own
+/// arena which is reused from one tessellation to the next, so different
+/// instances can be used at the same time from different threads.
 class ofTessellator
 {
 public:	
@@ -50,13 +65,79 @@ public:
 	void tessellateToPolylines( const ofPolyline & src, ofPolyWindingMode polyWindingMode, std::vector<ofPolyline>& dstpoly, bool bIs2D=false );
 
 private:
-	
+	void addContours( const std::vector<ofPolyline>& src, bool bIs2D );
 	void performTessellation( ofPolyWindingMode polyWindingMode, ofMesh& dstmesh, bool bIs2D );
 	void performTessellation(ofPolyWindingMode polyWindingMode, std::vector<ofPolyline>& dstpoly, bool bIs2D );
 	void init();
+	void begin(size_t numVertices);
+	void reset();
 
+	std::unique_ptr<of::priv::TessellatorArena> arena;
 	TESStesselator * cacheTess;
 	TESSalloc tessAllocator;
 };
 
+/// \brief statistics of an ofTessellationCache
+struct ofTessellationCacheStats{
+	uint64_t hits = 0; //< tessellations reused from the cache
+	uint64_t misses = 0; //< tessellations that had to be computed
+	uint64_t tessellationTime = 0; //< microseconds spent tessellating the misses
+	uint64_t lookupTime = 0; //< microseconds spent hashing, comparing and copying the hits
+	size_t numEntries = 0; //< number of tessellations in the cache
+};
+
+/// \brief Keeps the results of recent tessellations so shapes that are
+/// tessellated again with the same contours and winding mode reuse them
+/// instead of going through libtess2.
+///
+/// Entries are found by a hash of the contours and then compared point by
+/// point so a collision can never return the wrong mesh. When the cache is
+/// full the least recently used entry is dropped.
+///
+/// ofPath uses the cache returned by ofGetTessellationCache() when
+/// ofPath::setUseTessellationCache() is enabled. It can be used from
+/// several threads at the same time.
+class ofTessellationCache{
+public:
+	/// \param maxEntries Number of tessellations to keep.
+	explicit ofTessellationCache(size_t maxEntries = 4096);
+
+	ofTessellationCache(const ofTessellationCache &) = delete;
+	ofTessellationCache & operator=(const ofTessellationCache &) = delete;
+
+	/// \brief Get the tessellation of src from the cache or compute it with
+	/// tessellator and store it.
+	///
+	/// \param dstmesh Filled triangles, can be nullptr if not needed.
+	/// \param dstpoly Boundary contours, can be nullptr if not needed.
+	/// \returns true if the result came from the cache.
+	bool tessellate( ofTessellator & tessellator, const std::vector<ofPolyline>& src, ofPolyWindingMode polyWindingMode, ofMesh * dstmesh, std::vector<ofPolyline> * dstpoly, bool bIs2D=false );
+
+	/// \brief Remove every entry, the stats are kept.
+	void clear();
+
+	void setMaxEntries(size_t maxEntries);
+	size_t getMaxEntries() const;
+
+	ofTessellationCacheStats getStats() const;
+	void resetStats();
+
+private:
+	struct Entry;
+	typedef std::list<std::shared_ptr<const Entry>> EntryList;
+
+	mutable std::mutex mutex;
+	EntryList entries; // most recently used first
+	std::unordered_map<uint64_t, EntryList::iterator> entriesByHash;
+	size_t maxEntries;
+
+	std::atomic<uint64_t> hits;
+	std::atomic<uint64_t> misses;
+	std::atomic<uint64_t> tessellationTime;
+	std::atomic<uint64_t> lookupTime;
+};
+
+/// \brief The tessellation cache shared by every ofPath.
+ofTessellationCache & ofGetTessellationCache();
+
 
@@ -15,9 +15,11 @@
 #if !defined(TARGET_EMSCRIPTEN)
 #include "ofThread.h"
 #include "ofThreadChannel.h"
+#include "ofTaskPool.h"
 #endif
 
 #include "ofFpsCounter.h"
+#include "ofFrameProfiler.h"
 #include "ofJson.h"
 #include "ofXml.h"
 
@@ -111,6 +113,7 @@
 #include "ofEasyCam.h"
 #include "ofMesh.h"
 #include "ofNode.h"
+#include "ofTransformStore.h"
 
 //--------------------------
 using namespace std;
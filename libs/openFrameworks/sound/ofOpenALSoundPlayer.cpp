@@ -115,6 +115,7 @@ static string getMpg123EncodingString(int encoding) {
 #endif
 
 #define BUFFER_STREAM_SIZE 4096
+#define NUM_STREAM_BUFFERS 4
 
 // now, the individual sound player:
 //------------------------------------------------------------
@@ -134,6 +135,12 @@ ofOpenALSoundPlayer::ofOpenALSoundPlayer(){
 #ifdef OF_USING_MPG123
 	mp3streamf		= 0;
 #endif
+	streamFrames	= 0;
+	streamDecodePosition = 0;
+	streamEnd		= false;
+	streamRestart	= false;
+	streamRestartFrame = 0;
+	streamRestartState = AL_STOPPED;
 	players().insert(this);
 }
 
@@ -186,7 +193,7 @@ void ofOpenALSoundPlayer::close(){
 }
 
 // ----------------------------------------------------------------------------
-bool ofOpenALSoundPlayer::sfReadFile(const std::filesystem::path& path, vector<short> & buffer, vector<float> & fftAuxBuffer){
+bool ofOpenALSoundPlayer::sfReadFile(const std::filesystem::path& path, vector<short> & buffer){
 	SF_INFO sfInfo;
 	SNDFILE* f = sf_open(path.c_str(),SFM_READ,&sfInfo);
 	if(!f){
@@ -194,43 +201,18 @@ bool ofOpenALSoundPlayer::sfReadFile(const std::filesystem::path& path, vector<s
 		return false;
 	}
 
+	// float and double files are converted by libsndfile, clipping
+	// instead of wrapping around if they go over full scale
+	sf_command(f, SFC_SET_CLIPPING, nullptr, SF_TRUE);
+
 	buffer.resize(sfInfo.frames*sfInfo.channels);
-	fftAuxBuffer.resize(sfInfo.frames*sfInfo.channels);
-
-	int subformat = sfInfo.format & SF_FORMAT_SUBMASK ;
-	if (subformat == SF_FORMAT_FLOAT || subformat == SF_FORMAT_DOUBLE){
-		double	scale ;
-		sf_command (f, SFC_CALC_SIGNAL_MAX, &scale, sizeof (scale)) ;
-		if (scale < 1e-10)
-			scale = 1.0 ;
-		else
-			scale = 32700.0 / scale ;
-
-		sf_count_t samples_read = sf_read_float (f, &fftAuxBuffer[0], fftAuxBuffer.size());
-		if(samples_read<(int)fftAuxBuffer.size()){
-			ofLogWarning("ofOpenALSoundPlayer") << "sfReadFile(): read " << samples_read << " float samples, expected "
-			<< fftAuxBuffer.size() << " for \"" << path << "\"";
-		}
-		for (int i = 0 ; i < int(fftAuxBuffer.size()) ; i++){
-			fftAuxBuffer[i] *= scale ;
-			buffer[i] = 32565.0 * fftAuxBuffer[i];
-		}
-	}else{
-		sf_count_t frames_read = sf_readf_short(f,&buffer[0],sfInfo.frames);
-		if(frames_read<sfInfo.frames){
-			ofLogError("ofOpenALSoundPlayer") << "sfReadFile(): read " << frames_read << " frames from buffer, expected "
-			<< sfInfo.frames << " for \"" << path << "\"";
-			return false;
-		}
-		sf_seek(f,0,SEEK_SET);
-		frames_read = sf_readf_float(f,&fftAuxBuffer[0],sfInfo.frames);
-		if(frames_read<sfInfo.frames){
-			ofLogError("ofOpenALSoundPlayer") << "sfReadFile(): read " << frames_read << " frames from fft buffer, expected "
-			<< sfInfo.frames << " for \"" << path << "\"";
-			return false;
-		}
-	}
+	sf_count_t frames_read = sf_readf_short(f,buffer.data(),sfInfo.frames);
 	sf_close(f);
+	if(frames_read<sfInfo.frames){
+		ofLogError("ofOpenALSoundPlayer") << "sfReadFile(): read " << frames_read << " frames from buffer, expected "
+		<< sfInfo.frames << " for \"" << path << "\"";
+		return false;
+	}
 
 	channels = sfInfo.channels;
 	duration = float(sfInfo.frames) / float(sfInfo.samplerate);
@@ -240,10 +222,11 @@ bool ofOpenALSoundPlayer::sfReadFile(const std::filesystem::path& path, vector<s
 
 #ifdef OF_USING_MPG123
 //------------------------------------------------------------
-bool ofOpenALSoundPlayer::mpg123ReadFile(const std::filesystem::path& path,vector<short> & buffer,vector<float> & fftAuxBuffer){
+bool ofOpenALSoundPlayer::mpg123ReadFile(const std::filesystem::path& path,vector<short> & buffer){
 	int err = MPG123_OK;
 	mpg123_handle * f = mpg123_new(nullptr,&err);
 	if(mpg123_open(f,path.c_str())!=MPG123_OK){
+		mpg123_delete(f);
 		ofLogError("ofOpenALSoundPlayer") << "mpg123ReadFile(): couldn't read \"" << path << "\"";
 		return false;
 	}
@@ -252,12 +235,21 @@ bool ofOpenALSoundPlayer::mpg123ReadFile(const std::filesystem::path& path,vecto
 	long int rate;
 	mpg123_getformat(f,&rate,&channels,(int*)&encoding);
 	if(encoding!=MPG123_ENC_SIGNED_16){
+		mpg123_close(f);
+		mpg123_delete(f);
 		ofLogError("ofOpenALSoundPlayer") << "mpg123ReadFile(): " << getMpg123EncodingString(encoding)
 			<< " encoding for \"" << path << "\"" << " unsupported, expecting MPG123_ENC_SIGNED_16";
 		return false;
 	}
 	samplerate = rate;
 
+	// reserve the whole file up front when mpg123 can tell its length
+	mpg123_scan(f);
+	off_t frames = mpg123_length(f);
+	if(frames>0){
+		buffer.reserve(frames*channels);
+	}
+
 	size_t done=0;
 	size_t buffer_size = mpg123_outblock( f );
 	buffer.resize(buffer_size/2);
@@ -268,170 +260,297 @@ bool ofOpenALSoundPlayer::mpg123ReadFile(const std::filesystem::path& path,vecto
 	mpg123_close(f);
 	mpg123_delete(f);
 
-	fftAuxBuffer.resize(buffer.size());
-	for(int i=0;i<(int)buffer.size();i++){
-		fftAuxBuffer[i] = float(buffer[i])/32565.f;
-	}
 	duration = float(buffer.size()/channels) / float(samplerate);
 	return true;
 }
 #endif
 
 //------------------------------------------------------------
-bool ofOpenALSoundPlayer::sfStream(const std::filesystem::path& path,vector<short> & buffer,vector<float> & fftAuxBuffer){
-	if(!streamf){
-		SF_INFO sfInfo;
-		streamf = sf_open(path.c_str(),SFM_READ,&sfInfo);
-		if(!streamf){
-			ofLogError("ofOpenALSoundPlayer") << "sfStream(): couldn't read \"" << path << "\"";
-			return false;
-		}
-
-		stream_subformat = sfInfo.format & SF_FORMAT_SUBMASK ;
-		if (stream_subformat == SF_FORMAT_FLOAT || stream_subformat == SF_FORMAT_DOUBLE){
-			sf_command (streamf, SFC_CALC_SIGNAL_MAX, &stream_scale, sizeof (stream_scale)) ;
-			if (stream_scale < 1e-10)
-				stream_scale = 1.0 ;
-			else
-				stream_scale = 32700.0 / stream_scale ;
-		}
-		channels = sfInfo.channels;
-		duration = float(sfInfo.frames) / float(sfInfo.samplerate);
-		samplerate = sfInfo.samplerate;
-		stream_samples_read = 0;
-	}
-
-	int curr_buffer_size = BUFFER_STREAM_SIZE*channels;
-	if(speed>1) curr_buffer_size *= (int)round(speed);
-	buffer.resize(curr_buffer_size);
-	fftAuxBuffer.resize(buffer.size());
-	if (stream_subformat == SF_FORMAT_FLOAT || stream_subformat == SF_FORMAT_DOUBLE){
-		sf_count_t samples_read = sf_read_float (streamf, &fftAuxBuffer[0], fftAuxBuffer.size());
-		stream_samples_read += samples_read;
-		if(samples_read<(int)fftAuxBuffer.size()){
-			fftAuxBuffer.resize(samples_read);
-			buffer.resize(samples_read);
-			setPosition(0);
-			if(!bLoop) stopThread();
-			stream_samples_read = 0;
-			stream_end = true;
-		}
-		for (int i = 0 ; i < int(fftAuxBuffer.size()) ; i++){
-			fftAuxBuffer[i] *= stream_scale ;
-			buffer[i] = 32565.0 * fftAuxBuffer[i];
-		}
-	}else{
-		sf_count_t frames_read = sf_readf_short(streamf,&buffer[0],curr_buffer_size/channels);
-		stream_samples_read += frames_read*channels;
-		if(frames_read<curr_buffer_size/channels){
-			fftAuxBuffer.resize(frames_read*channels);
-			buffer.resize(frames_read*channels);
-			setPosition(0);
-			if(!bLoop) stopThread();
-			stream_samples_read = 0;
-			stream_end = true;
-		}
-		for(int i=0;i<(int)buffer.size();i++){
-			fftAuxBuffer[i]=float(buffer[i])/32565.0f;
-		}
+bool ofOpenALSoundPlayer::readFile(const std::filesystem::path& fileName, vector<short> & buffer){
+#ifdef OF_USING_MPG123
+	if(ofFilePath::getFileExt(fileName)=="mp3" || ofFilePath::getFileExt(fileName)=="MP3"){
+		return mpg123ReadFile(fileName,buffer);
 	}
-
-	return true;
+#endif
+	return sfReadFile(fileName,buffer);
 }
 
-#ifdef OF_USING_MPG123
 //------------------------------------------------------------
-bool ofOpenALSoundPlayer::mpg123Stream(const std::filesystem::path& path,vector<short> & buffer,vector<float> & fftAuxBuffer){
-	if(!mp3streamf){
+bool ofOpenALSoundPlayer::openStream(const std::filesystem::path& fileName){
+	streamFrames = 0;
+	streamDecodePosition = 0;
+	streamEnd = false;
+#ifdef OF_USING_MPG123
+	if(ofFilePath::getFileExt(fileName)=="mp3" || ofFilePath::getFileExt(fileName)=="MP3"){
 		int err = MPG123_OK;
 		mp3streamf = mpg123_new(nullptr,&err);
-		if(mpg123_open(mp3streamf,path.c_str())!=MPG123_OK){
-			mpg123_close(mp3streamf);
+		if(mpg123_open(mp3streamf,fileName.c_str())!=MPG123_OK){
 			mpg123_delete(mp3streamf);
-			ofLogError("ofOpenALSoundPlayer") << "mpg123Stream(): couldn't read \"" << path << "\"";
+			mp3streamf = 0;
+			ofLogError("ofOpenALSoundPlayer") << "openStream(): couldn't read \"" << fileName << "\"";
 			return false;
 		}
 
+		int encoding;
 		long int rate;
-		mpg123_getformat(mp3streamf,&rate,&channels,(int*)&stream_encoding);
-		if(stream_encoding!=MPG123_ENC_SIGNED_16){
-			ofLogError("ofOpenALSoundPlayer") << "mpg123Stream(): " << getMpg123EncodingString(stream_encoding)
-			<< " encoding for \"" << path << "\"" << " unsupported, expecting MPG123_ENC_SIGNED_16";
+		mpg123_getformat(mp3streamf,&rate,&channels,&encoding);
+		if(encoding!=MPG123_ENC_SIGNED_16){
+			ofLogError("ofOpenALSoundPlayer") << "openStream(): " << getMpg123EncodingString(encoding)
+			<< " encoding for \"" << fileName << "\"" << " unsupported, expecting MPG123_ENC_SIGNED_16";
+			closeStream();
 			return false;
 		}
 		samplerate = rate;
-		mp3_buffer_size = mpg123_outblock( mp3streamf );
-
 
-		mpg123_seek(mp3streamf,0,SEEK_END);
-		off_t samples = mpg123_tell(mp3streamf);
-		duration = float(samples/channels) / float(samplerate);
-		mpg123_seek(mp3streamf,0,SEEK_SET);
+		// scanning builds the seek index so seeking later doesn't need to
+		// decode from the start, and gives an exact length in frames
+		mpg123_scan(mp3streamf);
+		off_t frames = mpg123_length(mp3streamf);
+		streamFrames = frames>0 ? frames : 0;
+	}else
+#endif
+	{
+		SF_INFO sfInfo;
+		streamf = sf_open(fileName.c_str(),SFM_READ,&sfInfo);
+		if(!streamf){
+			ofLogError("ofOpenALSoundPlayer") << "openStream(): couldn't read \"" << fileName << "\"";
+			return false;
+		}
+		sf_command(streamf, SFC_SET_CLIPPING, nullptr, SF_TRUE);
+		channels = sfInfo.channels;
+		samplerate = sfInfo.samplerate;
+		streamFrames = sfInfo.frames;
 	}
+	duration = float(streamFrames) / float(samplerate);
+	return true;
+}
 
-	int curr_buffer_size = mp3_buffer_size;
-	if(speed>1) curr_buffer_size *= (int)round(speed);
-	buffer.resize(curr_buffer_size);
-	fftAuxBuffer.resize(buffer.size());
-	size_t done=0;
-	if(mpg123_read(mp3streamf,(unsigned char*)&buffer[0],curr_buffer_size*2,&done)==MPG123_DONE){
-		setPosition(0);
-		buffer.resize(done/2);
-		fftAuxBuffer.resize(done/2);
-		if(!bLoop) stopThread();
-		stream_end = true;
+//------------------------------------------------------------
+size_t ofOpenALSoundPlayer::readStream(short * samples, size_t frames){
+	size_t framesRead = 0;
+#ifdef OF_USING_MPG123
+	if(mp3streamf){
+		// mpg123 can return less than asked before the end of the file
+		while(framesRead<frames){
+			size_t done = 0;
+			size_t bytes = (frames-framesRead)*channels*sizeof(short);
+			int ret = mpg123_read(mp3streamf,(unsigned char*)(samples+framesRead*channels),bytes,&done);
+			framesRead += done/(channels*sizeof(short));
+			if(ret!=MPG123_OK || done==0) break;
+		}
+	}else
+#endif
+	if(streamf){
+		sf_count_t read = sf_readf_short(streamf,samples,frames);
+		framesRead = read>0 ? read : 0;
 	}
+	streamDecodePosition += framesRead;
+	return framesRead;
+}
 
-
-	for(int i=0;i<(int)buffer.size();i++){
-		fftAuxBuffer[i] = float(buffer[i])/32565.f;
+//------------------------------------------------------------
+bool ofOpenALSoundPlayer::seekStream(uint64_t frame){
+	bool ok = false;
+#ifdef OF_USING_MPG123
+	if(mp3streamf){
+		ok = mpg123_seek(mp3streamf,frame,SEEK_SET)>=0;
+	}else
+#endif
+	if(streamf){
+		ok = sf_seek(streamf,frame,SEEK_SET)>=0;
 	}
-
-	return true;
+	if(ok){
+		streamDecodePosition = frame;
+	}else{
+		ofLogError("ofOpenALSoundPlayer") << "seekStream(): couldn't seek to frame " << frame;
+	}
+	return ok;
 }
-#endif
 
 //------------------------------------------------------------
-bool ofOpenALSoundPlayer::stream(const std::filesystem::path& fileName, vector<short> & buffer){
+void ofOpenALSoundPlayer::closeStream(){
 #ifdef OF_USING_MPG123
-	if(ofFilePath::getFileExt(fileName)=="mp3" || ofFilePath::getFileExt(fileName)=="MP3" || mp3streamf){
-		if(!mpg123Stream(fileName,buffer,fftAuxBuffer)) return false;
-	}else
+	if(mp3streamf){
+		mpg123_close(mp3streamf);
+		mpg123_delete(mp3streamf);
+	}
+	mp3streamf = 0;
 #endif
-		if(!sfStream(fileName,buffer,fftAuxBuffer)) return false;
 
-	fftBuffers.resize(channels);
-	int numFrames = buffer.size()/channels;
+	if(streamf){
+		sf_close(streamf);
+	}
+	streamf = 0;
+	streamQueue.clear();
+	streamFreeChunks.clear();
+	streamFreeBuffers.clear();
+	streamRestart = false;
+}
 
+//------------------------------------------------------------
+bool ofOpenALSoundPlayer::decodeStreamChunk(StreamChunk & chunk){
+	size_t frames = BUFFER_STREAM_SIZE;
+	if(speed>1) frames *= (size_t)round(speed);
+	chunk.samples.resize(frames*channels);
+	chunk.firstFrame = streamDecodePosition;
+	size_t framesRead = readStream(chunk.samples.data(),frames);
+	if(framesRead==0 && bLoop && streamDecodePosition>0 && seekStream(0)){
+		// chunks never wrap around so their first frame is enough to
+		// know where every sample in them is
+		chunk.firstFrame = 0;
+		framesRead = readStream(chunk.samples.data(),frames);
+	}
+	chunk.samples.resize(framesRead*channels);
+	if(framesRead==0 || (framesRead<frames && !bLoop)){
+		streamEnd = true;
+	}
+	return framesRead>0;
+}
+
+//------------------------------------------------------------
+void ofOpenALSoundPlayer::uploadStreamChunk(const StreamChunk & chunk, const ALuint * chunkBuffers){
+	size_t frames = chunk.samples.size()/channels;
+	if(channels==1){
+		alBufferData(chunkBuffers[0],AL_FORMAT_MONO16,chunk.samples.data(),frames*sizeof(short),samplerate);
+		return;
+	}
+	// every channel plays on its own source for panning
+	streamChannelBuffer.resize(frames);
 	for(int i=0;i<channels;i++){
-		fftBuffers[i].resize(numFrames);
-		for(int j=0;j<numFrames;j++){
-			fftBuffers[i][j] = fftAuxBuffer[j*channels+i];
+		for(size_t j=0;j<frames;j++){
+			streamChannelBuffer[j] = chunk.samples[j*channels+i];
 		}
+		alBufferData(chunkBuffers[i],AL_FORMAT_MONO16,streamChannelBuffer.data(),frames*sizeof(short),samplerate);
 	}
-	return true;
 }
 
-bool ofOpenALSoundPlayer::readFile(const std::filesystem::path& fileName, vector<short> & buffer){
-#ifdef OF_USING_MPG123
-	if(ofFilePath::getFileExt(fileName)!="mp3" && ofFilePath::getFileExt(fileName)!="MP3"){
-		if(!sfReadFile(fileName,buffer,fftAuxBuffer)) return false;
-	}else{
-		if(!mpg123ReadFile(fileName,buffer,fftAuxBuffer)) return false;
+//------------------------------------------------------------
+// called with the mutex locked, stops the sources and frees every
+// chunk and buffer, keeping the memory of the chunks to decode into
+void ofOpenALSoundPlayer::clearStream(){
+	alSourceStopv(channels,&sources[0]);
+	// detaching the buffers unqueues them, processed or not
+	for(int i=0;i<channels;i++){
+		alSourcei(sources[i],AL_BUFFER,0);
 	}
-#else
-	if(!sfReadFile(fileName,buffer,fftAuxBuffer)) return false;
-#endif
-	fftBuffers.resize(channels);
-	int numFrames = buffer.size()/channels;
+	std::move(streamQueue.begin(),streamQueue.end(),std::back_inserter(streamFreeChunks));
+	streamQueue.clear();
+	streamFreeChunks.resize(NUM_STREAM_BUFFERS);
+	streamFreeBuffers = buffers;
+}
 
-	for(int i=0;i<channels;i++){
-		fftBuffers[i].resize(numFrames);
-		for(int j=0;j<numFrames;j++){
-			fftBuffers[i][j] = fftAuxBuffer[j*channels+i];
+//------------------------------------------------------------
+// called with the mutex locked, the streaming thread seeks to frame
+// and fills the queue again before setting the sources to state
+void ofOpenALSoundPlayer::requestStreamRestart(uint64_t frame, int state){
+	if(streamFrames>0 && frame>=streamFrames){
+		frame = bLoop ? 0 : streamFrames;
+	}
+	streamRestart = true;
+	streamRestartFrame = frame;
+	streamRestartState = state;
+}
+
+//------------------------------------------------------------
+// called from the streaming thread, decodes into the free chunks, in
+// order, and uploads them to their buffers. none of them is queued so
+// this doesn't need the mutex. returns how many are ready to be queued
+size_t ofOpenALSoundPlayer::decodeFreeStreamChunks(){
+	size_t ready = 0;
+	for(;ready<streamFreeChunks.size() && !streamEnd;ready++){
+		if(!decodeStreamChunk(streamFreeChunks[ready])) break;
+		uploadStreamChunk(streamFreeChunks[ready],&streamFreeBuffers[ready*channels]);
+	}
+	return ready;
+}
+
+//------------------------------------------------------------
+// called with the mutex locked from the streaming thread
+void ofOpenALSoundPlayer::queueFreeStreamChunks(size_t numChunks){
+	for(size_t i=0;i<numChunks;i++){
+		for(int j=0;j<channels;j++){
+			alSourceQueueBuffers(sources[j],1,&streamFreeBuffers[i*channels+j]);
 		}
+		streamQueue.push_back(std::move(streamFreeChunks[i]));
+	}
+	streamFreeChunks.erase(streamFreeChunks.begin(),streamFreeChunks.begin()+numChunks);
+	streamFreeBuffers.erase(streamFreeBuffers.begin(),streamFreeBuffers.begin()+numChunks*channels);
+}
+
+//------------------------------------------------------------
+// called from the streaming thread, refills the buffers openal is done
+// with or, after a seek, all of them. the mutex is only locked to
+// unqueue and queue buffers, decoding happens in between without it.
+// stops the thread once the stream has finished playing
+void ofOpenALSoundPlayer::updateStream(){
+	bool restart;
+	uint64_t restartFrame = 0;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		restart = streamRestart;
+		if(restart){
+			restartFrame = streamRestartFrame;
+			clearStream();
+		}else{
+			// all the channels play in sync but one of them might be a
+			// buffer ahead while the others catch up
+			int processed = NUM_STREAM_BUFFERS;
+			for(int i=0;i<channels;i++){
+				ALint channelProcessed;
+				alGetSourcei(sources[i],AL_BUFFERS_PROCESSED,&channelProcessed);
+				processed = std::min(processed,int(channelProcessed));
+			}
+			for(;processed>0 && !streamQueue.empty();processed--){
+				streamFreeBuffers.resize(streamFreeBuffers.size()+channels);
+				for(int i=0;i<channels;i++){
+					alSourceUnqueueBuffers(sources[i],1,&streamFreeBuffers[streamFreeBuffers.size()-channels+i]);
+				}
+				// reuse the memory of the chunk that just finished playing
+				streamFreeChunks.push_back(std::move(streamQueue.front()));
+				streamQueue.pop_front();
+			}
+		}
+	}
+
+	if(restart){
+		streamEnd = !seekStream(restartFrame);
+	}
+	size_t ready = decodeFreeStreamChunks();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	if(streamRestart && (!restart || streamRestartFrame!=restartFrame)){
+		// seeked again while decoding, the next update starts over
+		return;
+	}
+	queueFreeStreamChunks(ready);
+
+	ALint state;
+	if(restart){
+		streamRestart = false;
+		state = streamRestartState;
+		if(state==AL_PLAYING || state==AL_PAUSED){
+			alSourcePlayv(channels,&sources[0]);
+		}
+		if(state==AL_PAUSED){
+			alSourcePausev(channels,&sources[0]);
+		}
+		// the thread is started again on play or unpause, stopping
+		// it with the mutex locked so those see it's not running
+		if(state!=AL_PLAYING){
+			stopThread();
+		}
+		return;
+	}
+
+	alGetSourcei(sources[0],AL_SOURCE_STATE,&state);
+	if(state!=AL_PLAYING && state!=AL_PAUSED){
+		if(streamQueue.empty()){
+			stopThread();
+			return;
+		}
+		// the decoder couldn't keep up and openal ran out of buffers
+		alSourcePlayv(channels,&sources[0]);
 	}
-	return true;
 }
 
 //------------------------------------------------------------
@@ -440,7 +559,6 @@ bool ofOpenALSoundPlayer::load(const std::filesystem::path& _fileName, bool is_s
 	std::filesystem::path fileName = ofToDataPath(_fileName);
 
 	bMultiPlay = false;
-	isStreaming = is_stream;
 	int err = AL_NO_ERROR;
 
 	// [1] init sound systems, if necessary
@@ -451,19 +569,22 @@ bool ofOpenALSoundPlayer::load(const std::filesystem::path& _fileName, bool is_s
 	// if they call "loadSound" repeatedly, for example
 
 	unload();
+	isStreaming = is_stream;
 	ALenum format=AL_FORMAT_MONO16;
 	bLoadedOk = false;
 
+	// streams are only opened here, the buffers are filled on play
 	if(!isStreaming){
-		readFile(fileName, buffer);
+		if(!readFile(fileName, buffer)) return false;
 	}else{
-		stream(fileName, buffer);
+		buffer.clear();
+		if(!openStream(fileName)) return false;
 	}
 
 	int numFrames = buffer.size()/channels;
 
 	if(isStreaming){
-		buffers.resize(channels*2);
+		buffers.resize(channels*NUM_STREAM_BUFFERS);
 	}else{
 		buffers.resize(channels);
 	}
@@ -479,22 +600,15 @@ bool ofOpenALSoundPlayer::load(const std::filesystem::path& _fileName, bool is_s
 			return false;
 		}
 
-		for(int i=0; i<(int)buffers.size(); i++){
+		if(!isStreaming){
 			alGetError(); // Clear error.
-			alBufferData(buffers[i],format,&buffer[0],buffer.size()*2,samplerate);
+			alBufferData(buffers[0],format,&buffer[0],buffer.size()*2,samplerate);
 			err = alGetError();
 			if (err != AL_NO_ERROR){
 				ofLogError("ofOpenALSoundPlayer:") << "loadSound(): couldn't create buffer for \"" << fileName << "\": "
 				<< (int) err << " " << getALErrorString(err);
 				return false;
 			}
-			if(isStreaming){
-				stream(fileName,buffer);
-			}
-		}
-		if(isStreaming){
-			alSourceQueueBuffers(sources[0],buffers.size(),&buffers[0]);
-		}else{
 			alSourcei (sources[0], AL_BUFFER,   buffers[0]);
 		}
 
@@ -507,25 +621,7 @@ bool ofOpenALSoundPlayer::load(const std::filesystem::path& _fileName, bool is_s
 		multibuffer.resize(channels);
 		sources.resize(channels);
 		alGenSources(channels, &sources[0]);
-		if(isStreaming){
-			for(int s=0; s<2;s++){
-				for(int i=0;i<channels;i++){
-					multibuffer[i].resize(buffer.size()/channels);
-					for(int j=0;j<numFrames;j++){
-						multibuffer[i][j] = buffer[j*channels+i];
-					}
-					alGetError(); // Clear error.
-					alBufferData(buffers[s*2+i],format,&multibuffer[i][0],buffer.size()/channels*2,samplerate);
-					err = alGetError();
-					if ( err != AL_NO_ERROR){
-						ofLogError("ofOpenALSoundPlayer") << "loadSound(): couldn't create stereo buffers for \"" << fileName << "\": " << (int) err << " " << getALErrorString(err);
-						return false;
-					}
-					alSourceQueueBuffers(sources[i],1,&buffers[s*2+i]);
-					stream(fileName,buffer);
-				}
-			}
-		}else{
+		if(!isStreaming){
 			for(int i=0;i<channels;i++){
 				multibuffer[i].resize(buffer.size()/channels);
 				for(int j=0;j<numFrames;j++){
@@ -577,54 +673,11 @@ bool ofOpenALSoundPlayer::isLoaded() const{
 
 //------------------------------------------------------------
 void ofOpenALSoundPlayer::threadedFunction(){
-	vector<vector<short> > multibuffer;
-	multibuffer.resize(channels);
+	// decodes ahead of openal, each buffer lasts around 90ms at 44.1KHz
+	// so polling often enough keeps the ring full without busy waiting
 	while(isThreadRunning()){
-		std::unique_lock<std::mutex> lock(mutex);
-		for(int i=0; i<int(sources.size())/channels; i++){
-			int processed;
-			alGetSourcei(sources[i*channels], AL_BUFFERS_PROCESSED, &processed);
-
-			while(processed--)
-			{
-				stream("",buffer);
-				int numFrames = buffer.size()/channels;
-				if(channels>1){
-					for(int j=0;j<channels;j++){
-						multibuffer[j].resize(buffer.size()/channels);
-						for(int k=0;k<numFrames;k++){
-							multibuffer[j][k] = buffer[k*channels+j];
-						}
-						ALuint albuffer;
-						alSourceUnqueueBuffers(sources[i*channels+j], 1, &albuffer);
-						alBufferData(albuffer,AL_FORMAT_MONO16,&multibuffer[j][0],buffer.size()*2/channels,samplerate);
-						alSourceQueueBuffers(sources[i*channels+j], 1, &albuffer);
-					}
-				}else{
-					ALuint albuffer;
-					alSourceUnqueueBuffers(sources[i], 1, &albuffer);
-					alBufferData(albuffer,AL_FORMAT_MONO16,&buffer[0],buffer.size()*2/channels,samplerate);
-					alSourceQueueBuffers(sources[i], 1, &albuffer);
-				}
-				if(stream_end){
-					break;
-				}
-			}
-			ALint state;
-			alGetSourcei(sources[i*channels],AL_SOURCE_STATE,&state);
-			bool stream_running=false;
-			#ifdef OF_USING_MPG123
-				stream_running = streamf || mp3streamf;
-			#else
-				stream_running = streamf;
-			#endif
-			if(state != AL_PLAYING && stream_running && !stream_end){
-				alSourcePlayv(channels,&sources[i*channels]);
-			}
-
-			stream_end = false;
-		}
-		sleep(1);
+		updateStream();
+		sleep(5);
 	}
 }
 
@@ -655,26 +708,16 @@ void ofOpenALSoundPlayer::unload(){
 		std::unique_lock<std::mutex> lock(mutex);
 
 		// Delete sources before buffers.
-		alDeleteSources(sources.size(),&sources[0]);
-		alDeleteBuffers(buffers.size(),&buffers[0]);
+		alDeleteSources(sources.size(),sources.data());
+		alDeleteBuffers(buffers.size(),buffers.data());
 
 		sources.clear();
 		buffers.clear();
-	}
-
-	// Free resources and close file descriptors.
-#ifdef OF_USING_MPG123
-	if(mp3streamf){
-		mpg123_close(mp3streamf);
-		mpg123_delete(mp3streamf);
-	}
-	mp3streamf = 0;
-#endif
 
-	if(streamf){
-		sf_close(streamf);
+		// Free resources and close file descriptors.
+		closeStream();
 	}
-	streamf = 0;
+	buffer.clear();
 
 	bLoadedOk = false;
 }
@@ -682,7 +725,13 @@ void ofOpenALSoundPlayer::unload(){
 //------------------------------------------------------------
 bool ofOpenALSoundPlayer::isPlaying() const{
 	if(sources.empty()) return false;
-	if(isStreaming) return isThreadRunning();
+	if(isStreaming){
+		std::unique_lock<std::mutex> lock(mutex);
+		if(streamRestart){
+			return streamRestartState==AL_PLAYING;
+		}
+		return isThreadRunning();
+	}
 	ALint state;
 	bool playing=false;
 	for(int i=0;i<(int)sources.size();i++){
@@ -695,6 +744,12 @@ bool ofOpenALSoundPlayer::isPlaying() const{
 //------------------------------------------------------------
 bool ofOpenALSoundPlayer::isPaused() const{
 	if(sources.empty()) return false;
+	if(isStreaming){
+		std::unique_lock<std::mutex> lock(mutex);
+		if(streamRestart){
+			return streamRestartState==AL_PAUSED;
+		}
+	}
 	ALint state;
 	bool paused=true;
 	for(int i=0;i<(int)sources.size();i++){
@@ -738,13 +793,27 @@ void ofOpenALSoundPlayer::setPosition(float pct){
 //------------------------------------------------------------
 void ofOpenALSoundPlayer::setPositionMS(int ms){
 	if(sources.empty()) return;
-#ifdef OF_USING_MPG123
-	if(mp3streamf){
-		mpg123_seek(mp3streamf,float(ms)/1000.f*samplerate,SEEK_SET);
-	}else
-#endif
-	if(streamf){
-        stream_samples_read = sf_seek(streamf,float(ms)/1000.f*samplerate,SEEK_SET) * channels;
+	if(isStreaming){
+		// the streaming thread seeks the decoder and refills the queue
+		// from there, mp3s are scanned on load so this doesn't decode
+		// from the start. while it runs the stream is playing, a source
+		// that ran out of buffers for a moment is stopped
+		ALint state = AL_PLAYING;
+		bool running;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			running = isThreadRunning();
+			if(streamRestart){
+				state = streamRestartState;
+			}else if(!running){
+				alGetSourcei(sources[0],AL_SOURCE_STATE,&state);
+			}
+			requestStreamRestart(uint64_t(std::max(ms,0))*samplerate/1000,state);
+		}
+		if(!running && (state==AL_PLAYING || state==AL_PAUSED)){
+			waitForThread(false);
+			startThread();
+		}
 	}else{
 		for(int i=0;i<(int)channels;i++){
 			alSourcef(sources[sources.size()-channels+i],AL_SEC_OFFSET,float(ms)/1000.f);
@@ -764,13 +833,27 @@ float ofOpenALSoundPlayer::getPosition() const{
 int ofOpenALSoundPlayer::getPositionMS() const{
 	if(sources.empty()) return 0;
 	float pos;
-#ifdef OF_USING_MPG123
-	if(mp3streamf){
-		pos = float(mpg123_tell(mp3streamf)) / float(samplerate);
-	}else
-#endif
-	if(streamf){
-		pos = float(stream_samples_read) / float(channels) / float(samplerate);
+	if(isStreaming){
+		// the sample offset of a streaming source counts from the oldest
+		// buffer still queued, which is the front of streamQueue
+		std::unique_lock<std::mutex> lock(mutex);
+		uint64_t frame = 0;
+		if(streamRestart){
+			frame = streamRestartFrame;
+		}else{
+			ALint offset;
+			alGetSourcei(sources[0],AL_SAMPLE_OFFSET,&offset);
+			uint64_t remaining = offset;
+			for(auto & chunk: streamQueue){
+				uint64_t frames = chunk.samples.size()/channels;
+				frame = chunk.firstFrame + std::min(remaining,frames);
+				if(remaining<frames){
+					break;
+				}
+				remaining -= frames;
+			}
+		}
+		pos = float(frame) / float(samplerate);
 	}else{
 		alGetSourcef(sources[sources.size()-1],AL_SEC_OFFSET,&pos);
 	}
@@ -808,15 +891,32 @@ void ofOpenALSoundPlayer::setPan(float p){
 //------------------------------------------------------------
 void ofOpenALSoundPlayer::setPaused(bool bP){
 	if(sources.empty()) return;
-	std::unique_lock<std::mutex> lock(mutex);
+	// the streaming thread locks the mutex so it can't be started or
+	// waited for while holding it. a seek in progress ends in the new
+	// state
 	if(bP){
-		alSourcePausev(sources.size(),&sources[0]);
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			alSourcePausev(sources.size(),&sources[0]);
+			if(streamRestart){
+				streamRestartState = AL_PAUSED;
+			}
+		}
 		if(isStreaming){
-			stopThread();
+			waitForThread(true);
 		}
 	}else{
-		alSourcePlayv(sources.size(),&sources[0]);
-		if(isStreaming){
+		bool running;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			alSourcePlayv(sources.size(),&sources[0]);
+			if(streamRestart){
+				streamRestartState = AL_PLAYING;
+			}
+			running = isThreadRunning();
+		}
+		if(isStreaming && !running){
+			waitForThread(false);
 			startThread();
 		}
 	}
@@ -861,6 +961,9 @@ void ofOpenALSoundPlayer::setMultiPlay(bool bMp){
 
 // ----------------------------------------------------------------------------
 void ofOpenALSoundPlayer::play(){
+	if(isStreaming){
+		waitForThread(true);
+	}
 	std::unique_lock<std::mutex> lock(mutex);
 	int err = glGetError();
 
@@ -897,14 +1000,18 @@ void ofOpenALSoundPlayer::play(){
 			return;
 		}
 	}
-	alSourcePlayv(channels,&sources[sources.size()-channels]);
+	if(isStreaming){
+		// the streaming thread fills the queue and starts the sources
+		requestStreamRestart(0,AL_PLAYING);
+	}else{
+		alSourcePlayv(channels,&sources[sources.size()-channels]);
+	}
 
 	if(bMultiPlay){
 		ofAddListener(ofEvents().update,this,&ofOpenALSoundPlayer::update);
 	}
 	if(isStreaming){
-		setPosition(0);
-		stream_end = false;
+		lock.unlock();
 		startThread();
 	}
 
@@ -913,11 +1020,14 @@ void ofOpenALSoundPlayer::play(){
 // ----------------------------------------------------------------------------
 void ofOpenALSoundPlayer::stop(){
 	if(sources.empty()) return;
+	if(isStreaming){
+		waitForThread(true);
+	}
 	std::unique_lock<std::mutex> lock(mutex);
 	alSourceStopv(channels,&sources[sources.size()-channels]);
 	if(isStreaming){
-		setPosition(0);
-		stopThread();
+		clearStream();
+		streamRestart = false;
 	}
 }
 
@@ -948,6 +1058,11 @@ float * ofOpenALSoundPlayer::getCurrentBufferSum(int size){
 		windowedSignal.resize(size);
 	}
 	windowedSignal.assign(windowedSignal.size(),0);
+	// the streaming thread can't unqueue chunks while they are read
+	std::unique_lock<std::mutex> lock(mutex,std::defer_lock);
+	if(isStreaming){
+		lock.lock();
+	}
 	for(int k=0;k<int(sources.size())/channels;k++){
 		if(!isStreaming){
 			ALint state;
@@ -956,15 +1071,28 @@ float * ofOpenALSoundPlayer::getCurrentBufferSum(int size){
 		}
 		int pos;
 		alGetSourcei(sources[k*channels],AL_SAMPLE_OFFSET,&pos);
-		//if(pos+size>=(int)fftBuffers[0].size()) continue;
 		for(int i=0;i<channels;i++){
 			float gain;
 			alGetSourcef(sources[k*channels+i],AL_GAIN,&gain);
-			for(int j=0;j<size;j++){
-				if(pos+j<(int)fftBuffers[i].size())
-					windowedSignal[j]+=fftBuffers[i][pos+j]*gain;
-				else
-					windowedSignal[j]=0;
+			gain /= 32768.f;
+			if(isStreaming){
+				// the offset counts from the oldest chunk still queued
+				size_t frame = pos;
+				auto chunk = streamQueue.begin();
+				for(int j=0;j<size && chunk!=streamQueue.end();){
+					size_t frames = chunk->samples.size()/channels;
+					if(frame>=frames){
+						frame -= frames;
+						++chunk;
+						continue;
+					}
+					windowedSignal[j++]+=chunk->samples[frame*channels+i]*gain;
+					frame++;
+				}
+			}else{
+				for(int j=0;j<size && size_t(pos+j)*channels+i<buffer.size();j++){
+					windowedSignal[j]+=buffer[(pos+j)*channels+i]*gain;
+				}
 			}
 		}
 	}
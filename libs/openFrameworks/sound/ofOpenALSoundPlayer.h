@@ -5,7 +5,7 @@
 #ifdef OF_SOUND_PLAYER_OPENAL
 #include "ofSoundBaseTypes.h"
 #include "ofThread.h"
-
+#include <deque>
 
 
 typedef unsigned int ALuint;
@@ -102,15 +102,31 @@ class ofOpenALSoundPlayer : public ofBaseSoundPlayer, public ofThread {
 		static void runWindow(std::vector<float> & signal);
 		static void initSystemFFT(int bands);
 
-        bool sfReadFile(const std::filesystem::path& path,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer);
-        bool sfStream(const std::filesystem::path& path,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer);
+		// a chunk of interleaved samples queued in openal, firstFrame is
+		// its position in the file so the play position can be tracked
+		// across loops and seeks
+		struct StreamChunk{
+			uint64_t firstFrame;
+			std::vector<short> samples;
+		};
+
+        bool sfReadFile(const std::filesystem::path& path,std::vector<short> & buffer);
 #ifdef OF_USING_MPG123
-        bool mpg123ReadFile(const std::filesystem::path& path,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer);
-        bool mpg123Stream(const std::filesystem::path& path,std::vector<short> & buffer,std::vector<float> & fftAuxBuffer);
+        bool mpg123ReadFile(const std::filesystem::path& path,std::vector<short> & buffer);
 #endif
-
         bool readFile(const std::filesystem::path& fileName,std::vector<short> & buffer);
-        bool stream(const std::filesystem::path& fileName, std::vector<short> & buffer);
+
+		bool openStream(const std::filesystem::path& fileName);
+		size_t readStream(short * samples, size_t frames);
+		bool seekStream(uint64_t frame);
+		void closeStream();
+		bool decodeStreamChunk(StreamChunk & chunk);
+		void uploadStreamChunk(const StreamChunk & chunk, const ALuint * chunkBuffers);
+		void requestStreamRestart(uint64_t frame, int state);
+		void clearStream();
+		void updateStream();
+		size_t decodeFreeStreamChunks();
+		void queueFreeStreamChunks(size_t numChunks);
 
 		bool isStreaming;
 		bool bMultiPlay;
@@ -135,7 +151,6 @@ class ofOpenALSoundPlayer : public ofBaseSoundPlayer, public ofThread {
 		std::vector<ALuint> sources;
 
 		// fft structures
-		std::vector<std::vector<float> > fftBuffers;
 		kiss_fftr_cfg fftCfg;
 		std::vector<float> windowedSignal;
 		std::vector<float> bins;
@@ -148,18 +163,30 @@ class ofOpenALSoundPlayer : public ofBaseSoundPlayer, public ofThread {
 		static std::vector<kiss_fft_cpx> systemCx_out;
 
 		SNDFILE* streamf;
-		size_t stream_samples_read;
 #ifdef OF_USING_MPG123
 		mpg123_handle * mp3streamf;
-		int stream_encoding;
 #endif
-		int mp3_buffer_size;
-		int stream_subformat;
-		double stream_scale;
+		uint64_t streamFrames; // frames in the streamed file, 0 if unknown
+		uint64_t streamDecodePosition; // next frame the decoder will read
+		bool streamEnd;
+		std::deque<StreamChunk> streamQueue; // same order as the openal queue
+
+		// seeking and filling the queue is done by the streaming thread,
+		// play and setPositionMS only ask for it. state is the openal
+		// state the sources go to once the queue is filled again
+		bool streamRestart;
+		uint64_t streamRestartFrame;
+		int streamRestartState;
+
+		// only used from the streaming thread, chunks and openal buffers
+		// that aren't queued, channels buffers per chunk
+		std::vector<StreamChunk> streamFreeChunks;
+		std::vector<ALuint> streamFreeBuffers;
+		std::vector<short> streamChannelBuffer;
+
+		// interleaved samples of a sound that's not streamed, kept
+		// for getSpectrum since openal can't read them back
 		std::vector<short> buffer;
-		std::vector<float> fftAuxBuffer;
-
-		bool stream_end;
 };
 
 #endif
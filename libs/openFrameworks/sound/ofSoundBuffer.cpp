@@ -9,10 +9,428 @@
 #include "ofSoundUtils.h"
 #include "ofLog.h"
 #include <limits>
+#include <cstring>
+#include <array>
 #include "glm/trigonometric.hpp"
+#include "glm/gtc/constants.hpp"
+
+#if defined(__AVX__)
+	#include <immintrin.h>
+	#define OF_SOUND_BUFFER_AVX
+	#define OF_SOUND_BUFFER_SSE
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define OF_SOUND_BUFFER_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define OF_SOUND_BUFFER_NEON
+#endif
 
 using namespace std;
 
+namespace{
+	// dst[i] += src[i]
+	void addSamples(float * dst, const float * src, size_t n){
+		size_t i = 0;
+#if defined(OF_SOUND_BUFFER_AVX)
+		for(; i+8<=n; i+=8){
+			_mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_loadu_ps(src + i)));
+		}
+#endif
+#if defined(OF_SOUND_BUFFER_SSE)
+		for(; i+4<=n; i+=4){
+			_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+		}
+#elif defined(OF_SOUND_BUFFER_NEON)
+		for(; i+4<=n; i+=4){
+			vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vld1q_f32(src + i)));
+		}
+#endif
+		for(; i<n; i++){
+			dst[i] += src[i];
+		}
+	}
+
+	// multiplies interleaved frames by a gain per channel, gains has 4
+	// values repeating the channel gains, n samples
+	void scaleSamples(float * dst, const float * gains, size_t n){
+		size_t i = 0;
+#if defined(OF_SOUND_BUFFER_AVX)
+		__m128 g = _mm_loadu_ps(gains);
+		__m256 g8 = _mm256_insertf128_ps(_mm256_castps128_ps256(g), g, 1);
+		for(; i+8<=n; i+=8){
+			_mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(dst + i), g8));
+		}
+#endif
+#if defined(OF_SOUND_BUFFER_SSE)
+		__m128 g4 = _mm_loadu_ps(gains);
+		for(; i+4<=n; i+=4){
+			_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(dst + i), g4));
+		}
+#elif defined(OF_SOUND_BUFFER_NEON)
+		float32x4_t g4 = vld1q_f32(gains);
+		for(; i+4<=n; i+=4){
+			vst1q_f32(dst + i, vmulq_f32(vld1q_f32(dst + i), g4));
+		}
+#endif
+		for(; i<n; i++){
+			dst[i] *= gains[i % 4];
+		}
+	}
+
+	void scaleSamples(float * dst, float gain, size_t n){
+		float gains[] = {gain, gain, gain, gain};
+		scaleSamples(dst, gains, n);
+	}
+
+	float maxAbs(const float * src, size_t n){
+		float maxAmplitude = 0;
+		size_t i = 0;
+#if defined(OF_SOUND_BUFFER_SSE)
+		const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+		__m128 max4 = _mm_setzero_ps();
+		for(; i+4<=n; i+=4){
+			max4 = _mm_max_ps(max4, _mm_and_ps(_mm_loadu_ps(src + i), signMask));
+		}
+		float lanes[4];
+		_mm_storeu_ps(lanes, max4);
+		maxAmplitude = max(max(lanes[0], lanes[1]), max(lanes[2], lanes[3]));
+#elif defined(OF_SOUND_BUFFER_NEON)
+		float32x4_t max4 = vdupq_n_f32(0);
+		for(; i+4<=n; i+=4){
+			max4 = vmaxq_f32(max4, vabsq_f32(vld1q_f32(src + i)));
+		}
+		float lanes[4];
+		vst1q_f32(lanes, max4);
+		maxAmplitude = max(max(lanes[0], lanes[1]), max(lanes[2], lanes[3]));
+#endif
+		for(; i<n; i++){
+			maxAmplitude = max(maxAmplitude, abs(src[i]));
+		}
+		return maxAmplitude;
+	}
+
+	// sum of the squares of every stride-th sample, accumulated in double
+	double sumSquares(const float * src, size_t n, size_t stride){
+		double acc = 0;
+		size_t i = 0;
+		if(stride == 1){
+#if defined(OF_SOUND_BUFFER_SSE)
+			__m128d acc2 = _mm_setzero_pd();
+			for(; i+4<=n; i+=4){
+				__m128 v = _mm_loadu_ps(src + i);
+				v = _mm_mul_ps(v, v);
+				acc2 = _mm_add_pd(acc2, _mm_cvtps_pd(v));
+				acc2 = _mm_add_pd(acc2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+			}
+			double lanes[2];
+			_mm_storeu_pd(lanes, acc2);
+			acc = lanes[0] + lanes[1];
+#elif defined(OF_SOUND_BUFFER_NEON) && defined(__aarch64__)
+			float64x2_t acc2 = vdupq_n_f64(0);
+			for(; i+4<=n; i+=4){
+				float32x4_t v = vld1q_f32(src + i);
+				v = vmulq_f32(v, v);
+				acc2 = vaddq_f64(acc2, vcvt_f64_f32(vget_low_f32(v)));
+				acc2 = vaddq_f64(acc2, vcvt_high_f64_f32(v));
+			}
+			acc = vaddvq_f64(acc2);
+#endif
+		}
+		for(; i<n; i++){
+			float sample = src[i * stride];
+			acc += sample * sample;
+		}
+		return acc;
+	}
+
+	void shortToFloat(float * dst, const short * src, size_t n){
+		const float scale = float(numeric_limits<short>::max());
+		size_t i = 0;
+#if defined(OF_SOUND_BUFFER_SSE)
+		const __m128 scale4 = _mm_set1_ps(scale);
+		for(; i+8<=n; i+=8){
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			// sign extend to 32 bits by unpacking into the high half and shifting back
+			__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+			__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+			_mm_storeu_ps(dst + i, _mm_div_ps(_mm_cvtepi32_ps(lo), scale4));
+			_mm_storeu_ps(dst + i + 4, _mm_div_ps(_mm_cvtepi32_ps(hi), scale4));
+		}
+#elif defined(OF_SOUND_BUFFER_NEON) && defined(__aarch64__)
+		const float32x4_t scale4 = vdupq_n_f32(scale);
+		for(; i+8<=n; i+=8){
+			int16x8_t v = vld1q_s16(src + i);
+			vst1q_f32(dst + i, vdivq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale4));
+			vst1q_f32(dst + i + 4, vdivq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale4));
+		}
+#endif
+		for(; i<n; i++){
+			dst[i] = src[i] / scale;
+		}
+	}
+
+	// truncates like a cast but saturates samples out of -1..1 instead of wrapping
+	void floatToShort(short * dst, const float * src, size_t n){
+		const float scale = float(numeric_limits<short>::max());
+		const float lowest = float(numeric_limits<short>::lowest());
+		size_t i = 0;
+#if defined(OF_SOUND_BUFFER_SSE)
+		const __m128 scale4 = _mm_set1_ps(scale);
+		const __m128 min4 = _mm_set1_ps(lowest);
+		for(; i+8<=n; i+=8){
+			__m128 lo = _mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale4), scale4), min4);
+			__m128 hi = _mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale4), scale4), min4);
+			__m128i packed = _mm_packs_epi32(_mm_cvttps_epi32(lo), _mm_cvttps_epi32(hi));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+		}
+#elif defined(OF_SOUND_BUFFER_NEON)
+		const float32x4_t scale4 = vdupq_n_f32(scale);
+		const float32x4_t min4 = vdupq_n_f32(lowest);
+		for(; i+8<=n; i+=8){
+			float32x4_t lo = vmaxq_f32(vminq_f32(vmulq_f32(vld1q_f32(src + i), scale4), scale4), min4);
+			float32x4_t hi = vmaxq_f32(vminq_f32(vmulq_f32(vld1q_f32(src + i + 4), scale4), scale4), min4);
+			vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(vcvtq_s32_f32(lo)), vqmovn_s32(vcvtq_s32_f32(hi))));
+		}
+#endif
+		for(; i<n; i++){
+			float sample = src[i] * scale;
+			dst[i] = short(sample > scale ? scale : (sample < lowest ? lowest : sample));
+		}
+	}
+
+	// copies or adds mono frames to every channel of the output
+	template<bool add>
+	void broadcastMono(float * dst, const float * src, size_t numFrames, size_t outChannels){
+		size_t i = 0;
+		if(outChannels == 2){
+#if defined(OF_SOUND_BUFFER_SSE)
+			for(; i+4<=numFrames; i+=4){
+				__m128 v = _mm_loadu_ps(src + i);
+				__m128 lo = _mm_unpacklo_ps(v, v);
+				__m128 hi = _mm_unpackhi_ps(v, v);
+				if(add){
+					lo = _mm_add_ps(lo, _mm_loadu_ps(dst + i * 2));
+					hi = _mm_add_ps(hi, _mm_loadu_ps(dst + i * 2 + 4));
+				}
+				_mm_storeu_ps(dst + i * 2, lo);
+				_mm_storeu_ps(dst + i * 2 + 4, hi);
+			}
+#elif defined(OF_SOUND_BUFFER_NEON)
+			for(; i+4<=numFrames; i+=4){
+				float32x4_t v = vld1q_f32(src + i);
+				float32x4x2_t lr = {{v, v}};
+				if(add){
+					float32x4x2_t out = vld2q_f32(dst + i * 2);
+					lr.val[0] = vaddq_f32(lr.val[0], out.val[0]);
+					lr.val[1] = vaddq_f32(lr.val[1], out.val[1]);
+				}
+				vst2q_f32(dst + i * 2, lr);
+			}
+#endif
+		}
+		for(; i<numFrames; i++){
+			float * out = dst + i * outChannels;
+			for(size_t j = 0; j < outChannels; j++){
+				out[j] = add ? out[j] + src[i] : src[i];
+			}
+		}
+	}
+
+	// copies or adds frames with a different number of channels, dropping
+	// the extra ones or repeating the input channels to fill the output
+	template<bool add>
+	void copyFrames(float * dst, const float * src, size_t numFrames, size_t inChannels, size_t outChannels){
+		if(inChannels == outChannels){
+			if(add){
+				addSamples(dst, src, numFrames * inChannels);
+			}else{
+				memcpy(dst, src, numFrames * inChannels * sizeof(float));
+			}
+		}else if(inChannels == 1){
+			broadcastMono<add>(dst, src, numFrames, outChannels);
+		}else{
+			for(size_t i = 0; i < numFrames; i++){
+				for(size_t j = 0, channel = 0; j < outChannels; j++){
+					*dst = add ? *dst + src[channel] : src[channel];
+					dst++;
+					if(++channel == inChannels) channel = 0;
+				}
+				src += inChannels;
+			}
+		}
+	}
+
+	float dotProduct(const float * a, const float * b, size_t n){
+		size_t i = 0;
+		float result = 0;
+#if defined(OF_SOUND_BUFFER_SSE)
+		__m128 acc = _mm_setzero_ps();
+		for(; i+4<=n; i+=4){
+			acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+		}
+		float lanes[4];
+		_mm_storeu_ps(lanes, acc);
+		result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(OF_SOUND_BUFFER_NEON)
+		float32x4_t acc = vdupq_n_f32(0);
+		for(; i+4<=n; i+=4){
+			acc = vmlaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+		}
+		float lanes[4];
+		vst1q_f32(lanes, acc);
+		result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+		for(; i<n; i++){
+			result += a[i] * b[i];
+		}
+		return result;
+	}
+
+	// out[channel] = sum of weights[i] * src[i * 2 + channel] for interleaved stereo
+	void dotProductStereo(const float * weights, const float * src, size_t n, float * out){
+		size_t i = 0;
+		float left = 0, right = 0;
+#if defined(OF_SOUND_BUFFER_SSE)
+		__m128 acc = _mm_setzero_ps();
+		for(; i+2<=n; i+=2){
+			__m128 w = _mm_set_ps(weights[i + 1], weights[i + 1], weights[i], weights[i]);
+			acc = _mm_add_ps(acc, _mm_mul_ps(w, _mm_loadu_ps(src + i * 2)));
+		}
+		float lanes[4];
+		_mm_storeu_ps(lanes, acc);
+		left = lanes[0] + lanes[2];
+		right = lanes[1] + lanes[3];
+#elif defined(OF_SOUND_BUFFER_NEON)
+		float32x4_t accLeft = vdupq_n_f32(0), accRight = vdupq_n_f32(0);
+		for(; i+4<=n; i+=4){
+			float32x4x2_t lr = vld2q_f32(src + i * 2);
+			float32x4_t w = vld1q_f32(weights + i);
+			accLeft = vmlaq_f32(accLeft, w, lr.val[0]);
+			accRight = vmlaq_f32(accRight, w, lr.val[1]);
+		}
+		float lanes[4];
+		vst1q_f32(lanes, accLeft);
+		left = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+		vst1q_f32(lanes, accRight);
+		right = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+		for(; i<n; i++){
+			left += weights[i] * src[i * 2];
+			right += weights[i] * src[i * 2 + 1];
+		}
+		out[0] = left;
+		out[1] = right;
+	}
+
+	// windowed sinc kernel for the high quality resampler, 16 zero crossings
+	// to each side with a kaiser window, beta 8 gives around 80dB of
+	// stopband attenuation
+	const int sincZeroCrossings = 16;
+	const int sincTaps = sincZeroCrossings * 2;
+
+	double besselI0(double x){
+		double sum = 1, term = 1;
+		for(int k = 1; k < 32; k++){
+			term *= (x / (2 * k)) * (x / (2 * k));
+			sum += term;
+		}
+		return sum;
+	}
+
+	double windowedSinc(double x){
+		const double beta = 8;
+		x = std::abs(x);
+		if(x >= sincZeroCrossings){
+			return 0;
+		}
+		double sinc = x == 0 ? 1 : sin(glm::pi<double>() * x) / (glm::pi<double>() * x);
+		double r = x / sincZeroCrossings;
+		return sinc * besselI0(beta * sqrt(1 - r * r)) / besselI0(beta);
+	}
+
+	// half of the kernel, it's symmetric, sampled sincResolution times
+	// between zero crossings so the weights for any position can be
+	// interpolated when the kernel is stretched to filter out aliasing
+	const int sincResolution = 512;
+	const vector<float> & sincTable(){
+		static const vector<float> table = []{
+			vector<float> table(sincZeroCrossings * sincResolution + 2, 0.f);
+			for(int i = 0; i < sincZeroCrossings * sincResolution; i++){
+				table[i] = float(windowedSinc(double(i) / sincResolution));
+			}
+			return table;
+		}();
+		return table;
+	}
+
+	// polyphase version of the kernel for speeds up to 1: row p has the
+	// sincTaps weights for frames at fractional position p / sincPhases, any
+	// position in between is a linear interpolation of two consecutive rows
+	const int sincPhases = 256;
+	const vector<float> & sincPolyphaseTable(){
+		static const vector<float> table = []{
+			vector<float> table((sincPhases + 1) * sincTaps);
+			for(int p = 0; p <= sincPhases; p++){
+				for(int t = 0; t < sincTaps; t++){
+					table[p * sincTaps + t] = float(windowedSinc(t - (sincZeroCrossings - 1) - double(p) / sincPhases));
+				}
+			}
+			return table;
+		}();
+		return table;
+	}
+
+	// polyphase table for a kernel stretched to filter out what would alias
+	// when speeding up, interpolated from sincTable()
+	struct StretchedSincTable{
+		float cutoff = 0;
+		std::size_t taps = 0;
+		vector<float> table;
+		uint64_t lastUse = 0;
+	};
+
+	// the cutoff is rounded down to 1/64th of an octave so speeds that
+	// change slightly from call to call, like a vibrato, share tables and
+	// the filter never lets through more than it should. The last few
+	// tables used are kept per thread, once they are built resampling
+	// doesn't allocate
+	const StretchedSincTable & stretchedSincTable(float cutoff){
+		const int stepsPerOctave = 64;
+		cutoff = exp2f(floorf(log2f(cutoff) * stepsPerOctave) / stepsPerOctave);
+
+		thread_local std::array<StretchedSincTable, 8> cache;
+		thread_local uint64_t uses = 0;
+		uses++;
+		StretchedSincTable * stretched = &cache[0];
+		for(auto & cached: cache){
+			if(cached.cutoff == cutoff){
+				cached.lastUse = uses;
+				return cached;
+			}
+			if(cached.lastUse < stretched->lastUse){
+				stretched = &cached;
+			}
+		}
+
+		const vector<float> & kernel = sincTable();
+		const std::size_t kernelEnd = kernel.size() - 1;
+		const long long radius = (long long)ceil(sincZeroCrossings / cutoff);
+		stretched->cutoff = cutoff;
+		stretched->lastUse = uses;
+		stretched->taps = radius * 2;
+		stretched->table.resize((sincPhases + 1) * stretched->taps);
+		for(int p = 0; p <= sincPhases; p++){
+			for(std::size_t t = 0; t < stretched->taps; t++){
+				float x = std::abs(float(t) - float(radius - 1) - float(p) / sincPhases) * cutoff * sincResolution;
+				std::size_t index = x;
+				stretched->table[p * stretched->taps + t] = index < kernelEnd ? cutoff * ofLerp(kernel[index], kernel[index + 1], x - index) : 0;
+			}
+		}
+		return *stretched;
+	}
+}
+
 #if !defined(TARGET_ANDROID) && !defined(TARGET_IPHONE) && !defined(TARGET_LINUX_ARM)
 ofSoundBuffer::InterpolationAlgorithm ofSoundBuffer::defaultAlgorithm = ofSoundBuffer::Hermite;
 #else
@@ -38,9 +456,7 @@ void ofSoundBuffer::copyFrom(const short * shortBuffer, std::size_t numFrames, s
 	this->channels = numChannels;
 	setSampleRate(samplerate);
 	buffer.resize(numFrames * numChannels);
-	for(std::size_t i = 0; i < size(); i++){
-		buffer[i] = shortBuffer[i]/float(numeric_limits<short>::max());
-	}
+	shortToFloat(buffer.data(), shortBuffer, size());
 	checkSizeAndChannelsConsistency("copyFrom");
 }
 
@@ -61,15 +477,11 @@ void ofSoundBuffer::copyFrom(const vector<float> & floatBuffer, std::size_t numC
 
 void ofSoundBuffer::toShortPCM(vector<short> & dst) const{
 	dst.resize(size());
-	for(std::size_t i = 0; i < size(); i++){
-		dst[i] = buffer[i]*float(numeric_limits<short>::max());
-	}
+	floatToShort(dst.data(), buffer.data(), size());
 }
 
 void ofSoundBuffer::toShortPCM(short * dst) const{
-	for(std::size_t i = 0; i < size(); i++){
-		dst[i] = buffer[i]*float(numeric_limits<short>::max());
-	}
+	floatToShort(dst, buffer.data(), size());
 }
 
 vector<float> & ofSoundBuffer::getBuffer(){
@@ -164,9 +576,7 @@ ofSoundBuffer ofSoundBuffer::operator*(float value){
 }
 
 ofSoundBuffer & ofSoundBuffer::operator*=(float value){
-	for(std::size_t i=0;i<buffer.size();i++){
-		buffer[i] *= value;
-	}
+	scaleSamples(buffer.data(), value, buffer.size());
 	return *this;
 }
 
@@ -175,11 +585,8 @@ void ofSoundBuffer::stereoPan(float left, float right){
 		ofLogWarning("ofSoundBuffer") << "stereoPan called on a buffer with " << channels << " channels, only works with 2 channels";
 		return;
 	}
-	float * bufferPtr = &buffer[0];
-	for(std::size_t i=0;i<getNumFrames();i++){
-		*bufferPtr++ *= left;
-		*bufferPtr++ *= right;
-	}
+	float gains[] = {left, right, left, right};
+	scaleSamples(buffer.data(), gains, getNumFrames() * 2);
 }
 
 void ofSoundBuffer::copyTo(ofSoundBuffer & soundBuffer, std::size_t nFrames, std::size_t outChannels,std::size_t fromFrame,bool loop) const{
@@ -208,44 +615,24 @@ void ofSoundBuffer::copyTo(float * outBuffer, std::size_t nFrames, std::size_t o
 	// figure out how many frames we can copy before we need to stop or loop
 	std::size_t nFramesToCopy = nFrames;
 	if ((fromFrame + nFrames) >= this->getNumFrames()){
-		nFramesToCopy = this->getNumFrames() - fromFrame;
+		nFramesToCopy = this->getNumFrames() - std::min(fromFrame, this->getNumFrames());
 	}
-		
-	const float * buffPtr = &buffer[fromFrame * channels];
-	// if channels count matches we can just memcpy
-	if(channels == outChannels){
-		memcpy(outBuffer, buffPtr, nFramesToCopy * channels * sizeof(float));
+
+	// if channels count matches we can just memcpy, otherwise copy the first
+	// outChannels channels or repeat ours to fill the output:
+	// if we have 2 channels and output wants 5, data is copied from our
+	// channels in the following in order: 1 2 1 2 1
+	if(nFramesToCopy > 0){
+		copyFrames<false>(outBuffer, &buffer[fromFrame * channels], nFramesToCopy, channels, outChannels);
 		outBuffer += nFramesToCopy * outChannels;
-	} else if(channels > outChannels){
-		// otherwise, if we have more channels than the output is requesting,
-		// we copy the first outChannels channels
-		for(std::size_t i = 0; i < nFramesToCopy; i++){
-			for(std::size_t j = 0; j < outChannels; j++){
-				*outBuffer++ = *buffPtr++;
-			}
-			// and skip the rest
-			buffPtr += channels - outChannels;
-		}
-	} else {
-		// we have fewer channels than output is requesting. so replicate as many channels as possible then loop.
-		// if we have 2 channels and output wants 5, data is copied from our channels in the following in order:
-		// 1 2 1 2 1
-		for(std::size_t i = 0; i < nFramesToCopy; i++){
-			for(std::size_t j = 0; j < outChannels; j++){
-				*outBuffer++ = buffPtr[(j%channels)];
-			}
-			buffPtr += channels;
-		}
 	}
 
 	// do we have anything left?
-	int framesRemaining = nFrames - (int)nFramesToCopy;
+	std::size_t framesRemaining = nFrames - nFramesToCopy;
 	if (framesRemaining > 0){
 		if(!loop || size() == 0){
 			// fill with 0s
-			for(std::size_t i = 0; i < framesRemaining * outChannels; i++){
-				outBuffer[i] = 0;
-			}
+			memset(outBuffer, 0, framesRemaining * outChannels * sizeof(float));
 		}else{
 			// loop
 			copyTo(outBuffer, framesRemaining, outChannels, 0, loop);
@@ -257,41 +644,18 @@ void ofSoundBuffer::addTo(float * outBuffer, std::size_t nFrames, std::size_t ou
 	// figure out how many frames we can copy before we need to stop or loop
 	std::size_t nFramesToCopy = nFrames;
 	if ((fromFrame + nFrames) >= this->getNumFrames()){
-		nFramesToCopy = this->getNumFrames() - fromFrame;
+		nFramesToCopy = this->getNumFrames() - std::min(fromFrame, this->getNumFrames());
 	}
 
-	const float * buffPtr = &buffer[fromFrame * channels];
-	// if channels count matches it is easy
-	if(channels == outChannels){
-		for(std::size_t i = 0; i < (nFramesToCopy * outChannels); i++){
-			outBuffer[i] += buffPtr[i];
-		}
+	// same channel mapping as copyTo
+	if(nFramesToCopy > 0){
+		copyFrames<true>(outBuffer, &buffer[fromFrame * channels], nFramesToCopy, channels, outChannels);
 		outBuffer += nFramesToCopy * outChannels;
-	} else if(channels > outChannels){
-		// otherwise, if we have more channels than the output is requesting,
-		// we copy the first outChannels channels
-		for(std::size_t i = 0; i < nFramesToCopy; i++){
-			for(std::size_t j = 0; j < outChannels; j++){
-				*outBuffer++ += *buffPtr++;
-			}
-			// and skip the rest
-			buffPtr += channels - outChannels;
-		}
-	} else {
-		// we have fewer channels than output is requesting. so replicate as many channels as possible then loop.
-		// if we have 2 channels and output wants 5, data is copied from our channels in the following in order:
-		// 1 2 1 2 1
-		for(std::size_t i = 0; i < nFramesToCopy; i++){
-			for(std::size_t j = 0; j < outChannels; j++){
-				*outBuffer++ += buffPtr[(j%channels)];
-			}
-			buffPtr += channels;
-		}
 	}
 
 	// do we have anything left?
-	int framesRemaining = nFrames - (int)nFramesToCopy;
-	if (framesRemaining > 0 && loop){
+	std::size_t framesRemaining = nFrames - nFramesToCopy;
+	if (framesRemaining > 0 && loop && size() > 0){
 		// loop
 		addTo(outBuffer, framesRemaining, outChannels, 0, loop);
 	}
@@ -321,6 +685,51 @@ static bool prepareBufferForResampling(const ofSoundBuffer &in, ofSoundBuffer &o
 	return true;
 }
 
+// sample of the given frame for frames out of the buffer, wrapping
+// around when looping or silence otherwise
+static float sampleAt(const vector<float> & buffer, long long frame, std::size_t channel, std::size_t channels, bool loop){
+	long long numFrames = buffer.size() / channels;
+	if(frame < 0 || frame >= numFrames){
+		if(!loop || numFrames == 0){
+			return 0;
+		}
+		frame %= numFrames;
+		if(frame < 0) frame += numFrames;
+	}
+	return buffer[frame * channels + channel];
+}
+
+// the inner loops of the resamplers for frames that don't need to wrap,
+// with the number of channels known at compile time for mono and stereo
+template<std::size_t Channels>
+static void linearResampleFrames(const float * in, float * out, std::size_t numFrames, std::size_t channels, double & position, float increment){
+	const std::size_t inChannels = Channels ? Channels : channels;
+	for(std::size_t i = 0; i < numFrames; i++){
+		std::size_t intPosition = position;
+		float remainder = position - intPosition;
+		const float * a = in + intPosition * inChannels;
+		const float * b = a + inChannels;
+		for(std::size_t j = 0; j < inChannels; j++){
+			*out++ = ofLerp(a[j], b[j], remainder);
+		}
+		position += increment;
+	}
+}
+
+template<std::size_t Channels>
+static void hermiteResampleFrames(const float * in, float * out, std::size_t numFrames, std::size_t channels, double & position, float increment){
+	const std::size_t inChannels = Channels ? Channels : channels;
+	for(std::size_t i = 0; i < numFrames; i++){
+		std::size_t intPosition = position;
+		float remainder = position - intPosition;
+		const float * b = in + intPosition * inChannels;
+		for(std::size_t j = 0; j < inChannels; j++){
+			*out++ = ofInterpolateHermite(b[j - inChannels], b[j], b[j + inChannels], b[j + inChannels * 2], remainder);
+		}
+		position += increment;
+	}
+}
+
 // based on maximilian optimized for performance.
 // might lose 1 or 2 samples when it reaches the end of the buffer
 void ofSoundBuffer::linearResampleTo(ofSoundBuffer &outBuffer, std::size_t fromFrame, std::size_t numFrames, float speed, bool loop) const {
@@ -337,48 +746,45 @@ void ofSoundBuffer::linearResampleTo(ofSoundBuffer &outBuffer, std::size_t fromF
 	std::size_t start = fromFrame;
 	std::size_t end = start*inChannels + double(numFrames*inChannels)*speed;
 	double position = start;
-	std::size_t intPosition = position;
 	float increment = speed;
 	std::size_t copySize = inChannels*sizeof(float);
 	std::size_t to;
+	bool reachesEnd = size() < 2*inChannels || end>=size()-2*inChannels;
 	
-	if(end<size()-2*inChannels){
+	if(!reachesEnd){
 		to = numFrames;
 	}else if(fromFrame+2>inFrames){
 		to = 0;
 	}else{
-		to = ceil(float(inFrames-2-fromFrame)/speed);
+		to = std::min<std::size_t>(ceil(float(inFrames-2-fromFrame)/speed), numFrames);
 	}
 	
-	float remainder = position - intPosition;
 	float * resBufferPtr = &outBuffer[0];
-	float a, b;
-	
-	for(std::size_t i=0;i<to;i++){
-		intPosition *= inChannels;
-		for(std::size_t j=0;j<inChannels;j++){
-			a = buffer[intPosition+j];
-			b = buffer[intPosition+inChannels+j];
-			*resBufferPtr++ = ofLerp(a,b,remainder);
-		}
-		position += increment;
-		intPosition = position;
-		remainder = position - intPosition;
+	switch(inChannels){
+		case 1:
+			linearResampleFrames<1>(buffer.data(), resBufferPtr, to, inChannels, position, increment);
+			break;
+		case 2:
+			linearResampleFrames<2>(buffer.data(), resBufferPtr, to, inChannels, position, increment);
+			break;
+		default:
+			linearResampleFrames<0>(buffer.data(), resBufferPtr, to, inChannels, position, increment);
+			break;
 	}
-	if(end>=size()-2*inChannels){
+	resBufferPtr += to * inChannels;
+
+	if(reachesEnd){
 		to = numFrames-to;
 		if(loop){
-			intPosition %= inFrames;
 			for(std::size_t i=0;i<to;i++){
-				intPosition *= inChannels;
+				long long intPosition = floor(position);
+				float remainder = position - intPosition;
 				for(std::size_t j=0;j<inChannels;j++){
-					a = buffer[intPosition+j];
-					b = buffer[intPosition+inChannels+j];
+					float a = sampleAt(buffer, intPosition, j, inChannels, loop);
+					float b = sampleAt(buffer, intPosition + 1, j, inChannels, loop);
 					*resBufferPtr++ = ofLerp(a,b,remainder);
 				}
-				resBufferPtr+=inChannels;
 				position += increment;
-				intPosition = position;
 			}
 		}else{
 			memset(resBufferPtr,0,to*copySize);
@@ -402,69 +808,67 @@ void ofSoundBuffer::hermiteResampleTo(ofSoundBuffer &outBuffer, std::size_t from
 	std::size_t start = fromFrame;
 	std::size_t end = start*inChannels + double(numFrames*inChannels)*speed;
 	double position = start;
-	std::size_t intPosition = position;
-	float remainder = position - intPosition;
 	float increment = speed;
 	std::size_t copySize = inChannels*sizeof(float);
 	std::size_t to;
+	bool reachesEnd = size() < 3*inChannels || end>=size()-3*inChannels;
 	
-	if(end<size()-3*inChannels){
+	if(!reachesEnd){
 		to = numFrames;
 	}else if(fromFrame+3>inFrames){
 		to = 0;
 	}else{
-		to = double(inFrames-3-fromFrame)/speed;
+		to = std::min<std::size_t>(double(inFrames-3-fromFrame)/speed, numFrames);
 	}
 	
 	float * resBufferPtr = &outBuffer[0];
-	float a,b,c,d;
 	std::size_t from = 0;
 	
-	while(intPosition==0){
-		intPosition *= inChannels;
+	// the first frame needs the one before the start of the buffer
+	while(position < 1 && from < numFrames){
+		float remainder = position;
 		for(std::size_t j=0;j<inChannels;++j){
-			a=loop?buffer[j]:0;
-			b=buffer[intPosition+j];
-			c=buffer[intPosition+j+inChannels];
-			d=buffer[intPosition+j+inChannels*2];
+			float a = sampleAt(buffer, -1, j, inChannels, loop);
+			float b = sampleAt(buffer, 0, j, inChannels, loop);
+			float c = sampleAt(buffer, 1, j, inChannels, loop);
+			float d = sampleAt(buffer, 2, j, inChannels, loop);
 			*resBufferPtr++ = ofInterpolateHermite(a, b, c, d, remainder);
 		}
 		position += increment;
-		intPosition = position;
-		remainder = position - intPosition;
 		from++;
 	}
 	
-	for(std::size_t i=from;i<to;++i){
-		intPosition *= inChannels;
-		for(std::size_t j=0;j<inChannels;++j){
-			a=buffer[intPosition+j-inChannels];
-			b=buffer[intPosition+j];
-			c=buffer[intPosition+j+inChannels];
-			d=buffer[intPosition+j+inChannels*2];
-			*resBufferPtr++ = ofInterpolateHermite(a, b, c, d, remainder);
+	if(to > from){
+		switch(inChannels){
+			case 1:
+				hermiteResampleFrames<1>(buffer.data(), resBufferPtr, to - from, inChannels, position, increment);
+				break;
+			case 2:
+				hermiteResampleFrames<2>(buffer.data(), resBufferPtr, to - from, inChannels, position, increment);
+				break;
+			default:
+				hermiteResampleFrames<0>(buffer.data(), resBufferPtr, to - from, inChannels, position, increment);
+				break;
 		}
-		position += increment;
-		intPosition = position;
-		remainder = position - intPosition;
+		resBufferPtr += (to - from) * inChannels;
+	}else{
+		to = from;
 	}
 	
-	if(end>=size()-3*inChannels){
+	if(to < numFrames){
 		to = numFrames-to;
 		if(loop){
-			intPosition %= size();
 			for(std::size_t i=0;i<to;++i){
+				long long intPosition = floor(position);
+				float remainder = position - intPosition;
 				for(std::size_t j=0;j<inChannels;++j){
-					a=buffer[intPosition+j-inChannels];
-					b=buffer[intPosition+j];
-					c=buffer[intPosition+j+inChannels];
-					d=buffer[intPosition+j+inChannels*2];
+					float a = sampleAt(buffer, intPosition - 1, j, inChannels, loop);
+					float b = sampleAt(buffer, intPosition, j, inChannels, loop);
+					float c = sampleAt(buffer, intPosition + 1, j, inChannels, loop);
+					float d = sampleAt(buffer, intPosition + 2, j, inChannels, loop);
 					*resBufferPtr++ = ofInterpolateHermite(a, b, c, d, remainder);
 				}
 				position += increment;
-				intPosition = position;
-				remainder = position - intPosition;
-				intPosition *= inChannels;
 			}
 		}else{
 			memset(resBufferPtr,0,to*copySize);
@@ -472,6 +876,87 @@ void ofSoundBuffer::hermiteResampleTo(ofSoundBuffer &outBuffer, std::size_t from
 	}
 }
 
+// band limited interpolation with a windowed sinc. When speeding up, the
+// kernel is stretched to filter out what would alias above the new nyquist
+void ofSoundBuffer::sincResampleTo(ofSoundBuffer &outBuffer, std::size_t fromFrame, std::size_t numFrames, float speed, bool loop) const {
+
+	std::size_t inChannels = getNumChannels();
+	long long inFrames = getNumFrames();
+	bool bufferReady = prepareBufferForResampling(*this, outBuffer, numFrames);
+
+	if(!bufferReady) {
+		outBuffer = *this;
+		return;
+	}
+	if(inFrames == 0 || numFrames == 0){
+		return;
+	}
+
+	const float * table;
+	std::size_t taps;
+	if(speed <= 1){
+		table = sincPolyphaseTable().data();
+		taps = sincTaps;
+	}else{
+		const StretchedSincTable & stretched = stretchedSincTable(1.f / speed);
+		table = stretched.table.data();
+		taps = stretched.taps;
+	}
+	const long long radius = taps / 2;
+	thread_local vector<float> frame;
+	frame.resize(inChannels * 2);
+
+	double position = fromFrame;
+	float increment = speed;
+	float * resBufferPtr = &outBuffer[0];
+	for(std::size_t i=0;i<numFrames;i++){
+		long long center = (long long)floor(position);
+		float phase = position - center;
+		long long first = center - (radius - 1);
+
+		// the result is interpolated between the results of the two
+		// closest rows of the polyphase table
+		float rowPosition = phase * sincPhases;
+		std::size_t index = std::min<std::size_t>(rowPosition, sincPhases - 1);
+		float rowMix = rowPosition - index;
+		const float * rows[2];
+		rows[0] = &table[index * taps];
+		rows[1] = rows[0] + taps;
+
+		for(std::size_t row=0;row<2;row++){
+			float * result = &frame[row * inChannels];
+			if(first >= 0 && first + (long long)taps <= inFrames){
+				const float * in = &buffer[first * inChannels];
+				if(inChannels == 1){
+					*result = dotProduct(rows[row], in, taps);
+				}else if(inChannels == 2){
+					dotProductStereo(rows[row], in, taps, result);
+				}else{
+					std::fill(result, result + inChannels, 0.f);
+					for(std::size_t t=0;t<taps;t++){
+						for(std::size_t j=0;j<inChannels;j++){
+							result[j] += rows[row][t] * in[t * inChannels + j];
+						}
+					}
+				}
+			}else{
+				for(std::size_t j=0;j<inChannels;j++){
+					float sample = 0;
+					for(std::size_t t=0;t<taps;t++){
+						sample += rows[row][t] * sampleAt(buffer, first + t, j, inChannels, loop);
+					}
+					result[j] = sample;
+				}
+			}
+		}
+
+		for(std::size_t j=0;j<inChannels;j++){
+			*resBufferPtr++ = ofLerp(frame[j], frame[inChannels + j], rowMix);
+		}
+		position += increment;
+	}
+}
+
 void ofSoundBuffer::resampleTo(ofSoundBuffer & buffer, std::size_t fromFrame, std::size_t numFrames, float speed, bool loop, InterpolationAlgorithm algorithm) const {
 	switch(algorithm){
 		case Linear:
@@ -480,6 +965,9 @@ void ofSoundBuffer::resampleTo(ofSoundBuffer & buffer, std::size_t fromFrame, st
 		case Hermite:
 			hermiteResampleTo(buffer, fromFrame, numFrames, speed, loop);
 			break;
+		case Sinc:
+			sincResampleTo(buffer, fromFrame, numFrames, speed, loop);
+			break;
 	}
 }
 
@@ -528,10 +1016,7 @@ void ofSoundBuffer::setChannel(const ofSoundBuffer & inBuffer, std::size_t targe
 }
 
 float ofSoundBuffer::getRMSAmplitude() const {
-	double acc = 0;
-	for(size_t i = 0; i < buffer.size(); i++){
-		acc += buffer[i] * buffer[i];
-	}
+	double acc = sumSquares(buffer.data(), buffer.size(), 1);
 	return sqrt(acc / (double)buffer.size());
 }
 
@@ -540,23 +1025,17 @@ float ofSoundBuffer::getRMSAmplitudeChannel(std::size_t channel) const {
 		return 0;
 	}
 
-	double acc = 0;
-	for(size_t i = 0; i < getNumFrames(); i++) {
-		float sample = getSample(i, channel);
-		acc += sample * sample;
-	}
+	double acc = sumSquares(buffer.data() + channel, getNumFrames(), channels);
 	return sqrt(acc / (double)getNumFrames());
 }
 
 void ofSoundBuffer::normalize(float level){
-	float maxAmplitude = 0;
-	for(std::size_t i = 0; i < size(); i++) {
-		maxAmplitude = max(maxAmplitude, abs(buffer[i]));
+	float maxAmplitude = maxAbs(buffer.data(), size());
+	if(maxAmplitude == 0){
+		return;
 	}
 	float normalizationFactor = level/maxAmplitude;
-	for(std::size_t i = 0; i < size(); i++) {
-		buffer[i] *= normalizationFactor;
-	}
+	scaleSamples(buffer.data(), normalizationFactor, size());
 }
 
 bool ofSoundBuffer::trimSilence(float threshold, bool trimStart, bool trimEnd) {
@@ -88,7 +88,8 @@ public:
 
 	enum InterpolationAlgorithm{
 		Linear,
-		Hermite
+		Hermite,
+		Sinc ///< windowed sinc, slower but band limited so it doesn't alias
 	};
 	static InterpolationAlgorithm defaultAlgorithm;  //defaults to Linear for mobile, Hermite for desktop
 
@@ -188,6 +189,9 @@ public:
 	
 	void linearResampleTo(ofSoundBuffer & buffer, std::size_t fromFrame, std::size_t numFrames, float speed, bool loop) const;
 	void hermiteResampleTo(ofSoundBuffer & buffer, std::size_t fromFrame, std::size_t numFrames, float speed, bool loop) const;
+	/// high quality resampling with a windowed sinc from precomputed polyphase tables, 32 taps per output frame
+	/// when slowing down and proportionally more when speeding up to filter out what would alias.
+	void sincResampleTo(ofSoundBuffer & buffer, std::size_t fromFrame, std::size_t numFrames, float speed, bool loop) const;
 	
 	/// fills the buffer with random noise between -amplitude and amplitude. useful for debugging.
 	void fillWithNoise(float amplitude = 1.0f);
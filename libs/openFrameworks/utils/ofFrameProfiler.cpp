@@ -0,0 +1,473 @@
+#include "ofFrameProfiler.h"
+#include "ofFileUtils.h"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <iomanip>
+
+using namespace std;
+
+namespace{
+	const size_t threadBufferSize = 4096;
+
+	// every profiler gets an id so a thread can tell if the buffer it
+	// registered belongs to the profiler it's measuring now
+	std::atomic<uint64_t> nextProfilerId{1};
+
+	int getBucket(uint64_t nanos, int subBuckets){
+		if(nanos < uint64_t(subBuckets)){
+			return int(nanos);
+		}
+		int exponent = 63;
+		while(!(nanos & (uint64_t(1) << exponent))){
+			exponent--;
+		}
+		// the 3 bits after the highest one select the sub bucket
+		int shift = exponent - 3;
+		int sub = int((nanos >> shift) & (subBuckets - 1));
+		return (exponent - 2) * subBuckets + sub;
+	}
+
+	uint64_t getBucketValue(int bucket, int subBuckets){
+		if(bucket < subBuckets){
+			return uint64_t(bucket);
+		}
+		int exponent = bucket / subBuckets + 2;
+		int sub = bucket % subBuckets;
+		int shift = exponent - 3;
+		// middle of the bucket
+		uint64_t low = (uint64_t(subBuckets + sub) << shift);
+		return low + ((uint64_t(1) << shift) >> 1);
+	}
+
+	void writeJsonString(ostream & out, const string & str){
+		out << '"';
+		for(auto c: str){
+			switch(c){
+			case '"': out << "\\\""; break;
+			case '\\': out << "\\\\"; break;
+			case '\n': out << "\\n"; break;
+			case '\t': out << "\\t"; break;
+			default:
+				if((unsigned char)c < 0x20){
+					out << "\\u" << hex << setw(4) << setfill('0') << int(c) << dec << setfill(' ');
+				}else{
+					out << c;
+				}
+			}
+		}
+		out << '"';
+	}
+}
+
+//----------------------------------------
+void ofDurationHistogram::add(uint64_t nanos){
+	buckets[getBucket(nanos, subBuckets)]++;
+	if(count == 0 || nanos < min) min = nanos;
+	if(nanos > max) max = nanos;
+	total += nanos;
+	count++;
+}
+
+//----------------------------------------
+void ofDurationHistogram::clear(){
+	buckets.fill(0);
+	count = 0;
+	total = 0;
+	min = 0;
+	max = 0;
+}
+
+//----------------------------------------
+uint64_t ofDurationHistogram::getCount() const{
+	return count;
+}
+
+//----------------------------------------
+uint64_t ofDurationHistogram::getMin() const{
+	return min;
+}
+
+//----------------------------------------
+uint64_t ofDurationHistogram::getMax() const{
+	return max;
+}
+
+//----------------------------------------
+double ofDurationHistogram::getMean() const{
+	return count ? double(total) / double(count) : 0.;
+}
+
+//----------------------------------------
+uint64_t ofDurationHistogram::getPercentile(double percentile) const{
+	if(count == 0){
+		return 0;
+	}
+	auto rank = uint64_t(std::ceil(std::max(0., std::min(percentile, 1.)) * count));
+	if(rank == 0) rank = 1;
+	uint64_t accumulated = 0;
+	for(size_t i = 0; i < buckets.size(); i++){
+		accumulated += buckets[i];
+		if(accumulated >= rank){
+			return std::max(min, std::min(getBucketValue(int(i), subBuckets), max));
+		}
+	}
+	return max;
+}
+
+//----------------------------------------
+struct ofFrameProfiler::ThreadBuffer{
+	struct Zone{
+		const char * name;
+		uint64_t start;
+		uint64_t end;
+	};
+
+	uint32_t thread;
+	std::vector<Zone> zones = std::vector<Zone>(threadBufferSize);
+	// head is only written by the thread measuring, tail by the one
+	// collecting the zones
+	std::atomic<size_t> head{0};
+	std::atomic<size_t> tail{0};
+	std::atomic<uint64_t> dropped{0};
+
+	void push(const char * name, uint64_t start, uint64_t end){
+		auto h = head.load(std::memory_order_relaxed);
+		auto t = tail.load(std::memory_order_acquire);
+		if(h - t == zones.size()){
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		zones[h & (zones.size() - 1)] = {name, start, end};
+		head.store(h + 1, std::memory_order_release);
+	}
+};
+
+namespace{
+	struct ThreadRegistration{
+		uint64_t profiler = 0;
+		std::shared_ptr<void> buffer;
+	};
+	thread_local ThreadRegistration threadRegistration;
+}
+
+//----------------------------------------
+ofFrameProfiler::ofFrameProfiler()
+:id(nextProfilerId++)
+,clockStart(now()){
+}
+
+//----------------------------------------
+ofFrameProfiler::~ofFrameProfiler(){
+}
+
+//----------------------------------------
+uint64_t ofFrameProfiler::now(){
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//----------------------------------------
+void ofFrameProfiler::setEnabled(bool enabled){
+	this->enabled = enabled;
+}
+
+//----------------------------------------
+bool ofFrameProfiler::isEnabled() const{
+	return enabled.load(std::memory_order_relaxed);
+}
+
+//----------------------------------------
+void ofFrameProfiler::newFrame(){
+	if(!isEnabled()){
+		return;
+	}
+	auto time = now();
+	if(frameStart != 0){
+		currentFrame.duration = time - frameStart;
+		frameHistogram.add(currentFrame.duration);
+		for(size_t i = 0; i < phaseHistograms.size(); i++){
+			if(phaseRan[i]){
+				phaseHistograms[i].add(currentFrame.phases[i]);
+			}
+		}
+		addTraceEvent("frame", frameStart, currentFrame.duration, 0, Frame_);
+		lastFrame = currentFrame;
+		numFrames++;
+	}
+	collectZones();
+	currentFrame = Frame();
+	currentFrame.number = numFrames;
+	phaseRan.fill(false);
+	frameStart = time;
+}
+
+//----------------------------------------
+void ofFrameProfiler::beginPhase(ofFramePhase phase){
+	if(!isEnabled()){
+		return;
+	}
+	phaseStart[phase] = now();
+}
+
+//----------------------------------------
+void ofFrameProfiler::endPhase(ofFramePhase phase){
+	if(!isEnabled() || phaseStart[phase] == 0){
+		return;
+	}
+	auto start = phaseStart[phase];
+	auto duration = now() - start;
+	phaseStart[phase] = 0;
+	// a phase can run more than once per frame, like the events of
+	// several windows, the frame gets the total
+	currentFrame.phases[phase] += duration;
+	phaseRan[phase] = true;
+	addTraceEvent(getPhaseName(phase), start, duration, 0, Phase);
+}
+
+//----------------------------------------
+ofFrameProfiler::ThreadBuffer & ofFrameProfiler::getThreadBuffer(){
+	auto & registration = threadRegistration;
+	if(registration.profiler != id){
+		auto buffer = make_shared<ThreadBuffer>();
+		{
+			std::unique_lock<std::mutex> lock(threadsMutex);
+			buffer->thread = nextThread++;
+			threads.push_back(buffer);
+		}
+		registration.profiler = id;
+		registration.buffer = buffer;
+	}
+	return *static_cast<ThreadBuffer*>(registration.buffer.get());
+}
+
+//----------------------------------------
+void ofFrameProfiler::addZone(const char * name, uint64_t start, uint64_t end){
+	if(!isEnabled()){
+		return;
+	}
+	getThreadBuffer().push(name, start, end);
+}
+
+//----------------------------------------
+void ofFrameProfiler::setThreadName(const string & name){
+	auto thread = getThreadBuffer().thread;
+	std::unique_lock<std::mutex> lock(threadsMutex);
+	threadNames[thread] = name;
+}
+
+//----------------------------------------
+void ofFrameProfiler::collectZones(){
+	std::unique_lock<std::mutex> lock(threadsMutex);
+	for(auto it = threads.begin(); it != threads.end();){
+		auto & buffer = **it;
+		auto t = buffer.tail.load(std::memory_order_relaxed);
+		auto h = buffer.head.load(std::memory_order_acquire);
+		for(; t != h; t++){
+			auto & zone = buffer.zones[t & (buffer.zones.size() - 1)];
+			// different literals can have the same name, and once a zone is
+			// collected its name can be freed and the pointer reused
+			auto & histogram = zoneHistogramsByName[zone.name];
+			if(!histogram.name || strcmp(histogram.name, zone.name) != 0){
+				auto named = zoneHistograms.emplace(zone.name, ofDurationHistogram()).first;
+				histogram.name = named->first.c_str();
+				histogram.histogram = &named->second;
+			}
+			auto duration = zone.end - zone.start;
+			histogram.histogram->add(duration);
+			addTraceEvent(histogram.name, zone.start, duration, buffer.thread, Zone);
+		}
+		buffer.tail.store(h, std::memory_order_release);
+		droppedZones += buffer.dropped.exchange(0, std::memory_order_relaxed);
+
+		// the thread finished and everything it measured was collected
+		if(it->use_count() == 1 && buffer.head.load(std::memory_order_acquire) == h){
+			it = threads.erase(it);
+		}else{
+			++it;
+		}
+	}
+}
+
+//----------------------------------------
+void ofFrameProfiler::addTraceEvent(const char * name, uint64_t start, uint64_t duration, uint32_t thread, Category category){
+	if(traceCapacity == 0){
+		return;
+	}
+	TraceEvent event{name, start, duration, thread, category};
+	if(trace.size() < traceCapacity){
+		trace.push_back(event);
+	}else{
+		trace[traceNext] = event;
+	}
+	traceNext = (traceNext + 1) % traceCapacity;
+}
+
+//----------------------------------------
+const ofFrameProfiler::Frame & ofFrameProfiler::getLastFrame() const{
+	return lastFrame;
+}
+
+//----------------------------------------
+uint64_t ofFrameProfiler::getNumFrames() const{
+	return numFrames;
+}
+
+//----------------------------------------
+const ofDurationHistogram & ofFrameProfiler::getFrameHistogram() const{
+	return frameHistogram;
+}
+
+//----------------------------------------
+const ofDurationHistogram & ofFrameProfiler::getPhaseHistogram(ofFramePhase phase) const{
+	return phaseHistograms[phase];
+}
+
+//----------------------------------------
+const map<string, ofDurationHistogram> & ofFrameProfiler::getZoneHistograms() const{
+	return zoneHistograms;
+}
+
+//----------------------------------------
+uint64_t ofFrameProfiler::getNumDroppedZones() const{
+	return droppedZones;
+}
+
+//----------------------------------------
+const char * ofFrameProfiler::getPhaseName(ofFramePhase phase){
+	switch(phase){
+	case OF_FRAME_PHASE_UPDATE: return "update";
+	case OF_FRAME_PHASE_DRAW: return "draw";
+	case OF_FRAME_PHASE_WAIT: return "wait";
+	case OF_FRAME_PHASE_SWAP: return "swap";
+	case OF_FRAME_PHASE_EVENTS: return "events";
+	default: return "unknown";
+	}
+}
+
+//----------------------------------------
+string ofFrameProfiler::getSummary() const{
+	stringstream ss;
+	ss << fixed << setprecision(2);
+	auto line = [&](const string & name, const ofDurationHistogram & histogram){
+		if(histogram.getCount() == 0){
+			return;
+		}
+		ss << left << setw(20) << name << right
+		   << " count " << setw(8) << histogram.getCount()
+		   << " mean " << setw(9) << histogram.getMean() / 1000.
+		   << " p50 " << setw(9) << histogram.getPercentile(0.5) / 1000.
+		   << " p95 " << setw(9) << histogram.getPercentile(0.95) / 1000.
+		   << " p99 " << setw(9) << histogram.getPercentile(0.99) / 1000.
+		   << " max " << setw(9) << histogram.getMax() / 1000.
+		   << " us" << endl;
+	};
+	line("frame", frameHistogram);
+	for(int i = 0; i < OF_FRAME_NUM_PHASES; i++){
+		line(getPhaseName(ofFramePhase(i)), phaseHistograms[i]);
+	}
+	for(auto & zone: zoneHistograms){
+		line(zone.first, zone.second);
+	}
+	if(droppedZones){
+		ss << droppedZones << " zones dropped" << endl;
+	}
+	return ss.str();
+}
+
+//----------------------------------------
+void ofFrameProfiler::clear(){
+	frameHistogram.clear();
+	for(auto & histogram: phaseHistograms){
+		histogram.clear();
+	}
+	zoneHistograms.clear();
+	zoneHistogramsByName.clear();
+	trace.clear();
+	traceNext = 0;
+	droppedZones = 0;
+	numFrames = 0;
+	lastFrame = Frame();
+	currentFrame = Frame();
+	phaseRan.fill(false);
+	phaseStart.fill(0);
+	frameStart = 0;
+}
+
+//----------------------------------------
+void ofFrameProfiler::setTraceCapacity(size_t events){
+	trace.clear();
+	trace.shrink_to_fit();
+	traceNext = 0;
+	traceCapacity = events;
+}
+
+//----------------------------------------
+string ofFrameProfiler::getTrace(){
+	stringstream ss;
+	ss << "{\"traceEvents\":[";
+	bool first = true;
+	auto separator = [&]{
+		if(!first) ss << ",";
+		ss << "\n";
+		first = false;
+	};
+
+	{
+		std::unique_lock<std::mutex> lock(threadsMutex);
+		separator();
+		ss << R"({"name":"thread_name","ph":"M","pid":0,"tid":0,"args":{"name":"main"}})";
+		for(auto & name: threadNames){
+			separator();
+			ss << R"({"name":"thread_name","ph":"M","pid":0,"tid":)" << name.first + 1 << R"(,"args":{"name":)";
+			writeJsonString(ss, name.second);
+			ss << "}}";
+		}
+	}
+
+	static const char * categories[] = {"frame", "phase", "zone"};
+	// oldest event first
+	size_t begin = trace.size() < traceCapacity ? 0 : traceNext;
+	for(size_t i = 0; i < trace.size(); i++){
+		auto & event = trace[(begin + i) % trace.size()];
+		auto start = event.start > clockStart ? event.start - clockStart : 0;
+		separator();
+		ss << R"({"name":)";
+		writeJsonString(ss, event.name);
+		// phases and frames run on the main thread, zones get their own
+		// track per thread after it
+		auto tid = event.category == Zone ? event.thread + 1 : 0;
+		ss << R"(,"cat":")" << categories[event.category] << R"(","ph":"X","ts":)"
+		   << start / 1000 << "." << setw(3) << setfill('0') << start % 1000 << setfill(' ')
+		   << R"(,"dur":)" << event.duration / 1000 << "." << setw(3) << setfill('0') << event.duration % 1000 << setfill(' ')
+		   << R"(,"pid":0,"tid":)" << tid << "}";
+	}
+	ss << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return ss.str();
+}
+
+//----------------------------------------
+bool ofFrameProfiler::saveTrace(const std::filesystem::path & path){
+	auto json = getTrace();
+	ofBuffer buffer(json.c_str(), json.size());
+	return ofBufferToFile(path, buffer, false);
+}
+
+//----------------------------------------
+ofFrameProfiler & ofGetFrameProfiler(){
+	static ofFrameProfiler * profiler = new ofFrameProfiler;
+	return *profiler;
+}
+
+//----------------------------------------
+ofProfilerZone::ofProfilerZone(const char * name)
+:name(name)
+,start(ofGetFrameProfiler().isEnabled() ? ofFrameProfiler::now() : 0){
+}
+
+//----------------------------------------
+ofProfilerZone::~ofProfilerZone(){
+	if(start){
+		ofGetFrameProfiler().addZone(name, start, ofFrameProfiler::now());
+	}
+}
@@ -0,0 +1,243 @@
+#pragma once
+
+#include "ofConstants.h"
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/// \brief Phases of a frame measured by ofFrameProfiler.
+enum ofFramePhase{
+	/// \brief The update event, ofApp::update and its listeners.
+	OF_FRAME_PHASE_UPDATE,
+	/// \brief The draw event, ofApp::draw and its listeners.
+	OF_FRAME_PHASE_DRAW,
+	/// \brief Sleeping in ofTimer::waitNext to keep the frame rate set
+	/// with ofSetFrameRate.
+	OF_FRAME_PHASE_WAIT,
+	/// \brief Swapping the window buffers, including waiting for vsync.
+	OF_FRAME_PHASE_SWAP,
+	/// \brief Polling and dispatching window events.
+	OF_FRAME_PHASE_EVENTS,
+	OF_FRAME_NUM_PHASES
+};
+
+/// \brief Histogram of durations with logarithmic buckets.
+///
+/// Every bucket is 1/8 of a power of 2 wide so percentiles are within
+/// about 10% of the real value, adding a duration is a couple of integer
+/// operations.
+class ofDurationHistogram{
+public:
+	void add(uint64_t nanos);
+	void clear();
+
+	uint64_t getCount() const;
+	uint64_t getMin() const;
+	uint64_t getMax() const;
+	double getMean() const;
+
+	/// \param percentile Between 0 and 1, 0.5 for the median.
+	/// \returns The duration in nanoseconds under which that fraction of
+	/// the durations fall.
+	uint64_t getPercentile(double percentile) const;
+
+private:
+	static const int subBuckets = 8;
+	std::array<uint64_t, 64 * subBuckets> buckets{};
+	uint64_t count = 0;
+	uint64_t total = 0;
+	uint64_t min = 0;
+	uint64_t max = 0;
+};
+
+/// \brief Low overhead profiler of the frames of the application.
+///
+/// The main loop reports how long the update, draw, frame rate wait,
+/// buffer swap and event phases take every frame and the profiler keeps a
+/// histogram for each of them and for the whole frame, which gives the
+/// median and the 95 or 99 percentiles that show frame drops.
+///
+/// Any thread can measure its own code with OF_PROFILE_ZONE, zones are
+/// written into a buffer per thread without locks and collected once per
+/// frame into a histogram per zone name.
+///
+/// The last events are also kept in a ring buffer that can be saved as a
+/// Chrome trace, open it in chrome://tracing or https://ui.perfetto.dev to
+/// see every frame, phase and zone on a timeline.
+///
+/// ~~~~{.cpp}
+/// void ofApp::update(){
+///     OF_PROFILE_ZONE("physics");
+///     world.update();
+/// }
+///
+/// void ofApp::keyPressed(int key){
+///     if(key == 'p'){
+///         cout << ofGetFrameProfiler().getSummary();
+///         ofGetFrameProfiler().saveTrace("trace.json");
+///     }
+/// }
+/// ~~~~
+///
+/// The histograms and frames are read and written from the main thread,
+/// only zones can be measured from other threads.
+class ofFrameProfiler{
+public:
+	struct Frame{
+		uint64_t number = 0;
+		/// \brief Duration of the frame in nanoseconds, from one update
+		/// to the next.
+		uint64_t duration = 0;
+		/// \brief Duration of every phase in nanoseconds, 0 if it didn't
+		/// happen in this frame.
+		std::array<uint64_t, OF_FRAME_NUM_PHASES> phases{};
+	};
+
+	ofFrameProfiler();
+	~ofFrameProfiler();
+
+	/// \brief Enabled by default, when disabled phases and zones cost a
+	/// check of a flag.
+	void setEnabled(bool enabled);
+	bool isEnabled() const;
+
+	/// \brief End the current frame and start a new one, called by the
+	/// main loop before the update event.
+	///
+	/// Collects the zones measured during the frame. With several windows
+	/// the update of each of them starts a new frame.
+	void newFrame();
+
+	/// \brief Start measuring phase, called by the main loop.
+	void beginPhase(ofFramePhase phase);
+
+	/// \brief End measuring phase, called by the main loop.
+	void endPhase(ofFramePhase phase);
+
+	/// \brief Record a zone measured by the calling thread.
+	///
+	/// name has to stay valid until the zones are collected at the next
+	/// frame, usually a string literal. The histograms and the trace keep
+	/// their own copy.
+	void addZone(const char * name, uint64_t start, uint64_t end);
+
+	/// \brief Name of the calling thread in traces.
+	void setThreadName(const std::string & name);
+
+	/// \returns The last complete frame.
+	const Frame & getLastFrame() const;
+	uint64_t getNumFrames() const;
+
+	const ofDurationHistogram & getFrameHistogram() const;
+	const ofDurationHistogram & getPhaseHistogram(ofFramePhase phase) const;
+
+	/// \returns The histograms of the zones collected until the last frame
+	/// by name.
+	const std::map<std::string, ofDurationHistogram> & getZoneHistograms() const;
+
+	/// \brief Zones lost because a thread measured more than fit in its
+	/// buffer in one frame.
+	uint64_t getNumDroppedZones() const;
+
+	/// \returns Count, mean, p50, p95, p99 and max in microseconds of the
+	/// frames, phases and zones, one per line.
+	std::string getSummary() const;
+
+	/// \brief Clear the histograms and the trace.
+	void clear();
+
+	/// \brief Number of events kept for the trace, 65536 by default.
+	void setTraceCapacity(size_t events);
+
+	/// \returns The kept events in the Chrome trace event format.
+	std::string getTrace();
+
+	/// \brief Save the kept events in the Chrome trace event format.
+	bool saveTrace(const std::filesystem::path & path);
+
+	static const char * getPhaseName(ofFramePhase phase);
+
+	/// \returns Time in nanoseconds of the clock used for phases and zones.
+	static uint64_t now();
+
+private:
+	struct ThreadBuffer;
+
+	enum Category{
+		Frame_,
+		Phase,
+		Zone,
+	};
+
+	struct TraceEvent{
+		const char * name;
+		uint64_t start;
+		uint64_t duration;
+		uint32_t thread;
+		Category category;
+	};
+
+	ThreadBuffer & getThreadBuffer();
+	void collectZones();
+	void addTraceEvent(const char * name, uint64_t start, uint64_t duration, uint32_t thread, Category category);
+
+	uint64_t id;
+	std::atomic<bool> enabled{true};
+	uint64_t clockStart;
+
+	// main thread
+	uint64_t frameStart = 0;
+	Frame currentFrame;
+	Frame lastFrame;
+	uint64_t numFrames = 0;
+	std::array<uint64_t, OF_FRAME_NUM_PHASES> phaseStart{};
+	std::array<bool, OF_FRAME_NUM_PHASES> phaseRan{};
+	ofDurationHistogram frameHistogram;
+	std::array<ofDurationHistogram, OF_FRAME_NUM_PHASES> phaseHistograms;
+	std::map<std::string, ofDurationHistogram> zoneHistograms;
+	// the key of zoneHistograms is the copy of the name the trace points to
+	struct ZoneHistogram{
+		const char * name = nullptr;
+		ofDurationHistogram * histogram = nullptr;
+	};
+	std::unordered_map<const char*, ZoneHistogram> zoneHistogramsByName;
+
+	std::vector<TraceEvent> trace;
+	size_t traceCapacity = 65536;
+	size_t traceNext = 0;
+
+	// buffers of every thread that measured zones
+	std::mutex threadsMutex;
+	std::vector<std::shared_ptr<ThreadBuffer>> threads;
+	std::map<uint32_t, std::string> threadNames;
+	uint32_t nextThread = 0;
+	uint64_t droppedZones = 0;
+};
+
+/// \brief The profiler of the application.
+ofFrameProfiler & ofGetFrameProfiler();
+
+/// \brief Measures the time until it goes out of scope as a zone of
+/// ofGetFrameProfiler(), use it through OF_PROFILE_ZONE.
+class ofProfilerZone{
+public:
+	ofProfilerZone(const char * name);
+	~ofProfilerZone();
+
+	ofProfilerZone(const ofProfilerZone &) = delete;
+	ofProfilerZone & operator=(const ofProfilerZone &) = delete;
+private:
+	const char * name;
+	uint64_t start;
+};
+
+#define OF_PROFILE_ZONE_CONCAT_(a, b) a##b
+#define OF_PROFILE_ZONE_CONCAT(a, b) OF_PROFILE_ZONE_CONCAT_(a, b)
+
+/// \brief Measure the rest of the enclosing scope as a zone called name,
+/// which has to be a string literal.
+#define OF_PROFILE_ZONE(name) ofProfilerZone OF_PROFILE_ZONE_CONCAT(ofProfilerZone_, __LINE__)(name)
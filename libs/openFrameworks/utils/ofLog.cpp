@@ -3,6 +3,7 @@
 #include "ofUtils.h"
 #include <map>
 #include <cstdarg>
+#include <cstdio>
 #ifdef TARGET_ANDROID
 	#include "ofxAndroidLogChannel.h"
 #endif
@@ -123,12 +124,15 @@ void ofLog::setAutoSpace(bool autoSpace){
 //-------------------------------------------------------
 ofLog::~ofLog(){
 	// don't log if we printed in the constructor already
-	if(!bPrinted){
-		_log(level,module,message.str());
+	if(!bPrinted && isEnabled()){
+		channel()->log(level,module,message->str());
 	}
 }
 
 bool ofLog::checkLog(ofLogLevel level, const string & module){
+	if(getModules().empty()){
+		return level >= currentLogLevel;
+	}
 	if(getModules().find(module)==getModules().end()){
 		if(level >= currentLogLevel) return true;
 	}else{
@@ -402,4 +406,168 @@ void ofFileLoggerChannel::log(ofLogLevel level, const string & module, const cha
 	file << ofVAArgsToString(format,args) << endl;
 }
 
+//--------------------------------------------------
+ofAsyncLoggerChannel::ofAsyncLoggerChannel(size_t capacity)
+:ofAsyncLoggerChannel(nullptr, "", false, capacity){
+}
+
+ofAsyncLoggerChannel::ofAsyncLoggerChannel(const std::filesystem::path & path, bool append, size_t capacity)
+:ofAsyncLoggerChannel(nullptr, path, append, capacity){
+}
+
+ofAsyncLoggerChannel::ofAsyncLoggerChannel(shared_ptr<ofBaseLoggerChannel> channel, size_t capacity)
+:ofAsyncLoggerChannel(channel, "", false, capacity){
+}
+
+ofAsyncLoggerChannel::ofAsyncLoggerChannel(shared_ptr<ofBaseLoggerChannel> channel, const std::filesystem::path & path, bool append, size_t capacity)
+:records(capacity, OF_THREAD_CHANNEL_REJECT, OF_THREAD_CHANNEL_MULTI_PRODUCER)
+,channel(channel){
+	if(!path.empty()){
+		file.open(path, append ? ofFile::Append : ofFile::WriteOnly);
+	}
+	thread = std::thread(&ofAsyncLoggerChannel::threadedFunction, this);
+}
+
+ofAsyncLoggerChannel::~ofAsyncLoggerChannel(){
+	// the thread writes everything queued until it finds the queue empty
+	// after seeing this
+	stopping = true;
+	thread.join();
+	file.close();
+}
+
+void ofAsyncLoggerChannel::setFormat(Format format){
+	outputFormat = format;
+}
+
+void ofAsyncLoggerChannel::flush(){
+	uint64_t target = queued;
+	std::unique_lock<std::mutex> lock(mutex);
+	condition.wait(lock, [&]{ return written >= target; });
+}
+
+uint64_t ofAsyncLoggerChannel::getNumDropped() const{
+	return records.getNumRejected();
+}
+
+uint64_t ofAsyncLoggerChannel::getNumWritten() const{
+	return written;
+}
+
+void ofAsyncLoggerChannel::log(ofLogLevel level, const string & module, const string & message){
+	Record record{level, module, message, std::chrono::system_clock::now(), std::this_thread::get_id()};
+	if(records.send(std::move(record))){
+		queued++;
+	}
+}
+
+void ofAsyncLoggerChannel::log(ofLogLevel level, const string & module, const char* format, ...){
+	va_list args;
+	va_start(args, format);
+	log(level, module, format, args);
+	va_end(args);
+}
+
+void ofAsyncLoggerChannel::log(ofLogLevel level, const string & module, const char* format, va_list args){
+	log(level, module, ofVAArgsToString(format, args));
+}
+
+void ofAsyncLoggerChannel::threadedFunction(){
+	// polls the queue instead of sleeping on it so the threads that log
+	// never have to lock a mutex to wake this one up
+	const std::chrono::microseconds minSleep(50), maxSleep(5000);
+	auto sleep = minSleep;
+	std::vector<Record> batch;
+	while(true){
+		bool stop = stopping;
+		records.receiveAll(batch);
+		if(!batch.empty()){
+			write(batch);
+			written += batch.size();
+			batch.clear();
+			sleep = minSleep;
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.notify_all();
+		}else if(stop){
+			break;
+		}else{
+			std::this_thread::sleep_for(sleep);
+			sleep = std::min(sleep * 2, maxSleep);
+		}
+	}
+}
+
+void ofAsyncLoggerChannel::write(std::vector<Record> & batch){
+	if(channel){
+		for(auto & record: batch){
+			channel->log(record.level, record.module, record.message);
+		}
+		return;
+	}
+
+	// a single write and flush per batch, errors go to stderr on the console
+	std::string out, err;
+	for(auto & record: batch){
+		format(record, !file.is_open() && record.level >= OF_LOG_ERROR ? err : out);
+	}
+	if(file.is_open()){
+		file.write(out.data(), out.size());
+		file.flush();
+	}else{
+		if(!out.empty()){
+			fwrite(out.data(), 1, out.size(), stdout);
+			fflush(stdout);
+		}
+		if(!err.empty()){
+			fwrite(err.data(), 1, err.size(), stderr);
+			fflush(stderr);
+		}
+	}
+}
+
+namespace{
+	void appendJsonString(std::string & out, const std::string & str){
+		out += '"';
+		for(auto c: str){
+			switch(c){
+				case '"': out += "\\\""; break;
+				case '\\': out += "\\\\"; break;
+				case '\n': out += "\\n"; break;
+				case '\r': out += "\\r"; break;
+				case '\t': out += "\\t"; break;
+				default:
+					if((unsigned char)c < 0x20){
+						char escaped[7];
+						snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char)c);
+						out += escaped;
+					}else{
+						out += c;
+					}
+			}
+		}
+		out += '"';
+	}
+}
+
+void ofAsyncLoggerChannel::format(const Record & record, std::string & out){
+	if(outputFormat == JsonLines){
+		auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(record.time.time_since_epoch()).count();
+		out += "{\"time\":" + std::to_string(millis);
+		out += ",\"level\":\"" + ofGetLogLevelName(record.level) + "\"";
+		out += ",\"module\":";
+		appendJsonString(out, record.module);
+		out += ",\"thread\":" + std::to_string(std::hash<std::thread::id>()(record.thread));
+		out += ",\"message\":";
+		appendJsonString(out, record.message);
+		out += "}\n";
+	}else{
+		out += "[" + ofGetLogLevelName(record.level, true) + "] ";
+		if(record.module != ""){
+			out += record.module + ": ";
+		}
+		out += record.message;
+		out += '\n';
+	}
+}
+
 #undef noopDeleter
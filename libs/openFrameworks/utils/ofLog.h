@@ -2,7 +2,10 @@
 
 #include "ofConstants.h"
 #include "ofFileUtils.h"
+#include "ofThreadChannel.h"
 #include <sstream>
+#include <memory>
+#include <chrono>
 
 /// \file
 /// ofLog provides an interface for writing text output from your app.
@@ -477,7 +480,9 @@ class ofLog{
 		/// \returns A reference to itself.
 		template <class T> 
 		ofLog& operator<<(const T& value){
-			message << value << getPadding();
+			if(isEnabled()){
+				*message << value << getPadding();
+			}
 			return *this;
 		}
 	
@@ -489,7 +494,9 @@ class ofLog{
 		/// \param func A function pointer that takes a std::ostream as an argument.
 		/// \returns A reference to itself.
 		ofLog& operator<<(std::ostream& (*func)(std::ostream&)){
-			func(message);
+			if(isEnabled()){
+				func(*message);
+			}
 			return *this;
 		}
 	
@@ -522,7 +529,21 @@ class ofLog{
 		/// \endcond
 	
 	private:
-		std::stringstream message;	///< Temporary buffer.
+		/// \brief Checks the level the first time something is streamed and
+		/// only creates the buffer if the message will be printed, so
+		/// filtered messages never format their values.
+		bool isEnabled(){
+			if(!bChecked){
+				bChecked = true;
+				if(checkLog(level, module)){
+					message.reset(new std::stringstream);
+				}
+			}
+			return message != nullptr;
+		}
+
+		std::unique_ptr<std::stringstream> message;	///< Temporary buffer, only allocated for enabled messages.
+		bool bChecked = false; ///< Has the level been checked already?
 		
 		static bool bAutoSpace; ///< Should space be added between messages?
 		
@@ -720,4 +741,96 @@ private:
 	
 };
 
+/// \brief A logger channel that writes from a background thread.
+///
+/// Writing to the console or a file can block for a long time, which is a
+/// problem when logging from audio or network threads. This channel only
+/// queues the message in a lock free ring buffer without waking up the
+/// writer, a background thread checks the buffer every few milliseconds
+/// while it's idle, writes every queued message at once and flushes once
+/// per batch.
+///
+/// If the messages arrive faster than they can be written and the buffer
+/// fills up, new messages are discarded instead of blocking the thread
+/// that logs them and counted in getNumDropped().
+///
+/// ~~~~{.cpp}
+///     // log to a file as one json object per line
+///     auto logger = std::make_shared<ofAsyncLoggerChannel>("log.jsonl", false);
+///     logger->setFormat(ofAsyncLoggerChannel::JsonLines);
+///     ofSetLoggerChannel(logger);
+/// ~~~~
+class ofAsyncLoggerChannel: public ofBaseLoggerChannel{
+public:
+	/// \brief How every message is written.
+	enum Format{
+		/// \brief "[level] module: message", like the other channels.
+		Text,
+		/// \brief One json object per line with the time in milliseconds
+		/// since the epoch, level, module, thread id and message.
+		JsonLines,
+	};
+
+	/// \brief Create a channel that writes to the console.
+	/// \param capacity Number of messages that can be waiting to be written.
+	ofAsyncLoggerChannel(size_t capacity = 8192);
+
+	/// \brief Create a channel that writes to a log file.
+	/// \param path The file path for the log file.
+	/// \param append True if the log data should be added to an existing file.
+	/// \param capacity Number of messages that can be waiting to be written.
+	ofAsyncLoggerChannel(const std::filesystem::path & path, bool append, size_t capacity = 8192);
+
+	/// \brief Create a channel that passes the messages to another channel
+	/// from the background thread.
+	/// \param channel The channel that writes the messages.
+	/// \param capacity Number of messages that can be waiting to be written.
+	ofAsyncLoggerChannel(std::shared_ptr<ofBaseLoggerChannel> channel, size_t capacity = 8192);
+
+	/// \brief Writes any pending message and stops the background thread.
+	virtual ~ofAsyncLoggerChannel();
+
+	/// \brief Set the output format, ignored when passing the messages to
+	/// another channel.
+	void setFormat(Format format);
+
+	/// \brief Block until every message logged before this call is written.
+	void flush();
+
+	/// \returns The number of messages discarded because the buffer was full.
+	uint64_t getNumDropped() const;
+
+	/// \returns The number of messages written so far.
+	uint64_t getNumWritten() const;
+
+	void log(ofLogLevel level, const std::string & module, const std::string & message);
+	void log(ofLogLevel level, const std::string & module, const char* format, ...) OF_PRINTF_ATTR(4, 5);
+	void log(ofLogLevel level, const std::string & module, const char* format, va_list args);
+
+private:
+	struct Record{
+		ofLogLevel level;
+		std::string module;
+		std::string message;
+		std::chrono::system_clock::time_point time;
+		std::thread::id thread;
+	};
+
+	ofAsyncLoggerChannel(std::shared_ptr<ofBaseLoggerChannel> channel, const std::filesystem::path & path, bool append, size_t capacity);
+	void threadedFunction();
+	void write(std::vector<Record> & records);
+	void format(const Record & record, std::string & out);
+
+	ofBoundedThreadChannel<Record> records;
+	std::shared_ptr<ofBaseLoggerChannel> channel;
+	ofFile file;
+	std::atomic<Format> outputFormat{Text};
+	std::atomic<uint64_t> queued{0};
+	std::atomic<uint64_t> written{0};
+	std::atomic<bool> stopping{false};
+	std::mutex mutex; ///< only used to wait in flush()
+	std::condition_variable condition;
+	std::thread thread;
+};
+
 /// \endcond
@@ -0,0 +1,318 @@
+#include "ofTaskPool.h"
+#include "ofThread.h"
+#include "ofLog.h"
+
+namespace{
+	// pool and queue of the worker running in the current thread if any
+	thread_local ofTaskPool * currentPool = nullptr;
+	thread_local size_t currentWorker = 0;
+
+	void runTask(std::function<void()> & task){
+		try{
+			task();
+		}catch(const std::exception & exc){
+			ofLogError("ofTaskPool") << "uncaught exception in task: " << exc.what();
+		}catch(...){
+			ofLogError("ofTaskPool") << "uncaught unknown exception in task";
+		}
+	}
+
+	// functions queued by every pool for the main thread, run by the
+	// windows before their update event instead of listening to
+	// ofEvents().update, which are the events of no window if the pool is
+	// first used before the app runs
+	struct MainThreadQueue{
+		std::mutex mutex;
+		std::vector<std::function<void()>> functions;
+	};
+
+	MainThreadQueue & mainThreadQueue(){
+		static MainThreadQueue queue;
+		return queue;
+	}
+
+	// shared between the thread calling parallelForRange and the helper
+	// tasks. helpers that start once every chunk has been taken return
+	// without touching the function which might not exist anymore
+	struct ParallelForState{
+		const std::function<void(size_t, size_t)> * function;
+		size_t begin;
+		size_t end;
+		size_t grain;
+		size_t numChunks;
+		std::atomic<size_t> next{0};
+		std::atomic<size_t> done{0};
+		std::atomic<bool> failed{false};
+		std::exception_ptr exception;
+		std::mutex mutex;
+		std::condition_variable condition;
+
+		void run(){
+			for(size_t chunk = next++; chunk < numChunks; chunk = next++){
+				if(!failed){
+					size_t chunkBegin = begin + chunk * grain;
+					size_t chunkEnd = std::min(chunkBegin + grain, end);
+					try{
+						(*function)(chunkBegin, chunkEnd);
+					}catch(...){
+						std::unique_lock<std::mutex> lock(mutex);
+						if(!exception){
+							exception = std::current_exception();
+						}
+						failed = true;
+					}
+				}
+				if(++done == numChunks){
+					std::unique_lock<std::mutex> lock(mutex);
+					condition.notify_all();
+				}
+			}
+		}
+	};
+}
+
+#ifndef TARGET_NO_THREADS
+//-------------------------------------------------
+class ofTaskPool::Worker: public ofThread{
+public:
+	Worker(ofTaskPool & pool, size_t index)
+	:pool(pool)
+	,index(index){
+		setThreadName("ofTaskPool " + std::to_string(index));
+	}
+
+	void threadedFunction(){
+		currentPool = &pool;
+		currentWorker = index;
+		std::function<void()> task;
+		while(true){
+			if(pool.pop(index, task)){
+				runTask(task);
+				task = nullptr;
+			}else if(!isThreadRunning()){
+				break;
+			}else{
+				std::unique_lock<std::mutex> lock(pool.mutex);
+				pool.sleeping++;
+				pool.condition.wait(lock, [this]{
+					return pool.pending > 0 || !isThreadRunning();
+				});
+				pool.sleeping--;
+			}
+		}
+		currentPool = nullptr;
+	}
+
+	ofTaskPool & pool;
+	size_t index;
+	std::mutex queueMutex;
+	std::deque<std::function<void()>> queue;
+};
+#else
+class ofTaskPool::Worker{
+public:
+	std::mutex queueMutex;
+	std::deque<std::function<void()>> queue;
+};
+#endif
+
+//-------------------------------------------------
+ofTaskPool::ofTaskPool(size_t numThreads){
+#ifndef TARGET_NO_THREADS
+	if(numThreads == 0){
+		size_t cores = std::thread::hardware_concurrency();
+		numThreads = cores > 1 ? cores - 1 : 1;
+	}
+	for(size_t i = 0; i < numThreads; i++){
+		workers.emplace_back(new Worker(*this, i));
+	}
+	for(auto & worker: workers){
+		worker->startThread();
+	}
+#endif
+	// constructed before the pool so it's still there when the destructor
+	// runs the last tasks
+	mainThreadQueue();
+}
+
+//-------------------------------------------------
+ofTaskPool::~ofTaskPool(){
+#ifndef TARGET_NO_THREADS
+	// workers keep running until their queues are empty
+	for(auto & worker: workers){
+		worker->stopThread();
+	}
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		condition.notify_all();
+	}
+	for(auto & worker: workers){
+		worker->waitForThread(false);
+	}
+#endif
+}
+
+//-------------------------------------------------
+void ofTaskPool::push(std::function<void()> && task){
+	if(workers.empty()){
+		runTask(task);
+		return;
+	}
+
+	// counted before it's queued so a worker never misses it, at worst
+	// it wakes up a bit too early
+	pending++;
+	if(currentPool == this){
+		std::unique_lock<std::mutex> lock(workers[currentWorker]->queueMutex);
+		workers[currentWorker]->queue.push_back(std::move(task));
+	}else{
+		std::unique_lock<std::mutex> lock(mutex);
+		queue.push_back(std::move(task));
+	}
+	if(sleeping > 0){
+		std::unique_lock<std::mutex> lock(mutex);
+		condition.notify_one();
+	}
+}
+
+//-------------------------------------------------
+bool ofTaskPool::pop(size_t worker, std::function<void()> & task){
+	if(pending == 0){
+		return false;
+	}
+
+	// newest task from our own queue
+	if(worker < workers.size()){
+		auto & own = *workers[worker];
+		std::unique_lock<std::mutex> lock(own.queueMutex);
+		if(!own.queue.empty()){
+			task = std::move(own.queue.back());
+			own.queue.pop_back();
+			pending--;
+			return true;
+		}
+	}
+
+	// tasks submitted from outside the pool
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		if(!queue.empty()){
+			task = std::move(queue.front());
+			queue.pop_front();
+			pending--;
+			return true;
+		}
+	}
+
+	// oldest task from any other worker
+	for(size_t i = 1; i <= workers.size(); i++){
+		size_t victimIndex = (worker + i) % workers.size();
+		if(victimIndex == worker){
+			continue;
+		}
+		auto & victim = *workers[victimIndex];
+		std::unique_lock<std::mutex> lock(victim.queueMutex);
+		if(!victim.queue.empty()){
+			task = std::move(victim.queue.front());
+			victim.queue.pop_front();
+			pending--;
+			return true;
+		}
+	}
+	return false;
+}
+
+//-------------------------------------------------
+bool ofTaskPool::runPending(){
+	std::function<void()> task;
+	if(pop(currentPool == this ? currentWorker : workers.size(), task)){
+		runTask(task);
+		return true;
+	}
+	return false;
+}
+
+//-------------------------------------------------
+void ofTaskPool::parallelForRange(size_t begin, size_t end, const std::function<void(size_t, size_t)> & function, size_t grain){
+	if(end <= begin){
+		return;
+	}
+	size_t count = end - begin;
+	if(grain == 0){
+		grain = std::max<size_t>(1, count / ((workers.size() + 1) * 4));
+	}
+	size_t numChunks = (count + grain - 1) / grain;
+	if(numChunks == 1 || workers.empty()){
+		function(begin, end);
+		return;
+	}
+
+	auto state = std::make_shared<ParallelForState>();
+	state->function = &function;
+	state->begin = begin;
+	state->end = end;
+	state->grain = grain;
+	state->numChunks = numChunks;
+
+	// the calling thread processes chunks too so this never waits for
+	// helpers that couldn't start because the pool is busy
+	size_t numHelpers = std::min(workers.size(), numChunks - 1);
+	for(size_t i = 0; i < numHelpers; i++){
+		push([state]{ state->run(); });
+	}
+	state->run();
+
+	{
+		std::unique_lock<std::mutex> lock(state->mutex);
+		state->condition.wait(lock, [&]{ return state->done == state->numChunks; });
+	}
+	if(state->exception){
+		std::rethrow_exception(state->exception);
+	}
+}
+
+//-------------------------------------------------
+void ofTaskPool::runOnMainThread(std::function<void()> function){
+	auto & queue = mainThreadQueue();
+	std::unique_lock<std::mutex> lock(queue.mutex);
+	queue.functions.push_back(std::move(function));
+}
+
+//-------------------------------------------------
+size_t ofTaskPool::getNumThreads() const{
+	return workers.size();
+}
+
+//-------------------------------------------------
+bool ofTaskPool::isWorkerThread() const{
+	return currentPool == this;
+}
+
+//-------------------------------------------------
+ofTaskPool & ofGetTaskPool(){
+	static ofTaskPool pool;
+	return pool;
+}
+
+//-------------------------------------------------
+void ofParallelForRange(size_t begin, size_t end, const std::function<void(size_t, size_t)> & function, size_t grain){
+	ofGetTaskPool().parallelForRange(begin, end, function, grain);
+}
+
+//-------------------------------------------------
+void ofRunOnMainThread(std::function<void()> function){
+	ofGetTaskPool().runOnMainThread(std::move(function));
+}
+
+//-------------------------------------------------
+void of::priv::runMainThreadQueue(){
+	auto & queue = mainThreadQueue();
+	std::vector<std::function<void()>> functions;
+	{
+		std::unique_lock<std::mutex> lock(queue.mutex);
+		std::swap(functions, queue.functions);
+	}
+	for(auto & function: functions){
+		function();
+	}
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "ofConstants.h"
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <vector>
+
+class ofTaskPool;
+
+namespace of{
+namespace priv{
+	// called by ofCoreEvents::notifyUpdate() before the update event
+	void runMainThreadQueue();
+
+	template<typename Result>
+	struct TaskContinuation{
+		template<typename Task, typename Continuation>
+		static void run(ofTaskPool & pool, Task & task, const std::shared_ptr<Continuation> & continuation);
+	};
+
+	template<>
+	struct TaskContinuation<void>{
+		template<typename Task, typename Continuation>
+		static void run(ofTaskPool & pool, Task & task, const std::shared_ptr<Continuation> & continuation);
+	};
+}
+}
+
+/// \class ofTaskPool
+/// \brief A pool of worker threads shared by short tasks.
+///
+/// ofThread is meant to run one long lived function in its own thread.
+/// ofTaskPool instead keeps a fixed number of ofThread workers around and
+/// distributes small tasks between them, so different parts of an
+/// application can run work in parallel without each of them starting its
+/// own threads and oversubscribing the cores.
+///
+/// Every worker has its own queue. Tasks submitted from a worker go to its
+/// own queue and are run last in first out, which keeps the data they use
+/// in that core's cache, while idle workers steal the oldest tasks from the
+/// other queues.
+///
+/// ~~~~{.cpp}
+///     // run a task in the background and get its result later
+///     std::future<ofMesh> mesh = ofGetTaskPool().submit([]{
+///         return ofMesh::sphere(100, 100);
+///     });
+///
+///     // process every row of an image in parallel
+///     ofParallelFor(0, pixels.getHeight(), [&](size_t y){
+///         processRow(pixels.getLine(y));
+///     });
+///
+///     // decode in the background and upload the result to a texture
+///     // in the main thread once it's ready
+///     ofGetTaskPool().submit([path]{
+///         ofPixels pixels;
+///         ofLoadImage(pixels, path);
+///         return pixels;
+///     }, [this](ofPixels pixels){
+///         texture.loadData(pixels);
+///     });
+/// ~~~~
+///
+/// Most applications should use the default pool returned by
+/// ofGetTaskPool() instead of creating their own.
+///
+/// \warning Waiting on a future returned by submit() from inside a task can
+/// deadlock if every worker does the same, use ofTaskPool::wait() instead
+/// which runs other pending tasks while it waits.
+class ofTaskPool{
+public:
+	/// \brief Create a pool with the specified number of worker threads.
+	///
+	/// \param numThreads Number of worker threads, 0 creates one less than
+	/// the number of cores since the thread calling parallelFor also does
+	/// part of the work.
+	explicit ofTaskPool(size_t numThreads = 0);
+
+	/// \brief Runs any task still queued and stops the worker threads.
+	~ofTaskPool();
+
+	ofTaskPool(const ofTaskPool &) = delete;
+	ofTaskPool & operator=(const ofTaskPool &) = delete;
+
+	/// \brief Run a task in one of the worker threads.
+	///
+	/// \param task Function without parameters.
+	/// \returns A future that will contain the result of the task or the
+	/// exception thrown by it.
+	template<typename Task>
+	std::future<typename std::result_of<Task()>::type> submit(Task && task){
+		using Result = typename std::result_of<Task()>::type;
+		auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+		auto future = packaged->get_future();
+		push([packaged]{ (*packaged)(); });
+		return future;
+	}
+
+	/// \brief Run a task in one of the worker threads and then call
+	/// onMainThread with its result from the main thread.
+	///
+	/// The continuation is called from the main thread before the next
+	/// update event, also if the task was submitted before the app started
+	/// running. If the task returns void the continuation takes no parameters.
+	/// If the task throws, the exception is logged and the continuation is
+	/// never called.
+	template<typename Task, typename Continuation>
+	void submit(Task && task, Continuation && onMainThread){
+		using Result = typename std::result_of<Task()>::type;
+		using TaskType = typename std::decay<Task>::type;
+		using ContinuationType = typename std::decay<Continuation>::type;
+		auto sharedTask = std::make_shared<TaskType>(std::forward<Task>(task));
+		auto continuation = std::make_shared<ContinuationType>(std::forward<Continuation>(onMainThread));
+		push([this, sharedTask, continuation]{
+			of::priv::TaskContinuation<Result>::run(*this, *sharedTask, continuation);
+		});
+	}
+
+	/// \brief Call function for every index in [begin, end) in parallel.
+	///
+	/// The range is split in chunks of grain indices that are distributed
+	/// between the workers and the calling thread, which doesn't return
+	/// until every index has been processed. Can be called from inside
+	/// other tasks.
+	///
+	/// \param function Function receiving a single size_t index.
+	/// \param grain Number of consecutive indices processed by the same
+	/// thread, 0 chooses a size that gives every thread a few chunks.
+	template<typename Function>
+	void parallelFor(size_t begin, size_t end, Function && function, size_t grain = 0){
+		parallelForRange(begin, end, [&function](size_t chunkBegin, size_t chunkEnd){
+			for(size_t i = chunkBegin; i < chunkEnd; i++){
+				function(i);
+			}
+		}, grain);
+	}
+
+	/// \brief Like parallelFor but function receives every chunk as a
+	/// [chunkBegin, chunkEnd) range, useful when there's some setup
+	/// shared by consecutive indices.
+	///
+	/// If function throws the rest of the chunks are skipped and the first
+	/// exception is rethrown in the calling thread.
+	void parallelForRange(size_t begin, size_t end, const std::function<void(size_t, size_t)> & function, size_t grain = 0);
+
+	/// \brief Wait for a future returned by submit() running other
+	/// pending tasks in the meantime.
+	template<typename T>
+	void wait(const std::future<T> & future){
+		while(future.wait_for(std::chrono::seconds(0)) != std::future_status::ready){
+			if(!runPending()){
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	/// \brief Queue a function to be called from the main thread before the
+	/// next update event.
+	void runOnMainThread(std::function<void()> function);
+
+	/// \returns The number of worker threads.
+	size_t getNumThreads() const;
+
+	/// \returns True if called from one of this pool's workers.
+	bool isWorkerThread() const;
+
+private:
+	class Worker;
+
+	void push(std::function<void()> && task);
+	bool pop(size_t worker, std::function<void()> & task);
+	bool runPending();
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::deque<std::function<void()>> queue;
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::atomic<size_t> pending{0};
+	std::atomic<size_t> sleeping{0};
+};
+
+/// \brief The task pool shared by the whole application.
+ofTaskPool & ofGetTaskPool();
+
+/// \brief Call function for every index in [begin, end) in parallel using
+/// the shared task pool.
+///
+/// \sa ofTaskPool::parallelFor
+template<typename Function>
+void ofParallelFor(size_t begin, size_t end, Function && function, size_t grain = 0){
+	ofGetTaskPool().parallelFor(begin, end, std::forward<Function>(function), grain);
+}
+
+/// \brief Call function for [begin, end) split in chunks processed in
+/// parallel using the shared task pool.
+///
+/// \sa ofTaskPool::parallelForRange
+void ofParallelForRange(size_t begin, size_t end, const std::function<void(size_t, size_t)> & function, size_t grain = 0);
+
+/// \brief Queue a function to be called from the main thread before the
+/// next update event.
+void ofRunOnMainThread(std::function<void()> function);
+
+template<typename Result>
+template<typename Task, typename Continuation>
+void of::priv::TaskContinuation<Result>::run(ofTaskPool & pool, Task & task, const std::shared_ptr<Continuation> & continuation){
+	auto result = std::make_shared<Result>(task());
+	pool.runOnMainThread([result, continuation]{
+		(*continuation)(std::move(*result));
+	});
+}
+
+template<typename Task, typename Continuation>
+void of::priv::TaskContinuation<void>::run(ofTaskPool & pool, Task & task, const std::shared_ptr<Continuation> & continuation){
+	task();
+	pool.runOnMainThread([continuation]{
+		(*continuation)();
+	});
+}
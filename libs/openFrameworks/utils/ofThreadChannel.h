@@ -3,6 +3,11 @@
 
 #include <mutex>
 #include <queue>
+#include <vector>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <chrono>
 #include <condition_variable>
 
 
@@ -179,6 +184,28 @@ public:
 		}
 	}
 
+	/// \brief Receive all the values sent so far without blocking.
+	///
+	/// Moves every value currently in the channel to the end of `sentValues`
+	/// locking the channel only once, which is faster than calling
+	/// tryReceive in a loop when many small values are sent.
+	///
+	/// \param sentValues Vector where the received values are appended.
+	/// \returns The number of received values, 0 if there was no new data or
+	/// the channel was closed.
+	size_t receiveAll(std::vector<T> & sentValues){
+		std::unique_lock<std::mutex> lock(mutex);
+		if(closed){
+			return 0;
+		}
+		size_t received = queue.size();
+		while(!queue.empty()){
+			sentValues.emplace_back(std::move(queue.front()));
+			queue.pop();
+		}
+		return received;
+	}
+
 	/// \brief Send a value to the receiver by making a copy.
 	///
 	/// This method copies the contents of the sent value, leaving the original
@@ -292,3 +319,367 @@ private:
 	bool closed;
 
 };
+
+
+
+/// \brief What an ofBoundedThreadChannel does when sending to a full channel.
+enum ofThreadChannelOverflow{
+	/// \brief Wait until the receiver makes space, this applies backpressure
+	/// on the sender.
+	OF_THREAD_CHANNEL_BLOCK,
+	/// \brief Don't send the new value, send returns false.
+	OF_THREAD_CHANNEL_REJECT,
+	/// \brief Discard the oldest value in the channel to make space for the
+	/// new one, useful for frames where only the most recent matter.
+	OF_THREAD_CHANNEL_DROP_OLDEST,
+};
+
+/// \brief Number of threads that can send to an ofBoundedThreadChannel.
+enum ofThreadChannelProducers{
+	/// \brief Only one thread sends and only one thread receives, this is the
+	/// fastest mode.
+	OF_THREAD_CHANNEL_SINGLE_PRODUCER,
+	/// \brief Several threads can send and receive at the same time.
+	OF_THREAD_CHANNEL_MULTI_PRODUCER,
+};
+
+
+/// \brief A fixed capacity, lock free version of ofThreadChannel.
+///
+/// ofBoundedThreadChannel has the same interface as ofThreadChannel but
+/// stores the values in a ring buffer allocated once on construction, so
+/// sending and receiving never allocate or lock a mutex while there's data
+/// or space available.
+///
+/// When the channel is full, sending blocks, fails or overwrites the oldest
+/// value depending on the ofThreadChannelOverflow policy, so a stalled
+/// receiver can't make the channel grow without limit.
+///
+/// Threads that have to wait, for data when receiving or for space when
+/// sending with OF_THREAD_CHANNEL_BLOCK, spin for a short time and then
+/// sleep until they are notified.
+///
+/// ~~~~{.cpp}
+/// // up to 4 frames in flight, the receiver always gets the most recent ones
+/// ofBoundedThreadChannel<ofPixels> frames(4, OF_THREAD_CHANNEL_DROP_OLDEST);
+/// ~~~~
+///
+/// In OF_THREAD_CHANNEL_SINGLE_PRODUCER mode only one thread can send and
+/// only one can receive at the same time. OF_THREAD_CHANNEL_DROP_OLDEST always
+/// works as OF_THREAD_CHANNEL_MULTI_PRODUCER since the sender needs to
+/// receive the values it discards.
+///
+/// \tparam T The data type sent by the channel, it has to be default
+/// constructible and movable.
+template<typename T>
+class ofBoundedThreadChannel{
+public:
+	/// \brief Create a channel with space for at least `capacity` values.
+	///
+	/// \param capacity Minimum number of values the channel can hold, rounded
+	/// up to the next power of two.
+	/// \param overflow What to do when sending to a full channel.
+	/// \param producers Whether more than one thread will send or receive.
+	ofBoundedThreadChannel(size_t capacity, ofThreadChannelOverflow overflow = OF_THREAD_CHANNEL_BLOCK, ofThreadChannelProducers producers = OF_THREAD_CHANNEL_SINGLE_PRODUCER)
+	:overflow(overflow)
+	,singleProducer(producers == OF_THREAD_CHANNEL_SINGLE_PRODUCER && overflow != OF_THREAD_CHANNEL_DROP_OLDEST){
+		size_t size = 1;
+		while(size < capacity){
+			size <<= 1;
+		}
+		mask = size - 1;
+		cells = std::vector<Cell>(size);
+		for(size_t i=0; i<size; i++){
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	ofBoundedThreadChannel(const ofBoundedThreadChannel &) = delete;
+	ofBoundedThreadChannel & operator=(const ofBoundedThreadChannel &) = delete;
+
+	/// \brief Block the receiving thread until a new sent value is available.
+	///
+	/// \sa ofThreadChannel::receive
+	/// \returns True if a new value was received or false if the channel was closed.
+	bool receive(T & sentValue){
+		return waitFor(receivers, receiverCondition, std::chrono::steady_clock::time_point::max(), [&]{
+			return canPop();
+		}, [&]{
+			return pop(sentValue);
+		});
+	}
+
+	/// \brief If available, receive a new sent value without blocking.
+	///
+	/// \sa ofThreadChannel::tryReceive
+	/// \returns True if a new value was received or false if there was no
+	/// new data or the channel was closed.
+	bool tryReceive(T & sentValue){
+		if(closed){
+			return false;
+		}
+		return pop(sentValue);
+	}
+
+	/// \brief If available, receive a new sent value or wait for a user-specified duration.
+	///
+	/// \sa ofThreadChannel::tryReceive
+	/// \returns True if a new value was received or false if there was no
+	/// new data after `timeoutMs` or the channel was closed.
+	bool tryReceive(T & sentValue, int64_t timeoutMs){
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+		return waitFor(receivers, receiverCondition, deadline, [&]{
+			return canPop();
+		}, [&]{
+			return pop(sentValue);
+		});
+	}
+
+	/// \brief Receive all the values sent so far without blocking.
+	///
+	/// \param sentValues Vector where the received values are appended.
+	/// \returns The number of received values.
+	size_t receiveAll(std::vector<T> & sentValues){
+		if(closed){
+			return 0;
+		}
+		size_t received = 0;
+		T value;
+		while(pop(value)){
+			sentValues.emplace_back(std::move(value));
+			received++;
+		}
+		return received;
+	}
+
+	/// \brief Send a value to the receiver by making a copy.
+	///
+	/// \returns true if the value was sent or false if the channel was closed
+	/// or, with OF_THREAD_CHANNEL_REJECT, the channel was full.
+	bool send(const T & value){
+		T copy(value);
+		return send(std::move(copy));
+	}
+
+	/// \brief Send a value to the receiver without making a copy.
+	///
+	/// \returns true if the value was sent or false if the channel was closed
+	/// or, with OF_THREAD_CHANNEL_REJECT, the channel was full.
+	bool send(T && value){
+		if(closed){
+			return false;
+		}
+		bool sent;
+		switch(overflow){
+			case OF_THREAD_CHANNEL_REJECT:
+				sent = push(value);
+				if(!sent){
+					rejected++;
+				}
+				break;
+			case OF_THREAD_CHANNEL_DROP_OLDEST:{
+				T oldest;
+				while(!push(value)){
+					if(pop(oldest)){
+						dropped++;
+					}
+				}
+				sent = true;
+			}break;
+			case OF_THREAD_CHANNEL_BLOCK:
+			default:
+				sent = waitFor(senders, senderCondition, std::chrono::steady_clock::time_point::max(), [&]{
+					return canPush();
+				}, [&]{
+					return push(value);
+				});
+				break;
+		}
+		return sent;
+	}
+
+	/// \brief Close the channel.
+	///
+	/// No new values can be sent or received and every thread waiting to send
+	/// or receive is woken up and returns false.
+	void close(){
+		std::unique_lock<std::mutex> lock(mutex);
+		closed = true;
+		receiverCondition.notify_all();
+		senderCondition.notify_all();
+	}
+
+	/// \brief Queries empty channel.
+	///
+	/// Like ofThreadChannel::empty this is only an approximation.
+	bool empty() const{
+		return size() == 0;
+	}
+
+	/// \brief Approximate number of values waiting to be received.
+	size_t size() const{
+		size_t tail = enqueuePos.load(std::memory_order_acquire);
+		size_t head = dequeuePos.load(std::memory_order_acquire);
+		return tail > head ? tail - head : 0;
+	}
+
+	/// \brief Maximum number of values the channel can hold.
+	size_t capacity() const{
+		return mask + 1;
+	}
+
+	/// \brief Number of values discarded with OF_THREAD_CHANNEL_DROP_OLDEST.
+	uint64_t getNumDropped() const{
+		return dropped;
+	}
+
+	/// \brief Number of sends that failed with OF_THREAD_CHANNEL_REJECT.
+	uint64_t getNumRejected() const{
+		return rejected;
+	}
+
+private:
+	struct Cell{
+		std::atomic<size_t> sequence;
+		T value;
+	};
+
+	// Bounded queue from Dmitry Vyukov: every cell has a sequence number that
+	// tells whether it's ready to be written or read for a certain position so
+	// producers and consumers only need to claim a position.
+	// In single producer mode positions are claimed with a plain store instead
+	// of a compare and swap.
+	bool push(T & value){
+		size_t pos = enqueuePos.load(std::memory_order_relaxed);
+		Cell * cell;
+		while(true){
+			cell = &cells[pos & mask];
+			size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			intptr_t diff = intptr_t(sequence) - intptr_t(pos);
+			if(diff == 0){
+				if(singleProducer){
+					enqueuePos.store(pos + 1, std::memory_order_relaxed);
+					break;
+				}else if(enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+					break;
+				}
+			}else if(diff < 0){
+				return false;
+			}else{
+				pos = enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+		cell->value = std::move(value);
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(receivers.load(std::memory_order_relaxed) > 0){
+			std::unique_lock<std::mutex> lock(mutex);
+			receiverCondition.notify_one();
+		}
+		return true;
+	}
+
+	bool pop(T & value){
+		size_t pos = dequeuePos.load(std::memory_order_relaxed);
+		Cell * cell;
+		while(true){
+			cell = &cells[pos & mask];
+			size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			intptr_t diff = intptr_t(sequence) - intptr_t(pos + 1);
+			if(diff == 0){
+				if(singleProducer){
+					dequeuePos.store(pos + 1, std::memory_order_relaxed);
+					break;
+				}else if(dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+					break;
+				}
+			}else if(diff < 0){
+				return false;
+			}else{
+				pos = dequeuePos.load(std::memory_order_relaxed);
+			}
+		}
+		std::swap(value, cell->value);
+		cell->sequence.store(pos + mask + 1, std::memory_order_release);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(senders.load(std::memory_order_relaxed) > 0){
+			std::unique_lock<std::mutex> lock(mutex);
+			senderCondition.notify_one();
+		}
+		return true;
+	}
+
+	bool canPush() const{
+		size_t pos = enqueuePos.load(std::memory_order_relaxed);
+		return cells[pos & mask].sequence.load(std::memory_order_acquire) == pos;
+	}
+
+	bool canPop() const{
+		size_t pos = dequeuePos.load(std::memory_order_relaxed);
+		return cells[pos & mask].sequence.load(std::memory_order_acquire) == pos + 1;
+	}
+
+	// spin-then-park: retries the operation for a while and then registers
+	// as a waiter and sleeps on the condition. The other side only locks the
+	// mutex to notify when there's someone waiting. The operation itself is
+	// never run with the mutex locked since it can notify the other side.
+	template<typename Ready, typename Operation>
+	bool waitFor(std::atomic<size_t> & waiters, std::condition_variable & condition, std::chrono::steady_clock::time_point deadline, Ready && ready, Operation && operation){
+		for(size_t i=0; i<spinCount; i++){
+			if(closed){
+				return false;
+			}
+			if(operation()){
+				return true;
+			}
+			if(i > spinCount / 2){
+				std::this_thread::yield();
+			}
+		}
+
+		waiters++;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		bool done = false;
+		while(!closed){
+			if(operation()){
+				done = true;
+				break;
+			}
+			std::unique_lock<std::mutex> lock(mutex);
+			if(closed || ready()){
+				continue;
+			}
+			if(condition.wait_until(lock, deadline) == std::cv_status::timeout){
+				lock.unlock();
+				done = !closed && operation();
+				break;
+			}
+		}
+		waiters--;
+		return done;
+	}
+
+	static const size_t spinCount = 256;
+
+	std::vector<Cell> cells;
+	size_t mask;
+	ofThreadChannelOverflow overflow;
+	bool singleProducer;
+
+	// keep the positions written by senders and receivers in different
+	// cache lines to avoid false sharing
+	char pad0[64];
+	std::atomic<size_t> enqueuePos{0};
+	char pad1[64];
+	std::atomic<size_t> dequeuePos{0};
+	char pad2[64];
+
+	std::atomic<bool> closed{false};
+	std::atomic<size_t> receivers{0};
+	std::atomic<size_t> senders{0};
+	std::atomic<uint64_t> dropped{0};
+	std::atomic<uint64_t> rejected{0};
+	std::mutex mutex;
+	std::condition_variable receiverCondition;
+	std::condition_variable senderCondition;
+};
@@ -10,6 +10,12 @@ using namespace std;
 	#include <curl/curl.h>
 	#include "ofThreadChannel.h"
 	#include "ofThread.h"
+	#include "ofLog.h"
+	#include <atomic>
+	#include <chrono>
+	#include <condition_variable>
+	#include <fstream>
+	#include <set>
 	static bool curlInited = false;
 #elif defined(TARGET_QT)
     #include <QNetworkAccessManager>
@@ -29,6 +35,371 @@ ofEvent<ofHttpResponse> & ofURLResponseEvent(){
 
 
 #if !defined(TARGET_IMPLEMENTS_URL_LOADER)
+namespace{
+	// state of a request while it's being transferred
+	struct ofURLTransfer{
+		ofURLTransfer(const ofHttpRequest & request)
+		:request(request)
+		,response(request, 0, ""){}
+
+		~ofURLTransfer(){
+			if(headers){
+				curl_slist_free_all(headers);
+			}
+		}
+
+		ofHttpRequest request;
+		ofHttpResponse response;
+		std::unique_ptr<ofFile> file;
+		curl_slist * headers = nullptr;
+		size_t bodySent = 0;
+		bool aborted = false;
+
+		// disk cache
+		bool cacheable = false;
+		bool cached = false;
+		std::string cachedPath;
+		uint64_t cachedSize = 0;
+		std::string etag;
+		std::string lastModified;
+		bool noStore = false;
+		uint64_t received = 0;
+		uint64_t contentHash = 14695981039346656037ull; // FNV-1a
+	};
+
+	// responses are stored in files named after the hash of their content,
+	// so the same data served from different urls is only stored once. the
+	// index maps every url to its validators and content file
+	class ofURLCache{
+	public:
+		struct Entry{
+			std::string url;
+			std::string etag;
+			std::string lastModified;
+			std::string content;
+			uint64_t size = 0;
+			uint64_t lastUsed = 0;
+		};
+
+		~ofURLCache(){
+			std::unique_lock<std::mutex> lock(mutex);
+			if(dirty){
+				save();
+			}
+		}
+
+		void setup(const std::filesystem::path & directory, uint64_t maxSize){
+			std::unique_lock<std::mutex> lock(mutex);
+			if(dirty){
+				save();
+			}
+			entries.clear();
+			byUse.clear();
+			contents.clear();
+			totalSize = 0;
+			generation++;
+			this->maxSize = maxSize;
+			this->directory = ofToDataPath(directory, true);
+			if(maxSize == 0){
+				return;
+			}
+			ofDirectory::createDirectory(this->directory, false, true);
+			load();
+			evict();
+		}
+
+		bool isEnabled(){
+			std::unique_lock<std::mutex> lock(mutex);
+			return maxSize > 0;
+		}
+
+		bool find(const std::string & url, Entry & entry){
+			std::unique_lock<std::mutex> lock(mutex);
+			auto it = entries.find(url);
+			if(it == entries.end()){
+				return false;
+			}
+			// a content file removed or truncated from outside is dropped
+			// instead of being served
+			auto path = getPath(it->second.content);
+			if(!ofFile::doesFileExist(path, false) || ofFile(path, ofFile::Reference).getSize() != it->second.size){
+				remove(it);
+				saveLater();
+				return false;
+			}
+			entry = it->second;
+			return true;
+		}
+
+		std::string getPath(const std::string & content){
+			return (directory / content).string();
+		}
+
+		// stores the content of file or data, whichever is not null. the
+		// files are written and compared without holding the lock, it's
+		// only taken to pick a name and to update the index
+		void store(const ofURLTransfer & transfer, const std::string & file){
+			Entry entry;
+			entry.url = transfer.request.url;
+			entry.etag = transfer.etag;
+			entry.lastModified = transfer.lastModified;
+			entry.size = transfer.received;
+
+			std::unique_lock<std::mutex> lock(mutex);
+			if(maxSize == 0 || entry.size > maxSize){
+				return;
+			}
+			auto storeGeneration = generation;
+			// the hash only picks the name, an existing file is only shared
+			// if it has the same bytes, otherwise the next free name is used
+			auto name = ofToHex(transfer.contentHash) + "-" + ofToHex(transfer.received);
+			for(int i = 0; ; i++){
+				entry.content = i == 0 ? name : name + "-" + ofToString(i);
+				auto path = getPath(entry.content);
+				auto content = contents.find(entry.content);
+				if(content == contents.end()){
+					if(writing.count(entry.content)){
+						// another transfer is storing a file with this name
+						continue;
+					}
+					// reserved until the file is in place, written to a
+					// temporary file first so a crash never leaves a
+					// truncated file with a valid name
+					writing.insert(entry.content);
+					lock.unlock();
+					auto temp = path + ".tmp";
+					bool written = file.empty() ?
+						ofBufferToFile(temp, transfer.response.data, true) :
+						ofFile::copyFromTo(file, temp, false, true);
+					written = written && ofFile::moveFromTo(temp, path, false, true);
+					lock.lock();
+					writing.erase(entry.content);
+					if(!written){
+						ofLogError("ofURLFileLoader") << "couldn't store " << entry.url << " in the cache";
+						return;
+					}
+					if(generation != storeGeneration){
+						// the cache was cleared or moved while writing
+						ofFile::removeFile(path, false);
+						return;
+					}
+					break;
+				}
+				// referenced while it's compared so it can't be evicted
+				content->second.urls++;
+				lock.unlock();
+				bool same = sameContent(path, transfer.response.data, file);
+				lock.lock();
+				if(generation != storeGeneration){
+					// cleared or moved while comparing, the reference is gone
+					return;
+				}
+				if(same){
+					entry.lastUsed = ++useCounter;
+					add(entry);
+				}
+				release(content);
+				if(same){
+					evict();
+					saveLater();
+					return;
+				}
+			}
+			entry.lastUsed = ++useCounter;
+			// referenced by the new entry before the previous one goes, in
+			// case both use the same content
+			add(entry);
+			evict();
+			saveLater();
+		}
+
+		void touch(const std::string & url){
+			std::unique_lock<std::mutex> lock(mutex);
+			auto it = entries.find(url);
+			if(it != entries.end()){
+				byUse.erase(it->second.lastUsed);
+				it->second.lastUsed = ++useCounter;
+				byUse[it->second.lastUsed] = url;
+				saveLater();
+			}
+		}
+
+		void count(ofHttpResponse::CacheStatus status, uint64_t bytes){
+			std::unique_lock<std::mutex> lock(mutex);
+			switch(status){
+				case ofHttpResponse::CACHE_HIT:
+					stats.hits++;
+					stats.bytesFromCache += bytes;
+					break;
+				case ofHttpResponse::CACHE_STALE:
+					stats.stale++;
+					stats.bytesFromCache += bytes;
+					break;
+				case ofHttpResponse::CACHE_MISS:
+					stats.misses++;
+					stats.bytesDownloaded += bytes;
+					break;
+				default:
+					break;
+			}
+		}
+
+		ofHttpCacheStats getStats(){
+			std::unique_lock<std::mutex> lock(mutex);
+			auto result = stats;
+			result.size = totalSize;
+			result.numEntries = entries.size();
+			return result;
+		}
+
+		void clear(){
+			std::unique_lock<std::mutex> lock(mutex);
+			for(auto & content: contents){
+				ofFile::removeFile(getPath(content.first), false);
+			}
+			entries.clear();
+			byUse.clear();
+			contents.clear();
+			totalSize = 0;
+			generation++;
+			save();
+		}
+
+	private:
+		// a content file and the number of urls that use it
+		struct Content{
+			uint64_t size = 0;
+			size_t urls = 0;
+		};
+
+		// replaces the entry for the same url if there's one
+		void add(const Entry & entry){
+			auto & content = contents[entry.content];
+			if(content.urls++ == 0){
+				content.size = entry.size;
+				totalSize += entry.size;
+			}
+			auto previous = entries.find(entry.url);
+			if(previous != entries.end()){
+				remove(previous);
+			}
+			entries[entry.url] = entry;
+			byUse[entry.lastUsed] = entry.url;
+		}
+
+		void remove(std::map<std::string, Entry>::iterator entry){
+			byUse.erase(entry->second.lastUsed);
+			release(contents.find(entry->second.content));
+			entries.erase(entry);
+		}
+
+		// the file of a content is removed with its last reference
+		void release(std::map<std::string, Content>::iterator content){
+			if(content != contents.end() && --content->second.urls == 0){
+				totalSize -= content->second.size;
+				ofFile::removeFile(getPath(content->first), false);
+				contents.erase(content);
+			}
+		}
+
+		void evict(){
+			while(!byUse.empty() && totalSize > maxSize){
+				remove(entries.find(byUse.begin()->second));
+			}
+		}
+
+		bool sameContent(const std::string & path, const ofBuffer & data, const std::string & file){
+			std::ifstream cached(path, std::ios::binary);
+			if(file.empty()){
+				std::vector<char> buffer(data.size());
+				cached.read(buffer.data(), buffer.size());
+				return cached.gcount() == std::streamsize(data.size()) && std::equal(buffer.begin(), buffer.end(), data.getData());
+			}
+			std::ifstream other(file, std::ios::binary);
+			std::vector<char> buffer1(65536), buffer2(65536);
+			while(cached && other){
+				cached.read(buffer1.data(), buffer1.size());
+				other.read(buffer2.data(), buffer2.size());
+				if(cached.gcount() != other.gcount() || !std::equal(buffer1.begin(), buffer1.begin() + cached.gcount(), buffer2.begin())){
+					return false;
+				}
+			}
+			return !cached && !other;
+		}
+
+		// one line per url: content, size, last use, etag, last modified, url
+		void load(){
+			std::ifstream index((directory / "index").string());
+			std::string line;
+			while(std::getline(index, line)){
+				auto fields = ofSplitString(line, "\t");
+				if(fields.size() != 6){
+					continue;
+				}
+				Entry entry;
+				entry.content = fields[0];
+				entry.size = ofFromString<uint64_t>(fields[1]);
+				entry.lastUsed = ofFromString<uint64_t>(fields[2]);
+				entry.etag = fields[3];
+				entry.lastModified = fields[4];
+				entry.url = fields[5];
+				if(ofFile::doesFileExist(getPath(entry.content), false) && !byUse.count(entry.lastUsed)){
+					add(entry);
+					useCounter = std::max(useCounter, entry.lastUsed);
+				}
+			}
+			// files stored after the index was last saved
+			ofDirectory dir(directory);
+			dir.listDir();
+			for(auto & file: dir){
+				auto name = file.getFileName();
+				if(name != "index" && !contents.count(name)){
+					ofFile::removeFile(file.getAbsolutePath(), false);
+				}
+			}
+		}
+
+		// the index is saved at most once a second, hits only change the
+		// order of use which isn't worth rewriting the whole index each time
+		void saveLater(){
+			dirty = true;
+			auto now = std::chrono::steady_clock::now();
+			if(now - lastSave >= std::chrono::seconds(1)){
+				save();
+			}
+		}
+
+		void save(){
+			auto path = (directory / "index").string();
+			{
+				std::ofstream index(path + ".tmp");
+				for(auto & it: entries){
+					auto & entry = it.second;
+					index << entry.content << "\t" << entry.size << "\t" << entry.lastUsed << "\t"
+						  << entry.etag << "\t" << entry.lastModified << "\t" << entry.url << "\n";
+				}
+			}
+			ofFile::moveFromTo(path + ".tmp", path, false, true);
+			dirty = false;
+			lastSave = std::chrono::steady_clock::now();
+		}
+
+		std::mutex mutex;
+		std::filesystem::path directory;
+		uint64_t maxSize = 0;
+		uint64_t useCounter = 0;
+		uint64_t totalSize = 0; ///< of the content files, each counted once
+		std::map<std::string, Entry> entries; ///< by url
+		std::map<uint64_t, std::string> byUse; ///< url of every entry by last use, oldest first
+		std::map<std::string, Content> contents; ///< by file name
+		std::set<std::string> writing; ///< names of the content files being stored
+		uint64_t generation = 0; ///< changes when the contents are cleared, stores in progress are dropped
+		bool dirty = false;
+		std::chrono::steady_clock::time_point lastSave;
+		ofHttpCacheStats stats;
+	};
+}
+
 class ofURLFileLoaderImpl: public ofThread, public ofBaseURLFileLoader{
 public:
 	ofURLFileLoaderImpl();
@@ -42,6 +413,11 @@ public:
 	void stop();
 	ofHttpResponse handleRequest(const ofHttpRequest & request);
 	int handleRequestAsync(const ofHttpRequest& request); // returns id
+	void setMaxConcurrentTransfers(size_t maxTransfers);
+	void setMaxConnectionsPerHost(size_t maxConnections);
+	void setCache(const std::filesystem::path & directory, uint64_t maxSize);
+	void clearCache();
+	ofHttpCacheStats getCacheStats();
 
 protected:
 	// threading -----------------------------------------------
@@ -50,26 +426,79 @@ protected:
 	void update(ofEventArgs & args);  // notify in update so the notification is thread safe
 
 private:
-	// perform the requests on the thread
+	void wakeup();
+	void setup(CURL * handle, ofURLTransfer & transfer);
+	ofHttpResponse finish(CURL * handle, CURLcode result, ofURLTransfer & transfer);
+	void startTransfers();
+	bool finishTransfers();
+	void release(CURL * handle);
+
+	// requests waiting for a free transfer slot, sorted by priority
+	std::multimap<int, ofHttpRequest, std::greater<int>> queued;
+	std::vector<int> cancelled;
+	std::mutex queueMutex;
+	std::condition_variable queueCondition;
 
-	ofThreadChannel<ofHttpRequest> requests;
 	ofThreadChannel<ofHttpResponse> responses;
-	ofThreadChannel<int> cancelRequestQueue;
-	set<int> cancelledRequests;
+	std::atomic<size_t> maxTransfers{1};
+	std::atomic<size_t> maxConnectionsPerHost{0};
+	std::atomic<bool> settingsChanged{false};
+	ofURLCache cache;
+
+	// dns and tls sessions are shared between the synchronous and
+	// asynchronous handles, connections are reused by each of them
+	std::unique_ptr<CURLSH, CURLSHcode(*)(CURLSH*)> share;
+	std::mutex shareMutexes[CURL_LOCK_DATA_LAST];
+
+	// synchronous requests
 	std::unique_ptr<CURL, void(*)(CURL*)> curl;
+	std::mutex curlMutex;
+
+	// asynchronous requests, only accessed from the thread
+	std::unique_ptr<CURLM, CURLMcode(*)(CURLM*)> multi;
+	std::map<CURL*, std::unique_ptr<ofURLTransfer>> active;
+	std::vector<CURL*> idleHandles;
 };
 
+namespace{
+	void lockShare(CURL *, curl_lock_data data, curl_lock_access, void * mutexes){
+		((std::mutex*)mutexes)[data].lock();
+	}
+
+	void unlockShare(CURL *, curl_lock_data data, void * mutexes){
+		((std::mutex*)mutexes)[data].unlock();
+	}
+}
+
 ofURLFileLoaderImpl::ofURLFileLoaderImpl()
-:curl(nullptr, nullptr){
+:share(nullptr, nullptr)
+,curl(nullptr, nullptr)
+,multi(nullptr, nullptr){
 	if(!curlInited){
 		 curl_global_init(CURL_GLOBAL_ALL);
+		 curlInited = true;
 	}
+	share = std::unique_ptr<CURLSH, CURLSHcode(*)(CURLSH*)>(curl_share_init(), curl_share_cleanup);
+	curl_share_setopt(share.get(), CURLSHOPT_LOCKFUNC, lockShare);
+	curl_share_setopt(share.get(), CURLSHOPT_UNLOCKFUNC, unlockShare);
+	curl_share_setopt(share.get(), CURLSHOPT_USERDATA, shareMutexes);
+	curl_share_setopt(share.get(), CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+	curl_share_setopt(share.get(), CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
 	curl = std::unique_ptr<CURL, void(*)(CURL*)>(curl_easy_init(), curl_easy_cleanup);
+	multi = std::unique_ptr<CURLM, CURLMcode(*)(CURLM*)>(curl_multi_init(), curl_multi_cleanup);
 }
 
 ofURLFileLoaderImpl::~ofURLFileLoaderImpl(){
 	clear();
 	stop();
+	for(auto & transfer: active){
+		curl_multi_remove_handle(multi.get(), transfer.first);
+		curl_easy_cleanup(transfer.first);
+	}
+	for(auto handle: idleHandles){
+		curl_easy_cleanup(handle);
+	}
 }
 
 ofHttpResponse ofURLFileLoaderImpl::get(const string& url) {
@@ -80,9 +509,7 @@ ofHttpResponse ofURLFileLoaderImpl::get(const string& url) {
 
 int ofURLFileLoaderImpl::getAsync(const string& url, const string& name){
 	ofHttpRequest request(url, name.empty() ? url : name);
-	requests.send(request);
-	start();
-	return request.getId();
+	return handleRequestAsync(request);
 }
 
 
@@ -93,22 +520,54 @@ ofHttpResponse ofURLFileLoaderImpl::saveTo(const string& url, const std::filesys
 
 int ofURLFileLoaderImpl::saveAsync(const string& url, const std::filesystem::path& path){
 	ofHttpRequest request(url,path.string(),true);
-	requests.send(request);
-	start();
-	return request.getId();
+	return handleRequestAsync(request);
 }
 
 void ofURLFileLoaderImpl::remove(int id){
-	cancelRequestQueue.send(id);
+	std::unique_lock<std::mutex> lock(queueMutex);
+	for(auto it = queued.begin(); it != queued.end(); ++it){
+		if(it->second.getId() == id){
+			queued.erase(it);
+			return;
+		}
+	}
+	// might be transferring already
+	cancelled.push_back(id);
+	wakeup();
 }
 
 void ofURLFileLoaderImpl::clear(){
 	ofHttpResponse resp;
-	ofHttpRequest req;
-	while(requests.tryReceive(req)){}
+	{
+		std::unique_lock<std::mutex> lock(queueMutex);
+		queued.clear();
+	}
 	while(responses.tryReceive(resp)){}
 }
 
+void ofURLFileLoaderImpl::setMaxConcurrentTransfers(size_t maxTransfers){
+	this->maxTransfers = std::max<size_t>(1, maxTransfers);
+	wakeup();
+}
+
+void ofURLFileLoaderImpl::setMaxConnectionsPerHost(size_t maxConnections){
+	maxConnectionsPerHost = maxConnections;
+	settingsChanged = true;
+	wakeup();
+}
+
+void ofURLFileLoaderImpl::setCache(const std::filesystem::path & directory, uint64_t maxSize){
+	cache.setup(directory, maxSize);
+}
+
+void ofURLFileLoaderImpl::clearCache(){
+	cache.clear();
+}
+
+ofHttpCacheStats ofURLFileLoaderImpl::getCacheStats(){
+	return cache.getStats();
+}
+
 void ofURLFileLoaderImpl::start() {
 	 if (!isThreadRunning()){
 		ofAddListener(ofEvents().update,this,&ofURLFileLoaderImpl::update);
@@ -118,63 +577,184 @@ void ofURLFileLoaderImpl::start() {
 
 void ofURLFileLoaderImpl::stop() {
 	stopThread();
-	requests.close();
+	{
+		std::unique_lock<std::mutex> lock(queueMutex);
+		queueCondition.notify_all();
+	}
 	responses.close();
+	wakeup();
 	waitForThread();
 }
 
+void ofURLFileLoaderImpl::wakeup(){
+#if LIBCURL_VERSION_NUM >= 0x074400
+	curl_multi_wakeup(multi.get());
+#endif
+}
+
 void ofURLFileLoaderImpl::threadedFunction() {
 	setThreadName("ofURLFileLoader " + ofToString(getThreadId()));
 	while( isThreadRunning() ){
-		int cancelled;
-		while(cancelRequestQueue.tryReceive(cancelled)){
-			cancelledRequests.insert(cancelled);
-		}
-		ofHttpRequest request;
-		if(requests.receive(request)){
-			if(cancelledRequests.find(request.getId())==cancelledRequests.end()){
-				ofHttpResponse response(handleRequest(request));
-				int status = response.status;
-				if(!responses.send(move(response))){
-					break;
-				}
-				if(status==-1){
-					// retry
-					requests.send(request);
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			if(active.empty()){
+				// nothing to transfer, sleep until a new request arrives
+				queueCondition.wait(lock, [this]{
+					return !queued.empty() || !isThreadRunning();
+				});
+			}
+			for(auto id: cancelled){
+				for(auto it = active.begin(); it != active.end(); ++it){
+					if(it->second->request.getId() == id){
+						release(it->first);
+						active.erase(it);
+						break;
+					}
 				}
-			}else{
-				cancelledRequests.erase(cancelled);
 			}
+			cancelled.clear();
+			startTransfers();
+		}
+		if(!isThreadRunning()){
+			break;
+		}
+		if(settingsChanged.exchange(false)){
+			curl_multi_setopt(multi.get(), CURLMOPT_MAX_HOST_CONNECTIONS, long(maxConnectionsPerHost));
+		}
+
+		int running = 0;
+		curl_multi_perform(multi.get(), &running);
+
+		// if something finished, start the next transfers right away
+		if(!finishTransfers() && !active.empty()){
+#if LIBCURL_VERSION_NUM >= 0x074400
+			curl_multi_poll(multi.get(), nullptr, 0, 1000, nullptr);
+#else
+			curl_multi_wait(multi.get(), nullptr, 0, 100, nullptr);
+#endif
+		}
+	}
+}
+
+void ofURLFileLoaderImpl::startTransfers(){
+	while(active.size() < maxTransfers && !queued.empty()){
+		auto transfer = std::make_unique<ofURLTransfer>(queued.begin()->second);
+		queued.erase(queued.begin());
+
+		CURL * handle;
+		if(idleHandles.empty()){
+			handle = curl_easy_init();
 		}else{
+			handle = idleHandles.back();
+			idleHandles.pop_back();
+		}
+		setup(handle, *transfer);
+		curl_multi_add_handle(multi.get(), handle);
+		active[handle] = std::move(transfer);
+	}
+}
+
+bool ofURLFileLoaderImpl::finishTransfers(){
+	bool finished = false;
+	int pendingMessages;
+	while(CURLMsg * message = curl_multi_info_read(multi.get(), &pendingMessages)){
+		if(message->msg != CURLMSG_DONE){
+			continue;
+		}
+		CURL * handle = message->easy_handle;
+		CURLcode result = message->data.result;
+		auto it = active.find(handle);
+		if(it == active.end()){
+			continue;
+		}
+		auto transfer = std::move(it->second);
+		active.erase(it);
+		finished = true;
+		ofHttpResponse response(finish(handle, result, *transfer));
+		release(handle);
+		transfer->file.reset();
+
+		int status = response.status;
+		if(!responses.send(move(response))){
 			break;
 		}
+		if(status==-1 && !transfer->aborted){
+			// retry
+			std::unique_lock<std::mutex> lock(queueMutex);
+			queued.emplace(transfer->request.priority, transfer->request);
+		}
 	}
+	return finished;
+}
+
+void ofURLFileLoaderImpl::release(CURL * handle){
+	// keeping the easy handles around doesn't keep the connections, those
+	// live in the multi handle, but avoids reallocating their buffers
+	curl_multi_remove_handle(multi.get(), handle);
+	idleHandles.push_back(handle);
 }
 
 namespace{
-	size_t saveToFile_cb(void *buffer, size_t size, size_t nmemb, void *userdata){
-		auto saveTo = (ofFile*)userdata;
-		saveTo->write((const char*)buffer, size * nmemb);
-		return size * nmemb;
+	size_t write_cb(void *buffer, size_t size, size_t nmemb, void *userdata){
+		auto transfer = (ofURLTransfer*)userdata;
+		auto bytes = size * nmemb;
+		if(transfer->cacheable){
+			auto data = (const unsigned char*)buffer;
+			for(size_t i = 0; i < bytes; i++){
+				transfer->contentHash = (transfer->contentHash ^ data[i]) * 1099511628211ull;
+			}
+		}
+		transfer->received += bytes;
+		if(transfer->request.dataReceived){
+			if(!transfer->request.dataReceived((const char*)buffer, bytes)){
+				transfer->aborted = true;
+				return 0;
+			}
+		}else if(transfer->file){
+			transfer->file->write((const char*)buffer, bytes);
+		}else{
+			transfer->response.data.append((const char*)buffer, bytes);
+		}
+		return bytes;
 	}
 
-	size_t saveToMemory_cb(void *buffer, size_t size, size_t nmemb, void *userdata){
-		auto response = (ofHttpResponse*)userdata;
-		response->data.append((const char*)buffer, size * nmemb);
-		return size * nmemb;
+	size_t header_cb(char *buffer, size_t size, size_t nitems, void *userdata){
+		auto transfer = (ofURLTransfer*)userdata;
+		auto bytes = size * nitems;
+		std::string header(buffer, bytes);
+		if(header.compare(0, 5, "HTTP/") == 0){
+			// new response after a redirection
+			transfer->etag.clear();
+			transfer->lastModified.clear();
+			transfer->noStore = false;
+		}
+		auto colon = header.find(':');
+		if(colon != std::string::npos){
+			auto name = ofToLower(header.substr(0, colon));
+			auto value = ofTrim(header.substr(colon + 1));
+			if(name == "etag"){
+				transfer->etag = value;
+			}else if(name == "last-modified"){
+				transfer->lastModified = value;
+			}else if(name == "cache-control" && ofIsStringInString(ofToLower(value), "no-store")){
+				transfer->noStore = true;
+			}
+		}
+		return bytes;
 	}
 
     size_t readBody_cb(void *ptr, size_t size, size_t nmemb, void *userdata){
-        auto body = (std::string*)userdata;
+        auto transfer = (ofURLTransfer*)userdata;
+        auto & body = transfer->request.body;
 
         if(size*nmemb < 1){
             return 0;
         }
 
-        if(!body->empty()) {
-            auto sent = std::min(size * nmemb, body->size());
-            memcpy(ptr, body->c_str(), sent);
-            *body = body->substr(sent);
+        if(transfer->bodySent < body.size()) {
+            auto sent = std::min(size * nmemb, body.size() - transfer->bodySent);
+            memcpy(ptr, body.c_str() + transfer->bodySent, sent);
+            transfer->bodySent += sent;
             return sent;
         }
 
@@ -182,87 +762,142 @@ namespace{
     }
 }
 
-ofHttpResponse ofURLFileLoaderImpl::handleRequest(const ofHttpRequest & request) {
-	curl_slist *headers = nullptr;
-	curl_easy_setopt(curl.get(), CURLOPT_SSL_VERIFYPEER, 0);
-	curl_easy_setopt(curl.get(), CURLOPT_SSL_VERIFYHOST, 0);
-	curl_easy_setopt(curl.get(), CURLOPT_URL, request.url.c_str());
+void ofURLFileLoaderImpl::setup(CURL * handle, ofURLTransfer & transfer){
+	const ofHttpRequest & request = transfer.request;
+	curl_easy_reset(handle);
+	curl_easy_setopt(handle, CURLOPT_SHARE, share.get());
+	curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+	curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+	curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, 0);
+	curl_easy_setopt(handle, CURLOPT_SSL_VERIFYHOST, 0);
+	curl_easy_setopt(handle, CURLOPT_URL, request.url.c_str());
 
 	// always follow redirections
-	curl_easy_setopt(curl.get(), CURLOPT_FOLLOWLOCATION, 1L);
+	curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
+
+	// only plain GETs that don't set their own validators use the cache
+	transfer.cacheable = request.useCache && request.method == ofHttpRequest::GET && request.body.empty() &&
+		!request.dataReceived && request.headers.count("If-None-Match") == 0 &&
+		request.headers.count("If-Modified-Since") == 0 && cache.isEnabled();
+	if(transfer.cacheable){
+		ofURLCache::Entry entry;
+		if(cache.find(request.url, entry)){
+			transfer.cached = true;
+			transfer.cachedPath = cache.getPath(entry.content);
+			transfer.cachedSize = entry.size;
+			if(!entry.etag.empty()){
+				transfer.headers = curl_slist_append(transfer.headers, ("If-None-Match: " + entry.etag).c_str());
+			}
+			if(!entry.lastModified.empty()){
+				transfer.headers = curl_slist_append(transfer.headers, ("If-Modified-Since: " + entry.lastModified).c_str());
+			}
+		}
+		curl_easy_setopt(handle, CURLOPT_HEADERDATA, &transfer);
+		curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, header_cb);
+	}
 
 	// Set content type and any other header
 	if(request.contentType!=""){
-		headers = curl_slist_append(headers, ("Content-Type: " + request.contentType).c_str());
+		transfer.headers = curl_slist_append(transfer.headers, ("Content-Type: " + request.contentType).c_str());
 	}
 	for(map<string,string>::const_iterator it = request.headers.cbegin(); it!=request.headers.cend(); it++){
-		headers = curl_slist_append(headers, (it->first + ": " +it->second).c_str());
+		transfer.headers = curl_slist_append(transfer.headers, (it->first + ": " +it->second).c_str());
 	}
 
-	curl_easy_setopt(curl.get(), CURLOPT_HTTPHEADER, headers);
-
-    std::string body = request.body;
+	curl_easy_setopt(handle, CURLOPT_HTTPHEADER, transfer.headers);
 
 	// set body if there's any
 	if(request.body!=""){
-//		curl_easy_setopt(curl.get(), CURLOPT_UPLOAD, 1L); // Tis does PUT instead of POST
-		curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDSIZE, request.body.size());
-		curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDS, nullptr);
-		//curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDS, request.body.c_str());
-		curl_easy_setopt(curl.get(), CURLOPT_READFUNCTION, readBody_cb);
-		curl_easy_setopt(curl.get(), CURLOPT_READDATA, &body);
+		curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE, request.body.size());
+		curl_easy_setopt(handle, CURLOPT_POSTFIELDS, nullptr);
+		curl_easy_setopt(handle, CURLOPT_READFUNCTION, readBody_cb);
+		curl_easy_setopt(handle, CURLOPT_READDATA, &transfer);
 	}else{
-//		curl_easy_setopt(curl.get(), CURLOPT_UPLOAD, 0L);
-		curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDSIZE, 0);
-        //curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDS, nullptr);
-        curl_easy_setopt(curl.get(), CURLOPT_READFUNCTION, nullptr);
-        curl_easy_setopt(curl.get(), CURLOPT_READDATA, nullptr);
+		// after curl_easy_reset the size is -1 and an empty post would be
+		// sent chunked reading the body from stdin
+		curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE, 0L);
 	}
 	if(request.method == ofHttpRequest::GET){
-		curl_easy_setopt(curl.get(), CURLOPT_HTTPGET, 1);
-		curl_easy_setopt(curl.get(), CURLOPT_POST, 0);
+		curl_easy_setopt(handle, CURLOPT_HTTPGET, 1);
 	}else{
-		curl_easy_setopt(curl.get(), CURLOPT_POST, 1);
-		curl_easy_setopt(curl.get(), CURLOPT_HTTPGET, 0);
+		curl_easy_setopt(handle, CURLOPT_POST, 1);
 	}
 
     if(request.timeoutSeconds>0){
-        curl_easy_setopt(curl.get(), CURLOPT_TIMEOUT, request.timeoutSeconds);
+        curl_easy_setopt(handle, CURLOPT_TIMEOUT, request.timeoutSeconds);
     }
 
-	// start request and receive response
-	ofHttpResponse response(request, 0, "");
-	CURLcode err = CURLE_OK;
-	if(request.saveTo){
-		ofFile saveTo(request.name, ofFile::WriteOnly, true);
-		curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &saveTo);
-		curl_easy_setopt(curl.get(), CURLOPT_WRITEFUNCTION, saveToFile_cb);
-		err = curl_easy_perform(curl.get());
-	}else{
-		curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &response);
-		curl_easy_setopt(curl.get(), CURLOPT_WRITEFUNCTION, saveToMemory_cb);
-		err = curl_easy_perform(curl.get());
+	if(request.saveTo && !request.dataReceived){
+		transfer.file.reset(new ofFile(request.name, ofFile::WriteOnly, true));
 	}
+	curl_easy_setopt(handle, CURLOPT_WRITEDATA, &transfer);
+	curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, write_cb);
+}
+
+ofHttpResponse ofURLFileLoaderImpl::finish(CURL * handle, CURLcode err, ofURLTransfer & transfer){
+	ofHttpResponse & response = transfer.response;
 	if(err==CURLE_OK){
 		long http_code = 0;
-		curl_easy_getinfo (curl.get(), CURLINFO_RESPONSE_CODE, &http_code);
+		curl_easy_getinfo (handle, CURLINFO_RESPONSE_CODE, &http_code);
 		response.status = http_code;
+	}else if(transfer.aborted){
+		response.error = "transfer aborted by dataReceived";
+		response.status = -1;
 	}else{
 		response.error = curl_easy_strerror(err);
 		response.status = -1;
 	}
 
-	if(headers){
-		curl_slist_free_all(headers);
+	if(transfer.cacheable){
+		if(transfer.file){
+			transfer.file->close();
+		}
+		bool notModified = response.status == 304;
+		bool failed = response.status == -1 || response.status >= 500;
+		if(transfer.cached && (notModified || failed)){
+			// answer with the cached copy
+			if(transfer.request.saveTo){
+				ofFile::copyFromTo(transfer.cachedPath, transfer.request.name, true, true);
+			}else{
+				response.data = ofBufferFromFile(transfer.cachedPath, true);
+			}
+			if(notModified){
+				response.cacheStatus = ofHttpResponse::CACHE_HIT;
+				cache.touch(transfer.request.url);
+			}else{
+				ofLogWarning("ofURLFileLoader") << "couldn't revalidate " << transfer.request.url << ", using cached copy: " << response.error;
+				response.cacheStatus = ofHttpResponse::CACHE_STALE;
+			}
+			response.status = 200;
+			cache.count(response.cacheStatus, transfer.cachedSize);
+		}else if(response.status == 200){
+			response.cacheStatus = ofHttpResponse::CACHE_MISS;
+			cache.count(response.cacheStatus, transfer.received);
+			if(!transfer.noStore && (!transfer.etag.empty() || !transfer.lastModified.empty())){
+				cache.store(transfer, transfer.request.saveTo ? ofToDataPath(transfer.request.name, true) : std::string());
+			}
+		}
 	}
+	return std::move(response);
+}
 
-	return response;
+ofHttpResponse ofURLFileLoaderImpl::handleRequest(const ofHttpRequest & request) {
+	std::unique_lock<std::mutex> lock(curlMutex);
+	ofURLTransfer transfer(request);
+	setup(curl.get(), transfer);
+	CURLcode err = curl_easy_perform(curl.get());
+	return finish(curl.get(), err, transfer);
 }
 
 
 int ofURLFileLoaderImpl::handleRequestAsync(const ofHttpRequest& request){
-	requests.send(request);
+	{
+		std::unique_lock<std::mutex> lock(queueMutex);
+		queued.emplace(request.priority, request);
+		queueCondition.notify_one();
+	}
 	start();
+	wakeup();
 	return request.getId();
 }
 
@@ -457,6 +1092,26 @@ int ofURLFileLoader::handleRequestAsync(const ofHttpRequest& request){
 	return impl->handleRequestAsync(request);
 }
 
+void ofURLFileLoader::setMaxConcurrentTransfers(size_t maxTransfers){
+	impl->setMaxConcurrentTransfers(maxTransfers);
+}
+
+void ofURLFileLoader::setMaxConnectionsPerHost(size_t maxConnections){
+	impl->setMaxConnectionsPerHost(maxConnections);
+}
+
+void ofURLFileLoader::setCache(const std::filesystem::path & directory, uint64_t maxSize){
+	impl->setCache(directory, maxSize);
+}
+
+void ofURLFileLoader::clearCache(){
+	impl->clearCache();
+}
+
+ofHttpCacheStats ofURLFileLoader::getCacheStats(){
+	return impl->getCacheStats();
+}
+
 static bool fileLoaderInitialized = false;
 static ofURLFileLoader & getFileLoader(){
 	static ofURLFileLoader * fileLoader = new ofURLFileLoader;
@@ -524,6 +1179,14 @@ int ofLoadURLAsync(const string&  url, const string&  name){
 	return getFileLoader().getAsync(url,name);
 }
 
+void ofSetURLCache(const std::filesystem::path & directory, uint64_t maxSize){
+	getFileLoader().setCache(directory, maxSize);
+}
+
+ofHttpCacheStats ofGetURLCacheStats(){
+	return getFileLoader().getCacheStats();
+}
+
 ofHttpResponse ofSaveURLTo(const string& url, const std::filesystem::path& path){
 	return getFileLoader().saveTo(url,path);
 }
@@ -544,6 +1207,10 @@ void ofStopURLLoader(){
 	getFileLoader().stop();
 }
 
+void ofSetURLLoaderMaxConcurrentTransfers(size_t maxTransfers){
+	getFileLoader().setMaxConcurrentTransfers(maxTransfers);
+}
+
 void ofURLFileLoaderShutdown(){
 	if(fileLoaderInitialized){
 		ofRemoveAllURLRequests();
@@ -21,6 +21,12 @@ public:
 	std::string				contentType; //< POST data mime type
 	std::function<void(const ofHttpResponse&)> done;
     size_t              timeoutSeconds = 0;
+	int					priority = 0; //< queued async requests with higher priority start first
+	/// if set, receives the response body as it arrives, from the loader's
+	/// thread, instead of storing it in the response. Return false to abort
+	/// the transfer.
+	std::function<bool(const char * data, size_t size)> dataReceived;
+	bool				useCache = true; //< use the disk cache, if enabled, for this GET request
 
 	/// \return the unique id for this request
 	int getId() const;
@@ -51,6 +57,25 @@ public:
 	ofBuffer		    data; //< response raw data
 	int					status; //< HTTP response status (200: OK, 404: Not Found, etc)
 	std::string				error; //< HTTP error string, if any (OK, Not Found, etc)
+
+	/// how the disk cache was used for this response
+	enum CacheStatus{
+		CACHE_NONE, //< the cache is disabled or the request can't be cached
+		CACHE_MISS, //< downloaded, and stored if the server sent an ETag or Last-Modified
+		CACHE_HIT, //< the server confirmed the cached copy is still valid and the data comes from it
+		CACHE_STALE //< the request failed and the data comes from a cached copy that couldn't be revalidated
+	} cacheStatus = CACHE_NONE;
+};
+
+/// \brief statistics of the HTTP disk cache
+struct ofHttpCacheStats{
+	uint64_t hits = 0; //< responses served from the cache after revalidating them
+	uint64_t misses = 0; //< cacheable responses that had to be downloaded
+	uint64_t stale = 0; //< failed requests served from the cache
+	uint64_t bytesFromCache = 0; //< bytes that didn't need to be downloaded
+	uint64_t bytesDownloaded = 0; //< bytes downloaded by cacheable requests
+	uint64_t size = 0; //< current size of the cached data on disk
+	size_t numEntries = 0; //< number of cached urls
 };
 
 /// \brief make an HTTP GET request
@@ -93,6 +118,25 @@ void ofRemoveAllURLRequests();
 /// \brief stop & remove all active and waiting HTTP requests
 void ofStopURLLoader();
 
+/// \brief set how many asynchronous requests can be transferred at the same
+/// time, 1 by default so requests are processed in order
+void ofSetURLLoaderMaxConcurrentTransfers(size_t maxTransfers);
+
+/// \brief cache GET responses on disk
+///
+/// Responses with an ETag or Last-Modified header are stored in directory
+/// and later requests for the same url ask the server if they changed,
+/// which transfers no data if they didn't. If the server can't be reached
+/// the cached copy is used. When the cache grows over maxSize the least
+/// recently used responses are removed.
+///
+/// \param directory where to store the responses, relative to the data folder
+/// \param maxSize maximum size in bytes, 0 disables the cache
+void ofSetURLCache(const std::filesystem::path & directory, uint64_t maxSize);
+
+/// \returns statistics of the HTTP disk cache
+ofHttpCacheStats ofGetURLCacheStats();
+
 ofEvent<ofHttpResponse> & ofURLResponseEvent();
 
 template<class T>
@@ -161,6 +205,25 @@ class ofURLFileLoader  {
 		/// \return unique id of the active HTTP request
         int handleRequestAsync(const ofHttpRequest& request);
 
+		/// \brief set how many asynchronous requests can be transferred at
+		/// the same time, 1 by default so requests are processed in order
+		void setMaxConcurrentTransfers(size_t maxTransfers);
+
+		/// \brief limit the number of simultaneous connections to the same
+		/// host, 0 means no limit. Connections are kept alive and reused by
+		/// later requests to the same host.
+		void setMaxConnectionsPerHost(size_t maxConnections);
+
+		/// \brief cache GET responses on disk
+		/// \sa ofSetURLCache
+		void setCache(const std::filesystem::path & directory, uint64_t maxSize);
+
+		/// \brief remove every cached response
+		void clearCache();
+
+		/// \returns statistics of the HTTP disk cache
+		ofHttpCacheStats getCacheStats();
+
     private:
 	std::shared_ptr<ofBaseURLFileLoader> impl;
 };
@@ -216,4 +279,19 @@ public:
 	virtual ofHttpResponse handleRequest(const ofHttpRequest & request) = 0;
 	virtual int handleRequestAsync(const ofHttpRequest& request)=0; // returns id
 
+	/// \brief set how many asynchronous requests can be transferred at the same time
+	virtual void setMaxConcurrentTransfers(size_t maxTransfers){}
+
+	/// \brief limit the number of simultaneous connections to the same host
+	virtual void setMaxConnectionsPerHost(size_t maxConnections){}
+
+	/// \brief cache GET responses on disk
+	virtual void setCache(const std::filesystem::path & directory, uint64_t maxSize){}
+
+	/// \brief remove every cached response
+	virtual void clearCache(){}
+
+	/// \returns statistics of the HTTP disk cache
+	virtual ofHttpCacheStats getCacheStats(){ return ofHttpCacheStats(); }
+
 };
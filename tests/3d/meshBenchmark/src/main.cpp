@@ -0,0 +1,105 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	// a flat grid of size x size quads where every triangle has its own
+	// vertices, as loaded from formats without indices
+	ofMesh triangleSoup(size_t size, float jitter){
+		ofMesh mesh;
+		mesh.getVertices().reserve(size * size * 6);
+		mesh.getColors().reserve(size * size * 6);
+		auto vertex = [&](size_t x, size_t y){
+			mesh.addVertex({x + ofRandom(-jitter, jitter), y + ofRandom(-jitter, jitter), 0});
+			mesh.addColor(ofFloatColor(x / float(size), y / float(size), 0));
+		};
+		for(size_t y=0;y<size;y++){
+			for(size_t x=0;x<size;x++){
+				vertex(x, y);
+				vertex(x + 1, y);
+				vertex(x + 1, y + 1);
+				vertex(x, y);
+				vertex(x + 1, y + 1);
+				vertex(x, y + 1);
+			}
+		}
+		return mesh;
+	}
+
+	void benchmark(size_t numVertices){
+		size_t size = std::sqrt(numVertices / 6.);
+		size_t numSoupVertices = size * size * 6;
+		size_t numGridVertices = (size + 1) * (size + 1);
+
+		auto mesh = triangleSoup(size, 0);
+		auto then = ofGetElapsedTimeMicros();
+		mesh.mergeDuplicateVertices();
+		auto elapsed = ofGetElapsedTimeMicros() - then;
+		ofxTestEq(mesh.getNumVertices(), numGridVertices, "mergeDuplicateVertices merges the corners of " + ofToString(numSoupVertices) + " vertices");
+		ofxTestEq(mesh.getNumIndices(), numSoupVertices, "mergeDuplicateVertices keeps every triangle");
+		bool colorsMatch = true;
+		for(auto i: mesh.getIndices()){
+			auto v = mesh.getVertex(i);
+			colorsMatch &= mesh.getColor(i) == ofFloatColor(v.x / size, v.y / size, 0);
+		}
+		ofxTest(colorsMatch, "mergeDuplicateVertices keeps the color of every vertex with its position");
+		ofLogNotice() << "mergeDuplicateVertices " << numSoupVertices << " vertices: " << elapsed / 1000. << "ms";
+
+		mesh = triangleSoup(size, 0.0001);
+		then = ofGetElapsedTimeMicros();
+		mesh.mergeDuplicateVertices(0.001);
+		elapsed = ofGetElapsedTimeMicros() - then;
+		ofxTestEq(mesh.getNumVertices(), numGridVertices, "mergeDuplicateVertices merges close vertices of " + ofToString(numSoupVertices) + " vertices");
+		ofLogNotice() << "mergeDuplicateVertices epsilon 0.001 " << numSoupVertices << " vertices: " << elapsed / 1000. << "ms";
+
+		then = ofGetElapsedTimeMicros();
+		mesh.smoothNormals(60);
+		elapsed = ofGetElapsedTimeMicros() - then;
+		ofxTestEq(mesh.getNumVertices(), numSoupVertices, "smoothNormals outputs a vertex per triangle corner");
+		ofxTestEq(mesh.getNumNormals(), numSoupVertices, "smoothNormals outputs a normal per vertex");
+		bool normalsUp = true;
+		for(auto & n: mesh.getNormals()){
+			normalsUp &= glm::distance(n, glm::vec3(0, 0, 1)) < 0.001f;
+		}
+		ofxTest(normalsUp, "smoothNormals of a flat grid point up");
+		ofLogNotice() << "smoothNormals " << numGridVertices << " vertices: " << elapsed / 1000. << "ms";
+	}
+
+	void run(){
+		for(size_t numVertices: {10000, 100000, 1000000, 5000000}){
+			benchmark(numVertices);
+		}
+
+		// sharp edges on a cube aren't smoothed
+		{
+			auto box = ofMesh::box(1, 1, 1, 1, 1, 1);
+			box.smoothNormals(30);
+			bool axisAligned = true;
+			for(auto & n: box.getNormals()){
+				axisAligned &= std::abs(std::abs(n.x) + std::abs(n.y) + std::abs(n.z) - 1) < 0.001f;
+			}
+			ofxTest(axisAligned, "smoothNormals keeps the edges of a box sharp");
+
+			box = ofMesh::box(1, 1, 1, 1, 1, 1);
+			box.smoothNormals(120);
+			bool smooth = true;
+			for(auto & n: box.getNormals()){
+				smooth &= std::abs(n.x) > 0.001f && std::abs(n.y) > 0.001f && std::abs(n.z) > 0.001f;
+			}
+			ofxTest(smooth, "smoothNormals smooths the corners of a box");
+		}
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = make_shared<ofAppNoWindow>();
+	auto app = make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
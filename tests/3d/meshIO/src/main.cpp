@@ -0,0 +1,156 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	ofMesh quads(size_t size){
+		ofMesh mesh;
+		for(size_t y=0;y<=size;y++){
+			for(size_t x=0;x<=size;x++){
+				mesh.addVertex({x * 0.5f, y * 0.25f, -1.f * x});
+				mesh.addNormal({0, 0, 1});
+				mesh.addColor(ofFloatColor(x / float(size), y / float(size), 1, 1));
+				mesh.addTexCoord({x / float(size), y / float(size)});
+			}
+		}
+		for(size_t y=0;y<size;y++){
+			for(size_t x=0;x<size;x++){
+				auto i = ofIndexType(y * (size + 1) + x);
+				mesh.addTriangle(i, i + 1, i + size + 2);
+				mesh.addTriangle(i, i + size + 2, i + size + 1);
+			}
+		}
+		return mesh;
+	}
+
+	bool sameMesh(const ofMesh & a, const ofMesh & b){
+		if(a.getNumVertices() != b.getNumVertices() || a.getIndices() != b.getIndices() ||
+		   a.getNumNormals() != b.getNumNormals() || a.getNumColors() != b.getNumColors() ||
+		   a.getNumTexCoords() != b.getNumTexCoords()){
+			return false;
+		}
+		for(size_t i=0;i<a.getNumVertices();i++){
+			if(glm::distance(a.getVertex(i), b.getVertex(i)) > 0.0001f) return false;
+			if(a.hasNormals() && glm::distance(a.getNormal(i), b.getNormal(i)) > 0.0001f) return false;
+			if(a.hasTexCoords() && glm::distance(a.getTexCoord(i), b.getTexCoord(i)) > 0.0001f) return false;
+			if(a.hasColors() && std::abs(a.getColor(i).r - b.getColor(i).r) > 1 / 255.f) return false;
+		}
+		return true;
+	}
+
+	void run(){
+		auto mesh = quads(10);
+
+		// save and load again
+		for(bool binary: {false, true}){
+			for(bool multithreaded: {false, true}){
+				mesh.save("quads.ply", binary);
+				ofMesh loaded;
+				loaded.load("quads.ply", multithreaded);
+				ofxTest(sameMesh(mesh, loaded), string(binary ? "binary" : "ascii") + " ply saved and loaded" + (multithreaded ? " multithreaded" : ""));
+			}
+		}
+		mesh.save("quads.obj");
+		ofMesh loaded;
+		loaded.load("quads.obj");
+		ofxTest(sameMesh(mesh, loaded), "obj saved and loaded");
+
+		// big endian, other property types and layouts, polygons
+		{
+			ofBuffer buffer;
+			buffer.append("ply\nformat binary_big_endian 1.0\ncomment test\n"
+						  "element vertex 4\nproperty double x\nproperty double y\nproperty double z\nproperty int flags\nproperty uchar red\n"
+						  "element edge 1\nproperty int vertex1\nproperty int vertex2\n"
+						  "element face 1\nproperty list uchar uint vertex_indices\nend_header\n");
+			auto appendBigEndian = [&](const char * data, size_t size){
+				for(size_t i=0;i<size;i++) buffer.append(data + size - 1 - i, 1);
+			};
+			for(int i=0;i<4;i++){
+				double position[] = {double(i), double(i * 2), 0.5};
+				for(auto & value: position) appendBigEndian((const char*)&value, sizeof(value));
+				int32_t flags = 7;
+				appendBigEndian((const char*)&flags, sizeof(flags));
+				char red = char(255);
+				buffer.append(&red, 1);
+			}
+			int32_t edge[] = {0, 1};
+			for(auto & value: edge) appendBigEndian((const char*)&value, sizeof(value));
+			char numIndices = 4;
+			buffer.append(&numIndices, 1);
+			for(uint32_t i=0;i<4;i++) appendBigEndian((const char*)&i, sizeof(i));
+			ofBufferToFile("bigendian.ply", buffer);
+
+			ofMesh mesh;
+			mesh.load("bigendian.ply");
+			ofxTestEq(mesh.getNumVertices(), size_t(4), "big endian ply vertices");
+			ofxTestEq(mesh.getVertex(3), glm::vec3(3, 6, 0.5), "big endian ply double positions");
+			ofxTestEq(mesh.getColor(3).r, 1.f, "big endian ply uchar colors normalized");
+			ofxTestEq(mesh.getNumIndices(), size_t(6), "big endian ply quad split in 2 triangles");
+		}
+
+		// obj with separate texcoord and normal indices
+		{
+			ofBuffer buffer;
+			buffer.append("# quad\nv 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+						  "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\nvn 0 0 1\n"
+						  "f 1/1/1 2/2/1 3/3/1 4/4/1\nf -4/1/1 -2/3/1 -1/4/1\n");
+			ofBufferToFile("quad.obj", buffer);
+			ofMesh mesh;
+			mesh.load("quad.obj");
+			ofxTestEq(mesh.getNumVertices(), size_t(4), "obj vertices shared by faces with the same indices");
+			ofxTestEq(mesh.getNumIndices(), size_t(9), "obj faces split in triangles");
+			ofxTestEq(mesh.getTexCoord(2), glm::vec2(1, 1), "obj texcoords");
+			ofxTestEq(mesh.getNormal(0), glm::vec3(0, 0, 1), "obj normals");
+		}
+
+		// a file that can't be loaded leaves the mesh as it was
+		{
+			ofBuffer buffer;
+			buffer.append("ply\nformat ascii 1.0\nelement vertex 3\nproperty float x\nproperty float y\nproperty float z\nend_header\n0 0 0\n1 1\n");
+			ofBufferToFile("wrong.ply", buffer);
+			auto copy = mesh;
+			copy.load("wrong.ply");
+			ofxTest(sameMesh(mesh, copy), "wrong ply doesn't change the mesh");
+		}
+
+		// big point clouds
+		{
+			ofMesh cloud;
+			size_t numPoints = 2000000;
+			cloud.getVertices().resize(numPoints);
+			cloud.getColors().resize(numPoints);
+			for(size_t i=0;i<numPoints;i++){
+				cloud.getVertices()[i] = {ofRandom(-100, 100), ofRandom(-100, 100), ofRandom(-100, 100)};
+				cloud.getColors()[i] = ofFloatColor(ofRandom(1), ofRandom(1), ofRandom(1));
+			}
+			cloud.setMode(OF_PRIMITIVE_POINTS);
+			for(bool binary: {false, true}){
+				auto then = ofGetElapsedTimeMicros();
+				cloud.save("cloud.ply", binary);
+				auto saveTime = ofGetElapsedTimeMicros() - then;
+				for(bool multithreaded: {false, true}){
+					ofMesh loaded;
+					then = ofGetElapsedTimeMicros();
+					loaded.load("cloud.ply", multithreaded);
+					auto loadTime = ofGetElapsedTimeMicros() - then;
+					ofxTestEq(loaded.getNumVertices(), numPoints, string(binary ? "binary" : "ascii") + " point cloud loaded" + (multithreaded ? " multithreaded" : ""));
+					ofLogNotice() << (binary ? "binary" : "ascii") << " ply " << numPoints << " points, save: " << saveTime / 1000. << "ms, load"
+								  << (multithreaded ? " multithreaded: " : ": ") << loadTime / 1000. << "ms";
+				}
+			}
+		}
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = make_shared<ofAppNoWindow>();
+	auto app = make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
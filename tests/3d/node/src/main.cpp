@@ -0,0 +1,305 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+#include "ofTransformStore.h"
+
+class ofApp: public ofxUnitTestsApp{
+	// what getGlobalTransformMatrix used to do, walking up the parents every time
+	glm::mat4 globalTransform(const ofNode & node){
+		if(node.getParent()) return globalTransform(*node.getParent()) * node.getLocalTransformMatrix();
+		return node.getLocalTransformMatrix();
+	}
+
+	bool sameMatrix(const glm::mat4 & a, const glm::mat4 & b){
+		for(int i=0;i<4;i++){
+			for(int j=0;j<4;j++){
+				if(std::abs(a[i][j] - b[i][j]) > 0.001f * std::max(1.f, std::abs(b[i][j]))) return false;
+			}
+		}
+		return true;
+	}
+
+	bool sameGlobalTransforms(const std::vector<ofNode> & nodes){
+		for(auto & node: nodes){
+			if(!sameMatrix(node.getGlobalTransformMatrix(), globalTransform(node))) return false;
+		}
+		return true;
+	}
+
+	void randomTransform(ofNode & node, float scale = 1){
+		node.setPosition(ofRandom(-1, 1) * scale, ofRandom(-1, 1) * scale, ofRandom(-1, 1) * scale);
+		node.setOrientation(glm::vec3(ofRandom(-10, 10), ofRandom(-10, 10), ofRandom(-10, 10)));
+	}
+
+	// every node gets a random parent among the previous ones, like a rig or a scene
+	void randomTree(std::vector<ofNode> & nodes){
+		for(size_t i=0;i<nodes.size();i++){
+			randomTransform(nodes[i]);
+			if(i > 0) nodes[i].setParent(nodes[size_t(ofRandom(i))]);
+		}
+	}
+
+	void chain(std::vector<ofNode> & nodes){
+		for(size_t i=0;i<nodes.size();i++){
+			randomTransform(nodes[i], 0.01);
+			if(i > 0) nodes[i].setParent(nodes[i - 1]);
+		}
+	}
+
+	void fan(std::vector<ofNode> & nodes){
+		for(size_t i=0;i<nodes.size();i++){
+			randomTransform(nodes[i]);
+			if(i > 0) nodes[i].setParent(nodes[0]);
+		}
+	}
+
+	// moves the root and reads every global transform, what drawing a scene does every frame
+	void benchmark(const std::string & name, std::vector<ofNode> & nodes, ofTransformStore * store = nullptr){
+		size_t frames = 20;
+		glm::vec3 sum;
+
+		auto then = ofGetElapsedTimeMicros();
+		for(size_t frame=0;frame<frames;frame++){
+			nodes[0].setPosition(frame, 0, 0);
+			for(auto & node: nodes){
+				sum += glm::vec3(globalTransform(node)[3]);
+			}
+		}
+		auto uncached = ofGetElapsedTimeMicros() - then;
+
+		if(store){
+			for(auto & node: nodes) store->add(node);
+		}
+		then = ofGetElapsedTimeMicros();
+		for(size_t frame=0;frame<frames;frame++){
+			nodes[0].setPosition(frame, 0, 0);
+			for(auto & node: nodes){
+				sum += node.getGlobalPosition();
+			}
+		}
+		auto cached = ofGetElapsedTimeMicros() - then;
+		ofxTest(sameGlobalTransforms(nodes), name + (store ? " store" : "") + " global transforms after moving the root");
+		if(store){
+			store->clear();
+		}
+
+		ofLogNotice() << name << " " << nodes.size() << " nodes, per frame: walking up the parents " << uncached / 1000. / frames
+					  << "ms, " << (store ? "store " : "cached ") << cached / 1000. / frames << "ms" << (sum.x == 0 ? " " : "");
+	}
+
+	// only a few nodes move every frame, like an animated character in a static scene
+	void benchmarkFewChanges(const std::string & name, std::vector<ofNode> & nodes){
+		size_t frames = 20;
+		glm::vec3 sum;
+		std::vector<size_t> moving;
+		for(size_t i=0;i<10;i++){
+			moving.push_back(size_t(ofRandom(nodes.size() / 2, nodes.size())));
+		}
+
+		auto then = ofGetElapsedTimeMicros();
+		for(size_t frame=0;frame<frames;frame++){
+			for(auto i: moving) nodes[i].move(0.1, 0, 0);
+			for(auto & node: nodes){
+				sum += glm::vec3(globalTransform(node)[3]);
+			}
+		}
+		auto uncached = ofGetElapsedTimeMicros() - then;
+
+		then = ofGetElapsedTimeMicros();
+		for(size_t frame=0;frame<frames;frame++){
+			for(auto i: moving) nodes[i].move(0.1, 0, 0);
+			for(auto & node: nodes){
+				sum += node.getGlobalPosition();
+			}
+		}
+		auto cached = ofGetElapsedTimeMicros() - then;
+		ofxTest(sameGlobalTransforms(nodes), name + " global transforms after moving a few nodes");
+
+		ofLogNotice() << name << " " << nodes.size() << " nodes, 10 moving, per frame: walking up the parents " << uncached / 1000. / frames
+					  << "ms, cached " << cached / 1000. / frames << "ms" << (sum.x == 0 ? " " : "");
+	}
+
+	// transforms without nodes, updated in one pass over the store
+	void benchmarkHandles(const std::string & name, std::vector<ofNode> & nodes){
+		size_t frames = 20;
+		glm::vec3 sum;
+		ofTransformStore store;
+		std::vector<ofTransformStore::Handle> handles(nodes.size());
+		std::map<const ofNode*, size_t> indices;
+		for(size_t i=0;i<nodes.size();i++){
+			indices[&nodes[i]] = i;
+		}
+		for(size_t i=0;i<nodes.size();i++){
+			auto parent = nodes[i].getParent() ? handles[indices[nodes[i].getParent()]] : ofTransformStore::none;
+			handles[i] = store.add(nodes[i].getLocalTransformMatrix(), parent);
+		}
+		store.update();
+
+		auto then = ofGetElapsedTimeMicros();
+		for(size_t frame=0;frame<frames;frame++){
+			nodes[0].setPosition(frame, 0, 0);
+			store.setLocalTransform(handles[0], nodes[0].getLocalTransformMatrix());
+			store.update();
+			for(auto handle: handles){
+				sum += glm::vec3(store.getWorldTransform(handle)[3]);
+			}
+		}
+		auto elapsed = ofGetElapsedTimeMicros() - then;
+		bool same = true;
+		for(size_t i=0;i<nodes.size();i++){
+			same &= sameMatrix(store.getWorldTransform(handles[i]), globalTransform(nodes[i]));
+		}
+		ofxTest(same, name + " store handles world transforms after moving the root");
+
+		ofLogNotice() << name << " " << nodes.size() << " store handles, per frame: " << elapsed / 1000. / frames << "ms" << (sum.x == 0 ? " " : "");
+	}
+
+	void run(){
+		ofSeedRandom(0);
+
+		// cached transforms follow every kind of change
+		{
+			std::vector<ofNode> nodes(2000);
+			randomTree(nodes);
+			ofxTest(sameGlobalTransforms(nodes), "random tree global transforms");
+			for(int i=0;i<200;i++){
+				auto & node = nodes[size_t(ofRandom(nodes.size()))];
+				switch(int(ofRandom(5))){
+					case 0: node.move(ofRandom(-1, 1), 0, 0); break;
+					case 1: node.rotateDeg(ofRandom(90), {0, 1, 0}); break;
+					case 2: node.setScale(ofRandom(0.5, 2)); break;
+					case 3: node.lookAt({ofRandom(-10, 10), ofRandom(-10, 10), ofRandom(-10, 10)}); break;
+					case 4: node.setGlobalPosition(ofRandom(-10, 10), 0, 0); break;
+				}
+				// read some of them so part of the tree is clean for the next change
+				nodes[size_t(ofRandom(nodes.size()))].getGlobalTransformMatrix();
+			}
+			ofxTest(sameGlobalTransforms(nodes), "random tree global transforms after changes");
+
+			// reparenting
+			nodes[1500].setParent(nodes[10], true);
+			ofxTest(sameGlobalTransforms(nodes), "global transforms after setParent");
+			nodes[1500].clearParent(true);
+			ofxTest(sameGlobalTransforms(nodes), "global transforms after clearParent");
+		}
+
+		// parents destroyed, copied and moved
+		{
+			ofNode root, child, grandChild;
+			root.setPosition(10, 0, 0);
+			child.setPosition(0, 10, 0);
+			grandChild.setPosition(0, 0, 10);
+			child.setParent(root);
+			grandChild.setParent(child);
+			ofxTestEq(grandChild.getGlobalPosition(), glm::vec3(10, 10, 10), "grand child global position");
+			{
+				auto moved = std::move(child);
+				ofxTestEq(grandChild.getParent(), &moved, "children of a moved node point to the new one");
+				moved.move(0, 5, 0);
+				ofxTestEq(grandChild.getGlobalPosition(), glm::vec3(10, 15, 10), "grand child follows the moved node");
+				ofNode copy;
+				copy.setParent(root);
+				copy = moved;
+				root.move(1, 0, 0);
+				ofxTestEq(copy.getGlobalPosition(), glm::vec3(11, 15, 0), "copy follows the parent");
+			}
+			ofxTestEq(grandChild.getParent(), (ofNode*)nullptr, "destroying a parent clears it");
+			ofxTestEq(grandChild.getGlobalPosition(), glm::vec3(0, 0, 10), "global position without parent");
+		}
+
+		// nodes backed by a transform store
+		{
+			std::vector<ofNode> nodes(2000);
+			randomTree(nodes);
+			ofTransformStore store;
+			// children before their parents so the store has to sort them
+			for(size_t i=nodes.size();i>0;i--){
+				store.add(nodes[i - 1]);
+			}
+			ofxTestEq(store.size(), nodes.size(), "every node added to the store");
+			ofxTestEq(store.getParent(store.getHandle(nodes[1])), store.getHandle(*nodes[1].getParent()), "store parents");
+			ofxTest(sameGlobalTransforms(nodes), "store global transforms");
+
+			auto particle = store.add(glm::translate(glm::mat4(1), {0, 1, 0}), store.getHandle(nodes[100]));
+			ofxTest(sameMatrix(store.getWorldTransform(particle), globalTransform(nodes[100]) * glm::translate(glm::mat4(1), {0, 1, 0})), "transforms without a node attached to nodes");
+
+			for(int i=0;i<200;i++){
+				randomTransform(nodes[size_t(ofRandom(nodes.size()))]);
+				nodes[size_t(ofRandom(nodes.size()))].getGlobalTransformMatrix();
+			}
+			ofxTest(sameGlobalTransforms(nodes), "store global transforms after changes");
+			ofxTest(sameMatrix(store.getWorldTransform(particle), globalTransform(nodes[100]) * glm::translate(glm::mat4(1), {0, 1, 0})), "transforms without a node follow their parent");
+
+			// a parent outside of the store
+			ofNode outside;
+			outside.setPosition(100, 0, 0);
+			nodes[0].setParent(outside);
+			ofxTest(sameGlobalTransforms(nodes), "store global transforms with a parent outside of the store");
+			outside.move(0, 100, 0);
+			ofxTest(sameGlobalTransforms(nodes), "store global transforms after the parent outside of the store moves");
+
+			// removing nodes from the middle of the hierarchy
+			for(size_t i=0;i<nodes.size();i+=3){
+				store.remove(nodes[i]);
+			}
+			nodes[0].move(1, 1, 1);
+			ofxTest(sameGlobalTransforms(nodes), "store global transforms after removing nodes");
+			nodes[1999].setParent(nodes[5]);
+			nodes[0].move(1, 1, 1);
+			ofxTest(sameGlobalTransforms(nodes), "store global transforms after reparenting");
+			nodes[0].clearParent();
+		}
+		{
+			std::vector<ofNode> nodes(100);
+			randomTree(nodes);
+			{
+				ofTransformStore store;
+				for(auto & node: nodes) store.add(node);
+				nodes[0].getGlobalTransformMatrix();
+			}
+			nodes[0].move(1, 0, 0);
+			ofxTest(sameGlobalTransforms(nodes), "nodes work on their own after the store is destroyed");
+		}
+
+		// benchmarks
+		{
+			ofTransformStore store;
+			std::vector<ofNode> nodes(20000);
+			randomTree(nodes);
+			benchmark("random tree", nodes);
+			benchmark("random tree", nodes, &store);
+			benchmarkHandles("random tree", nodes);
+			benchmarkFewChanges("random tree", nodes);
+		}
+		{
+			ofTransformStore store;
+			std::vector<ofNode> nodes(1000);
+			chain(nodes);
+			benchmark("deep chain", nodes);
+			benchmark("deep chain", nodes, &store);
+			benchmarkHandles("deep chain", nodes);
+		}
+		{
+			ofTransformStore store;
+			std::vector<ofNode> nodes(20000);
+			fan(nodes);
+			benchmark("wide", nodes);
+			benchmark("wide", nodes, &store);
+			benchmarkHandles("wide", nodes);
+			benchmarkFewChanges("wide", nodes);
+		}
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = make_shared<ofAppNoWindow>();
+	auto app = make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
@@ -0,0 +1,187 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	// a shared mesh scaled to the primitive size, what gets drawn
+	ofMesh drawnMesh(const of3dPrimitive & primitive){
+		ofMesh mesh = primitive.getMesh();
+		auto scale = primitive.getMeshScale();
+		for(auto & v: mesh.getVertices()){
+			v *= scale;
+		}
+		for(auto & n: mesh.getNormals()){
+			n = glm::normalize(n / scale);
+		}
+		return mesh;
+	}
+
+	bool sameMesh(const ofMesh & a, const ofMesh & b){
+		if(a.getMode() != b.getMode()) return false;
+		if(a.getIndices() != b.getIndices()) return false;
+		if(a.getNumVertices() != b.getNumVertices() || a.getNumNormals() != b.getNumNormals() || a.getNumTexCoords() != b.getNumTexCoords()) return false;
+		for(size_t i=0;i<a.getNumVertices();i++){
+			if(glm::distance(a.getVertex(i), b.getVertex(i)) > 0.001f * std::max(1.f, glm::length(b.getVertex(i)))) return false;
+		}
+		for(size_t i=0;i<a.getNumNormals();i++){
+			if(glm::distance(a.getNormal(i), b.getNormal(i)) > 0.001f) return false;
+		}
+		for(size_t i=0;i<a.getNumTexCoords();i++){
+			if(glm::distance(a.getTexCoord(i), b.getTexCoord(i)) > 0.0001f) return false;
+		}
+		return true;
+	}
+
+	template<typename Primitive, typename Set>
+	void testPrimitive(const std::string & name, Set set){
+		Primitive own;
+		set(own);
+		Primitive shared;
+		shared.setUseSharedMesh(true);
+		set(shared);
+		Primitive other;
+		other.setUseSharedMesh(true);
+		set(other);
+		ofxTest(shared.isUsingSharedMesh() && !own.isUsingSharedMesh(), name + " using shared mesh");
+		ofxTest(&static_cast<const Primitive&>(shared).getMesh() == &static_cast<const Primitive&>(other).getMesh(), name + " same parameters share the mesh");
+		ofxTest(sameMesh(drawnMesh(shared), own.getMesh()), name + " shared mesh scaled is the same as its own mesh");
+
+		// the non const getMesh gives the primitive its own copy
+		other.getMesh();
+		ofxTest(&static_cast<const Primitive&>(shared).getMesh() != &static_cast<const Primitive&>(other).getMesh(), name + " getMesh copies the shared mesh");
+		ofxTest(other.getMeshScale() == glm::vec3(1, 1, 1), name + " copy has the real size");
+		ofxTest(sameMesh(other.getMesh(), own.getMesh()), name + " copy is the same as its own mesh");
+
+		shared.setUseSharedMesh(false);
+		ofxTest(sameMesh(shared.getMesh(), own.getMesh()), name + " mesh after disabling sharing");
+
+		// copies share too
+		other.setUseSharedMesh(false);
+		other.setUseSharedMesh(true);
+		Primitive copy = other;
+		ofxTest(&static_cast<const Primitive&>(copy).getMesh() == &static_cast<const Primitive&>(other).getMesh(), name + " copies share the mesh");
+		Primitive assigned;
+		assigned = other;
+		ofxTest(&static_cast<const Primitive&>(assigned).getMesh() == &static_cast<const Primitive&>(other).getMesh(), name + " assigned primitives share the mesh");
+	}
+
+	void run(){
+		auto & cache = ofPrimitiveMeshCache::get();
+		cache.clear();
+		cache.resetStats();
+
+		testPrimitive<ofPlanePrimitive>("plane", [](ofPlanePrimitive & p){ p.set(120, 30, 5, 7); });
+		testPrimitive<ofSpherePrimitive>("sphere", [](ofSpherePrimitive & p){ p.set(33, 12); });
+		testPrimitive<ofSpherePrimitive>("sphere triangles", [](ofSpherePrimitive & p){ p.set(5, 7, OF_PRIMITIVE_TRIANGLES); });
+		testPrimitive<ofIcoSpherePrimitive>("icosphere", [](ofIcoSpherePrimitive & p){ p.set(17, 2); });
+		testPrimitive<ofCylinderPrimitive>("cylinder", [](ofCylinderPrimitive & p){ p.set(10, 40, 12, 4, 3, true); });
+		testPrimitive<ofCylinderPrimitive>("uncapped cylinder", [](ofCylinderPrimitive & p){ p.set(10, 40, 12, 4, 3, false, OF_PRIMITIVE_TRIANGLES); });
+		testPrimitive<ofConePrimitive>("cone", [](ofConePrimitive & p){ p.set(15, 25, 9, 3, 2); });
+		testPrimitive<ofBoxPrimitive>("box", [](ofBoxPrimitive & p){ p.set(10, 20, 30, 3, 4, 5); });
+
+		{
+			// different sizes share the mesh, different resolutions don't
+			ofSpherePrimitive a, b, c;
+			for(auto p: {&a, &b, &c}){
+				p->setUseSharedMesh(true);
+			}
+			a.set(10, 20);
+			b.set(200, 20);
+			c.set(10, 21);
+			ofxTest(&static_cast<const ofSpherePrimitive&>(a).getMesh() == &static_cast<const ofSpherePrimitive&>(b).getMesh(), "spheres of different radius share the mesh");
+			ofxTest(&static_cast<const ofSpherePrimitive&>(a).getMesh() != &static_cast<const ofSpherePrimitive&>(c).getMesh(), "spheres of different resolution don't share the mesh");
+			ofxTest(b.getMeshScale() == glm::vec3(200, 200, 200), "mesh scale is the radius");
+
+			b.setPosition(1, 2, 3);
+			auto expected = glm::scale(b.getGlobalTransformMatrix(), glm::vec3(200, 200, 200));
+			ofxTest(b.getMeshTransformMatrix() == expected, "mesh transform is the global transform scaled");
+
+			// changing the size goes back to the shared mesh
+			b.getMesh();
+			b.setRadius(50);
+			ofxTest(&static_cast<const ofSpherePrimitive&>(a).getMesh() == &static_cast<const ofSpherePrimitive&>(b).getMesh(), "back to the shared mesh after changing the size");
+		}
+
+		{
+			// modifying the mesh doesn't change other primitives
+			ofBoxPrimitive a, b;
+			a.setUseSharedMesh(true);
+			b.setUseSharedMesh(true);
+			a.setSideColor(ofBoxPrimitive::SIDE_FRONT, ofColor::red);
+			ofxTest(a.getMesh().getNumColors() > 0 && static_cast<const ofBoxPrimitive&>(b).getMesh().getNumColors() == 0, "side colors only change one box");
+		}
+
+		{
+			// primitives grouped by mesh
+			std::vector<ofSpherePrimitive> spheres(100);
+			std::vector<ofBoxPrimitive> boxes(50);
+			for(auto & sphere: spheres){
+				sphere.setUseSharedMesh(true);
+				sphere.setRadius(ofRandom(1, 10));
+				sphere.setPosition(ofRandom(-100, 100), ofRandom(-100, 100), 0);
+			}
+			for(auto & box: boxes){
+				box.setUseSharedMesh(true);
+			}
+			ofPrimitiveBatch batch;
+			for(int frame=0;frame<2;frame++){
+				batch.clear();
+				for(auto & sphere: spheres) batch.add(sphere);
+				for(auto & box: boxes) batch.add(box);
+				ofxTestEq(batch.getNumMeshes(), size_t(2), "batch frame " + ofToString(frame) + " has one mesh per type");
+				ofxTestEq(batch.getTransforms(0).size(), spheres.size(), "batch frame " + ofToString(frame) + " has a transform per sphere");
+				ofxTestEq(batch.getTransforms(1).size(), boxes.size(), "batch frame " + ofToString(frame) + " has a transform per box");
+			}
+			ofxTest(batch.getTransforms(0)[10] == spheres[10].getMeshTransformMatrix(), "batch transforms");
+		}
+
+		{
+			// thousands of identical primitives
+			size_t count = 2000;
+			cache.purge();
+			cache.resetStats();
+
+			auto then = ofGetElapsedTimeMicros();
+			std::vector<ofSpherePrimitive> own(count);
+			for(auto & sphere: own){
+				sphere.set(ofRandom(1, 10), 32);
+			}
+			auto ownTime = ofGetElapsedTimeMicros() - then;
+
+			of3dPrimitive::setUseSharedMeshesByDefault(true);
+			then = ofGetElapsedTimeMicros();
+			std::vector<ofSpherePrimitive> shared(count);
+			for(auto & sphere: shared){
+				sphere.set(ofRandom(1, 10), 32);
+			}
+			auto sharedTime = ofGetElapsedTimeMicros() - then;
+			of3dPrimitive::setUseSharedMeshesByDefault(false);
+			ofxTest(shared.front().isUsingSharedMesh(), "shared by default");
+
+			auto stats = cache.getStats();
+			ofxTestEq(stats.numMeshes, size_t(2), "one mesh for the default and one for the set resolution");
+			ofxTestEq(stats.numUsers, count, "every sphere uses the cached mesh");
+			ofxTestEq(stats.misses, size_t(2), "generated once per resolution");
+			ofxTest(stats.bytesSaved >= (count - 1) * stats.bytes / 2, "memory saved");
+			ofLogNotice() << count << " spheres: own meshes " << ownTime / 1000. << "ms, shared " << sharedTime / 1000. << "ms, "
+						  << stats.bytes / 1024 << "KB cached, " << stats.bytesSaved / 1024 << "KB saved, generation " << stats.generationTime / 1000. << "ms";
+
+			shared.clear();
+			cache.purge();
+			ofxTestEq(cache.getStats().numMeshes, size_t(0), "purge releases unused meshes");
+		}
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = make_shared<ofAppNoWindow>();
+	auto app = make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
@@ -256,6 +256,337 @@ public:
 		ofxTestEq(received, str, "received max size message == sent message");
 	}
 
+	// many clients sending messages split in random sized writes to check
+	// the framing and how long it takes to receive all of them
+	void testEventServerLoad(ofxTCPFraming framing){
+		ofLogNotice() << "";
+		ofLogNotice() << "---------------------------------------";
+		ofLogNotice() << "testEventServerLoad " << (framing == OFXTCP_FRAMING_DELIMITER ? "delimiter" : "length prefix");
+
+		const int numClients = 200;
+		const int numMessages = 50;
+		int port = ofRandom(15000, 65535);
+
+		ofxTCPSettings settings(port);
+		settings.framing = framing;
+		ofxTCPEventServer server;
+		ofxTest(server.setup(settings), "event server");
+
+		std::vector<std::unique_ptr<ofxTCPManager>> clients;
+		bool allConnected = true;
+		for(int i = 0; i < numClients; i++){
+			clients.emplace_back(new ofxTCPManager);
+			allConnected &= clients.back()->Create() && clients.back()->Connect("127.0.0.1", port);
+		}
+		ofxTest(allConnected, "connect " + ofToString(numClients) + " clients");
+
+		auto then = ofGetElapsedTimeMillis();
+		for(int i = 0; i < numClients; i++){
+			std::string stream;
+			for(int j = 0; j < numMessages; j++){
+				auto message = "client " + ofToString(i) + " message " + ofToString(j) + std::string(ofRandom(200), 'x');
+				if(framing == OFXTCP_FRAMING_LENGTH_PREFIX){
+					uint32_t size = message.size();
+					char header[4] = {char(size >> 24), char(size >> 16), char(size >> 8), char(size)};
+					stream += std::string(header, 4) + message;
+				}else{
+					stream += message + settings.messageDelimiter;
+				}
+			}
+			size_t sent = 0;
+			while(sent < stream.size()){
+				size_t size = std::min<size_t>(stream.size() - sent, 1 + ofRandom(300));
+				clients[i]->SendAll(stream.data() + sent, size);
+				sent += size;
+			}
+		}
+
+		// ids are assigned in connection order
+		std::vector<int> next(numClients, 0);
+		int received = 0;
+		int connected = 0;
+		bool inOrder = true;
+		std::vector<ofxTCPMessage> messages;
+		while(received < numClients * numMessages && ofGetElapsedTimeMillis() - then < 10000){
+			messages.clear();
+			if(server.receiveAll(messages) == 0){
+				ofSleepMillis(1);
+			}
+			for(auto & message: messages){
+				if(message.type == ofxTCPMessage::Connected){
+					connected++;
+				}else if(message.type == ofxTCPMessage::Message){
+					auto expected = "client " + ofToString(message.clientID) + " message " + ofToString(next[message.clientID]++);
+					auto text = message.data.getText();
+					inOrder &= text.compare(0, expected.size(), expected) == 0 && text.find_first_not_of('x', expected.size()) == std::string::npos;
+					received++;
+				}
+			}
+		}
+		auto elapsed = ofGetElapsedTimeMillis() - then;
+		ofxTestEq(connected, numClients, "connections are notified");
+		ofxTestEq(received, numClients * numMessages, "every message received");
+		ofxTest(inOrder, "messages are complete and in order");
+		ofLogNotice() << received << " messages from " << numClients << " clients received in " << elapsed << "ms";
+
+		// the same buffer is sent to every client without copying it
+		auto buffer = std::make_shared<ofBuffer>();
+		buffer->allocate(100000);
+		buffer->setall('b');
+		ofxTestEq(server.sendToAll(buffer), size_t(numClients), "send to all");
+		size_t expectedSize = buffer->size() + (framing == OFXTCP_FRAMING_LENGTH_PREFIX ? 4 : settings.messageDelimiter.size());
+		bool allReceived = true;
+		for(auto & client: clients){
+			std::vector<char> data(expectedSize);
+			size_t size = 0;
+			while(size < expectedSize){
+				int ret = client->Receive(data.data() + size, expectedSize - size);
+				if(ret <= 0){
+					break;
+				}
+				size += ret;
+			}
+			allReceived &= size == expectedSize;
+		}
+		ofxTest(allReceived, "every client receives the broadcast");
+
+		clients[0]->Close();
+		ofxTest(server.disconnectClient(1), "disconnect client");
+		int disconnected = 0;
+		then = ofGetElapsedTimeMillis();
+		while(disconnected < 2 && ofGetElapsedTimeMillis() - then < 2000){
+			ofxTCPMessage message;
+			while(server.receive(message)){
+				disconnected += message.type == ofxTCPMessage::Disconnected;
+			}
+			ofSleepMillis(1);
+		}
+		ofxTestEq(disconnected, 2, "disconnections are notified");
+		ofxTestEq(server.getNumClients(), size_t(numClients - 2), "disconnected clients are removed");
+	}
+
+	void testEventServerCompatibility(){
+		ofLogNotice() << "";
+		ofLogNotice() << "---------------------------------------";
+		ofLogNotice() << "testEventServerCompatibility";
+
+		int port = ofRandom(15000, 65535);
+		ofxTCPEventServer server;
+		// the client sends text with send()
+		ofxTCPSettings settings(port);
+		settings.skipSendTerminator = true;
+		ofxTest(server.setup(settings), "event server");
+
+		ofxTCPClient client;
+		ofxTest(client.setup("127.0.0.1", port, true), "blocking client");
+		client.send("hello");
+		client.send("world");
+
+		std::vector<ofxTCPMessage> messages;
+		auto then = ofGetElapsedTimeMillis();
+		while(messages.size() < 3 && ofGetElapsedTimeMillis() - then < 2000){
+			server.receiveAll(messages);
+			ofSleepMillis(1);
+		}
+		ofxTestEq(messages.size(), size_t(3), "connection and messages from ofxTCPClient");
+		if(messages.size() == 3){
+			ofxTestEq(messages[1].data.getText(), std::string("hello"), "first message");
+			ofxTestEq(messages[2].data.getText(), std::string("world"), "second message");
+			ofxTest(server.send(messages[1].clientID, "reply"), "send to ofxTCPClient");
+			ofxTestEq(client.receive(), std::string("reply"), "ofxTCPClient receives");
+		}
+
+		// the 0 after the delimiter of send() is skipped, the zeros a
+		// binary message starts with are kept
+		const char zeros[] = {0, 0, 4};
+		client.sendRawMsg(zeros, sizeof(zeros));
+		messages.clear();
+		then = ofGetElapsedTimeMillis();
+		while(messages.empty() && ofGetElapsedTimeMillis() - then < 2000){
+			server.receiveAll(messages);
+			ofSleepMillis(1);
+		}
+		ofxTestEq(messages.size(), size_t(1), "binary message from ofxTCPClient");
+		if(messages.size() == 1){
+			ofxTestEq(messages[0].data.size(), sizeof(zeros), "leading zeros kept");
+			ofxTest(memcmp(messages[0].data.getData(), zeros, sizeof(zeros)) == 0, "leading zeros data");
+		}
+
+		// without skipSendTerminator a binary message right after another
+		// one keeps its first 0
+		int rawPort = ofRandom(15000, 65535);
+		ofxTCPEventServer rawServer;
+		ofxTest(rawServer.setup(rawPort), "event server for binary messages");
+		ofxTCPClient rawClient;
+		ofxTest(rawClient.setup("127.0.0.1", rawPort, true), "binary client");
+		const char first[] = {1, 2};
+		rawClient.sendRawMsg(first, sizeof(first));
+		rawClient.sendRawMsg(zeros, sizeof(zeros));
+		messages.clear();
+		then = ofGetElapsedTimeMillis();
+		while(messages.size() < 3 && ofGetElapsedTimeMillis() - then < 2000){
+			rawServer.receiveAll(messages);
+			ofSleepMillis(1);
+		}
+		ofxTestEq(messages.size(), size_t(3), "connection and consecutive binary messages");
+		if(messages.size() == 3){
+			ofxTest(messages[1].data.size() == sizeof(first) && memcmp(messages[1].data.getData(), first, sizeof(first)) == 0, "first binary message data");
+			ofxTestEq(messages[2].data.size(), sizeof(zeros), "leading zeros kept after a binary message");
+			ofxTest(memcmp(messages[2].data.getData(), zeros, sizeof(zeros)) == 0, "leading zeros data after a binary message");
+		}
+	}
+
+	void testClientFraming(ofxTCPFraming framing){
+		ofLogNotice() << "";
+		ofLogNotice() << "---------------------------------------";
+		ofLogNotice() << "testClientFraming " << (framing == OFXTCP_FRAMING_DELIMITER ? "delimiter" : "length prefix");
+
+		int port = ofRandom(15000, 65535);
+
+		ofxTCPSettings settings(port);
+		settings.blocking = true;
+		settings.framing = framing;
+		ofxTCPServer server;
+		ofxTest(server.setup(settings), "blocking server");
+
+		ofxTCPSettings clientSettings("127.0.0.1", port);
+		clientSettings.framing = framing;
+		// the server sends text with send()
+		clientSettings.skipSendTerminator = true;
+		ofxTCPClient client;
+		ofxTest(client.setup(clientSettings), "non blocking client");
+
+		// wait for connection to be made
+		server.waitConnectedClient(500);
+
+		// parts are sent as a single message
+		std::string header = "{\"type\":\"data\",";
+		std::string body = "\"value\":" + ofToString(ofRandom(1000)) + "}";
+		ofxTest(client.sendMessage({header, body}), "send message in parts");
+		ofxTestEq(server.receive(0), header + body, "parts received as one message");
+
+		// the receiver gets messages that arrive in many parts and messages
+		// that arrive together in the same read
+		std::string big(1024 * 1024, 'x');
+		bool sent = true;
+		std::thread sender([&]{
+			sent &= server.send(0, big);
+			sent &= server.send(0, "small");
+		});
+		ofxTCPDataView message;
+		std::vector<std::string> received;
+		auto then = ofGetElapsedTimeMillis();
+		while(received.size() < 2 && ofGetElapsedTimeMillis() - then < 5000){
+			if(client.receiveMessage(message)){
+				received.push_back(message.getText());
+			}
+		}
+		sender.join();
+		ofxTest(sent, "send big and small messages");
+		ofxTestEq(received.size(), size_t(2), "received both messages");
+		if(received.size() == 2){
+			ofxTest(received[0] == big, "big message is complete");
+			ofxTestEq(received[1], std::string("small"), "small message after big one");
+		}
+
+		// binary data with null bytes in the middle
+		const char binary[] = {1, 0, 2, 0, 3};
+		ofxTest(server.sendRawMsg(0, binary, sizeof(binary)), "send binary message");
+		char receivedBinary[16];
+		int size = 0;
+		then = ofGetElapsedTimeMillis();
+		while(size == 0 && ofGetElapsedTimeMillis() - then < 2000){
+			size = client.receiveRawMsg(receivedBinary, sizeof(receivedBinary));
+		}
+		ofxTestEq(size, int(sizeof(binary)), "binary message size");
+		ofxTest(memcmp(binary, receivedBinary, sizeof(binary)) == 0, "binary message data");
+
+		// only the 0 send() adds after the delimiter is skipped, binary
+		// messages can start with zeros
+		ofxTest(server.send(0, "text"), "send text message");
+		std::string text;
+		then = ofGetElapsedTimeMillis();
+		while(text.empty() && ofGetElapsedTimeMillis() - then < 2000){
+			text = client.receive();
+		}
+		ofxTestEq(text, std::string("text"), "text message");
+		const char zeros[] = {0, 0, 4};
+		ofxTest(server.sendRawMsg(0, zeros, sizeof(zeros)), "send binary message starting with zeros");
+		size = 0;
+		then = ofGetElapsedTimeMillis();
+		while(size == 0 && ofGetElapsedTimeMillis() - then < 2000){
+			size = client.receiveRawMsg(receivedBinary, sizeof(receivedBinary));
+		}
+		ofxTestEq(size, int(sizeof(zeros)), "leading zeros kept");
+		ofxTest(memcmp(zeros, receivedBinary, sizeof(zeros)) == 0, "leading zeros data");
+
+		// without skipSendTerminator a binary message right after another
+		// one keeps its first 0
+		ofxTCPClient rawClient;
+		ofxTest(rawClient.setup("127.0.0.1", port, false), "second client");
+		then = ofGetElapsedTimeMillis();
+		while(server.getNumClients() < 2 && ofGetElapsedTimeMillis() - then < 2000){
+			ofSleepMillis(1);
+		}
+		rawClient.setFraming(framing);
+		const char first[] = {1, 2};
+		ofxTest(server.sendRawMsg(1, first, sizeof(first)), "send binary message");
+		ofxTest(server.sendRawMsg(1, zeros, sizeof(zeros)), "send binary message starting with zeros after it");
+		std::vector<std::vector<char>> rawMessages;
+		then = ofGetElapsedTimeMillis();
+		while(rawMessages.size() < 2 && ofGetElapsedTimeMillis() - then < 2000){
+			size = rawClient.receiveRawMsg(receivedBinary, sizeof(receivedBinary));
+			if(size > 0){
+				rawMessages.emplace_back(receivedBinary, receivedBinary + size);
+			}
+		}
+		ofxTestEq(rawMessages.size(), size_t(2), "consecutive binary messages");
+		if(rawMessages.size() == 2){
+			ofxTest(rawMessages[0] == std::vector<char>(first, first + sizeof(first)), "first binary message data");
+			ofxTest(rawMessages[1] == std::vector<char>(zeros, zeros + sizeof(zeros)), "leading zeros kept after a binary message");
+		}
+	}
+
+	// big json like messages used to get slower to receive the bigger they
+	// were since the whole message was searched for the delimiter on every read
+	void testClientLargeMessages(){
+		ofLogNotice() << "";
+		ofLogNotice() << "---------------------------------------";
+		ofLogNotice() << "testClientLargeMessages";
+
+		const int numMessages = 20;
+		int port = ofRandom(15000, 65535);
+
+		ofxTCPServer server;
+		ofxTest(server.setup(port, true), "blocking server");
+
+		ofxTCPClient client;
+		ofxTest(client.setup("127.0.0.1", port, false), "non blocking client");
+		server.waitConnectedClient(500);
+
+		std::string json = "{\"data\":\"" + std::string(1024 * 1024, 'x') + "\"}";
+		std::thread sender([&]{
+			for(int i = 0; i < numMessages; i++){
+				server.send(0, json);
+			}
+		});
+		int received = 0;
+		bool complete = true;
+		auto then = ofGetElapsedTimeMillis();
+		while(received < numMessages && ofGetElapsedTimeMillis() - then < 10000){
+			auto message = client.receive();
+			if(!message.empty()){
+				complete &= message == json;
+				received++;
+			}
+		}
+		auto elapsed = ofGetElapsedTimeMillis() - then;
+		sender.join();
+		ofxTestEq(received, numMessages, "every message received");
+		ofxTest(complete, "messages are complete");
+		ofLogNotice() << received << " messages of " << json.size() << " bytes received in " << elapsed << "ms";
+	}
+
 	void run(){
 		ofSeedRandom(ofGetSeconds());
 		testNonBlocking();
@@ -266,6 +597,12 @@ public:
 		testWrongConnect();
 		testReceiveTimeout();
 		testSendMaxSize();
+		testEventServerLoad(OFXTCP_FRAMING_DELIMITER);
+		testEventServerLoad(OFXTCP_FRAMING_LENGTH_PREFIX);
+		testEventServerCompatibility();
+		testClientFraming(OFXTCP_FRAMING_DELIMITER);
+		testClientFraming(OFXTCP_FRAMING_LENGTH_PREFIX);
+		testClientLargeMessages();
 	}
 };
 
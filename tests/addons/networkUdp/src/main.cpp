@@ -192,11 +192,84 @@ class ofApp: public ofxUnitTestsApp{
         ofxTestEq(receivedPort, serverport, "client received from servers bound port");
     }
 
+	void testSendReceiveMany(){
+		int port = ofRandom(15000, 65535);
+		ofxUDPManager server;
+		ofxTest(server.Create(), "create udp socket");
+		ofxTest(server.SetNonBlocking(true), "set non-blocking");
+		ofxTest(server.Bind(port), "bind udp socket");
+
+		ofxUDPManager client;
+		ofxTest(client.Create(), "create udp socket");
+		ofxTest(client.SetNonBlocking(true), "set udp socket non blocking");
+		ofxTest(client.Connect("127.0.0.1", port), "set ip and port to send for udp socket");
+
+		const int numPackets = 100;
+		std::vector<std::string> packets;
+		std::vector<const char*> buffers;
+		std::vector<int> sizes;
+		for(int i = 0; i < numPackets; i++){
+			packets.push_back("packet " + ofToString(i));
+		}
+		packets.push_back(std::string(100, 'x'));
+		for(auto & packet: packets){
+			buffers.push_back(packet.c_str());
+			sizes.push_back(packet.size());
+		}
+		ofxTestEq(client.SendMany(buffers.data(), sizes.data(), buffers.size()), int(buffers.size()), "client sends all the packets with one call");
+
+		ofxUDPPacketBuffer received(32, 64);
+		std::vector<std::string> receivedPackets;
+		bool truncated = false;
+		for(int i = 0; i < 20 && receivedPackets.size() < packets.size(); i++){
+			auto ret = server.ReceiveMany(received);
+			ofxTest(ret >= 0, "server receiving many non block");
+			ofxTest(ret <= 32, "server receives at most the buffer size");
+			for(int j = 0; j < ret; j++){
+				receivedPackets.emplace_back(received.GetData(j), received.GetSize(j));
+				truncated = received.IsTruncated(j);
+			}
+			if(ret == 0){
+				ofSleepMillis(10);
+			}
+		}
+		ofxTestEq(receivedPackets.size(), packets.size(), "server received all the packets");
+		bool inOrder = true;
+		for(int i = 0; i < numPackets && i < int(receivedPackets.size()); i++){
+			inOrder &= receivedPackets[i] == packets[i];
+		}
+		ofxTest(inOrder, "packets received in order");
+		ofxTest(truncated, "packet bigger than the buffer is truncated");
+		ofxTestEq(receivedPackets.back(), std::string(64, 'x'), "truncated packet keeps the beginning");
+
+		std::string address;
+		int remotePort;
+		ofxTest(received.GetRemoteAddr(0, address, remotePort), "get remote address of a packet");
+		ofxTestEq(address, std::string("127.0.0.1"), "remote address of a packet");
+
+		ofxUDPPacketBuffer moved(std::move(received));
+		ofxTestEq(moved.GetMaxPackets(), size_t(32), "moved packet buffer keeps its size");
+		ofxTestEq(received.GetMaxPackets(), size_t(0), "moved from packet buffer is empty");
+		ofxTestEq(received.GetNumPackets(), size_t(0), "moved from packet buffer has no packets");
+		ofxTest(server.ReceiveMany(received) < 0, "moved from packet buffer can't receive");
+		client.Send("after move", 10);
+		int ret = 0;
+		for(int i = 0; i < 20 && ret == 0; i++){
+			ret = server.ReceiveMany(moved);
+			if(ret == 0){
+				ofSleepMillis(10);
+			}
+		}
+		ofxTestEq(ret, 1, "moved packet buffer receives");
+		ofxTestEq(std::string(moved.GetData(0), moved.GetSize(0)), std::string("after move"), "moved packet buffer receives into its memory");
+	}
+
 	void run(){
 		testNonBlocking();
 		testBlocking();
 		testTimeOutRecv();
         testPortsStayBound();
+		testSendReceiveMany();
 	}
 };
 
@@ -0,0 +1,730 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+#include "ofxOpenCv.h"
+
+class ofApp: public ofxUnitTestsApp{
+	// dark noise with bright discs, like a thresholded camera frame would
+	// see them
+	void drawFrame(unsigned char * data, int w, int h, int stride, int numDiscs, int radius){
+		for(int y = 0; y < h; y++){
+			for(int x = 0; x < w; x++){
+				data[y * stride + x] = (unsigned char)ofRandom(0, 60);
+			}
+		}
+		for(int i = 0; i < numDiscs; i++){
+			int cx = ofRandom(radius + 1, w - radius - 1);
+			int cy = ofRandom(radius + 1, h - radius - 1);
+			for(int y = cy - radius; y <= cy + radius; y++){
+				for(int x = cx - radius; x <= cx + radius; x++){
+					if((x - cx) * (x - cx) + (y - cy) * (y - cy) <= radius * radius){
+						data[y * stride + x] = 220;
+					}
+				}
+			}
+		}
+	}
+
+	void drawSquare(ofPixels & pixels, int x0, int y0, int size){
+		for(int y = y0; y < y0 + size; y++){
+			for(int x = x0; x < x0 + size; x++){
+				pixels[y * pixels.getWidth() + x] = 255;
+			}
+		}
+	}
+
+	void testExternalPixels(){
+		ofPixels pixels;
+		pixels.allocate(64, 48, OF_PIXELS_GRAY);
+		pixels.set(100);
+		pixels[10 * 64 + 10] = 200;
+
+		ofxCvGrayscaleImage image;
+		image.setUseTexture(false);
+		image.setFromExternalPixels(pixels);
+		ofxTest(image.isUsingExternalPixels(), "using external pixels");
+		ofxTest((unsigned char*)image.getCvImage()->imageData == pixels.getData(), "cv image points to the pixels");
+		ofxTestEq(image.getWidth(), 64.f, "external width");
+		ofxTestEq(image.getHeight(), 48.f, "external height");
+
+		image.threshold(150);
+		ofxTestEq(int(pixels[10 * 64 + 10]), 255, "threshold writes into the pixels");
+		ofxTestEq(int(pixels[0]), 0, "threshold writes into the pixels");
+
+		// operations that use the temp image end up in the external memory too
+		pixels.set(0);
+		pixels[20 * 64 + 20] = 255;
+		image.flagImageChanged();
+		image.dilate();
+		ofxTest((unsigned char*)image.getCvImage()->imageData == pixels.getData(), "dilate keeps the external memory");
+		ofxTestEq(int(pixels[21 * 64 + 21]), 255, "dilate writes into the pixels");
+
+		// rows with padding
+		int w = 10, h = 4, stride = 16;
+		std::vector<unsigned char> padded(stride * h, 7);
+		for(int y = 0; y < h; y++){
+			for(int x = 0; x < w; x++){
+				padded[y * stride + x] = x < 5 ? 10 : 200;
+			}
+		}
+		ofxCvGrayscaleImage strided;
+		strided.setUseTexture(false);
+		strided.setFromExternalPixels(padded.data(), w, h, stride);
+		ofxTestEq(strided.getCvImage()->widthStep, stride, "width step respected");
+		strided.threshold(100);
+		bool rowsOk = true, paddingOk = true;
+		for(int y = 0; y < h; y++){
+			for(int x = 0; x < w; x++){
+				rowsOk &= padded[y * stride + x] == (x < 5 ? 0 : 255);
+			}
+			for(int x = w; x < stride; x++){
+				paddingOk &= padded[y * stride + x] == 7;
+			}
+		}
+		ofxTest(rowsOk, "strided threshold");
+		ofxTest(paddingOk, "padding untouched");
+		auto & stridedPixels = strided.getPixels();
+		ofxTestEq(int(stridedPixels[w - 1]), 255, "getPixels of strided memory");
+
+		// the same size only points to the new memory
+		std::vector<unsigned char> other(stride * h, 0);
+		auto temp = strided.getCvImage();
+		strided.setFromExternalPixels(other.data(), w, h, stride);
+		ofxTest(strided.getCvImage() == temp && (unsigned char*)strided.getCvImage()->imageData == other.data(), "same size reuses the header");
+
+		strided.clear();
+		ofxTest(!strided.isUsingExternalPixels(), "clear stops using external memory");
+		strided.allocate(w, h);
+		ofxTest(!strided.isUsingExternalPixels() && strided.bAllocated, "allocate after external memory");
+
+		// channels have to match
+		ofPixels rgb;
+		rgb.allocate(8, 8, OF_PIXELS_RGB);
+		ofxCvGrayscaleImage gray;
+		gray.setUseTexture(false);
+		gray.setFromExternalPixels(rgb);
+		ofxTest(!gray.bAllocated, "external pixels with other channels are rejected");
+		ofxCvColorImage color;
+		color.setUseTexture(false);
+		color.setFromExternalPixels(rgb);
+		ofxTest(color.isUsingExternalPixels(), "color image wraps rgb pixels");
+	}
+
+	void testRoiViews(){
+		ofxCvGrayscaleImage image;
+		image.setUseTexture(false);
+		image.allocate(40, 30);
+		image.set(0);
+
+		ofxCvGrayscaleImage view;
+		view.setUseTexture(false);
+		view.setFromExternalRoi(image, ofRectangle(10, 5, 20, 10));
+		ofxTestEq(view.getWidth(), 20.f, "roi view width");
+		ofxTestEq(view.getHeight(), 10.f, "roi view height");
+		view.set(255);
+		view.erode();
+		view.set(255);
+
+		auto & pixels = image.getPixels();
+		bool inside = true, outside = true;
+		for(int y = 0; y < 30; y++){
+			for(int x = 0; x < 40; x++){
+				bool in = x >= 10 && x < 30 && y >= 5 && y < 15;
+				(in ? inside : outside) &= pixels[y * 40 + x] == (in ? 255 : 0);
+			}
+		}
+		ofxTest(inside, "roi view writes its region");
+		ofxTest(outside, "roi view doesn't touch the rest");
+
+		view.setFromExternalRoi(image, ofRectangle(35, 25, 20, 20));
+		ofxTestEq(view.getWidth(), 5.f, "roi view clamped to the image");
+	}
+
+	void testContours(){
+		ofPixels pixels;
+		pixels.allocate(200, 100, OF_PIXELS_GRAY);
+		pixels.set(0);
+		// one square in each quarter, a bigger one in the first
+		drawSquare(pixels, 10, 10, 30);
+		drawSquare(pixels, 110, 10, 20);
+		drawSquare(pixels, 10, 60, 20);
+		drawSquare(pixels, 160, 60, 20);
+
+		ofxCvGrayscaleImage image;
+		image.setUseTexture(false);
+		image.setFromPixels(pixels);
+
+		ofxCvContourFinder finder;
+		finder.findContours(image, 10, 200 * 100, 10, false);
+		ofxTestEq(finder.nBlobs, 4, "contours found");
+		ofxTestEq(finder.blobs[0].boundingRect, ofRectangle(10, 10, 30, 30), "biggest first");
+		ofxTestEq(int(image.getPixels()[10 * 200 + 10]), 255, "input untouched");
+
+		std::vector<ofRectangle> rois{
+			{0, 0, 100, 50}, {100, 0, 100, 50}, {0, 50, 100, 50}, {100, 50, 100, 50},
+		};
+		ofxCvContourFinder roiFinder;
+		roiFinder.findContours(image, rois, 10, 200 * 100, 10, false);
+		ofxTestEq(roiFinder.nBlobs, 4, "contours found in the regions");
+		for(size_t i = 0; i < rois.size(); i++){
+			ofxTestEq(roiFinder.getRoiBlobs(i).size(), size_t(1), "one blob in region " + ofToString(i));
+		}
+		ofxTestEq(roiFinder.getRoiBlobs(3)[0].boundingRect, ofRectangle(160, 60, 20, 20), "region blobs in image coordinates");
+		ofxTest(glm::distance(glm::vec2(roiFinder.getRoiBlobs(3)[0].centroid), glm::vec2(169.5, 69.5)) < 1, "region centroid in image coordinates");
+		ofxTestEq(int(image.getPixels()[60 * 200 + 160]), 255, "input untouched by regions");
+
+		// the border of the second region cuts the square at 110, 10, the
+		// whole image still sees it complete
+		roiFinder.findContours(image, {{0, 0, 200, 100}, {0, 0, 120, 50}}, 10, 200 * 100, 10, false);
+		ofxTestEq(roiFinder.getRoiBlobs(0).size(), size_t(4), "overlapping regions");
+		bool whole = false;
+		for(auto & blob: roiFinder.getRoiBlobs(0)){
+			whole |= blob.boundingRect == ofRectangle(110, 10, 20, 20);
+		}
+		ofxTest(whole, "overlapping regions don't change each other");
+
+		// the same blobs found in place
+		ofxCvContourFinder inPlaceFinder;
+		ofxCvGrayscaleImage copy;
+		copy.setUseTexture(false);
+		copy.allocate(200, 100);
+		copy = image;
+		inPlaceFinder.findContoursInPlace(copy, 10, 200 * 100, 10, false);
+		ofxTestEq(inPlaceFinder.nBlobs, finder.nBlobs, "in place finds the same blobs");
+		bool same = true;
+		for(int i = 0; i < std::min(finder.nBlobs, inPlaceFinder.nBlobs); i++){
+			same &= finder.blobs[i].boundingRect == inPlaceFinder.blobs[i].boundingRect;
+			same &= finder.blobs[i].nPts == inPlaceFinder.blobs[i].nPts;
+		}
+		ofxTest(same, "in place blobs are the same");
+
+		copy = image;
+		roiFinder.findContours(copy, rois, 10, 200 * 100, 10, false, true, true);
+		ofxTestEq(roiFinder.nBlobs, 4, "contours found in place in the regions");
+		ofxTestEq(roiFinder.getRoiBlobs(1)[0].boundingRect, ofRectangle(110, 10, 20, 20), "in place region blobs");
+
+		// the image roi is kept
+		image.setROI(0, 0, 100, 100);
+		roiFinder.findContours(image, rois, 10, 200 * 100, 10, false);
+		ofxTestEq(roiFinder.nBlobs, 4, "regions ignore the image roi");
+		ofxTestEq(image.getROI(), ofRectangle(0, 0, 100, 100), "image roi restored");
+	}
+
+	void benchmarkPipeline(){
+		int w = 1920, h = 1080, cameras = 4, frames = 10;
+		std::vector<ofPixels> cameraFrames(cameras);
+		for(auto & frame: cameraFrames){
+			frame.allocate(w, h, OF_PIXELS_GRAY);
+			drawFrame(frame.getData(), w, h, w, 40, 20);
+		}
+
+		// copying every frame into the images and the contour finder
+		std::vector<ofxCvGrayscaleImage> images(cameras);
+		std::vector<ofxCvContourFinder> finders(cameras);
+		for(auto & image: images){
+			image.setUseTexture(false);
+		}
+		int copyBlobs = 0;
+		auto then = ofGetElapsedTimeMicros();
+		for(int frame = 0; frame < frames; frame++){
+			copyBlobs = 0;
+			for(int i = 0; i < cameras; i++){
+				images[i].setFromPixels(cameraFrames[i]);
+				images[i].threshold(128);
+				copyBlobs += finders[i].findContours(images[i], 20, w * h, 100, false);
+			}
+		}
+		auto copyTime = (ofGetElapsedTimeMicros() - then) / frames;
+
+		// wrapping the frames and finding contours in place, every camera
+		// in parallel
+		std::vector<ofPixels> thresholded(cameras);
+		int inPlaceBlobs = 0;
+		uint64_t inPlaceTime = 0;
+		for(int frame = 0; frame < frames; frame++){
+			// the pipeline destroys the frames, restore them outside of the timing
+			for(int i = 0; i < cameras; i++){
+				thresholded[i] = cameraFrames[i];
+			}
+			then = ofGetElapsedTimeMicros();
+			std::vector<int> found(cameras);
+			ofParallelFor(0, cameras, [&](size_t i){
+				images[i].setFromExternalPixels(thresholded[i]);
+				images[i].threshold(128);
+				found[i] = finders[i].findContoursInPlace(images[i], 20, w * h, 100, false);
+			});
+			inPlaceTime += ofGetElapsedTimeMicros() - then;
+			inPlaceBlobs = 0;
+			for(auto count: found){
+				inPlaceBlobs += count;
+			}
+		}
+		inPlaceTime /= frames;
+		ofxTestEq(inPlaceBlobs, copyBlobs, "in place pipeline finds the same blobs");
+
+		// the four cameras in one image, processed by regions
+		ofPixels combined;
+		combined.allocate(w * 2, h * 2, OF_PIXELS_GRAY);
+		std::vector<ofRectangle> rois;
+		for(int i = 0; i < cameras; i++){
+			int x = (i % 2) * w, y = (i / 2) * h;
+			rois.emplace_back(x, y, w, h);
+		}
+		ofxCvGrayscaleImage combinedImage;
+		combinedImage.setUseTexture(false);
+		ofxCvContourFinder combinedFinder;
+		std::vector<ofxCvGrayscaleImage> views(cameras);
+		for(auto & view: views){
+			view.setUseTexture(false);
+		}
+		int roiBlobs = 0;
+		uint64_t roiTime = 0;
+		for(int frame = 0; frame < frames; frame++){
+			for(int i = 0; i < cameras; i++){
+				cameraFrames[i].pasteInto(combined, rois[i].x, rois[i].y);
+			}
+			then = ofGetElapsedTimeMicros();
+			combinedImage.setFromExternalPixels(combined);
+			ofParallelFor(0, cameras, [&](size_t i){
+				views[i].setFromExternalRoi(combinedImage, rois[i]);
+				views[i].threshold(128);
+			});
+			roiBlobs = combinedFinder.findContours(combinedImage, rois, 20, w * h, 100, false, true, true);
+			roiTime += ofGetElapsedTimeMicros() - then;
+		}
+		roiTime /= frames;
+		ofxTestEq(roiBlobs, copyBlobs, "region pipeline finds the same blobs");
+
+		ofLogNotice() << cameras << " cameras " << w << "x" << h << ", threshold + contours per frame: copying "
+					  << copyTime / 1000. << "ms, in place in parallel " << inPlaceTime / 1000.
+					  << "ms, regions of one image " << roiTime / 1000. << "ms, " << copyBlobs << " blobs";
+	}
+
+	struct Component{
+		uint64_t area = 0;
+		double sumX = 0, sumY = 0;
+		int minX = std::numeric_limits<int>::max();
+		int minY = std::numeric_limits<int>::max();
+		int maxX = -1;
+		int maxY = -1;
+	};
+
+	// 8-connected components by flood fill, in raster order of their first
+	// pixel, to check the blob finder against
+	std::vector<Component> floodFill(const ofPixels & pixels, int threshold, std::vector<int> & labels){
+		int w = pixels.getWidth();
+		int h = pixels.getHeight();
+		size_t channels = pixels.getNumChannels();
+		labels.assign(w * h, -1);
+		std::vector<Component> components;
+		std::vector<std::pair<int,int>> stack;
+		for(int y = 0; y < h; y++){
+			for(int x = 0; x < w; x++){
+				if(pixels[(y * w + x) * channels] <= threshold || labels[y * w + x] >= 0) continue;
+				int label = components.size();
+				components.emplace_back();
+				auto & component = components.back();
+				labels[y * w + x] = label;
+				stack.emplace_back(x, y);
+				while(!stack.empty()){
+					auto p = stack.back();
+					stack.pop_back();
+					component.area++;
+					component.sumX += p.first;
+					component.sumY += p.second;
+					component.minX = std::min(component.minX, p.first);
+					component.minY = std::min(component.minY, p.second);
+					component.maxX = std::max(component.maxX, p.first);
+					component.maxY = std::max(component.maxY, p.second);
+					for(int dy = -1; dy <= 1; dy++){
+						for(int dx = -1; dx <= 1; dx++){
+							int nx = p.first + dx;
+							int ny = p.second + dy;
+							if(nx < 0 || ny < 0 || nx >= w || ny >= h) continue;
+							if(pixels[(ny * w + nx) * channels] <= threshold || labels[ny * w + nx] >= 0) continue;
+							labels[ny * w + nx] = label;
+							stack.emplace_back(nx, ny);
+						}
+					}
+				}
+			}
+		}
+		return components;
+	}
+
+	bool sameBlobs(const std::vector<ofxCvBlob> & blobs, std::vector<Component> components){
+		// largest first, in raster order for the same area
+		std::stable_sort(components.begin(), components.end(), [](const Component & a, const Component & b){
+			return a.area > b.area;
+		});
+		if(blobs.size() != components.size()) return false;
+		for(size_t i = 0; i < blobs.size(); i++){
+			auto & c = components[i];
+			if(blobs[i].area != c.area) return false;
+			if(blobs[i].boundingRect != ofRectangle(c.minX, c.minY, c.maxX - c.minX + 1, c.maxY - c.minY + 1)) return false;
+			if(std::abs(blobs[i].centroid.x - c.sumX / c.area) > 0.001) return false;
+			if(std::abs(blobs[i].centroid.y - c.sumY / c.area) > 0.001) return false;
+		}
+		return true;
+	}
+
+	// the contour goes around the outside of the blob through its border
+	// pixels, one step at a time
+	bool validContour(const ofxCvBlob & blob, const std::vector<int> & labels, int w, int h){
+		if(blob.pts.empty()) return false;
+		int label = labels[int(blob.pts[0].y) * w + int(blob.pts[0].x)];
+		auto labelAt = [&](int x, int y){
+			return x < 0 || y < 0 || x >= w || y >= h ? -1 : labels[y * w + x];
+		};
+		ofRectangle bounds(blob.pts[0].x, blob.pts[0].y, 1, 1);
+		for(size_t i = 0; i < blob.pts.size(); i++){
+			int x = blob.pts[i].x;
+			int y = blob.pts[i].y;
+			if(labelAt(x, y) != label) return false;
+			if(labelAt(x - 1, y) == label && labelAt(x + 1, y) == label && labelAt(x, y - 1) == label && labelAt(x, y + 1) == label) return false;
+			auto & next = blob.pts[(i + 1) % blob.pts.size()];
+			if(std::abs(next.x - x) > 1 || std::abs(next.y - y) > 1) return false;
+			bounds.growToInclude(glm::vec3(x + 1, y + 1, 0));
+			bounds.growToInclude(glm::vec3(x, y, 0));
+		}
+		return bounds == blob.boundingRect && blob.nPts == int(blob.pts.size());
+	}
+
+	void testBlobFinder(){
+		ofSeedRandom(11);
+		std::vector<glm::ivec2> sizes{{1, 1}, {1, 50}, {50, 1}, {7, 9}, {64, 48}, {97, 61}, {320, 240}};
+		bool same = true;
+		bool contours = true;
+		size_t tested = 0;
+		for(auto size : sizes){
+			ofPixels pixels;
+			pixels.allocate(size.x, size.y, OF_PIXELS_GRAY);
+			for(auto & pixel : pixels){
+				pixel = ofRandom(0, 256);
+			}
+			for(int threshold : {0, 100, 200, 254}){
+				std::vector<int> labels;
+				auto components = floodFill(pixels, threshold, labels);
+				for(int strips : {1, 3, 0, 1000}){
+					ofxCvBlobFinder finder;
+					finder.setThreshold(threshold);
+					finder.setNumStrips(strips);
+					finder.findBlobs(pixels, 0, size.x * size.y + 1, size.x * size.y, false);
+					same &= finder.getNumComponents() == components.size();
+					same &= sameBlobs(finder.blobs, components);
+					for(auto & blob : finder.blobs){
+						contours &= validContour(blob, labels, size.x, size.y);
+					}
+					tested++;
+				}
+			}
+		}
+		ofxTest(same, "blobs match a flood fill in " + ofToString(tested) + " random images");
+		ofxTest(contours, "contours go around the blobs");
+
+		// only the first channel of color pixels is used
+		ofPixels gray;
+		gray.allocate(97, 61, OF_PIXELS_GRAY);
+		for(auto & pixel : gray){
+			pixel = ofRandom(0, 256);
+		}
+		ofPixels color;
+		color.allocate(97, 61, OF_PIXELS_RGB);
+		for(size_t i = 0; i < gray.size(); i++){
+			color[i * 3] = gray[i];
+			color[i * 3 + 1] = 255 - gray[i];
+			color[i * 3 + 2] = 255;
+		}
+		ofxCvBlobFinder grayFinder, colorFinder;
+		grayFinder.setThreshold(128);
+		colorFinder.setThreshold(128);
+		grayFinder.findBlobs(gray, 0, 97 * 61, 1000);
+		colorFinder.findBlobs(color, 0, 97 * 61, 1000);
+		same = grayFinder.blobs.size() == colorFinder.blobs.size();
+		for(size_t i = 0; same && i < grayFinder.blobs.size(); i++){
+			same &= grayFinder.blobs[i].area == colorFinder.blobs[i].area;
+			same &= grayFinder.blobs[i].pts == colorFinder.blobs[i].pts;
+		}
+		ofxTest(same, "first channel of color pixels");
+
+		// memory with padding at the end of the rows
+		int stride = 112;
+		std::vector<unsigned char> padded(stride * 61, 255);
+		for(int y = 0; y < 61; y++){
+			memcpy(padded.data() + y * stride, gray.getData() + y * 97, 97);
+		}
+		ofxCvBlobFinder paddedFinder;
+		paddedFinder.setThreshold(128);
+		paddedFinder.findBlobs(padded.data(), 97, 61, 1, stride, 0, 97 * 61, 1000);
+		same = grayFinder.blobs.size() == paddedFinder.blobs.size();
+		for(size_t i = 0; same && i < grayFinder.blobs.size(); i++){
+			same &= grayFinder.blobs[i].area == paddedFinder.blobs[i].area;
+			same &= grayFinder.blobs[i].pts == paddedFinder.blobs[i].pts;
+		}
+		ofxTest(same, "rows with padding");
+
+		// filtered by area and sorted
+		ofPixels pixels;
+		pixels.allocate(200, 100, OF_PIXELS_GRAY);
+		pixels.set(0);
+		drawSquare(pixels, 10, 10, 30);
+		drawSquare(pixels, 110, 10, 20);
+		drawSquare(pixels, 10, 60, 20);
+		drawSquare(pixels, 160, 60, 10);
+		pixels[5 * 200 + 150] = 255;
+		ofxCvBlobFinder finder;
+		finder.findBlobs(pixels, 10, 200 * 100, 10);
+		ofxTestEq(finder.getNumComponents(), size_t(5), "components found");
+		ofxTestEq(finder.blobs.size(), size_t(4), "small blobs filtered");
+		ofxTestEq(finder.blobs[0].boundingRect, ofRectangle(10, 10, 30, 30), "biggest first");
+		ofxTestEq(finder.blobs[0].area, 900.f, "area in pixels");
+		ofxTestEq(finder.blobs[3].centroid, ofDefaultVec3(164.5, 64.5, 0), "centroid");
+		ofxTestEq(finder.blobs[1].boundingRect, ofRectangle(110, 10, 20, 20), "same area in raster order");
+		finder.findBlobs(pixels, 10, 800, 1);
+		ofxTestEq(finder.blobs.size(), size_t(1), "nConsidered");
+		ofxTestEq(finder.blobs[0].boundingRect, ofRectangle(110, 10, 20, 20), "max area");
+
+		// square contours with and without approximation
+		ofxTestEq(finder.blobs[0].nPts, 4, "approximated square contour");
+		ofxTestEq(finder.blobs[0].pts[0], ofDefaultVec3(110, 10, 0), "contour starts at the top left");
+		ofxTestEq(finder.blobs[0].pts[2], ofDefaultVec3(129, 29, 0), "contour goes clockwise");
+		ofxTestEq(finder.blobs[0].length, 76.f, "contour length");
+		finder.findBlobs(pixels, 10, 800, 1, false);
+		ofxTestEq(finder.blobs[0].nPts, 76, "square contour");
+		finder.findBlobs(pixels, 0, 2, 1);
+		ofxTestEq(finder.blobs[0].nPts, 1, "single pixel contour");
+		ofxTestEq(finder.blobs[0].length, 0.f, "single pixel length");
+
+		finder.setFindContours(false);
+		finder.findBlobs(pixels, 10, 200 * 100, 10);
+		ofxTestEq(finder.blobs.size(), size_t(4), "blobs without contours");
+		ofxTestEq(finder.blobs[0].nPts, 0, "no contours");
+
+		ofPixels empty;
+		ofxTestEq(finder.findBlobs(empty, 0, 100, 10), 0, "empty pixels");
+	}
+
+	void testBlobTracker(){
+		auto disc = [](glm::vec2 center){
+			ofxCvBlob blob;
+			blob.centroid = ofDefaultVec3(center.x, center.y, 0);
+			blob.area = 100;
+			blob.boundingRect.setFromCenter(center.x, center.y, 10, 10);
+			return blob;
+		};
+
+		ofxCvBlobTracker tracker;
+		tracker.setMaxDistance(20);
+		tracker.setPersistence(2);
+
+		// two blobs moving towards each other and crossing, their
+		// velocities keep them apart
+		std::vector<ofxCvBlob> blobs;
+		bool kept = true;
+		for(int frame = 0; frame < 10; frame++){
+			blobs = {disc({100 + frame * 8, 100}), disc({172 - frame * 8, 100})};
+			if(frame % 2){
+				std::swap(blobs[0], blobs[1]);
+			}
+			tracker.track(blobs);
+			if(frame == 0){
+				ofxTestEq(tracker.getNewIds().size(), size_t(2), "new blobs");
+				continue;
+			}
+			kept &= tracker.getNewIds().empty() && tracker.blobs.size() == 2;
+			kept &= tracker.getBlob(0) && tracker.getBlob(0)->centroid.x == 100 + frame * 8;
+			kept &= tracker.getBlob(1) && tracker.getBlob(1)->centroid.x == 172 - frame * 8;
+		}
+		ofxTest(kept, "ids kept while crossing");
+		ofxTestEq(tracker.getBlob(0)->velocity, ofDefaultVec3(8, 0, 0), "velocity");
+		ofxTestEq(tracker.getBlob(0)->age, 9, "age");
+
+		// lost for less frames than the persistence
+		tracker.reset();
+		tracker.track({disc({50, 50})});
+		tracker.track({});
+		ofxTestEq(tracker.blobs.size(), size_t(1), "lost blob kept");
+		ofxTestEq(tracker.blobs[0].lostFrames, 1, "lost frames");
+		tracker.track({});
+		tracker.track({disc({55, 50})});
+		ofxTestEq(tracker.blobs.size(), size_t(1), "blob found again");
+		ofxTestEq(tracker.blobs[0].id, 0, "found blob keeps its id");
+		ofxTestEq(tracker.blobs[0].lostFrames, 0, "found blob isn't lost");
+
+		// and for more
+		tracker.track({});
+		tracker.track({});
+		tracker.track({});
+		ofxTestEq(tracker.getRemovedIds(), std::vector<int>{0}, "removed after the persistence");
+		ofxTest(tracker.blobs.empty(), "removed blob");
+		tracker.track({disc({55, 50})});
+		ofxTestEq(tracker.blobs[0].id, 1, "new id after being removed");
+
+		// too far to be the same blob
+		tracker.track({disc({80, 50})});
+		ofxTestEq(tracker.getNewIds(), std::vector<int>{2}, "far blobs are new");
+		ofxTestEq(tracker.blobs.size(), size_t(2), "far blob and lost blob");
+		ofxTest(tracker.getBlob(1) && tracker.getBlob(1)->lostFrames == 1, "far blob doesn't take the id");
+
+		// a lot of blobs in any order
+		tracker.reset();
+		ofSeedRandom(3);
+		std::vector<glm::vec2> centers;
+		for(int y = 0; y < 30; y++){
+			for(int x = 0; x < 40; x++){
+				centers.emplace_back(x * 48 + 24, y * 36 + 18);
+			}
+		}
+		tracker.setMaxDistance(10);
+		tracker.track([&]{
+			std::vector<ofxCvBlob> blobs;
+			for(auto & center : centers) blobs.push_back(disc(center));
+			return blobs;
+		}());
+		kept = true;
+		std::vector<size_t> order(centers.size());
+		for(size_t i = 0; i < order.size(); i++){
+			order[i] = i;
+		}
+		for(int frame = 0; frame < 10; frame++){
+			for(size_t i = order.size() - 1; i > 0; i--){
+				std::swap(order[i], order[size_t(ofRandom(i + 1)) % (i + 1)]);
+			}
+			std::vector<ofxCvBlob> blobs;
+			for(auto i : order){
+				centers[i] += glm::vec2(ofRandom(-2, 2), ofRandom(-2, 2));
+				blobs.push_back(disc(centers[i]));
+			}
+			tracker.track(blobs);
+			kept &= tracker.getNewIds().empty() && tracker.getRemovedIds().empty();
+			for(size_t i = 0; i < centers.size(); i++){
+				auto blob = tracker.getBlob(i);
+				kept &= blob && blob->centroid.x == centers[i].x && blob->centroid.y == centers[i].y;
+			}
+		}
+		ofxTest(kept, "ids of " + ofToString(centers.size()) + " blobs kept");
+	}
+
+	void benchmarkBlobTracking(){
+		// a big multi-touch table, a grid of fingers moving around their
+		// cell over noise under the threshold with some bright speckles
+		int w = 1920;
+		int h = 1080;
+		int columns = 20;
+		int rows = 10;
+		int radius = 12;
+		ofPixels pixels;
+		pixels.allocate(w, h, OF_PIXELS_GRAY);
+		ofSeedRandom(5);
+		std::vector<unsigned char> noise(w * h);
+		for(auto & pixel : noise){
+			pixel = ofRandom(0, 60);
+		}
+		for(int i = 0; i < 500; i++){
+			noise[int(ofRandom(w * h))] = 255;
+		}
+
+		ofxCvBlobFinder finder;
+		finder.setThreshold(128);
+		ofxCvBlobTracker tracker;
+		size_t frames = 240;
+		uint64_t findTime = 0;
+		uint64_t trackTime = 0;
+		size_t newIds = 0;
+		size_t removedIds = 0;
+		bool allFound = true;
+		for(size_t frame = 0; frame < frames; frame++){
+			memcpy(pixels.getData(), noise.data(), noise.size());
+			for(int row = 0; row < rows; row++){
+				for(int column = 0; column < columns; column++){
+					float angle = (frame + row * columns + column) * 0.1f;
+					int cx = (column + 0.5f) * w / columns + cos(angle) * 20;
+					int cy = (row + 0.5f) * h / rows + sin(angle) * 20;
+					for(int y = cy - radius; y <= cy + radius; y++){
+						for(int x = cx - radius; x <= cx + radius; x++){
+							if((x - cx) * (x - cx) + (y - cy) * (y - cy) <= radius * radius){
+								pixels[y * w + x] = 220;
+							}
+						}
+					}
+				}
+			}
+			auto then = ofGetElapsedTimeMicros();
+			finder.findBlobs(pixels, 50, 5000, 1000);
+			auto found = ofGetElapsedTimeMicros();
+			tracker.track(finder.blobs);
+			auto tracked = ofGetElapsedTimeMicros();
+			findTime += found - then;
+			trackTime += tracked - found;
+			allFound &= finder.blobs.size() == size_t(rows * columns);
+			newIds += tracker.getNewIds().size();
+			removedIds += tracker.getRemovedIds().size();
+		}
+		ofxTest(allFound, "every finger found");
+		ofxTestEq(newIds, size_t(rows * columns), "fingers keep their ids");
+		ofxTestEq(removedIds, size_t(0), "no fingers lost");
+
+		double frameTime = double(findTime + trackTime) / frames;
+		ofLogNotice() << w << "x" << h << ", " << rows * columns << " fingers per frame: blobs "
+					  << double(findTime) / frames / 1000. << "ms, tracking " << double(trackTime) / frames / 1000.
+					  << "ms, " << 1000000. / frameTime << "fps";
+	}
+
+	void compareBlobFinder(){
+		// the same blobs as ofxCvContourFinder without thresholding first
+		int w = 1920;
+		int h = 1080;
+		ofSeedRandom(7);
+		ofPixels pixels;
+		pixels.allocate(w, h, OF_PIXELS_GRAY);
+		drawFrame(pixels.getData(), w, h, w, 200, 12);
+
+		ofxCvGrayscaleImage image;
+		image.setUseTexture(false);
+		image.allocate(w, h);
+		ofxCvContourFinder contourFinder;
+		ofxCvBlobFinder blobFinder;
+		blobFinder.setThreshold(128);
+		size_t frames = 20;
+		uint64_t contourTime = 0;
+		uint64_t blobTime = 0;
+		for(size_t frame = 0; frame < frames; frame++){
+			auto then = ofGetElapsedTimeMicros();
+			image.setFromPixels(pixels);
+			image.threshold(128);
+			contourFinder.findContours(image, 20, w * h, 1000, false);
+			contourTime += ofGetElapsedTimeMicros() - then;
+
+			then = ofGetElapsedTimeMicros();
+			blobFinder.findBlobs(pixels, 20, w * h, 1000);
+			blobTime += ofGetElapsedTimeMicros() - then;
+		}
+		ofxTestEq(blobFinder.blobs.size(), contourFinder.blobs.size(), "same blobs as the contour finder");
+		ofLogNotice() << w << "x" << h << " per frame: threshold + ofxCvContourFinder " << contourTime / frames / 1000.
+					  << "ms, ofxCvBlobFinder " << blobTime / frames / 1000. << "ms";
+	}
+
+	void run(){
+		testExternalPixels();
+		testRoiViews();
+		testContours();
+		benchmarkPipeline();
+		testBlobFinder();
+		testBlobTracker();
+		compareBlobFinder();
+		benchmarkBlobTracking();
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = make_shared<ofAppNoWindow>();
+	auto app = make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
@@ -0,0 +1,386 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+#include "ofxOsc.h"
+#include "ofxOscParameterSync.h"
+
+class ofApp: public ofxUnitTestsApp{
+public:
+	void testArguments(){
+		ofLogNotice() << "---------------------------------------";
+		ofLogNotice() << "testArguments";
+
+		ofBuffer blob("blob\0data", 9);
+		ofxOscMessage message;
+		message.setAddress("/test");
+		message.addInt32Arg(-5);
+		message.addInt64Arg(1ll << 40);
+		message.addFloatArg(1.5f);
+		message.addDoubleArg(2.5);
+		message.addStringArg("a string longer than the small string optimization");
+		message.addSymbolArg("symbol");
+		message.addCharArg('c');
+		message.addBoolArg(false);
+		message.addNoneArg();
+		message.addTriggerArg();
+		message.addTimetagArg(12345);
+		message.addBlobArg(blob);
+		message.addRgbaColorArg(0xff00ff00);
+
+		ofxTestEq(message.getTypeString(), std::string("ihfdsScFNItbr"), "type string");
+		ofxTestEq(message.getArgAsInt32(0), -5, "int32");
+		ofxTestEq(message.getArgAsInt64(1), std::int64_t(1ll << 40), "int64");
+		ofxTestEq(message.getArgAsFloat(2), 1.5f, "float");
+		ofxTestEq(message.getArgAsDouble(3), 2.5, "double");
+		ofxTestEq(message.getArgAsString(4), std::string("a string longer than the small string optimization"), "string");
+		ofxTestEq(message.getArgAsSymbol(5), std::string("symbol"), "symbol");
+		ofxTestEq(message.getArgAsChar(6), 'c', "char");
+		ofxTestEq(message.getArgAsBool(7), false, "bool");
+		ofxTest(message.getArgAsNone(8), "none");
+		ofxTest(message.getArgAsTrigger(9), "trigger");
+		ofxTestEq(message.getArgAsTimetag(10), std::uint64_t(12345), "timetag");
+		ofxTestEq(message.getArgAsBlob(11).getText(), blob.getText(), "blob");
+		ofxTestEq(message.getArgAsRgbaColor(12), std::uint32_t(0xff00ff00), "rgba color");
+		ofxTestEq(message.getArgAsFloat(0), -5.f, "int32 converted to float");
+
+		ofxOscMessage copy = message;
+		ofxTestEq(copy.getTypeString(), message.getTypeString(), "copy keeps the types");
+		ofxTestEq(copy.getArgAsString(4), message.getArgAsString(4), "copy keeps the strings");
+		ofxTestEq(copy.getArgAsBlob(11).getText(), blob.getText(), "copy keeps the blobs");
+
+		ofxOscMessage moved = std::move(copy);
+		ofxTestEq(moved.getAddress(), std::string("/test"), "move keeps the address");
+		ofxTestEq(moved.getArgAsSymbol(5), std::string("symbol"), "move keeps the arguments");
+
+		// moving into a message with content leaves the source empty
+		ofxOscMessage target;
+		target.setAddress("/old");
+		target.addIntArg(1);
+		target.setRemoteEndpoint("192.168.0.1", 9000);
+		target = std::move(moved);
+		ofxTestEq(target.getAddress(), std::string("/test"), "move assignment keeps the address");
+		ofxTestEq(moved.getAddress(), std::string(""), "moved from message has no address");
+		ofxTestEq(moved.getNumArgs(), std::size_t(0), "moved from message has no arguments");
+		ofxTestEq(moved.getRemoteIp(), std::string(""), "moved from message has no remote host");
+		ofxTestEq(moved.getRemotePort(), 0, "moved from message has no remote port");
+
+		message.clear();
+		ofxTestEq(message.getNumArgs(), std::size_t(0), "clear removes the arguments");
+		message.addStringArg("new");
+		ofxTestEq(message.getArgAsString(0), std::string("new"), "cleared message can be reused");
+	}
+
+	// messages with several arguments sent from a sender to a receiver
+	// on the same machine, received messages are reused by the receiver
+	void testLoopbackThroughput(){
+		ofLogNotice() << "";
+		ofLogNotice() << "---------------------------------------";
+		ofLogNotice() << "testLoopbackThroughput";
+
+		int port = ofRandom(15000, 65535);
+		ofxOscReceiver receiver;
+		ofxTest(receiver.setup(port), "receiver");
+		ofxOscSender sender;
+		ofxTest(sender.setup("127.0.0.1", port), "sender");
+
+		ofxOscMessage message;
+		message.setAddress("/sensors/values");
+		for(int i = 0; i < 16; i++){
+			message.addFloatArg(i);
+		}
+		message.addStringArg("sensor array with a long name");
+
+		const int numMessages = 100000;
+		int received = 0;
+		bool complete = true;
+		ofxOscMessage receivedMessage;
+		auto receive = [&]{
+			while(receiver.getNextMessage(receivedMessage)){
+				complete &= receivedMessage.getAddress() == "/sensors/values" &&
+					receivedMessage.getNumArgs() == 17 &&
+					receivedMessage.getArgAsFloat(15) == 15;
+				received++;
+			}
+		};
+		auto then = ofGetElapsedTimeMillis();
+		for(int i = 0; i < numMessages; i++){
+			sender.sendMessage(message, false);
+			receive();
+			// don't overflow the socket buffer
+			if(i % 64 == 0){
+				ofSleepMillis(1);
+			}
+		}
+		auto sent = ofGetElapsedTimeMillis();
+		while(received < numMessages && ofGetElapsedTimeMillis() - sent < 1000){
+			receive();
+		}
+		auto elapsed = ofGetElapsedTimeMillis() - then;
+		// udp can drop messages so only check that most of them arrived
+		ofxTestGt(received, numMessages * 9 / 10, "messages received");
+		ofxTest(complete, "messages are complete");
+		ofLogNotice() << received << " messages received in " << elapsed << "ms";
+	}
+
+	// handlers and parameters resolved by address, including wildcards
+	void testRouting(){
+		ofLogNotice() << "";
+		ofLogNotice() << "---------------------------------------";
+		ofLogNotice() << "testRouting";
+
+		int port = ofRandom(15000, 65535);
+		ofxOscReceiver receiver;
+		ofxTest(receiver.setup(port), "receiver");
+		ofxOscSender sender;
+		ofxTest(sender.setup("127.0.0.1", port), "sender");
+
+		int exact = 0, wildcard = 0, alternatives = 0;
+		std::atomic<int> listenerThread(0);
+		receiver.addHandler("/mixer/volume", [&](const ofxOscMessage &){ exact++; });
+		receiver.addHandler("/mixer/*/mute", [&](const ofxOscMessage &){ wildcard++; });
+		receiver.addHandler("/fx/{reverb,delay}/[0-9]", [&](const ofxOscMessage &){ alternatives++; });
+		auto listenerId = receiver.addHandler("/clock", [&](const ofxOscMessage &){ listenerThread++; }, OFXOSC_DISPATCH_LISTENER_THREAD);
+
+		ofParameter<float> gain{"gain", 0, 0, 1};
+		ofParameter<int> channel{"channel", 0, 0, 16};
+		ofParameterGroup group{"synth", gain, channel};
+		receiver.addParameter(group);
+
+		auto send = [&](const std::string & address, float value){
+			ofxOscMessage message;
+			message.setAddress(address);
+			message.addFloatArg(value);
+			sender.sendMessage(message, false);
+		};
+		send("/mixer/volume", 1);
+		send("/mixer/1/mute", 1);
+		send("/mixer/1/2/mute", 1);
+		send("/fx/reverb/3", 1);
+		send("/fx/chorus/3", 1);
+		send("/clock", 1);
+		send("/synth/gain", 0.5);
+		channel = 3;
+		sender.sendParameter(channel);
+		channel = 0;
+		send("/synth/*", 0.25);
+
+		std::vector<std::string> unhandled;
+		ofxOscMessage message;
+		auto then = ofGetElapsedTimeMillis();
+		while(unhandled.size() < 2 && ofGetElapsedTimeMillis() - then < 1000){
+			while(receiver.getNextMessage(message)){
+				unhandled.push_back(message.getAddress());
+			}
+		}
+		ofSleepMillis(20);
+		receiver.dispatchMessages();
+
+		ofxTestEq(exact, 1, "exact address");
+		ofxTestEq(wildcard, 1, "wildcards don't match across /");
+		ofxTestEq(alternatives, 1, "alternatives and ranges");
+		ofxTestEq(listenerThread.load(), 1, "listener thread handler");
+		ofxTestEq(gain.get(), 0.25f, "parameter set by address and by pattern");
+		ofxTestEq(channel.get(), 3, "parameter sent by ofxOscSender::sendParameter");
+		ofxTestEq(unhandled.size(), std::size_t(2), "messages without handler returned by getNextMessage");
+
+		receiver.removeHandler(listenerId);
+		send("/clock", 1);
+		then = ofGetElapsedTimeMillis();
+		while(!receiver.getNextMessage(message) && ofGetElapsedTimeMillis() - then < 1000){}
+		ofxTestEq(message.getAddress(), std::string("/clock"), "removed handler");
+		ofxTestEq(listenerThread.load(), 1, "removed handler isn't called");
+
+		// removing a handler waits for the listener thread to return from it
+		std::atomic<bool> started(false), finished(false);
+		auto slowId = receiver.addHandler("/slow", [&](const ofxOscMessage &){
+			started = true;
+			ofSleepMillis(50);
+			finished = true;
+		}, OFXOSC_DISPATCH_LISTENER_THREAD);
+		send("/slow", 1);
+		then = ofGetElapsedTimeMillis();
+		while(!started && ofGetElapsedTimeMillis() - then < 1000){}
+		receiver.removeHandler(slowId);
+		ofxTest(started && finished, "remove handler waits for the listener thread");
+
+		// and doesn't wait when the handler removes itself
+		std::atomic<int> calls(0);
+		std::size_t selfId = 0;
+		selfId = receiver.addHandler("/self", [&](const ofxOscMessage &){
+			calls++;
+			receiver.removeHandler(selfId);
+		}, OFXOSC_DISPATCH_LISTENER_THREAD);
+		send("/self", 1);
+		send("/self", 1);
+		then = ofGetElapsedTimeMillis();
+		int returned = 0;
+		while(returned < 1 && ofGetElapsedTimeMillis() - then < 1000){
+			while(receiver.getNextMessage(message)){
+				returned++;
+			}
+		}
+		ofxTestEq(calls.load(), 1, "handler removed from the listener thread");
+		ofxTestEq(returned, 1, "messages after removing it are returned");
+	}
+
+	// messages queued in bundles or packets until flush
+	void testQueuedSend(ofxOscSendMode mode){
+		ofLogNotice() << "";
+		ofLogNotice() << "---------------------------------------";
+		ofLogNotice() << "testQueuedSend " << (mode == OFXOSC_SEND_BUNDLE ? "bundle" : "packets");
+
+		int port = ofRandom(15000, 65535);
+		ofxOscReceiver receiver;
+		ofxTest(receiver.setup(port), "receiver");
+		ofxOscSenderSettings settings;
+		settings.host = "127.0.0.1";
+		settings.port = port;
+		settings.mode = mode;
+		settings.flushEveryFrame = false;
+		ofxOscSender sender;
+		ofxTest(sender.setup(settings), "sender");
+
+		const int numMessages = 100;
+		ofBuffer data(std::string(32, 'x').c_str(), 32);
+		for(int i = 0; i < numMessages; i++){
+			ofxOscMessage message;
+			message.setAddress("/universe");
+			message.addIntArg(i);
+			message.addBlobArg(data);
+			sender.sendMessage(message);
+		}
+		ofSleepMillis(50);
+		ofxTest(!receiver.hasWaitingMessages(), "nothing sent before flush");
+		sender.flush();
+
+		int received = 0;
+		bool inOrder = true;
+		ofxOscMessage message;
+		auto then = ofGetElapsedTimeMillis();
+		while(received < numMessages && ofGetElapsedTimeMillis() - then < 1000){
+			while(receiver.getNextMessage(message)){
+				inOrder &= message.getArgAsInt32(0) == received;
+				received++;
+			}
+		}
+		ofxTestEq(received, numMessages, "all messages received after flush");
+		ofxTest(inOrder, "messages received in order");
+
+		// messages queued before setting up another host go to the old one
+		int otherPort = port == 65535 ? port - 1 : port + 1;
+		ofxOscReceiver otherReceiver;
+		ofxTest(otherReceiver.setup(otherPort), "other receiver");
+		message.clear();
+		message.setAddress("/old");
+		sender.sendMessage(message);
+		settings.port = otherPort;
+		ofxTest(sender.setup(settings), "sender to the other receiver");
+		message.setAddress("/new");
+		sender.sendMessage(message);
+		sender.flush();
+		bool receivedOld = false, receivedNew = false, wrongHost = false;
+		then = ofGetElapsedTimeMillis();
+		while(!(receivedOld && receivedNew) && ofGetElapsedTimeMillis() - then < 1000){
+			while(receiver.getNextMessage(message)){
+				receivedOld |= message.getAddress() == "/old";
+				wrongHost |= message.getAddress() == "/new";
+			}
+			while(otherReceiver.getNextMessage(message)){
+				receivedNew |= message.getAddress() == "/new";
+				wrongHost |= message.getAddress() == "/old";
+			}
+		}
+		ofxTest(receivedOld, "queued message sent to the old host on setup");
+		ofxTest(receivedNew, "message queued after setup sent to the new host");
+		ofxTest(!wrongHost, "no message sent to the wrong host");
+	}
+
+	// a late joiner gets the whole group and changes are sent at most
+	// maxRate times per second
+	void testParameterSync(){
+		ofLogNotice() << "";
+		ofLogNotice() << "---------------------------------------";
+		ofLogNotice() << "testParameterSync";
+
+		const int numParameters = 1000;
+		std::vector<ofParameter<float>> parametersA(numParameters), parametersB(numParameters);
+		ofParameterGroup groupA, groupB;
+		groupA.setName("sync");
+		groupB.setName("sync");
+		for(int i = 0; i < numParameters; i++){
+			groupA.add(parametersA[i].set("p" + ofToString(i), i));
+			groupB.add(parametersB[i].set("p" + ofToString(i), 0));
+		}
+
+		int port = ofRandom(15000, 65535);
+		ofxOscParameterSyncSettings settingsA;
+		settingsA.localPort = port;
+		settingsA.remoteHost = "127.0.0.1";
+		settingsA.remotePort = port + 1;
+		settingsA.requestSnapshot = false;
+		ofxOscParameterSyncSettings settingsB = settingsA;
+		settingsB.localPort = port + 1;
+		settingsB.remotePort = port;
+		settingsB.requestSnapshot = true;
+
+		ofxOscParameterSync syncA, syncB;
+		syncA.setup(groupA, settingsA);
+		syncB.setup(groupB, settingsB);
+
+		auto then = ofGetElapsedTimeMillis();
+		while(parametersB.back() != numParameters - 1 && ofGetElapsedTimeMillis() - then < 1000){
+			syncA.update();
+			syncB.update();
+			ofSleepMillis(1);
+		}
+		bool snapshot = true;
+		for(int i = 0; i < numParameters; i++){
+			snapshot &= parametersB[i] == parametersA[i];
+		}
+		ofxTest(snapshot, "late joiner receives all the parameters");
+
+		// simulate dragging a slider, several changes per frame for a bit more
+		// than two seconds so the stats don't include the snapshot
+		then = ofGetElapsedTimeMillis();
+		while(ofGetElapsedTimeMillis() - then < 2100){
+			for(int i = 0; i < 10; i++){
+				parametersA[0] = parametersA[0] + 1;
+			}
+			syncA.update();
+			syncB.update();
+			ofSleepMillis(5);
+		}
+		ofSleepMillis(1000 / settingsA.maxRate);
+		syncA.update();
+		ofSleepMillis(20);
+		syncB.update();
+		ofxTestEq(parametersB[0].get(), parametersA[0].get(), "last value received");
+		ofxTestGt(syncA.getSentMessagesPerSecond(), 0.f, "changes sent");
+		ofxTest(syncA.getSentMessagesPerSecond() <= settingsA.maxRate + 1, "changes sent at most maxRate times per second");
+		ofxTestGt(syncA.getSentBytesPerSecond(), 0.f, "bytes sent");
+		ofxTestGt(syncB.getReceivedMessagesPerSecond(), 0.f, "messages received");
+		ofLogNotice() << syncA.getSentMessagesPerSecond() << " messages/s " << syncA.getSentBytesPerSecond() << " bytes/s";
+	}
+
+	void run(){
+		testArguments();
+		testLoopbackThroughput();
+		testRouting();
+		testQueuedSend(OFXOSC_SEND_BUNDLE);
+		testQueuedSend(OFXOSC_SEND_PACKETS);
+		testParameterSync();
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = make_shared<ofAppNoWindow>();
+	auto app = make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
@@ -118,6 +118,43 @@ class ofApp: public ofxUnitTestsApp{
 			ofxTestEq(selfUnregisterValue, 5, "Testing remove listener on event callback, second call");
 		}
 
+		{
+			// removing a listener waits for its calls in other threads
+			ofEvent<const int> intEvent;
+			std::atomic<bool> started{false};
+			std::atomic<bool> finished{false};
+			ofEventListener listener(intEvent.newListener([&](const int &){
+				started = true;
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+				finished = true;
+			}));
+			std::thread thread([&]{
+				intEvent.notify(5);
+			});
+			while(!started){
+				std::this_thread::yield();
+			}
+			listener.unsubscribe();
+			ofxTest(finished.load(), "Testing remove listener waits for the calls from other threads");
+			thread.join();
+		}
+
+		{
+			// the listeners being notified outlive the event
+			auto intEvent = std::make_unique<ofEvent<const int>>();
+			int calls = 0;
+			ofEventListeners listeners;
+			listeners.push(intEvent->newListener([&](const int &){
+				calls++;
+				intEvent.reset();
+			}, 0));
+			listeners.push(intEvent->newListener([&](const int &){
+				calls++;
+			}, 1));
+			intEvent->notify(5);
+			ofxTestEq(calls, 2, "Testing destroying the event from its callback");
+		}
+
 		{
 			ofEvent<void> voidEvent;
 			ofAddListener(voidEvent, this, &ofApp::voidListener);
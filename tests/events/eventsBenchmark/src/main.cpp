@@ -0,0 +1,114 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	std::atomic<uint64_t> intCalls{0};
+	uint64_t voidCalls = 0;
+
+	void intListener(const int & i){
+		intCalls += i;
+	}
+
+	void voidListener(){
+		voidCalls++;
+	}
+
+	// average cost of a notification in ns per listener per thread
+	double benchmarkNotify(size_t numListeners, size_t numThreads, size_t numNotifications){
+		ofEvent<const int> event;
+		ofEventListeners listeners;
+		for(size_t i=0;i<numListeners;i++){
+			listeners.push(event.newListener(this, &ofApp::intListener));
+		}
+
+		intCalls = 0;
+		vector<std::thread> threads;
+		auto then = ofGetElapsedTimeMicros();
+		for(size_t t=0;t<numThreads;t++){
+			threads.emplace_back([&]{
+				for(size_t i=0;i<numNotifications;i++){
+					event.notify(1);
+				}
+			});
+		}
+		for(auto & thread: threads){
+			thread.join();
+		}
+		auto elapsed = ofGetElapsedTimeMicros() - then;
+
+		ofxTestEq(intCalls.load(), uint64_t(numListeners * numThreads * numNotifications), "notify reaches every listener with " + ofToString(numListeners) + " listeners and " + ofToString(numThreads) + " threads");
+		return elapsed * 1000. / double(numNotifications * numThreads);
+	}
+
+	void run(){
+		const size_t numNotifications = 100000;
+		for(size_t numThreads: {1, 2, 4, 8}){
+			for(size_t numListeners: {0, 1, 10, 100}){
+				auto ns = benchmarkNotify(numListeners, numThreads, numNotifications);
+				ofLogNotice() << "ofEvent<int>::notify " << numListeners << " listeners, "
+							  << numThreads << " threads: " << ns << "ns per notify";
+			}
+		}
+
+		// listeners added and removed while other threads are notifying
+		{
+			ofEvent<const int> event;
+			std::atomic<bool> running{true};
+			intCalls = 0;
+			vector<std::thread> threads;
+			for(size_t t=0;t<4;t++){
+				threads.emplace_back([&]{
+					while(running){
+						event.notify(1);
+					}
+				});
+			}
+			auto then = ofGetElapsedTimeMicros();
+			for(size_t i=0;i<10000;i++){
+				auto listener = event.newListener(this, &ofApp::intListener);
+			}
+			auto elapsed = ofGetElapsedTimeMicros() - then;
+			// replaced snapshots are reclaimed as soon as no notification
+			// uses them, even if some thread is always notifying
+			auto retired = of::priv::SnapshotHazards::get().getNumRetired();
+			ofxTest(retired <= 4, "replaced listener snapshots reclaimed while notifying, " + ofToString(retired) + " retired");
+			running = false;
+			for(auto & thread: threads){
+				thread.join();
+			}
+			ofxTestEq(event.size(), size_t(0), "all listeners removed while notifying from other threads");
+			ofLogNotice() << "ofEvent<int> add + remove while notifying from 4 threads: " << elapsed / 10. << "ns per listener";
+		}
+
+		// single threaded void events as fired by the core every frame
+		for(size_t numListeners: {1, 10, 100}){
+			ofEvent<void> event;
+			ofEventListeners listeners;
+			for(size_t i=0;i<numListeners;i++){
+				listeners.push(event.newListener(this, &ofApp::voidListener));
+			}
+			voidCalls = 0;
+			auto then = ofGetElapsedTimeMicros();
+			for(size_t i=0;i<numNotifications;i++){
+				event.notify();
+			}
+			auto elapsed = ofGetElapsedTimeMicros() - then;
+			ofxTestEq(voidCalls, uint64_t(numListeners * numNotifications), "void notify reaches every listener");
+			ofLogNotice() << "ofEvent<void>::notify " << numListeners << " listeners: " << elapsed * 1000. / numNotifications << "ns per notify";
+		}
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = make_shared<ofAppNoWindow>();
+	auto app = make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
@@ -309,6 +309,108 @@ class ofApp: public ofxUnitTestsApp{
                 ofxTestEq((uint64_t)&pixels.getLine(0).getPixel(10)[0], (uint64_t)pixels.getData()+(10*bpp/8),"getLine(0).getPixel(10)[0]==pixels.getData()+(10*bpp/8)");
 			}
 		}
+
+		testResize();
+		benchmarkResize();
+	}
+
+	string interpolationName(ofInterpolationMethod interpMethod){
+		switch(interpMethod){
+			case OF_INTERPOLATE_NEAREST_NEIGHBOR:
+				return "NEAREST_NEIGHBOR";
+			case OF_INTERPOLATE_BILINEAR:
+				return "BILINEAR";
+			case OF_INTERPOLATE_BICUBIC:
+				return "BICUBIC";
+			case OF_INTERPOLATE_AREA:
+				return "AREA";
+			case OF_INTERPOLATE_LANCZOS:
+				return "LANCZOS";
+		}
+		return "UNKNOWN";
+	}
+
+	void testResize(){
+		vector<ofInterpolationMethod> methods{OF_INTERPOLATE_BILINEAR, OF_INTERPOLATE_AREA, OF_INTERPOLATE_LANCZOS};
+		for(auto interpMethod: methods){
+			string name = interpolationName(interpMethod);
+
+			// a flat image has to stay flat when down and upscaling
+			for(auto pixelFormat: {OF_PIXELS_GRAY, OF_PIXELS_RGB, OF_PIXELS_RGBA}){
+				ofPixels src;
+				src.allocate(320,240,pixelFormat);
+				src.setColor(ofColor(100,150,200,250));
+				for(auto size: {glm::vec2(123,77), glm::vec2(640,480)}){
+					ofPixels dst;
+					dst.allocate(size.x,size.y,pixelFormat);
+					ofxTest(src.resizeTo(dst,interpMethod),"resizeTo() " + name + " " + formatName(pixelFormat));
+					ofxTestEq(dst.getColor(0,0),src.getColor(0,0),"resizeTo() " + name + " " + formatName(pixelFormat) + " keeps flat color top left");
+					ofxTestEq(dst.getColor(size.x-1,size.y-1),src.getColor(0,0),"resizeTo() " + name + " " + formatName(pixelFormat) + " keeps flat color bottom right");
+				}
+			}
+
+			// halving a ramp averages every pair of pixels
+			ofFloatPixels ramp;
+			ramp.allocate(100,2,OF_PIXELS_GRAY);
+			for(size_t i=0;i<ramp.size();i++){
+				ramp[i] = i % 100;
+			}
+			ofFloatPixels half;
+			half.allocate(50,1,OF_PIXELS_GRAY);
+			ramp.resizeTo(half,interpMethod);
+			if(interpMethod != OF_INTERPOLATE_LANCZOS){
+				ofxTestEq(half[1],2.5f,"resizeTo() " + name + " halving a float ramp");
+			}else{
+				ofxTest(std::abs(half[25]-50.5f)<0.01f,"resizeTo() " + name + " halving a float ramp");
+			}
+
+			// uint16 pixels must not be treated as bytes
+			ofShortPixels shortPixels;
+			shortPixels.allocate(64,64,OF_PIXELS_RGB);
+			shortPixels.setColor(ofShortColor(60000,1000,30000));
+			ofShortPixels shortDst;
+			shortDst.allocate(20,20,OF_PIXELS_RGB);
+			shortPixels.resizeTo(shortDst,interpMethod);
+			ofxTestEq(shortDst.getColor(10,10),ofShortColor(60000,1000,30000),"resizeTo() " + name + " ofShortPixels");
+
+			// splitting the work in bands gives the same result as a single thread
+			ofPixels noise;
+			noise.allocate(333,211,OF_PIXELS_RGB);
+			for(auto & p: noise){
+				p = ofRandom(255);
+			}
+			ofPixels single, banded;
+			single.allocate(97,61,OF_PIXELS_RGB);
+			banded.allocate(97,61,OF_PIXELS_RGB);
+			noise.resizeTo(single,interpMethod,1);
+			noise.resizeTo(banded,interpMethod,4);
+			ofxTest(memcmp(single.getData(),banded.getData(),single.size())==0,"resizeTo() " + name + " multithreaded equals single threaded");
+		}
+	}
+
+	void benchmarkResize(){
+		ofPixels src;
+		src.allocate(3840,2160,OF_PIXELS_RGB);
+		for(auto & p: src){
+			p = ofRandom(255);
+		}
+
+		vector<glm::vec2> sizes{{1920,1080}, {640,360}, {160,90}};
+		vector<ofInterpolationMethod> methods{OF_INTERPOLATE_NEAREST_NEIGHBOR, OF_INTERPOLATE_BICUBIC, OF_INTERPOLATE_BILINEAR, OF_INTERPOLATE_AREA, OF_INTERPOLATE_LANCZOS};
+		for(auto size: sizes){
+			ofPixels dst;
+			dst.allocate(size.x,size.y,OF_PIXELS_RGB);
+			for(auto interpMethod: methods){
+				auto then = ofGetElapsedTimeMicros();
+				src.resizeTo(dst,interpMethod);
+				auto single = ofGetElapsedTimeMicros() - then;
+				then = ofGetElapsedTimeMicros();
+				src.resizeTo(dst,interpMethod,0);
+				auto threaded = ofGetElapsedTimeMicros() - then;
+				ofLogNotice() << "resize 3840x2160 -> " << size.x << "x" << size.y << " " << interpolationName(interpMethod)
+							  << ": " << single / 1000.f << "ms, all cores " << threaded / 1000.f << "ms";
+			}
+		}
 	}
 };
 
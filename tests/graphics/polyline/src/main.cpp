@@ -0,0 +1,160 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	// a closed contour with noisy radius, concave in lots of places
+	ofPolyline contour(size_t numPoints){
+		ofPolyline polyline;
+		for(size_t i=0;i<numPoints;i++){
+			float angle = i * glm::two_pi<float>() / numPoints;
+			float radius = ofRandom(50, 100);
+			polyline.addVertex(radius * cos(angle), radius * sin(angle), ofRandom(-1, 1));
+		}
+		polyline.close();
+		return polyline;
+	}
+
+	std::vector<glm::vec3> randomPoints(size_t numPoints){
+		std::vector<glm::vec3> points(numPoints);
+		for(auto & p: points){
+			p = {ofRandom(-110, 110), ofRandom(-110, 110), 0};
+		}
+		return points;
+	}
+
+	void run(){
+		ofSeedRandom(7);
+
+		for(bool closed: {true, false}){
+			auto polyline = contour(5000);
+			polyline.setClosed(closed);
+			auto points = randomPoints(10000);
+			std::string name = closed ? " closed" : " open";
+
+			// inside
+			auto then = ofGetElapsedTimeMicros();
+			std::vector<bool> expected(points.size());
+			for(size_t i=0;i<points.size();i++){
+				expected[i] = ofPolyline::inside(points[i], polyline);
+			}
+			auto linearTime = ofGetElapsedTimeMicros() - then;
+
+			then = ofGetElapsedTimeMicros();
+			auto batched = polyline.inside(points);
+			auto batchedTime = ofGetElapsedTimeMicros() - then;
+			ofxTest(batched == expected, "batched inside same as linear" + name);
+
+			polyline.setUseAcceleration(true);
+			bool same = true;
+			for(size_t i=0;i<points.size();i++){
+				same &= polyline.inside(points[i]) == expected[i];
+			}
+			ofxTest(same, "accelerated inside same as linear" + name);
+			ofLogNotice() << "inside " << points.size() << " points, " << polyline.size() << " vertices, linear: "
+						  << linearTime / 1000. << "ms, batched: " << batchedTime / 1000. << "ms";
+
+			// closest point
+			polyline.setUseAcceleration(false);
+			std::vector<glm::vec3> expectedClosest(points.size());
+			std::vector<unsigned int> expectedIndices(points.size());
+			then = ofGetElapsedTimeMicros();
+			for(size_t i=0;i<points.size();i++){
+				expectedClosest[i] = polyline.getClosestPoint(points[i], &expectedIndices[i]);
+			}
+			linearTime = ofGetElapsedTimeMicros() - then;
+
+			std::vector<unsigned int> indices;
+			then = ofGetElapsedTimeMicros();
+			auto closest = polyline.getClosestPoints(points, &indices);
+			batchedTime = ofGetElapsedTimeMicros() - then;
+			ofxTest(closest == expectedClosest, "batched closest points same as linear" + name);
+			ofxTest(indices == expectedIndices, "batched nearest indices same as linear" + name);
+
+			polyline.setUseAcceleration(true);
+			same = true;
+			for(size_t i=0;i<points.size();i++){
+				unsigned int index;
+				same &= polyline.getClosestPoint(points[i], &index) == expectedClosest[i] && index == expectedIndices[i];
+			}
+			ofxTest(same, "accelerated closest point same as linear" + name);
+			ofLogNotice() << "closest point " << points.size() << " points, " << polyline.size() << " vertices, linear: "
+						  << linearTime / 1000. << "ms, batched: " << batchedTime / 1000. << "ms";
+		}
+
+		// changes rebuild the acceleration structure
+		{
+			auto polyline = contour(1000);
+			polyline.setUseAcceleration(true);
+			ofxTest(polyline.inside(0, 0), "center inside");
+			auto linear = polyline;
+			linear.setUseAcceleration(false);
+			ofxTestEq(polyline.getClosestPoint({0, 0, 0}), linear.getClosestPoint({0, 0, 0}), "closest point to the center");
+			for(auto & v: polyline.getVertices()){
+				v += glm::vec3(500, 0, 0);
+			}
+			polyline.flagHasChanged();
+			ofxTest(!polyline.inside(0, 0), "center outside after moving the vertices");
+			ofxTest(polyline.inside(500, 0), "new center inside after moving the vertices");
+			polyline.clear();
+			ofxTest(!polyline.inside(500, 0), "nothing inside an empty polyline");
+			ofxTestEq(polyline.getClosestPoint({1, 2, 3}), glm::vec3(1, 2, 3), "closest point in an empty polyline");
+		}
+
+		// lengths
+		{
+			auto polyline = contour(5000);
+			std::vector<float> lengths(20000), percents(20000);
+			for(size_t i=0;i<lengths.size();i++){
+				percents[i] = ofRandom(-0.1, 1.1);
+				lengths[i] = percents[i] * polyline.getPerimeter();
+			}
+
+			std::vector<float> expectedIndices(lengths.size());
+			std::vector<glm::vec3> expectedPoints(lengths.size());
+			auto then = ofGetElapsedTimeMicros();
+			for(size_t i=0;i<lengths.size();i++){
+				expectedIndices[i] = polyline.getIndexAtLength(lengths[i]);
+				expectedPoints[i] = polyline.getPointAtPercent(percents[i]);
+				// any change used to recalculate every vertex cache
+				polyline.flagHasChanged();
+			}
+			auto singleTime = ofGetElapsedTimeMicros() - then;
+
+			std::vector<float> indices(lengths.size());
+			std::vector<glm::vec3> points(lengths.size());
+			then = ofGetElapsedTimeMicros();
+			polyline.getIndicesAtLengths(lengths.data(), lengths.size(), indices.data());
+			polyline.getPointsAtPercents(percents.data(), percents.size(), points.data());
+			auto batchedTime = ofGetElapsedTimeMicros() - then;
+			ofxTest(indices == expectedIndices, "batched indices at lengths");
+			ofxTest(points == expectedPoints, "batched points at percents");
+
+			std::vector<glm::vec3> pointsAtLengths(lengths.size());
+			polyline.getPointsAtLengths(lengths.data(), lengths.size(), pointsAtLengths.data());
+			bool same = true;
+			for(size_t i=0;i<lengths.size();i++){
+				same &= pointsAtLengths[i] == polyline.getPointAtLength(lengths[i]);
+			}
+			ofxTest(same, "batched points at lengths");
+
+			ofxTestEq(polyline.getIndexAtLength(0), 0.f, "index at 0 length");
+			ofxTestEq(polyline.getIndexAtLength(polyline.getPerimeter()), float(polyline.size()), "index at the perimeter of a closed polyline");
+			ofxTestEq(polyline.getIndexAtLength(polyline.getLengthAtIndex(10)), 10.f, "index at the length of a vertex");
+			ofLogNotice() << "indices and points at " << lengths.size() << " lengths with changes: " << singleTime / 1000. << "ms, batched: " << batchedTime / 1000. << "ms";
+		}
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = make_shared<ofAppNoWindow>();
+	auto app = make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
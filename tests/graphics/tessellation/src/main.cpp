@@ -0,0 +1,138 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	// a star with a square hole, changes with t
+	void shape(ofPath & path, float t, int points = 5){
+		path.clear();
+		for(int i=0;i<points*2;i++){
+			float radius = i % 2 ? 40 : 100 + t;
+			float angle = i * PI / points;
+			if(i==0){
+				path.moveTo(cos(angle) * radius, sin(angle) * radius);
+			}else{
+				path.lineTo(cos(angle) * radius, sin(angle) * radius);
+			}
+		}
+		path.close();
+		path.rectangle(-10, -10, 20, 20);
+	}
+
+	bool sameMesh(const ofMesh & a, const ofMesh & b){
+		return a.getVertices() == b.getVertices() && a.getIndices() == b.getIndices();
+	}
+
+	void run(){
+		auto & cache = ofGetTessellationCache();
+		cache.clear();
+		cache.resetStats();
+
+		ofPath uncached;
+		shape(uncached, 0);
+		auto expected = uncached.getTessellation();
+		ofxTest(expected.getNumIndices() > 0, "path tessellated");
+
+		// tessellating many times reuses the tessellator memory
+		for(int i=0;i<100;i++){
+			uncached.setPolyWindingMode(i % 2 ? OF_POLY_WINDING_NONZERO : OF_POLY_WINDING_ODD);
+			uncached.getTessellation();
+		}
+		uncached.setPolyWindingMode(OF_POLY_WINDING_ODD);
+		ofxTest(sameMesh(expected, uncached.getTessellation()), "same tessellation after reusing the tessellator");
+
+		// same shape rebuilt every frame
+		ofPath cached;
+		cached.setUseTessellationCache(true);
+		for(int frame=0;frame<10;frame++){
+			shape(cached, 0);
+			ofxTest(sameMesh(expected, cached.getTessellation()), "cached tessellation frame " + ofToString(frame));
+		}
+		auto stats = cache.getStats();
+		ofxTestEq(stats.misses, uint64_t(1), "one miss for the same shape");
+		ofxTestEq(stats.hits, uint64_t(9), "hits for the same shape");
+
+		// a different shape or winding mode is a miss
+		shape(cached, 1);
+		cached.getTessellation();
+		cached.setPolyWindingMode(OF_POLY_WINDING_NONZERO);
+		cached.getTessellation();
+		ofxTestEq(cache.getStats().misses, uint64_t(3), "changes in the shape or winding mode are misses");
+
+		// outlines
+		uncached.setStrokeWidth(1);
+		uncached.setPolyWindingMode(OF_POLY_WINDING_NONZERO);
+		cached.setStrokeWidth(1);
+		shape(cached, 0);
+		for(int i=0;i<2;i++){
+			auto & outline = cached.getOutline();
+			auto & expectedOutline = uncached.getOutline();
+			ofxTestEq(outline.size(), expectedOutline.size(), "cached outline contours");
+			bool same = outline.size() == expectedOutline.size();
+			for(size_t j=0;same && j<outline.size();j++){
+				same = outline[j].getVertices() == expectedOutline[j].getVertices();
+			}
+			ofxTest(same, "cached outline vertices");
+			shape(cached, 0);
+		}
+
+		// the least recently used entries are dropped
+		cache.setMaxEntries(2);
+		ofxTestEq(cache.getStats().numEntries, size_t(2), "cache shrinks");
+		cache.setMaxEntries(4096);
+
+		// shapes big enough to need several arena blocks
+		{
+			ofPath big;
+			ofPath small;
+			for(int points: {5000, 5, 20000, 5}){
+				shape(big, 0, points);
+				ofxTestEq(big.getTessellation().getNumIndices(), size_t((points * 2 + 4) * 3), "big shape tessellated " + ofToString(points));
+				shape(small, 0);
+				ofxTest(sameMesh(expected, small.getTessellation()), "small shape after big one");
+			}
+		}
+
+		// batch
+		for(bool useCache: {false, true}){
+			size_t numPaths = 2000;
+			vector<ofPath> paths(numPaths);
+			for(size_t i=0;i<numPaths;i++){
+				paths[i].setUseTessellationCache(useCache);
+				shape(paths[i], i % 100, 20);
+			}
+			cache.resetStats();
+			auto then = ofGetElapsedTimeMicros();
+			ofTessellatePaths(paths);
+			auto batchTime = ofGetElapsedTimeMicros() - then;
+
+			bool same = true;
+			ofPath serial;
+			for(size_t i=0;i<numPaths;i++){
+				shape(serial, i % 100, 20);
+				same &= sameMesh(serial.getTessellation(), paths[i].getTessellation());
+			}
+			ofxTest(same, string("batch tessellation") + (useCache ? " with cache" : ""));
+			stats = cache.getStats();
+			if(useCache){
+				ofxTestEq(stats.hits + stats.misses, uint64_t(numPaths), "every path looked up");
+			}
+			ofLogNotice() << numPaths << " paths " << (useCache ? "with cache: " : ": ") << batchTime / 1000. << "ms, hits: "
+						  << stats.hits << ", misses: " << stats.misses << ", tessellating: " << stats.tessellationTime / 1000.
+						  << "ms, lookups: " << stats.lookupTime / 1000. << "ms";
+		}
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = make_shared<ofAppNoWindow>();
+	auto app = make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
@@ -10,6 +10,50 @@ class ofApp: public ofxUnitTestsApp{
 		ofxTest(img.load(ofToDataPath("indispensable.jpg", true)), "load from fs");
 		ofxTest(img.load("http://openframeworks.cc/about/0.jpg"), "load from http");
 		ofxTest(img.load("https://forum.openframeworks.cc/user_avatar/forum.openframeworks.cc/arturo/45/3965_1.png"), "load from https");
+
+		// save and load roundtrip, checks rows and channels end up in the right order
+		ofPixels pixels;
+		pixels.allocate(4, 3, OF_PIXELS_RGB);
+		for(size_t y = 0; y < pixels.getHeight(); y++){
+			for(size_t x = 0; x < pixels.getWidth(); x++){
+				pixels.setColor(x, y, ofColor(x * 60, y * 100, 200));
+			}
+		}
+		ofxTest(ofSaveImage(pixels, "roundtrip.png"), "save png");
+		ofPixels loaded;
+		ofxTest(ofLoadImage(loaded, "roundtrip.png"), "load png");
+		ofxTestEq(loaded.getPixelFormat(), OF_PIXELS_RGB, "loaded png format");
+		ofxTest(loaded.getWidth() == pixels.getWidth() && loaded.getHeight() == pixels.getHeight(), "loaded png size");
+		ofxTest(std::equal(pixels.begin(), pixels.end(), loaded.begin()), "loaded png pixels");
+
+		// batch loading, the same as loading each image on its own
+		ofImage full;
+		full.setUseTexture(false);
+		ofxTest(full.load("indispensable.jpg"), "load image to compare with");
+		const auto & fullPixels = full.getPixels();
+		std::vector<std::filesystem::path> paths(8, "indispensable.jpg");
+		paths.push_back("nonexistent.jpg");
+		std::vector<ofPixels> batch;
+		auto stats = ofLoadImages(paths, batch, 4);
+		ofxTestEq(batch.size(), paths.size(), "batch output size");
+		ofxTestEq(stats.size(), paths.size(), "batch stats size");
+		bool allEqual = true;
+		for(size_t i = 0; i < 8; i++){
+			allEqual &= stats[i].loaded;
+			allEqual &= batch[i].getWidth() == fullPixels.getWidth() && batch[i].getHeight() == fullPixels.getHeight();
+			allEqual &= batch[i].getPixelFormat() == fullPixels.getPixelFormat();
+			allEqual &= std::equal(batch[i].begin(), batch[i].end(), fullPixels.begin(), fullPixels.end());
+		}
+		ofxTest(allEqual, "batch loads every image like ofImage");
+		ofxTest(!stats.back().loaded, "batch reports failed images");
+
+		ofImageLoadSettings settings;
+		auto fullSize = std::max(full.getWidth(), full.getHeight());
+		settings.jpegTargetSize = fullSize / 4;
+		ofPixels scaled;
+		ofxTest(ofLoadImage(scaled, "indispensable.jpg", settings), "load scaled jpeg");
+		auto scaledSize = std::max(scaled.getWidth(), scaled.getHeight());
+		ofxTest(scaledSize < fullSize && scaledSize >= settings.jpegTargetSize, "scaled jpeg size");
 	}
 };
 
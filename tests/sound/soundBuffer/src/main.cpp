@@ -0,0 +1,272 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	ofSoundBuffer noise(size_t numFrames, size_t channels){
+		ofSoundBuffer buffer;
+		buffer.allocate(numFrames, channels);
+		for(auto & sample: buffer.getBuffer()){
+			sample = ofRandom(-1, 1);
+		}
+		return buffer;
+	}
+
+	ofSoundBuffer tone(size_t numFrames, size_t channels, float hz){
+		ofSoundBuffer buffer;
+		buffer.allocate(numFrames, channels);
+		buffer.setSampleRate(44100);
+		buffer.fillWithTone(hz);
+		return buffer;
+	}
+
+	// the loops ofSoundBuffer used before, to compare results and timings
+	void addToScalar(const ofSoundBuffer & in, float * out, size_t numFrames, size_t outChannels, size_t fromFrame){
+		size_t channels = in.getNumChannels();
+		for(size_t i = 0; i < numFrames; i++){
+			for(size_t j = 0; j < outChannels; j++){
+				out[i * outChannels + j] += in[(fromFrame + i) * channels + j % channels];
+			}
+		}
+	}
+
+	template<typename F>
+	double nsPerSample(size_t samples, F f){
+		size_t iterations = 0;
+		auto then = ofGetElapsedTimeMicros();
+		auto now = then;
+		do{
+			f();
+			iterations++;
+			now = ofGetElapsedTimeMicros();
+		}while(now - then < 20000);
+		return (now - then) * 1000. / double(iterations * samples);
+	}
+
+	void run(){
+		ofSeedRandom(3);
+		const size_t numFrames = 4099;
+
+		// mixing, every combination of channels
+		bool sameAdd = true, sameCopy = true, sameLoop = true;
+		for(size_t channels: {1, 2, 6}){
+			auto in = noise(numFrames, channels);
+			for(size_t outChannels: {1, 2, 6}){
+				auto out = noise(numFrames - 10, outChannels);
+				auto expected = out;
+				in.addTo(out, 5, false);
+				addToScalar(in, &expected[0], out.getNumFrames(), outChannels, 5);
+				sameAdd &= out.getBuffer() == expected.getBuffer();
+
+				in.copyTo(out, 15, false);
+				expected.set(0);
+				addToScalar(in, &expected[0], out.getNumFrames() - 5, outChannels, 15);
+				sameCopy &= out.getBuffer() == expected.getBuffer();
+
+				// looping wraps to the first frame
+				in.copyTo(out, numFrames - 3, true);
+				expected.set(0);
+				addToScalar(in, &expected[0], 3, outChannels, numFrames - 3);
+				addToScalar(in, &expected[3 * outChannels], out.getNumFrames() - 3, outChannels, 0);
+				sameLoop &= out.getBuffer() == expected.getBuffer();
+			}
+		}
+		ofxTest(sameAdd, "addTo same as scalar for every channel combination");
+		ofxTest(sameCopy, "copyTo same as scalar, zero padded at the end");
+		ofxTest(sameLoop, "copyTo loops to the start");
+
+		// gain
+		{
+			auto buffer = noise(numFrames, 2);
+			auto expected = buffer.getBuffer();
+			buffer.stereoPan(0.25, 0.75);
+			for(size_t i = 0; i < expected.size(); i++){
+				expected[i] *= i % 2 ? 0.75f : 0.25f;
+			}
+			ofxTest(buffer.getBuffer() == expected, "stereoPan");
+
+			buffer *= 3;
+			for(auto & sample: expected) sample *= 3;
+			ofxTest(buffer.getBuffer() == expected, "gain");
+
+			buffer.normalize(0.5);
+			float maxAmplitude = 0;
+			for(auto sample: buffer.getBuffer()) maxAmplitude = std::max(maxAmplitude, std::abs(sample));
+			ofxTest(std::abs(maxAmplitude - 0.5f) < 1e-6f, "normalize, max amplitude " + ofToString(maxAmplitude));
+
+			ofSoundBuffer silence;
+			silence.allocate(16, 1);
+			silence.normalize();
+			ofxTestEq(silence[0], 0.f, "normalizing silence keeps it silent");
+		}
+
+		// rms
+		{
+			auto buffer = noise(numFrames, 2);
+			double acc = 0, accRight = 0;
+			for(size_t i = 0; i < buffer.size(); i++){
+				acc += buffer[i] * buffer[i];
+				if(i % 2) accRight += buffer[i] * buffer[i];
+			}
+			ofxTest(std::abs(buffer.getRMSAmplitude() - sqrt(acc / buffer.size())) < 1e-6, "rms");
+			ofxTest(std::abs(buffer.getRMSAmplitudeChannel(1) - sqrt(accRight / buffer.getNumFrames())) < 1e-6, "rms of one channel");
+		}
+
+		// pcm
+		{
+			auto buffer = noise(numFrames, 1);
+			buffer[0] = 1.5;
+			buffer[1] = -1.5;
+			std::vector<short> pcm;
+			buffer.toShortPCM(pcm);
+			bool same = true;
+			for(size_t i = 2; i < buffer.size(); i++){
+				same &= pcm[i] == short(buffer[i] * 32767.f);
+			}
+			ofxTest(same, "toShortPCM");
+			ofxTestEq(pcm[0], short(32767), "toShortPCM saturates over 1");
+			ofxTestEq(pcm[1], short(-32768), "toShortPCM saturates under -1");
+
+			ofSoundBuffer fromShort;
+			fromShort.copyFrom(pcm, 1, 44100);
+			same = true;
+			for(size_t i = 0; i < pcm.size(); i++){
+				same &= fromShort[i] == pcm[i] / 32767.f;
+			}
+			ofxTest(same, "copyFrom short");
+		}
+
+		// resampling
+		for(size_t channels: {1, 2, 6}){
+			auto in = noise(numFrames, channels);
+			for(float speed: {0.37f, 1.f, 1.61f}){
+				size_t outFrames = 1000;
+				ofSoundBuffer out;
+				in.linearResampleTo(out, 3, outFrames, speed, false);
+				bool same = true;
+				double position = 3;
+				for(size_t i = 0; i < outFrames; i++, position += speed){
+					size_t index = position;
+					float remainder = position - index;
+					for(size_t j = 0; j < channels; j++){
+						same &= std::abs(out[i * channels + j] - ofLerp(in[index * channels + j], in[(index + 1) * channels + j], remainder)) < 1e-6;
+					}
+				}
+				ofxTest(same, "linear resampling " + ofToString(channels) + " channels speed " + ofToString(speed));
+
+				in.hermiteResampleTo(out, 3, outFrames, speed, false);
+				same = true;
+				position = 3;
+				for(size_t i = 0; i < outFrames; i++, position += speed){
+					size_t index = position;
+					float remainder = position - index;
+					for(size_t j = 0; j < channels; j++){
+						auto sample = [&](size_t frame){ return in[frame * channels + j]; };
+						same &= std::abs(out[i * channels + j] - ofInterpolateHermite(sample(index - 1), sample(index), sample(index + 1), sample(index + 2), remainder)) < 1e-6;
+					}
+				}
+				ofxTest(same, "hermite resampling " + ofToString(channels) + " channels speed " + ofToString(speed));
+			}
+
+			// past the end of the buffer
+			for(auto algorithm: {ofSoundBuffer::Linear, ofSoundBuffer::Hermite, ofSoundBuffer::Sinc}){
+				ofSoundBuffer out;
+				in.resampleTo(out, numFrames - 10, 100, 1.3, true, algorithm);
+				bool finite = out.size() == 100 * channels;
+				for(auto sample: out.getBuffer()){
+					finite &= std::abs(sample) < 4;
+				}
+				ofxTest(finite, "looping resampling " + ofToString(algorithm) + " with " + ofToString(channels) + " channels");
+			}
+		}
+
+		// tiny buffers
+		for(size_t frames: {1, 2, 3}){
+			auto in = noise(frames, 2);
+			for(auto algorithm: {ofSoundBuffer::Linear, ofSoundBuffer::Hermite, ofSoundBuffer::Sinc}){
+				for(bool loop: {false, true}){
+					ofSoundBuffer out;
+					in.resampleTo(out, 0, 20, 0.5, loop, algorithm);
+					ofxTestEq(out.size(), size_t(40), "resampling a " + ofToString(frames) + " frames buffer");
+				}
+			}
+		}
+
+		// windowed sinc
+		{
+			ofSoundBuffer in;
+			in.allocate(numFrames, 1);
+			double step = glm::two_pi<double>() * 1000 / 44100;
+			for(size_t i = 0; i < numFrames; i++){
+				in[i] = sin(i * step);
+			}
+			ofSoundBuffer out;
+			in.sincResampleTo(out, 0, 2000, 0.5, false);
+			float maxError = 0;
+			for(size_t i = 100; i < 2000; i++){
+				maxError = std::max(maxError, float(std::abs(out[i] - sin(i * 0.5 * step))));
+			}
+			ofxTest(maxError < 0.001, "sinc resampling of a tone, max error " + ofToString(maxError));
+
+			// a tone above the new nyquist is filtered out instead of aliasing
+			auto high = tone(numFrames, 1, 15000);
+			high.sincResampleTo(out, 0, 1500, 2, false);
+			ofSoundBuffer middle;
+			out.copyTo(middle, 1000, 1, 250);
+			ofxTest(middle.getRMSAmplitude() < 0.01, "sinc resampling filters aliasing, rms " + ofToString(middle.getRMSAmplitude()));
+			high.linearResampleTo(out, 0, 1500, 2, false);
+			out.copyTo(middle, 1000, 1, 250);
+			ofxTest(middle.getRMSAmplitude() > 0.1, "linear resampling aliases, rms " + ofToString(middle.getRMSAmplitude()));
+
+			// changing the speed every buffer, like a vibrato, gives the
+			// same result as resampling at each speed alone
+			ofSoundBuffer first, again;
+			in.sincResampleTo(first, 0, 256, 1.5, false);
+			for(float speed: {1.2f, 1.21f, 1.8f, 2.5f, 3.f, 3.5f, 1.5f}){
+				in.sincResampleTo(again, 0, 256, speed, false);
+			}
+			ofxTest(first.getBuffer() == again.getBuffer(), "sinc resampling with a changing speed");
+		}
+
+		// ns per sample of every kernel with a typical callback buffer size
+		const size_t bufferSize = 256;
+		for(size_t channels: {1, 2, 6}){
+			auto in = noise(bufferSize * 8, channels);
+			ofSoundBuffer out;
+			out.allocate(bufferSize, 2);
+			std::vector<short> pcm(in.size());
+			auto samples = bufferSize * 2;
+			ofLogNotice() << channels << " channels into stereo, ns per output sample:";
+			ofLogNotice() << "    addTo: " << nsPerSample(samples, [&]{ in.addTo(out, 100, true); })
+						  << ", scalar: " << nsPerSample(samples, [&]{ addToScalar(in, &out[0], bufferSize, 2, 100); });
+			ofLogNotice() << "    copyTo: " << nsPerSample(samples, [&]{ in.copyTo(out, 100, true); });
+			ofLogNotice() << "    gain: " << nsPerSample(in.size(), [&]{ in *= 1.f; })
+						  << ", normalize: " << nsPerSample(in.size(), [&]{ in.normalize(1); })
+						  << ", rms: " << nsPerSample(in.size(), [&]{ in.getRMSAmplitude(); })
+						  << ", toShortPCM: " << nsPerSample(in.size(), [&]{ in.toShortPCM(pcm.data()); });
+			if(channels == 2){
+				ofLogNotice() << "    stereoPan: " << nsPerSample(in.size(), [&]{ in.stereoPan(1, 1); });
+			}
+			ofSoundBuffer resampled;
+			for(auto algorithm: {ofSoundBuffer::Linear, ofSoundBuffer::Hermite, ofSoundBuffer::Sinc}){
+				for(float speed: {0.75f, 1.5f}){
+					ofLogNotice() << "    resample " << (algorithm == ofSoundBuffer::Linear ? "linear" : algorithm == ofSoundBuffer::Hermite ? "hermite" : "sinc")
+								  << " speed " << speed << ": " << nsPerSample(bufferSize * channels, [&]{ in.resampleTo(resampled, 10, bufferSize, speed, false, algorithm); });
+				}
+			}
+		}
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = make_shared<ofAppNoWindow>();
+	auto app = make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
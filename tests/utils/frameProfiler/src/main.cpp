@@ -0,0 +1,284 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+	void sleepMillis(int millis){
+		std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+	}
+
+	void testHistogram(){
+		ofDurationHistogram histogram;
+		ofxTestEq(histogram.getPercentile(0.5), uint64_t(0), "empty histogram percentile");
+
+		// 1 to 1000 microseconds
+		for(uint64_t i = 1; i <= 1000; i++){
+			histogram.add(i * 1000);
+		}
+		ofxTestEq(histogram.getCount(), uint64_t(1000), "histogram count");
+		ofxTestEq(histogram.getMin(), uint64_t(1000), "histogram min");
+		ofxTestEq(histogram.getMax(), uint64_t(1000000), "histogram max");
+		ofxTestEq(histogram.getMean(), 500500., "histogram mean");
+		auto near = [](uint64_t value, double expected){
+			return std::abs(double(value) - expected) <= expected * 0.07;
+		};
+		ofxTest(near(histogram.getPercentile(0.5), 500000), "p50 " + ofToString(histogram.getPercentile(0.5)));
+		ofxTest(near(histogram.getPercentile(0.95), 950000), "p95 " + ofToString(histogram.getPercentile(0.95)));
+		ofxTest(near(histogram.getPercentile(0.99), 990000), "p99 " + ofToString(histogram.getPercentile(0.99)));
+		ofxTestEq(histogram.getPercentile(1), uint64_t(1000000), "p100 is the max");
+		ofxTestEq(histogram.getPercentile(0), uint64_t(1000), "p0 is the min");
+
+		// a few slow frames show in the high percentiles only
+		histogram.clear();
+		for(int i = 0; i < 990; i++){
+			histogram.add(16000000);
+		}
+		for(int i = 0; i < 10; i++){
+			histogram.add(100000000);
+		}
+		ofxTest(near(histogram.getPercentile(0.5), 16000000), "p50 with drops");
+		ofxTest(near(histogram.getPercentile(0.99), 16000000), "p99 with 1% drops");
+		ofxTest(near(histogram.getPercentile(0.995), 100000000), "p99.5 with 1% drops");
+
+		// small values are exact
+		histogram.clear();
+		for(uint64_t i = 0; i < 16; i++){
+			histogram.add(i);
+		}
+		ofxTestEq(histogram.getPercentile(0.5), uint64_t(7), "small values p50");
+	}
+
+	void testPhases(){
+		ofFrameProfiler profiler;
+		for(int frame = 0; frame < 5; frame++){
+			profiler.newFrame();
+			profiler.beginPhase(OF_FRAME_PHASE_UPDATE);
+			sleepMillis(2);
+			profiler.endPhase(OF_FRAME_PHASE_UPDATE);
+			profiler.beginPhase(OF_FRAME_PHASE_DRAW);
+			sleepMillis(4);
+			profiler.endPhase(OF_FRAME_PHASE_DRAW);
+		}
+		profiler.newFrame();
+		ofxTestEq(profiler.getNumFrames(), uint64_t(5), "frames counted from the second newFrame");
+		ofxTestEq(profiler.getLastFrame().number, uint64_t(4), "last frame number");
+		auto & frame = profiler.getLastFrame();
+		ofxTest(frame.phases[OF_FRAME_PHASE_UPDATE] >= 2000000, "update phase duration");
+		ofxTest(frame.phases[OF_FRAME_PHASE_DRAW] >= 4000000, "draw phase duration");
+		ofxTest(frame.duration >= frame.phases[OF_FRAME_PHASE_UPDATE] + frame.phases[OF_FRAME_PHASE_DRAW], "frame includes its phases");
+		ofxTestEq(profiler.getPhaseHistogram(OF_FRAME_PHASE_DRAW).getCount(), uint64_t(5), "draw histogram count");
+		ofxTestEq(profiler.getPhaseHistogram(OF_FRAME_PHASE_SWAP).getCount(), uint64_t(0), "phases that didn't run aren't counted");
+		ofxTest(profiler.getFrameHistogram().getPercentile(0.5) >= 6000000 * 0.9, "frame p50");
+
+		// phases running more than once per frame add up
+		profiler.beginPhase(OF_FRAME_PHASE_EVENTS);
+		sleepMillis(1);
+		profiler.endPhase(OF_FRAME_PHASE_EVENTS);
+		profiler.beginPhase(OF_FRAME_PHASE_EVENTS);
+		sleepMillis(1);
+		profiler.endPhase(OF_FRAME_PHASE_EVENTS);
+		profiler.newFrame();
+		ofxTest(profiler.getLastFrame().phases[OF_FRAME_PHASE_EVENTS] >= 2000000, "repeated phases add up");
+
+		profiler.setEnabled(false);
+		profiler.newFrame();
+		ofxTestEq(profiler.getNumFrames(), uint64_t(6), "disabled profiler doesn't count frames");
+		profiler.setEnabled(true);
+
+		profiler.clear();
+		ofxTestEq(profiler.getNumFrames(), uint64_t(0), "clear frames");
+		ofxTestEq(profiler.getFrameHistogram().getCount(), uint64_t(0), "clear histograms");
+	}
+
+	void testZones(){
+		auto & profiler = ofGetFrameProfiler();
+		profiler.clear();
+		profiler.newFrame();
+		{
+			OF_PROFILE_ZONE("main zone");
+			sleepMillis(1);
+		}
+
+		size_t numThreads = 4;
+		size_t zonesPerThread = 1000;
+		std::vector<std::thread> threads;
+		for(size_t i = 0; i < numThreads; i++){
+			threads.emplace_back([&, i]{
+				ofGetFrameProfiler().setThreadName("worker " + ofToString(i));
+				for(size_t j = 0; j < zonesPerThread; j++){
+					OF_PROFILE_ZONE("worker zone");
+				}
+			});
+		}
+		for(auto & thread: threads){
+			thread.join();
+		}
+		profiler.newFrame();
+
+		auto & zones = profiler.getZoneHistograms();
+		ofxTestEq(zones.size(), size_t(2), "a histogram per zone name");
+		ofxTestEq(zones.at("main zone").getCount(), uint64_t(1), "main thread zone collected");
+		ofxTest(zones.at("main zone").getMin() >= 1000000, "zone duration");
+		ofxTestEq(zones.at("worker zone").getCount(), uint64_t(numThreads * zonesPerThread), "zones from every thread collected");
+		ofxTestEq(profiler.getNumDroppedZones(), uint64_t(0), "no zones dropped");
+
+		// more zones than fit in the buffer of a thread in one frame
+		std::thread([]{
+			for(int i = 0; i < 5000; i++){
+				OF_PROFILE_ZONE("burst");
+			}
+		}).join();
+		profiler.newFrame();
+		ofxTestEq(profiler.getZoneHistograms().at("burst").getCount() + profiler.getNumDroppedZones(), uint64_t(5000), "zones collected or dropped");
+		ofxTest(profiler.getNumDroppedZones() > 0, "full buffers drop zones");
+
+		// the buffer is reused once collected
+		for(int frame = 0; frame < 3; frame++){
+			for(int i = 0; i < 3000; i++){
+				OF_PROFILE_ZONE("frames");
+			}
+			profiler.newFrame();
+		}
+		ofxTestEq(profiler.getZoneHistograms().at("frames").getCount(), uint64_t(9000), "buffers emptied every frame");
+
+		// zones collected while the thread keeps measuring
+		std::atomic<bool> done{false};
+		uint64_t measured = 0;
+		std::thread worker([&]{
+			for(int i = 0; i < 200000; i++){
+				OF_PROFILE_ZONE("concurrent");
+				measured++;
+			}
+			done = true;
+		});
+		auto dropped = profiler.getNumDroppedZones();
+		while(!done){
+			profiler.newFrame();
+		}
+		worker.join();
+		profiler.newFrame();
+		ofxTestEq(profiler.getZoneHistograms().at("concurrent").getCount() + profiler.getNumDroppedZones() - dropped, measured, "zones collected while measuring");
+	}
+
+	void testTrace(){
+		ofFrameProfiler profiler;
+		profiler.setTraceCapacity(8);
+		for(int frame = 0; frame < 10; frame++){
+			profiler.newFrame();
+			profiler.beginPhase(OF_FRAME_PHASE_UPDATE);
+			profiler.endPhase(OF_FRAME_PHASE_UPDATE);
+		}
+		profiler.setThreadName("main \"thread\"");
+		auto start = ofFrameProfiler::now();
+		profiler.addZone("zone", start, start + 1500);
+		profiler.newFrame();
+
+		ofJson json;
+		bool parsed = true;
+		try{
+			json = ofJson::parse(profiler.getTrace());
+		}catch(...){
+			parsed = false;
+		}
+		ofxTest(parsed, "trace is valid json");
+		if(!parsed) return;
+
+		auto & events = json["traceEvents"];
+		size_t complete = 0;
+		size_t metadata = 0;
+		std::string lastName;
+		for(auto & event: events){
+			if(event["ph"] == "X"){
+				complete++;
+				lastName = event["name"];
+			}else if(event["ph"] == "M"){
+				metadata++;
+			}
+		}
+		ofxTestEq(complete, size_t(8), "trace keeps the last events");
+		ofxTestEq(metadata, size_t(2), "thread names in the trace");
+		ofxTestEq(lastName, std::string("zone"), "oldest events are overwritten first");
+		bool zoneFound = false;
+		for(auto & event: events){
+			if(event["name"] == "zone"){
+				zoneFound = true;
+				ofxTestEq(double(event["dur"]), 1.5, "zone duration in microseconds");
+				ofxTestEq(int(event["tid"]), 1, "zone in its thread track");
+			}
+		}
+		ofxTest(zoneFound, "zones in the trace");
+
+		// names only have to live until they are collected
+		{
+			auto name = std::make_unique<std::string>("temporary");
+			start = ofFrameProfiler::now();
+			profiler.addZone(name->c_str(), start, start + 1000);
+			profiler.newFrame();
+		}
+		auto temporary = std::make_unique<std::string>("overwrite");
+		profiler.addZone(temporary->c_str(), start, start + 1000);
+		profiler.newFrame();
+		json = ofJson::parse(profiler.getTrace());
+		size_t named = 0;
+		for(auto & event: json["traceEvents"]){
+			named += event["name"] == "temporary" || event["name"] == "overwrite";
+		}
+		ofxTestEq(named, size_t(2), "zone names copied for the trace");
+		ofxTestEq(profiler.getZoneHistograms().count("overwrite"), size_t(1), "zones named with a freed pointer");
+
+		auto path = ofToDataPath("trace.json");
+		ofxTest(profiler.saveTrace(path), "save trace");
+		ofxTest(ofFile(path).getSize() > 0, "trace saved");
+		ofFile::removeFile(path);
+	}
+
+	void benchmarkZones(){
+		auto & profiler = ofGetFrameProfiler();
+		profiler.clear();
+		profiler.newFrame();
+		size_t count = 4000;
+		size_t frames = 100;
+		auto then = ofFrameProfiler::now();
+		for(size_t frame = 0; frame < frames; frame++){
+			for(size_t i = 0; i < count; i++){
+				OF_PROFILE_ZONE("benchmark");
+			}
+			profiler.newFrame();
+		}
+		auto time = ofFrameProfiler::now() - then;
+		ofxTestEq(profiler.getZoneHistograms().at("benchmark").getCount(), uint64_t(count * frames), "benchmark zones collected");
+		ofLogNotice() << "zone measured and collected in " << double(time) / (count * frames) << "ns";
+
+		profiler.setEnabled(false);
+		then = ofFrameProfiler::now();
+		for(size_t i = 0; i < count * frames; i++){
+			OF_PROFILE_ZONE("disabled");
+		}
+		time = ofFrameProfiler::now() - then;
+		profiler.setEnabled(true);
+		ofxTest(profiler.getZoneHistograms().count("disabled") == 0, "disabled profiler doesn't measure zones");
+		ofLogNotice() << "zone with the profiler disabled " << double(time) / (count * frames) << "ns";
+		ofLogNotice() << profiler.getSummary();
+	}
+
+	void run(){
+		testHistogram();
+		testPhases();
+		testZones();
+		testTrace();
+		benchmarkZones();
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = make_shared<ofAppNoWindow>();
+	auto app = make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
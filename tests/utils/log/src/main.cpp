@@ -0,0 +1,159 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+// counts how many times it's formatted
+struct FormatCounter{
+	int & count;
+};
+
+std::ostream & operator<<(std::ostream & os, const FormatCounter & counter){
+	counter.count++;
+	return os << "counter";
+}
+
+class ofApp: public ofxUnitTestsApp{
+	void testFiltered(){
+		int formatted = 0;
+		ofSetLogLevel(OF_LOG_NOTICE);
+		ofLogVerbose() << FormatCounter{formatted};
+		ofLogVerbose("module") << FormatCounter{formatted} << std::endl;
+		ofxTestEq(formatted, 0, "filtered messages aren't formatted");
+
+		ofSetLogLevel("verboseModule", OF_LOG_VERBOSE);
+		ofLogVerbose("verboseModule") << FormatCounter{formatted};
+		ofxTestEq(formatted, 1, "module levels are respected");
+		ofSetLogLevel("verboseModule", OF_LOG_NOTICE);
+	}
+
+	void testJsonFile(){
+		auto path = ofToDataPath("log.jsonl", true);
+		const int numThreads = 4;
+		const int numMessages = 1000;
+		{
+			auto logger = std::make_shared<ofAsyncLoggerChannel>(path, false);
+			logger->setFormat(ofAsyncLoggerChannel::JsonLines);
+			auto previous = ofGetLoggerChannel();
+			ofSetLoggerChannel(logger);
+			std::vector<std::thread> threads;
+			for(int t = 0; t < numThreads; t++){
+				threads.emplace_back([t]{
+					for(int i = 0; i < numMessages; i++){
+						ofLogNotice("thread" + ofToString(t)) << "message " << i;
+					}
+				});
+			}
+			for(auto & thread: threads){
+				thread.join();
+			}
+			ofLogError("json") << "quote \" backslash \\ newline \n tab \t";
+			logger->flush();
+			ofxTestEq(logger->getNumWritten() + logger->getNumDropped(), uint64_t(numThreads * numMessages + 1), "every message written or dropped");
+			ofxTestEq(logger->getNumDropped(), uint64_t(0), "no messages dropped");
+			ofSetLoggerChannel(previous);
+		}
+
+		auto lines = ofSplitString(ofBufferFromFile(path).getText(), "\n", true);
+		ofxTestEq(lines.size(), size_t(numThreads * numMessages + 1), "one line per message");
+		bool allValid = true;
+		std::vector<int> next(numThreads, 0);
+		for(auto & line: lines){
+			try{
+				auto json = ofJson::parse(line);
+				auto module = json["module"].get<std::string>();
+				if(module == "json"){
+					allValid &= json["level"] == "error";
+					allValid &= json["message"] == "quote \" backslash \\ newline \n tab \t";
+				}else{
+					// messages from the same thread keep their order
+					int t = ofToInt(module.substr(6));
+					allValid &= json["message"] == "message " + ofToString(next[t]++);
+					allValid &= json["level"] == "notice";
+				}
+			}catch(...){
+				allValid = false;
+			}
+		}
+		ofxTest(allValid, "valid json lines in order");
+		ofFile::removeFile(path);
+	}
+
+	// a channel that takes a long time to write
+	class SlowChannel: public ofBaseLoggerChannel{
+	public:
+		void log(ofLogLevel level, const std::string & module, const std::string & message){
+			ofSleepMillis(1);
+			count++;
+		}
+		void log(ofLogLevel level, const std::string & module, const char* format, ...){
+			log(level, module, std::string(format));
+		}
+		void log(ofLogLevel level, const std::string & module, const char* format, va_list args){
+			log(level, module, std::string(format));
+		}
+		std::atomic<int> count{0};
+	};
+
+	void testOverflow(){
+		auto slow = std::make_shared<SlowChannel>();
+		const int numMessages = 200;
+		uint64_t syncTime, asyncTime;
+		{
+			auto then = ofGetElapsedTimeMicros();
+			for(int i = 0; i < numMessages; i++){
+				slow->log(OF_LOG_NOTICE, "", "message");
+			}
+			syncTime = ofGetElapsedTimeMicros() - then;
+		}
+		slow->count = 0;
+		{
+			ofAsyncLoggerChannel logger(slow, 16);
+			auto then = ofGetElapsedTimeMicros();
+			for(int i = 0; i < numMessages; i++){
+				logger.log(OF_LOG_NOTICE, "", "message");
+			}
+			asyncTime = ofGetElapsedTimeMicros() - then;
+			logger.flush();
+			ofxTest(logger.getNumDropped() > 0, "full buffer drops messages");
+			ofxTestEq(logger.getNumWritten() + logger.getNumDropped(), uint64_t(numMessages), "dropped messages are counted");
+			ofxTestEq(uint64_t(slow->count), logger.getNumWritten(), "forwarded to the wrapped channel");
+		}
+		ofxTest(asyncTime < syncTime, "logging doesn't wait for the channel");
+		ofLogNotice() << numMessages << " messages to a 1ms channel, sync: " << syncTime << "us, async: " << asyncTime << "us";
+	}
+
+	void testDestructor(){
+		auto slow = std::make_shared<SlowChannel>();
+		const int numMessages = 50;
+		{
+			ofAsyncLoggerChannel logger(slow, 64);
+			std::thread thread([&]{
+				for(int i = 0; i < numMessages; i++){
+					logger.log(OF_LOG_NOTICE, "", "message");
+				}
+			});
+			thread.join();
+		}
+		ofxTestEq(slow->count.load(), numMessages, "destructor writes every queued message");
+	}
+
+	void run(){
+		testFiltered();
+		testJsonFile();
+		testOverflow();
+		testDestructor();
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = make_shared<ofAppNoWindow>();
+	auto app = make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
@@ -0,0 +1,175 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+// set from main thread functions queued before ofRunApp
+static int resultBeforeRunApp = 0;
+static bool mainThreadBeforeRunApp = false;
+
+class ofApp: public ofxUnitTestsApp{
+	void testSubmit(ofTaskPool & pool){
+		auto result = pool.submit([]{ return 42; });
+		ofxTestEq(result.get(), 42, "submit returns the task result");
+
+		auto failed = pool.submit([]() -> int{ throw std::runtime_error("task error"); });
+		bool thrown = false;
+		try{
+			failed.get();
+		}catch(const std::runtime_error &){
+			thrown = true;
+		}
+		ofxTest(thrown, "submit forwards exceptions through the future");
+
+		// tasks submitted from inside other tasks go to the worker's own queue
+		vector<std::future<int>> results;
+		for(int i = 0; i < 100; i++){
+			results.push_back(pool.submit([&pool, i]{
+				auto inner = pool.submit([i]{ return i; });
+				pool.wait(inner);
+				return inner.get() * 2;
+			}));
+		}
+		int total = 0;
+		for(auto & result: results){
+			total += result.get();
+		}
+		ofxTestEq(total, 9900, "nested submit and wait");
+	}
+
+	void testParallelFor(ofTaskPool & pool){
+		bool allOnce = true;
+		for(size_t count: {0, 1, 7, 1000, 100003}){
+			for(size_t grain: {0, 1, 3, 64}){
+				vector<std::atomic<int>> visited(count);
+				pool.parallelFor(0, count, [&](size_t i){
+					visited[i]++;
+				}, grain);
+				allOnce &= std::all_of(visited.begin(), visited.end(), [](const std::atomic<int> & v){ return v == 1; });
+			}
+		}
+		ofxTest(allOnce, "parallelFor visits every index once");
+
+		std::atomic<size_t> chunks{0};
+		pool.parallelForRange(10, 110, [&](size_t begin, size_t end){
+			chunks++;
+		}, 25);
+		ofxTestEq(chunks.load(), size_t(4), "parallelForRange respects the grain");
+
+		std::atomic<size_t> nested{0};
+		pool.parallelFor(0, 64, [&](size_t){
+			pool.parallelFor(0, 64, [&](size_t){
+				nested++;
+			});
+		});
+		ofxTestEq(nested.load(), size_t(64 * 64), "nested parallelFor");
+
+		bool thrown = false;
+		try{
+			pool.parallelFor(0, 100, [](size_t i){
+				if(i == 50) throw std::runtime_error("parallelFor error");
+			});
+		}catch(const std::runtime_error &){
+			thrown = true;
+		}
+		ofxTest(thrown, "parallelFor rethrows exceptions in the calling thread");
+	}
+
+	void testContinuations(ofTaskPool & pool){
+		int result = 0;
+		bool mainThread = false;
+		auto mainThreadId = std::this_thread::get_id();
+		pool.submit([]{ return 5; }, [&](int value){
+			result = value;
+			mainThread = std::this_thread::get_id() == mainThreadId;
+		});
+		pool.submit([]{}, [&]{
+			result += 1;
+		});
+		ofSleepMillis(100);
+		ofxTestEq(result, 0, "continuations wait for the update event");
+		ofEvents().notifyUpdate();
+		ofxTestEq(result, 6, "continuations run on update");
+		ofxTest(mainThread, "continuations run in the main thread");
+	}
+
+	// the shared pool used before there's a window, like ofPixels::resize
+	// in a global's constructor, still runs main thread functions
+	void testBeforeRunApp(){
+		auto then = ofGetElapsedTimeMillis();
+		do{
+			ofEvents().notifyUpdate();
+		}while(resultBeforeRunApp < 6 && ofGetElapsedTimeMillis() - then < 1000);
+		ofxTestEq(resultBeforeRunApp, 6, "continuations submitted before ofRunApp run on update");
+		ofxTest(mainThreadBeforeRunApp, "ofRunOnMainThread before ofRunApp runs on update");
+	}
+
+	void benchmark(){
+		const size_t numTasks = 200000;
+		for(size_t numThreads: {size_t(1), size_t(std::thread::hardware_concurrency())}){
+			ofTaskPool pool(numThreads);
+			std::atomic<size_t> counter{0};
+			auto then = ofGetElapsedTimeMicros();
+			vector<std::future<void>> futures;
+			futures.reserve(numTasks);
+			for(size_t i = 0; i < numTasks; i++){
+				futures.push_back(pool.submit([&]{ counter++; }));
+			}
+			for(auto & future: futures){
+				future.get();
+			}
+			auto elapsed = ofGetElapsedTimeMicros() - then;
+			ofLogNotice() << numThreads << " workers: " << elapsed * 1000. / numTasks << "ns per submitted task";
+
+			vector<float> values(1 << 22);
+			then = ofGetElapsedTimeMicros();
+			pool.parallelFor(0, values.size(), [&](size_t i){
+				values[i] = sqrt(float(i));
+			});
+			elapsed = ofGetElapsedTimeMicros() - then;
+			ofLogNotice() << numThreads << " workers: parallelFor over " << values.size() << " values in " << elapsed / 1000. << "ms";
+		}
+	}
+
+	void run(){
+		ofTaskPool pool(4);
+		testSubmit(pool);
+		testParallelFor(pool);
+		testContinuations(pool);
+		testBeforeRunApp();
+
+		std::atomic<int> counter{0};
+		{
+			ofTaskPool pool(2);
+			for(int i = 0; i < 1000; i++){
+				pool.submit([&]{ counter++; });
+			}
+		}
+		ofxTestEq(counter.load(), 1000, "destructor runs every queued task");
+
+		benchmark();
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	// the shared pool is used for the first time before there's a window
+	auto mainThreadId = std::this_thread::get_id();
+	ofGetTaskPool().submit([]{ return 5; }, [](int value){
+		resultBeforeRunApp += value;
+	});
+	ofGetTaskPool().submit([]{}, []{
+		resultBeforeRunApp += 1;
+	});
+	ofRunOnMainThread([mainThreadId]{
+		mainThreadBeforeRunApp = std::this_thread::get_id() == mainThreadId;
+	});
+	auto window = make_shared<ofAppNoWindow>();
+	auto app = make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
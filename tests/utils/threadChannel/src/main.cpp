@@ -0,0 +1,138 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+
+class ofApp: public ofxUnitTestsApp{
+
+	template<typename Channel>
+	void benchmark(const string & name, Channel & channel, size_t numProducers, size_t numMessages){
+		// every message carries the time it was sent to measure latency
+		vector<std::thread> producers;
+		auto then = ofGetElapsedTimeMicros();
+		for(size_t p=0;p<numProducers;p++){
+			producers.emplace_back([&]{
+				for(size_t i=0;i<numMessages;i++){
+					channel.send(ofGetElapsedTimeMicros());
+				}
+			});
+		}
+
+		uint64_t sent;
+		uint64_t totalLatency = 0;
+		uint64_t maxLatency = 0;
+		size_t received = 0;
+		for(;received<numMessages*numProducers;received++){
+			if(!channel.receive(sent)){
+				break;
+			}
+			auto latency = ofGetElapsedTimeMicros() - sent;
+			totalLatency += latency;
+			maxLatency = std::max(maxLatency, latency);
+		}
+		auto elapsed = ofGetElapsedTimeMicros() - then;
+		for(auto & producer: producers){
+			producer.join();
+		}
+
+		ofxTestEq(received, numMessages*numProducers, name + " receives every message");
+		ofLogNotice() << name << ", " << numProducers << " producers: "
+					  << elapsed * 1000. / received << "ns per message, latency avg "
+					  << totalLatency / double(received) << "us max " << maxLatency << "us";
+	}
+
+	void run(){
+		{
+			ofBoundedThreadChannel<int> channel(3, OF_THREAD_CHANNEL_REJECT);
+			ofxTestEq(channel.capacity(), size_t(4), "capacity is rounded to a power of two");
+			for(int i=0;i<4;i++){
+				channel.send(i);
+			}
+			ofxTest(!channel.send(4), "reject policy fails to send to a full channel");
+			ofxTestEq(channel.getNumRejected(), uint64_t(1), "reject policy counts rejected sends");
+			vector<int> received;
+			ofxTestEq(channel.receiveAll(received), size_t(4), "receiveAll receives every sent value");
+			ofxTestEq(received.front(), 0, "receiveAll keeps the order of sent values");
+			ofxTestEq(received.back(), 3, "receiveAll keeps the order of sent values");
+			ofxTest(channel.empty(), "channel is empty after receiveAll");
+		}
+
+		{
+			ofBoundedThreadChannel<int> channel(4, OF_THREAD_CHANNEL_DROP_OLDEST);
+			for(int i=0;i<10;i++){
+				channel.send(i);
+			}
+			ofxTestEq(channel.getNumDropped(), uint64_t(6), "drop oldest policy counts dropped values");
+			int value;
+			channel.receive(value);
+			ofxTestEq(value, 6, "drop oldest policy keeps the most recent values");
+		}
+
+		{
+			ofBoundedThreadChannel<int> channel(2);
+			channel.send(1);
+			channel.send(2);
+			std::thread receiver([&]{
+				ofSleepMillis(50);
+				int value;
+				channel.receive(value);
+			});
+			auto then = ofGetElapsedTimeMillis();
+			ofxTest(channel.send(3), "block policy sends once there's space");
+			ofxTestGt(ofGetElapsedTimeMillis() - then, uint64_t(25), "block policy waits for the receiver");
+			receiver.join();
+		}
+
+		{
+			ofBoundedThreadChannel<string> channel(8);
+			string value;
+			ofxTest(!channel.tryReceive(value, 10), "tryReceive with timeout on an empty channel");
+			std::thread closer([&]{
+				ofSleepMillis(50);
+				channel.close();
+			});
+			ofxTest(!channel.receive(value), "close wakes up a waiting receiver");
+			ofxTest(!channel.send("closed"), "send fails on a closed channel");
+			closer.join();
+		}
+
+		{
+			ofThreadChannel<int> channel;
+			for(int i=0;i<10;i++){
+				channel.send(i);
+			}
+			vector<int> received;
+			ofxTestEq(channel.receiveAll(received), size_t(10), "ofThreadChannel::receiveAll receives every sent value");
+		}
+
+		const size_t numMessages = 100000;
+		{
+			ofThreadChannel<uint64_t> channel;
+			benchmark("ofThreadChannel", channel, 1, numMessages);
+		}
+		{
+			ofBoundedThreadChannel<uint64_t> channel(1024);
+			benchmark("ofBoundedThreadChannel single producer", channel, 1, numMessages);
+		}
+		{
+			ofThreadChannel<uint64_t> channel;
+			benchmark("ofThreadChannel", channel, 4, numMessages);
+		}
+		{
+			ofBoundedThreadChannel<uint64_t> channel(1024, OF_THREAD_CHANNEL_BLOCK, OF_THREAD_CHANNEL_MULTI_PRODUCER);
+			benchmark("ofBoundedThreadChannel multi producer", channel, 4, numMessages);
+		}
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = make_shared<ofAppNoWindow>();
+	auto app = make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}
@@ -0,0 +1,246 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofxUnitTests.h"
+#include "ofxNetwork.h"
+
+// minimal HTTP/1.1 server on loopback, answers every GET with the path
+// repeated 100 times after an artificial delay, keeping connections alive.
+// sends the path as ETag and answers 304 when the client already has it
+class LoopbackServer: public ofThread{
+public:
+	bool setup(int port, uint64_t delayMillis){
+		this->delayMillis = delayMillis;
+		if(!server.setup(port, false)){
+			return false;
+		}
+		startThread();
+		return true;
+	}
+
+	~LoopbackServer(){
+		close();
+	}
+
+	void close(){
+		waitForThread(true);
+		server.close();
+	}
+
+	// number of connections accepted so far
+	int getNumConnections(){
+		return server.getLastID();
+	}
+
+	void setDelay(uint64_t delayMillis){
+		this->delayMillis = delayMillis;
+	}
+
+private:
+	struct Response{
+		int client;
+		std::string etag;
+		bool notModified;
+		std::string body;
+		uint64_t due;
+	};
+
+	void threadedFunction(){
+		while(isThreadRunning()){
+			for(int client = 0; client < server.getLastID(); client++){
+				if(!server.isClientConnected(client)){
+					continue;
+				}
+				char buffer[4096];
+				int received = server.receiveRawBytes(client, buffer, sizeof(buffer));
+				if(received > 0){
+					incoming[client].append(buffer, received);
+				}
+				auto & request = incoming[client];
+				auto end = request.find("\r\n\r\n");
+				if(end != std::string::npos){
+					auto path = request.substr(4, request.find(' ', 4) - 4);
+					auto etag = "\"" + path + "\"";
+					bool notModified = ofIsStringInString(request.substr(0, end), "If-None-Match: " + etag);
+					std::string body;
+					for(int i = 0; !notModified && i < 100; i++){
+						body += path;
+					}
+					pending.push_back({client, etag, notModified, body, ofGetElapsedTimeMillis() + delayMillis});
+					request.erase(0, end + 4);
+				}
+			}
+
+			auto now = ofGetElapsedTimeMillis();
+			for(auto it = pending.begin(); it != pending.end();){
+				if(it->due <= now){
+					auto response = std::string(it->notModified ? "HTTP/1.1 304 Not Modified" : "HTTP/1.1 200 OK") +
+						"\r\nETag: " + it->etag +
+						"\r\nContent-Length: " + ofToString(it->body.size()) + "\r\n\r\n" + it->body;
+					server.sendRawBytes(it->client, response.c_str(), response.size());
+					it = pending.erase(it);
+				}else{
+					++it;
+				}
+			}
+			ofSleepMillis(1);
+		}
+	}
+
+	ofxTCPServer server;
+	std::atomic<uint64_t> delayMillis;
+	std::map<int, std::string> incoming;
+	std::list<Response> pending;
+};
+
+class ofApp: public ofxUnitTestsApp{
+	// responses are delivered on the update event
+	void waitFor(std::function<bool()> condition, uint64_t timeoutMillis = 5000){
+		auto then = ofGetElapsedTimeMillis();
+		while(!condition() && ofGetElapsedTimeMillis() - then < timeoutMillis){
+			ofEventArgs args;
+			ofEvents().update.notify(args);
+			ofSleepMillis(1);
+		}
+	}
+
+	uint64_t fetch(ofURLFileLoader & loader, const std::string & url, size_t numRequests, vector<int> & order){
+		auto then = ofGetElapsedTimeMillis();
+		bool allCorrect = true;
+		for(size_t i = 0; i < numRequests; i++){
+			auto path = "/" + ofToString(i);
+			ofHttpRequest request(url + path, path);
+			request.done = [&order, &allCorrect, path, i](const ofHttpResponse & response){
+				allCorrect &= response.status == 200 && response.data.size() == path.size() * 100;
+				order.push_back(i);
+			};
+			loader.handleRequestAsync(request);
+		}
+		waitFor([&]{ return order.size() == numRequests; });
+		ofxTest(allCorrect && order.size() == numRequests, "async responses");
+		return ofGetElapsedTimeMillis() - then;
+	}
+
+	void run(){
+		int port = ofRandom(15000, 65535);
+		std::string url = "http://127.0.0.1:" + ofToString(port);
+		LoopbackServer server;
+		ofxTest(server.setup(port, 50), "loopback server");
+
+		ofURLFileLoader loader;
+		auto response = loader.get(url + "/sync");
+		ofxTestEq(response.status, 200, "sync request status");
+		ofxTestEq(response.data.size(), size_t(500), "sync request data");
+
+		// one transfer at a time keeps the order and reuses the connection
+		const size_t numRequests = 16;
+		vector<int> order;
+		auto connections = server.getNumConnections();
+		auto sequentialTime = fetch(loader, url, numRequests, order);
+		ofxTest(std::is_sorted(order.begin(), order.end()), "sequential responses arrive in order");
+		ofxTestEq(server.getNumConnections() - connections, 1, "sequential requests reuse one connection");
+
+		loader.setMaxConcurrentTransfers(8);
+		order.clear();
+		connections = server.getNumConnections();
+		auto concurrentTime = fetch(loader, url, numRequests, order);
+		ofxTest(server.getNumConnections() - connections <= 8, "concurrent requests reuse connections");
+		ofxTest(concurrentTime < sequentialTime, "concurrent transfers are faster");
+		ofLogNotice() << numRequests << " requests with 50ms latency, sequential: " << sequentialTime << "ms, 8 concurrent: " << concurrentTime << "ms";
+
+		// priorities and cancellation, the first request keeps the only
+		// transfer slot busy while the rest are queued
+		loader.setMaxConcurrentTransfers(1);
+		order.clear();
+		for(int i = 0; i < 4; i++){
+			auto path = "/" + ofToString(i);
+			ofHttpRequest request(url + path, path);
+			request.priority = i == 3 ? 10 : 0;
+			request.done = [&order, i](const ofHttpResponse &){
+				order.push_back(i);
+			};
+			auto id = loader.handleRequestAsync(request);
+			if(i == 0){
+				ofSleepMillis(20);
+			}
+			if(i == 2){
+				loader.remove(id);
+			}
+		}
+		waitFor([&]{ return order.size() == 3; });
+		// give the cancelled request time to show up if it wasn't cancelled
+		waitFor([]{ return false; }, 100);
+		ofxTest(order == vector<int>({0, 3, 1}), "priorities and cancellation");
+
+		// streaming
+		std::atomic<size_t> streamed{0};
+		bool done = false;
+		ofHttpRequest request(url + "/stream", "stream");
+		request.dataReceived = [&](const char * data, size_t size){
+			streamed += size;
+			return true;
+		};
+		request.done = [&](const ofHttpResponse & response){
+			done = response.data.size() == 0;
+		};
+		loader.handleRequestAsync(request);
+		waitFor([&]{ return done; });
+		ofxTest(done, "streamed responses don't store the data");
+		ofxTestEq(streamed.load(), size_t(700), "streamed data");
+
+		// disk cache: revalidated with the ETag and served from disk when
+		// the server is gone
+		loader.setCache("urlcache", 2000);
+		loader.clearCache();
+		auto first = loader.get(url + "/cached");
+		auto second = loader.get(url + "/cached");
+		ofxTestEq(first.cacheStatus, ofHttpResponse::CACHE_MISS, "first cached request is a miss");
+		ofxTestEq(second.cacheStatus, ofHttpResponse::CACHE_HIT, "revalidated request is a hit");
+		ofxTestEq(second.status, 200, "cache hit status");
+		ofxTest(second.data.getText() == first.data.getText(), "cache hit data");
+		loader.get(url + "/evicted");
+		loader.get(url + "/cached");
+		loader.get(url + "/longer_path");
+		auto stats = loader.getCacheStats();
+		ofxTest(stats.size <= 2000, "cache size limit");
+		ofxTestEq(stats.numEntries, size_t(2), "least recently used response evicted");
+
+		// hits only save the index once in a while, setting the cache up
+		// again saves and reloads it
+		loader.setCache("urlcache", 2000);
+		ofxTestEq(loader.getCacheStats().numEntries, size_t(2), "cache index reloaded");
+		ofxTestEq(loader.getCacheStats().size, stats.size, "cache size reloaded");
+
+		// cached copies that don't match the index aren't served
+		ofDirectory cacheDir("urlcache");
+		cacheDir.listDir();
+		for(auto & file: cacheDir){
+			if(file.getFileName() != "index"){
+				ofBufferToFile(file.getAbsolutePath(), ofBuffer("x", 1));
+			}
+		}
+		auto truncated = loader.get(url + "/cached");
+		ofxTestEq(truncated.cacheStatus, ofHttpResponse::CACHE_MISS, "truncated cached copy is downloaded again");
+		ofxTestEq(truncated.data.size(), size_t(700), "truncated cached copy data");
+
+		server.close();
+		auto stale = loader.get(url + "/cached");
+		ofxTestEq(stale.cacheStatus, ofHttpResponse::CACHE_STALE, "unreachable server serves stale copy");
+		ofxTestEq(stale.data.size(), size_t(700), "stale data");
+		loader.clearCache();
+
+		loader.stop();
+	}
+};
+
+//========================================================================
+int main( ){
+	ofInit();
+	auto window = make_shared<ofAppNoWindow>();
+	auto app = make_shared<ofApp>();
+	// this kicks off the running of my app
+	// can be OF_WINDOW or OF_FULLSCREEN
+	// pass in width and height too:
+	ofRunApp(window, app);
+	return ofRunMainLoop();
+
+}